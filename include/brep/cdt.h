@@ -82,6 +82,13 @@ ON_Brep_CDT_Tessellate(struct ON_Brep_CDT_State *s, int face_cnt, int *faces);
 extern BREP_EXPORT int
 ON_Brep_CDT_Status(struct ON_Brep_CDT_State *s);
 
+/* Report the number of triangles in the tessellation of face face_index, or
+ * -1 if the face has not been tessellated.  ON_Brep_CDT_Mesh emits the
+ * triangles of each face together and in face order, so these counts map
+ * the triangles of a full mesh back to the faces that produced them. */
+extern BREP_EXPORT int
+ON_Brep_CDT_Face_Tri_Cnt(struct ON_Brep_CDT_State *s, int face_index);
+
 /* Construct a vlist plot from the tessellation.  Modes are:
  *
  * 0 - shaded 3D triangles
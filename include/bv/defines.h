@@ -191,6 +191,7 @@ struct bv_obj_settings {
 #define BV_POLYGONS       0x20
 #define BV_MESH_LOD       0x40
 #define BV_CSG_LOD        0x80
+#define BV_SHARED_VLIST   0x100
 
 struct bview;
 
@@ -86,6 +86,29 @@ bv_mesh_lod_context_create(const char *name);
 BV_EXPORT void
 bv_mesh_lod_context_destroy(struct bv_mesh_lod_context *c);
 
+/* Mesh LoD data loaded for drawing is tracked per context, so the total
+ * memory held by all meshes associated with a database can be capped.  When a
+ * level change pushes the total over the budget, data is released from other
+ * meshes in the context - first from meshes not visible in their views, then
+ * by stepping down the visible meshes whose on-screen error increases the
+ * least from a coarser level.  A budget of 0 (the default) means unlimited.
+ * Meshes drawing full-detail data (beyond the POP levels) are not managed. */
+BV_EXPORT void
+bv_mesh_lod_budget_set(struct bv_mesh_lod_context *c, size_t bytes);
+
+struct bv_mesh_lod_stats {
+    size_t budget;          /* current memory budget in bytes (0 == unlimited) */
+    size_t resident;        /* bytes of level data currently loaded */
+    size_t peak;            /* high water mark of resident */
+    size_t meshes;          /* number of active LoD meshes in the context */
+    size_t resident_meshes; /* number of meshes with level data loaded */
+    size_t evictions;       /* number of data releases forced by the budget */
+};
+
+/* Report residency statistics for the LoD context c. */
+BV_EXPORT void
+bv_mesh_lod_stats_get(struct bv_mesh_lod_context *c, struct bv_mesh_lod_stats *stats);
+
 /* Remove cache data associated with key.  If key == 0, remove ALL cache data
  * associated with all LoD objects in c. (i.e. a full LoD cache reset for that
  * .g database).  If key == 0 AND c == NULL, clear all LoD cache data for all
@@ -142,6 +165,40 @@ bv_mesh_lod_key_get(struct bv_mesh_lod_context *c, const char *name);
 BV_EXPORT int
 bv_mesh_lod_key_put(struct bv_mesh_lod_context *c, const char *name, unsigned long long key);
 
+/**
+ * Generate the LoD cache data for a mesh in a background thread, associating
+ * the resulting key with name (see bv_mesh_lod_key_put) once it is ready.
+ * Jobs beyond the number of available processors queue until a slot frees up,
+ * and processors not claimed by other jobs are used to process large meshes
+ * in parallel.
+ *
+ * The mesh data must remain valid until the job is complete.  If release is
+ * non-NULL, the job will call it with rdata when it no longer needs the data
+ * (including when generation fails), and it may be called from the job's
+ * thread.
+ *
+ * Returns 0 if the job was started, 1 if a job for name is already pending
+ * and -1 on error.  If the job was not started, release is NOT called and the
+ * caller retains responsibility for the data.
+ */
+BV_EXPORT int
+bv_mesh_lod_cache_bg(struct bv_mesh_lod_context *c, const char *name, const point_t *v, size_t vcnt, const vect_t *vn, int *f, size_t fcnt, unsigned long long user_key, fastf_t fratio, void (*release)(void *), void *rdata);
+
+/**
+ * Returns 1 if a background cache job for name is queued or running, else 0.
+ */
+BV_EXPORT int
+bv_mesh_lod_cache_pending(struct bv_mesh_lod_context *c, const char *name);
+
+/**
+ * Block until no more than max_pending background cache jobs remain queued
+ * or running.  Passing 0 waits for all jobs to complete.
+ *
+ * Returns the number of jobs still pending.
+ */
+BV_EXPORT size_t
+bv_mesh_lod_cache_wait(struct bv_mesh_lod_context *c, size_t max_pending);
+
 /**
  * Set up the bv_mesh_lod container using cached LoD information associated
  * with key.  If no cached data has been prepared, a NULL container is
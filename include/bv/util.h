@@ -125,6 +125,19 @@ BV_EXPORT extern int bv_screen_pt(point_t *p, fastf_t x, fastf_t y, struct bview
  * Return 1 if a bound was computed, else 0 */
 BV_EXPORT extern int bv_scene_obj_bound(struct bv_scene_obj *s, struct bview *v);
 
+/* Return the vlist holding the geometry of s, setting mat to the matrix that
+ * takes its points to model coordinates.  That is the identity for ordinary
+ * objects, whose s_vlist is already in model coordinates, and s_mat for
+ * objects drawing a shared vlist (BV_SHARED_VLIST), whose s_vlist is empty and
+ * whose points are in the source object's local coordinates.  Commands that
+ * carry normals rather than locations need MAT4X3VEC instead. */
+BV_EXPORT extern struct bu_list *bv_obj_vlist(struct bv_scene_obj *s, mat_t mat);
+
+/* Append a copy of the geometry of s, in model coordinates, to dest using
+ * s->vlfree.  For handing to code that only knows about s_vlist - release it
+ * with BV_FREE_VLIST(s->vlfree, dest). */
+BV_EXPORT extern void bv_obj_vlist_copy(struct bu_list *dest, struct bv_scene_obj *s);
+
 /* Find the nearest (mode == 0) or farthest (mode == 1) data_vZ value from
  * the vlist points in s in the context of view v */
 BV_EXPORT extern fastf_t bv_vZ_calc(struct bv_scene_obj *s, struct bview *v, int mode);
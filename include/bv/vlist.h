@@ -329,6 +329,70 @@ bv_vlblock_obj(struct bv_vlblock *vbp, struct bview *v, const char *name);
 BV_EXPORT extern void bv_vlist_to_uplot(FILE *fp,
 					const struct bu_list *vhead);
 
+/**
+ * Shared vlists.
+ *
+ * When many scene objects are instances of the same geometry under different
+ * matrices (fasteners, track links, etc.) there is no need for each of them to
+ * carry its own copy of the vlist.  A bv_vlist_shared holds one copy of the
+ * wireframe/triangle data in the source object's local coordinate system.
+ * Scene objects using it are flagged BV_SHARED_VLIST, hold a reference to it
+ * in draw_data and leave s_vlist empty - display managers draw them by
+ * applying s_mat to the view matrix rather than from transformed copies of
+ * the vertices.
+ *
+ * Shared vlists are reference counted and looked up in a bv_vlist_cache by a
+ * caller supplied key, which must capture everything that determines the
+ * geometry (source data, tolerances, drawing mode.)  An entry is dropped from
+ * its cache and freed when the last reference to it is released.  The cache
+ * functions are thread safe.
+ */
+struct bv_vlist_cache;
+
+struct bv_vlist_shared {
+    unsigned long long key;
+    struct bu_list vlist;	/**< @brief vlist in local (un-instanced) coordinates */
+    size_t vlen;		/**< @brief number of commands in vlist */
+    point_t bmin;		/**< @brief local bounding box of vlist */
+    point_t bmax;
+    int dispmode;		/**< @brief vlist contains display context vertices */
+    size_t refcnt;
+    struct bv_vlist_cache *c;
+};
+
+BV_EXPORT extern struct bv_vlist_cache *bv_vlist_cache_create(void);
+
+/**
+ * Destroy the cache.  Shared vlists still referenced by scene objects remain
+ * valid, and are freed when their last reference is released.
+ */
+BV_EXPORT extern void bv_vlist_cache_destroy(struct bv_vlist_cache *c);
+
+/**
+ * Return a new reference to the shared vlist stored under key, or NULL if
+ * there is no such entry.
+ */
+BV_EXPORT extern struct bv_vlist_shared *bv_vlist_cache_get(struct bv_vlist_cache *c, unsigned long long key);
+
+/**
+ * Store the contents of vlist under key and return a new reference to the
+ * shared vlist.  The chain of bv_vlist structures is moved out of vlist,
+ * leaving it empty.  If an entry for key already exists (for example, another
+ * thread stored it first) the supplied vlist is freed and the existing entry
+ * is returned.
+ */
+BV_EXPORT extern struct bv_vlist_shared *bv_vlist_cache_put(struct bv_vlist_cache *c, unsigned long long key, struct bu_list *vlist);
+
+/**
+ * Release a reference to sv, freeing it when no references remain.
+ */
+BV_EXPORT extern void bv_vlist_shared_put(struct bv_vlist_shared *sv);
+
+/**
+ * Number of shared vlists currently held in the cache.
+ */
+BV_EXPORT extern size_t bv_vlist_cache_size(struct bv_vlist_cache *c);
+
 /** @} */
 
 __END_DECLS
@@ -523,6 +523,8 @@ typedef struct fb_internal FBIO;
 #define MSG_FBSETCURSOR   31            /**< @brief NEW in Release 4.4 */
 #define MSG_FBBWREADRECT  32            /**< @brief NEW in Release 4.6 */
 #define MSG_FBBWWRITERECT 33            /**< @brief NEW in Release 4.6 */
+#define MSG_FBSHMOPEN     34            /**< @brief NEW: offer local clients a shared memory segment */
+#define MSG_FBSHMSYNC     35            /**< @brief NEW: apply writes queued in shared memory */
 
 #define MSG_DATA          20
 #define MSG_RETURN        21
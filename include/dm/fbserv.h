@@ -100,6 +100,17 @@ DM_EXPORT extern void fbs_setup_socket(int fd);
 DM_EXPORT extern int fbs_new_client(struct fbserv_obj *fbsp, struct pkg_conn *pcp, void *data);
 DM_EXPORT extern void fbs_existing_client_handler(void *clientData, int mask);
 
+/**
+ * Shared memory pixel transport for clients on the same host.
+ * fbs_shm_open() answers a MSG_FBSHMOPEN request and fbs_shm_sync()
+ * a MSG_FBSHMSYNC, applying the writes the client has queued to fbp.
+ * Neither frees buf.  Servers must call fbs_shm_release() when they
+ * drop a connection.
+ */
+DM_EXPORT extern void fbs_shm_open(struct pkg_conn *pcp, struct fb *fbp);
+DM_EXPORT extern void fbs_shm_sync(struct pkg_conn *pcp, struct fb *fbp, char *buf);
+DM_EXPORT extern void fbs_shm_release(struct pkg_conn *pcp);
+
 
 __END_DECLS
 
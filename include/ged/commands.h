@@ -154,6 +154,17 @@ GED_EXPORT extern int ged_inside_internal(struct ged *gedp,
 
 GED_EXPORT void draw_scene(struct bv_scene_obj *s, struct bview *v);
 
+/**
+ * Generate geometry for cnt scene objects in view v - the equivalent of
+ * calling draw_scene on each object, except that view independent solid
+ * wireframes are imported and plotted in parallel.  If clbk is set it is
+ * called after each batch of objects with a struct draw_progress as its
+ * first user data pointer and clbk_data as its second; a non-zero return
+ * stops the draw.  Objects not drawn due to cancellation are added to
+ * cancelled, if supplied.  Returns the number of objects drawn.
+ */
+GED_EXPORT size_t draw_scene_objs(struct bv_scene_obj **objs, size_t cnt, struct bview *v, bu_clbk_t clbk, void *clbk_data, struct bu_ptbl *cancelled);
+
 
 /** @} */
 
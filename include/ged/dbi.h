@@ -166,7 +166,11 @@ class GED_EXPORT BViewState {
 	// A View State redraw can impact multiple views with a shared state - most of
 	// the elements will be the same, but adaptive plotting will be view specific even
 	// with otherwise common objects - we must update accordingly.
-	unsigned long long redraw(struct bv_obj_settings *vs, std::unordered_set<struct bview *> &views, int no_autoview);
+	//
+	// If supplied, clbk is passed along to draw_scene_objs to report progress
+	// during geometry generation.  If it cancels the draw, the objects that
+	// didn't get geometry are removed from the view state.
+	unsigned long long redraw(struct bv_obj_settings *vs, std::unordered_set<struct bview *> &views, int no_autoview, bu_clbk_t clbk = NULL, void *clbk_data = NULL);
 
 	// Allow callers to calculate the drawing hash of a path
 	unsigned long long path_hash(std::vector<unsigned long long> &path, size_t max_len);
@@ -351,13 +355,24 @@ class GED_EXPORT DbiState {
 	std::unordered_map<unsigned long long, std::unordered_map<unsigned long long, size_t>> i_bool;
 
 
-	// Bounding boxes for each solid.  To calculate the bbox for a comb, the
-	// children are walked combining the bboxes.  The idea is to be able to
+	// Bounding boxes for each object, in that object's own coordinate
+	// system.  To calculate the bbox for a comb, the children are walked
+	// combining their (matrix transformed) bboxes.  The idea is to be able to
 	// retrieve solid bboxes and calculate comb bboxes without having to touch
 	// the disk beyond the initial per-solid calculations, which may be done
 	// once per load and/or dimensional change.
 	std::unordered_map<unsigned long long, std::vector<fastf_t>> bboxes;
 
+	// Hashes of the on-disk contents of each object, filled in on first use
+	// by content_hash().  The persistent cache is keyed on these rather than
+	// on object names, so stale entries are never picked up after an edit
+	// (including edits made by other programs between sessions.)  Comb bounds additionally depend on everything below
+	// the comb, so they are stored under a key combining the comb's content
+	// with the bbox keys of its children - bkeys memoizes those, and update()
+	// invalidates them for changed objects and all their ancestors.
+	std::unordered_map<unsigned long long, unsigned long long> c_hash;
+	std::unordered_map<unsigned long long, unsigned long long> bkeys;
+
 
 	// We also have a number of standard attributes that can impact drawing,
 	// which are normally only accessible by loading in the attributes of
@@ -411,6 +426,10 @@ class GED_EXPORT DbiState {
 		);
 
 	void populate_maps(struct directory *dp, unsigned long long phash, int reset);
+	unsigned long long content_hash(unsigned long long hash);
+	unsigned long long bbox_key(unsigned long long hash, std::unordered_set<unsigned long long> &visiting);
+	bool obj_bbox(point_t *bmin, point_t *bmax, unsigned long long hash, std::unordered_set<unsigned long long> &visiting);
+	void invalidate_bboxes(std::unordered_set<unsigned long long> &hashes);
 	unsigned long long update_dp(struct directory *dp, int reset);
 	unsigned int color_int(struct bu_color *);
 	int int_color(struct bu_color *c, unsigned int);
@@ -37,6 +37,7 @@
 #include "rt/search.h"
 #include "bv/defines.h"
 #include "bv/lod.h"
+#include "bv/vlist.h"
 #include "dm/fbserv.h" // for fbserv_obj
 #include "rt/wdb.h" // for struct rt_wdb
 
@@ -184,6 +185,8 @@ struct ged {
 
     /* Drawing data associated with this .g file */
     struct bv_mesh_lod_context  *ged_lod;
+    /* Wireframes shared between instances of the same solid */
+    struct bv_vlist_cache       *ged_vlist_c;
 
 
     void                        *u_data; /**< @brief User data associated with this ged instance */
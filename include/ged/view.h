@@ -213,9 +213,20 @@ struct draw_update_data_t {
     const struct bn_tol *tol;
     const struct bg_tess_tol *ttol;
     struct bv_mesh_lod_context *mesh_c;
+    struct bv_vlist_cache *vlist_c;
     struct resource *res;
 };
 
+/* Progress of a running draw.  Passed as the first user data pointer to the
+ * draw command's BU_CLBK_DURING callback after each batch of objects is
+ * added to the view - a non-zero return from the callback cancels the rest
+ * of the draw. */
+struct draw_progress {
+    size_t done;	/**< @brief objects with generated geometry */
+    size_t total;	/**< @brief objects in the draw */
+    int64_t elapsed;	/**< @brief microseconds since the draw started */
+};
+
 GED_EXPORT extern unsigned long long dl_name_hash(struct ged *gedp);
 
 
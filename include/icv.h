@@ -38,6 +38,7 @@ __BEGIN_DECLS
 #include "icv/io.h"
 #include "icv/ops.h"
 #include "icv/stat.h"
+#include "icv/tile.h"
 
 __END_DECLS
 
@@ -55,7 +55,8 @@ typedef enum {
 
 typedef enum {
     ICV_DATA_DOUBLE,
-    ICV_DATA_UCHAR
+    ICV_DATA_UCHAR,
+    ICV_DATA_HALF	/* IEEE 754 binary16, stored as uint16_t */
 } ICV_DATA;
 
 /* Define Various Flags */
@@ -58,8 +58,10 @@ typedef enum {
 
 /**
  * Filters an image with the specified filter type. Basically
- * convolves kernel with the image.  Does zero_padding for outbound
- * pixels.
+ * convolves kernel with the image.  The 3x3 kernel is centered on each
+ * output pixel, its first row and column applied to the row and
+ * column before the pixel.  Does zero_padding for outbound rows, and
+ * the first and last pixel of each row are passed through unchanged.
  *
  * @param img Image to be filtered.
  * @param filter_type Type of filter to be used.
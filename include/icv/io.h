@@ -133,7 +133,8 @@ ICV_EXPORT extern int icv_write(icv_image_t *bif, const char*filename, bu_mime_i
  * @param y Index of the line at which data is to be written. 0 for
  * the first line
  * @param data Line Data to be written
- * @param type Type of data, e.g., uint8 data specify ICV_DATA_UCHAR or 1
+ * @param type Type of data, e.g., uint8 data specify ICV_DATA_UCHAR or 1,
+ * half float data ICV_DATA_HALF
  * @return on success 0, on failure -1
  */
 ICV_EXPORT int icv_writeline(icv_image_t *bif, size_t y, void *data, ICV_DATA type);
@@ -0,0 +1,137 @@
+/*                         T I L E . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup icv_tile
+ *
+ * @brief
+ * Region at a time access to image files too large to load whole.
+ *
+ * icv_read() converts an entire image to doubles, eight times the
+ * size of an 8-bit pix file.  An icv_file instead leaves the image
+ * where it is: pix, bw and dpix files are memory mapped and read in
+ * place, and PNG files are decoded a strip of rows at a time.  Only
+ * the regions a caller asks for are converted, into 8-bit, half float
+ * or double samples as the caller chooses.
+ *
+ * As with icv_image, row 0 is the bottom of the image and region
+ * buffers hold their bottom row first, with the channels of each
+ * pixel interleaved.
+ *
+ */
+
+#ifndef ICV_TILE_H
+#define ICV_TILE_H
+
+#include "common.h"
+#include <stddef.h> /* for size_t */
+#include "bu/mime.h"
+#include "icv/defines.h"
+
+__BEGIN_DECLS
+
+/** @{ */
+/** @file icv/tile.h */
+
+typedef struct icv_file icv_file_t;
+
+/**
+ * Open an image file for region reads.  PIX, BW, DPIX and
+ * non-interlaced PNG files are supported; use icv_read() for the
+ * others.
+ *
+ * For PIX, BW and DPIX files a width and height of 0 asks for the size
+ * to be guessed from the file size, as icv_image_size() does.
+ *
+ * @return the open file, or NULL on failure with log messages.
+ */
+ICV_EXPORT extern icv_file_t *icv_file_open(const char *filename, bu_mime_image_t format, size_t width, size_t height);
+
+/**
+ * Create a PIX, BW or DPIX file of the given size for region writes.
+ * The file starts out black.
+ */
+ICV_EXPORT extern icv_file_t *icv_file_create(const char *filename, bu_mime_image_t format, size_t width, size_t height);
+
+/**
+ * Report the dimensions and channel count of an open file.  Any of
+ * the output pointers may be NULL.
+ */
+ICV_EXPORT extern int icv_file_size(const icv_file_t *f, size_t *width, size_t *height, size_t *channels);
+
+/**
+ * Convert the region of w by h pixels with bottom left corner (x, y)
+ * into buf, as samples of the given type.  buf must hold
+ * w*h*channels samples.
+ *
+ * PNG files are decoded from the top down, so reading regions in that
+ * order decodes the file once; going back up restarts the decoder.
+ *
+ * @return 0 on success, -1 on failure
+ */
+ICV_EXPORT extern int icv_file_read_region(icv_file_t *f, size_t x, size_t y, size_t w, size_t h, ICV_DATA type, void *buf);
+
+/**
+ * Read a region into a new double icv_image, so that the usual libicv
+ * operations can be applied to one tile of a large image at a time.
+ */
+ICV_EXPORT extern icv_image_t *icv_file_read_image(icv_file_t *f, size_t x, size_t y, size_t w, size_t h);
+
+/**
+ * Return the 8-bit samples of row y without copying them.  For PIX and
+ * BW files this points into the mapped file; for PNG files it points
+ * into the current strip and is valid until the next read.  DPIX
+ * files have no 8-bit rows and return NULL.
+ */
+ICV_EXPORT extern const unsigned char *icv_file_row(icv_file_t *f, size_t y);
+
+/**
+ * Convert the w by h samples of the given type in buf to the file's
+ * own format and store them at (x, y) of a file opened with
+ * icv_file_create().
+ *
+ * @return 0 on success, -1 on failure
+ */
+ICV_EXPORT extern int icv_file_write_region(icv_file_t *f, size_t x, size_t y, size_t w, size_t h, ICV_DATA type, const void *buf);
+
+/**
+ * Write an icv_image, e.g. a tile obtained with icv_file_read_image(),
+ * at (x, y) of a file opened with icv_file_create().
+ */
+ICV_EXPORT extern int icv_file_write_image(icv_file_t *f, size_t x, size_t y, icv_image_t *img);
+
+/**
+ * Close the file, unmapping it and flushing any writes.
+ */
+ICV_EXPORT extern int icv_file_close(icv_file_t *f);
+
+/** @} */
+
+__END_DECLS
+
+#endif /* ICV_TILE_H */
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -84,6 +84,52 @@ OPTICAL_EXPORT extern void light_maker(int num, mat_t v2m);
 OPTICAL_EXPORT extern int light_init(struct application *ap);
 OPTICAL_EXPORT extern void light_obs(struct application *ap, struct shadework *swp, int have);
 
+/**
+ * A light visibility ray that light_obs_defer() left for the
+ * application to shoot.
+ */
+struct light_vis_ray {
+    point_t	lv_pt;		/**< @brief start, just off the lit surface */
+    vect_t	lv_dir;		/**< @brief unit vector toward the light */
+    fastf_t	lv_dist;	/**< @brief distance to the light, INFINITY if infinite */
+    fastf_t	lv_rbeam;	/**< @brief beam radius at lv_pt */
+    struct light_specific *lv_lsp;	/**< @brief light shot at */
+};
+
+/**
+ * Light visibility deferral, set by an application that shoots the
+ * visibility rays of many hit points together.
+ *
+ * ld_rays() is given the rays for light index light (as in
+ * sw_visible[]) out of tot it was to get - the others can't see the
+ * light - and returns 0 if it takes them.  The light is then treated
+ * as fully visible and the shader hands ld_term() its contribution to
+ * the color, to be scaled by the light fraction and intensity the rays
+ * come up with, as light_obs() would have set them.  Anything else
+ * from ld_rays() has the rays shot right away.
+ */
+struct light_defer {
+    int (*ld_rays)(struct application *ap, int light, int tot, const struct light_vis_ray *rays, int nrays);
+    void (*ld_term)(struct application *ap, int light, const vect_t term);
+};
+OPTICAL_EXPORT extern struct light_defer *light_defer;
+
+/**
+ * As light_obs(), but the visibility of lights an occlusion query can
+ * decide (invisible or infinite lights that cast shadows) may be left
+ * to light_defer.  deferred[] is set !0 for those lights, and only the
+ * caller can tell whether its color stays linear in them.  Returns the
+ * number of lights deferred.
+ */
+OPTICAL_EXPORT extern int light_obs_defer(struct application *ap, struct shadework *swp, int have, char deferred[SW_NLIGHTS]);
+
+/**
+ * Shoot a deferred light visibility ray from application ap.  Returns
+ * 1 if the light is seen, setting inten to the fraction of it that
+ * gets through, or 0 if it is not.
+ */
+OPTICAL_EXPORT extern int light_vis_shoot(struct application *ap, const struct light_vis_ray *rp, vect_t inten);
+
 __END_DECLS
 
 #endif /* OPTICAL_LIGHT_H */
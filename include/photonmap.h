@@ -68,8 +68,8 @@ struct Photon {
 
 
 struct PSN {
-    struct	Photon	P;
-    fastf_t		Dist;
+    const struct Photon	*P;		/**< @brief Located Photon, in the Photon Map */
+    fastf_t		Dist;		/**< @brief Distance Sq to the Search Position */
 };
 
 
@@ -96,18 +96,10 @@ struct NearestPhotons {
 };
 
 
-struct PNode {
-    struct	Photon	P;
-    struct	PNode	*L;
-    struct	PNode	*R;
-    int			C;		/**< @brief For Threading Purposes to see if it's been computed yet */
-};
-
-
 struct PhotonMap {
     int			StoredPhotons;
     int			MaxPhotons;
-    struct	PNode	*Root;
+    struct	Photon	*Photons;	/**< @brief Balanced KD-Tree, a flat array with each node in the middle of its subtrees */
 };
 
 
@@ -83,6 +83,7 @@ struct pkg_header {
 };
 
 #define	PKG_STREAMLEN	(32*1024)
+struct pkg_async;
 struct pkg_conn {
     int	pkc_fd;					/**< @brief TCP connection fd */
 
@@ -118,6 +119,7 @@ struct pkg_conn {
     char *pkc_buf;				/**< @brief start of dynamic buf */
     char *pkc_curpos;				/**< @brief current position in pkg_buf */
     void *pkc_server_data;			/**< @brief used to hold server data for callbacks */
+    struct pkg_async *pkc_async;		/**< @brief transport threads, see pkg_async_start() */
 };
 #define PKC_NULL	((struct pkg_conn *)0)
 #define PKC_ERROR	((struct pkg_conn *)(-1L))
@@ -265,6 +267,54 @@ PKG_EXPORT extern char *pkg_bwaitfor(int type, struct pkg_conn* pc);
  */
 PKG_EXPORT extern int pkg_block(struct pkg_conn* pc);
 
+/**
+ * Switch a connection to the asynchronous transport.
+ *
+ * Two threads take over the connection's file descriptors.  A sender
+ * thread writes the messages queued by pkg_send(), pkg_2send() and
+ * pkg_stream(), coalescing whatever has accumulated into as few
+ * writev() calls as possible, so callers no longer block on the
+ * network for every small message.  A receiver thread reads and
+ * frames incoming messages into a lock-free queue, from which
+ * pkg_process(), pkg_block(), pkg_suckin(), pkg_waitfor() and
+ * pkg_bwaitfor() take them.  Handlers still run on the thread calling
+ * those routines.
+ *
+ * While the transport is running the caller must not read or write
+ * pkc_fd itself, nor rely on select() on it; pkg_suckin() is the way
+ * to wait for input.  pkg_flush() waits for the send queue to drain.
+ * Send errors are reported by the next send or pkg_flush().
+ *
+ * Returns 0 on success, -1 if the threads could not be started or a
+ * message is partially read.
+ */
+PKG_EXPORT extern int pkg_async_start(struct pkg_conn *pc);
+
+/**
+ * Return a connection to synchronous operation.
+ *
+ * Waits for queued output to be written, stops both threads and
+ * dispatches any messages already received.  Input not yet framed is
+ * left in the connection's buffer for the synchronous routines.
+ * pkg_close() does this implicitly.
+ *
+ * Returns 0 on success, -1 if queued output could not be sent.
+ */
+PKG_EXPORT extern int pkg_async_stop(struct pkg_conn *pc);
+
+/**
+ * Send a message, handing the buffer over to libpkg.
+ *
+ * Like pkg_send(), but buf must have come from malloc() and becomes
+ * the property of the library, which frees it once it has been
+ * written.  On an asynchronous connection the buffer is queued as is,
+ * without being copied.
+ *
+ * Returns the number of bytes of user data sent (or queued), or -1 on
+ * error, in which case buf has still been freed.
+ */
+PKG_EXPORT extern int pkg_send_nocopy(int type, char *buf, size_t len, struct pkg_conn* pc);
+
 /**
  * Become a transient network server
  *
@@ -207,6 +207,35 @@ RT_EXPORT extern int rt_poly_roots(bn_poly_t *eqn,
 				   bn_complex_t roots[],
 				   const char *name);
 
+/**
+ * Find the four roots of a quartic polynomial.
+ *
+ * Uses the closed form solution, with the real roots refined by a
+ * Newton step.  When that doesn't produce roots within RT_ROOT_TOL all
+ * the roots are refined further, and only if that also fails does it
+ * fall back to the iterative rt_poly_roots() solver.  Intended for the
+ * torus family of primitives (tor, eto, pipe bends.)
+ *
+ * As with rt_poly_roots(), the polynomial given as input is destroyed.
+ *
+ * Returns the number of roots found (4 unless the solve failed.)
+ */
+RT_EXPORT extern int rt_poly_quartic_roots(bn_poly_t *eqn,
+					   bn_complex_t roots[],
+					   const char *name);
+
+/**
+ * Solve n quartics at once with rt_poly_quartic_roots(), for the
+ * vectorized (ft_vshot) intersectors.  Entries with nroots[i] < 0 on
+ * input are skipped, otherwise nroots[i] is set to the number of roots
+ * found for eqns[i].
+ */
+RT_EXPORT extern void rt_poly_quartic_roots_batch(bn_poly_t eqns[],
+						  bn_complex_t (*roots)[4],
+						  int nroots[],
+						  size_t n,
+						  const char *name);
+
 /** @} */
 
 
@@ -92,6 +92,33 @@ __BEGIN_DECLS
  */
 RT_EXPORT extern int rt_shootray(struct application *ap);
 
+/**
+ * @brief
+ * Occlusion (any-hit) query for shadow and visibility rays.
+ *
+ * Fires ap->a_ray like rt_shootray(), but only answers whether some
+ * region occupies part of the ray between mindist and maxdist.  The
+ * ray stops at the first such region the occluder callback accepts
+ * (a NULL occluder accepts every region), and segments of solids that
+ * are only unioned into their regions settle the query without any
+ * partitions being built.  a_hit and a_miss are not called.
+ *
+ * Returns -
+ *  1 if an occluder was found in the interval
+ *  0 if no region was found in the interval
+ * -1 if only regions the occluder callback rejected were found
+ */
+RT_EXPORT extern int rt_shootray_occluded(struct application *ap, fastf_t mindist, fastf_t maxdist, int (*occluder)(struct application *, const struct region *));
+
+/**
+ * @brief
+ * As rt_shootray_occluded(), but only regions the ray enters between
+ * mindist and maxdist count - one the ray is already inside of at
+ * mindist is passed over.  This is the test ambient occlusion rays
+ * use, since their origin may be just inside the surface they leave.
+ */
+RT_EXPORT extern int rt_shootray_occluded_entry(struct application *ap, fastf_t mindist, fastf_t maxdist, int (*occluder)(struct application *, const struct region *));
+
 
 /**
  * @brief
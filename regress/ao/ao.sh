@@ -0,0 +1,134 @@
+#!/bin/sh
+#                           A O . S H
+# BRL-CAD
+#
+# Copyright (c) 2025 United States Government as represented by
+# the U.S. Army Research Laboratory.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following
+# disclaimer in the documentation and/or other materials provided
+# with the distribution.
+#
+# 3. The name of the author may not be used to endorse or promote
+# products derived from this software without specific prior written
+# permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+###
+
+# Ensure /bin/sh
+export PATH || (echo "This isn't sh."; sh $0 $*; kill $$)
+
+# source common library functionality, setting ARGS, NAME_OF_THIS,
+# PATH_TO_THIS, and THIS.
+. "$1/regress/library.sh"
+
+if test "x$LOGFILE" = "x" ; then
+    LOGFILE=`pwd`/ao.log
+    rm -f $LOGFILE
+fi
+log "=== TESTING ambient occlusion ==="
+
+RT="`ensearch rt`"
+if test ! -f "$RT" ; then
+    log "Unable to find rt, aborting"
+    exit 1
+fi
+A2G="`ensearch asc2g`"
+if test ! -f "$A2G" ; then
+    log "Unable to find asc2g, aborting"
+    exit 1
+fi
+PIXDIFF="`ensearch pixdiff`"
+if test ! -f "$PIXDIFF" ; then
+    log "Unable to find pixdiff, aborting"
+    exit 1
+fi
+
+# Occlusion rays are answered by an occlusion query unless a cutting
+# plane is given, when they are shot in full so the plane can be
+# applied.  A plane far below everything cuts nothing, so the two ways
+# must give the same pixels.  The overlapping spheres unioned into one
+# region start some occlusion rays inside a region they go on to leave
+# and enter again.
+rm -f ao.asc
+cat > ao.asc <<EOF
+title {Ambient occlusion}
+units mm
+put {plate.s} arb8 V1 {-30 -30 -1} V2 {30 -30 -1} V3 {30 30 -1} V4 {-30 30 -1} V5 {-30 -30 0} V6 {30 -30 0} V7 {30 30 0} V8 {-30 30 0}
+put {pole.s} tgc V {9 2.5 0} H {0 0 10} A {0 -0.25 0} B {0.25 0 0} C {0 -0.25 0} D {0.25 0 0}
+put {ball.s} ell V {10 0 5} A {2 0 0} B {0 2 0} C {0 0 2}
+put {lobe1.s} ell V {-10 0 3} A {4 0 0} B {0 4 0} C {0 0 4}
+put {lobe2.s} ell V {-6 3 5} A {4 0 0} B {0 4 0} C {0 0 4}
+put {wall.s} arb8 V1 {-20 -12 0} V2 {20 -12 0} V3 {20 -10 0} V4 {-20 -10 0} V5 {-20 -12 8} V6 {20 -12 8} V7 {20 -10 8} V8 {-20 -10 8}
+put {plate.r} comb region yes tree {l plate.s}
+attr set {plate.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1000}
+put {ball.r} comb region yes tree {u {l ball.s} {l pole.s}}
+attr set {ball.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1001}
+put {lobes.r} comb region yes tree {u {l lobe1.s} {l lobe2.s}}
+attr set {lobes.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1002}
+put {wall.r} comb region yes tree {l wall.s}
+attr set {wall.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1003}
+put {all.g} comb region no tree {u {u {l plate.r} {l ball.r}} {u {l lobes.r} {l wall.r}}}
+EOF
+
+run $A2G ao.asc ao.g
+
+FAILED=0
+for radius in 0 6 ; do
+    for kut in no yes ; do
+	if test "x$kut" = "xyes" ; then
+	    KUT="-k 0,0,1,-1000000"
+	else
+	    KUT=""
+	fi
+	log "rendering with ambRadius=$radius, cutting plane: $kut"
+	rm -f ao.$radius.$kut.pix
+	$RT -P1 -s64 -a 35 -e 25 $KUT -c "set ambSamples=16 ambRadius=$radius" -o ao.$radius.$kut.pix ao.g all.g >> $LOGFILE 2>&1
+    done
+
+    rm -f ao.$radius.diff.pix
+    $PIXDIFF ao.$radius.no.pix ao.$radius.yes.pix > ao.$radius.diff.pix 2>> $LOGFILE
+    NUMBER_WRONG=`tail -n1 "$LOGFILE" | tr , '\012' | awk '/many/ {print $1}'`
+    log "ambRadius=$radius: $NUMBER_WRONG off by many"
+    if test "x$NUMBER_WRONG" != "x0" ; then
+	FAILED="`expr $FAILED + 1`"
+    fi
+done
+
+if test $FAILED -eq 0 ; then
+    log "-> ao.sh succeeded"
+else
+    log "-> ao.sh FAILED, see $LOGFILE"
+    cat "$LOGFILE"
+fi
+
+exit $FAILED
+
+# Local Variables:
+# mode: sh
+# tab-width: 8
+# sh-indentation: 4
+# sh-basic-offset: 4
+# indent-tabs-mode: t
+# End:
+# ex: shiftwidth=4 tabstop=8
@@ -0,0 +1,126 @@
+#!/bin/sh
+#                     F A C E T I Z E . S H
+# BRL-CAD
+#
+# Copyright (c) 2025 United States Government as represented by
+# the U.S. Army Research Laboratory.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following
+# disclaimer in the documentation and/or other materials provided
+# with the distribution.
+#
+# 3. The name of the author may not be used to endorse or promote
+# products derived from this software without specific prior written
+# permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+###
+#
+# Facetize the inputs that get their own tessellation methods - a DSP
+# and a plate mode BoT - on their own and together, with more than one
+# worker process.
+#
+###
+
+# Ensure /bin/sh
+export PATH || (echo "This isn't sh."; sh $0 $*; kill $$)
+
+# source common library functionality, setting ARGS, NAME_OF_THIS,
+# PATH_TO_THIS, and THIS.
+. "$1/regress/library.sh"
+
+# Tests should use a local cache
+BU_DIR_CACHE="`pwd`/cache"
+rm -rf $BU_DIR_CACHE && mkdir $BU_DIR_CACHE
+export BU_DIR_CACHE
+LIBRT_CACHE="`pwd`/rtcache"
+rm -rf $LIBRT_CACHE && mkdir $LIBRT_CACHE
+export LIBRT_CACHE
+
+if test "x$LOGFILE" = "x" ; then
+    LOGFILE=`pwd`/facetize.log
+    rm -f $LOGFILE
+fi
+
+log "=== TESTING facetize of DSP and plate mode BoT inputs ==="
+
+MGED="`ensearch mged`"
+if test ! -f "$MGED" ; then
+    log "Unable to find MGED, aborting"
+    exit 1
+fi
+
+# 4x4 height field, network order unsigned shorts.  The tessellation
+# runs against a working copy of the database elsewhere, so the DSP
+# refers to the file by its full path.
+rm -f facetize.dsp
+printf '\000\020\000\030\000\040\000\030\000\030\000\050\000\060\000\040\000\040\000\060\000\070\000\050\000\030\000\040\000\050\000\040' > facetize.dsp
+
+log "creating a geometry database (facetize.g) with a DSP and a plate mode BoT"
+rm -f facetize.g
+
+$MGED -c >> $LOGFILE 2>&1 <<EOF
+opendb facetize.g y
+in dsp.s dsp f `pwd`/facetize.dsp 4 4 0 ad 10 1
+in box.s rpp 0 10 0 10 0 10
+facetize box.bot box.s
+cp box.bot plate.bot
+bot set mode plate.bot plate
+bot set thickness plate.bot 1
+comb both.c u dsp.s u plate.bot
+facetize -j 2 dsp.vol.bot dsp.s
+facetize -j 2 plate.vol.bot plate.bot
+facetize -j 2 both.vol.bot both.c
+EOF
+
+FAILED=0
+
+for obj in dsp.vol.bot plate.vol.bot both.vol.bot ; do
+    mode="`$MGED -c facetize.g get $obj mode 2>&1 | grep -v Using`"
+    # the echo is to remove a newline that gets stored in the variable
+    if test "x`echo $mode`" != "xvolume" ; then
+	log "ERROR: $obj was not created [$mode]"
+	FAILED="`expr $FAILED + 1`"
+    fi
+done
+
+if test $FAILED -eq 0 ; then
+    log "-> facetize check succeeded"
+else
+    log "-> facetize check FAILED, see $LOGFILE"
+    cat "$LOGFILE"
+fi
+
+# Cleanup
+rm -rf "$BU_DIR_CACHE"
+rm -rf "$LIBRT_CACHE"
+
+exit $FAILED
+
+# Local Variables:
+# tab-width: 8
+# mode: sh
+# sh-indentation: 4
+# sh-basic-offset: 4
+# indent-tabs-mode: t
+# End:
+# ex: shiftwidth=4 tabstop=8
@@ -0,0 +1,244 @@
+#!/bin/sh
+#                          R E M R T . S H
+# BRL-CAD
+#
+# Copyright (c) 2025 United States Government as represented by
+# the U.S. Army Research Laboratory.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following
+# disclaimer in the documentation and/or other materials provided
+# with the distribution.
+#
+# 3. The name of the author may not be used to endorse or promote
+# products derived from this software without specific prior written
+# permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+###
+
+#
+# Renders a small database with remrt and a handful of rtsrv servers
+# all running on this machine, killing one of the servers partway
+# through, and compares the result with a plain rt rendering.  The
+# server to be killed is started first and stopped as soon as it has
+# its trees, and is only killed once remrt reports it holding work,
+# which remrt then has to requeue or re-issue.
+#
+
+# Ensure /bin/sh
+export PATH || (echo "This isn't sh."; sh $0 $*; kill $$)
+
+# source common library functionality, setting ARGS, NAME_OF_THIS,
+# PATH_TO_THIS, and THIS.
+. "$1/regress/library.sh"
+
+# Tests should use a local cache
+BU_DIR_CACHE="`pwd`/cache"
+rm -rf $BU_DIR_CACHE && mkdir $BU_DIR_CACHE
+export BU_DIR_CACHE
+LIBRT_CACHE="`pwd`/rtcache"
+rm -rf $LIBRT_CACHE && mkdir $LIBRT_CACHE
+export LIBRT_CACHE
+
+if test "x$LOGFILE" = "x" ; then
+    LOGFILE=`pwd`/remrt.log
+    rm -f $LOGFILE
+fi
+log "=== TESTING remrt distributed rendering ==="
+
+MGED="`ensearch mged`"
+if test ! -f "$MGED" ; then
+    log "Unable to find mged, aborting"
+    exit 1
+fi
+RT="`ensearch rt`"
+if test ! -f "$RT" ; then
+    log "Unable to find rt, aborting"
+    exit 1
+fi
+REMRT="`ensearch remrt`"
+if test ! -f "$REMRT" ; then
+    log "Unable to find remrt, aborting"
+    exit 1
+fi
+RTSRV="`ensearch rtsrv`"
+if test ! -f "$RTSRV" ; then
+    log "Unable to find rtsrv, aborting"
+    exit 1
+fi
+PIXDIFF="`ensearch pixdiff`"
+if test ! -f "$PIXDIFF" ; then
+    log "Unable to find pixdiff, aborting"
+    exit 1
+fi
+
+# number of servers to start, one of which is killed
+SERVERS=4
+VIEW="-B -s 512 -a 35 -e 25"
+
+
+log "... running mged to create a geometry database (remrt.g)"
+rm -f remrt.g
+$MGED -c remrt.g <<EOF >> $LOGFILE 2>&1
+in ball.s sph 0 0 10 10
+in ring.s tor 0 0 10 0 0 1 16 3
+in base.s rpp -30 30 -30 30 -2 0
+r ball.r u ball.s
+r ring.r u ring.s
+r base.r u base.s
+mater ball.r "plastic re=0.8 sp=0.2" 220 220 220 0
+mater ring.r "glass" 200 255 200 0
+mater base.r "plastic re=0.5" 180 180 255 0
+g all.g ball.r ring.r base.r
+q
+EOF
+
+log "... rendering the reference image with rt"
+rm -f remrt.ref.pix
+$RT $VIEW -o remrt.ref.pix remrt.g all.g >> $LOGFILE 2>&1
+
+
+log "... starting remrt"
+rm -f remrt.pix.0 remrt.out
+# frames are written to remrt.pix.<frame number>
+$REMRT $VIEW -o remrt.pix remrt.g all.g < /dev/null > remrt.out 2>&1 &
+REMRT_PID=$!
+
+# remrt reports the port it listens on, unless the "rtsrv" service
+# is known to the system
+PORT=""
+tries=0
+while test "x$PORT" = "x" && test $tries -lt 30 ; do
+    sleep 1
+    PORT="`grep 'Listening at TCP port' remrt.out | awk '{print $NF}'`"
+    if test "x$PORT" = "x" && grep 'Assigned LIBPKG permport' remrt.out > /dev/null 2>&1 ; then
+	PORT=rtsrv
+    fi
+    tries=`expr $tries + 1`
+done
+
+NUMBER_WRONG=-1
+if test "x$PORT" = "x" ; then
+    log "remrt did not start listening"
+    kill $REMRT_PID > /dev/null 2>&1
+else
+    # the victim starts alone, so the first trees remrt hands out are
+    # its, and it is stopped right away so that whatever remrt assigns
+    # it can't come back
+    log "... starting the rtsrv server to be killed on port $PORT"
+    $RTSRV -d localhost $PORT >> $LOGFILE 2>&1 &
+    VICTIM=$!
+    tries=0
+    while test $tries -lt 100000 ; do
+	if grep 'gettrees OK' remrt.out > /dev/null 2>&1 ; then
+	    break
+	fi
+	if kill -0 $REMRT_PID > /dev/null 2>&1 ; then : ; else
+	    break
+	fi
+	tries=`expr $tries + 1`
+    done
+    kill -STOP $VICTIM > /dev/null 2>&1
+
+    # have remrt list its servers, and find the one holding work
+    $RTSRV localhost $PORT status >> $LOGFILE 2>&1
+    HELD="`grep 'assignments=' remrt.out | sed 's/.*assignments=//' | awk '$1 > 0 {print}' | head -n 1`"
+
+    log "... starting `expr $SERVERS - 1` more rtsrv servers on port $PORT"
+    PIDS="$VICTIM"
+    i=1
+    while test $i -lt $SERVERS ; do
+	$RTSRV -d localhost $PORT >> $LOGFILE 2>&1 &
+	PIDS="$PIDS $!"
+	i=`expr $i + 1`
+    done
+
+    if test "x$HELD" = "x" ; then
+	log "rtsrv server $VICTIM was not holding any work when stopped"
+    else
+	log "... killing rtsrv server $VICTIM, holding $HELD assignments"
+    fi
+    kill -9 $VICTIM > /dev/null 2>&1
+
+    # remrt exits once the frame is done
+    tries=0
+    while kill -0 $REMRT_PID > /dev/null 2>&1 && test $tries -lt 300 ; do
+	sleep 1
+	tries=`expr $tries + 1`
+    done
+    if kill -0 $REMRT_PID > /dev/null 2>&1 ; then
+	log "remrt did not finish, killing it"
+	kill $REMRT_PID > /dev/null 2>&1
+    fi
+    for pid in $PIDS ; do
+	kill $pid > /dev/null 2>&1
+    done
+    cat remrt.out >> $LOGFILE
+
+    if [ ! -f remrt.pix.0 ] ; then
+	log "remrt failed to create remrt.pix.0"
+    elif [ ! -f remrt.ref.pix ] ; then
+	log "rt failed to create remrt.ref.pix"
+    else
+	log "... running $PIXDIFF remrt.pix.0 remrt.ref.pix > remrt.pix.diff"
+	rm -f remrt.pix.diff
+	$PIXDIFF remrt.pix.0 remrt.ref.pix > remrt.pix.diff 2>> $LOGFILE
+
+	NUMBER_WRONG=`tail -n1 "$LOGFILE" | tr , '\012' | awk '/many/ {print $1}'`
+	log "remrt.pix $NUMBER_WRONG off by many"
+    fi
+
+    # a frame finished before the kill proves nothing about recovery
+    if test "x$HELD" = "x" ; then
+	NUMBER_WRONG=-1
+    elif grep 'requeueing' remrt.out > /dev/null 2>&1 ; then
+	log "... the killed server's work was requeued"
+    elif grep 're-issuing' remrt.out > /dev/null 2>&1 ; then
+	log "... the killed server's work was re-issued"
+    else
+	log "remrt neither requeued nor re-issued any work"
+	NUMBER_WRONG=-1
+    fi
+fi
+
+
+if [ X$NUMBER_WRONG = X0 ] ; then
+    log "-> remrt.sh succeeded"
+else
+    log "-> remrt.sh FAILED, see $LOGFILE"
+    cat "$LOGFILE"
+fi
+
+# Cleanup
+rm -rf "$BU_DIR_CACHE"
+rm -rf "$LIBRT_CACHE"
+
+exit $NUMBER_WRONG
+
+# Local Variables:
+# mode: sh
+# tab-width: 8
+# sh-indentation: 4
+# sh-basic-offset: 4
+# indent-tabs-mode: t
+# End:
+# ex: shiftwidth=4 tabstop=8
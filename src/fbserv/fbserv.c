@@ -266,6 +266,7 @@ fbserv_drop_client(int sub)
     fd = clients[sub]->pkc_fd;
 
     FD_CLR(fd, &select_list);
+    fbs_shm_release(clients[sub]);
     pkg_close(clients[sub]);
     clients[sub] = PKC_NULL;
 }
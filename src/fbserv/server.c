@@ -731,6 +731,28 @@ fb_server_fb_poll(struct pkg_conn *pcp, char *buf)
 }
 
 
+static void
+fb_server_fb_shmopen(struct pkg_conn *pcp, char *buf)
+{
+    if (pcp == PKC_NULL) return;
+
+    fbs_shm_open(pcp, fb_server_fbp);
+    if (buf)
+	(void)free(buf);
+}
+
+
+static void
+fb_server_fb_shmsync(struct pkg_conn *pcp, char *buf)
+{
+    if (pcp == PKC_NULL) return;
+
+    fbs_shm_sync(pcp, fb_server_fbp, buf);
+    if (buf)
+	(void)free(buf);
+}
+
+
 /*
  * At one time at least we couldn't send a zero length PKG
  * message back and forth, so we receive a dummy long here.
@@ -786,6 +808,9 @@ const struct pkg_switch pkg_switch[] = {
     { MSG_FBPOLL,                       fb_server_fb_poll,        "Handle Events", NULL },
     { MSG_FBSETCURSOR,                  fb_server_fb_setcursor,   "Set Cursor Shape", NULL },
     { MSG_FBSETCURSOR + MSG_NORETURN,   fb_server_fb_setcursor,   "Set Cursor Shape", NULL },
+    { MSG_FBSHMOPEN,                    fb_server_fb_shmopen,     "Open Shared Memory", NULL },
+    { MSG_FBSHMSYNC,                    fb_server_fb_shmsync,     "Apply Shared Memory Writes", NULL },
+    { MSG_FBSHMSYNC + MSG_NORETURN,     fb_server_fb_shmsync,     "Apply Shared Memory Writes", NULL },
     { 0,                                NULL,           NULL, NULL }
 };
 
@@ -588,6 +588,17 @@ ON_Brep_CDT_Brep(struct ON_Brep_CDT_State *s_cdt)
     return (void *)s_cdt->brep;
 }
 
+int
+ON_Brep_CDT_Face_Tri_Cnt(struct ON_Brep_CDT_State *s_cdt, int face_index)
+{
+    if (!s_cdt)
+	return -1;
+    std::map<int, cdt_mesh_t>::iterator f_it = s_cdt->fmeshes.find(face_index);
+    if (f_it == s_cdt->fmeshes.end())
+	return -1;
+    return f_it->second.tris_tree.Count();
+}
+
 // Rules of precedence:
 //
 // 1.  absmax >= absmin
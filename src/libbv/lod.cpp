@@ -57,7 +57,10 @@
 #include "common.h"
 #include <cstring>
 #include <stdlib.h>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <set>
 #include <thread>
 #include <vector>
@@ -94,6 +97,9 @@ extern "C" {
 #include "bv/util.h"
 #include "bv/view_sets.h"
 
+// Meshes with fewer faces than this per thread are characterized serially
+#define POP_THREAD_MIN_FACES 50000
+
 // Number of levels of detail to define
 #define POP_MAXLEVEL 16
 
@@ -594,6 +600,52 @@ _obj_visible(struct bv_scene_obj *s, struct bview *v)
     return 0;
 }
 
+class POPState;
+
+// Bookkeeping for the memory held by all the POPStates drawing from a
+// context, used to enforce the context's memory budget.
+struct bv_mesh_lod_residency {
+    std::mutex lock;
+    std::unordered_set<POPState *> states;
+    size_t budget = 0;
+    size_t resident = 0;
+    size_t peak = 0;
+    size_t evictions = 0;
+};
+
+static void lod_residency_detach(struct bv_mesh_lod_residency *r);
+
+// A queued background cache generation request
+struct bv_mesh_lod_job {
+    std::string name;
+    const point_t *v;
+    size_t vcnt;
+    const vect_t *vn;
+    int *faces;
+    size_t fcnt;
+    unsigned long long user_key;
+    double fratio;
+    void (*release)(void *);
+    void *rdata;
+};
+
+// Background cache generation jobs, keyed on object name.  A pool of at most
+// max_active worker threads (started as the queue needs them) pulls jobs off
+// the queue - running holds the names of both queued and active jobs.
+struct bv_mesh_lod_jobs {
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<bv_mesh_lod_job> queue;
+    std::unordered_set<std::string> running;
+    std::vector<std::thread> workers;
+    size_t idle = 0;
+    size_t active = 0;
+    size_t max_active = 1;
+    bool shutdown = false;
+};
+
+static void lod_jobs_shutdown(struct bv_mesh_lod_jobs *j);
+
 struct bv_mesh_lod_context_internal {
     MDB_env *lod_env;
     MDB_txn *lod_txn;
@@ -604,6 +656,9 @@ struct bv_mesh_lod_context_internal {
     MDB_dbi name_dbi;
 
     struct bu_vls *fname;
+
+    struct bv_mesh_lod_residency *r;
+    struct bv_mesh_lod_jobs *j;
 };
 
 struct bv_mesh_lod_context *
@@ -714,6 +769,9 @@ bv_mesh_lod_context_create(const char *name)
 	goto lod_context_close_name_fail;
 
     // Success - return the context
+    i->r = new bv_mesh_lod_residency;
+    i->j = new bv_mesh_lod_jobs;
+    i->j->max_active = (ncpus > 0) ? (size_t)ncpus : 1;
     bu_vls_free(&fname);
     return c;
 
@@ -734,6 +792,12 @@ bv_mesh_lod_context_destroy(struct bv_mesh_lod_context *c)
 {
     if (!c)
 	return;
+    // Background jobs are writing to the environments - let them finish
+    bv_mesh_lod_cache_wait(c, 0);
+    lod_jobs_shutdown(c->i->j);
+    delete c->i->j;
+    lod_residency_detach(c->i->r);
+    delete c->i->r;
     mdb_env_close(c->i->name_env);
     mdb_env_close(c->i->lod_env);
     bu_vls_free(c->i->fname);
@@ -762,18 +826,23 @@ bv_mesh_lod_key_get(struct bv_mesh_lod_context *c, const char *name)
     unsigned long long hash = bu_data_hash(bu_vls_cstr(&keystr), bu_vls_strlen(&keystr)*sizeof(char));
     bu_vls_sprintf(&keystr, "%llu", hash);
 
-    mdb_txn_begin(c->i->name_env, NULL, 0, &c->i->name_txn);
-    mdb_dbi_open(c->i->name_txn, NULL, 0, &c->i->name_dbi);
+    // Name lookups may be made while background cache jobs are recording
+    // their keys, so use a transaction local to this call.
+    MDB_txn *txn;
+    MDB_dbi dbi;
+    mdb_txn_begin(c->i->name_env, NULL, 0, &txn);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = bu_vls_strlen(&keystr)*sizeof(char);
     mdb_key.mv_data = (void *)bu_vls_cstr(&keystr);
-    int rc = mdb_get(c->i->name_txn, c->i->name_dbi, &mdb_key, &mdb_data);
+    int rc = mdb_get(txn, dbi, &mdb_key, &mdb_data);
     if (rc) {
-	mdb_txn_commit(c->i->name_txn);
+	mdb_txn_commit(txn);
+	bu_vls_free(&keystr);
 	return 0;
     }
     unsigned long long *fkeyp = (unsigned long long *)mdb_data.mv_data;
     unsigned long long fkey = *fkeyp;
-    mdb_txn_commit(c->i->name_txn);
+    mdb_txn_commit(txn);
 
     bu_vls_free(&keystr);
     //bu_log("GOT %s: %llu\n", name, fkey);
@@ -800,16 +869,18 @@ bv_mesh_lod_key_put(struct bv_mesh_lod_context *c, const char *name, unsigned lo
 
     MDB_val mdb_key;
     MDB_val mdb_data[2];
-    mdb_txn_begin(c->i->name_env, NULL, 0, &c->i->name_txn);
-    mdb_dbi_open(c->i->name_txn, NULL, 0, &c->i->name_dbi);
+    MDB_txn *txn;
+    MDB_dbi dbi;
+    mdb_txn_begin(c->i->name_env, NULL, 0, &txn);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = bu_vls_strlen(&keystr)*sizeof(char);
     mdb_key.mv_data = (void *)bu_vls_cstr(&keystr);
     mdb_data[0].mv_size = sizeof(key);
     mdb_data[0].mv_data = (void *)&key;
     mdb_data[1].mv_size = 0;
     mdb_data[1].mv_data = NULL;
-    int rc = mdb_put(c->i->name_txn, c->i->name_dbi, &mdb_key, mdb_data, 0);
-    mdb_txn_commit(c->i->name_txn);
+    int rc = mdb_put(txn, dbi, &mdb_key, mdb_data, 0);
+    mdb_txn_commit(txn);
 
     bu_vls_free(&keystr);
     //bu_log("PUT %s: %llu\n", name, key);
@@ -832,7 +903,7 @@ class POPState {
     public:
 
 	// Create cached data (doesn't create a usable container)
-	POPState(struct bv_mesh_lod_context *ctx, const point_t *v, size_t vcnt, const vect_t *vn, int *faces, size_t fcnt, unsigned long long user_key, fastf_t pop_face_cnt_threshold_ratio);
+	POPState(struct bv_mesh_lod_context *ctx, const point_t *v, size_t vcnt, const vect_t *vn, int *faces, size_t fcnt, unsigned long long user_key, fastf_t pop_face_cnt_threshold_ratio, size_t nthreads = 0);
 
 	// Load cached data (DOES create a usable container)
 	POPState(struct bv_mesh_lod_context *ctx, unsigned long long key);
@@ -899,9 +970,21 @@ class POPState {
 	// Info for drawing
 	struct bv_mesh_lod *lod = NULL;
 
+	// Residency management.  rbytes is the level data size last reported
+	// to the context, and last_vlen the view size used to pick the level.
+	size_t resident_bytes();
+	fastf_t level_error(int level);
+	size_t rbytes = 0;
+	fastf_t last_vlen = 0;
+	bool tracked = false;
+
+	// Number of threads to use characterizing triangles (0 == all cpus)
+	size_t tthreads = 0;
+
     private:
 
 	void tri_process();
+	void tri_classify(size_t start, size_t end, unsigned char *tri_level, size_t *lcnt);
 
 	float minx = FLT_MAX, miny = FLT_MAX, minz = FLT_MAX;
 	float maxx = -FLT_MAX, maxy = -FLT_MAX, maxz = -FLT_MAX;
@@ -931,6 +1014,8 @@ class POPState {
 	void cache_done();
 	void cache_del(const char *component);
 	MDB_val mdb_key, mdb_data[2];
+	MDB_txn *txn = NULL;
+	MDB_dbi dbi;
 
 	// Specific loading and unloading methods
 	void tri_pop_load(int start_level, int level);
@@ -941,7 +1026,7 @@ class POPState {
 	// Processing containers used for initial triangle data characterization
 	std::vector<size_t> tri_ind_map;
 	std::vector<size_t> vert_tri_minlevel;
-	std::map<size_t, std::unordered_set<size_t>> level_tri_verts;
+	std::map<size_t, std::vector<size_t>> level_tri_verts;
 	std::vector<std::vector<size_t>> level_tris;
 
 	// Pointers to original input data
@@ -955,25 +1040,14 @@ class POPState {
 	struct bv_mesh_lod_context *c;
 };
 
+// Find the level at which each of the faces in [start,end) first becomes
+// non-degenerate, recording per-level counts in lcnt.  Bad faces get level
+// POP_MAXLEVEL.  Only reads shared state, so ranges may be processed
+// concurrently.
 void
-POPState::tri_process()
+POPState::tri_classify(size_t start, size_t end, unsigned char *tri_level, size_t *lcnt)
 {
-    // Until we prove otherwise, all edges are assumed to appear only at the
-    // last level (and consequently, their vertices are only needed then).  Set
-    // the level accordingly.
-    vert_tri_minlevel.reserve(vert_cnt);
-    for (size_t i = 0; i < vert_cnt; i++) {
-	vert_tri_minlevel.push_back(POP_MAXLEVEL - 1);
-    }
-
-    // Reserve memory for level containers
-    level_tris.reserve(POP_MAXLEVEL);
-    for (size_t i = 0; i < POP_MAXLEVEL; i++) {
-	level_tris.push_back(std::vector<size_t>(0));
-    }
-
-    // Walk the triangles and perform the LoD characterization
-    for (size_t i = 0; i < faces_cnt; i++) {
+    for (size_t i = start; i < end; i++) {
 	rec triangle[3];
 	// Transform triangle vertices
 	bool bad_face = false;
@@ -988,8 +1062,10 @@ POPState::tri_process()
 	    triangle[j].y = floor((verts_array[f_ind][Y] - miny) / (maxy - miny) * USHRT_MAX);
 	    triangle[j].z = floor((verts_array[f_ind][Z] - minz) / (maxz - minz) * USHRT_MAX);
 	}
-	if (bad_face)
+	if (bad_face) {
+	    tri_level[i] = POP_MAXLEVEL;
 	    continue;
+	}
 
 	// Find the pop up level for this triangle (i.e., when it will first
 	// appear as we step up the zoom levels.)
@@ -1000,11 +1076,86 @@ POPState::tri_process()
 		break;
 	    }
 	}
-	// Add this triangle to its "pop" level
-	level_tris[level].push_back(i);
+	tri_level[i] = (unsigned char)level;
+	lcnt[level]++;
+    }
+}
+
+void
+POPState::tri_process()
+{
+    // Until we prove otherwise, all edges are assumed to appear only at the
+    // last level (and consequently, their vertices are only needed then).  Set
+    // the level accordingly.
+    vert_tri_minlevel.reserve(vert_cnt);
+    for (size_t i = 0; i < vert_cnt; i++) {
+	vert_tri_minlevel.push_back(POP_MAXLEVEL - 1);
+    }
+
+    // Reserve memory for level containers
+    level_tris.reserve(POP_MAXLEVEL);
+    for (size_t i = 0; i < POP_MAXLEVEL; i++) {
+	level_tris.push_back(std::vector<size_t>(0));
+    }
+
+    // Walk the triangles and perform the LoD characterization.  Large meshes
+    // split the faces into contiguous ranges, one per thread.
+    size_t nthreads = (tthreads) ? tthreads : (size_t)bu_avail_cpus();
+    if (nthreads > faces_cnt / POP_THREAD_MIN_FACES)
+	nthreads = faces_cnt / POP_THREAD_MIN_FACES;
+    if (!nthreads)
+	nthreads = 1;
+    std::vector<unsigned char> tri_level(faces_cnt);
+    std::vector<size_t> lcnt(nthreads * POP_MAXLEVEL, 0);
+    std::vector<size_t> rstart(nthreads + 1);
+    for (size_t t = 0; t <= nthreads; t++)
+	rstart[t] = faces_cnt * t / nthreads;
+    if (nthreads == 1) {
+	tri_classify(0, faces_cnt, tri_level.data(), lcnt.data());
+    } else {
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < nthreads; t++)
+	    workers.push_back(std::thread(&POPState::tri_classify, this, rstart[t], rstart[t+1], tri_level.data(), &lcnt[t*POP_MAXLEVEL]));
+	for (size_t t = 0; t < nthreads; t++)
+	    workers[t].join();
+    }
+
+    // Add each triangle to its "pop" level.  An exclusive prefix sum over the
+    // per-range counts gives each range its starting slot in every level, so
+    // the ranges can fill the levels concurrently while keeping the faces in
+    // their original order.
+    std::vector<size_t> loffset(nthreads * POP_MAXLEVEL, 0);
+    for (size_t l = 0; l < POP_MAXLEVEL; l++) {
+	size_t lsum = 0;
+	for (size_t t = 0; t < nthreads; t++) {
+	    loffset[t*POP_MAXLEVEL+l] = lsum;
+	    lsum += lcnt[t*POP_MAXLEVEL+l];
+	}
+	level_tris[l].resize(lsum);
+    }
+    auto scatter = [&](size_t t) {
+	size_t *off = &loffset[t*POP_MAXLEVEL];
+	for (size_t i = rstart[t]; i < rstart[t+1]; i++) {
+	    size_t level = tri_level[i];
+	    if (level < POP_MAXLEVEL)
+		level_tris[level][off[level]++] = i;
+	}
+    };
+    if (nthreads == 1) {
+	scatter(0);
+    } else {
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < nthreads; t++)
+	    workers.push_back(std::thread(scatter, t));
+	for (size_t t = 0; t < nthreads; t++)
+	    workers[t].join();
+    }
 
-	// Let the vertices know they will be needed at this level, if another
-	// triangle doesn't already need them sooner
+    // Let the vertices know which level they will first be needed at
+    for (size_t i = 0; i < faces_cnt; i++) {
+	size_t level = tri_level[i];
+	if (level >= POP_MAXLEVEL)
+	    continue;
 	for (size_t j = 0; j < 3; j++) {
 	    if (vert_tri_minlevel[faces_array[3*i+j]] > level) {
 		vert_tri_minlevel[faces_array[3*i+j]] = level;
@@ -1015,7 +1166,7 @@ POPState::tri_process()
     // The vertices now know when they will first need to appear.  Build level
     // sets of vertices
     for (size_t i = 0; i < vert_tri_minlevel.size(); i++) {
-	level_tri_verts[vert_tri_minlevel[i]].insert(i);
+	level_tri_verts[vert_tri_minlevel[i]].push_back(i);
     }
 
     // Having sorted the vertices into level sets, we may now define a new global
@@ -1025,8 +1176,8 @@ POPState::tri_process()
 	tri_ind_map.push_back(i);
     }
     size_t vind = 0;
-    std::map<size_t, std::unordered_set<size_t>>::iterator l_it;
-    std::unordered_set<size_t>::iterator s_it;
+    std::map<size_t, std::vector<size_t>>::iterator l_it;
+    std::vector<size_t>::iterator s_it;
     for (l_it = level_tri_verts.begin(); l_it != level_tri_verts.end(); l_it++) {
 	for (s_it = l_it->second.begin(); s_it != l_it->second.end(); s_it++) {
 	    tri_ind_map[*s_it] = vind;
@@ -1069,10 +1220,11 @@ POPState::tri_process()
     //bu_log("Max LoD POP level: %zd\n", max_pop_threshold_level);
 }
 
-POPState::POPState(struct bv_mesh_lod_context *ctx, const point_t *v, size_t vcnt, const vect_t *vn, int *faces, size_t fcnt, unsigned long long user_key, fastf_t pop_facecnt_threshold_ratio)
+POPState::POPState(struct bv_mesh_lod_context *ctx, const point_t *v, size_t vcnt, const vect_t *vn, int *faces, size_t fcnt, unsigned long long user_key, fastf_t pop_facecnt_threshold_ratio, size_t nthreads)
 {
     // Store the context
     c = ctx;
+    tthreads = nthreads;
 
     // Caller set parameter telling us when to switch from POP data
     // to just drawing the full mesh
@@ -1272,6 +1424,12 @@ POPState::POPState(struct bv_mesh_lod_context *ctx, unsigned long long key)
 
 POPState::~POPState()
 {
+    if (tracked) {
+	struct bv_mesh_lod_residency *r = c->i->r;
+	std::lock_guard<std::mutex> g(r->lock);
+	r->states.erase(this);
+	r->resident -= rbytes;
+    }
     if (full_detail_free_clbk) {
 	(*full_detail_free_clbk)(lod, detail_clbk_data);
 	detail_clbk_data = NULL;
@@ -1355,6 +1513,29 @@ POPState::shrink_memory()
     lod_tri_pnts_snapped.shrink_to_fit();
 }
 
+size_t
+POPState::resident_bytes()
+{
+    size_t bytes = 0;
+    bytes += lod_tri_pnts.capacity() * sizeof(fastf_t);
+    bytes += lod_tri_pnts_snapped.capacity() * sizeof(fastf_t);
+    bytes += lod_tri_norms.capacity() * sizeof(fastf_t);
+    bytes += lod_tris.capacity() * sizeof(int);
+    return bytes;
+}
+
+// Approximate screen space error of drawing the mesh at level, as a fraction
+// of the view size - each level halves the quantization cell size.
+fastf_t
+POPState::level_error(int level)
+{
+    point_t bmin, bmax;
+    VSET(bmin, minx, miny, minz);
+    VSET(bmax, maxx, maxy, maxz);
+    fastf_t vlen = (last_vlen > SMALL_FASTF) ? last_vlen : 1.0;
+    return DIST_PNT_PNT(bmin, bmax) / pow(2, level) / vlen;
+}
+
 void
 POPState::tri_pop_trim(int level)
 {
@@ -1392,6 +1573,7 @@ int
 POPState::get_level(fastf_t vlen)
 {
     fastf_t delta = 0.01*vlen;
+    last_vlen = vlen;
     point_t bmin, bmax;
     fastf_t bdiag = 0;
     VSET(bmin, minx, miny, minz);
@@ -1544,16 +1726,16 @@ POPState::cache_write(const char *component, std::stringstream &s)
     char *keycstr = bu_strdup(keystr.c_str());
     void *bdata = bu_calloc(buffer.length()+1, sizeof(char), "bdata");
     memcpy(bdata, buffer.data(), buffer.length()*sizeof(char));
-    mdb_txn_begin(c->i->lod_env, NULL, 0, &c->i->lod_txn);
-    mdb_dbi_open(c->i->lod_txn, NULL, 0, &c->i->lod_dbi);
+    mdb_txn_begin(c->i->lod_env, NULL, 0, &txn);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = keystr.length()*sizeof(char);
     mdb_key.mv_data = (void *)keycstr;
     mdb_data[0].mv_size = buffer.length()*sizeof(char);
     mdb_data[0].mv_data = bdata;
     mdb_data[1].mv_size = 0;
     mdb_data[1].mv_data = NULL;
-    int rc = mdb_put(c->i->lod_txn, c->i->lod_dbi, &mdb_key, mdb_data, 0);
-    mdb_txn_commit(c->i->lod_txn);
+    int rc = mdb_put(txn, dbi, &mdb_key, mdb_data, 0);
+    mdb_txn_commit(txn);
     bu_free(keycstr, "keycstr");
     bu_free(bdata, "buffer data");
 
@@ -1575,11 +1757,11 @@ POPState::cache_get(void **data, const char *component)
     //if (keystr.length()*sizeof(char) > mdb_env_get_maxkeysize(c->i->lod_env))
     //	return 0;
     char *keycstr = bu_strdup(keystr.c_str());
-    mdb_txn_begin(c->i->lod_env, NULL, 0, &c->i->lod_txn);
-    mdb_dbi_open(c->i->lod_txn, NULL, 0, &c->i->lod_dbi);
+    mdb_txn_begin(c->i->lod_env, NULL, 0, &txn);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = keystr.length()*sizeof(char);
     mdb_key.mv_data = (void *)keycstr;
-    int rc = mdb_get(c->i->lod_txn, c->i->lod_dbi, &mdb_key, &mdb_data[0]);
+    int rc = mdb_get(txn, dbi, &mdb_key, &mdb_data[0]);
     if (rc) {
 	bu_free(keycstr, "keycstr");
 	(*data) = NULL;
@@ -1594,7 +1776,7 @@ POPState::cache_get(void **data, const char *component)
 void
 POPState::cache_done()
 {
-    mdb_txn_commit(c->i->lod_txn);
+    mdb_txn_commit(txn);
 }
 
 bool
@@ -1665,7 +1847,7 @@ POPState::cache_tri()
 	    if (!level_tri_verts[i].size())
 		continue;
 	    // Write out the vertex points
-	    std::unordered_set<size_t>::iterator s_it;
+	    std::vector<size_t>::iterator s_it;
 	    for (s_it = level_tri_verts[i].begin(); s_it != level_tri_verts[i].end(); s_it++) {
 		point_t v;
 		VMOVE(v, verts_array[*s_it]);
@@ -1912,6 +2094,103 @@ bv_mesh_lod_cache(struct bv_mesh_lod_context *c, const point_t *v, size_t vcnt,
     return key;
 }
 
+static void
+lod_cache_worker(struct bv_mesh_lod_context *c)
+{
+    struct bv_mesh_lod_jobs *j = c->i->j;
+    std::unique_lock<std::mutex> lk(j->lock);
+    while (true) {
+	j->idle++;
+	j->cv.wait(lk, [j]{ return j->shutdown || !j->queue.empty(); });
+	j->idle--;
+	if (j->queue.empty())
+	    return;
+
+	bv_mesh_lod_job job = j->queue.front();
+	j->queue.pop_front();
+	j->active++;
+	// Split the available processors between the active jobs - a lone
+	// large mesh gets all of them.
+	size_t nthreads = j->max_active / j->active;
+	lk.unlock();
+
+	unsigned long long key = 0;
+	{
+	    POPState p(c, job.v, job.vcnt, job.vn, job.faces, job.fcnt, job.user_key, job.fratio, nthreads);
+	    if (p.is_valid)
+		key = p.hash;
+	}
+	if (key)
+	    bv_mesh_lod_key_put(c, job.name.c_str(), key);
+	if (job.release)
+	    (*job.release)(job.rdata);
+
+	lk.lock();
+	j->active--;
+	j->running.erase(job.name);
+	j->cv.notify_all();
+    }
+}
+
+// Stop the worker pool.  Callers wait for the queue to drain first.
+static void
+lod_jobs_shutdown(struct bv_mesh_lod_jobs *j)
+{
+    {
+	std::lock_guard<std::mutex> g(j->lock);
+	j->shutdown = true;
+    }
+    j->cv.notify_all();
+    for (size_t i = 0; i < j->workers.size(); i++)
+	j->workers[i].join();
+    j->workers.clear();
+}
+
+extern "C" int
+bv_mesh_lod_cache_bg(struct bv_mesh_lod_context *c, const char *name, const point_t *v, size_t vcnt, const vect_t *vn, int *faces, size_t fcnt, unsigned long long user_key, double fratio, void (*release)(void *), void *rdata)
+{
+    if (!c || !name || !v || !vcnt || !faces || !fcnt)
+	return -1;
+
+    struct bv_mesh_lod_jobs *j = c->i->j;
+    std::lock_guard<std::mutex> g(j->lock);
+    std::string sname(name);
+    if (j->running.find(sname) != j->running.end())
+	return 1;
+
+    j->running.insert(sname);
+    j->queue.push_back({sname, v, vcnt, vn, faces, fcnt, user_key, fratio, release, rdata});
+
+    // Only start another worker if none is free to take the job
+    if (j->idle < j->queue.size() && j->workers.size() < j->max_active)
+	j->workers.push_back(std::thread(lod_cache_worker, c));
+    j->cv.notify_all();
+    return 0;
+}
+
+extern "C" int
+bv_mesh_lod_cache_pending(struct bv_mesh_lod_context *c, const char *name)
+{
+    if (!c || !name)
+	return 0;
+
+    struct bv_mesh_lod_jobs *j = c->i->j;
+    std::lock_guard<std::mutex> g(j->lock);
+    return (j->running.find(std::string(name)) != j->running.end()) ? 1 : 0;
+}
+
+extern "C" size_t
+bv_mesh_lod_cache_wait(struct bv_mesh_lod_context *c, size_t max_pending)
+{
+    if (!c)
+	return 0;
+
+    struct bv_mesh_lod_jobs *j = c->i->j;
+    std::unique_lock<std::mutex> lk(j->lock);
+    j->cv.wait(lk, [j, max_pending]{ return j->running.size() <= max_pending; });
+    return j->running.size();
+}
+
 extern "C" struct bv_mesh_lod *
 bv_mesh_lod_create(struct bv_mesh_lod_context *c, unsigned long long key)
 {
@@ -1933,8 +2212,17 @@ bv_mesh_lod_create(struct bv_mesh_lod_context *c, unsigned long long key)
     BU_GET(lod->i, struct bv_mesh_lod_internal);
     ((struct bv_mesh_lod_internal *)lod->i)->s = p;
     lod->c = (void *)c;
+    lod->s = NULL;
     p->lod = lod;
 
+    // Register with the context, so its memory budget covers this mesh
+    {
+	struct bv_mesh_lod_residency *r = c->i->r;
+	std::lock_guard<std::mutex> g(r->lock);
+	r->states.insert(p);
+	p->tracked = true;
+    }
+
     // Important - parent codes need to have a sense of the size of
     // the object, and we want that size to be consistent regardless
     // of the LoD actually in use.  Set the bbox dimensions at a level
@@ -1969,6 +2257,147 @@ dlist_stale(struct bv_scene_obj *s)
     s->s_dlist_stale = 1;
 }
 
+// Point the drawing container at the POPState's current level data
+static void
+lod_sync(struct bv_mesh_lod *l, POPState *sp)
+{
+    // If we're in POP territory use the local arrays - otherwise, they
+    // were already set by the full detail callback.
+    if (sp->curr_level > sp->max_pop_threshold_level)
+	return;
+
+    l->fcnt = (int)sp->lod_tris.size()/3;
+    l->faces = sp->lod_tris.data();
+    l->points_orig = (const point_t *)sp->lod_tri_pnts.data();
+    l->porig_cnt = (int)sp->lod_tri_pnts.size();
+#if 0
+    // TODO - there's still some error with normals - they seem to work,
+    // but when zooming way out and back in (at least on Windows) we're
+    // getting an access violation with some geometry...
+    if (sp->lod_tri_norms.size() >= sp->lod_tris.size()) {
+	l->normals = (const vect_t *)sp->lod_tri_norms.data();
+    } else {
+	l->normals = NULL;
+    }
+#else
+    l->normals = NULL;
+#endif
+    l->points = (const point_t *)sp->lod_tri_pnts_snapped.data();
+    l->pcnt = (int)sp->lod_tri_pnts_snapped.size();
+}
+
+// Caller must hold the residency lock
+static void
+lod_residency_update(struct bv_mesh_lod_residency *r, POPState *sp)
+{
+    size_t nbytes = sp->resident_bytes();
+    r->resident = r->resident - sp->rbytes + nbytes;
+    sp->rbytes = nbytes;
+    if (r->resident > r->peak)
+	r->peak = r->resident;
+}
+
+// Release level data from other meshes until the context is back under its
+// budget.  Meshes not visible in their view go first (all their data is
+// released - if they have no display list they will reload when drawn).
+// After that, visible meshes are stepped down one level at a time, picking
+// the mesh whose screen space error grows the least each time.  The mesh
+// that triggered the check is left alone.
+static void
+lod_residency_enforce(struct bv_mesh_lod_residency *r, POPState *keep)
+{
+    if (!r->budget)
+	return;
+
+    while (r->resident > r->budget) {
+	POPState *victim = NULL;
+	bool victim_visible = true;
+	fastf_t victim_err = MAX_FASTF;
+	std::unordered_set<POPState *>::iterator s_it;
+	for (s_it = r->states.begin(); s_it != r->states.end(); s_it++) {
+	    POPState *sp = *s_it;
+	    if (sp == keep || !sp->rbytes || !sp->lod)
+		continue;
+	    if (sp->curr_level < 0 || sp->curr_level > sp->max_pop_threshold_level)
+		continue;
+	    struct bv_scene_obj *s = sp->lod->s;
+	    if (s && s->s_v && !_obj_visible(s, s->s_v)) {
+		victim = sp;
+		victim_visible = false;
+		break;
+	    }
+	    if (!sp->curr_level)
+		continue;
+	    fastf_t err = sp->level_error(sp->curr_level - 1);
+	    if (err < victim_err) {
+		victim_err = err;
+		victim = sp;
+	    }
+	}
+	if (!victim)
+	    break;
+
+	struct bv_scene_obj *vs = victim->lod->s;
+	if (victim_visible) {
+	    victim->set_level(victim->curr_level - 1);
+	    lod_sync(victim->lod, victim);
+	    if (vs)
+		dlist_stale(vs);
+	} else {
+	    victim->shrink_memory();
+	    victim->force_update = true;
+	    lod_sync(victim->lod, victim);
+	    if (vs && !vs->s_dlist)
+		dlist_stale(vs);
+	}
+	lod_residency_update(r, victim);
+	r->evictions++;
+    }
+}
+
+static void
+lod_residency_detach(struct bv_mesh_lod_residency *r)
+{
+    if (!r)
+	return;
+    std::lock_guard<std::mutex> g(r->lock);
+    std::unordered_set<POPState *>::iterator s_it;
+    for (s_it = r->states.begin(); s_it != r->states.end(); s_it++)
+	(*s_it)->tracked = false;
+    r->states.clear();
+}
+
+extern "C" void
+bv_mesh_lod_budget_set(struct bv_mesh_lod_context *c, size_t bytes)
+{
+    if (!c)
+	return;
+    struct bv_mesh_lod_residency *r = c->i->r;
+    std::lock_guard<std::mutex> g(r->lock);
+    r->budget = bytes;
+    lod_residency_enforce(r, NULL);
+}
+
+extern "C" void
+bv_mesh_lod_stats_get(struct bv_mesh_lod_context *c, struct bv_mesh_lod_stats *stats)
+{
+    if (!c || !stats)
+	return;
+    struct bv_mesh_lod_residency *r = c->i->r;
+    std::lock_guard<std::mutex> g(r->lock);
+    stats->budget = r->budget;
+    stats->resident = r->resident;
+    stats->peak = r->peak;
+    stats->meshes = r->states.size();
+    stats->resident_meshes = 0;
+    stats->evictions = r->evictions;
+    std::unordered_set<POPState *>::iterator s_it;
+    for (s_it = r->states.begin(); s_it != r->states.end(); s_it++) {
+	if ((*s_it)->rbytes)
+	    stats->resident_meshes++;
+    }
+}
+
 extern "C" int
 bv_mesh_lod_level(struct bv_scene_obj *s, int level, int reset)
 {
@@ -1985,30 +2414,18 @@ bv_mesh_lod_level(struct bv_scene_obj *s, int level, int reset)
 
     int old_level = sp->curr_level;
 
-    sp->force_update = (reset) ? true : false;
+    // A pending forced update may also have been requested by the residency
+    // manager releasing this mesh's data.
+    sp->force_update = (reset || sp->force_update) ? true : false;
     sp->set_level(level);
+    lod_sync(l, sp);
 
-    // If we're in POP territory use the local arrays - otherwise, they
-    // were already set by the full detail callback.
-    if (sp->curr_level <= sp->max_pop_threshold_level) {
-	l->fcnt = (int)sp->lod_tris.size()/3;
-	l->faces = sp->lod_tris.data();
-	l->points_orig = (const point_t *)sp->lod_tri_pnts.data();
-	l->porig_cnt = (int)sp->lod_tri_pnts.size();
-#if 0
-	// TODO - there's still some error with normals - they seem to work,
-	// but when zooming way out and back in (at least on Windows) we're
-	// getting an access violation with some geometry...
-	if (sp->lod_tri_norms.size() >= sp->lod_tris.size()) {
-	    l->normals = (const vect_t *)sp->lod_tri_norms.data();
-	} else {
-	    l->normals = NULL;
-	}
-#else
-	l->normals = NULL;
-#endif
-	l->points = (const point_t *)sp->lod_tri_pnts_snapped.data();
-	l->pcnt = (int)sp->lod_tri_pnts_snapped.size();
+    // Account for the new data, making room for it if need be
+    if (sp->tracked) {
+	struct bv_mesh_lod_residency *r = ((struct bv_mesh_lod_context *)l->c)->i->r;
+	std::lock_guard<std::mutex> g(r->lock);
+	lod_residency_update(r, sp);
+	lod_residency_enforce(r, sp);
     }
 
     bv_log(2, "bv_mesh_lod_level %s[%d](%d): %d", bu_vls_cstr(&s->s_name), level, reset, l->fcnt);
@@ -2060,6 +2477,11 @@ bv_mesh_lod_memshrink(struct bv_scene_obj *s)
     struct bv_mesh_lod_internal *i = (struct bv_mesh_lod_internal *)l->i;
     POPState *sp = i->s;
     sp->shrink_memory();
+    if (sp->tracked) {
+	struct bv_mesh_lod_residency *r = ((struct bv_mesh_lod_context *)l->c)->i->r;
+	std::lock_guard<std::mutex> g(r->lock);
+	lod_residency_update(r, sp);
+    }
     bu_log("memshrink\n");
 }
 
@@ -2084,6 +2506,10 @@ bv_mesh_lod_clear_cache(struct bv_mesh_lod_context *c, unsigned long long key)
 {
     char dir[MAXPATHLEN];
 
+    // Don't pull the data out from under background jobs
+    if (c)
+	bv_mesh_lod_cache_wait(c, 0);
+
     if (c && key) {
 	// For this case, we're clearing the data associated with a
 	// specific key (for example, if we're about to edit a BoT but
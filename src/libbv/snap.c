@@ -178,16 +178,26 @@ _find_closest_obj_point(struct bv_cp_info *s, point_t *p, struct bv_scene_obj *o
     int ret = 0;
     if (!s || !p || !o)
 	return 0;
-    if (!bu_list_len(&o->s_vlist))
+
+    // Shared vlists hold local coordinates - their points are moved into
+    // place with the instance matrix before testing.
+    struct bu_list *vhead = &o->s_vlist;
+    int instanced = 0;
+    if (o->s_type_flags & BV_SHARED_VLIST && o->draw_data) {
+	vhead = &((struct bv_vlist_shared *)o->draw_data)->vlist;
+	instanced = 1;
+    }
+    if (!bu_list_len(vhead))
 	return 0;
 
     struct bv_vlist *tvp;
-    for (BU_LIST_FOR(tvp, bv_vlist, &o->s_vlist)) {
+    for (BU_LIST_FOR(tvp, bv_vlist, vhead)) {
 	int nused = tvp->nused;
 	int *cmd = tvp->cmd;
 	point_t *pt = tvp->pt;
 	point_t *pt1 = NULL;
 	point_t *pt2 = NULL;
+	point_t ipt1, ipt2;
 	for (int i = 0; i < nused; i++, cmd++, pt++) {
 	    switch (*cmd) {
 		case BV_VLIST_LINE_MOVE:
@@ -200,7 +210,14 @@ _find_closest_obj_point(struct bv_cp_info *s, point_t *p, struct bv_scene_obj *o
 	    }
 	    if (pt1 && pt2) {
 		point_t c;
-		double dsq = bg_distsq_lseg3_pt(&c, *pt1, *pt2, *p);
+		if (instanced) {
+		    MAT4X3PNT(ipt1, o->s_mat, *pt1);
+		    MAT4X3PNT(ipt2, o->s_mat, *pt2);
+		} else {
+		    VMOVE(ipt1, *pt1);
+		    VMOVE(ipt2, *pt2);
+		}
+		double dsq = bg_distsq_lseg3_pt(&c, ipt1, ipt2, *p);
 		// If we're outside tolerance, continue
 		if (dsq > s->ctol_sq) {
 		    continue;
@@ -0,0 +1,111 @@
+/*                   V L I S T _ C A C H E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/* Exercise the shared vlist cache - lookups, reference counting, duplicate
+ * stores, and entries outliving the cache that produced them.  The argument
+ * is the number of points to put in the test vlist.
+ */
+
+#include "common.h"
+
+#include <string.h>
+#include "bu.h"
+#include "bv.h"
+
+static void
+vlist_cache_mk(struct bu_list *vlfree, struct bu_list *head, int npts)
+{
+    BU_LIST_INIT(head);
+    for (int i = 0; i < npts; i++) {
+	point_t p;
+	VSET(p, i, -i, 2*i);
+	BV_ADD_VLIST(vlfree, head, p, (i) ? BV_VLIST_LINE_DRAW : BV_VLIST_LINE_MOVE);
+    }
+}
+
+int
+vlist_cache_main(int argc, char* argv[])
+{
+    struct bu_list vlfree;
+    struct bu_list head;
+    int npts = 0;
+
+    if (argc < 2) {
+	bu_exit(1, "ERROR: input format is test_args [%s]\n", argv[0]);
+    }
+    sscanf(argv[1], "%d", &npts);
+    if (npts < 1)
+	bu_exit(1, "ERROR: need at least one point\n");
+
+    BU_LIST_INIT(&vlfree);
+
+    struct bv_vlist_cache *c = bv_vlist_cache_create();
+    if (bv_vlist_cache_get(c, 1))
+	bu_exit(1, "ERROR: lookup in empty cache succeeded\n");
+
+    vlist_cache_mk(&vlfree, &head, npts);
+    struct bv_vlist_shared *sv = bv_vlist_cache_put(c, 1, &head);
+    if (!sv || BU_LIST_NON_EMPTY(&head))
+	bu_exit(1, "ERROR: put did not take the vlist\n");
+    if (sv->vlen != (size_t)npts || sv->refcnt != 1)
+	bu_exit(1, "ERROR: put - vlen %zu, refcnt %zu\n", sv->vlen, sv->refcnt);
+    if (!EQUAL(sv->bmax[X], npts - 1) || !EQUAL(sv->bmin[Y], -(npts - 1)))
+	bu_exit(1, "ERROR: bad bounding box\n");
+
+    /* Lookups and duplicate stores share the one entry */
+    struct bv_vlist_shared *sv2 = bv_vlist_cache_get(c, 1);
+    vlist_cache_mk(&vlfree, &head, npts);
+    struct bv_vlist_shared *sv3 = bv_vlist_cache_put(c, 1, &head);
+    if (sv2 != sv || sv3 != sv || sv->refcnt != 3 || bv_vlist_cache_size(c) != 1)
+	bu_exit(1, "ERROR: entry not shared\n");
+
+    /* Entry stays while referenced, goes away with the last reference */
+    bv_vlist_shared_put(sv2);
+    bv_vlist_shared_put(sv3);
+    if (bv_vlist_cache_size(c) != 1 || bv_vlist_cache_get(c, 1) != sv)
+	bu_exit(1, "ERROR: entry released early\n");
+    bv_vlist_shared_put(sv);
+    bv_vlist_shared_put(sv);
+    if (bv_vlist_cache_size(c) != 0 || bv_vlist_cache_get(c, 1))
+	bu_exit(1, "ERROR: entry not released\n");
+
+    /* Referenced entries survive the cache */
+    vlist_cache_mk(&vlfree, &head, npts);
+    sv = bv_vlist_cache_put(c, 2, &head);
+    bv_vlist_cache_destroy(c);
+    if (sv->c || sv->vlen != (size_t)npts)
+	bu_exit(1, "ERROR: entry not detached from destroyed cache\n");
+    bv_vlist_shared_put(sv);
+
+    bv_vlist_cleanup(&vlfree);
+
+    return 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
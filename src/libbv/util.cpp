@@ -1239,6 +1239,12 @@ bv_obj_reset(struct bv_scene_obj *s)
     }
     BU_LIST_INIT(&(s->s_vlist));
 
+    // release shared vlist reference, if any
+    if (s->s_type_flags & BV_SHARED_VLIST) {
+	bv_vlist_shared_put((struct bv_vlist_shared *)s->draw_data);
+	s->s_type_flags &= ~BV_SHARED_VLIST;
+    }
+
     if (!BU_VLS_IS_INITIALIZED(&s->s_name))
 	BU_VLS_INIT(&s->s_name);
     bu_vls_trunc(&s->s_name, 0);
@@ -1526,6 +1532,21 @@ bv_find_child(struct bv_scene_obj *s, const char *vname)
     return NULL;
 }
 
+/* Shared vlists are stored in local coordinates - bound all eight corners of
+ * the local box under the instance matrix to get the instance box. */
+static void
+_bv_shared_vlist_bound(point_t *bmin, point_t *bmax, const mat_t mat, struct bv_vlist_shared *sv)
+{
+    VSETALL(*bmin, INFINITY);
+    VSETALL(*bmax, -INFINITY);
+    for (int i = 0; i < 8; i++) {
+	point_t lpt, wpt;
+	VSET(lpt, (i & 1) ? sv->bmax[X] : sv->bmin[X], (i & 2) ? sv->bmax[Y] : sv->bmin[Y], (i & 4) ? sv->bmax[Z] : sv->bmin[Z]);
+	MAT4X3PNT(wpt, mat, lpt);
+	VMINMAX(*bmin, *bmax, wpt);
+    }
+}
+
 int
 bv_scene_obj_bound(struct bv_scene_obj *sp, struct bview *v)
 {
@@ -1551,6 +1572,13 @@ bv_scene_obj_bound(struct bv_scene_obj *sp, struct bview *v)
 	    MAT4X3PNT(s->bmax, s->s_mat, obmax);
 	    calc = 1;
 	}
+    } else if (s->s_type_flags & BV_SHARED_VLIST) {
+	struct bv_vlist_shared *sv = (struct bv_vlist_shared *)s->draw_data;
+	if (sv && sv->vlen) {
+	    _bv_shared_vlist_bound(&s->bmin, &s->bmax, s->s_mat, sv);
+	    s->s_displayobj = sv->dispmode;
+	    calc = 1;
+	}
     } else if (bu_list_len(&s->s_vlist)) {
 	int dismode;
 	cmd = bv_vlist_bbox(&s->s_vlist, &s->bmin, &s->bmax, NULL, &dismode);
@@ -1579,6 +1607,12 @@ bv_scene_obj_bound(struct bv_scene_obj *sp, struct bview *v)
 		    MAT4X3PNT(lv->bmax, lv->s_mat, obmax);
 		    calc = 1;
 		}
+	    } else if (lv->s_type_flags & BV_SHARED_VLIST) {
+		struct bv_vlist_shared *sv = (struct bv_vlist_shared *)lv->draw_data;
+		if (sv && sv->vlen) {
+		    _bv_shared_vlist_bound(&lv->bmin, &lv->bmax, lv->s_mat, sv);
+		    calc = 1;
+		}
 	    } else if (bu_list_len(&lv->s_vlist)) {
 		int dismode;
 		cmd = bv_vlist_bbox(&lv->s_vlist, &lv->bmin, &lv->bmax, NULL, &dismode);
@@ -1615,6 +1649,52 @@ bv_scene_obj_bound(struct bv_scene_obj *sp, struct bview *v)
     return 0;
 }
 
+struct bu_list *
+bv_obj_vlist(struct bv_scene_obj *s, mat_t mat)
+{
+    if (s->s_type_flags & BV_SHARED_VLIST && s->draw_data) {
+	MAT_COPY(mat, s->s_mat);
+	return &((struct bv_vlist_shared *)s->draw_data)->vlist;
+    }
+    MAT_IDN(mat);
+    return &s->s_vlist;
+}
+
+void
+bv_obj_vlist_copy(struct bu_list *dest, struct bv_scene_obj *s)
+{
+    mat_t mat;
+    struct bu_list *vhead = bv_obj_vlist(s, mat);
+    struct bv_vlist *vp;
+
+    for (BU_LIST_FOR(vp, bv_vlist, vhead)) {
+	size_t nused = vp->nused;
+	int *cmd = vp->cmd;
+	point_t *pt = vp->pt;
+	for (size_t i = 0; i < nused; i++, cmd++, pt++) {
+	    point_t npt;
+	    switch (*cmd) {
+		case BV_VLIST_POLY_START:
+		case BV_VLIST_POLY_VERTNORM:
+		case BV_VLIST_TRI_START:
+		case BV_VLIST_TRI_VERTNORM:
+		    MAT4X3VEC(npt, mat, *pt);
+		    if (MAGSQ(npt) > SMALL_FASTF)
+			VUNITIZE(npt);
+		    break;
+		case BV_VLIST_POINT_SIZE:
+		case BV_VLIST_LINE_WIDTH:
+		    VMOVE(npt, *pt);
+		    break;
+		default:
+		    MAT4X3PNT(npt, mat, *pt);
+		    break;
+	    }
+	    BV_ADD_VLIST(s->vlfree, dest, npt, *cmd);
+	}
+    }
+}
+
 fastf_t
 bv_vZ_calc(struct bv_scene_obj *s, struct bview *v, int mode)
 {
@@ -1630,13 +1710,19 @@ bv_vZ_calc(struct bv_scene_obj *s, struct bview *v, int mode)
 
     double calc_val = (calc_mode) ? -DBL_MAX : DBL_MAX;
     int have_val = 0;
+
+    // Shared vlists hold local coordinates - fold the instance matrix in
+    mat_t omat, m2v;
+    struct bu_list *vhead = bv_obj_vlist(s, omat);
+    bn_mat_mul(m2v, v->gv_model2view, omat);
+
     struct bv_vlist *tvp;
-    for (BU_LIST_FOR(tvp, bv_vlist, &((struct bv_vlist *)(&s->s_vlist))->l)) {
+    for (BU_LIST_FOR(tvp, bv_vlist, vhead)) {
 	size_t nused = tvp->nused;
 	point_t *lpt = tvp->pt;
 	for (size_t l = 0; l < nused; l++, lpt++) {
 	    vect_t vpt;
-	    MAT4X3PNT(vpt, v->gv_model2view, *lpt);
+	    MAT4X3PNT(vpt, m2v, *lpt);
 	    if (calc_mode) {
 		if (vpt[Z] > calc_val) {
 		    calc_val = vpt[Z];
@@ -0,0 +1,166 @@
+/*                  V L I S T _ C A C H E . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file vlist_cache.cpp
+ *
+ * Reference counted vlists shared between instanced scene objects.
+ *
+ * The cache only holds weak references - an entry lives exactly as long as
+ * some scene object is using it.  That means there is no need for explicit
+ * invalidation when the source geometry changes, provided the caller's key
+ * reflects the geometry content: an edited object simply produces a new key,
+ * and the old entry goes away when the last instance using it is redrawn.
+ */
+
+#include "common.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "vmath.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bv/vlist.h"
+
+struct bv_vlist_cache {
+    std::mutex lock;
+    std::unordered_map<unsigned long long, struct bv_vlist_shared *> entries;
+};
+
+struct bv_vlist_cache *
+bv_vlist_cache_create(void)
+{
+    return new bv_vlist_cache;
+}
+
+void
+bv_vlist_cache_destroy(struct bv_vlist_cache *c)
+{
+    if (!c)
+	return;
+
+    // Entries still referenced by scene objects outlive the cache - detach
+    // them so their final release doesn't reach back into freed memory.
+    {
+	std::lock_guard<std::mutex> g(c->lock);
+	std::unordered_map<unsigned long long, struct bv_vlist_shared *>::iterator e_it;
+	for (e_it = c->entries.begin(); e_it != c->entries.end(); e_it++)
+	    e_it->second->c = NULL;
+	c->entries.clear();
+    }
+
+    delete c;
+}
+
+struct bv_vlist_shared *
+bv_vlist_cache_get(struct bv_vlist_cache *c, unsigned long long key)
+{
+    if (!c)
+	return NULL;
+
+    std::lock_guard<std::mutex> g(c->lock);
+    std::unordered_map<unsigned long long, struct bv_vlist_shared *>::iterator e_it = c->entries.find(key);
+    if (e_it == c->entries.end())
+	return NULL;
+
+    e_it->second->refcnt++;
+    return e_it->second;
+}
+
+struct bv_vlist_shared *
+bv_vlist_cache_put(struct bv_vlist_cache *c, unsigned long long key, struct bu_list *vlist)
+{
+    if (!c || !vlist)
+	return NULL;
+
+    // Do the (potentially large) bounding calculation before taking the
+    // lock, so concurrent plotting threads don't serialize on it.
+    struct bv_vlist_shared *sv;
+    BU_GET(sv, struct bv_vlist_shared);
+    BU_LIST_INIT(&sv->vlist);
+    if (BU_LIST_IS_INITIALIZED(vlist) && BU_LIST_NON_EMPTY(vlist))
+	BU_LIST_APPEND_LIST(&sv->vlist, vlist);
+    sv->key = key;
+    sv->refcnt = 1;
+    sv->c = c;
+    VSETALL(sv->bmin, INFINITY);
+    VSETALL(sv->bmax, -INFINITY);
+    if (BU_LIST_NON_EMPTY(&sv->vlist)) {
+	int cmd = bv_vlist_bbox(&sv->vlist, &sv->bmin, &sv->bmax, &sv->vlen, &sv->dispmode);
+	if (cmd)
+	    bu_log("bv_vlist_cache_put: unknown vlist op %d\n", cmd);
+    }
+
+    std::lock_guard<std::mutex> g(c->lock);
+    std::unordered_map<unsigned long long, struct bv_vlist_shared *>::iterator e_it = c->entries.find(key);
+    if (e_it != c->entries.end()) {
+	// Lost a race with another producer of the same data - use theirs.
+	bv_vlist_cleanup(&sv->vlist);
+	BU_PUT(sv, struct bv_vlist_shared);
+	e_it->second->refcnt++;
+	return e_it->second;
+    }
+
+    c->entries[key] = sv;
+    return sv;
+}
+
+void
+bv_vlist_shared_put(struct bv_vlist_shared *sv)
+{
+    if (!sv)
+	return;
+
+    struct bv_vlist_cache *c = sv->c;
+    if (c) {
+	std::lock_guard<std::mutex> g(c->lock);
+	if (sv->refcnt > 1) {
+	    sv->refcnt--;
+	    return;
+	}
+	c->entries.erase(sv->key);
+    } else if (sv->refcnt > 1) {
+	// Detached from a destroyed cache - only the owning scene objects
+	// can still see it, and they are serialized by their caller.
+	sv->refcnt--;
+	return;
+    }
+
+    bv_vlist_cleanup(&sv->vlist);
+    BU_PUT(sv, struct bv_vlist_shared);
+}
+
+size_t
+bv_vlist_cache_size(struct bv_vlist_cache *c)
+{
+    if (!c)
+	return 0;
+
+    std::lock_guard<std::mutex> g(c->lock);
+    return c->entries.size();
+}
+
+// Local Variables:
+// tab-width: 8
+// mode: C++
+// c-basic-offset: 4
+// indent-tabs-mode: t
+// c-file-style: "stroustrup"
+// End:
+// ex: shiftwidth=4 tabstop=8
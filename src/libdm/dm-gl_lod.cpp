@@ -551,6 +551,26 @@ int gl_draw_obj(struct dm *dmp, struct bv_scene_obj *s)
 	return gl_csg_lod(dmp, s);
     }
 
+    // Instanced objects share one local coordinate vlist - rather than
+    // transforming the vertices, fold the instance matrix into the view
+    // matrix for the duration of the draw.
+    if (s->s_type_flags & BV_SHARED_VLIST) {
+	struct bv_vlist_shared *sv = (struct bv_vlist_shared *)s->draw_data;
+	if (!sv || !s->s_v)
+	    return BRLCAD_ERROR;
+	mat_t save_mat, draw_mat;
+	MAT_COPY(save_mat, s->s_v->gv_model2view);
+	bn_mat_mul(draw_mat, s->s_v->gv_model2view, s->s_mat);
+	dm_loadmatrix(dmp, draw_mat, 0);
+	if (s->s_os->s_dmode == 4) {
+	    dm_draw_vlist_hidden_line(dmp, (struct bv_vlist *)&sv->vlist);
+	} else {
+	    dm_draw_vlist(dmp, (struct bv_vlist *)&sv->vlist);
+	}
+	dm_loadmatrix(dmp, save_mat, 0);
+	return BRLCAD_OK;
+    }
+
     // "Standard" vlist object drawing
     if (bu_list_len(&s->s_vlist)) {
 	if (s->s_os->s_dmode == 4) {
@@ -43,6 +43,7 @@ static void
 drop_client(struct fbserv_obj *fbsp, int sub)
 {
     if (fbsp->fbs_clients[sub].fbsc_pkg != PKC_NULL) {
+	fbs_shm_release(fbsp->fbs_clients[sub].fbsc_pkg);
 	pkg_close(fbsp->fbs_clients[sub].fbsc_pkg);
 	fbsp->fbs_clients[sub].fbsc_pkg = PKC_NULL;
     }
@@ -660,6 +661,32 @@ fbs_rfbpoll(struct pkg_conn *pcp, char *buf)
 }
 
 
+static void
+fbs_rfbshmopen(struct pkg_conn *pcp, char *buf)
+{
+    struct fb *curr_fbp = (struct fb *)pcp->pkc_server_data;
+
+    fbs_shm_open(pcp, curr_fbp);
+
+    if (buf) {
+	(void)free(buf);
+    }
+}
+
+
+static void
+fbs_rfbshmsync(struct pkg_conn *pcp, char *buf)
+{
+    struct fb *curr_fbp = (struct fb *)pcp->pkc_server_data;
+
+    fbs_shm_sync(pcp, curr_fbp, buf);
+
+    if (buf) {
+	(void)free(buf);
+    }
+}
+
+
 /*
  * At one time at least we couldn't send a zero length PKG message
  * back and forth, so we receive a dummy long here.
@@ -784,6 +811,9 @@ fbs_pkg_switch(void)
 	{ MSG_FBPOLL, fbs_rfbpoll, "Handle Events", NULL },
 	{ MSG_FBSETCURSOR, fbs_rfbsetcursor, "Set Cursor Shape", NULL },
 	{ MSG_FBSETCURSOR + MSG_NORETURN, fbs_rfbsetcursor, "Set Cursor Shape", NULL },
+	{ MSG_FBSHMOPEN, fbs_rfbshmopen, "Open Shared Memory", NULL },
+	{ MSG_FBSHMSYNC, fbs_rfbshmsync, "Apply Shared Memory Writes", NULL },
+	{ MSG_FBSHMSYNC + MSG_NORETURN, fbs_rfbshmsync, "Apply Shared Memory Writes", NULL },
 	{ 0, NULL, NULL, NULL }
     };
 
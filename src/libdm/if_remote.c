@@ -61,6 +61,7 @@
 #define MAX_HOSTNAME 128
 #define PCP(ptr)	((struct pkg_conn *)((ptr)->i->u1.p))
 #define PCPL(ptr)	((ptr)->i->u1.p)	/* left hand side version */
+#define SHMP(ptr)	((struct fb_shm_client *)((ptr)->i->u2.p))
 
 
 /* Package Handlers. */
@@ -199,6 +200,164 @@ rem_log(const char *msg)
 }
 
 
+/*
+ * True if both ends of the connection are on this host, so that
+ * pixels can be handed over in shared memory (see if_shm.c).
+ */
+static int
+rem_is_local(int fd)
+{
+#ifdef HAVE_SYS_SOCKET_H
+    struct sockaddr_storage here, there;
+    socklen_t len;
+
+    len = sizeof(here);
+    if (getsockname(fd, (struct sockaddr *)&here, &len) < 0)
+	return 0;
+    len = sizeof(there);
+    if (getpeername(fd, (struct sockaddr *)&there, &len) < 0)
+	return 0;
+    if (here.ss_family != there.ss_family)
+	return 0;
+
+    switch (here.ss_family) {
+	case AF_INET:
+	    return ((struct sockaddr_in *)&here)->sin_addr.s_addr
+		== ((struct sockaddr_in *)&there)->sin_addr.s_addr;
+#ifdef AF_INET6
+	case AF_INET6:
+	    return !memcmp(&((struct sockaddr_in6 *)&here)->sin6_addr,
+			   &((struct sockaddr_in6 *)&there)->sin6_addr,
+			   sizeof(struct in6_addr));
+#endif
+#ifdef AF_UNIX
+	case AF_UNIX:
+	    return 1;
+#endif
+    }
+#else
+    (void)fd;
+#endif
+    return 0;
+}
+
+
+/*
+ * Tell the server to apply the writes queued in shared memory.  With
+ * wait set, also hold off until it has, so that pixels we then send
+ * over the socket can't be overtaken by ones still in the ring.
+ */
+static int
+rem_shm_sync(struct fb *ifp, long op, int wait)
+{
+    unsigned char buf[NET_LONG_LEN+1];
+
+    *(uint32_t *)&buf[0*NET_LONG_LEN] = htonl(op);
+    if (!wait)
+	return (pkg_send(MSG_FBSHMSYNC+MSG_NORETURN, (const char *)buf, NET_LONG_LEN, PCP(ifp)) < NET_LONG_LEN) ? -1 : 0;
+
+    if (pkg_send(MSG_FBSHMSYNC, (const char *)buf, NET_LONG_LEN, PCP(ifp)) < NET_LONG_LEN)
+	return -1;
+    if (pkg_waitfor (MSG_RETURN, (char *)buf, NET_LONG_LEN, PCP(ifp)) < 1*NET_LONG_LEN)
+	return -1;
+    return 0;
+}
+
+
+/*
+ * Queue a write in shared memory.  Returns 0 if it went in the ring,
+ * or -1 if the caller should send it over the socket instead.
+ */
+static int
+rem_shm_put(struct fb *ifp, int kind, int x, int y, int w, int h, const unsigned char *pp)
+{
+    int ret;
+
+    if (!SHMP(ifp))
+	return -1;
+
+    ret = fb_shm_put(SHMP(ifp), kind, x, y, w, h, pp);
+    if (ret == -2) {
+	/* ring is full, wait for the server to catch up */
+	if (rem_shm_sync(ifp, FB_SHM_DRAIN, 1) < 0)
+	    return -1;
+	ret = fb_shm_put(SHMP(ifp), kind, x, y, w, h, pp);
+    }
+    if (ret < 0) {
+	/* off the image, let the server sort it out once the ring is empty */
+	(void)rem_shm_sync(ifp, FB_SHM_DRAIN, 1);
+	return -1;
+    }
+    if (ret > 0 && rem_shm_sync(ifp, FB_SHM_DRAIN, 0) < 0)
+	return -1;
+    return 0;
+}
+
+
+/*
+ * Offer to take pixel traffic off the socket when the server is on
+ * this host.  The request is chased by a flush so that servers which
+ * predate it, and just log and drop the unknown message, still send
+ * a reply to wait for.
+ */
+static void
+rem_shm_open(struct fb *ifp)
+{
+    unsigned char buf[3*NET_LONG_LEN+1];
+    unsigned char fbuf[NET_LONG_LEN+1];
+    struct fb_shm_client *shm;
+    long shmid, token;
+
+    if (!fb_shm_supported() || !rem_is_local(PCP(ifp)->pkc_fd))
+	return;
+
+    if (pkg_send(MSG_FBSHMOPEN, (const char *)0, 0, PCP(ifp)) < 0)
+	return;
+    if (pkg_send(MSG_FBFLUSH, (const char *)0, 0, PCP(ifp)) < 0)
+	return;
+
+    /* return code, shmid, token as longs */
+    if (pkg_waitfor (MSG_RETURN, (char *)buf, 3*NET_LONG_LEN, PCP(ifp)) < 3*NET_LONG_LEN)
+	return;		/* old server, that was the flush */
+    if (ntohl(*(uint32_t *)&buf[0*NET_LONG_LEN]) != 0)
+	shmid = -1;
+    else
+	shmid = (long)ntohl(*(uint32_t *)&buf[1*NET_LONG_LEN]);
+    token = (long)ntohl(*(uint32_t *)&buf[2*NET_LONG_LEN]);
+
+    /*
+     * Until the server hears we have attached, only it can remove the
+     * segment's name.  If it can't be told, remove the name here so
+     * the segment goes away with the last detach.
+     */
+    if (pkg_waitfor (MSG_RETURN, (char *)fbuf, NET_LONG_LEN, PCP(ifp)) < 1*NET_LONG_LEN) {
+	if (shmid >= 0)
+	    fb_shm_remove(shmid, token);
+	return;
+    }
+    if (shmid < 0)
+	return;
+
+    shm = fb_shm_attach(shmid, token, ifp->i->if_width, ifp->i->if_height);
+    ifp->i->u2.p = (char *)shm;
+
+    /* either way the server can let go of the segment's name now */
+    if (rem_shm_sync(ifp, shm ? FB_SHM_ATTACHED : FB_SHM_DETACH, 0) < 0 || !shm)
+	fb_shm_remove(shmid, token);
+}
+
+
+static void
+rem_shm_close(struct fb *ifp)
+{
+    if (!SHMP(ifp))
+	return;
+    (void)rem_shm_sync(ifp, FB_SHM_DETACH, 0);
+    fb_shm_detach(SHMP(ifp));
+    ifp->i->u2.p = NULL;
+}
+
+
 /*
  * Open a connection to the remotefb.
  *
@@ -280,6 +439,8 @@ rem_open(register struct fb *ifp, const char *file, int width, int height)
     if (ntohl(*(uint32_t *)&buf[0*NET_LONG_LEN]) != 0)
 	return -7;		/* fail */
 
+    rem_shm_open(ifp);
+
     return 0;		/* OK */
 }
 
@@ -326,6 +487,8 @@ rem_close(struct fb *ifp)
 {
     unsigned char buf[NET_LONG_LEN+1];
 
+    rem_shm_close(ifp);
+
     /* send a close package to remote */
     if (pkg_send(MSG_FBCLOSE, (const char *)0, 0, PCP(ifp)) < 0)
 	return -2;
@@ -351,6 +514,8 @@ rem_free(struct fb *ifp)
 {
     unsigned char buf[NET_LONG_LEN+1];
 
+    rem_shm_close(ifp);
+
     /* send a free package to remote */
     if (pkg_send(MSG_FBFREE, (const char *)0, 0, PCP(ifp)) < 0)
 	return -2;
@@ -422,6 +587,9 @@ rem_write(register struct fb *ifp, int x, int y, const unsigned char *pixelp, si
 
     if (num <= 0) return num;
 
+    if (rem_shm_put(ifp, FB_SHM_SPAN, x, y, (int)num, 1, pixelp) == 0)
+	return num;
+
     /* Send Write Command */
     *(uint32_t *)&buf[0*NET_LONG_LEN] = htonl(x);
     *(uint32_t *)&buf[1*NET_LONG_LEN] = htonl(y);
@@ -479,6 +647,9 @@ rem_writerect(struct fb *ifp, int xmin, int ymin, int width, int height, const u
     if (num <= 0)
 	return 0;
 
+    if (rem_shm_put(ifp, FB_SHM_RECT, xmin, ymin, width, height, pp) == 0)
+	return num;
+
     /* Send Write Command */
     *(uint32_t *)&buf[0*NET_LONG_LEN] = htonl(xmin);
     *(uint32_t *)&buf[1*NET_LONG_LEN] = htonl(ymin);
@@ -539,6 +710,9 @@ rem_bwwriterect(struct fb *ifp, int xmin, int ymin, int width, int height, const
     if (num <= 0)
 	return 0;
 
+    if (rem_shm_put(ifp, FB_SHM_BWRECT, xmin, ymin, width, height, pp) == 0)
+	return num;
+
     /* Send Write Command */
     *(uint32_t *)&buf[0*NET_LONG_LEN] = htonl(xmin);
     *(uint32_t *)&buf[1*NET_LONG_LEN] = htonl(ymin);
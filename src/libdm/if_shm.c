@@ -0,0 +1,482 @@
+/*                        I F _ S H M . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup libstruct fb */
+/** @{ */
+/** @file if_shm.c
+ *
+ * Shared memory pixel transport for remote framebuffers.
+ *
+ * When an if_remote.c client and its fbserv are on the same host,
+ * the server creates a private segment holding a copy of the image
+ * and a ring of dirty rectangles.  The client copies pixels into the
+ * image and queues the rectangle instead of sending the pixels over
+ * the socket, and the server applies queued rectangles to its own
+ * framebuffer when it gets a MSG_FBSHMSYNC.
+ *
+ * The server sets a "waiting" flag once it has emptied the ring, and
+ * a client that finds the flag set when it queues a write clears it
+ * and sends the MSG_FBSHMSYNC.  Otherwise the server is still
+ * draining and will see the new entry before it goes idle, so a
+ * queued write is always applied before the server reads anything
+ * else the client sends.
+ *
+ */
+/** @} */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_SYS_TYPES_H
+#  include <sys/types.h>
+#endif
+#if defined(HAVE_SYS_IPC_H) && defined(HAVE_SYS_SHM_H) && !defined(__STDC_NO_ATOMICS__)
+#  include <sys/ipc.h>
+#  include <sys/shm.h>
+#  include <stdatomic.h>
+#  define FB_SHM 1
+#endif
+
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/process.h"
+#include "bu/time.h"
+#include "pkg.h"
+#include "./include/private.h"
+#include "dm.h"
+
+
+#ifdef FB_SHM
+
+#define FB_SHM_MAGIC	0x46427368	/* "FBsh" */
+#define FB_SHM_RING	4096		/* queued writes */
+
+struct fb_shm_entry {
+    int32_t kind;
+    int32_t x, y, w, h;
+};
+
+/* Start of the segment, followed by width*height RGB pixels */
+struct fb_shm_header {
+    uint32_t magic;
+    uint32_t token;		/* guards against a stale or foreign shmid */
+    int32_t width;
+    int32_t height;
+    atomic_uint head;		/* next entry the client fills */
+    atomic_uint tail;		/* next entry the server applies */
+    atomic_int waiting;		/* !0 when the server needs a MSG_FBSHMSYNC */
+    struct fb_shm_entry ring[FB_SHM_RING];
+};
+#define FB_SHM_PIXELS(hp) ((unsigned char *)(hp) + sizeof(struct fb_shm_header))
+
+
+struct fb_shm_client {
+    struct fb_shm_header *hdr;
+};
+
+
+/* Per connection server state */
+struct fb_shm_server {
+    struct pkg_conn *pcp;
+    int shmid;			/* -1 once removed */
+    struct fb_shm_header *hdr;
+    unsigned char *scratch;	/* rows of a rectangle, gathered */
+    size_t scratch_len;
+    struct fb_shm_server *next;
+};
+static struct fb_shm_server *fb_shm_servers = NULL;
+
+
+/* True if the write lies within the image of the segment */
+static int
+shm_fits(const struct fb_shm_header *hdr, int kind, int x, int y, int w, int h)
+{
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x >= hdr->width || y >= hdr->height)
+	return 0;
+
+    /* spans may run on into the following scanlines */
+    if (kind == FB_SHM_SPAN)
+	return h == 1 && (size_t)y * hdr->width + x + w <= (size_t)hdr->width * hdr->height;
+
+    return x + w <= hdr->width && y + h <= hdr->height;
+}
+
+
+int
+fb_shm_supported(void)
+{
+    return 1;
+}
+
+
+struct fb_shm_client *
+fb_shm_attach(long shmid, long token, int width, int height)
+{
+    struct fb_shm_header *hdr;
+    struct fb_shm_client *shm;
+
+    hdr = (struct fb_shm_header *)shmat((int)shmid, NULL, 0);
+    if (hdr == (struct fb_shm_header *)-1L)
+	return NULL;
+
+    if (hdr->magic != FB_SHM_MAGIC || hdr->token != (uint32_t)token
+	|| hdr->width != width || hdr->height != height) {
+	(void)shmdt((void *)hdr);
+	return NULL;
+    }
+
+    BU_GET(shm, struct fb_shm_client);
+    shm->hdr = hdr;
+    return shm;
+}
+
+
+void
+fb_shm_detach(struct fb_shm_client *shm)
+{
+    if (!shm)
+	return;
+    (void)shmdt((void *)shm->hdr);
+    BU_PUT(shm, struct fb_shm_client);
+}
+
+
+void
+fb_shm_remove(long shmid, long token)
+{
+    struct fb_shm_header *hdr;
+
+    hdr = (struct fb_shm_header *)shmat((int)shmid, NULL, 0);
+    if (hdr == (struct fb_shm_header *)-1L)
+	return;
+
+    /* only the segment the server offered, not whatever has the id now */
+    if (hdr->magic == FB_SHM_MAGIC && hdr->token == (uint32_t)token)
+	(void)shmctl((int)shmid, IPC_RMID, NULL);
+    (void)shmdt((void *)hdr);
+}
+
+
+int
+fb_shm_put(struct fb_shm_client *shm, int kind, int x, int y, int w, int h, const unsigned char *pp)
+{
+    struct fb_shm_header *hdr = shm->hdr;
+    unsigned char *pix = FB_SHM_PIXELS(hdr);
+    size_t width = (size_t)hdr->width;
+    struct fb_shm_entry *ep;
+    unsigned int head;
+    int row, i;
+
+    if (!shm_fits(hdr, kind, x, y, w, h))
+	return -1;
+
+    head = atomic_load_explicit(&hdr->head, memory_order_relaxed);
+    if (head - atomic_load_explicit(&hdr->tail, memory_order_acquire) >= FB_SHM_RING)
+	return -2;
+
+    if (kind == FB_SHM_SPAN) {
+	memcpy(pix + ((size_t)y * width + x) * 3, pp, (size_t)w * 3);
+    } else if (kind == FB_SHM_RECT) {
+	for (row = 0; row < h; row++)
+	    memcpy(pix + ((size_t)(y + row) * width + x) * 3, pp + (size_t)row * w * 3, (size_t)w * 3);
+    } else {
+	for (row = 0; row < h; row++) {
+	    unsigned char *dp = pix + ((size_t)(y + row) * width + x) * 3;
+	    for (i = 0; i < w; i++, pp++) {
+		*dp++ = *pp;
+		*dp++ = *pp;
+		*dp++ = *pp;
+	    }
+	}
+	kind = FB_SHM_RECT;
+    }
+
+    ep = &hdr->ring[head % FB_SHM_RING];
+    ep->kind = kind;
+    ep->x = x;
+    ep->y = y;
+    ep->w = w;
+    ep->h = h;
+    atomic_store(&hdr->head, head + 1);
+
+    return atomic_exchange(&hdr->waiting, 0) ? 1 : 0;
+}
+
+
+static struct fb_shm_server *
+shm_find(struct pkg_conn *pcp)
+{
+    struct fb_shm_server *s;
+
+    for (s = fb_shm_servers; s; s = s->next) {
+	if (s->pcp == pcp)
+	    return s;
+    }
+    return NULL;
+}
+
+
+static void
+shm_unlink_id(struct fb_shm_server *s)
+{
+    if (s->shmid < 0)
+	return;
+    (void)shmctl(s->shmid, IPC_RMID, NULL);
+    s->shmid = -1;
+}
+
+
+static void
+shm_apply(struct fb_shm_server *s, struct fb *fbp, const struct fb_shm_entry *ep)
+{
+    struct fb_shm_header *hdr = s->hdr;
+    unsigned char *pix = FB_SHM_PIXELS(hdr);
+    size_t width = (size_t)hdr->width;
+    size_t len;
+    int row;
+
+    /* the client is trusted only as far as the segment goes */
+    if (!shm_fits(hdr, ep->kind, ep->x, ep->y, ep->w, ep->h))
+	return;
+
+    if (ep->kind == FB_SHM_SPAN) {
+	(void)fb_write(fbp, ep->x, ep->y, pix + ((size_t)ep->y * width + ep->x) * 3, (size_t)ep->w);
+	return;
+    }
+
+    /* full width rectangles are already contiguous */
+    if (ep->x == 0 && (size_t)ep->w == width) {
+	(void)fb_writerect(fbp, ep->x, ep->y, ep->w, ep->h, pix + (size_t)ep->y * width * 3);
+	return;
+    }
+
+    len = (size_t)ep->w * ep->h * 3;
+    if (len > s->scratch_len) {
+	s->scratch = (unsigned char *)bu_realloc(s->scratch, len, "fb_shm scratch");
+	s->scratch_len = len;
+    }
+    for (row = 0; row < ep->h; row++)
+	memcpy(s->scratch + (size_t)row * ep->w * 3, pix + ((size_t)(ep->y + row) * width + ep->x) * 3, (size_t)ep->w * 3);
+    (void)fb_writerect(fbp, ep->x, ep->y, ep->w, ep->h, s->scratch);
+}
+
+
+static void
+shm_drain(struct fb_shm_server *s, struct fb *fbp)
+{
+    struct fb_shm_header *hdr = s->hdr;
+    unsigned int head, tail;
+
+    tail = atomic_load_explicit(&hdr->tail, memory_order_relaxed);
+    for (;;) {
+	head = atomic_load_explicit(&hdr->head, memory_order_acquire);
+	while (tail != head) {
+	    /* copied, so the checks in shm_apply() hold */
+	    struct fb_shm_entry e = hdr->ring[tail % FB_SHM_RING];
+	    if (fbp != FB_NULL && head - tail <= FB_SHM_RING)
+		shm_apply(s, fbp, &e);
+	    tail++;
+	    atomic_store_explicit(&hdr->tail, tail, memory_order_release);
+	}
+
+	/* go idle, unless more arrived before the client saw us busy */
+	atomic_store(&hdr->waiting, 1);
+	if (atomic_load(&hdr->head) == tail)
+	    break;
+	if (!atomic_exchange(&hdr->waiting, 0))
+	    break;	/* client took the flag, its MSG_FBSHMSYNC is coming */
+    }
+}
+
+
+void
+fbs_shm_open(struct pkg_conn *pcp, struct fb *fbp)
+{
+    char rbuf[3*NET_LONG_LEN+1] = {0};
+    struct fb_shm_server *s;
+    struct fb_shm_header *hdr;
+    size_t size;
+    int shmid;
+
+    /* a client only asks once, but start over if it does again */
+    fbs_shm_release(pcp);
+
+    (void)pkg_plong(&rbuf[0*NET_LONG_LEN], (unsigned long)-1);
+    if (fbp == FB_NULL || fb_getwidth(fbp) <= 0 || fb_getheight(fbp) <= 0)
+	goto reply;
+
+    size = sizeof(struct fb_shm_header) + (size_t)fb_getwidth(fbp) * fb_getheight(fbp) * 3;
+    shmid = shmget(IPC_PRIVATE, size, IPC_CREAT|0600);
+    if (shmid < 0)
+	goto reply;
+    hdr = (struct fb_shm_header *)shmat(shmid, NULL, 0);
+    if (hdr == (struct fb_shm_header *)-1L) {
+	(void)shmctl(shmid, IPC_RMID, NULL);
+	goto reply;
+    }
+
+    hdr->magic = FB_SHM_MAGIC;
+    hdr->token = (uint32_t)bu_gettime() ^ ((uint32_t)bu_pid() << 16) ^ (uint32_t)shmid;
+    hdr->width = fb_getwidth(fbp);
+    hdr->height = fb_getheight(fbp);
+    atomic_init(&hdr->head, 0);
+    atomic_init(&hdr->tail, 0);
+    atomic_init(&hdr->waiting, 1);
+
+    BU_ALLOC(s, struct fb_shm_server);
+    s->pcp = pcp;
+    s->shmid = shmid;
+    s->hdr = hdr;
+    s->next = fb_shm_servers;
+    fb_shm_servers = s;
+
+    (void)pkg_plong(&rbuf[0*NET_LONG_LEN], 0);
+    (void)pkg_plong(&rbuf[1*NET_LONG_LEN], shmid);
+    (void)pkg_plong(&rbuf[2*NET_LONG_LEN], hdr->token);
+
+reply:
+    if (pkg_send(MSG_RETURN, rbuf, 3*NET_LONG_LEN, pcp) != 3*NET_LONG_LEN) {
+	bu_log("pkg_send fb_shm_open reply\n");
+	/* the client will never attach, so don't keep the segment */
+	fbs_shm_release(pcp);
+    }
+}
+
+
+void
+fbs_shm_sync(struct pkg_conn *pcp, struct fb *fbp, char *buf)
+{
+    char rbuf[NET_LONG_LEN+1] = {0};
+    struct fb_shm_server *s = shm_find(pcp);
+    long op = FB_SHM_DRAIN;
+
+    if (buf && pcp->pkc_len >= NET_LONG_LEN)
+	op = (long)pkg_glong(&buf[0*NET_LONG_LEN]);
+
+    if (s) {
+	shm_drain(s, fbp);
+	if (op == FB_SHM_ATTACHED)
+	    shm_unlink_id(s);
+	else if (op == FB_SHM_DETACH)
+	    fbs_shm_release(pcp);
+    }
+
+    if (pcp->pkc_type < MSG_NORETURN) {
+	(void)pkg_plong(&rbuf[0], s ? 0 : (unsigned long)-1);
+	pkg_send(MSG_RETURN, rbuf, NET_LONG_LEN, pcp);
+    }
+}
+
+
+void
+fbs_shm_release(struct pkg_conn *pcp)
+{
+    struct fb_shm_server **sp, *s;
+
+    for (sp = &fb_shm_servers; *sp; sp = &(*sp)->next) {
+	if ((*sp)->pcp != pcp)
+	    continue;
+	s = *sp;
+	*sp = s->next;
+	shm_unlink_id(s);
+	(void)shmdt((void *)s->hdr);
+	if (s->scratch)
+	    bu_free(s->scratch, "fb_shm scratch");
+	bu_free(s, "fb_shm_server");
+	return;
+    }
+}
+
+#else /* FB_SHM */
+
+/* Everything goes over the socket */
+
+int
+fb_shm_supported(void)
+{
+    return 0;
+}
+
+
+struct fb_shm_client *
+fb_shm_attach(long UNUSED(shmid), long UNUSED(token), int UNUSED(width), int UNUSED(height))
+{
+    return NULL;
+}
+
+
+void
+fb_shm_detach(struct fb_shm_client *UNUSED(shm))
+{
+}
+
+
+void
+fb_shm_remove(long UNUSED(shmid), long UNUSED(token))
+{
+}
+
+
+int
+fb_shm_put(struct fb_shm_client *UNUSED(shm), int UNUSED(kind), int UNUSED(x), int UNUSED(y), int UNUSED(w), int UNUSED(h), const unsigned char *UNUSED(pp))
+{
+    return -1;
+}
+
+
+void
+fbs_shm_open(struct pkg_conn *pcp, struct fb *UNUSED(fbp))
+{
+    char rbuf[3*NET_LONG_LEN+1] = {0};
+
+    (void)pkg_plong(&rbuf[0*NET_LONG_LEN], (unsigned long)-1);
+    if (pkg_send(MSG_RETURN, rbuf, 3*NET_LONG_LEN, pcp) != 3*NET_LONG_LEN)
+	bu_log("pkg_send fb_shm_open reply\n");
+}
+
+
+void
+fbs_shm_sync(struct pkg_conn *pcp, struct fb *UNUSED(fbp), char *UNUSED(buf))
+{
+    char rbuf[NET_LONG_LEN+1] = {0};
+
+    if (pcp->pkc_type < MSG_NORETURN) {
+	(void)pkg_plong(&rbuf[0], (unsigned long)-1);
+	pkg_send(MSG_RETURN, rbuf, NET_LONG_LEN, pcp);
+    }
+}
+
+
+void
+fbs_shm_release(struct pkg_conn *UNUSED(pcp))
+{
+}
+
+#endif /* FB_SHM */
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
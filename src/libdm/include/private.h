@@ -172,6 +172,44 @@ struct fb_clip {
 DM_EXPORT extern int fb_sim_writerect(struct fb *ifp, int xmin, int ymin, int _width, int _height, const unsigned char *pp);
 DM_EXPORT extern int fb_sim_bwwriterect(struct fb *ifp, int xmin, int ymin, int _width, int _height, const unsigned char *pp);
 
+/*
+ * Shared memory pixel transport used by if_remote.c when the server
+ * is on the same host, defined in if_shm.c.  The server side is in
+ * dm/fbserv.h.
+ */
+#define FB_SHM_SPAN	0	/* x, y and a pixel count, as fb_write() */
+#define FB_SHM_RECT	1	/* as fb_writerect() */
+#define FB_SHM_BWRECT	2	/* as fb_bwwriterect(), queued as RGB */
+
+/* The long sent with MSG_FBSHMSYNC */
+#define FB_SHM_DRAIN	0	/* apply everything queued so far */
+#define FB_SHM_ATTACHED	1	/* client has attached, segment may be removed */
+#define FB_SHM_DETACH	2	/* client is done with the segment */
+
+struct fb_shm_client;
+
+/* Returns !0 if this build has the shared memory transport */
+DM_EXPORT extern int fb_shm_supported(void);
+
+/* Attach to the segment described by a MSG_FBSHMOPEN reply, or NULL */
+DM_EXPORT extern struct fb_shm_client *fb_shm_attach(long shmid, long token, int width, int height);
+DM_EXPORT extern void fb_shm_detach(struct fb_shm_client *shm);
+
+/*
+ * Remove the name of the segment described by a MSG_FBSHMOPEN reply,
+ * if it still holds that token.  For when the server can't be told
+ * the client is done with it.
+ */
+DM_EXPORT extern void fb_shm_remove(long shmid, long token);
+
+/*
+ * Queue a write of one of the FB_SHM_* kinds (h is 1 for a span).
+ * Returns 1 if queued and the server must be sent a FB_SHM_DRAIN,
+ * 0 if queued and the server will pick it up on its own, -1 if the
+ * write doesn't fit the segment and -2 if the ring is full.
+ */
+DM_EXPORT extern int fb_shm_put(struct fb_shm_client *shm, int kind, int x, int y, int w, int h, const unsigned char *pp);
+
 __END_DECLS
 
 /************************************************/
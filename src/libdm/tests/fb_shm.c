@@ -0,0 +1,414 @@
+/*                        F B _ S H M . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file fb_shm.c
+ *
+ * Checks the shared memory pixel transport between if_remote.c and a
+ * framebuffer server on the same host.  A server thread answers one
+ * client at a time with the fbserv.c handlers, drawing into a memory
+ * framebuffer, and counts the pixel writes that come over the socket.
+ *
+ * Against a server that offers shared memory, a lone write has to be
+ * applied by the MSG_FBSHMSYNC it rings, and enough writes to go round
+ * the ring several times have to land with none of them sent over the
+ * socket.  The segment must only attach with the token it was offered
+ * with.  Against a server that predates MSG_FBSHMOPEN, the client has
+ * to fall back to sending the pixels over the socket.
+ *
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include "bio.h"
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/snooze.h"
+#include "bu/tc.h"
+#include "pkg.h"
+#include "dm.h"
+#include "dm/fbserv.h"
+#include "../include/private.h"
+
+#define WIDTH	64
+#define HEIGHT	48
+#define WRITES	(3*4096 + 123)	/* spans, more than the ring holds several times over */
+#define MAX_SWITCH	64
+
+struct server {
+    int netfd;
+    struct fb *fbp;
+    struct pkg_switch orig[MAX_SWITCH];
+    struct pkg_switch wrapped[MAX_SWITCH];
+
+    /* counted as the messages are handled */
+    size_t socket_writes;
+    size_t shm_opens;
+};
+
+/* held while the server draws, so the test can look at its framebuffer */
+static bu_mtx_t fb_lock;
+
+
+static void
+server_call(struct pkg_conn *pc, char *buf)
+{
+    struct server *s = (struct server *)pc->pkc_user_data;
+    int i;
+
+    bu_mtx_lock(&fb_lock);
+    switch (pc->pkc_type % MSG_NORETURN) {
+	case MSG_FBWRITE:
+	case MSG_FBWRITERECT:
+	case MSG_FBBWWRITERECT:
+	    s->socket_writes++;
+	    break;
+	case MSG_FBSHMOPEN:
+	    s->shm_opens++;
+	    break;
+    }
+    for (i = 0; s->orig[i].pks_handler; i++) {
+	if (s->orig[i].pks_type == pc->pkc_type) {
+	    s->orig[i].pks_handler(pc, buf);
+	    break;
+	}
+    }
+    bu_mtx_unlock(&fb_lock);
+}
+
+
+/* with_shm clear leaves out the messages older servers don't know */
+static void
+server_init(struct server *s, int netfd, struct fb *fbp, int with_shm)
+{
+    struct pkg_switch *sw = fbs_pkg_switch();
+    int i, n = 0;
+
+    memset(s, 0, sizeof(struct server));
+    s->netfd = netfd;
+    s->fbp = fbp;
+    for (i = 0; sw[i].pks_handler && n < MAX_SWITCH - 1; i++) {
+	int type = sw[i].pks_type % MSG_NORETURN;
+	if (!with_shm && (type == MSG_FBSHMOPEN || type == MSG_FBSHMSYNC))
+	    continue;
+	s->orig[n] = sw[i];
+	s->wrapped[n] = sw[i];
+	s->wrapped[n].pks_handler = server_call;
+	s->wrapped[n].pks_user_data = (void *)s;
+	n++;
+    }
+}
+
+
+/**
+ * serve one client until it hangs up
+ */
+static int
+run_server(void *arg)
+{
+    struct server *s = (struct server *)arg;
+    struct pkg_conn *pc;
+
+    pc = pkg_getclient(s->netfd, s->wrapped, NULL, 0);
+    if (pc == PKC_NULL || pc == PKC_ERROR)
+	return 1;
+    pc->pkc_server_data = (void *)s->fbp;
+
+    while (pkg_block(pc) >= 0)
+	;
+
+    bu_mtx_lock(&fb_lock);
+    fbs_shm_release(pc);
+    bu_mtx_unlock(&fb_lock);
+    pkg_close(pc);
+    return 0;
+}
+
+
+static void
+pixel(unsigned char *p, int i)
+{
+    p[0] = (unsigned char)(i * 3);
+    p[1] = (unsigned char)(i * 5 + 1);
+    p[2] = (unsigned char)(i * 7 + 2);
+}
+
+
+/*
+ * Write spans, an RGB rectangle and a BW rectangle through the client,
+ * mirroring them in want, then read the image back through the client
+ * and from the server's framebuffer.  Returns the number of mismatches.
+ */
+static int
+draw_and_check(struct fb *fbp, struct fb *srv, unsigned char *want, int nwrites)
+{
+    unsigned char rect[13*9*3];
+    unsigned char bw[9*5];
+    unsigned char *got;
+    int i, j, fails = 0;
+
+    for (i = 0; i < nwrites; i++) {
+	int x = (i * 37) % WIDTH;
+	int y = (i / 7) % HEIGHT;
+	unsigned char *p = &want[(y*WIDTH + x)*3];
+	pixel(p, i);
+	if (fb_write(fbp, x, y, p, 1) < 0) {
+	    bu_log("fb_write of span %d failed\n", i);
+	    return 1;
+	}
+    }
+
+    for (i = 0; i < 13*9; i++)
+	pixel(&rect[i*3], i + 77);
+    if (fb_writerect(fbp, 10, 20, 13, 9, rect) < 0) {
+	bu_log("fb_writerect failed\n");
+	return 1;
+    }
+    for (j = 0; j < 9; j++)
+	memcpy(&want[((20 + j)*WIDTH + 10)*3], &rect[j*13*3], 13*3);
+
+    for (i = 0; i < 9*5; i++)
+	bw[i] = (unsigned char)(i * 11);
+    if (fb_bwwriterect(fbp, 30, 40, 9, 5, bw) < 0) {
+	bu_log("fb_bwwriterect failed\n");
+	return 1;
+    }
+    for (j = 0; j < 5; j++) {
+	for (i = 0; i < 9; i++) {
+	    unsigned char *p = &want[((40 + j)*WIDTH + 30 + i)*3];
+	    p[0] = p[1] = p[2] = bw[j*9 + i];
+	}
+    }
+
+    /* the read goes over the socket, after everything queued so far */
+    got = (unsigned char *)bu_calloc(WIDTH*HEIGHT*3, 1, "pixels read");
+    if (fb_readrect(fbp, 0, 0, WIDTH, HEIGHT, got) < 0) {
+	bu_log("fb_readrect failed\n");
+	fails++;
+    } else if (memcmp(got, want, WIDTH*HEIGHT*3)) {
+	bu_log("pixels read through the client differ from those written\n");
+	fails++;
+    }
+
+    memset(got, 0, WIDTH*HEIGHT*3);
+    bu_mtx_lock(&fb_lock);
+    (void)fb_readrect(srv, 0, 0, WIDTH, HEIGHT, got);
+    bu_mtx_unlock(&fb_lock);
+    if (memcmp(got, want, WIDTH*HEIGHT*3)) {
+	bu_log("server framebuffer differs from the pixels written\n");
+	fails++;
+    }
+
+    bu_free(got, "pixels read");
+    return fails;
+}
+
+
+static int
+check_transport(int netfd, struct fb *srv, const char *name, int with_shm)
+{
+    struct server s;
+    struct fb *fbp;
+    bu_thrd_t thread;
+    unsigned char *want;
+    unsigned char p[3];
+    int tries, fails = 0;
+
+    (void)fb_clear(srv, NULL);
+    server_init(&s, netfd, srv, with_shm);
+    if (bu_thrd_create(&thread, run_server, &s) != bu_thrd_success)
+	bu_bomb("Unable to start the server thread\n");
+
+    fbp = fb_open(name, WIDTH, HEIGHT);
+    if (fbp == FB_NULL) {
+	bu_log("unable to open %s\n", name);
+	bu_thrd_join(thread, NULL);
+	return 1;
+    }
+    want = (unsigned char *)bu_calloc(WIDTH*HEIGHT*3, 1, "pixels written");
+
+    if (with_shm) {
+	/* nothing follows this write, so only its doorbell can get it applied */
+	pixel(p, 1234);
+	memcpy(&want[(7*WIDTH + 5)*3], p, 3);
+	(void)fb_write(fbp, 5, 7, p, 1);
+	for (tries = 0; tries < 500; tries++) {
+	    unsigned char q[3] = {0, 0, 0};
+	    bu_mtx_lock(&fb_lock);
+	    (void)fb_read(srv, 5, 7, q, 1);
+	    bu_mtx_unlock(&fb_lock);
+	    if (!memcmp(p, q, 3))
+		break;
+	    bu_snooze(BU_SEC2USEC(0.01));
+	}
+	if (tries == 500) {
+	    bu_log("shared memory: a lone write was never applied\n");
+	    fails++;
+	}
+    }
+
+    fails += draw_and_check(fbp, srv, want, (with_shm) ? WRITES : 200);
+
+    bu_mtx_lock(&fb_lock);
+    if (with_shm && (s.shm_opens != 1 || s.socket_writes != 0)) {
+	bu_log("shared memory: %zu opens, %zu writes over the socket\n", s.shm_opens, s.socket_writes);
+	fails++;
+    }
+    if (!with_shm && s.socket_writes == 0) {
+	bu_log("old server: no writes came over the socket\n");
+	fails++;
+    }
+    bu_mtx_unlock(&fb_lock);
+
+    fb_close(fbp);
+    bu_thrd_join(thread, NULL);
+    bu_free(want, "pixels written");
+    return fails;
+}
+
+
+/*
+ * Ask for a segment by hand and check that it only attaches with the
+ * token and size it was offered with, and that fb_shm_remove() leaves
+ * it alone given some other token.
+ */
+static int
+check_token(int netfd, struct fb *srv, const char *port)
+{
+    struct server s;
+    struct pkg_conn *pc;
+    struct fb_shm_client *shm;
+    bu_thrd_t thread;
+    char buf[3*NET_LONG_LEN+1];
+    long shmid, token;
+    int fails = 0;
+
+    server_init(&s, netfd, srv, 1);
+    if (bu_thrd_create(&thread, run_server, &s) != bu_thrd_success)
+	bu_bomb("Unable to start the server thread\n");
+
+    pc = pkg_open("localhost", port, "tcp", NULL, NULL, NULL, NULL);
+    if (pc == PKC_ERROR) {
+	bu_log("unable to connect to port %s\n", port);
+	bu_thrd_join(thread, NULL);
+	return 1;
+    }
+
+    if (pkg_send(MSG_FBSHMOPEN, NULL, 0, pc) < 0
+	|| pkg_waitfor(MSG_RETURN, buf, 3*NET_LONG_LEN, pc) < 3*NET_LONG_LEN
+	|| pkg_glong(&buf[0*NET_LONG_LEN]) != 0) {
+	bu_log("token: no segment offered\n");
+	pkg_close(pc);
+	bu_thrd_join(thread, NULL);
+	return 1;
+    }
+    shmid = (long)pkg_glong(&buf[1*NET_LONG_LEN]);
+    token = (long)pkg_glong(&buf[2*NET_LONG_LEN]);
+
+    shm = fb_shm_attach(shmid, token ^ 0x5a5a, WIDTH, HEIGHT);
+    if (shm) {
+	bu_log("token: attached with the wrong token\n");
+	fb_shm_detach(shm);
+	fails++;
+    }
+    shm = fb_shm_attach(shmid, token, WIDTH - 1, HEIGHT);
+    if (shm) {
+	bu_log("token: attached with the wrong size\n");
+	fb_shm_detach(shm);
+	fails++;
+    }
+
+    fb_shm_remove(shmid, token ^ 0x5a5a);
+    shm = fb_shm_attach(shmid, token, WIDTH, HEIGHT);
+    if (!shm) {
+	bu_log("token: unable to attach with the right token\n");
+	fails++;
+    } else {
+	fb_shm_detach(shm);
+    }
+
+    /* as a client that can't reach the server would */
+    fb_shm_remove(shmid, token);
+
+    pkg_close(pc);
+    bu_thrd_join(thread, NULL);
+    return fails;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    char name[64];
+    char port[16];
+    struct fb *srv;
+    int netfd;
+    int portnum = 2030;
+    int fails = 0;
+
+    bu_setprogname(argv[0]);
+    if (argc > 1)
+	portnum = atoi(argv[1]);
+
+#ifdef SIGPIPE
+    (void)signal(SIGPIPE, SIG_IGN);
+#endif
+
+    bu_mtx_init(&fb_lock);
+    snprintf(port, sizeof(port), "%d", portnum);
+    snprintf(name, sizeof(name), "localhost:%d", portnum);
+
+    netfd = pkg_permserver(port, "tcp", 0, 0);
+    if (netfd < 0)
+	bu_exit(1, "Unable to listen on port %s\n", port);
+
+    srv = fb_open("/dev/mem", WIDTH, HEIGHT);
+    if (srv == FB_NULL)
+	bu_exit(1, "Unable to open a memory framebuffer\n");
+
+    if (fb_shm_supported()) {
+	fails += check_transport(netfd, srv, name, 1);
+	fails += check_token(netfd, srv, port);
+    } else {
+	bu_log("no shared memory transport in this build\n");
+    }
+    fails += check_transport(netfd, srv, name, 0);
+
+    fb_close(srv);
+    bu_mtx_destroy(&fb_lock);
+
+    if (fails)
+	bu_log("%d checks failed\n", fails);
+    return (fails) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -83,8 +83,8 @@ dm_draw_arrow(struct dm *dmp, point_t A, point_t B, fastf_t tip_length, fastf_t
 void
 dm_add_arrows(struct dm *dmp, struct bv_scene_obj *s)
 {
-    struct bv_vlist *vp = (struct bv_vlist *)&s->s_vlist;
     struct bv_vlist *tvp;
+    mat_t omat;
     point_t A = VINIT_ZERO;
     point_t B = VINIT_ZERO;
     int pcnt = 0;
@@ -92,11 +92,15 @@ dm_add_arrows(struct dm *dmp, struct bv_scene_obj *s)
 	return;
     if (NEAR_ZERO(s->s_os->s_arrow_tip_length, SMALL_FASTF) || NEAR_ZERO(s->s_os->s_arrow_tip_width, SMALL_FASTF))
        return;
-    for (BU_LIST_FOR(tvp, bv_vlist, &vp->l)) {
+    // Arrows are drawn in model coordinates, and shared vlists are in local ones
+    struct bu_list *vhead = bv_obj_vlist(s, omat);
+    for (BU_LIST_FOR(tvp, bv_vlist, vhead)) {
 	int nused = tvp->nused;
 	int *cmd = tvp->cmd;
 	point_t *pt = tvp->pt;
 	for (int i = 0; i < nused; i++, cmd++, pt++) {
+	    point_t mpt;
+	    MAT4X3PNT(mpt, omat, *pt);
 	    pcnt++;
 	    switch (*cmd) {
 		case BV_VLIST_LINE_MOVE:
@@ -105,11 +109,11 @@ dm_add_arrows(struct dm *dmp, struct bv_scene_obj *s)
 			// to the A -> B segment at B
 			dm_draw_arrow(dmp, A, B, s->s_os->s_arrow_tip_length, s->s_os->s_arrow_tip_width, 1.0);
 		    }
-		    VMOVE(B,*pt);
+		    VMOVE(B,mpt);
 		    break;
 		case BV_VLIST_LINE_DRAW:
 		    VMOVE(A,B);
-		    VMOVE(B,*pt);
+		    VMOVE(B,mpt);
 		    break;
 		default:
 		    // For these purposes, we're only interested in lines
@@ -32,6 +32,7 @@
 #include <string.h>
 #include <math.h>
 
+#include "bu/parallel.h"
 #include "raytrace.h"
 #include "gcv/api.h"
 
@@ -162,6 +163,11 @@ nmg_to_obj(struct conversion_state *pstate, struct nmgregion *r, const struct db
     }
 
     /* END CHECK SECTION */
+
+    /* Regions are evaluated in parallel - the output, and the vertex
+     * numbering that goes with it, is one region at a time */
+    bu_semaphore_acquire(RT_SEM_RESULTS);
+
     /* Write pertinent info for this region */
 
     if (pstate->obj_write_options->usemtl)
@@ -280,6 +286,7 @@ nmg_to_obj(struct conversion_state *pstate, struct nmgregion *r, const struct db
 	pstate->norm_offset += BU_PTBL_LEN(&norms);
 	bu_ptbl_free(&norms);
     }
+    bu_semaphore_release(RT_SEM_RESULTS);
     bu_free(region_name, "region name");
 }
 
@@ -310,15 +317,8 @@ process_triangulation(struct conversion_state *pstate, struct nmgregion *r, cons
 	/* Release any intersector 2d tables */
 	nmg_isect2d_final_cleanup();
 
-	/* Get rid of (m)any other intermediate structures */
-	if ((*tsp->ts_m)->magic == NMG_MODEL_MAGIC) {
-	    nmg_km(*tsp->ts_m);
-	} else {
-	    bu_log("WARNING: tsp->ts_m pointer corrupted, ignoring it.\n");
-	}
-
-	/* Now, make a new, clean model structure for next pass. */
-	*tsp->ts_m = nmg_mm();
+	/* The region's model is released by the caller - *tsp->ts_m is
+	 * shared by all the regions of the walk, and must be left alone */
     }  BU_UNSETJUMP;
 }
 
@@ -326,7 +326,7 @@ process_triangulation(struct conversion_state *pstate, struct nmgregion *r, cons
 static union tree *
 obj_write_process_boolean(const struct conversion_state *pstate, union tree *curtree, struct db_tree_state *tsp, const struct db_full_path *pathp, struct bu_list *vlfree)
 {
-    static union tree *ret_tree = TREE_NULL;
+    union tree *ret_tree = TREE_NULL;
 
     /* Begin bomb protection */
     if (!BU_SETJUMP) {
@@ -353,16 +353,7 @@ obj_write_process_boolean(const struct conversion_state *pstate, union tree *cur
 	/* Release the tree memory & input regions */
 	db_free_tree(curtree, &rt_uniresource);/* Does an nmg_kr() */
 
-	/* Get rid of (m)any other intermediate structures */
-	if ((*tsp->ts_m)->magic == NMG_MODEL_MAGIC) {
-	    nmg_km(*tsp->ts_m);
-	} else {
-	    bu_log("WARNING: tsp->ts_m pointer corrupted, ignoring it.\n");
-	}
-
 	bu_free(name, "db_path_to_string");
-	/* Now, make a new, clean model structure for next pass. */
-	*tsp->ts_m = nmg_mm();
     } BU_UNSETJUMP;/* Relinquish the protection */
 
     return ret_tree;
@@ -402,7 +393,9 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
     if (curtree->tr_op == OP_NOP)
 	return curtree;
 
+    bu_semaphore_acquire(RT_SEM_RESULTS);
     pstate->regions_tried++;
+    bu_semaphore_release(RT_SEM_RESULTS);
 
     ret_tree = obj_write_process_boolean(pstate, curtree, tsp, pathp, pstate->vlfree);
 
@@ -411,7 +404,9 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
     else
 	r = (struct nmgregion *)NULL;
 
+    bu_semaphore_acquire(RT_SEM_RESULTS);
     pstate->regions_converted++;
+    bu_semaphore_release(RT_SEM_RESULTS);
 
     if (r != 0) {
 	struct shell *s;
@@ -441,7 +436,9 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
 	if (!empty_region && !empty_model) {
 	    process_triangulation(pstate, r, pathp, tsp);
 
+	    bu_semaphore_acquire(RT_SEM_RESULTS);
 	    pstate->regions_written++;
+	    bu_semaphore_release(RT_SEM_RESULTS);
 
 	    BU_UNSETJUMP;
 	}
@@ -460,6 +457,7 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
 
     db_free_tree(curtree, &rt_uniresource);		/* Does an nmg_kr() */
 
+    bu_semaphore_acquire(RT_SEM_RESULTS);
     if (pstate->regions_tried) {
 	float npercent;
 	float tpercent;
@@ -469,6 +467,7 @@ do_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, union
 	bu_log("Tried %zu regions; %zu conv. to NMG's, %zu conv. to tri.; nmgper = %.2f%%, triper = %.2f%%\n",
 	       pstate->regions_tried, pstate->regions_converted, pstate->regions_written, npercent, tpercent);
     }
+    bu_semaphore_release(RT_SEM_RESULTS);
 
     BU_ALLOC(curtree, union tree);
     RT_TREE_INIT(curtree);
@@ -506,6 +505,7 @@ static int
 obj_write(struct gcv_context *context, const struct gcv_opts *gcv_options, const void *options_data, const char *dest_path)
 {
     size_t i;
+    int ncpu;
     struct model *the_model;
     struct db_tree_state tree_state;
     struct conversion_state state;
@@ -544,9 +544,11 @@ obj_write(struct gcv_context *context, const struct gcv_opts *gcv_options, const
 
     fprintf(state.fp, "\n");
 
-    /* Walk indicated tree(s).  Each region will be output separately */
+    /* Walk indicated tree(s).  Each region will be output separately,
+     * as it finishes - independent regions are evaluated in parallel */
+    ncpu = (state.gcv_options->max_cpus) ? (int)state.gcv_options->max_cpus : bu_avail_cpus();
     (void) db_walk_tree(context->dbip, state.gcv_options->num_objects, (const char **)state.gcv_options->object_names,
-	    1, &tree_state, NULL, do_region_end, rt_booltree_leaf_tess, (void *)&state);
+	    ncpu, &tree_state, NULL, do_region_end, rt_booltree_leaf_tess, (void *)&state);
 
     if (state.regions_tried) {
 	double percent = ((double)state.regions_converted * 100.0) / state.regions_tried;
@@ -41,6 +41,7 @@
 extern "C" {
 #include "bu/getopt.h"
 #include "bu/cv.h"
+#include "bu/parallel.h"
 #include "bu/units.h"
 #include "vmath.h"
 #include "nmg.h"
@@ -132,6 +133,15 @@ nmg_to_stl(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree
 
     region_name = db_path_to_string(pathp);
 
+    m = r->m_p;
+    NMG_CK_MODEL(m);
+
+    /* triangulate model - regions are evaluated in parallel, so do this
+     * before taking the lock on the output */
+    nmg_triangulate_model(m, pstate->vlfree, &pstate->gcv_options->calculational_tolerance);
+
+    bu_semaphore_acquire(RT_SEM_RESULTS);
+
     if (pstate->stl_write_options->output_directory) {
 	char *c;
 
@@ -195,16 +205,10 @@ nmg_to_stl(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree
 	}
     }
 
-    m = r->m_p;
-    NMG_CK_MODEL(m);
-
     /* Write pertinent info for this region */
     if (!pstate->stl_write_options->binary)
 	fprintf(pstate->fp, "solid %s\n", (region_name+1));
 
-    /* triangulate model */
-    nmg_triangulate_model(m, pstate->vlfree, &pstate->gcv_options->calculational_tolerance);
-
     /* Check triangles */
     for (BU_LIST_FOR (s, shell, &r->s_hd))
     {
@@ -321,6 +325,7 @@ nmg_to_stl(struct nmgregion *r, const struct db_full_path *pathp, struct db_tree
 	    fclose(pstate->fp);
 	}
     }
+    bu_semaphore_release(RT_SEM_RESULTS);
     bu_free(region_name, "region name");
 }
 
@@ -363,6 +368,7 @@ stl_write(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     struct gcv_region_end_data gcvwriter;
 
     gcvwriter.write_region = nmg_to_stl;
+    gcvwriter.vlfree = &rt_vlfree;
     gcvwriter.client_data = &state;
 
     memset(&state, 0, sizeof(state));
@@ -419,9 +425,14 @@ stl_write(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     state.the_model = nmg_mm();
     state.vlfree = &rt_vlfree;
 
-    /* Walk indicated tree(s).  Each region will be output separately */
+    /* Walk indicated tree(s).  Each region will be output separately,
+     * as it finishes - the NMG evaluation of independent regions runs
+     * in parallel, and nmg_to_stl() serializes the output. */
+    int ncpu = (gcv_options->max_cpus) ? (int)gcv_options->max_cpus : bu_avail_cpus();
+    if (gcv_options->tessellation_algorithm == GCV_TESS_MARCHING_CUBES)
+	ncpu = 1;
     (void) db_walk_tree(state.dbip, gcv_options->num_objects, (const char **)gcv_options->object_names,
-	    1,
+	    ncpu,
 	    &tree_state,
 	    0,			/* take all regions */
 	    (gcv_options->tessellation_algorithm == GCV_TESS_MARCHING_CUBES)?gcv_region_end_mc:gcv_region_end,
@@ -130,14 +130,9 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	/* Release any intersector 2d tables */
 	nmg_isect2d_final_cleanup();
 
-	/* Get rid of (m)any other intermediate structures */
-	if ((*tsp->ts_m)->magic == NMG_MODEL_MAGIC)
-	    nmg_km(*tsp->ts_m);
-	else
-	    bu_log("WARNING: tsp->ts_m pointer corrupted, ignoring it.\n");
-
-	/* Now, make a new, clean model structure for next pass. */
-	*tsp->ts_m = nmg_mm();
+	/* The leaves were tessellated into models of their own, which
+	 * go with the tree - *tsp->ts_m is shared by all the regions of
+	 * a parallel walk, and must be left alone. */
 
 	return _gcv_cleanup(NMG_debug_state, tp);
     } BU_UNSETJUMP; /* Relinquish bomb protection */
@@ -185,14 +180,7 @@ gcv_region_end(struct db_tree_state *tsp, const struct db_full_path *pathp, unio
 	/* Release any intersector 2d tables */
 	nmg_isect2d_final_cleanup();
 
-	/* Get rid of (m)any other intermediate structures */
-	if ((*tsp->ts_m)->magic == NMG_MODEL_MAGIC)
-	    nmg_km(*tsp->ts_m);
-	else
-	    bu_log("WARNING: tsp->ts_m pointer corrupted, ignoring it.\n");
-
-	/* Now, make a new, clean model structure for next pass. */
-	*tsp->ts_m = nmg_mm();
+	/* Leave the shared *tsp->ts_m alone, as above */
 	nmg_kr(r);
 
 	return _gcv_cleanup(NMG_debug_state, tp);
@@ -62,19 +62,25 @@ extern "C" {
 
 // Define what format of the cache is current - if it doesn't match, we need
 // to wipe and redo.
-#define CACHE_CURRENT_FORMAT 1
+#define CACHE_CURRENT_FORMAT 2
 
 /* There are various individual pieces of data in the cache associated with
  * each object key.  For lookup they use short suffix strings to distinguish
  * them - we define those strings here to have consistent definitions for use
  * in multiple functions.
  *
+ * Object keys are hashes of the on-disk object contents (see c_hash in
+ * DbiState) rather than of object names, so an edited object simply maps to
+ * new entries.  The exception is comb bounds, which also depend on the comb's
+ * children - those are keyed on the bkeys values.
+ *
  * Changing any of these requires incrementing CACHE_CURRENT_FORMAT. */
 #define CACHE_OBJ_BOUNDS "bb"
 #define CACHE_REGION_ID "rid"
 #define CACHE_REGION_FLAG "rf"
 #define CACHE_INHERIT_FLAG "if"
 #define CACHE_COLOR "c"
+#define CACHE_COMB_TREE "ct"
 
 struct ged_draw_cache {
     MDB_env *env;
@@ -235,6 +241,7 @@ cache_write(struct ged_draw_cache *c, unsigned long long hash, const char *compo
     mdb_data[1].mv_data = NULL;
     mdb_put(c->txn, c->dbi, &mdb_key, mdb_data, 0);
     mdb_txn_commit(c->txn);
+    c->txn = NULL;
     bu_free(keycstr, "keycstr");
     bu_free(bdata, "buffer data");
 }
@@ -287,14 +294,18 @@ cache_del(struct ged_draw_cache *c, unsigned long long hash, const char *compone
     mdb_key.mv_data = (void *)keystr.c_str();
     mdb_del(c->txn, c->dbi, &mdb_key, NULL);
     mdb_txn_commit(c->txn);
+    c->txn = NULL;
 }
 
+// Ends the transaction opened by cache_get, if it opened one (lookups with
+// a zero key return without touching the database.)
 static void
 cache_done(struct ged_draw_cache *c)
 {
-    if (!c)
+    if (!c || !c->txn)
 	return;
     mdb_txn_commit(c->txn);
+    c->txn = NULL;
 }
 
 
@@ -309,8 +320,21 @@ struct walk_data {
     std::unordered_map<unsigned long long, unsigned long long> i_count;
     mat_t *curr_mat = NULL;
     unsigned long long phash = 0;
+    std::stringstream *rec = NULL;
+    size_t rcnt = 0;
 };
 
+static unsigned long long
+dp_content_hash(struct db_i *dbip, struct directory *dp)
+{
+    struct bu_external ext = BU_EXTERNAL_INIT_ZERO;
+    if (db_get_external(&ext, dp, dbip) < 0)
+	return 0;
+    unsigned long long hash = bu_data_hash(ext.ext_buf, ext.ext_nbytes);
+    bu_free_external(&ext);
+    return hash;
+}
+
 static void
 populate_leaf(void *client_data, const char *name, matp_t c_m, int op)
 {
@@ -367,6 +391,63 @@ populate_leaf(void *client_data, const char *name, matp_t c_m, int op)
 
     // If we have a non-UNION op, store it
     d->dbis->i_bool[d->phash][chash] = op;
+
+    // If we're recording the tree for the cache, add this leaf.  We store the
+    // raw leaf inputs rather than the results so a cached tree can be
+    // replayed through this same function.
+    if (d->rec) {
+	uint32_t nlen = (uint32_t)strlen(name);
+	int has_mat = (c_m) ? 1 : 0;
+	d->rec->write(reinterpret_cast<const char *>(&nlen), sizeof(nlen));
+	d->rec->write(name, nlen);
+	d->rec->write(reinterpret_cast<const char *>(&op), sizeof(op));
+	d->rec->write(reinterpret_cast<const char *>(&has_mat), sizeof(has_mat));
+	if (c_m)
+	    d->rec->write(reinterpret_cast<const char *>(c_m), sizeof(mat_t));
+	d->rcnt++;
+    }
+}
+
+// Replay a comb tree recorded by populate_leaf.  Returns false (leaving the
+// walk data in an undefined state) if the data is not well formed.
+static bool
+populate_replay(struct walk_data *d, const char *b, size_t bsize)
+{
+    const char *bend = b + bsize;
+    size_t lcnt = 0;
+    if (bsize < sizeof(lcnt))
+	return false;
+    memcpy(&lcnt, b, sizeof(lcnt));
+    b += sizeof(lcnt);
+
+    std::string name;
+    for (size_t i = 0; i < lcnt; i++) {
+	uint32_t nlen = 0;
+	int op = OP_UNION;
+	int has_mat = 0;
+	mat_t m;
+	if ((size_t)(bend - b) < sizeof(nlen))
+	    return false;
+	memcpy(&nlen, b, sizeof(nlen));
+	b += sizeof(nlen);
+	if ((size_t)(bend - b) < nlen + sizeof(op) + sizeof(has_mat))
+	    return false;
+	name.assign(b, nlen);
+	b += nlen;
+	memcpy(&op, b, sizeof(op));
+	b += sizeof(op);
+	memcpy(&has_mat, b, sizeof(has_mat));
+	b += sizeof(has_mat);
+	if (has_mat) {
+	    if ((size_t)(bend - b) < sizeof(mat_t))
+		return false;
+	    memcpy(m, b, sizeof(mat_t));
+	    b += sizeof(mat_t);
+	}
+	populate_leaf((void *)d, name.c_str(), (has_mat) ? m : NULL, op);
+    }
+
+    return (b == bend);
 }
 
 static void
@@ -476,19 +557,55 @@ DbiState::populate_maps(struct directory *dp, unsigned long long phash, int rese
 	if (reset && pv_it != p_v.end()) {
 	    pv_it->second.clear();
 	}
+	if (reset) {
+	    matrices.erase(phash);
+	    i_bool.erase(phash);
+	}
+
+	// If we've seen this exact comb before, its leaves are in the cache and
+	// we can skip unpacking the tree.
+	unsigned long long chash = content_hash(phash);
+	const char *b = NULL;
+	size_t bsize = cache_get(dcache, (void **)&b, chash, CACHE_COMB_TREE);
+	if (bsize) {
+	    struct walk_data cd;
+	    cd.dbis = this;
+	    cd.phash = phash;
+	    bool replayed = populate_replay(&cd, b, bsize);
+	    cache_done(dcache);
+	    if (replayed)
+		return;
+	    bu_log("Incorrect data found loading cached comb tree for %s\n", dp->d_namep);
+	    cache_del(dcache, chash, CACHE_COMB_TREE);
+	    p_c[phash].clear();
+	    p_v[phash].clear();
+	    matrices.erase(phash);
+	    i_bool.erase(phash);
+	} else {
+	    cache_done(dcache);
+	}
+
 	struct rt_db_internal in;
 	if (rt_db_get_internal(&in, dp, dbip, NULL, res) < 0)
 	    return;
 	struct rt_comb_internal *comb = (struct rt_comb_internal *)in.idb_ptr;
-	if (!comb->tree)
+	if (!comb->tree) {
+	    rt_db_free_internal(&in);
 	    return;
+	}
 
-	std::unordered_map<unsigned long long, unsigned long long> i_count;
+	std::stringstream rec;
 	struct walk_data d;
 	d.dbis = this;
 	d.phash = phash;
+	d.rec = &rec;
 	populate_walk_tree(comb->tree, (void *)&d, 0, OP_UNION, populate_leaf);
 	rt_db_free_internal(&in);
+
+	std::stringstream s;
+	s.write(reinterpret_cast<const char *>(&d.rcnt), sizeof(d.rcnt));
+	s << rec.rdbuf();
+	cache_write(dcache, chash, CACHE_COMB_TREE, s);
     }
 }
 
@@ -803,17 +920,16 @@ DbiState::int_color(struct bu_color *c, unsigned int cval)
 void
 DbiState::clear_cache(struct directory *dp)
 {
-    if (!dp || !dcache)
+    if (!dp)
 	return;
 
     unsigned long long hash = bu_data_hash(dp->d_namep, strlen(dp->d_namep)*sizeof(char));
 
-    cache_del(dcache, hash, CACHE_OBJ_BOUNDS);
-    cache_del(dcache, hash, CACHE_REGION_ID);
-    cache_del(dcache, hash, CACHE_REGION_FLAG);
-    cache_del(dcache, hash, CACHE_INHERIT_FLAG);
-    cache_del(dcache, hash, CACHE_COLOR);
-
+    // The on-disk cache is keyed on object contents, so changed objects
+    // don't need their entries removed - they will simply no longer be
+    // looked up.  We do need to let go of the in-memory copies.
+    c_hash.erase(hash);
+    bkeys.erase(hash);
     bboxes.erase(hash);
     region_id.erase(hash);
     c_inherit.erase(hash);
@@ -830,9 +946,16 @@ DbiState::update_dp(struct directory *dp, int reset)
     unsigned long long hash = bu_data_hash(dp->d_namep, strlen(dp->d_namep)*sizeof(char));
     d_map[hash] = dp;
 
+    // Identify the current contents of the object - all persistent cache
+    // lookups for this object are keyed on this hash.  Reading the object
+    // to compute it is only worth doing if we have a cache to look in.
+    c_hash.erase(hash);
+    unsigned long long chash = content_hash(hash);
+
     // Clear any (possibly) state bbox.  bbox calculation
     // can be expensive, so defer it until it's needed
     bboxes.erase(hash);
+    bkeys.erase(hash);
 
     // Encode hierarchy info if this is a comb
     if (dp->d_flags & RT_DIR_COMB)
@@ -861,28 +984,28 @@ DbiState::update_dp(struct directory *dp, int reset)
     int color_inherit = 0;
     unsigned int cval = INT_MAX;
 
-    bsize = cache_get(dcache, (void **)&b, hash, CACHE_REGION_ID);
+    bsize = cache_get(dcache, (void **)&b, chash, CACHE_REGION_ID);
     if (bsize == sizeof(attr_region_id)) {
 	memcpy(&attr_region_id, b, sizeof(attr_region_id));
 	need_region_id_avs = false;
     }
     cache_done(dcache);
 
-    bsize = cache_get(dcache, (void **)&b, hash, CACHE_REGION_FLAG);
+    bsize = cache_get(dcache, (void **)&b, chash, CACHE_REGION_FLAG);
     if (bsize == sizeof(region_flag)) {
 	memcpy(&region_flag, b, sizeof(region_flag));
 	need_region_flag_avs = false;
     }
     cache_done(dcache);
 
-    bsize = cache_get(dcache, (void **)&b, hash, CACHE_INHERIT_FLAG);
+    bsize = cache_get(dcache, (void **)&b, chash, CACHE_INHERIT_FLAG);
     if (bsize == sizeof(color_inherit)) {
 	memcpy(&color_inherit, b, sizeof(color_inherit));
 	need_color_inherit_avs = false;
     }
     cache_done(dcache);
 
-    bsize = cache_get(dcache, (void **)&b, hash, CACHE_COLOR);
+    bsize = cache_get(dcache, (void **)&b, chash, CACHE_COLOR);
     if (bsize == sizeof(cval)) {
 	memcpy(&cval, b, sizeof(cval));
 	need_cval_avs = false;
@@ -903,7 +1026,7 @@ DbiState::update_dp(struct directory *dp, int reset)
 
 	std::stringstream s;
 	s.write(reinterpret_cast<const char *>(&region_flag), sizeof(region_flag));
-	cache_write(dcache, hash, CACHE_REGION_FLAG, s);
+	cache_write(dcache, chash, CACHE_REGION_FLAG, s);
     }
 
 
@@ -919,7 +1042,7 @@ DbiState::update_dp(struct directory *dp, int reset)
 
 	std::stringstream s;
 	s.write(reinterpret_cast<const char *>(&attr_region_id), sizeof(attr_region_id));
-	cache_write(dcache, hash, CACHE_REGION_ID, s);
+	cache_write(dcache, chash, CACHE_REGION_ID, s);
     }
 
     if (need_color_inherit_avs) {
@@ -931,7 +1054,7 @@ DbiState::update_dp(struct directory *dp, int reset)
 
 	std::stringstream s;
 	s.write(reinterpret_cast<const char *>(&color_inherit), sizeof(color_inherit));
-	cache_write(dcache, hash, CACHE_INHERIT_FLAG, s);
+	cache_write(dcache, chash, CACHE_INHERIT_FLAG, s);
     }
 
     if (need_cval_avs) {
@@ -955,7 +1078,7 @@ DbiState::update_dp(struct directory *dp, int reset)
 
 	std::stringstream s;
 	s.write(reinterpret_cast<const char *>(&cval), sizeof(cval));
-	cache_write(dcache, hash, CACHE_COLOR, s);
+	cache_write(dcache, chash, CACHE_COLOR, s);
     }
 
     // If a region flag is set but a region_id is not, there is an implicit
@@ -1168,160 +1291,294 @@ DbiState::get_path_matrix(matp_t m, std::vector<unsigned long long> &elements)
     return have_mat;
 }
 
-bool
-DbiState::get_bbox(point_t *bbmin, point_t *bbmax, matp_t curr_mat, unsigned long long hash)
+// Hash of the on-disk contents of an object, computed the first time a
+// persistent cache lookup needs it.  Returns 0 (which the cache routines
+// treat as "don't look") if there is no cache or the object can't be read.
+unsigned long long
+DbiState::content_hash(unsigned long long hash)
 {
+    if (!dcache)
+	return 0;
 
-    if (UNLIKELY(!bbmin || !bbmax || hash == 0))
-	return false;
+    std::unordered_map<unsigned long long, unsigned long long>::iterator c_it;
+    c_it = c_hash.find(hash);
+    if (c_it != c_hash.end())
+	return c_it->second;
 
-    bool ret = false;
-    std::unordered_map<unsigned long long, std::unordered_set<unsigned long long>>::iterator pc_it;
-    std::unordered_set<unsigned long long>::iterator s_it;
-    unsigned long long key = hash;
-    // First, see if this is an instance we need to translate to its canonical
-    // .g database name
-    if (i_map.find(hash) != i_map.end())
-	key = i_map[hash];
+    struct directory *dp = get_hdp(hash);
+    if (!dp)
+	return 0;
+    unsigned long long chash = dp_content_hash(dbip, dp);
+    c_hash[hash] = chash;
+    return chash;
+}
 
-    // See if we have a direct bbox lookup available
-    std::unordered_map<unsigned long long, std::vector<fastf_t>>::iterator b_it;
-    b_it = bboxes.find(key);
-    if (b_it != bboxes.end()) {
-	point_t lbmin, lbmax;
-	lbmin[X] = b_it->second[0];
-	lbmin[Y] = b_it->second[1];
-	lbmin[Z] = b_it->second[2];
-	lbmax[X] = b_it->second[3];
-	lbmax[Y] = b_it->second[4];
-	lbmax[Z] = b_it->second[5];
-
-	if (curr_mat) {
-	    point_t tbmin, tbmax;
-	    MAT4X3PNT(tbmin, curr_mat, lbmin);
-	    VMOVE(lbmin, tbmin);
-	    MAT4X3PNT(tbmax, curr_mat, lbmax);
-	    VMOVE(lbmax, tbmax);
-	}
+// Solids whose shape comes from another object or from a file - their
+// record can stay the same while their extent changes, so the content hash
+// doesn't identify their bounds.  (Same set draw.cpp keeps off its parallel
+// plotting path.)
+static int
+bbox_external_geometry(struct directory *dp)
+{
+    if (!dp || dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
+	return 0;
+    switch (dp->d_minor_type) {
+	case DB5_MINORTYPE_BRLCAD_DSP:
+	case DB5_MINORTYPE_BRLCAD_EBM:
+	case DB5_MINORTYPE_BRLCAD_VOL:
+	case DB5_MINORTYPE_BRLCAD_SUBMODEL:
+	    return 1;
+	default:
+	    return 0;
+    }
+}
 
-	VMINMAX(*bbmin, *bbmax, lbmin);
-	VMINMAX(*bbmin, *bbmax, lbmax);
-	return true;
+// Key identifying the bounds of an object.  For solids that's just the
+// content hash, but a comb's extent also depends on everything below it - we
+// fold the child keys (in tree order) into the comb's own content hash so any
+// change in the subtree yields a new key.  Solids whose extent depends on
+// data outside their own record get no key, and neither do combs above
+// them, so their bounds are never persisted.
+unsigned long long
+DbiState::bbox_key(unsigned long long hash, std::unordered_set<unsigned long long> &visiting)
+{
+    std::unordered_map<unsigned long long, unsigned long long>::iterator k_it;
+    k_it = bkeys.find(hash);
+    if (k_it != bkeys.end())
+	return k_it->second;
+
+    unsigned long long chash = content_hash(hash);
+    if (!chash)
+	return 0;
+
+    std::unordered_map<unsigned long long, std::vector<unsigned long long>>::iterator pv_it;
+    pv_it = p_v.find(hash);
+    if (pv_it == p_v.end()) {
+	if (bbox_external_geometry(get_hdp(hash)))
+	    chash = 0;
+	bkeys[hash] = chash;
+	return chash;
     }
 
-    // We might have a comb.  If that's the case, we need to work
-    // through the hierarchy to get the bboxes of the children.
-    pc_it = p_c.find(key);
-    if (pc_it != p_c.end()) {
-	// Have comb children - incorporate each one
-	for (s_it = pc_it->second.begin(); s_it != pc_it->second.end(); s_it++) {
-	    unsigned long long child_hash = *s_it;
-	    // See if we have a matrix for this case - if so, we need to
-	    // incorporate it
-	    mat_t nm;
-	    MAT_IDN(nm);
-	    bool have_mat = get_matrix(nm, key, child_hash);
-	    if (have_mat) {
-		// Construct new "current" matrix
-		if (curr_mat) {
-		    // If we already have a non-IDN matrix from parent
-		    // path elements, we need to multiply the matrices
-		    // to accumulate the position changes
-		    mat_t om;
-		    MAT_COPY(om, curr_mat);
-		    bn_mat_mul(curr_mat, om, nm);
-		    if (get_bbox(bbmin, bbmax, curr_mat, child_hash))
-			ret = true;
-		    MAT_COPY(curr_mat, om);
-		} else {
-		    // If this is the first non-IDN matrix, we don't
-		    // need to combine it with parent matrices
-		    if (get_bbox(bbmin, bbmax, nm, child_hash))
-			ret = true;
-		}
-	    } else {
-		if (get_bbox(bbmin, bbmax, curr_mat, child_hash))
-		    ret = true;
-	    }
+    // Cyclic combs don't have a well defined extent
+    if (visiting.find(hash) != visiting.end())
+	return 0;
+    visiting.insert(hash);
+
+    std::vector<unsigned long long> kv;
+    kv.push_back(chash);
+    for (size_t i = 0; i < pv_it->second.size(); i++) {
+	unsigned long long ckey = pv_it->second[i];
+	if (i_map.find(ckey) != i_map.end())
+	    ckey = i_map[ckey];
+	unsigned long long cbkey = bbox_key(ckey, visiting);
+	if (!cbkey && d_map.find(ckey) != d_map.end()) {
+	    // A real child we couldn't key (cyclic, or with external
+	    // geometry) - don't persist
+	    visiting.erase(hash);
+	    return 0;
 	}
+	kv.push_back(cbkey);
+    }
+
+    visiting.erase(hash);
+    unsigned long long key = bu_data_hash(kv.data(), kv.size() * sizeof(unsigned long long));
+    bkeys[hash] = key;
+    return key;
+}
+
+// Bounds of the canonical object hash in its own coordinate system.
+bool
+DbiState::obj_bbox(point_t *bmin, point_t *bmax, unsigned long long hash, std::unordered_set<unsigned long long> &visiting)
+{
+    std::unordered_map<unsigned long long, std::vector<fastf_t>>::iterator b_it;
+    b_it = bboxes.find(hash);
+    if (b_it != bboxes.end()) {
+	VSET(*bmin, b_it->second[0], b_it->second[1], b_it->second[2]);
+	VSET(*bmax, b_it->second[3], b_it->second[4], b_it->second[5]);
+	return true;
     }
 
-    // When we have an object that is not a comb, look up its pre-calculated
-    // box and incorporate it into bmin/bmax.
-    point_t bmin, bmax;
+    struct directory *dp = get_hdp(hash);
+    if (!dp)
+	return false;
+
+    // Cyclic references don't contribute
+    if (visiting.find(hash) != visiting.end())
+	return false;
+
     bool have_bbox = false;
+    VSETALL(*bmin, INFINITY);
+    VSETALL(*bmax, -INFINITY);
 
     // First, check the dcache
+    std::unordered_set<unsigned long long> kvisiting;
+    unsigned long long key = bbox_key(hash, kvisiting);
     const char *b = NULL;
-    size_t bsize = cache_get(dcache, (void **)&b, hash, CACHE_OBJ_BOUNDS);
+    size_t bsize = cache_get(dcache, (void **)&b, key, CACHE_OBJ_BOUNDS);
     if (bsize) {
-	if (bsize != (sizeof(bmin) + sizeof(bmax))) {
+	if (bsize != (sizeof(point_t) * 2)) {
 	    bu_log("Incorrect data size found loading cached bounds data\n");
 	} else {
-	    memcpy(&bmin, b, sizeof(bmin));
-	    b += sizeof(bmin);
-	    memcpy(&bmax, b, sizeof(bmax));
-	    //bu_log("cached: bmin: %f %f %f bbmax: %f %f %f\n", V3ARGS(bmin), V3ARGS(bmax));
+	    memcpy(bmin, b, sizeof(point_t));
+	    b += sizeof(point_t);
+	    memcpy(bmax, b, sizeof(point_t));
+	    //bu_log("cached: bmin: %f %f %f bbmax: %f %f %f\n", V3ARGS(*bmin), V3ARGS(*bmax));
 	    have_bbox = true;
 	}
     }
     cache_done(dcache);
 
+    // We might have a comb.  If that's the case, we need to work through the
+    // hierarchy to get the bboxes of the children.  Each child's box is in
+    // its own coordinates, so it is placed using all eight corners.
+    std::unordered_map<unsigned long long, std::unordered_set<unsigned long long>>::iterator pc_it;
+    pc_it = p_c.find(hash);
+    if (!have_bbox && pc_it != p_c.end()) {
+	visiting.insert(hash);
+	std::unordered_set<unsigned long long>::iterator s_it;
+	for (s_it = pc_it->second.begin(); s_it != pc_it->second.end(); s_it++) {
+	    unsigned long long child_hash = *s_it;
+	    unsigned long long ckey = child_hash;
+	    if (i_map.find(child_hash) != i_map.end())
+		ckey = i_map[child_hash];
+	    point_t cmin, cmax;
+	    if (!obj_bbox(&cmin, &cmax, ckey, visiting))
+		continue;
+	    mat_t nm;
+	    if (!get_matrix(nm, hash, child_hash)) {
+		VMINMAX(*bmin, *bmax, cmin);
+		VMINMAX(*bmin, *bmax, cmax);
+		have_bbox = true;
+		continue;
+	    }
+	    for (int j = 0; j < 8; j++) {
+		point_t c, tc;
+		VSET(c, (j & 1) ? cmax[X] : cmin[X], (j & 2) ? cmax[Y] : cmin[Y], (j & 4) ? cmax[Z] : cmin[Z]);
+		MAT4X3PNT(tc, nm, c);
+		VMINMAX(*bmin, *bmax, tc);
+	    }
+	    have_bbox = true;
+	}
+	visiting.erase(hash);
+    }
 
-    // This calculation can be expensive.  If we've already
-    // got it stashed as part of LoD processing, use that
-    // version.
-    struct directory *dp = get_hdp(hash);
-    if (!dp)
-	return false;
-    if (!have_bbox) {
+    // When we have an object that is not a comb, we need to calculate its
+    // box.  This calculation can be expensive.  If we've already got it
+    // stashed as part of LoD processing, use that version.
+    if (!have_bbox && pc_it == p_c.end()) {
 	if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BOT && gedp->ged_lod) {
-	    key = bv_mesh_lod_key_get(gedp->ged_lod, dp->d_namep);
-	    if (key) {
-		struct bv_mesh_lod *lod = bv_mesh_lod_create(gedp->ged_lod, key);
+	    unsigned long long lkey = bv_mesh_lod_key_get(gedp->ged_lod, dp->d_namep);
+	    if (lkey) {
+		struct bv_mesh_lod *lod = bv_mesh_lod_create(gedp->ged_lod, lkey);
 		if (lod) {
-		    VMOVE(bmin, lod->bmin);
-		    VMOVE(bmax, lod->bmax);
+		    VMOVE(*bmin, lod->bmin);
+		    VMOVE(*bmax, lod->bmax);
 		    have_bbox = true;
-
-		    std::stringstream s;
-		    s.write(reinterpret_cast<const char *>(&bmin), sizeof(bmin));
-		    s.write(reinterpret_cast<const char *>(&bmax), sizeof(bmax));
-		    cache_write(dcache, hash, CACHE_OBJ_BOUNDS, s);
 		}
 	    }
 	}
+
+	// No LoD - ask librt
+	if (!have_bbox) {
+	    struct bg_tess_tol ttol = BG_TESS_TOL_INIT_ZERO;
+	    struct bn_tol tol = BN_TOL_INIT_TOL;
+	    mat_t m;
+	    MAT_IDN(m);
+	    if (rt_bound_instance(bmin, bmax, dp, dbip, &ttol, &tol, &m, res) != -1)
+		have_bbox = true;
+	}
     }
 
-    // No LoD - ask librt
-    if (!have_bbox) {
-	struct bg_tess_tol ttol = BG_TESS_TOL_INIT_ZERO;
-	struct bn_tol tol = BN_TOL_INIT_TOL;
-	mat_t m;
-	MAT_IDN(m);
-	int bret = rt_bound_instance(&bmin, &bmax, dp, dbip, &ttol, &tol, &m, res);
-	if (bret != -1) {
-	    have_bbox = true;
+    if (!have_bbox)
+	return false;
 
-	    std::stringstream s;
-	    s.write(reinterpret_cast<const char *>(&bmin), sizeof(bmin));
-	    s.write(reinterpret_cast<const char *>(&bmax), sizeof(bmax));
-	    cache_write(dcache, hash, CACHE_OBJ_BOUNDS, s);
-	}
+    if (!bsize) {
+	std::stringstream s;
+	s.write(reinterpret_cast<const char *>(bmin), sizeof(point_t));
+	s.write(reinterpret_cast<const char *>(bmax), sizeof(point_t));
+	cache_write(dcache, key, CACHE_OBJ_BOUNDS, s);
+    }
+
+    std::vector<fastf_t> &bv = bboxes[hash];
+    bv.clear();
+    for (size_t j = 0; j < 3; j++)
+	bv.push_back((*bmin)[j]);
+    for (size_t j = 0; j < 3; j++)
+	bv.push_back((*bmax)[j]);
+
+    return true;
+}
+
+bool
+DbiState::get_bbox(point_t *bbmin, point_t *bbmax, matp_t curr_mat, unsigned long long hash)
+{
+
+    if (UNLIKELY(!bbmin || !bbmax || hash == 0))
+	return false;
+
+    unsigned long long key = hash;
+    // First, see if this is an instance we need to translate to its canonical
+    // .g database name
+    if (i_map.find(hash) != i_map.end())
+	key = i_map[hash];
+
+    point_t lbmin, lbmax;
+    std::unordered_set<unsigned long long> visiting;
+    if (!obj_bbox(&lbmin, &lbmax, key, visiting))
+	return false;
+
+    if (!curr_mat) {
+	VMINMAX(*bbmin, *bbmax, lbmin);
+	VMINMAX(*bbmin, *bbmax, lbmax);
+	return true;
     }
 
-    if (have_bbox) {
-	for (size_t j = 0; j < 3; j++)
-	    bboxes[hash].push_back(bmin[j]);
-	for (size_t j = 0; j < 3; j++)
-	    bboxes[hash].push_back(bmax[j]);
+    for (int j = 0; j < 8; j++) {
+	point_t c, tc;
+	VSET(c, (j & 1) ? lbmax[X] : lbmin[X], (j & 2) ? lbmax[Y] : lbmin[Y], (j & 4) ? lbmax[Z] : lbmin[Z]);
+	MAT4X3PNT(tc, curr_mat, c);
+	VMINMAX(*bbmin, *bbmax, tc);
+    }
+
+    return true;
+}
+
+// Drop the in-memory bounds information for the specified objects and for
+// every comb above them.
+void
+DbiState::invalidate_bboxes(std::unordered_set<unsigned long long> &hashes)
+{
+    if (!hashes.size())
+	return;
 
-	VMINMAX(*bbmin, *bbmax, bmin);
-	VMINMAX(*bbmin, *bbmax, bmax);
-	ret = true;
+    std::unordered_map<unsigned long long, std::unordered_set<unsigned long long>> parents;
+    std::unordered_map<unsigned long long, std::unordered_set<unsigned long long>>::iterator pc_it;
+    std::unordered_set<unsigned long long>::iterator s_it;
+    for (pc_it = p_c.begin(); pc_it != p_c.end(); pc_it++) {
+	for (s_it = pc_it->second.begin(); s_it != pc_it->second.end(); s_it++) {
+	    unsigned long long ckey = *s_it;
+	    if (i_map.find(ckey) != i_map.end())
+		ckey = i_map[ckey];
+	    parents[ckey].insert(pc_it->first);
+	}
     }
 
-    return ret;
+    std::unordered_set<unsigned long long> done;
+    std::vector<unsigned long long> q(hashes.begin(), hashes.end());
+    while (q.size()) {
+	unsigned long long h = q.back();
+	q.pop_back();
+	if (done.find(h) != done.end())
+	    continue;
+	done.insert(h);
+	bboxes.erase(h);
+	bkeys.erase(h);
+	pc_it = parents.find(h);
+	if (pc_it == parents.end())
+	    continue;
+	q.insert(q.end(), pc_it->second.begin(), pc_it->second.end());
+    }
 }
 
 bool
@@ -1551,6 +1808,17 @@ DbiState::update()
 	changed_hashes.insert(hash);
     }
 
+    // Bounds of anything above a changed object are no longer valid.  (The
+    // persistent cache doesn't need this - its comb bounds keys incorporate
+    // the contents of the children.)
+    std::unordered_set<unsigned long long> bchanged = changed_hashes;
+    bchanged.insert(removed.begin(), removed.end());
+    for(g_it = added.begin(); g_it != added.end(); g_it++) {
+	struct directory *dp = *g_it;
+	bchanged.insert(bu_data_hash(dp->d_namep, strlen(dp->d_namep)*sizeof(char)));
+    }
+    invalidate_bboxes(bchanged);
+
     // Update the primary data structures
     for(s_it = removed.begin(); s_it != removed.end(); s_it++) {
 	bu_log("removed: %llu\n", *s_it);
@@ -1569,6 +1837,7 @@ DbiState::update()
 	}
 
 	d_map.erase(*s_it);
+	c_hash.erase(*s_it);
 	bboxes.erase(*s_it);
 	c_inherit.erase(*s_it);
 	rgb.erase(*s_it);
@@ -2318,6 +2587,7 @@ BViewState::scene_obj(
     ud->ttol = &wdbp->wdb_ttol;
     ud->res = &rt_uniresource; // TODO - at some point this may be from the app or view... local_res is temporary, don't use it here
     ud->mesh_c = dbis->gedp->ged_lod;
+    ud->vlist_c = dbis->gedp->ged_vlist_c;
     sp->dp = dp;
     sp->s_i_data = (void *)ud;
 
@@ -2690,7 +2960,7 @@ BViewState::refresh(struct bview *v, int argc, const char **argv)
 }
 
 unsigned long long
-BViewState::redraw(struct bv_obj_settings *vs, std::unordered_set<struct bview *> &views, int no_autoview)
+BViewState::redraw(struct bv_obj_settings *vs, std::unordered_set<struct bview *> &views, int no_autoview, bu_clbk_t clbk, void *clbk_data)
 {
     bv_log(1, "BViewState::redraw");
     // We (well, callers) need to be able to tell if the redraw pass actually
@@ -2912,13 +3182,44 @@ BViewState::redraw(struct bv_obj_settings *vs, std::unordered_set<struct bview *
     // work for the "top level" object used for adaptive cases, since shared
     // views will be using a shared object pool for anything other than their
     // view specific geometry sub-objects.
+    std::vector<struct bv_scene_obj *> dobjs(objs.begin(), objs.end());
+    struct bu_ptbl cancelled;
+    bu_ptbl_init(&cancelled, 8, "cancelled objs");
     for (v_it = views.begin(); v_it != views.end(); v_it++) {
-	std::unordered_set<struct bv_scene_obj *>::iterator o_it;
-	for (o_it = objs.begin(); o_it != objs.end(); o_it++) {
-	    bv_log(3, "redraw %s[%s]", bu_vls_cstr(&((*(*o_it)).s_name)), bu_vls_cstr(&((*(*v_it)).gv_name)));
-	    draw_scene(*o_it, *v_it);
+	bv_log(3, "redraw %zu objs[%s]", dobjs.size(), bu_vls_cstr(&((*(*v_it)).gv_name)));
+	draw_scene_objs(dobjs.data(), dobjs.size(), *v_it, clbk, clbk_data, &cancelled);
+	if (BU_PTBL_LEN(&cancelled))
+	    break;
+    }
+
+    // If the draw was cancelled, anything that didn't get geometry is
+    // removed rather than being left in the scene as an empty object
+    if (BU_PTBL_LEN(&cancelled)) {
+	std::unordered_set<struct bv_scene_obj *> cset;
+	for (size_t i = 0; i < BU_PTBL_LEN(&cancelled); i++)
+	    cset.insert((struct bv_scene_obj *)BU_PTBL_GET(&cancelled, i));
+	std::vector<std::pair<unsigned long long, int>> cobjs;
+	std::unordered_map<unsigned long long, std::unordered_map<int, struct bv_scene_obj *>>::iterator s_it;
+	for (s_it = s_map.begin(); s_it != s_map.end(); s_it++) {
+	    std::unordered_map<int, struct bv_scene_obj *>::iterator sm_it;
+	    for (sm_it = s_it->second.begin(); sm_it != s_it->second.end(); sm_it++) {
+		if (cset.find(sm_it->second) != cset.end())
+		    cobjs.push_back(std::make_pair(s_it->first, sm_it->first));
+	    }
 	}
+	for (size_t i = 0; i < cobjs.size(); i++) {
+	    if (s_keys.find(cobjs[i].first) == s_keys.end())
+		continue;
+	    std::vector<unsigned long long> phashes = s_keys[cobjs[i].first];
+	    if (!phashes.size())
+		continue;
+	    unsigned long long c_hash = phashes[phashes.size() - 1];
+	    phashes.pop_back();
+	    erase_hpath(cobjs[i].second, c_hash, phashes, false);
+	}
+	ret = GED_DBISTATE_VIEW_CHANGE;
     }
+    bu_ptbl_free(&cancelled);
 
     // We need to check if any drawn solids are selected.  If so, we need
     // to illuminate them.  This is what ensures that newly drawn solids
@@ -27,6 +27,7 @@
 
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #include <stdlib.h>
 #include <ctype.h>
@@ -37,10 +38,13 @@
 #include "bu/cmd.h"
 #include "bu/hash.h"
 #include "bu/opt.h"
+#include "bu/parallel.h"
 #include "bu/sort.h"
 #include "bu/str.h"
+#include "bu/time.h"
 #include "bv/defines.h"
 #include "bg/sat.h"
+#include "bg/trimesh.h"
 #include "bv/lod.h"
 #include "nmg.h"
 #include "rt/view.h"
@@ -245,6 +249,99 @@ bot_mesh_info_free_clbk(struct bv_mesh_lod *lod, void *cb_data)
     return 0;
 }
 
+/* BoTs with at least this many faces and no LoD cache data have that data
+ * generated in the background, drawing a bounding box until it is ready */
+#define DRAW_LOD_BG_MIN_FACES 100000
+
+static void bot_adaptive_plot(struct bv_scene_obj *s, struct bview *v);
+
+static void
+bot_lod_bg_release(void *data)
+{
+    struct rt_db_internal *ip = (struct rt_db_internal *)data;
+    rt_db_free_internal(ip);
+    BU_PUT(ip, struct rt_db_internal);
+}
+
+/* Update callback for objects waiting on background LoD generation - once
+ * the data is ready, replace the placeholder with the real LoD object. */
+static int
+bot_lod_bg_check(struct bv_scene_obj *s, struct bview *v, int UNUSED(flags))
+{
+    struct draw_update_data_t *d = (struct draw_update_data_t *)s->s_i_data;
+    struct db_full_path *fp = (struct db_full_path *)s->s_path;
+    struct directory *dp = (fp) ? DB_FULL_PATH_CUR_DIR(fp) : (struct directory *)s->dp;
+    if (!d || !d->mesh_c || !dp || !v)
+	return 0;
+    if (bv_mesh_lod_cache_pending(d->mesh_c, dp->d_namep))
+	return 0;
+
+    BV_FREE_VLIST(s->vlfree, &s->s_vlist);
+    s->s_update_callback = NULL;
+    if (!bv_mesh_lod_key_get(d->mesh_c, dp->d_namep)) {
+	// Don't keep relaunching a generation that can't succeed
+	bu_log("%s: LoD generation failed\n", dp->d_namep);
+	return 1;
+    }
+    bot_adaptive_plot(s, v);
+    s->s_changed++;
+    return 1;
+}
+
+/* If a large BoT has no LoD data yet, start generating it in the background
+ * rather than stalling the draw.  Returns 1 if the object is waiting on a
+ * background job, else 0 (the caller should proceed normally.) */
+static int
+bot_lod_bg_start(struct bv_scene_obj *s, struct draw_update_data_t *d, struct directory *dp)
+{
+    if (bv_mesh_lod_key_get(d->mesh_c, dp->d_namep))
+	return 0;
+
+    if (!bv_mesh_lod_cache_pending(d->mesh_c, dp->d_namep)) {
+	struct rt_db_internal *ip;
+	BU_GET(ip, struct rt_db_internal);
+	RT_DB_INTERNAL_INIT(ip);
+	if (rt_db_get_internal(ip, dp, d->dbip, NULL, d->res) < 0) {
+	    BU_PUT(ip, struct rt_db_internal);
+	    return 0;
+	}
+	struct rt_bot_internal *bot = (struct rt_bot_internal *)ip->idb_ptr;
+	RT_BOT_CK_MAGIC(bot);
+	if (bot->num_faces < DRAW_LOD_BG_MIN_FACES) {
+	    rt_db_free_internal(ip);
+	    BU_PUT(ip, struct rt_db_internal);
+	    return 0;
+	}
+
+	// Placeholder box, so the user can see (and autoview can find) the
+	// object while its LoD data is generated
+	point_t lmin, lmax;
+	bg_trimesh_aabb(&lmin, &lmax, bot->faces, bot->num_faces, (const point_t *)bot->vertices, bot->num_vertices);
+	VSETALL(s->bmin, INFINITY);
+	VSETALL(s->bmax, -INFINITY);
+	for (int i = 0; i < 8; i++) {
+	    point_t c, tc;
+	    VSET(c, (i & 1) ? lmax[X] : lmin[X], (i & 2) ? lmax[Y] : lmin[Y], (i & 4) ? lmax[Z] : lmin[Z]);
+	    MAT4X3PNT(tc, s->s_mat, c);
+	    VMINMAX(s->bmin, s->bmax, tc);
+	}
+
+	int ret = bv_mesh_lod_cache_bg(d->mesh_c, dp->d_namep, (const point_t *)bot->vertices, bot->num_vertices, NULL, bot->faces, bot->num_faces, 0, 0.66, &bot_lod_bg_release, (void *)ip);
+	if (ret) {
+	    rt_db_free_internal(ip);
+	    BU_PUT(ip, struct rt_db_internal);
+	    if (ret < 0)
+		return 0;
+	}
+
+	BV_FREE_VLIST(s->vlfree, &s->s_vlist);
+	bv_vlist_rpp(s->vlfree, &s->s_vlist, s->bmin, s->bmax);
+    }
+
+    s->s_update_callback = &bot_lod_bg_check;
+    return 1;
+}
+
 static void
 bot_adaptive_plot(struct bv_scene_obj *s, struct bview *v)
 {
@@ -260,11 +357,6 @@ bot_adaptive_plot(struct bv_scene_obj *s, struct bview *v)
 
     if (!vo) {
 
-	vo = bv_obj_get_vo(s, v);
-
-	vo->csg_obj = 0;
-	vo->mesh_obj = 1;
-
 	struct draw_update_data_t *d = (struct draw_update_data_t *)s->s_i_data;
 	if (!d || !d->mesh_c)
 	    return;
@@ -275,6 +367,17 @@ bot_adaptive_plot(struct bv_scene_obj *s, struct bview *v)
 	if (!dp)
 	    return;
 
+	// Large meshes without LoD data get a placeholder until a background
+	// job has generated it.  Until then there is no view object - the
+	// placeholder's update callback will set one up.
+	if (bot_lod_bg_start(s, d, dp))
+	    return;
+
+	vo = bv_obj_get_vo(s, v);
+
+	vo->csg_obj = 0;
+	vo->mesh_obj = 1;
+
 	// We need the key to look up the LoD data from the cache, and if we don't
 	// already have cache data for this bot we need to generate it.
 	unsigned long long key = bv_mesh_lod_key_get(d->mesh_c, dp->d_namep);
@@ -571,6 +674,7 @@ wireframe_plot(struct bv_scene_obj *s, struct bview *v, struct rt_db_internal *i
 	    ld->tol = d->tol;
 	    ld->ttol = d->ttol;
 	    ld->mesh_c = d->mesh_c;
+	    ld->vlist_c = d->vlist_c;
 	    ld->res = d->res;
 	    vo->s_i_data= (void *)ld;
 
@@ -598,6 +702,206 @@ wireframe_plot(struct bv_scene_obj *s, struct bview *v, struct rt_db_internal *i
 }
 
 
+/*****************************************************************************
+
+  Shared wireframes for instanced solids.
+
+  Large models often reference the same leaf solid many times under different
+  matrices (fasteners, track links, ...)  Non-adaptive wireframes and mode 1
+  triangles don't depend on the view, so rather than importing and plotting
+  the solid once per instance with the instance matrix applied, we plot it
+  once in its local coordinates and share that vlist between all the scene
+  objects drawing it.  The display manager applies each object's s_mat when
+  drawing.
+
+  Shared vlists live in a bv_vlist_cache, keyed on a hash of the solid's
+  on-disk data and the parameters that influence its plot.  Editing a solid
+  changes its key, so there is no separate invalidation step - instances
+  redrawn after the edit pick up a new entry, and the old one is freed when
+  the last scene object using it lets it go.
+
+******************************************************************************/
+
+/* Mode 1 draws triangles rather than wireframes for these types */
+#define DRAW_SHARED_POLY(_dmode, _minor) ((_dmode) == 1 && \
+	((_minor) == DB5_MINORTYPE_BRLCAD_BOT || \
+	 (_minor) == DB5_MINORTYPE_BRLCAD_POLY || \
+	 (_minor) == DB5_MINORTYPE_BRLCAD_BREP))
+
+/* Returns 1 for the primitives that get their geometry from other objects or
+ * files, which the solid's own data doesn't capture (and whose ft_plot goes
+ * back to the database or the filesystem to find it). */
+static int
+draw_external_geometry(struct directory *dp)
+{
+    switch (dp->d_minor_type) {
+	case DB5_MINORTYPE_BRLCAD_DSP:
+	case DB5_MINORTYPE_BRLCAD_EBM:
+	case DB5_MINORTYPE_BRLCAD_VOL:
+	case DB5_MINORTYPE_BRLCAD_SUBMODEL:
+	    return 1;
+	default:
+	    break;
+    }
+    return 0;
+}
+
+extern "C" unsigned long long
+draw_shared_key(struct db_i *dbip, struct directory *dp, int dmode, const struct bn_tol *tol, const struct bg_tess_tol *ttol, struct bview *v)
+{
+    if (!dbip || !dp || dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
+	return 0;
+    if (dmode != 0 && dmode != 1)
+	return 0;
+
+    if (draw_external_geometry(dp))
+	return 0;
+
+    struct bu_external ext = BU_EXTERNAL_INIT_ZERO;
+    if (db_get_external(&ext, dp, dbip))
+	return 0;
+
+    struct bu_data_hash_state *state = bu_data_hash_create();
+    if (!state) {
+	bu_free_external(&ext);
+	return 0;
+    }
+    bu_data_hash_update(state, ext.ext_buf, ext.ext_nbytes);
+    bu_free_external(&ext);
+
+    // Modes 0 and 1 both produce the plain wireframe, except for the types
+    // with a triangle plot
+    int poly = DRAW_SHARED_POLY(dmode, dp->d_minor_type) ? 1 : 0;
+    bu_data_hash_update(state, &poly, sizeof(int));
+    if (tol) {
+	bu_data_hash_update(state, &tol->dist, sizeof(double));
+	bu_data_hash_update(state, &tol->perp, sizeof(double));
+    }
+    if (ttol) {
+	bu_data_hash_update(state, &ttol->abs, sizeof(double));
+	bu_data_hash_update(state, &ttol->rel, sizeof(double));
+	bu_data_hash_update(state, &ttol->norm, sizeof(double));
+    }
+    // BoT wireframes are replaced by their bounding box above the view's
+    // face count threshold
+    if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BOT && v && v->gv_s) {
+	size_t bot_threshold = v->gv_s->bot_threshold;
+	bu_data_hash_update(state, &bot_threshold, sizeof(size_t));
+    }
+
+    unsigned long long key = bu_data_hash_val(state);
+    bu_data_hash_destroy(state);
+    return key;
+}
+
+/* Plot the un-instanced ip the same way draw_scene would for dmode */
+static int
+draw_shared_plot(struct bu_list *vhead, struct rt_db_internal *ip, struct directory *dp, int dmode, const struct bg_tess_tol *ttol, const struct bn_tol *tol, struct bview *v)
+{
+    if (DRAW_SHARED_POLY(dmode, ip->idb_minor_type)) {
+	switch (ip->idb_minor_type) {
+	    case DB5_MINORTYPE_BRLCAD_BOT:
+		return rt_bot_plot_poly(vhead, ip, ttol, tol);
+	    case DB5_MINORTYPE_BRLCAD_POLY:
+		return rt_pg_plot_poly(vhead, ip, ttol, tol);
+	    case DB5_MINORTYPE_BRLCAD_BREP:
+		return rt_brep_plot_poly(vhead, dp, ip, ttol, tol, NULL);
+	    default:
+		break;
+	}
+    }
+
+    if (!ip->idb_meth->ft_plot)
+	return 1;
+    return ip->idb_meth->ft_plot(vhead, ip, ttol, tol, v);
+}
+
+/* Replace whatever geometry s has with a reference to sv (which s takes
+ * ownership of) and update the mode to match what was plotted. */
+static void
+draw_shared_attach(struct bv_scene_obj *s, struct bv_vlist_shared *sv, struct directory *dp)
+{
+    if (BU_LIST_NON_EMPTY(&s->s_vlist))
+	BV_FREE_VLIST(&rt_vlfree, &s->s_vlist);
+    if (s->s_type_flags & BV_SHARED_VLIST)
+	bv_vlist_shared_put((struct bv_vlist_shared *)s->draw_data);
+
+    s->draw_data = (void *)sv;
+    s->s_type_flags |= BV_SHARED_VLIST;
+    s->s_vlen = sv->vlen;
+
+    // Mirror draw_scene - everything but the triangle plots and pipes is
+    // reported as a mode 0 wireframe
+    if (DRAW_SHARED_POLY(s->s_os->s_dmode, dp->d_minor_type)) {
+	s->csg_obj = 0;
+    } else {
+	s->csg_obj = 1;
+	if (dp->d_minor_type != DB5_MINORTYPE_BRLCAD_PIPE)
+	    s->s_os->s_dmode = 0;
+    }
+    s->mesh_obj = 0;
+
+    // Shared data is view independent - no need to regenerate per view
+    s->current = 1;
+}
+
+/* If s can be drawn from a shared vlist, look it up (plotting and caching
+ * it first if need be), attach it to s and return 1. */
+static int
+draw_scene_shared(struct bv_scene_obj *s, struct bview *v, struct directory *dp)
+{
+    struct draw_update_data_t *d = (struct draw_update_data_t *)s->s_i_data;
+    if (!d || !d->vlist_c)
+	return 0;
+
+    // Adaptive wireframes are view specific
+    if (v && v->gv_s->adaptive_plot_csg)
+	return 0;
+
+    int dmode = s->s_os->s_dmode;
+    unsigned long long key = draw_shared_key(d->dbip, dp, dmode, d->tol, d->ttol, s->s_v);
+    if (!key)
+	return 0;
+
+    struct bv_vlist_shared *sv = bv_vlist_cache_get(d->vlist_c, key);
+    if (!sv) {
+	struct rt_db_internal dbintern;
+	RT_DB_INTERNAL_INIT(&dbintern);
+	if (rt_db_get_internal(&dbintern, dp, d->dbip, NULL, d->res) < 0)
+	    return 0;
+
+	struct bu_list vhead;
+	BU_LIST_INIT(&vhead);
+	int ret = draw_shared_plot(&vhead, &dbintern, dp, dmode, d->ttol, d->tol, s->s_v);
+	rt_db_free_internal(&dbintern);
+	if (ret < 0) {
+	    BV_FREE_VLIST(&rt_vlfree, &vhead);
+	    return 0;
+	}
+	sv = bv_vlist_cache_put(d->vlist_c, key, &vhead);
+	if (!sv)
+	    return 0;
+    }
+
+    draw_shared_attach(s, sv, dp);
+    return 1;
+}
+
+/* Common bookkeeping once geometry has been generated for s */
+static void
+draw_scene_finalize(struct bv_scene_obj *s, struct bview *v)
+{
+    // Update s_size and s_center
+    bv_scene_obj_bound(s, v);
+
+    // Store current view info, in case of adaptive plotting
+    s->adaptive_wireframe = s->s_v->gv_s->adaptive_plot_csg;
+    s->view_scale = s->s_v->gv_scale;
+    s->bot_threshold= s->s_v->gv_s->bot_threshold;
+    s->curve_scale = s->s_v->gv_s->curve_scale;
+    s->point_scale = s->s_v->gv_s->point_scale;
+}
+
 extern "C" int draw_m3(struct bv_scene_obj *s);
 extern "C" int draw_points(struct bv_scene_obj *s);
 
@@ -681,6 +985,12 @@ draw_scene(struct bv_scene_obj *s, struct bview *v)
 	return;
     }
 
+    // View independent plots of solids are shared between instances
+    if (draw_scene_shared(s, v, dp)) {
+	draw_scene_finalize(s, v);
+	return;
+    }
+
     /**************************************************************************
      * For the remainder of the options we're into more standard wireframe
      * callback modes - crack the internal and stage the tolerances
@@ -775,19 +1085,378 @@ draw_scene(struct bv_scene_obj *s, struct bview *v)
 
 geom_done:
 
-    // Update s_size and s_center
-    bv_scene_obj_bound(s, v);
-
-    // Store current view info, in case of adaptive plotting
-    s->adaptive_wireframe = s->s_v->gv_s->adaptive_plot_csg;
-    s->view_scale = s->s_v->gv_scale;
-    s->bot_threshold= s->s_v->gv_s->bot_threshold;
-    s->curve_scale = s->s_v->gv_s->curve_scale;
-    s->point_scale = s->s_v->gv_s->point_scale;
+    draw_scene_finalize(s, v);
 
     rt_db_free_internal(&dbintern);
 }
 
+/*****************************************************************************
+
+  Parallel plotting of solid wireframes.
+
+  Importing a solid and running its plot method doesn't depend on any other
+  solid, so large draws hand those jobs to bu_parallel workers.  Jobs are
+  processed in batches - after each batch the new vlists are moved into their
+  scene objects on the calling thread, and the caller gets a chance to publish
+  the partial results to the view (or to cancel the rest of the draw).
+
+  Primitive plot routines allocate vlist chunks from the global rt_vlfree
+  list, which isn't safe to pop from in more than one thread.  While workers
+  are running we set aside the contents of rt_vlfree, so BV_GET_VLIST only
+  ever sees an empty list and allocates new chunks.  The set aside chunks are
+  returned to rt_vlfree once the batch is done.
+
+******************************************************************************/
+
+/* Number of jobs per worker thread in each batch.  Large enough to amortize
+ * thread startup, small enough to let the view update regularly. */
+#define DRAW_PLOT_BATCH_PER_CPU 256
+
+/* Draws with at least this many objects report their timing */
+#define DRAW_TIMING_MIN_OBJS 10000
+
+struct draw_plot_state {
+    struct draw_plot_job *jobs;
+    size_t next;
+    size_t end;
+    struct resource *res;
+};
+
+static void
+draw_plot_job_run(struct draw_plot_job *j, struct resource *res)
+{
+    struct rt_db_internal dbintern;
+    struct rt_db_internal *ip = &dbintern;
+    RT_DB_INTERNAL_INIT(ip);
+
+    j->ret = -1;
+    j->sv = NULL;
+
+    // Shared plots are done in the solid's local coordinates
+    matp_t mat = (j->vlist_c) ? NULL : j->s->s_mat;
+    if (rt_db_get_internal(ip, j->dp, j->dbip, mat, res) < 0)
+	return;
+
+    if (j->vlist_c) {
+	j->ret = draw_shared_plot(&j->vhead, ip, j->dp, j->s->s_os->s_dmode, j->ttol, j->tol, j->v);
+	if (j->ret >= 0)
+	    j->sv = bv_vlist_cache_put(j->vlist_c, j->key, &j->vhead);
+    } else if (j->adaptive && ip->idb_meth->ft_adaptive_plot) {
+	j->ret = ip->idb_meth->ft_adaptive_plot(&j->vhead, ip, j->tol, j->v, j->s->s_size);
+    } else if (ip->idb_meth->ft_plot) {
+	j->ret = ip->idb_meth->ft_plot(&j->vhead, ip, j->ttol, j->tol, j->v);
+    } else {
+	// Nothing to plot
+	j->ret = 1;
+    }
+
+    rt_db_free_internal(ip);
+}
+
+static void
+draw_plot_worker(int cpu, void *data)
+{
+    struct draw_plot_state *st = (struct draw_plot_state *)data;
+    struct resource *res = &st->res[cpu];
+
+    while (1) {
+	bu_semaphore_acquire(RT_SEM_WORKER);
+	size_t i = st->next++;
+	bu_semaphore_release(RT_SEM_WORKER);
+	if (i >= st->end)
+	    return;
+	draw_plot_job_run(&st->jobs[i], res);
+    }
+}
+
+extern "C" size_t
+draw_plot_parallel(struct draw_plot_job *jobs, size_t cnt, size_t ncpu, draw_plot_publish_t publish, void *data)
+{
+    if (!jobs || !cnt)
+	return 0;
+
+    if (!ncpu)
+	ncpu = bu_avail_cpus();
+    if (ncpu > MAX_PSW)
+	ncpu = MAX_PSW;
+    if (ncpu > cnt)
+	ncpu = cnt;
+
+    struct resource *res = (struct resource *)bu_calloc(ncpu, sizeof(struct resource), "draw_plot_parallel resources");
+    for (size_t i = 0; i < ncpu; i++)
+	rt_init_resource(&res[i], (int)i, NULL);
+
+    struct bu_list vlreserve;
+    BU_LIST_INIT(&vlreserve);
+
+    size_t batch = ncpu * DRAW_PLOT_BATCH_PER_CPU;
+    size_t done = 0;
+    while (done < cnt) {
+	struct draw_plot_state st;
+	st.jobs = jobs;
+	st.next = done;
+	st.end = (cnt - done > batch) ? done + batch : cnt;
+	st.res = res;
+
+	for (size_t i = st.next; i < st.end; i++) {
+	    BU_LIST_INIT(&jobs[i].vhead);
+	    jobs[i].ret = -1;
+	}
+
+	if (ncpu > 1) {
+	    BU_LIST_APPEND_LIST(&vlreserve, &rt_vlfree);
+	    bu_parallel(draw_plot_worker, ncpu, (void *)&st);
+	    BU_LIST_APPEND_LIST(&rt_vlfree, &vlreserve);
+	} else {
+	    draw_plot_worker(0, (void *)&st);
+	}
+
+	// Hand the new vlists over to their scene objects
+	for (size_t i = done; i < st.end; i++) {
+	    struct draw_plot_job *j = &jobs[i];
+	    if (j->sv) {
+		draw_shared_attach(j->s, j->sv, j->dp);
+		continue;
+	    }
+	    if (j->vlist_c) {
+		// Failed shared plot - local coordinates, not usable as is
+		BV_FREE_VLIST(&rt_vlfree, &j->vhead);
+		continue;
+	    }
+	    if (BU_LIST_IS_EMPTY(&j->s->s_vlist))
+		j->s->s_vlen = 0;
+	    j->s->s_vlen += bv_vlist_cmd_cnt((struct bv_vlist *)&j->vhead);
+	    BU_LIST_APPEND_LIST(&j->s->s_vlist, &j->vhead);
+	}
+
+	size_t bstart = done;
+	done = st.end;
+	if (publish && (*publish)(&jobs[bstart], done - bstart, done, cnt, data))
+	    break;
+    }
+
+    for (size_t i = 0; i < ncpu; i++)
+	rt_clean_resource_basic(NULL, &res[i]);
+    bu_free(res, "draw_plot_parallel resources");
+
+    return done;
+}
+
+/* If draw_scene(s, v) would do nothing more than import s's solid and run its
+ * view independent ft_plot, set up j to do the same thing and return 1.
+ * Otherwise, return 0 - s needs the full draw_scene logic. */
+static int
+draw_scene_plot_job(struct draw_plot_job *j, struct bv_scene_obj *s, struct bview *v)
+{
+    if (!s || s->current)
+	return 0;
+    struct draw_update_data_t *d = (struct draw_update_data_t *)s->s_i_data;
+    if (!d)
+	return 0;
+
+    // Adaptive wireframes are view specific
+    if (v && v->gv_s->adaptive_plot_csg)
+	return 0;
+
+    int dmode = s->s_os->s_dmode;
+    if (dmode != 0 && dmode != 1)
+	return 0;
+
+    struct db_full_path *fp = (struct db_full_path *)s->s_path;
+    if (fp && fp->fp_len <= 0)
+	return 0;
+    struct directory *dp = (fp) ? DB_FULL_PATH_CUR_DIR(fp) : (struct directory *)s->dp;
+    if (!dp || dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
+	return 0;
+
+    // Shaded mode has special handling for these types
+    if (dmode == 1 && (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BOT ||
+		dp->d_minor_type == DB5_MINORTYPE_BRLCAD_POLY ||
+		dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BREP))
+	return 0;
+
+    // Adaptive BoTs are handled by the LoD logic
+    if (v && v->gv_s->adaptive_plot_mesh && dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BOT)
+	return 0;
+
+    // Plotting these reads other objects or files (submodels open and walk a
+    // whole database), which we don't do from the parallel workers
+    if (draw_external_geometry(dp))
+	return 0;
+
+    j->s = s;
+    j->dp = dp;
+    j->dbip = d->dbip;
+    j->tol = d->tol;
+    j->ttol = d->ttol;
+    j->v = s->s_v;
+    j->adaptive = 0;
+    j->vlist_c = NULL;
+    j->key = 0;
+    j->sv = NULL;
+    j->ret = -1;
+
+    if (d->vlist_c) {
+	j->key = draw_shared_key(d->dbip, dp, dmode, d->tol, d->ttol, s->s_v);
+	if (j->key)
+	    j->vlist_c = d->vlist_c;
+    }
+
+    return 1;
+}
+
+struct draw_scene_objs_data {
+    struct bview *v;
+    bu_clbk_t clbk;
+    void *clbk_data;
+    struct draw_progress p;
+    int64_t start;
+    int cancel;
+
+    // Instances sharing the vlist plotted by each job, and the instances
+    // which need another try if that plot failed
+    struct draw_plot_job *jobs;
+    std::vector<std::vector<struct bv_scene_obj *>> *instances;
+    std::vector<struct bv_scene_obj *> *retry;
+};
+
+static int
+draw_scene_progress(struct draw_scene_objs_data *sd)
+{
+    if (!sd->clbk)
+	return 0;
+    sd->p.elapsed = bu_gettime() - sd->start;
+    if ((*sd->clbk)(0, NULL, (void *)&sd->p, sd->clbk_data))
+	sd->cancel = 1;
+    return sd->cancel;
+}
+
+static int
+draw_scene_publish(struct draw_plot_job *jobs, size_t cnt, size_t UNUSED(done), size_t UNUSED(total), void *data)
+{
+    struct draw_scene_objs_data *sd = (struct draw_scene_objs_data *)data;
+    for (size_t i = 0; i < cnt; i++) {
+	struct bv_scene_obj *s = jobs[i].s;
+	s->csg_obj = 1;
+	s->mesh_obj = 0;
+	if (!jobs[i].ret) {
+	    // Because this data is view independent, it only needs to be
+	    // generated once rather than per-view.
+	    s->current = 1;
+	}
+	// Mirror draw_scene - plain wireframes are reported as mode 0
+	if (jobs[i].dp->d_minor_type != DB5_MINORTYPE_BRLCAD_PIPE)
+	    s->s_os->s_dmode = 0;
+	draw_scene_finalize(s, sd->v);
+
+	// Other instances of the same solid pick up the shared vlist
+	std::vector<struct bv_scene_obj *> &inst = (*sd->instances)[&jobs[i] - sd->jobs];
+	for (size_t k = 0; k < inst.size(); k++) {
+	    struct bv_vlist_shared *sv = (jobs[i].sv) ? bv_vlist_cache_get(jobs[i].vlist_c, jobs[i].key) : NULL;
+	    if (!sv) {
+		sd->retry->push_back(inst[k]);
+		continue;
+	    }
+	    draw_shared_attach(inst[k], sv, jobs[i].dp);
+	    draw_scene_finalize(inst[k], sd->v);
+	    sd->p.done++;
+	}
+    }
+    sd->p.done += cnt;
+    return draw_scene_progress(sd);
+}
+
+extern "C" size_t
+draw_scene_objs(struct bv_scene_obj **objs, size_t cnt, struct bview *v, bu_clbk_t clbk, void *clbk_data, struct bu_ptbl *cancelled)
+{
+    if (!objs || !cnt)
+	return 0;
+
+    struct draw_scene_objs_data sd;
+    sd.v = v;
+    sd.clbk = clbk;
+    sd.clbk_data = clbk_data;
+    sd.p.done = 0;
+    sd.p.total = cnt;
+    sd.p.elapsed = 0;
+    sd.start = bu_gettime();
+    sd.cancel = 0;
+
+    // Split the objects into independent plotting jobs and the objects
+    // needing the full draw_scene treatment.  Only one instance of each
+    // shared solid gets a job - the rest wait for its vlist, or use one
+    // that is already cached.
+    struct draw_plot_job *jobs = (struct draw_plot_job *)bu_calloc(cnt, sizeof(struct draw_plot_job), "draw jobs");
+    std::vector<struct bv_scene_obj *> sobjs;
+    std::vector<std::vector<struct bv_scene_obj *>> instances;
+    std::unordered_map<unsigned long long, size_t> key_jobs;
+    size_t jcnt = 0;
+    size_t shared = 0;
+    for (size_t i = 0; i < cnt; i++) {
+	struct draw_plot_job *j = &jobs[jcnt];
+	if (!draw_scene_plot_job(j, objs[i], v)) {
+	    sobjs.push_back(objs[i]);
+	    continue;
+	}
+	if (j->vlist_c) {
+	    struct bv_vlist_shared *sv = bv_vlist_cache_get(j->vlist_c, j->key);
+	    if (sv) {
+		draw_shared_attach(objs[i], sv, j->dp);
+		draw_scene_finalize(objs[i], v);
+		sd.p.done++;
+		shared++;
+		continue;
+	    }
+	    std::unordered_map<unsigned long long, size_t>::iterator k_it = key_jobs.find(j->key);
+	    if (k_it != key_jobs.end()) {
+		instances[k_it->second].push_back(objs[i]);
+		shared++;
+		continue;
+	    }
+	    key_jobs[j->key] = jcnt;
+	}
+	instances.push_back(std::vector<struct bv_scene_obj *>());
+	jcnt++;
+    }
+
+    std::vector<struct bv_scene_obj *> retry;
+    sd.jobs = jobs;
+    sd.instances = &instances;
+    sd.retry = &retry;
+    size_t jdone = draw_plot_parallel(jobs, jcnt, 0, &draw_scene_publish, (void *)&sd);
+    if (cancelled) {
+	for (size_t i = jdone; i < jcnt; i++) {
+	    bu_ptbl_ins(cancelled, (long *)jobs[i].s);
+	    for (size_t k = 0; k < instances[i].size(); k++)
+		bu_ptbl_ins(cancelled, (long *)instances[i][k]);
+	}
+    }
+    bu_free(jobs, "draw jobs");
+    sobjs.insert(sobjs.end(), retry.begin(), retry.end());
+
+    // Anything else goes through draw_scene one object at a time
+    size_t batch = DRAW_PLOT_BATCH_PER_CPU;
+    for (size_t i = 0; i < sobjs.size(); i++) {
+	if (sd.cancel) {
+	    if (cancelled)
+		bu_ptbl_ins(cancelled, (long *)sobjs[i]);
+	    continue;
+	}
+	draw_scene(sobjs[i], v);
+	sd.p.done++;
+	if (!((i + 1) % batch) || i == sobjs.size() - 1)
+	    draw_scene_progress(&sd);
+    }
+
+    if (cnt >= DRAW_TIMING_MIN_OBJS) {
+	fastf_t seconds = (fastf_t)(bu_gettime() - sd.start) / 1.0e6;
+	bu_log("draw: %zu of %zu objects (%zu plotted in parallel, %zu shared) in %g seconds%s\n",
+		sd.p.done, cnt, jdone, shared, seconds, (sd.cancel) ? " - cancelled" : "");
+    }
+
+    return sd.p.done;
+}
+
 static void
 tree_color(struct directory *dp, struct draw_data_t *dd)
 {
@@ -1033,6 +1702,7 @@ draw_gather_paths(struct db_full_path *path, mat_t *curr_mat, void *client_data)
 	ud->tol = dd->tol;
 	ud->ttol = dd->ttol;
 	ud->mesh_c = dd->mesh_c;
+	ud->vlist_c = dd->vlist_c;
 	ud->res = &rt_uniresource; // TODO - at some point this may be from the app or view.  dd->res is temporary, so we don't use it here
 	s->s_i_data = (void *)ud;
 	s->s_free_callback = &draw_free_data;
@@ -158,68 +158,42 @@ _ged_drawH_part2(int dashflag, struct bu_list *vhead, const struct db_full_path
     }
 }
 
-static fastf_t
-draw_solid_wireframe(struct bv_scene_obj *sp, struct bview *gvp, struct db_i *dbip,
-		     const struct bn_tol *tol, const struct bg_tess_tol *ttol)
-{
-    int ret;
-    struct bu_list vhead;
-    struct rt_db_internal dbintern;
-    struct rt_db_internal *ip = &dbintern;
-
-    BU_LIST_INIT(&vhead);
-    if (!sp->s_u_data)
-	return -1;
-    struct ged_bv_data *bdata = (struct ged_bv_data *)sp->s_u_data;
-
-    ret = rt_db_get_internal(ip, DB_FULL_PATH_CUR_DIR(&bdata->s_fullpath),
-			     dbip, sp->s_mat, &rt_uniresource);
-
-    if (ret < 0) {
-	return -1;
-    }
-
-    if (gvp && gvp->gv_s->adaptive_plot_csg && ip->idb_meth->ft_adaptive_plot) {
-	ret = ip->idb_meth->ft_adaptive_plot(&vhead, ip, tol, gvp, sp->s_size);
-    } else if (ip->idb_meth->ft_plot) {
-	ret = ip->idb_meth->ft_plot(&vhead, ip, ttol, tol, gvp);
-    }
-
-    rt_db_free_internal(ip);
+struct dl_redraw_data {
+    bu_clbk_t clbk;
+    void *clbk_data;
+    struct draw_progress p;
+    int64_t start;
+};
 
-    if (ret < 0) {
-	if (DB_FULL_PATH_CUR_DIR(&bdata->s_fullpath))
-	    bu_log("%s: plot failure\n", DB_FULL_PATH_CUR_DIR(&bdata->s_fullpath)->d_namep);
+static int
+dl_redraw_publish(struct draw_plot_job *jobs, size_t cnt, size_t done, size_t total, void *data)
+{
+    struct dl_redraw_data *rd = (struct dl_redraw_data *)data;
+    size_t i;
 
-	return -1;
+    for (i = 0; i < cnt; i++) {
+	if (jobs[i].ret < 0)
+	    bu_log("%s: plot failure\n", jobs[i].dp->d_namep);
     }
 
-    /* add plot to solid */
-    if (BU_LIST_IS_EMPTY(&(sp->s_vlist)))
-	sp->s_vlen = 0;
+    if (!rd->clbk)
+	return 0;
 
-    struct bv_vlist *bvv = (struct bv_vlist *)&vhead;
-    sp->s_vlen += bv_vlist_cmd_cnt(bvv);
-    BU_LIST_APPEND_LIST(&(sp->s_vlist), &(bvv->l));
-
-    return 0;
-}
-
-static int
-redraw_solid(struct bv_scene_obj *sp, struct db_i *dbip, struct db_tree_state *tsp, struct bview *gvp, struct bu_list *vlfree)
-{
-    if (sp->s_os->s_dmode == _GED_WIREFRAME) {
-	/* replot wireframe */
-	if (BU_LIST_NON_EMPTY(&sp->s_vlist)) {
-	    BV_FREE_VLIST(vlfree, &sp->s_vlist);
-	}
-	return draw_solid_wireframe(sp, gvp, dbip, tsp->ts_tol, tsp->ts_ttol);
-    }
-    return 0;
+    rd->p.done = done;
+    rd->p.total = total;
+    rd->p.elapsed = bu_gettime() - rd->start;
+    return (*rd->clbk)(0, NULL, (void *)&rd->p, rd->clbk_data);
 }
 
+/*
+ * Replot the wireframes in a display list, using up to ncpu threads (0 == all
+ * available).  If clbk is set it gets a struct draw_progress after each batch
+ * of solids, and may return non-zero to stop plotting - solids not reached are
+ * left in the display list without geometry, to be picked up by a later
+ * redraw.
+ */
 static int
-dl_redraw(struct display_list *gdlp, struct ged *gedp, int skip_subtractions)
+dl_redraw(struct display_list *gdlp, struct ged *gedp, int skip_subtractions, size_t ncpu, bu_clbk_t clbk, void *clbk_data)
 {
     struct db_i *dbip = gedp->dbip;
     struct rt_wdb *wdbp = wdb_dbopen(gedp->dbip, RT_WDB_TYPE_DB_DEFAULT);
@@ -228,11 +202,69 @@ dl_redraw(struct display_list *gdlp, struct ged *gedp, int skip_subtractions)
     int ret = 0;
     struct bv_scene_obj *sp;
     struct bu_list *vlfree = &rt_vlfree;
+    struct draw_plot_job *jobs = NULL;
+    struct dl_redraw_data rd;
+    size_t cnt = 0;
+    size_t jcnt = 0;
+    size_t done, i;
+
     for (BU_LIST_FOR(sp, bv_scene_obj, &gdlp->dl_head_scene_obj)) {
-	if (!skip_subtractions || (skip_subtractions && !sp->s_soldash)) {
-	    ret += redraw_solid(sp, dbip, tsp, gvp, vlfree);
+	if (skip_subtractions && sp->s_soldash)
+	    continue;
+	if (sp->s_os->s_dmode == _GED_WIREFRAME)
+	    cnt++;
+    }
+
+    if (cnt)
+	jobs = (struct draw_plot_job *)bu_calloc(cnt, sizeof(struct draw_plot_job), "dl_redraw jobs");
+
+    for (BU_LIST_FOR(sp, bv_scene_obj, &gdlp->dl_head_scene_obj)) {
+	struct ged_bv_data *bdata;
+	struct directory *dp;
+	if (skip_subtractions && sp->s_soldash)
+	    continue;
+	if (sp->s_os->s_dmode != _GED_WIREFRAME)
+	    continue;
+
+	/* replot wireframe */
+	if (BU_LIST_NON_EMPTY(&sp->s_vlist)) {
+	    BV_FREE_VLIST(vlfree, &sp->s_vlist);
 	}
+
+	bdata = (struct ged_bv_data *)sp->s_u_data;
+	dp = (bdata) ? DB_FULL_PATH_CUR_DIR(&bdata->s_fullpath) : RT_DIR_NULL;
+	if (!dp) {
+	    ret--;
+	    continue;
+	}
+
+	jobs[jcnt].s = sp;
+	jobs[jcnt].dp = dp;
+	jobs[jcnt].dbip = dbip;
+	jobs[jcnt].tol = tsp->ts_tol;
+	jobs[jcnt].ttol = tsp->ts_ttol;
+	jobs[jcnt].v = gvp;
+	jobs[jcnt].adaptive = (gvp && gvp->gv_s->adaptive_plot_csg) ? 1 : 0;
+	jcnt++;
     }
+
+    rd.clbk = clbk;
+    rd.clbk_data = clbk_data;
+    rd.p.done = 0;
+    rd.p.total = jcnt;
+    rd.p.elapsed = 0;
+    rd.start = bu_gettime();
+    done = draw_plot_parallel(jobs, jcnt, ncpu, &dl_redraw_publish, (void *)&rd);
+    for (i = 0; i < done; i++) {
+	if (jobs[i].ret < 0)
+	    ret--;
+    }
+    if (done < jcnt)
+	bu_log("%s: plotting cancelled after %zu of %zu solids\n", bu_vls_cstr(&gdlp->dl_path), done, jcnt);
+
+    if (jobs)
+	bu_free(jobs, "dl_redraw jobs");
+
     ged_create_vlist_display_list_cb(gedp, gdlp);
     return ret;
 }
@@ -951,6 +983,7 @@ _ged_drawtrees(struct ged *gedp, int argc, const char *argv[], int kind, struct
     int ret = 0;
     int c;
     int ncpu = 1;
+    size_t plot_ncpu = 0;
     int nmg_use_tnurbs = 0;
     int enable_fastpath = 0;
     struct model *nmg_model;
@@ -1044,6 +1077,7 @@ _ged_drawtrees(struct ged *gedp, int argc, const char *argv[], int kind, struct
 		    break;
 		case 'P':
 		    ncpu = atoi(bu_optarg);
+		    plot_ncpu = (ncpu > 0) ? (size_t)ncpu : 0;
 		    break;
 		case 'q':
 		    dgcdp.do_not_draw_nmg_solids_during_debugging = 1;
@@ -1250,6 +1284,8 @@ _ged_drawtrees(struct ged *gedp, int argc, const char *argv[], int kind, struct
 	    } else {
 		struct display_list **paths_to_draw;
 		struct display_list *gdlp;
+		bu_clbk_t clbk = NULL;
+		void *clbk_data = NULL;
 
 		paths_to_draw = (struct display_list **)
 		    bu_malloc(sizeof(struct display_list *) * argc,
@@ -1304,6 +1340,10 @@ _ged_drawtrees(struct ged *gedp, int argc, const char *argv[], int kind, struct
 		if (gedp && gedp->ged_gvp) gedp->ged_gvp->gv_s->bot_threshold = bot_threshold;
 
 		/* calculate plot vlists for solids of each draw path */
+		if (ged_clbk_get(&clbk, &clbk_data, gedp, "draw", BU_CLBK_DURING) != BRLCAD_OK) {
+		    clbk = NULL;
+		    clbk_data = NULL;
+		}
 		for (i = 0; i < argc; ++i) {
 		    gdlp = paths_to_draw[i];
 
@@ -1311,7 +1351,7 @@ _ged_drawtrees(struct ged *gedp, int argc, const char *argv[], int kind, struct
 			continue;
 		    }
 
-		    ret = dl_redraw(gdlp, gedp, dgcdp.vs.draw_non_subtract_only);
+		    ret = dl_redraw(gdlp, gedp, dgcdp.vs.draw_non_subtract_only, plot_ncpu, clbk, clbk_data);
 		    if (ret < 0) {
 			/* restore view bot threshold */
 			if (gedp && gedp->ged_gvp) gedp->ged_gvp->gv_s->bot_threshold = threshold_cached;
@@ -1650,6 +1690,8 @@ ged_redraw_core(struct ged *gedp, int argc, const char *argv[])
 
     int ret;
     struct display_list *gdlp;
+    bu_clbk_t clbk = NULL;
+    void *clbk_data = NULL;
 
     GED_CHECK_DATABASE_OPEN(gedp, BRLCAD_ERROR);
     GED_CHECK_DRAWABLE(gedp, BRLCAD_ERROR);
@@ -1658,11 +1700,16 @@ ged_redraw_core(struct ged *gedp, int argc, const char *argv[])
 
     bu_vls_trunc(gedp->ged_result_str, 0);
 
+    if (ged_clbk_get(&clbk, &clbk_data, gedp, argv[0], BU_CLBK_DURING) != BRLCAD_OK) {
+	clbk = NULL;
+	clbk_data = NULL;
+    }
+
     if (argc == 1) {
 	/* redraw everything */
 	for (BU_LIST_FOR(gdlp, display_list, gedp->i->ged_gdp->gd_headDisplay))
 	{
-	    ret = dl_redraw(gdlp, gedp, 0);
+	    ret = dl_redraw(gdlp, gedp, 0, 0, clbk, clbk_data);
 	    if (ret < 0) {
 		bu_vls_printf(gedp->ged_result_str, "%s: redraw failure\n", argv[0]);
 		return BRLCAD_ERROR;
@@ -1698,7 +1745,7 @@ ged_redraw_core(struct ged *gedp, int argc, const char *argv[])
 		    found_path = 1;
 		    db_free_full_path(&dl_path);
 
-		    ret = dl_redraw(gdlp, gedp, 0);
+		    ret = dl_redraw(gdlp, gedp, 0, 0, clbk, clbk_data);
 		    if (ret < 0) {
 			bu_vls_printf(gedp->ged_result_str,
 				"%s: %s redraw failure\n", argv[0], argv[i]);
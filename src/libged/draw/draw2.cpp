@@ -69,6 +69,15 @@ ged_draw2_core(struct ged *gedp, int argc, const char *argv[])
     GED_CHECK_DRAWABLE(gedp, BRLCAD_ERROR);
     GED_CHECK_VIEW(gedp, BRLCAD_ERROR);
 
+    /* Applications may want progress reports during large draws (and the
+     * chance to cancel them) - see struct draw_progress */
+    bu_clbk_t clbk = NULL;
+    void *clbk_data = NULL;
+    if (argc > 0 && ged_clbk_get(&clbk, &clbk_data, gedp, argv[0], BU_CLBK_DURING) != BRLCAD_OK) {
+	clbk = NULL;
+	clbk_data = NULL;
+    }
+
     /* skip command name argv[0] */
     argc-=(argc>0); argv+=(argc>0);
 
@@ -225,7 +234,7 @@ ged_draw2_core(struct ged *gedp, int argc, const char *argv[])
 	    bvs->add_path(argv[i]);
 	std::unordered_set<struct bview *> vset;
 	vset.insert(cv);
-	bvs->redraw(&vs, vset, !(blank_slate && !no_autoview));
+	bvs->redraw(&vs, vset, !(blank_slate && !no_autoview), clbk, clbk_data);
 	return BRLCAD_OK;
     }
 
@@ -248,7 +257,7 @@ ged_draw2_core(struct ged *gedp, int argc, const char *argv[])
     for (bv_it = vmap.begin(); bv_it != vmap.end(); bv_it++) {
 	for (size_t i = 0; i < (size_t)argc; ++i)
 	    bv_it->first->add_path(argv[i]);
-	bv_it->first->redraw(&vs, bv_it->second, !(blank_slate && !no_autoview));
+	bv_it->first->redraw(&vs, bv_it->second, !(blank_slate && !no_autoview), clbk, clbk_data);
     }
 
     return BRLCAD_OK;
@@ -34,6 +34,7 @@
 #include "bu/app.h"
 #include "bu/path.h"
 #include "bu/opt.h"
+#include "bu/parallel.h"
 #include "wdb.h"
 
 #include "../ged_private.h"
@@ -119,6 +120,7 @@ _ged_facetize_state_create()
 
     s->max_time = 0;
     s->max_pnts = 0;
+    s->jobs = 0;
 
     s->tol = NULL;
     s->nonovlp_threshold = 0;
@@ -259,7 +261,7 @@ ged_facetize_core(struct ged *gedp, int argc, const char *argv[])
     s->method_opts = method_options;
 
     /* General options */
-    struct bu_opt_desc d[20];
+    struct bu_opt_desc d[21];
     BU_OPT(d[ 0], "h", "help",                                      "",                  NULL,           &print_help, "Print help and exit");
     BU_OPT(d[ 1], "v", "verbose",                                   "",            &_ged_vopt,       &(s->verbosity), "Verbose output (multiple flags increase verbosity)");
     BU_OPT(d[ 2], "q", "quiet",                                     "",                  NULL,                &quiet, "Suppress all output (overrides verbose flag)");
@@ -279,7 +281,8 @@ ged_facetize_core(struct ged *gedp, int argc, const char *argv[])
     BU_OPT(d[16],  "", "disable-fixup",                             "",                  NULL,          &s->no_fixup, "Disable post-processing steps intended to improve generated meshes.");
     BU_OPT(d[17], "B", "",                                          "",                  NULL,      &s->nonovlp_brep, "EXPERIMENTAL: non-overlapping facetization to BoT objects of union-only brep comb tree.");
     BU_OPT(d[18], "t", "threshold",                                "#",       &bu_opt_fastf_t, &s->nonovlp_threshold, "EXPERIMENTAL: max ovlp threshold length for -B mode.");
-    BU_OPT_NULL(d[19]);
+    BU_OPT(d[19], "j", "jobs",                                     "#",           &bu_opt_int,            &(s->jobs), "Maximum number of tessellation subprocesses and Boolean evaluations to run concurrently.  Default is the number of available processors.");
+    BU_OPT_NULL(d[20]);
 
     GED_CHECK_DATABASE_OPEN(gedp, BRLCAD_ERROR);
     GED_CHECK_READ_ONLY(gedp, BRLCAD_ERROR);
@@ -315,6 +318,9 @@ ged_facetize_core(struct ged *gedp, int argc, const char *argv[])
 	}
     }
 
+    if (s->jobs < 1)
+	s->jobs = bu_avail_cpus();
+
     /* Sync -q and -v options */
     if (quiet)
 	s->verbosity = -1;
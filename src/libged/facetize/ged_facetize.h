@@ -64,6 +64,7 @@ struct _ged_facetize_state {
     // Settings
     int max_time;
     int max_pnts;
+    int jobs;
     struct bu_vls *prefix;
     struct bu_vls *suffix;
 
@@ -28,6 +28,7 @@
 #include "common.h"
 
 #include <algorithm>
+#include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -293,6 +294,108 @@ pnt_sampling_methods:
     return BRLCAD_ERROR;
 }
 
+// Tessellate one object and write out the result
+static int
+obj_tessellate(struct ged *gedp, struct directory *dp, tess_opts *s)
+{
+    // If this isn't a proper BRL-CAD object, tessellation is a no-op
+    if (dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
+	return BRLCAD_OK;
+
+    // Trigger the core tessellation routines
+    struct rt_bot_internal *obot = NULL;
+    struct bu_vls method_flag = BU_VLS_INIT_ZERO;
+    if (dp_tessellate(&obot, &method_flag, gedp, dp, s) != BRLCAD_OK) {
+	bu_vls_free(&method_flag);
+	return BRLCAD_ERROR;
+    }
+
+    // If we used a BRep CSG tree, we're already done
+    if (BU_STR_EQUAL(bu_vls_cstr(&method_flag), "NMG_BREP_CSG")) {
+	bu_vls_free(&method_flag);
+	return BRLCAD_OK;
+    }
+
+    // If we didn't get anything and we had an OK code, just keep going
+    if (!obot) {
+	bu_vls_free(&method_flag);
+	return BRLCAD_OK;
+    }
+
+    // If we've got something to write, handle it
+    struct bu_vls obot_name = BU_VLS_INIT_ZERO;
+    if (s->overwrite_obj) {
+	bu_vls_sprintf(&obot_name, "%s", dp->d_namep);
+    } else {
+	bu_vls_sprintf(&obot_name, "%s_tess.bot", dp->d_namep);
+    }
+    // NOTE: _tess_facetize_write_bot frees obot
+    int ret = _tess_facetize_write_bot(gedp->dbip, obot, bu_vls_cstr(&obot_name), bu_vls_cstr(&method_flag));
+    bu_vls_free(&method_flag);
+    bu_vls_free(&obot_name);
+    return ret;
+}
+
+// Persistent worker mode.  Rather than processing the objects on the command
+// line and exiting, keep the database open and read requests from stdin -
+// the per-request options (--methods, --method-opts) followed by object
+// names, one argument per line, with an empty line ending the request.  Each
+// object is announced on stdout before it is attempted and its failure, if
+// any, is reported after, so the parent can tell which object was in
+// progress if we crash or have to be killed.  A done marker ends each reply,
+// and is also sent once the database is open to signal we're ready.
+static int
+facetize_serve(struct ged *gedp, int overwrite_obj)
+{
+    fprintf(stdout, "%s\n", TESS_SERVE_DONE);
+    fflush(stdout);
+
+    std::vector<std::string> args;
+    std::string line;
+    while (std::getline(std::cin, line)) {
+	if (line.length() && line[line.length()-1] == '\r')
+	    line.erase(line.length()-1);
+	if (line.length()) {
+	    args.push_back(line);
+	    continue;
+	}
+	if (!args.size())
+	    continue;
+
+	tess_opts s;
+	s.overwrite_obj = overwrite_obj;
+	struct bu_opt_desc d[3];
+	BU_OPT(d[0], "",     "methods",               "m1 m2 ...", &_tess_active_methods, &s.method_opts, "List of active methods to use for this tessellation attempt");
+	BU_OPT(d[1], "", "method-opts", "M opt1=val opt2=val ...",    &_tess_method_opts, &s.method_opts, "Set options for method M.");
+	BU_OPT_NULL(d[2]);
+
+	std::vector<const char *> av;
+	for (size_t i = 0; i < args.size(); i++)
+	    av.push_back(args[i].c_str());
+	struct bu_vls omsg = BU_VLS_INIT_ZERO;
+	int ac = bu_opt_parse(&omsg, av.size(), av.data(), d);
+	if (ac < 0) {
+	    bu_log("Option parsing error: %s\n", bu_vls_cstr(&omsg));
+	    ac = 0;
+	}
+	bu_vls_free(&omsg);
+	method_setup(&s);
+
+	for (int i = 0; i < ac; i++) {
+	    fprintf(stdout, "%s\t%s\n", TESS_SERVE_START, av[i]);
+	    fflush(stdout);
+	    struct directory *dp = db_lookup(gedp->dbip, av[i], LOOKUP_NOISY);
+	    if (!dp || obj_tessellate(gedp, dp, &s) != BRLCAD_OK)
+		fprintf(stdout, "%s\t%s\n", TESS_SERVE_FAIL, av[i]);
+	}
+	fprintf(stdout, "%s\n", TESS_SERVE_DONE);
+	fflush(stdout);
+	args.clear();
+    }
+
+    return BRLCAD_OK;
+}
+
 void
 print_methods_info()
 {
@@ -326,16 +429,17 @@ facetize_process(int argc, const char **argv)
     // Done with prog name
     argc--; argv++;
 
-    static const char *usage = "Usage: ged_exec facetize_process [options] file.g input_obj [input_object_2 ...]\n";
+    static const char *usage = "Usage: ged_exec facetize_process [options] file.g input_obj [input_object_2 ...]\n       ged_exec facetize_process --serve [options] file.g\n";
     int print_help = 0;
     struct bu_vls cache_dir = BU_VLS_INIT_ZERO;
     tess_opts s;
 
     int list_methods = 0;
+    int serve = 0;
     int max_time = 0;
     int max_pnts = 0;
 
-    struct bu_opt_desc d[ 9];
+    struct bu_opt_desc d[10];
     BU_OPT(d[ 0],  "h",         "help",                         "",                  NULL,           &print_help, "Print help and exit");
     BU_OPT(d[ 1],   "", "list-methods",                         "",                  NULL,         &list_methods, "List available tessellation methods.  When used with -h, print an informational summary of each method.");
     BU_OPT(d[ 2],  "O",    "overwrite",                         "",                  NULL,    &(s.overwrite_obj), "Replace original object with BoT");
@@ -344,7 +448,8 @@ facetize_process(int argc, const char **argv)
     BU_OPT(d[ 5],   "",     "max-time",                        "#",           &bu_opt_int,             &max_time, "Maximum number of seconds to allow for runtime (not supported by all methods).");
     BU_OPT(d[ 6],   "",     "max-pnts",                        "#",           &bu_opt_int,             &max_pnts, "Maximum number of pnts to use when applying ray sampling methods.");
     BU_OPT(d[ 7],   "",     "cache-dir",                     "dir",           &bu_opt_vls,            &cache_dir, "Directory to use for cached outputs (default is libbu cache directory).");
-    BU_OPT_NULL(d[ 8]);
+    BU_OPT(d[ 8],   "",        "serve",                         "",                  NULL,                &serve, "Keep the database open and tessellate the objects named in requests read from stdin, until stdin is closed.");
+    BU_OPT_NULL(d[ 9]);
 
     /* parse options */
     struct bu_vls omsg = BU_VLS_INIT_ZERO;
@@ -400,6 +505,13 @@ facetize_process(int argc, const char **argv)
 	return BRLCAD_ERROR;
     }
 
+    if (serve) {
+	int ret = facetize_serve(gedp, s.overwrite_obj);
+	ged_close(gedp);
+	bu_vls_free(&cache_dir);
+	return ret;
+    }
+
     // Translate specified object names to directory pointers
     struct bu_ptbl dps = BU_PTBL_INIT_ZERO;
     for (int i = 1; i < argc; i++) {
@@ -415,48 +527,11 @@ facetize_process(int argc, const char **argv)
     // than parallel because of the risks of high memory consumption and/or
     // CPU utilization for individual object operations.
     for (size_t i = 0; i < BU_PTBL_LEN(&dps); i++) {
-
-	// If this isn't a proper BRL-CAD object, tessellation is a no-op
 	struct directory *dp = (struct directory *)BU_PTBL_GET(&dps, i);
-	if (dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
-	    continue;
-
-	// Trigger the core tessellation routines
-	struct rt_bot_internal *obot = NULL;
-	struct bu_vls method_flag = BU_VLS_INIT_ZERO;
-	if (dp_tessellate(&obot, &method_flag, gedp, dp, &s) != BRLCAD_OK) {
-	    bu_vls_free(&method_flag);
-	    return BRLCAD_ERROR;
-	}
-
-	// If we used a BRep CSG tree, we're already done
-	if (BU_STR_EQUAL(bu_vls_cstr(&method_flag), "NMG_BREP_CSG")) {
-	    bu_vls_free(&method_flag);
-	    continue;
-	}
-
-	// If we didn't get anything and we had an OK code, just keep going
-	if (!obot) {
-	    bu_vls_free(&method_flag);
-	    continue;
-	}
-
-	// If we've got something to write, handle it
-	struct bu_vls obot_name = BU_VLS_INIT_ZERO;
-	if (s.overwrite_obj) {
-	    bu_vls_sprintf(&obot_name, "%s", dp->d_namep);
-	} else {
-	    bu_vls_sprintf(&obot_name, "%s_tess.bot", dp->d_namep);
-	}
-	// NOTE: _tess_facetize_write_bot frees obot
-	int ret = _tess_facetize_write_bot(gedp->dbip, obot, bu_vls_cstr(&obot_name), bu_vls_cstr(&method_flag));
-	bu_vls_free(&method_flag);
-	bu_vls_free(&obot_name);
-	if (ret != BRLCAD_OK) {
+	if (obj_tessellate(gedp, dp, &s) != BRLCAD_OK) {
 	    bu_vls_free(&cache_dir);
 	    return BRLCAD_ERROR;
 	}
-
     }
 
     bu_vls_free(&cache_dir);
@@ -41,6 +41,12 @@
 #include "bg/spsr.h"
 #include "raytrace.h"
 
+// Markers the persistent tessellation workers (facetize_process --serve) use
+// to report back to the parent facetize command on stdout
+#define TESS_SERVE_START "@facetize_start"
+#define TESS_SERVE_FAIL "@facetize_fail"
+#define TESS_SERVE_DONE "@facetize_done"
+
 class method_options_t {
     public:
 
@@ -32,6 +32,10 @@
 #include <iostream>
 #include <fstream>
 #include <queue>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 
 #include <string.h>
 
@@ -41,6 +45,7 @@
 #endif
 
 #include "bu/app.h"
+#include "bu/parallel.h"
 #include "bu/path.h"
 #include "bu/snooze.h"
 #include "bu/time.h"
@@ -408,6 +413,223 @@ manifold_do_bool(
     return 0;
 }
 
+// Long running stages report how far along they are, at most every
+// FACETIZE_PROGRESS_INTERVAL seconds so short runs stay quiet.  Callers hold
+// whatever lock guards the counters.
+#define FACETIZE_PROGRESS_INTERVAL 10
+
+struct facetize_progress {
+    const char *what;
+    size_t total;
+    size_t done;
+    int64_t start;
+    int64_t last;
+};
+
+static void
+facetize_progress_init(struct facetize_progress *p, const char *what, size_t total)
+{
+    p->what = what;
+    p->total = total;
+    p->done = 0;
+    p->start = p->last = bu_gettime();
+}
+
+static void
+facetize_progress_step(struct _ged_facetize_state *s, struct facetize_progress *p)
+{
+    p->done++;
+    int64_t now = bu_gettime();
+    if (p->done < p->total && now - p->last < FACETIZE_PROGRESS_INTERVAL * 1000000)
+	return;
+    // Only close out the reporting if we started it
+    if (p->done == p->total && p->last == p->start)
+	return;
+    p->last = now;
+    fastf_t elapsed = (now - p->start) / 1000000.0;
+    fastf_t remaining = elapsed / p->done * (p->total - p->done);
+    facetize_log(s, 0, "%s: %zu of %zu done, %.0f seconds elapsed, about %.0f seconds remaining\n", p->what, p->done, p->total, elapsed, remaining);
+}
+
+// Union runs are built up one operand at a time - facetize_region_end
+// chains every region onto the previous ones, and combs with many members
+// come out of db_walk_tree the same way - which leaves a left-deep tree where
+// every Boolean has to wait on the one before it.  Regroup each maximal run of
+// unions into a balanced tree, reusing its nodes, so the independent pairs can
+// be evaluated concurrently.
+//
+// Half spaces in a union don't contribute anything manifold_do_bool can
+// represent - on the right it drops them, and on the left it fails the whole
+// subtree.  Regrouping could move one between the two, so drop the ones on
+// the right up front.  The run's leftmost operand stays leftmost after the
+// rebuild, so a half space there is left in place and still fails.
+static union tree *
+booltree_union_build(std::vector<union tree *> &ops, size_t lo, size_t hi, std::vector<union tree *> &nodes, size_t *ni)
+{
+    if (hi - lo == 1)
+	return ops[lo];
+    size_t mid = lo + (hi - lo)/2;
+    union tree *tp = nodes[(*ni)++];
+    tp->tr_b.tb_left = booltree_union_build(ops, lo, mid, nodes, ni);
+    tp->tr_b.tb_right = booltree_union_build(ops, mid, hi, nodes, ni);
+    return tp;
+}
+
+static void
+booltree_balance(union tree *root)
+{
+    std::vector<union tree *> todo;
+    todo.push_back(root);
+    while (!todo.empty()) {
+	union tree *tp = todo.back();
+	todo.pop_back();
+	switch (tp->tr_op) {
+	    case OP_UNION:
+		break;
+	    case OP_INTERSECT:
+	    case OP_SUBTRACT:
+		todo.push_back(tp->tr_b.tb_left);
+		todo.push_back(tp->tr_b.tb_right);
+		continue;
+	    default:
+		continue;
+	}
+
+	// Collect the operands of the run, in order.  The run's top node is
+	// nodes[0], and stays the top after the rebuild.
+	std::vector<union tree *> ops;
+	std::vector<union tree *> nodes;
+	std::vector<union tree *> run;
+	run.push_back(tp);
+	while (!run.empty()) {
+	    union tree *cp = run.back();
+	    run.pop_back();
+	    if (cp->tr_op == OP_UNION) {
+		nodes.push_back(cp);
+		run.push_back(cp->tr_b.tb_right);
+		run.push_back(cp->tr_b.tb_left);
+		continue;
+	    }
+	    if (cp->tr_op == OP_TESS && cp->tr_d.td_i && !ops.empty()) {
+		struct rt_db_internal *hip = cp->tr_d.td_i;
+		BU_PUT(hip->idb_ptr, struct rt_half_internal);
+		BU_PUT(hip, struct rt_db_internal);
+		cp->tr_d.td_i = NULL;
+		bu_free((char *)cp->tr_d.td_name, "half name");
+		cp->tr_d.td_name = NULL;
+		cp->tr_op = OP_NOP;
+	    }
+	    ops.push_back(cp);
+	}
+
+	size_t ni = 0;
+	(void)booltree_union_build(ops, 0, ops.size(), nodes, &ni);
+
+	for (size_t i = 0; i < ops.size(); i++) {
+	    if (ops[i]->tr_op == OP_INTERSECT || ops[i]->tr_op == OP_SUBTRACT)
+		todo.push_back(ops[i]);
+	}
+    }
+}
+
+// Evaluate the Boolean tree bottom up, with up to ncpu nodes in flight at
+// once.  A node is ready once both its children have been reduced to
+// leaves, and rt_booltree_evaluate then does just that one combine.  Each
+// combine only touches its own node and children, so the only shared state
+// is the ready queue.
+struct booltree_eval_state {
+    struct _ged_facetize_state *s;
+    struct bu_list *vlfree;
+    const struct bn_tol *tol;
+    std::mutex lock;
+    std::condition_variable cv;
+    std::queue<union tree *> ready;
+    std::unordered_map<union tree *, union tree *> parent;
+    std::unordered_map<union tree *, int> pending;
+    struct facetize_progress progress;
+};
+
+static void
+booltree_eval_worker(int UNUSED(cpu), void *data)
+{
+    struct booltree_eval_state *st = (struct booltree_eval_state *)data;
+
+    while (1) {
+	union tree *tp;
+	{
+	    std::unique_lock<std::mutex> lk(st->lock);
+	    st->cv.wait(lk, [st]{ return !st->ready.empty() || st->progress.done == st->progress.total; });
+	    if (st->ready.empty())
+		return;
+	    tp = st->ready.front();
+	    st->ready.pop();
+	}
+
+	// db_free_tree only checks the resource, so rt_uniresource is safe
+	// to share here
+	(void)rt_booltree_evaluate(tp, st->vlfree, st->tol, &rt_uniresource, &manifold_do_bool, 0, (void *)st->s);
+
+	{
+	    std::lock_guard<std::mutex> lk(st->lock);
+	    facetize_progress_step(st->s, &st->progress);
+	    std::unordered_map<union tree *, union tree *>::iterator p_it = st->parent.find(tp);
+	    if (p_it != st->parent.end() && --st->pending[p_it->second] == 0)
+		st->ready.push(p_it->second);
+	}
+	st->cv.notify_all();
+    }
+}
+
+static union tree *
+booltree_evaluate(struct _ged_facetize_state *s, union tree *root, struct bu_list *vlfree, const struct bn_tol *tol)
+{
+    if (!root)
+	return TREE_NULL;
+
+    booltree_balance(root);
+
+    struct booltree_eval_state st;
+    st.s = s;
+    st.vlfree = vlfree;
+    st.tol = tol;
+
+    size_t nops = 0;
+    std::vector<union tree *> todo;
+    todo.push_back(root);
+    while (!todo.empty()) {
+	union tree *tp = todo.back();
+	todo.pop_back();
+	if (tp->tr_op != OP_UNION && tp->tr_op != OP_INTERSECT && tp->tr_op != OP_SUBTRACT)
+	    continue;
+	nops++;
+	int cnt = 0;
+	union tree *children[2] = {tp->tr_b.tb_left, tp->tr_b.tb_right};
+	for (int i = 0; i < 2; i++) {
+	    union tree *cp = children[i];
+	    if (cp->tr_op == OP_UNION || cp->tr_op == OP_INTERSECT || cp->tr_op == OP_SUBTRACT) {
+		st.parent[cp] = tp;
+		todo.push_back(cp);
+		cnt++;
+	    }
+	}
+	st.pending[tp] = cnt;
+	if (!cnt)
+	    st.ready.push(tp);
+    }
+    facetize_progress_init(&st.progress, "Boolean evaluation", nops);
+
+    size_t ncpu = (s->jobs > 1) ? (size_t)s->jobs : 1;
+    if (ncpu > st.ready.size())
+	ncpu = st.ready.size();
+    if (ncpu > 1) {
+	bu_parallel(booltree_eval_worker, ncpu, &st);
+    } else {
+	booltree_eval_worker(0, &st);
+    }
+
+    return (root->tr_op == OP_TESS) ? root : TREE_NULL;
+}
+
 std::vector<std::string>
 tess_avail_methods()
 {
@@ -446,201 +668,364 @@ tess_avail_methods()
     return methods;
 }
 
-int
-tess_run(struct _ged_facetize_state *s, const char **tess_cmd, int tess_cmd_cnt, fastf_t max_time, int ocnt)
+class DpCompare
 {
-    if (!s || !tess_cmd || !tess_cmd[3])
-	return BRLCAD_ERROR;
-
-    std::string wfile(tess_cmd[3]);
-    std::string wfilebak = wfile + std::string(".bak");
-    {
-	// Before the run, prepare a backup file
-	std::ifstream workfile(wfile, std::ios::binary);
-	std::ofstream bakfile(wfilebak, std::ios::binary);
-	if (!workfile.is_open() || !bakfile.is_open()) {
-	    bu_log("Unable to create backup file %s\n", wfilebak.c_str());
-	    return BRLCAD_ERROR;
+    public:
+	bool operator()(struct directory *dp1, struct directory *dp2) {
+	    // C++ priority queues return the largest element, but
+	    // we want to start with the smaller elements - so we
+	    // invert the large/small reporting
+	    return (dp1->d_len > dp2->d_len);
 	}
-	bakfile << workfile.rdbuf();
-	workfile.close();
-	bakfile.close();
-    }
+};
 
-    // Record the actual command being use to trigger the subprocess
-    struct bu_vls cmd = BU_VLS_INIT_ZERO;
-    for (int i = 0; i < tess_cmd_cnt ; i++)
-	bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-    facetize_log(s, 2, "%s\n", bu_vls_cstr(&cmd));
-    bu_vls_free(&cmd);
+// Tessellation is done by a pool of persistent facetize_process workers
+// (running in --serve mode), rather than by launching a new subprocess for
+// each batch of objects - for small solids, process start-up and reopening
+// the .g file would otherwise dominate.  Each worker keeps its own private
+// copy of the working file open (the workers write their outputs into the .g
+// they are given, and they can't safely share one) and is fed one object at
+// a time over its stdin, which lets us attribute a crash or timeout to the
+// object responsible without having to bisect.  A worker that crashes or
+// has to be killed is replaced with a fresh one.  Completed outputs are
+// merged back into the shared working file periodically, and whatever a
+// lost worker hadn't merged yet is redone.
+#define TESS_MERGE_CNT 64
+
+struct tess_method {
+    std::string name;
+    int max_time;
+    std::string opts;
+};
 
-    // If we're not being verbose, just report how many objects we're working on
-    if (ocnt == 1)
-	facetize_log(s, 0, "Attempting to triangulate %s...", tess_cmd[tess_cmd_cnt-ocnt]);
-    if (ocnt > 1)
-	facetize_log(s, 0, "Attempting to triangulate %d solids...", ocnt);
+struct tess_item {
+    struct directory *dp;
+    const std::vector<struct tess_method> *methods;
+    size_t mind;
+    bool required;
+    bool counted;
+};
 
-    int64_t start = bu_gettime();
-    int64_t elapsed = 0;
-    fastf_t seconds = 0.0;
-    tess_cmd[tess_cmd_cnt] = NULL; // Make sure we're NULL terminated
+struct tess_pool {
+    struct _ged_facetize_state *s;
+    const char *tess_exec;
+    const char *lcache;
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<struct tess_item> items;
+    size_t inflight;
+    std::vector<std::string> failed;
+    bool required_failed;
+    struct facetize_progress progress;
+};
+
+struct tess_worker {
     struct subprocess_s p;
-    if (subprocess_create(tess_cmd, subprocess_option_no_window|subprocess_option_enable_async|subprocess_option_inherit_environment, &p)) {
-	// Unable to create subprocess??
-	facetize_log(s, 0, " FAILED.\n");
-	facetize_log(s, 0, "Unable to create subprocess\n");
+    bool running;
+    std::string wfile;
+    std::string obuf;
+};
 
-	return BRLCAD_ERROR;
-    }
-    while (subprocess_alive(&p)) {
-	std::this_thread::sleep_for(std::chrono::milliseconds(100));
-	elapsed = bu_gettime() - start;
-	seconds = elapsed / 1000000.0;
-
-	// Check for and pass along intermediate output
-	char curr_out[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stdout(&p, curr_out, MAXPATHLEN*10);
-	if (strlen(curr_out))
-	    facetize_log(s, 1, "%s", curr_out);
-	char curr_err[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stderr(&p, curr_err, MAXPATHLEN*10);
-	if (strlen(curr_err))
-	    facetize_log(s, 1, "%s", curr_err);
-
-	if (seconds > max_time) {
-	    // if we timeout, cleanup and return error
-	    subprocess_terminate(&p);
-
-	    facetize_log(s, 0, " FAILED.\n");
-
-	    facetize_log(s, 0, "tess_run subprocess killed %g %g\n", seconds, max_time);
-	    if (s->verbosity >= 0) {
-		char mraw[MAXPATHLEN*10] = {'\0'};
-		subprocess_read_stdout(&p, mraw, MAXPATHLEN*10);
-		if (strlen(mraw))
-		    facetize_log(s, 0, "%s\n", mraw);
-		char mraw2[MAXPATHLEN*10] = {'\0'};
-		subprocess_read_stderr(&p, mraw2, MAXPATHLEN*10);
-		if (strlen(mraw2))
-		    facetize_log(s, 0, "%s\n", mraw2);
+static bool
+tess_pool_next(struct tess_pool *tp, struct tess_item *item)
+{
+    std::unique_lock<std::mutex> lk(tp->lock);
+    tp->cv.wait(lk, [tp]{ return !tp->items.empty() || !tp->inflight; });
+    if (tp->items.empty())
+	return false;
+    *item = tp->items.front();
+    tp->items.pop_front();
+    tp->inflight++;
+    return true;
+}
+
+// Record the outcome of an attempt, queuing the next method if the current one
+// failed and there are others left to try
+static void
+tess_pool_finish(struct tess_pool *tp, struct tess_item *item, bool ok)
+{
+    {
+	std::lock_guard<std::mutex> lk(tp->lock);
+	if (!ok && item->mind + 1 < item->methods->size()) {
+	    item->mind++;
+	    tp->items.push_back(*item);
+	} else {
+	    if (!ok) {
+		facetize_log(tp->s, 0, "Unable to triangulate %s\n", item->dp->d_namep);
+		tp->failed.push_back(std::string(item->dp->d_namep));
+		if (item->required)
+		    tp->required_failed = true;
 	    }
-	    subprocess_destroy(&p);
-
-	    // Because we had to kill the process, there's no way of knowing
-	    // whether we interrupted I/O in a state that could result in a
-	    // corrupted .g file.  Restore the pre-run state of the .g file -
-	    // we may have to redo some work, but this at least ensures we
-	    // won't have strange garbage corrupting subsequent processing.
-	    std::ifstream bakfile(wfilebak, std::ios::binary);
-	    std::ofstream workfile(wfile, std::ios::binary);
-	    if (!workfile.is_open() || !bakfile.is_open())
-		return BRLCAD_ERROR;
-	    workfile << bakfile.rdbuf();
-	    workfile.close();
-	    bakfile.close();
+	    if (!item->counted)
+		facetize_progress_step(tp->s, &tp->progress);
+	    item->counted = true;
+	}
+	tp->inflight--;
+    }
+    tp->cv.notify_all();
+}
 
+static void
+tess_pool_requeue(struct tess_pool *tp, std::vector<struct tess_item> &items)
+{
+    {
+	std::lock_guard<std::mutex> lk(tp->lock);
+	for (size_t i = 0; i < items.size(); i++)
+	    tp->items.push_back(items[i]);
+    }
+    items.clear();
+    tp->cv.notify_all();
+}
 
-	    return BRLCAD_ERROR;
+// Pass along worker output, watching for the protocol markers.  Returns 1 once
+// the worker reports it is done with the current request.
+static int
+tess_worker_read(struct _ged_facetize_state *s, struct tess_worker *w, bool *failed)
+{
+    int done = 0;
+    char buf[MAXPATHLEN];
+    unsigned n;
+    while ((n = subprocess_read_stdout(&w->p, buf, MAXPATHLEN)) > 0)
+	w->obuf.append(buf, n);
+    size_t pos;
+    while ((pos = w->obuf.find('\n')) != std::string::npos) {
+	std::string line = w->obuf.substr(0, pos);
+	w->obuf.erase(0, pos + 1);
+	if (line.find(TESS_SERVE_DONE) != std::string::npos) {
+	    done = 1;
+	} else if (line.find(TESS_SERVE_FAIL) != std::string::npos) {
+	    if (failed)
+		*failed = true;
+	} else if (line.find(TESS_SERVE_START) == std::string::npos && line.length()) {
+	    facetize_log(s, 1, "%s\n", line.c_str());
 	}
     }
-    int w_rc;
-    if (subprocess_join(&p, &w_rc)) {
-	// Unable to join??
-	facetize_log(s, 0, " FAILED.\n");
-	facetize_log(s, 0, "tess_run subprocess unable to join\n");
-	if (s->verbosity >= 0) {
-	    char mraw[MAXPATHLEN*10] = {'\0'};
-	    subprocess_read_stdout(&p, mraw, MAXPATHLEN*10);
-	    if (strlen(mraw))
-		facetize_log(s, 0, "%s\n", mraw);
-	    char mraw2[MAXPATHLEN*10] = {'\0'};
-	    subprocess_read_stderr(&p, mraw2, MAXPATHLEN*10);
-	    if (strlen(mraw2))
-		facetize_log(s, 0, "%s\n", mraw2);
-	}
-	return BRLCAD_ERROR;
+    while ((n = subprocess_read_stderr(&w->p, buf, MAXPATHLEN - 1)) > 0) {
+	buf[n] = '\0';
+	facetize_log(s, 1, "%s", buf);
     }
+    return done;
+}
+
+static void
+tess_worker_stop(struct tess_worker *w, bool kill)
+{
+    if (!w->running)
+	return;
+    // Closing stdin tells a healthy worker to exit
+    if (kill && subprocess_alive(&w->p) > 0)
+	subprocess_terminate(&w->p);
+    subprocess_join(&w->p, NULL);
+    subprocess_destroy(&w->p);
+    w->running = false;
+    w->obuf.clear();
+}
 
-    bu_file_delete(wfilebak.c_str());
-
-    if (s->verbosity >= 0) {
-	char mraw[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stdout(&p, mraw, MAXPATHLEN*10);
-	if (strlen(mraw))
-	    facetize_log(s, 0, "%s\n", mraw);
-	char mraw2[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stderr(&p, mraw2, MAXPATHLEN*10);
-	if (strlen(mraw2))
-	    facetize_log(s, 0, "%s\n", mraw2);
+// Wait for the worker to finish the current request, returning 0 if it did,
+// 1 if it ran out of time, and -1 if it exited
+static int
+tess_worker_wait(struct _ged_facetize_state *s, struct tess_worker *w, fastf_t max_time, bool *failed)
+{
+    int64_t start = bu_gettime();
+    while (!tess_worker_read(s, w, failed)) {
+	if (subprocess_alive(&w->p) <= 0)
+	    return (tess_worker_read(s, w, failed)) ? 0 : -1;
+	if ((bu_gettime() - start) / 1000000.0 > max_time)
+	    return 1;
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+    return 0;
+}
 
-    // Needed to clean up file handles
-    subprocess_destroy(&p);
+static int
+tess_worker_start(struct tess_pool *tp, struct tess_worker *w)
+{
+    struct _ged_facetize_state *s = tp->s;
+
+    // Start from the current state of the shared working file
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    std::ifstream workfile(bu_vls_cstr(s->wfile), std::ios::binary);
+    std::ofstream jobfile(w->wfile, std::ios::binary);
+    bool copied = (workfile.is_open() && jobfile.is_open());
+    if (copied)
+	jobfile << workfile.rdbuf();
+    workfile.close();
+    jobfile.close();
+    bu_semaphore_release(RT_SEM_MODEL);
+    if (!copied) {
+	facetize_log(s, 0, "Unable to create worker file %s\n", w->wfile.c_str());
+	return BRLCAD_ERROR;
+    }
 
-    if (w_rc == BRLCAD_OK) {
-	facetize_log(s, 0, " Success.\n");
-    } else {
-	facetize_log(s, 0, " FAILED.\n");
+    const char *tess_cmd[8] = {NULL};
+    tess_cmd[0] = tp->tess_exec;
+    tess_cmd[1] = "facetize_process";
+    tess_cmd[2] = "--serve";
+    tess_cmd[3] = "-O";
+    tess_cmd[4] = "--cache-dir";
+    tess_cmd[5] = tp->lcache;
+    tess_cmd[6] = w->wfile.c_str();
+    tess_cmd[7] = NULL;
+    facetize_log(s, 2, "%s %s %s %s %s %s %s\n", tess_cmd[0], tess_cmd[1], tess_cmd[2], tess_cmd[3], tess_cmd[4], tess_cmd[5], tess_cmd[6]);
+
+    if (subprocess_create(tess_cmd, subprocess_option_no_window|subprocess_option_enable_async|subprocess_option_inherit_environment, &w->p)) {
+	facetize_log(s, 0, "Unable to create subprocess\n");
+	return BRLCAD_ERROR;
     }
+    w->running = true;
 
-    return (w_rc ? BRLCAD_ERROR : BRLCAD_OK);
+    // The worker checks in once it has the database open.  Don't send it
+    // anything before then - if it can't start, writing to it would fail.
+    if (tess_worker_wait(s, w, 60, NULL)) {
+	facetize_log(s, 0, "Tessellation worker failed to start\n");
+	tess_worker_stop(w, true);
+	return BRLCAD_ERROR;
+    }
+    return BRLCAD_OK;
 }
 
-int
-bisect_run(struct _ged_facetize_state *s, std::vector<struct directory *> &bad_dps, std::vector<struct directory *> &inputs, const char **orig_cmd, int cmd_cnt, fastf_t max_time, int ocnt);
-
-int
-bisect_failing_inputs(struct _ged_facetize_state *s, std::vector<struct directory *> &bad_dps, std::vector<struct directory *> &inputs, const char **orig_cmd, int cmd_cnt, fastf_t max_time)
+// Attempt the item's current method.  Returns 0 on success, 1 if the method
+// failed, and -1 if the worker was lost in the process.
+static int
+tess_worker_run(struct tess_pool *tp, struct tess_worker *w, struct tess_item *item)
 {
-    std::vector<struct directory *> left_inputs;
-    std::vector<struct directory *> right_inputs;
-    for (size_t i = 0; i < inputs.size()/2; i++)
-	left_inputs.push_back(inputs[i]);
-    for (size_t i =  inputs.size()/2; i < inputs.size(); i++)
-	right_inputs.push_back(inputs[i]);
-
-    int lret = bisect_run(s, bad_dps, left_inputs, orig_cmd, cmd_cnt, max_time, left_inputs.size());
-    int rret = bisect_run(s, bad_dps, right_inputs, orig_cmd, cmd_cnt, max_time, right_inputs.size());
-    return lret + rret;
+    struct _ged_facetize_state *s = tp->s;
+    const struct tess_method *m = &(*item->methods)[item->mind];
+
+    FILE *in = subprocess_stdin(&w->p);
+    if (!in || subprocess_alive(&w->p) <= 0)
+	return -1;
+    fprintf(in, "--methods\n%s\n--method-opts\n%s\n%s\n\n", m->name.c_str(), m->opts.c_str(), item->dp->d_namep);
+    fflush(in);
+    facetize_log(s, 1, "Attempting to triangulate %s (%s)\n", item->dp->d_namep, m->name.c_str());
+
+    bool failed = false;
+    int ret = tess_worker_wait(s, w, m->max_time, &failed);
+    if (ret > 0) {
+	facetize_log(s, 0, "%s: %s tessellation killed after %d seconds\n", item->dp->d_namep, m->name.c_str(), m->max_time);
+	return -1;
+    }
+    if (ret < 0) {
+	facetize_log(s, 0, "%s: tessellation worker exited during %s tessellation\n", item->dp->d_namep, m->name.c_str());
+	return -1;
+    }
+    if (failed)
+	facetize_log(s, 1, "%s: %s tessellation failed\n", item->dp->d_namep, m->name.c_str());
+    return (failed) ? 1 : 0;
 }
 
-int
-bisect_run(struct _ged_facetize_state *s, std::vector<struct directory *> &bad_dps, std::vector<struct directory *> &inputs, const char **orig_cmd, int cmd_cnt, fastf_t max_time, int ocnt)
+// Copy the outputs of completed items from a worker's private file into the
+// shared working file.  Besides the items themselves, anything the worker
+// created that the working file doesn't have yet (such as the members of
+// NMG_BREP_CSG combs) comes along.
+static int
+tess_worker_merge_files(struct _ged_facetize_state *s, struct tess_worker *w, std::vector<struct tess_item> &done)
 {
-    const char *tess_cmd[MAXPATHLEN] = {NULL};
-    // The initial part of the re-run is the same.
-    for (int i = 0; i < cmd_cnt; i++) {
-	tess_cmd[i] = orig_cmd[i];
-    }
-    for (size_t i = 0; i < inputs.size(); i++) {
-	tess_cmd[cmd_cnt+i] = inputs[i]->d_namep;
+
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    struct db_i *jdbip = db_open(w->wfile.c_str(), DB_OPEN_READWRITE);
+    struct db_i *wdbip = db_open(bu_vls_cstr(s->wfile), DB_OPEN_READWRITE);
+    if (!jdbip || !wdbip || db_dirbuild(jdbip) < 0 || db_dirbuild(wdbip) < 0) {
+	if (jdbip)
+	    db_close(jdbip);
+	if (wdbip)
+	    db_close(wdbip);
+	bu_semaphore_release(RT_SEM_MODEL);
+	return BRLCAD_ERROR;
     }
+    struct rt_wdb *wwdbp = wdb_dbopen(wdbip, RT_WDB_TYPE_DB_DISK);
+
+    std::set<std::string> names;
+    for (size_t i = 0; i < done.size(); i++)
+	names.insert(std::string(done[i].dp->d_namep));
 
-    int ret = tess_run(s, tess_cmd, cmd_cnt+inputs.size(), max_time, ocnt);
-    if (ret) {
-	if (inputs.size() > 1) {
-	    return bisect_failing_inputs(s, bad_dps, inputs, tess_cmd, cmd_cnt, max_time);
+    int ret = BRLCAD_OK;
+    struct directory *jdp;
+    FOR_ALL_DIRECTORY_START(jdp, jdbip) {
+	struct directory *wdp = db_lookup(wdbip, jdp->d_namep, LOOKUP_QUIET);
+	if (wdp && names.find(std::string(jdp->d_namep)) == names.end())
+	    continue;
+	struct bu_external ext = BU_EXTERNAL_INIT_ZERO;
+	if (db_get_external(&ext, jdp, jdbip) < 0) {
+	    ret = BRLCAD_ERROR;
+	    continue;
 	}
-	bad_dps.push_back(inputs[0]);
-	return 1;
-    }
-    return 0;
-}
+	// The object type usually changes, so replace rather than update
+	if (wdp) {
+	    db_delete(wdbip, wdp);
+	    db_dirdelete(wdbip, wdp);
+	}
+	int flags = (jdp->d_flags & RT_DIR_COMB) ? ((jdp->d_flags & RT_DIR_REGION) ? RT_DIR_COMB | RT_DIR_REGION : RT_DIR_COMB) : RT_DIR_SOLID;
+	if (wdb_export_external(wwdbp, &ext, jdp->d_namep, flags, jdp->d_minor_type) < 0)
+	    ret = BRLCAD_ERROR;
+	bu_free_external(&ext);
+    } FOR_ALL_DIRECTORY_END;
 
+    db_close(wdbip);
+    db_close(jdbip);
+    bu_semaphore_release(RT_SEM_MODEL);
+    return ret;
+}
 
+// If the outputs can't be merged the shared working file still has the
+// original primitives, which the Boolean evaluation would silently skip -
+// count the items as failures instead
+static void
+tess_worker_merge(struct tess_pool *tp, struct tess_worker *w, std::vector<struct tess_item> &done)
+{
+    if (!done.size())
+	return;
+    if (tess_worker_merge_files(tp->s, w, done) != BRLCAD_OK) {
+	std::lock_guard<std::mutex> lk(tp->lock);
+	facetize_log(tp->s, 0, "Unable to merge tessellation outputs from %s\n", w->wfile.c_str());
+	for (size_t i = 0; i < done.size(); i++) {
+	    tp->failed.push_back(std::string(done[i].dp->d_namep));
+	    if (done[i].required)
+		tp->required_failed = true;
+	}
+    }
+    done.clear();
+}
 
-class DpCompare
+static void
+tess_pool_worker(int cpu, void *data)
 {
-    public:
-	bool operator()(struct directory *dp1, struct directory *dp2) {
-	    // C++ priority queues return the largest element, but
-	    // we want to start with the smaller elements - so we
-	    // invert the large/small reporting
-	    return (dp1->d_len > dp2->d_len);
+    struct tess_pool *tp = (struct tess_pool *)data;
+    struct _ged_facetize_state *s = tp->s;
+    struct tess_worker w;
+    w.running = false;
+    w.wfile = std::string(bu_vls_cstr(s->wfile)) + std::string(".worker") + std::to_string(cpu);
+    std::vector<struct tess_item> unmerged;
+
+    struct tess_item item;
+    while (tess_pool_next(tp, &item)) {
+	if (!w.running && tess_worker_start(tp, &w) != BRLCAD_OK) {
+	    // Without a worker there's nothing more to try
+	    item.mind = item.methods->size() - 1;
+	    tess_pool_finish(tp, &item, false);
+	    continue;
+	}
+
+	int ret = tess_worker_run(tp, &w, &item);
+	if (ret < 0) {
+	    // Whatever the worker hadn't merged yet is suspect - start over
+	    // with a fresh worker and redo it
+	    tess_worker_stop(&w, true);
+	    tess_pool_requeue(tp, unmerged);
 	}
-};
 
-#define CMD_LEN_MAX 8000
+	tess_pool_finish(tp, &item, (ret == 0));
+	if (!ret)
+	    unmerged.push_back(item);
+
+	if (unmerged.size() >= TESS_MERGE_CNT)
+	    tess_worker_merge(tp, &w, unmerged);
+    }
+
+    tess_worker_merge(tp, &w, unmerged);
+    tess_worker_stop(&w, false);
+    bu_file_delete(w.wfile.c_str());
+}
 
 int
 _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struct bu_ptbl *leaf_dps)
@@ -707,7 +1092,6 @@ _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struc
 
     method_options_t *mo = (method_options_t*)s->method_opts;
     std::queue<std::string> method_flags;
-    std::queue<std::string> method_flags_bak;
     for (size_t i = 0; i < mo->methods.size(); i++) {
 	std::string cmethod = mo->methods[i];
 	if (std::find(avail_methods.begin(), avail_methods.end(), cmethod) != avail_methods.end()) {
@@ -729,205 +1113,72 @@ _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struc
 	}
     }
 
-    method_flags_bak = method_flags;
-
     // We want the subprocess to be using the same cache directory
     // as the parent
     char lcache[MAXPATHLEN] = {0};
     bu_dir(lcache, MAXPATHLEN, BU_DIR_CACHE, NULL);
 
 
-    // Call ged_exec to produce evaluated solids.
-    // First step is to build up the command to run
-    std::vector<std::string> failed_dps;
-    std::string mstrpp;
-    int l_max_time;
-    struct bu_vls method_str = BU_VLS_INIT_ZERO;
-    struct bu_vls method_opts_str = BU_VLS_INIT_ZERO;
-    const char *tess_cmd[MAXPATHLEN] = {NULL};
-    int method_ind = 5;
-    int method_opt_ind = 7;
-    tess_cmd[ 0] = tess_exec;
-    tess_cmd[ 1] = "facetize_process";
-    tess_cmd[ 2] = "-O";
-    tess_cmd[ 3] = bu_vls_cstr(s->wfile);
-    tess_cmd[ 4] = "--methods";
-    tess_cmd[ 5] = NULL;
-    tess_cmd[ 6] = "--method-opts";
-    tess_cmd[ 7] = NULL;
-    tess_cmd[ 8] = "--cache-dir";
-    tess_cmd[ 9] = lcache;
-    int cmd_fixed_cnt = 10;
-    while (!pq.empty()) {
-	int obj_cnt = 0;
-
-	// Starting a new round of object processing - reset method flags
-	method_flags = method_flags_bak;
-
-	// There are a number of methods that can be tried.  We try them in priority
-	// order, timing out if one of them goes too long.
-	mstrpp = method_flags.front();
+    // Each object gets the methods that suit it, in priority order
+    std::vector<struct tess_method> std_methods;
+    while (!method_flags.empty()) {
+	struct tess_method m;
+	m.name = method_flags.front();
+	m.max_time = mo->max_time[m.name];
+	m.opts = mo->method_optstr(m.name, dbip);
+	std_methods.push_back(m);
 	method_flags.pop();
-	bu_vls_sprintf(&method_str, "%s", mstrpp.c_str());
-	tess_cmd[method_ind] = bu_vls_cstr(&method_str);
-	// Each method has its own default (or possibly user set) time limit
-	l_max_time = mo->max_time[mstrpp];
-	// Get defined options for this particular method
-	bu_vls_sprintf(&method_opts_str, "%s", mo->method_optstr(mstrpp, dbip).c_str());
-	tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
-
-	std::vector<struct directory *> dps;
-	std::vector<struct directory *> bad_dps;
-	struct bu_vls cmd = BU_VLS_INIT_ZERO;
-	for (int i = 0; i < cmd_fixed_cnt; i++)
-	    bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-	while (bu_vls_strlen(&cmd) < CMD_LEN_MAX) {
-	    if (pq.empty() || cmd_fixed_cnt+dps.size() == MAXPATHLEN)
-		break;
-	    struct directory *ldp = pq.top();
-	    if ((bu_vls_strlen(&cmd) + strlen(ldp->d_namep)) > CMD_LEN_MAX) {
-		// This would be too long -  we've listed all we can
-		break;
-	    }
-	    obj_cnt++;
-	    pq.pop();
-	    dps.push_back(ldp);
-	    bu_vls_printf(&cmd, "%s ", ldp->d_namep);
-	}
-	bu_vls_free(&cmd);
-
-	// We have the list of objects to feed the process - now, trigger
-	// the runs with as many methods as it takes to facetize all the
-	// primitives
-	int err_cnt = 0;
-	while (bu_vls_strlen(&method_str)) {
-	    if (BU_STR_EQUAL(bu_vls_cstr(&method_str), "NMG")) {
-		err_cnt = bisect_run(s, bad_dps, dps, tess_cmd, cmd_fixed_cnt, l_max_time, obj_cnt);
-	    } else {
-		// If we're in fallback territory, process individually rather
-		// than doing the bisect - at least for now, those methods are
-		// much more expensive and likely to fail as compared to NMG.
-		for (size_t i = 0; i < dps.size(); i++) {
-		    tess_cmd[cmd_fixed_cnt] = dps[i]->d_namep;
-		    int tess_ret = tess_run(s, tess_cmd, cmd_fixed_cnt + 1, l_max_time, 1);
-		    if (tess_ret != BRLCAD_OK) {
-			bad_dps.push_back(dps[i]);
-			err_cnt++;
-		    }
-		}
-	    }
-
-	    // If we dealt successfully with everything, we're done
-	    if (!err_cnt)
-		break;
-
-	    if (method_flags.size()) {
-		// If we still have available methods to try, go another round
-		err_cnt = 0;
-		mstrpp = method_flags.front();
-		method_flags.pop();
-		bu_vls_sprintf(&method_str, "%s", mstrpp.c_str());
-		tess_cmd[method_ind] = bu_vls_cstr(&method_str);
-		// Each method has its own default (or possibly user set) time limit
-		l_max_time = mo->max_time[mstrpp];
-		// Get defined options for this particular method
-		bu_vls_sprintf(&method_opts_str, "\"%s\"", mo->method_optstr(mstrpp, dbip).c_str());
-		tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
-		dps = bad_dps;
-		bad_dps.clear();
-	    } else {
-		// All done - nothing left to try
-		bu_vls_trunc(&method_str, 0);
-		tess_cmd[method_ind] = NULL;
-	    }
-	}
-
-	if (err_cnt || bad_dps.size() > 0) {
-	    // If we tried all the active methods and still had failures, we have an
-	    // error.  We'll keep trying to process all the leaves, since we want to
-	    // get a full picture of what the issues with the conversion are, but
-	    // we need to record these as a full-on failure.
-	    for (size_t i = 0; i < bad_dps.size(); i++)
-		failed_dps.push_back(std::string(bad_dps[i]->d_namep));
-	}
     }
-
+    std::vector<struct tess_method> dsp_methods(1);
+    dsp_methods[0].name = std::string("CM");
+    dsp_methods[0].max_time = mo->max_time[dsp_methods[0].name];
+    dsp_methods[0].opts = mo->method_optstr(dsp_methods[0].name, dbip);
+    std::vector<struct tess_method> pbot_methods(1);
+    pbot_methods[0].name = std::string("NMG");
+    pbot_methods[0].max_time = mo->plate_max_time;
+    pbot_methods[0].opts = mo->method_optstr(pbot_methods[0].name, dbip);
+
+    struct tess_pool tp;
+    tp.s = s;
+    tp.tess_exec = tess_exec;
+    tp.lcache = lcache;
+    tp.inflight = 0;
+    tp.required_failed = false;
+    while (!pq.empty()) {
+	struct tess_item item = {pq.top(), &std_methods, 0, false, false};
+	tp.items.push_back(item);
+	pq.pop();
+    }
     while (!q_dsp.empty()) {
-	bu_vls_sprintf(&method_str, "CM");
-	tess_cmd[method_ind] = bu_vls_cstr(&method_str);
-	mstrpp = std::string("CM");
-	l_max_time = mo->max_time[mstrpp];
-	bu_vls_sprintf(&method_opts_str, "\"%s\"", mo->method_optstr(mstrpp, dbip).c_str());
-	tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
-	std::vector<struct directory *> dps;
-	struct bu_vls cmd = BU_VLS_INIT_ZERO;
-	for (int i = 0; i < cmd_fixed_cnt; i++)
-	    bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-	while (bu_vls_strlen(&cmd) < CMD_LEN_MAX) {
-	    if (q_dsp.empty() || cmd_fixed_cnt+dps.size() == MAXPATHLEN)
-		break;
-	    struct directory *ldp = q_dsp.front();
-	    if ((bu_vls_strlen(&cmd) + strlen(ldp->d_namep)) > CMD_LEN_MAX) {
-		// This would be too long -  we've listed all we can
-		break;
-	    }
-	    q_dsp.pop();
-	    dps.push_back(ldp);
-	    bu_vls_printf(&cmd, "%s ", ldp->d_namep);
-	}
-	bu_vls_free(&cmd);
-
-	// We have the list of objects to feed the process - now, trigger
-	// the runs with as many methods as it takes to facetize all the
-	// primitives
-	for (size_t i = 0; i < dps.size(); i++) {
-	    tess_cmd[cmd_fixed_cnt] = dps[i]->d_namep;
-	    int err_cnt = tess_run(s, tess_cmd, cmd_fixed_cnt + 1, l_max_time, 1);
-	    if (err_cnt)
-		failed_dps.push_back(std::string(dps[i]->d_namep));
-	}
+	struct tess_item item = {q_dsp.front(), &dsp_methods, 0, false, false};
+	tp.items.push_back(item);
+	q_dsp.pop();
     }
-
+    // If we can't handle the plate mode conversions, we can't do the boolean
+    // evaluation
     while (!q_pbot.empty()) {
-	bu_vls_sprintf(&method_str, "NMG");
-	tess_cmd[method_ind] = bu_vls_cstr(&method_str);
-	mstrpp = std::string("NMG");
-	l_max_time = mo->plate_max_time;
-	bu_vls_sprintf(&method_opts_str, "\"%s\"", mo->method_optstr(mstrpp, dbip).c_str());
-	tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
-
-
-	std::vector<struct directory *> dps;
-	std::vector<struct directory *> bad_dps;
-	struct bu_vls cmd = BU_VLS_INIT_ZERO;
-	for (int i = 0; i < cmd_fixed_cnt; i++)
-	    bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-	int obj_cnt = 0;
-	while (bu_vls_strlen(&cmd) < CMD_LEN_MAX) {
-	    if (q_pbot.empty() || cmd_fixed_cnt+dps.size() == MAXPATHLEN)
-		break;
-	    struct directory *ldp = q_pbot.top();
-	    if ((bu_vls_strlen(&cmd) + strlen(ldp->d_namep)) > CMD_LEN_MAX) {
-		// This would be too long -  we've listed all we can
-		break;
-	    }
-	    obj_cnt++;
-	    q_pbot.pop();
-	    dps.push_back(ldp);
-	    bu_vls_printf(&cmd, "%s ", ldp->d_namep);
-	}
-	bu_vls_free(&cmd);
-
+	struct tess_item item = {q_pbot.top(), &pbot_methods, 0, true, false};
+	tp.items.push_back(item);
+	q_pbot.pop();
+    }
+    facetize_progress_init(&tp.progress, "Tessellation", tp.items.size());
+
+    size_t ncpu = (s->jobs > 1) ? (size_t)s->jobs : 1;
+    if (ncpu > tp.items.size())
+	ncpu = tp.items.size();
+    facetize_log(s, 0, "Triangulating %zu solids with %zu worker process%s...\n", tp.items.size(), ncpu, (ncpu == 1) ? "" : "es");
+    if (ncpu > 1) {
+	bu_parallel(tess_pool_worker, ncpu, &tp);
+    } else {
+	tess_pool_worker(0, &tp);
+    }
 
-	int err_cnt = bisect_run(s, bad_dps, dps, tess_cmd, cmd_fixed_cnt, l_max_time * dps.size(), obj_cnt);
-	if (err_cnt) {
-	    // If we couldn't handle the plate mode conversion, we can't do the
-	    // boolean evaluation
-	    facetize_log(s, 0, "Plate mode conversion wasn't able to complete\n");
-	    return BRLCAD_ERROR;
-	}
+    if (tp.required_failed) {
+	facetize_log(s, 0, "Plate mode conversion wasn't able to complete\n");
+	return BRLCAD_ERROR;
     }
 
+    std::vector<std::string> failed_dps = tp.failed;
     if (failed_dps.size()) {
 	// As the parent process, we can know when we've run out of options
        // to try.  If we get there, flag the solid in the working copy so
@@ -1058,7 +1309,7 @@ _ged_facetize_booleval_tri(struct _ged_facetize_state *s, struct db_i *dbip, str
     }
 
     // Third stage is to execute the boolean operations
-    ftree = rt_booltree_evaluate(s->facetize_tree, vlfree, &wdbp->wdb_tol, &rt_uniresource, &manifold_do_bool, 0, (void *)s);
+    ftree = booltree_evaluate(s, s->facetize_tree, vlfree, &wdbp->wdb_tol);
     if (!ftree) {
 	return BRLCAD_ERROR;
     }
@@ -110,6 +110,7 @@ ged_init(struct ged *gedp)
     // View related containers
     bv_set_init(&gedp->ged_views);
     BU_PTBL_INIT(&gedp->ged_free_views);
+    gedp->ged_vlist_c = bv_vlist_cache_create();
 
     /* TODO: If we're init-ing the list here, does that mean the gedp has
      * ownership of all solid objects created and stored here, and should we
@@ -207,6 +208,9 @@ ged_free(struct ged *gedp)
     bu_ptbl_free(&gedp->ged_free_views);
     bv_set_free(&gedp->ged_views);
 
+    bv_vlist_cache_destroy(gedp->ged_vlist_c);
+    gedp->ged_vlist_c = NULL;
+
     if (gedp->i->ged_gdp != GED_DRAWABLE_NULL) {
 
 	for (size_t i = 0; i < BU_PTBL_LEN(&gedp->free_solids); i++) {
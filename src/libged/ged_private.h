@@ -212,6 +212,7 @@ struct draw_data_t {
     int bool_op;
     struct resource *res;
     struct bv_mesh_lod_context *mesh_c;
+    struct bv_vlist_cache *vlist_c;
 
     /* To avoid the need for multiple subtree walking
      * functions, we also set up to support a bounding
@@ -228,6 +229,43 @@ struct draw_data_t {
 
 GED_EXPORT void draw_gather_paths(struct db_full_path *path, mat_t *curr_mat, void *client_data);
 
+/* Parallel solid plotting (defined in draw.cpp).  Each job imports dp with
+ * s->s_mat applied and plots it, using ft_adaptive_plot if adaptive is set
+ * and the primitive supports it.  Finished vlists are appended to s->s_vlist
+ * on the calling thread.
+ *
+ * If vlist_c is set the job instead plots dp in its local coordinates, stores
+ * the result in vlist_c under key and gives s a reference to the shared vlist
+ * (see draw_shared_key.) */
+struct draw_plot_job {
+    struct bv_scene_obj *s;
+    struct directory *dp;
+    struct db_i *dbip;
+    const struct bn_tol *tol;
+    const struct bg_tess_tol *ttol;
+    struct bview *v;
+    int adaptive;
+    struct bv_vlist_cache *vlist_c;
+    unsigned long long key;
+    struct bv_vlist_shared *sv;
+    struct bu_list vhead;
+    int ret; /* < 0 on failure, 0 if plotted, 1 if the object has no plot method */
+};
+
+/* Called on the calling thread after each batch of jobs completes, with the
+ * jobs from that batch.  Returning non-zero cancels the remaining batches. */
+typedef int (*draw_plot_publish_t)(struct draw_plot_job *jobs, size_t cnt, size_t done, size_t total, void *data);
+
+/* Run cnt jobs using up to ncpu threads (0 == all available).  Returns the
+ * number of jobs completed, which is less than cnt if publish cancelled. */
+GED_EXPORT size_t draw_plot_parallel(struct draw_plot_job *jobs, size_t cnt, size_t ncpu, draw_plot_publish_t publish, void *data);
+
+/* Key identifying the shared vlist for solid dp drawn in mode dmode - a hash
+ * of the solid's on-disk data and the plotting parameters.  Returns 0 if dp
+ * can't be drawn from a shared vlist (for example, primitives whose geometry
+ * depends on other database objects or files.) */
+GED_EXPORT unsigned long long draw_shared_key(struct db_i *dbip, struct directory *dp, int dmode, const struct bn_tol *tol, const struct bg_tess_tol *ttol, struct bview *v);
+
 GED_EXPORT void vls_col_item(struct bu_vls *str, const char *cp);
 GED_EXPORT void vls_col_eol(struct bu_vls *str);
 
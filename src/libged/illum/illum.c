@@ -71,7 +71,12 @@ ged_labelvert_core(struct ged *gedp, int argc, const char *argv[])
 		    continue;
 		struct ged_bv_data *bdata = (struct ged_bv_data *)s->s_u_data;
 		if (db_full_path_search(&bdata->s_fullpath, dp)) {
-		    rt_label_vlist_verts(vbp, &s->s_vlist, mat, scale, gedp->dbip->dbi_base2local);
+		    /* label model coordinates, shared vlists included */
+		    struct bu_list vhead;
+		    BU_LIST_INIT(&vhead);
+		    bv_obj_vlist_copy(&vhead, s);
+		    rt_label_vlist_verts(vbp, &vhead, mat, scale, gedp->dbip->dbi_base2local);
+		    BV_FREE_VLIST(s->vlfree, &vhead);
 		}
 	    }
 
@@ -84,7 +84,16 @@ dl_plot(struct bu_list *hdlp, FILE *fp, mat_t model2view, int floating, mat_t ce
                         pl_linmod(fp, "solid");
                     Dashing = sp->s_soldash;
                 }
-                bv_vlist_to_uplot(fp, &(sp->s_vlist));
+                if (sp->s_type_flags & BV_SHARED_VLIST) {
+                    /* shared vlists are in local coordinates */
+                    struct bu_list vhead;
+                    BU_LIST_INIT(&vhead);
+                    bv_obj_vlist_copy(&vhead, sp);
+                    bv_vlist_to_uplot(fp, &vhead);
+                    BV_FREE_VLIST(sp->vlfree, &vhead);
+                } else {
+                    bv_vlist_to_uplot(fp, &(sp->s_vlist));
+                }
             }
 
             gdlp = next_gdlp;
@@ -130,7 +139,11 @@ dl_plot(struct bu_list *hdlp, FILE *fp, mat_t model2view, int floating, mat_t ce
                     pl_linmod(fp, "solid");
                 Dashing = sp->s_soldash;
             }
-            for (BU_LIST_FOR(vp, bv_vlist, &(sp->s_vlist))) {
+            /* shared vlists are in local coordinates */
+            mat_t omat, m2v;
+            struct bu_list *vhead = bv_obj_vlist(sp, omat);
+            bn_mat_mul(m2v, model2view, omat);
+            for (BU_LIST_FOR(vp, bv_vlist, vhead)) {
                 size_t i;
                 size_t nused = vp->nused;
                 int *cmd = vp->cmd;
@@ -146,7 +159,7 @@ dl_plot(struct bu_list *hdlp, FILE *fp, mat_t model2view, int floating, mat_t ce
                         case BV_VLIST_LINE_MOVE:
                         case BV_VLIST_TRI_MOVE:
                             /* Move, not draw */
-                            MAT4X3PNT(last, model2view, *pt);
+                            MAT4X3PNT(last, m2v, *pt);
                             continue;
                         case BV_VLIST_LINE_DRAW:
                         case BV_VLIST_POLY_DRAW:
@@ -154,7 +167,7 @@ dl_plot(struct bu_list *hdlp, FILE *fp, mat_t model2view, int floating, mat_t ce
                         case BV_VLIST_TRI_DRAW:
                         case BV_VLIST_TRI_END:
                             /* draw */
-                            MAT4X3PNT(fin, model2view, *pt);
+                            MAT4X3PNT(fin, m2v, *pt);
                             VMOVE(start, last);
                             VMOVE(last, fin);
                             break;
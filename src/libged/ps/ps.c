@@ -98,7 +98,8 @@ ps_draw_solid(fastf_t perspective, FILE *fp, struct bv_scene_obj *sp, matp_t psm
     point_t *pt_prev=NULL;
     fastf_t dist_prev=1.0;
     fastf_t dist;
-    struct bv_vlist *vp = (struct bv_vlist *)&sp->s_vlist;
+    mat_t omat, m2v;
+    struct bu_list *vhead = bv_obj_vlist(sp, omat);
     fastf_t delta;
 
     fprintf(fp, "%f %f %f setrgbcolor\n",
@@ -110,13 +111,17 @@ ps_draw_solid(fastf_t perspective, FILE *fp, struct bv_scene_obj *sp, matp_t psm
      * in front of eye plane (perspective mode only).
      * This value is a SWAG that seems to work OK.
      */
+    /* shared vlists are in local coordinates */
+    bn_mat_mul(m2v, psmat, omat);
+    psmat = m2v;
+
     delta = psmat[15]*0.0001;
     if (delta < 0.0)
         delta = -delta;
     if (delta < SQRT_SMALL_FASTF)
         delta = SQRT_SMALL_FASTF;
 
-    for (BU_LIST_FOR(tvp, bv_vlist, &vp->l)) {
+    for (BU_LIST_FOR(tvp, bv_vlist, vhead)) {
         size_t i;
         size_t nused = tvp->nused;
         int *cmd = tvp->cmd;
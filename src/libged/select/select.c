@@ -155,7 +155,12 @@ dl_select(struct bu_list *hdlp, mat_t model2view, struct bu_vls *vls, double vx,
 	    vmax[X] = vmax[Y] = vmax[Z] = -INFINITY;
 	    vmin[X] = vmin[Y] = vmin[Z] =  INFINITY;
 
-	    for (BU_LIST_FOR(vp, bv_vlist, &(sp->s_vlist))) {
+	    /* shared vlists are in local coordinates */
+	    mat_t omat, m2v;
+	    struct bu_list *vhead = bv_obj_vlist(sp, omat);
+	    bn_mat_mul(m2v, model2view, omat);
+
+	    for (BU_LIST_FOR(vp, bv_vlist, vhead)) {
 		size_t j;
 		size_t nused = vp->nused;
 		int *cmd = vp->cmd;
@@ -179,7 +184,7 @@ dl_select(struct bu_list *hdlp, mat_t model2view, struct bu_vls *vls, double vx,
 			case BV_VLIST_TRI_MOVE:
 			case BV_VLIST_TRI_DRAW:
 			case BV_VLIST_TRI_END:
-			    MAT4X3PNT(vpt, model2view, *pt);
+			    MAT4X3PNT(vpt, m2v, *pt);
 			    V_MIN(vmin[X], vpt[X]);
 			    V_MAX(vmax[X], vpt[X]);
 			    V_MIN(vmin[Y], vpt[Y]);
@@ -275,7 +280,12 @@ dl_select_partial(struct bu_list *hdlp, mat_t model2view, struct bu_vls *vls, do
 
 	    struct bv_vlist *vp;
 
-	    for (BU_LIST_FOR(vp, bv_vlist, &(sp->s_vlist))) {
+	    /* shared vlists are in local coordinates */
+	    mat_t omat, m2v;
+	    struct bu_list *vhead = bv_obj_vlist(sp, omat);
+	    bn_mat_mul(m2v, model2view, omat);
+
+	    for (BU_LIST_FOR(vp, bv_vlist, vhead)) {
 		size_t j;
 		size_t nused = vp->nused;
 		int *cmd = vp->cmd;
@@ -297,7 +307,7 @@ dl_select_partial(struct bu_list *hdlp, mat_t model2view, struct bu_vls *vls, do
 			case BV_VLIST_TRI_MOVE:
 			case BV_VLIST_TRI_DRAW:
 			case BV_VLIST_TRI_END:
-			    MAT4X3PNT(vpt, model2view, *pt);
+			    MAT4X3PNT(vpt, m2v, *pt);
 
 			    if (rflag) {
 				point_t vloc;
@@ -31,6 +31,7 @@
 
 #include "bu/cmd.h"
 #include "bu/hash.h"
+#include "bu/parallel.h"
 #include "bu/str.h"
 #include "bu/time.h"
 #include "bu/vls.h"
@@ -39,6 +40,14 @@
 #include "../ged_private.h"
 #include "./ged_view.h"
 
+static void
+lod_cache_release(void *data)
+{
+    struct rt_db_internal *ip = (struct rt_db_internal *)data;
+    rt_db_free_internal(ip);
+    BU_PUT(ip, struct rt_db_internal);
+}
+
 int
 _view_cmd_lod(void *bs, int argc, const char **argv)
 {
@@ -57,7 +66,9 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 	"view lod scale [factor]\n"
 	"view lod point_scale [factor]\n"
 	"view lod curve_scale [factor]\n"
-	"view lod bot_threshold [face_cnt]\n";
+	"view lod bot_threshold [face_cnt]\n"
+	"view lod budget [MB]\n"
+	"view lod stats\n";
 
     GED_CHECK_ARGC_GT_0(gedp, argc, BRLCAD_ERROR);
 
@@ -187,6 +198,7 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 	    // Clear any old cache in memory
 	    bv_mesh_lod_clear_cache(gedp->ged_lod, 0);
 
+	    size_t ncpus = (size_t)bu_avail_cpus();
 	    int done = 0;
 	    int total = 0;
 	    for (int i = 0; i < RT_DBNHASH; i++) {
@@ -211,27 +223,33 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 
 		    // No need to open up the internal unless it's a BoT or a BRep
 		    if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BOT) {
-			struct rt_db_internal dbintern;
-			RT_DB_INTERNAL_INIT(&dbintern);
-			struct rt_db_internal *ip = &dbintern;
+			// BoTs are cached by background jobs, one per processor.
+			// Don't get too far ahead of them loading meshes, or we
+			// end up with the whole database in memory.
+			bv_mesh_lod_cache_wait(gedp->ged_lod, ncpus);
+
+			struct rt_db_internal *ip;
+			BU_GET(ip, struct rt_db_internal);
+			RT_DB_INTERNAL_INIT(ip);
 			int ret = rt_db_get_internal(ip, dp, gedp->dbip, NULL, &rt_uniresource);
-			if (ret < 0)
+			if (ret < 0) {
+			    BU_PUT(ip, struct rt_db_internal);
 			    continue;
+			}
 
 			if (ip->idb_minor_type != DB5_MINORTYPE_BRLCAD_BOT) {
-			    rt_db_free_internal(&dbintern);
+			    rt_db_free_internal(ip);
+			    BU_PUT(ip, struct rt_db_internal);
 			    continue;
 			}
 			done++;
-			struct bu_vls pname = BU_VLS_INIT_ZERO;
 			bu_log("Caching BoT %s (%d of %d)\n", dp->d_namep, done, total);
-			bu_vls_free(&pname);
 			struct rt_bot_internal *bot = (struct rt_bot_internal *)ip->idb_ptr;
 			RT_BOT_CK_MAGIC(bot);
-			key = bv_mesh_lod_cache(gedp->ged_lod, (const point_t *)bot->vertices, bot->num_vertices, NULL, bot->faces, bot->num_faces, 0, 0.66);
-			if (key)
-			    bv_mesh_lod_key_put(gedp->ged_lod, dp->d_namep, key);
-			rt_db_free_internal(&dbintern);
+			if (bv_mesh_lod_cache_bg(gedp->ged_lod, dp->d_namep, (const point_t *)bot->vertices, bot->num_vertices, NULL, bot->faces, bot->num_faces, 0, 0.66, &lod_cache_release, (void *)ip)) {
+			    rt_db_free_internal(ip);
+			    BU_PUT(ip, struct rt_db_internal);
+			}
 		    }
 
 		    if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BREP) {
@@ -295,6 +313,9 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 		}
 	    }
 
+	    // Let any remaining BoT jobs finish
+	    bv_mesh_lod_cache_wait(gedp->ged_lod, 0);
+
 	    elapsedtime = bu_gettime() - elapsedtime;
 	    {
 		int seconds = elapsedtime / 1000000;
@@ -397,6 +418,32 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 
     }
 
+    if (BU_STR_EQUAL(argv[0], "budget")) {
+	struct bv_mesh_lod_stats st = {0, 0, 0, 0, 0, 0};
+	bv_mesh_lod_stats_get(gedp->ged_lod, &st);
+	if (argc == 1) {
+	    bu_vls_printf(gedp->ged_result_str, "%zu\n", st.budget / (1024*1024));
+	    return BRLCAD_OK;
+	}
+	int mb = 0;
+	if (bu_opt_int(NULL, 1, (const char **)&argv[1], (void *)&mb) != 1 || mb < 0) {
+	    bu_vls_printf(gedp->ged_result_str, "unknown argument to budget: %s\n", argv[1]);
+	    return BRLCAD_ERROR;
+	}
+	bv_mesh_lod_budget_set(gedp->ged_lod, (size_t)mb * 1024 * 1024);
+	return BRLCAD_OK;
+    }
+
+    if (BU_STR_EQUAL(argv[0], "stats")) {
+	struct bv_mesh_lod_stats st = {0, 0, 0, 0, 0, 0};
+	bv_mesh_lod_stats_get(gedp->ged_lod, &st);
+	bu_vls_printf(gedp->ged_result_str, "budget: %zu MB\n", st.budget / (1024*1024));
+	bu_vls_printf(gedp->ged_result_str, "resident: %zu bytes (peak %zu)\n", st.resident, st.peak);
+	bu_vls_printf(gedp->ged_result_str, "meshes: %zu (%zu with data loaded)\n", st.meshes, st.resident_meshes);
+	bu_vls_printf(gedp->ged_result_str, "evictions: %zu\n", st.evictions);
+	return BRLCAD_OK;
+    }
+
     bu_vls_printf(gedp->ged_result_str, "unknown subcommand: %s\n", argv[0]);
     return BRLCAD_ERROR;
 }
@@ -268,7 +268,9 @@ _objs_cmd_lcnt(void *bs, int argc, const char **argv)
 	bu_vls_printf(gedp->ged_result_str, "No view object named %s\n", gd->vobj);
 	return BRLCAD_ERROR;
     }
-    bu_vls_printf(gedp->ged_result_str, "%d\n", bu_list_len(&s->s_vlist));
+    mat_t omat;
+    struct bu_list *vhead = bv_obj_vlist(s, omat);
+    bu_vls_printf(gedp->ged_result_str, "%d\n", bu_list_len(vhead));
     return BRLCAD_OK;
 }
 
@@ -406,7 +408,7 @@ _view_cmd_objs(void *bs, int argc, const char **argv)
 	    if (db_objs) {
 		for (size_t i = 0; i < BU_PTBL_LEN(db_objs); i++) {
 		    struct bv_scene_group *cg = (struct bv_scene_group *)BU_PTBL_GET(db_objs, i);
-		    if (bu_list_len(&cg->s_vlist)) {
+		    if (bu_list_len(&cg->s_vlist) || (cg->s_type_flags & BV_SHARED_VLIST)) {
 			bu_vls_printf(gd->gedp->ged_result_str, "%s\n", bu_vls_cstr(&cg->s_name));
 		    } else {
 			for (size_t j = 0; j < BU_PTBL_LEN(&cg->children); j++) {
@@ -420,7 +422,7 @@ _view_cmd_objs(void *bs, int argc, const char **argv)
 	    if (local_db_objs) {
 		for (size_t i = 0; i < BU_PTBL_LEN(local_db_objs); i++) {
 		    struct bv_scene_group *cg = (struct bv_scene_group *)BU_PTBL_GET(local_db_objs, i);
-		    if (bu_list_len(&cg->s_vlist)) {
+		    if (bu_list_len(&cg->s_vlist) || (cg->s_type_flags & BV_SHARED_VLIST)) {
 			bu_vls_printf(gd->gedp->ged_result_str, "%s\n", bu_vls_cstr(&cg->s_name));
 		    } else {
 			for (size_t j = 0; j < BU_PTBL_LEN(&cg->children); j++) {
@@ -493,7 +495,7 @@ _view_cmd_objs(void *bs, int argc, const char **argv)
 	    struct bu_ptbl *db_objs = bv_view_objs(v, BV_DB_OBJS);
 	    for (size_t i = 0; i < BU_PTBL_LEN(db_objs); i++) {
 		struct bv_scene_group *cg = (struct bv_scene_group *)BU_PTBL_GET(db_objs, i);
-		if (bu_list_len(&cg->s_vlist)) {
+		if (bu_list_len(&cg->s_vlist) || (cg->s_type_flags & BV_SHARED_VLIST)) {
 		    if (BU_STR_EQUAL(gd->vobj, bu_vls_cstr(&cg->s_name))) {
 			gd->s = cg;
 			break;
@@ -513,7 +515,7 @@ _view_cmd_objs(void *bs, int argc, const char **argv)
 	    struct bu_ptbl *db_objs = bv_view_objs(v, BV_DB_OBJS | BV_LOCAL_OBJS);
 	    for (size_t i = 0; i < BU_PTBL_LEN(db_objs); i++) {
 		struct bv_scene_group *cg = (struct bv_scene_group *)BU_PTBL_GET(db_objs, i);
-		if (bu_list_len(&cg->s_vlist)) {
+		if (bu_list_len(&cg->s_vlist) || (cg->s_type_flags & BV_SHARED_VLIST)) {
 		    if (BU_STR_EQUAL(gd->vobj, bu_vls_cstr(&cg->s_name))) {
 			gd->s = cg;
 			break;
@@ -442,7 +442,7 @@ _view_cmd_vZ(void *bs, int argc, const char **argv)
 	    if (db_objs) {
 		for (size_t i = 0; i < BU_PTBL_LEN(db_objs); i++) {
 		    struct bv_scene_group *cg = (struct bv_scene_group *)BU_PTBL_GET(db_objs, i);
-		    if (bu_list_len(&cg->s_vlist)) {
+		    if (bu_list_len(&cg->s_vlist) || (cg->s_type_flags & BV_SHARED_VLIST)) {
 			fastf_t calc_val = bv_vZ_calc(cg, gd->cv, calc_mode);
 			if (calc_mode) {
 			    if (calc_val > vZ) {
@@ -477,7 +477,7 @@ _view_cmd_vZ(void *bs, int argc, const char **argv)
 	    if (local_db_objs) {
 		for (size_t i = 0; i < BU_PTBL_LEN(local_db_objs); i++) {
 		    struct bv_scene_group *cg = (struct bv_scene_group *)BU_PTBL_GET(local_db_objs, i);
-		    if (bu_list_len(&cg->s_vlist)) {
+		    if (bu_list_len(&cg->s_vlist) || (cg->s_type_flags & BV_SHARED_VLIST)) {
 			fastf_t calc_val = bv_vZ_calc(cg, gd->cv, calc_mode);
 			if (calc_mode) {
 			    if (calc_val > vZ) {
@@ -44,7 +44,7 @@
  * FMT:filename as being preferred, but will attempt to guess based on
  * extension as well.
  */
-static bu_mime_image_t
+bu_mime_image_t
 icv_guess_file_format(const char *filename, struct bu_vls *trimmedname)
 {
     // If we have no filename, there's nothing to go on
@@ -206,6 +206,10 @@ icv_writeline(icv_image_t *bif, size_t y, void *data, ICV_DATA type)
 		p++;
 		dst++;
 	}
+    } else if (type == ICV_DATA_HALF) {
+	uint16_t *h = (uint16_t *)data;
+	for (; width_size > 0; width_size--)
+	    *dst++ = icv_half2double(*h++);
     } else
 	memcpy(dst, data, width_size*sizeof(double));
 
@@ -26,6 +26,9 @@
 #ifndef ICV_PRIVATE_H
 #define ICV_PRIVATE_H
 
+/* defined in fileformat.c */
+extern bu_mime_image_t icv_guess_file_format(const char *filename, struct bu_vls *trimmedname);
+
 /* defined in bw.c */
 extern icv_image_t *bw_read(FILE *fp, size_t width, size_t height);
 extern int bw_write(icv_image_t *bif, FILE *fp);
@@ -42,6 +45,11 @@ extern int dpix_write(icv_image_t *bif, FILE *fp);
 extern icv_image_t* png_read(FILE *fp);
 extern int png_write(icv_image_t *bif, FILE *fp);
 
+/* Decode a PNG a row at a time, top row first, as 8-bit RGB */
+extern void *png_stream_open(FILE *fp, size_t *width, size_t *height);
+extern int png_stream_row(void *stream, unsigned char *row);
+extern void png_stream_close(void *stream);
+
 /* defined in ppm.c */
 extern icv_image_t* ppm_read(FILE *fp);
 extern int ppm_write(icv_image_t *bif, FILE *fp);
@@ -50,6 +58,31 @@ extern int ppm_write(icv_image_t *bif, FILE *fp);
 extern icv_image_t* rle_read(FILE *fp);
 extern int rle_write(icv_image_t *bif, FILE *fp);
 
+/* defined in tile.c */
+extern uint16_t icv_double2half(double d);
+extern double icv_half2double(uint16_t h);
+
+/* defined in parallel.c */
+
+/**
+ * Kernel run by icv_rows() on rows [y0, y1) of an image.  band is the
+ * index of the band, from 0 to one less than icv_rows_bands().
+ */
+typedef void (*icv_rows_func_t)(size_t band, size_t y0, size_t y1, void *data);
+
+/**
+ * Number of bands icv_rows() will split an image of the given height
+ * into, where values is the number of doubles the kernel touches.
+ * Callers that accumulate per band size their tables with this.
+ */
+extern size_t icv_rows_bands(size_t height, size_t values);
+
+/**
+ * Run func over the rows of an image, in parallel bands when the
+ * image is large enough to make that worthwhile.
+ */
+extern void icv_rows(size_t height, size_t values, icv_rows_func_t func, void *data);
+
 #endif /* ICV_PRIVATE_H */
 
 /*
@@ -35,6 +35,7 @@
 #include "bu/malloc.h"
 #include "bn/tol.h"
 #include "vmath.h"
+#include "icv_private.h"
 
 
 int icv_sanitize(icv_image_t* img)
@@ -303,6 +304,65 @@ int icv_saturate(icv_image_t* img, double sat)
     return 0;
 }
 
+/* One of the images compared by icv_diff, either as its doubles or,
+ * when gamma correction asks for dithering, as icv_data2uchar() bytes.
+ */
+struct diff_img {
+    const double *data;
+    unsigned char *uchar;
+};
+
+struct diff_info {
+    struct diff_img img[2];
+    int *counts;	/* matching, off by 1, off by many, per band */
+};
+
+
+static int
+diff_val(const struct diff_img *d, size_t i)
+{
+    long l;
+
+    if (d->uchar)
+	return d->uchar[i];
+
+    l = lrint(d->data[i]*255.0);
+    if (l > 255)
+	return 255;
+    if (l < 0)
+	return 0;
+    return (int)l;
+}
+
+
+static void
+diff_pixels(size_t band, size_t p0, size_t p1, void *data)
+{
+    struct diff_info *info = (struct diff_info *)data;
+    const struct diff_img *d1 = &info->img[0];
+    const struct diff_img *d2 = &info->img[1];
+    int matching = 0, off_by_1 = 0, off_by_many = 0;
+    size_t i, c;
+    int dcnt;
+
+    for (i = p0*3; i < p1*3; i += 3) {
+	dcnt = 0;
+	for (c = 0; c < 3; c++)
+	    dcnt += (diff_val(d1, i+c) != diff_val(d2, i+c)) ? 1 : 0;
+	if (dcnt == 0)
+	    matching++;
+	else if (dcnt == 1)
+	    off_by_1++;
+	else
+	    off_by_many++;
+    }
+
+    info->counts[band*3+0] = matching;
+    info->counts[band*3+1] = off_by_1;
+    info->counts[band*3+2] = off_by_many;
+}
+
+
 int
 icv_diff(
 	int *matching, int *off_by_1, int *off_by_many,
@@ -313,40 +373,33 @@ icv_diff(
 	return -1;
 
     int ret = 0;
-
-    // Have images
-    unsigned char *d1 = icv_data2uchar(img1);
-    unsigned char *d2 = icv_data2uchar(img2);
+    struct diff_info info;
     size_t s1 = img1->width * img1->height;
     size_t s2 = img2->width * img2->height;
     size_t smin = (s1 < s2) ? s1 : s2;
     size_t smax = (s1 > s2) ? s1 : s2;
-    for (size_t i = 0; i < smin; i++) {
-	int r1 = d1[i*3+0];
-	int g1 = d1[i*3+1];
-	int b1 = d1[i*3+2];
-	int r2 = d2[i*3+0];
-	int g2 = d2[i*3+1];
-	int b2 = d2[i*3+2];
-	int dcnt = 0;
-	dcnt += (r1 != r2) ? 1 : 0;
-	dcnt += (g1 != g2) ? 1 : 0;
-	dcnt += (b1 != b2) ? 1 : 0;
-	switch (dcnt) {
-	    case 0:
-		if (matching)
-		    (*matching)++;
-		break;
-	    case 1:
-		ret = 1;
-		if (off_by_1)
-		    (*off_by_1)++;
-		break;
-	    default:
-		ret = 1;
-		if (off_by_many)
-		    (*off_by_many)++;
-	}
+    size_t bands = icv_rows_bands(smin, smin*3);
+
+    /* Dithered gamma correction has to go through the one converter */
+    info.img[0].data = img1->data;
+    info.img[0].uchar = ZERO(img1->gamma_corr) ? NULL : icv_data2uchar(img1);
+    info.img[1].data = img2->data;
+    info.img[1].uchar = ZERO(img2->gamma_corr) ? NULL : icv_data2uchar(img2);
+    info.counts = (int *)bu_calloc(bands*3, sizeof(int), "icv_diff counts");
+
+    /* Pixels rather than rows are split into bands, the images may
+     * not have the same width */
+    icv_rows(smin, smin*3, diff_pixels, &info);
+
+    for (size_t b = 0; b < bands; b++) {
+	if (matching)
+	    (*matching) += info.counts[b*3+0];
+	if (off_by_1)
+	    (*off_by_1) += info.counts[b*3+1];
+	if (off_by_many)
+	    (*off_by_many) += info.counts[b*3+2];
+	if (info.counts[b*3+1] || info.counts[b*3+2])
+	    ret = 1;
     }
     if (smin != smax) {
 	ret = 1;
@@ -354,8 +407,11 @@ icv_diff(
 	    (*off_by_many) += (int)(smax - smin);
 	}
     }
-    bu_free(d1, "image 1 rgb");
-    bu_free(d2, "image 2 rgb");
+    bu_free(info.counts, "icv_diff counts");
+    if (info.img[0].uchar)
+	bu_free(info.img[0].uchar, "image 1 rgb");
+    if (info.img[1].uchar)
+	bu_free(info.img[1].uchar, "image 2 rgb");
 
     return ret;
 }
@@ -0,0 +1,102 @@
+/*                      P A R A L L E L . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file libicv/parallel.c
+ *
+ * Runs an image kernel over bands of rows, one band per CPU.  Every
+ * kernel writes only the rows of its own band, so no locking is
+ * needed.
+ *
+ */
+
+#include "common.h"
+
+#include "bu/parallel.h"
+#include "icv_private.h"
+
+/* Images with fewer values than this are not worth starting threads for */
+#define ICV_PARALLEL_MIN (256*1024)
+
+struct icv_rows_info {
+    size_t height;
+    size_t bands;
+    icv_rows_func_t func;
+    void *data;
+};
+
+
+static void
+icv_rows_band(int cpu, void *arg)
+{
+    struct icv_rows_info *info = (struct icv_rows_info *)arg;
+    size_t y0 = info->height * (size_t)cpu / info->bands;
+    size_t y1 = info->height * ((size_t)cpu + 1) / info->bands;
+
+    if (y1 > y0)
+	info->func((size_t)cpu, y0, y1, info->data);
+}
+
+
+size_t
+icv_rows_bands(size_t height, size_t values)
+{
+    size_t ncpu;
+
+    if (values < ICV_PARALLEL_MIN || height < 2)
+	return 1;
+
+    ncpu = bu_avail_cpus();
+    if (ncpu > height)
+	ncpu = height;
+    if (ncpu > MAX_PSW)
+	ncpu = MAX_PSW;
+
+    return (ncpu < 1) ? 1 : ncpu;
+}
+
+
+void
+icv_rows(size_t height, size_t values, icv_rows_func_t func, void *data)
+{
+    struct icv_rows_info info;
+
+    if (!height || !func)
+	return;
+
+    info.height = height;
+    info.bands = icv_rows_bands(height, values);
+    info.func = func;
+    info.data = data;
+
+    if (info.bands > 1)
+	bu_parallel(icv_rows_band, info.bands, &info);
+    else
+	func(0, 0, height, data);
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
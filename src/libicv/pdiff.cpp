@@ -40,6 +40,7 @@
 #include "bu/log.h"
 #include "bu/magic.h"
 #include "bu/malloc.h"
+#include "bu/parallel.h"
 #include "vmath.h"
 
 #if 0
@@ -59,51 +60,63 @@ load_icv(icv_image_t *img, imghash::Preprocess *prep)
     prep->start(img->height, img->width, 3);
     rows = img->height;
     cols = img->width;
+    std::vector<uint8_t> row(cols * 3);
     for (size_t i = 0; i < rows; i++) {
-	std::vector<uint8_t> row;
-	for (size_t j = 0; j < cols ; j++) {
-	    long l;
-	    int offset = ((rows - 1) * cols * 3) - (i * cols * 3);
-	    l = lrint(img->data[offset + j*3+0]*255.0);
-	    row.push_back((uint8_t)l);
-	    l = lrint(img->data[offset + j*3+1]*255.0);
-	    row.push_back((uint8_t)l);
-	    l = lrint(img->data[offset + j*3+2]*255.0);
-	    row.push_back((uint8_t)l);
-	    //std::cout << "rgb: " << (int)row[row.size()-3] << " " << (int)row[row.size()-2] << " " << (int)row[row.size()-1] << "\n";
+	// Rows are fed top down, icv images are stored bottom up
+	const double *in = img->data + (rows - 1 - i) * cols * 3;
+	for (size_t j = 0; j < cols * 3; j++) {
+	    long l = lrint(in[j]*255.0);
+	    row[j] = (uint8_t)l;
 	}
 	prep->add_row(row.data());
     }
 }
 
 
+struct pdiff_info {
+    icv_image_t *img[2];
+    imghash::Hasher::hash_type hash[2];
+};
+
+
+static void
+pdiff_hash(int cpu, void *data)
+{
+    struct pdiff_info *info = (struct pdiff_info *)data;
+    icv_image_t *img = info->img[cpu];
+    int dct_size = 4; // 1024 bits
+
+    imghash::DCTHasher hasher(8 * dct_size, true);
+    int d = (img->width < img->height) ? img->width : img->height;
+    imghash::Preprocess prep(d, d);
+    load_icv(img, &prep);
+    imghash::Image<float> pimg = prep.stop();
+
+    info->hash[cpu] = hasher.apply(pimg);
+}
+
+
 extern "C" uint32_t
 icv_pdiff(icv_image_t *img1, icv_image_t *img2)
 {
     if (!img1 || !img2)
 	return -1;
 
-    std::unique_ptr<imghash::Hasher> hasher;
-    int dct_size = 4; // 1024 bits
-    hasher = std::make_unique<imghash::DCTHasher>(8 * dct_size, true);
-
-    int d1 = (img1->width < img1->height) ? img1->width : img1->height;
-    imghash::Preprocess prep1(d1, d1);
-    load_icv(img1, &prep1);
-    imghash::Image<float> pimg1 = prep1.stop();
-
-    int d2 = (img2->width < img2->height) ? img2->width : img2->height;
-    imghash::Preprocess prep2(d2, d2);
-    load_icv(img2, &prep2);
-    imghash::Image<float> pimg2 = prep2.stop();
-
-    auto hash1 = hasher->apply(pimg1);
-    auto hash2 = hasher->apply(pimg2);
+    // The two images are hashed independently, one per thread
+    struct pdiff_info info;
+    info.img[0] = img1;
+    info.img[1] = img2;
+    if (bu_avail_cpus() > 1) {
+	bu_parallel(pdiff_hash, 2, &info);
+    } else {
+	pdiff_hash(0, &info);
+	pdiff_hash(1, &info);
+    }
 
-    //std::cout << "hash1:" << format_hash(hash1) << "\n";
-    //std::cout << "hash2:" << format_hash(hash2) << "\n";
+    //std::cout << "hash1:" << format_hash(info.hash[0]) << "\n";
+    //std::cout << "hash2:" << format_hash(info.hash[1]) << "\n";
 
-    return hasher->hamming_distance(hash1, hash2);
+    return imghash::Hasher::hamming_distance(info.hash[0], info.hash[1]);
 }
 
 /*
@@ -79,38 +79,41 @@ png_write(icv_image_t *bif, FILE *fp)
     return BRLCAD_OK;
 }
 
-icv_image_t *
-png_read(FILE *fp)
+/* Read the PNG header from fp and set up png_p to decode it as 8-bit
+ * RGB rows, which is what both png_read and the row streams hand out.
+ */
+static int
+png_read_setup(FILE *fp, png_structp *png_pp, png_infop *info_pp, size_t *width, size_t *height)
 {
-    if (UNLIKELY(!fp))
-	return NULL;
-
     char header[8];
     if (fread(header, 8, 1, fp) != 1) {
 	bu_log("png-pix: ERROR: Failed while reading file header!!!\n");
-	return NULL;
+	return -1;
     }
 
     if (png_sig_cmp((png_bytep)header, 0, 8)) {
 	bu_log("png-pix: This is not a PNG file!!!\n");
-	return NULL;
+	return -1;
     }
 
     png_structp png_p = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (!png_p) {
 	bu_log("png-pix: png_create_read_struct() failed!!\n");
-	return NULL;
+	return -1;
     }
 
     png_infop info_p = png_create_info_struct(png_p);
     if (!info_p) {
 	bu_log("png-pix: png_create_info_struct() failed!!\n");
-	return NULL;
+	png_destroy_read_struct(&png_p, NULL, NULL);
+	return -1;
     }
 
-    icv_image_t *bif;
-    BU_ALLOC(bif, struct icv_image);
-    ICV_IMAGE_INIT(bif);
+    if (setjmp(png_jmpbuf(png_p))) {
+	bu_log("png-pix: ERROR: Failed while reading PNG header\n");
+	png_destroy_read_struct(&png_p, &info_p, NULL);
+	return -1;
+    }
 
     png_init_io(png_p, fp);
     png_set_sig_bytes(png_p, 8);
@@ -123,8 +126,8 @@ png_read(FILE *fp)
     int bit_depth = png_get_bit_depth(png_p, info_p);
     if (bit_depth == 16) png_set_strip_16(png_p);
 
-    bif->width = png_get_image_width(png_p, info_p);
-    bif->height = png_get_image_height(png_p, info_p);
+    *width = png_get_image_width(png_p, info_p);
+    *height = png_get_image_height(png_p, info_p);
 
     png_color_16p input_backgrd;
     if (png_get_bKGD(png_p, info_p, &input_backgrd)) {
@@ -141,6 +144,29 @@ png_read(FILE *fp)
 
     png_read_update_info(png_p, info_p);
 
+    *png_pp = png_p;
+    *info_pp = info_p;
+    return 0;
+}
+
+
+icv_image_t *
+png_read(FILE *fp)
+{
+    if (UNLIKELY(!fp))
+	return NULL;
+
+    png_structp png_p;
+    png_infop info_p;
+    size_t width, height;
+    if (png_read_setup(fp, &png_p, &info_p, &width, &height) < 0)
+	return NULL;
+
+    icv_image_t *bif;
+    BU_ALLOC(bif, struct icv_image);
+    ICV_IMAGE_INIT(bif);
+    bif->width = width;
+    bif->height = height;
 
     /* allocate memory for image */
     unsigned char *image = (unsigned char *)bu_calloc(1, bif->width*bif->height*3, "image");
@@ -150,8 +176,19 @@ png_read(FILE *fp)
     for (size_t i = 0; i < bif->height; i++)
 	rows[bif->height - 1 - i] = image+(i * bif->width * 3);
 
+    /* png_read_setup()'s jump buffer went with its frame, so a data
+     * error has to land here */
+    if (setjmp(png_jmpbuf(png_p))) {
+	bu_log("png_read : ERROR: Failed while decoding image data\n");
+	png_destroy_read_struct(&png_p, &info_p, NULL);
+	bu_free(rows, "rows");
+	bu_free(image, "png_read : unsigned char data");
+	bu_free(bif, "icv container");
+	return NULL;
+    }
     png_read_image(png_p, rows);
-
+    png_destroy_read_struct(&png_p, &info_p, NULL);
+    bu_free(rows, "rows");
 
     bif->data = icv_uchar2double(image, 3 * bif->width * bif->height);
     bu_free(image, "png_read : unsigned char data");
@@ -163,6 +200,65 @@ png_read(FILE *fp)
 }
 
 
+struct png_stream {
+    png_structp png_p;
+    png_infop info_p;
+};
+
+
+void *
+png_stream_open(FILE *fp, size_t *width, size_t *height)
+{
+    struct png_stream *ps;
+    png_structp png_p;
+    png_infop info_p;
+
+    if (UNLIKELY(!fp))
+	return NULL;
+
+    if (png_read_setup(fp, &png_p, &info_p, width, height) < 0)
+	return NULL;
+
+    /* Interlaced passes can't be decoded a row at a time */
+    if (png_get_interlace_type(png_p, info_p) != PNG_INTERLACE_NONE) {
+	bu_log("png_stream_open : interlaced PNG images must be read whole\n");
+	png_destroy_read_struct(&png_p, &info_p, NULL);
+	return NULL;
+    }
+
+    BU_GET(ps, struct png_stream);
+    ps->png_p = png_p;
+    ps->info_p = info_p;
+    return ps;
+}
+
+
+int
+png_stream_row(void *stream, unsigned char *row)
+{
+    struct png_stream *ps = (struct png_stream *)stream;
+
+    if (setjmp(png_jmpbuf(ps->png_p))) {
+	bu_log("png_stream_row : ERROR: Failed while decoding row\n");
+	return -1;
+    }
+    png_read_row(ps->png_p, (png_bytep)row, NULL);
+    return 0;
+}
+
+
+void
+png_stream_close(void *stream)
+{
+    struct png_stream *ps = (struct png_stream *)stream;
+
+    if (!ps)
+	return;
+    png_destroy_read_struct(&ps->png_p, &ps->info_p, NULL);
+    BU_PUT(ps, struct png_stream);
+}
+
+
 /*
  * Local Variables:
  * mode: C
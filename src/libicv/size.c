@@ -38,6 +38,7 @@
 #include "bu/mime.h"
 #include "bu/str.h"
 #include "bu/units.h"
+#include "icv_private.h"
 
 
 struct xy_size {
@@ -366,15 +367,61 @@ under_sample(icv_image_t* bif, size_t factor)
 }
 
 
+struct interp_info {
+    const double *in;
+    double *out;
+    size_t in_width, in_height, out_width, channels;
+    double ystep;
+    const size_t *xoff;		/* offset of each output column's input pixel */
+    const double *xfrac;	/* and its distance to the next input pixel */
+};
+
+
+/* Column lookup tables shared by every row of an interpolation */
+static void
+interp_columns(struct interp_info *info, double xstep, size_t **xoff, double **xfrac)
+{
+    size_t i;
+    double x;
+
+    *xoff = (size_t *)bu_malloc(info->out_width*sizeof(size_t), "interp : xoff");
+    *xfrac = (double *)bu_malloc(info->out_width*sizeof(double), "interp : xfrac");
+    for (i = 0; i < info->out_width; i++) {
+	x = i*xstep;
+	(*xoff)[i] = (size_t)x*info->channels;
+	(*xfrac)[i] = x - (int)x;
+    }
+    info->xoff = *xoff;
+    info->xfrac = *xfrac;
+}
+
+
+static void
+ninterp_rows(size_t UNUSED(band), size_t y0, size_t y1, void *data)
+{
+    struct interp_info *info = (struct interp_info *)data;
+    size_t ch = info->channels;
+    size_t i, j;
+    const double *in_r;
+    double *out_p;
+
+    for (j = y0; j < y1; j++) {
+	in_r = info->in + (size_t)(j*info->ystep)*info->in_width*ch;
+	out_p = info->out + j*info->out_width*ch;
+	for (i = 0; i < info->out_width; i++, out_p += ch)
+	    VMOVEN(out_p, in_r + info->xoff[i], ch);
+    }
+}
+
+
 static int
 ninterp(icv_image_t* bif, size_t out_width, size_t out_height)
 {
+    struct interp_info info;
     double xstep, ystep;
-    size_t i, j;
-    size_t x, y;
-    size_t widthstep;
-    double *in_r, *in_c; /* Pointer to row and col of input buffers */
-    double *out_data, *out_p;
+    size_t *xoff;
+    double *xfrac;
+    double *out_data;
     xstep = (double)(bif->width-1) / (double)(out_width) - 1.0e-06;
     ystep = (double)(bif->height-1) / (double)(out_height) - 1.0e-06;
 
@@ -383,24 +430,21 @@ ninterp(icv_image_t* bif, size_t out_width, size_t out_height)
 	return -1;
     }
 
-    out_p = out_data = (double *)bu_malloc(out_width*out_height*bif->channels*sizeof(double), "ninterp : out_data");
-
-    widthstep= bif->width*bif->channels;
-
-    for (j = 0; j < out_height; j++) {
-	y = (int)(j*ystep);
-	in_r = bif->data + y*widthstep;
+    out_data = (double *)bu_malloc(out_width*out_height*bif->channels*sizeof(double), "ninterp : out_data");
 
-	for (i = 0; i < out_width; i++) {
-	    x = (int)(i*xstep);
+    info.in = bif->data;
+    info.out = out_data;
+    info.in_width = bif->width;
+    info.in_height = bif->height;
+    info.out_width = out_width;
+    info.channels = bif->channels;
+    info.ystep = ystep;
+    interp_columns(&info, xstep, &xoff, &xfrac);
 
-	    in_c = in_r + x*bif->channels;
-
-	    VMOVEN(out_p, in_c, bif->channels);
-	    out_p += bif->channels;
-	}
-    }
+    icv_rows(out_height, out_width*out_height*bif->channels, ninterp_rows, &info);
 
+    bu_free(xoff, "ninterp : xoff");
+    bu_free(xfrac, "ninterp : xfrac");
     bu_free(bif->data, "ninterp : in_data");
 
     bif->data = out_data;
@@ -413,17 +457,57 @@ ninterp(icv_image_t* bif, size_t out_width, size_t out_height)
 }
 
 
+/* Blend the two input rows around each output row first, which is a
+ * plain contiguous loop the compiler can vectorize, and then
+ * interpolate along the blended row with the column tables.
+ */
+static void
+binterp_rows(size_t UNUSED(band), size_t y0, size_t y1, void *data)
+{
+    struct interp_info *info = (struct interp_info *)data;
+    size_t ch = info->channels;
+    size_t widthstep = info->in_width*ch;
+    size_t i, j, c, n;
+    double y, dx, dy;
+    const double *low_r, *upp_r, *mid_c;
+    double *mid, *out_p;
+
+    n = info->xoff[info->out_width-1] + 2*ch;
+    if (n > widthstep)
+	n = widthstep;
+    mid = (double *)bu_malloc(widthstep*sizeof(double), "binterp : mid row");
+
+    for (j = y0; j < y1; j++) {
+	y = j*info->ystep;
+	dy = y - (int)y;
+
+	low_r = info->in + widthstep*(size_t)y;
+	upp_r = info->in + widthstep*(size_t)(y+1);
+
+	for (i = 0; i < n; i++)
+	    mid[i] = low_r[i] + dy * (upp_r[i] - low_r[i]);
+
+	out_p = info->out + j*info->out_width*ch;
+	for (i = 0; i < info->out_width; i++) {
+	    mid_c = mid + info->xoff[i];
+	    dx = info->xfrac[i];
+	    for (c = 0; c < ch; c++)
+		*out_p++ = mid_c[c] + dx * (mid_c[c+ch] - mid_c[c]);
+	}
+    }
+
+    bu_free(mid, "binterp : mid row");
+}
+
+
 static int
 binterp(icv_image_t *bif, size_t out_width, size_t out_height)
 {
-    size_t i, j;
-    size_t c;
-    double x, y, dx, dy, mid1, mid2;
+    struct interp_info info;
     double xstep, ystep;
-    double *out_data, *out_p;
-    double *upp_r, *low_r; /* upper and lower row */
-    double *upp_c, *low_c;
-    size_t widthstep;
+    size_t *xoff;
+    double *xfrac;
+    double *out_data;
 
     xstep = (double)(bif->width - 1) / (double)out_width - 1.0e-6;
     ystep = (double)(bif->height -1) / (double)out_height - 1.0e-6;
@@ -433,35 +517,21 @@ binterp(icv_image_t *bif, size_t out_width, size_t out_height)
 	return -1;
     }
 
-    out_p = out_data = (double *)bu_malloc(out_width*out_height*bif->channels*sizeof(double), "binterp : out data");
+    out_data = (double *)bu_malloc(out_width*out_height*bif->channels*sizeof(double), "binterp : out data");
 
-    widthstep = bif->width*bif->channels;
-
-    for (j = 0; j < out_height; j++) {
-	y = j*ystep;
-	dy = y - (int)y;
-
-	low_r = bif->data + widthstep* (int)y;
-	upp_r = bif->data + widthstep* (int)(y+1);
-
-	for (i = 0; i < out_width; i++) {
-	    x = i*xstep;
-	    dx = x - (int)x;
+    info.in = bif->data;
+    info.out = out_data;
+    info.in_width = bif->width;
+    info.in_height = bif->height;
+    info.out_width = out_width;
+    info.channels = bif->channels;
+    info.ystep = ystep;
+    interp_columns(&info, xstep, &xoff, &xfrac);
 
-	    upp_c = upp_r + (int)x*bif->channels;
-	    low_c = low_r + (int)x*bif->channels;
+    icv_rows(out_height, out_width*out_height*bif->channels, binterp_rows, &info);
 
-	    for (c = 0; c < bif->channels; c++) {
-		mid1 = low_c[0] + dx * ((double)low_c[bif->channels] - (double)low_c[0]);
-		mid2 = upp_c[0] + dx * ((double)upp_c[bif->channels] - (double)upp_c[0]);
-		*out_p = mid1 + dy * (mid2 - mid1);
-
-		out_p++;
-		upp_c++;
-		low_c++;
-	    }
-	}
-    }
+    bu_free(xoff, "binterp : xoff");
+    bu_free(xfrac, "binterp : xfrac");
     bu_free(bif->data, "binterp : Input Data");
     bif->data = out_data;
     bif->width = out_width;
@@ -0,0 +1,183 @@
+/*                        B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file icv_bench.c
+ *
+ * Times icv_filter, icv_resize, icv_diff and icv_pdiff on synthetic
+ * images, by default 8K (7680x4320) RGB.
+ *
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/getopt.h"
+#include "bu/parallel.h"
+#include "bu/time.h"
+#include "icv.h"
+
+static void
+usage(const char *argv0)
+{
+    bu_log("Usage: %s [-w width] [-n height] [-r repeats]\n", argv0);
+}
+
+
+/* Smooth gradients with a little noise, so the filters have
+ * something to do and no two pixels are quite alike.
+ */
+static icv_image_t *
+bench_image(size_t width, size_t height, unsigned int seed)
+{
+    icv_image_t *img = icv_create(width, height, ICV_COLOR_SPACE_RGB);
+    double *p = img->data;
+    size_t x, y;
+
+    srand(seed);
+    for (y = 0; y < height; y++) {
+	for (x = 0; x < width; x++) {
+	    double n = (double)rand() / RAND_MAX * 0.05;
+	    *p++ = (double)x / width * 0.95 + n;
+	    *p++ = (double)y / height * 0.95 + n;
+	    *p++ = (double)((x + y) % 256) / 255.0 * 0.95;
+	}
+    }
+    return img;
+}
+
+
+static icv_image_t *
+bench_copy(const icv_image_t *src)
+{
+    icv_image_t *img = icv_create(src->width, src->height, src->color_space);
+    memcpy(img->data, src->data, src->width*src->height*src->channels*sizeof(double));
+    return img;
+}
+
+
+static void
+bench_report(const char *name, int64_t start, int repeats)
+{
+    double elapsed = (double)(bu_gettime() - start) / 1000000.0;
+    bu_log("%-24s %10.3f s total %10.3f s each\n", name, elapsed, elapsed / repeats);
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t width = 7680, height = 4320;
+    int repeats = 1;
+    int c, r;
+    int matching, off_by_1, off_by_many;
+    int64_t start;
+    icv_image_t *img1, *img2, *work;
+
+    bu_setprogname(argv[0]);
+
+    while ((c = bu_getopt(argc, argv, "w:n:r:h?")) != -1) {
+	switch (c) {
+	    case 'w':
+		width = (size_t)atoi(bu_optarg);
+		break;
+	    case 'n':
+		height = (size_t)atoi(bu_optarg);
+		break;
+	    case 'r':
+		repeats = atoi(bu_optarg);
+		break;
+	    default:
+		usage(argv[0]);
+		return 1;
+	}
+    }
+    if (width < 4 || height < 4 || repeats < 1) {
+	usage(argv[0]);
+	return 1;
+    }
+
+    bu_log("%zux%zu RGB, %d repeat(s), %zu cpu(s)\n", width, height, repeats, bu_avail_cpus());
+
+    img1 = bench_image(width, height, 1);
+    img2 = bench_image(width, height, 2);
+
+    start = bu_gettime();
+    for (r = 0; r < repeats; r++) {
+	work = bench_copy(img1);
+	icv_filter(work, ICV_FILTER_LOW_PASS);
+	icv_destroy(work);
+    }
+    bench_report("icv_filter", start, repeats);
+
+    start = bu_gettime();
+    for (r = 0; r < repeats; r++) {
+	work = bench_copy(img1);
+	icv_resize(work, ICV_RESIZE_BINTERP, width/2, height/2, 1);
+	icv_destroy(work);
+    }
+    bench_report("icv_resize down (binterp)", start, repeats);
+
+    start = bu_gettime();
+    for (r = 0; r < repeats; r++) {
+	work = bench_copy(img1);
+	icv_resize(work, ICV_RESIZE_NINTERP, width/2, height/2, 1);
+	icv_destroy(work);
+    }
+    bench_report("icv_resize down (ninterp)", start, repeats);
+
+    start = bu_gettime();
+    for (r = 0; r < repeats; r++) {
+	work = icv_create(width/2, height/2, ICV_COLOR_SPACE_RGB);
+	icv_resize(work, ICV_RESIZE_BINTERP, width, height, 1);
+	icv_destroy(work);
+    }
+    bench_report("icv_resize up (binterp)", start, repeats);
+
+    start = bu_gettime();
+    for (r = 0; r < repeats; r++) {
+	matching = off_by_1 = off_by_many = 0;
+	icv_diff(&matching, &off_by_1, &off_by_many, img1, img2);
+    }
+    bench_report("icv_diff", start, repeats);
+    bu_log("  %d matching, %d off by 1, %d off by many\n", matching, off_by_1, off_by_many);
+
+    start = bu_gettime();
+    for (r = 0; r < repeats; r++)
+	icv_pdiff(img1, img2);
+    bench_report("icv_pdiff", start, repeats);
+
+    icv_destroy(img1);
+    icv_destroy(img2);
+
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
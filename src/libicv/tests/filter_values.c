@@ -0,0 +1,212 @@
+/*               F I L T E R _ V A L U E S . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file filter_values.c
+ *
+ * Checks the pixels icv_filter() writes.  Each filter is run on a 5x3
+ * gray image that is black but for its center pixel, so the output is
+ * the kernel turned half way around - that pins down where the kernel
+ * is anchored.  Each filter is then run on an RGB image big enough to
+ * be split into row bands, and compared against a plain convolution.
+ *
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "icv.h"
+
+#define IMPULSE_W 5
+#define IMPULSE_H 3
+
+struct filter_case {
+    const char *name;
+    ICV_FILTER filter;
+    double kern[9];
+    double offset;
+    double impulse[IMPULSE_W*IMPULSE_H];	/* output for the impulse image */
+};
+
+static const struct filter_case cases[] = {
+    { "low pass", ICV_FILTER_LOW_PASS,
+      { 3.0/42, 5.0/42, 3.0/42, 5.0/42, 10.0/42, 5.0/42, 3.0/42, 5.0/42, 3.0/42 }, 0,
+      { 0, 3.0/42, 5.0/42, 3.0/42, 0,
+	0, 5.0/42, 10.0/42, 5.0/42, 0,
+	0, 3.0/42, 5.0/42, 3.0/42, 0 } },
+    { "laplacian", ICV_FILTER_LAPLACIAN,
+      { -1.0/16, -1.0/16, -1.0/16, -1.0/16, 8.0/16, -1.0/16, -1.0/16, -1.0/16, -1.0/16 }, 0.5,
+      { 0, 0.5 - 1.0/16, 0.5 - 1.0/16, 0.5 - 1.0/16, 0,
+	0, 0.5 - 1.0/16, 0.5 + 8.0/16, 0.5 - 1.0/16, 0,
+	0, 0.5 - 1.0/16, 0.5 - 1.0/16, 0.5 - 1.0/16, 0 } },
+    { "horizontal gradient", ICV_FILTER_HORIZONTAL_GRAD,
+      { 1.0/6, 0, -1.0/6, 1.0/6, 0, -1.0/6, 1.0/6, 0, -1.0/6 }, 0.5,
+      { 0, 0.5 - 1.0/6, 0.5, 0.5 + 1.0/6, 0,
+	0, 0.5 - 1.0/6, 0.5, 0.5 + 1.0/6, 0,
+	0, 0.5 - 1.0/6, 0.5, 0.5 + 1.0/6, 0 } },
+    { "vertical gradient", ICV_FILTER_VERTICAL_GRAD,
+      { 1.0/6, 1.0/6, 1.0/6, 0, 0, 0, -1.0/6, -1.0/6, -1.0/6 }, 0.5,
+      { 0, 0.5 - 1.0/6, 0.5 - 1.0/6, 0.5 - 1.0/6, 0,
+	0, 0.5, 0.5, 0.5, 0,
+	0, 0.5 + 1.0/6, 0.5 + 1.0/6, 0.5 + 1.0/6, 0 } },
+    { "high pass", ICV_FILTER_HIGH_PASS,
+      { -1, -2, -1, -2, 13, -2, -1, -2, -1 }, 0,
+      { 0, -1, -2, -1, 0,
+	0, -2, 13, -2, 0,
+	0, -1, -2, -1, 0 } },
+    { "boxcar average", ICV_FILTER_BOXCAR_AVERAGE,
+      { 1.0/9, 1.0/9, 1.0/9, 1.0/9, 1.0/9, 1.0/9, 1.0/9, 1.0/9, 1.0/9 }, 0,
+      { 0, 1.0/9, 1.0/9, 1.0/9, 0,
+	0, 1.0/9, 1.0/9, 1.0/9, 0,
+	0, 1.0/9, 1.0/9, 1.0/9, 0 } },
+    { NULL, ICV_FILTER_NULL, { 0 }, 0, { 0 } }
+};
+
+
+/* Output of icv_filter() at x, y in channel c, done the slow way: the
+ * kernel is centered on the pixel, rows off the image are zero and the
+ * first and last column are passed through. */
+static double
+filter_ref(const struct filter_case *fc, const double *in, size_t w, size_t h, size_t ch, size_t x, size_t y, size_t c)
+{
+    double v = fc->offset;
+    size_t j, k;
+
+    if (x == 0 || x == w - 1)
+	return in[(y*w + x)*ch + c];
+
+    for (k = 0; k < 3; k++) {
+	if (y + k < 1 || y + k > h)
+	    continue;
+	for (j = 0; j < 3; j++)
+	    v += fc->kern[k*3 + j] * in[((y + k - 1)*w + x + j - 1)*ch + c];
+    }
+    return v;
+}
+
+
+static int
+check_impulse(const struct filter_case *fc)
+{
+    icv_image_t *img;
+    size_t i;
+    int fails = 0;
+
+    img = icv_create(IMPULSE_W, IMPULSE_H, ICV_COLOR_SPACE_GRAY);
+    img->data[IMPULSE_W + IMPULSE_W/2] = 1.0;
+
+    if (icv_filter(img, fc->filter) < 0) {
+	bu_log("%s: icv_filter failed\n", fc->name);
+	icv_destroy(img);
+	return 1;
+    }
+
+    for (i = 0; i < IMPULSE_W*IMPULSE_H; i++) {
+	if (fabs(img->data[i] - fc->impulse[i]) > 1.0e-12) {
+	    bu_log("%s: impulse pixel %zu,%zu is %g, expected %g\n", fc->name,
+		   i % IMPULSE_W, i / IMPULSE_W, img->data[i], fc->impulse[i]);
+	    fails++;
+	}
+    }
+
+    icv_destroy(img);
+    return fails;
+}
+
+
+static int
+check_bands(const struct filter_case *fc, size_t w, size_t h)
+{
+    icv_image_t *img;
+    double *in;
+    size_t size = w*h*3;
+    size_t i, x, y, c;
+    int fails = 0;
+
+    img = icv_create(w, h, ICV_COLOR_SPACE_RGB);
+    srand(1);
+    for (i = 0; i < size; i++)
+	img->data[i] = rand() / (double)RAND_MAX;
+    in = (double *)bu_malloc(size*sizeof(double), "filter input");
+    memcpy(in, img->data, size*sizeof(double));
+
+    if (icv_filter(img, fc->filter) < 0) {
+	bu_log("%s: icv_filter failed\n", fc->name);
+	bu_free(in, "filter input");
+	icv_destroy(img);
+	return 1;
+    }
+
+    for (y = 0; y < h; y++) {
+	for (x = 0; x < w; x++) {
+	    for (c = 0; c < 3; c++) {
+		double v = filter_ref(fc, in, w, h, 3, x, y, c);
+		if (fabs(img->data[(y*w + x)*3 + c] - v) > 1.0e-9) {
+		    if (fails < 10)
+			bu_log("%s: %zux%zu pixel %zu,%zu channel %zu is %g, expected %g\n", fc->name,
+			       w, h, x, y, c, img->data[(y*w + x)*3 + c], v);
+		    fails++;
+		}
+	    }
+	}
+    }
+
+    bu_free(in, "filter input");
+    icv_destroy(img);
+    return fails;
+}
+
+
+int
+main(int UNUSED(argc), char *argv[])
+{
+    const struct filter_case *fc;
+    int fails = 0;
+
+    bu_setprogname(argv[0]);
+
+    for (fc = cases; fc->name; fc++) {
+	int f = check_impulse(fc);
+
+	/* big enough for icv_filter() to split it into row bands */
+	f += check_bands(fc, 256, 131);
+
+	if (f)
+	    bu_log("%s: %d values differ\n", fc->name, f);
+	fails += f;
+    }
+
+    return (fails) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,117 @@
+/*                P N G _ T R U N C A T E D . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file png_truncated.c
+ *
+ * Checks that icv_read() fails cleanly on a PNG file that ends in the
+ * middle of its image data.  The header reads fine, so the error comes
+ * from libpng while the rows are being decoded.
+ *
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bio.h"
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "icv.h"
+
+int
+main(int UNUSED(argc), char *argv[])
+{
+    char png_file[MAXPATHLEN];
+    char cut_file[MAXPATHLEN];
+    icv_image_t *img;
+    unsigned char *buf;
+    FILE *fp;
+    long len;
+    size_t i;
+    int ret = 0;
+
+    bu_setprogname(argv[0]);
+
+    /* Noise, so the image data doesn't compress down to a few bytes */
+    img = icv_create(64, 64, ICV_COLOR_SPACE_RGB);
+    srand(1);
+    for (i = 0; i < 64*64*3; i++)
+	img->data[i] = (rand() % 256) / 255.0;
+
+    fp = bu_temp_file(png_file, MAXPATHLEN);
+    if (!fp)
+	bu_exit(1, "ERROR: unable to create a temporary file\n");
+    fclose(fp);
+    if (icv_write(img, png_file, BU_MIME_IMAGE_PNG) < 0)
+	bu_exit(1, "ERROR: unable to write %s\n", png_file);
+    icv_destroy(img);
+
+    /* The whole file has to read, or the truncated one proves nothing */
+    img = icv_read(png_file, BU_MIME_IMAGE_PNG, 0, 0);
+    if (!img || img->width != 64 || img->height != 64) {
+	bu_log("ERROR: unable to read back %s\n", png_file);
+	ret = 1;
+    }
+    if (img)
+	icv_destroy(img);
+
+    fp = fopen(png_file, "rb");
+    if (!fp)
+	bu_exit(1, "ERROR: unable to open %s\n", png_file);
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    rewind(fp);
+    buf = (unsigned char *)bu_malloc(len, "png file");
+    if (fread(buf, 1, len, fp) != (size_t)len)
+	bu_exit(1, "ERROR: unable to read %s\n", png_file);
+    fclose(fp);
+
+    fp = bu_temp_file(cut_file, MAXPATHLEN);
+    if (!fp)
+	bu_exit(1, "ERROR: unable to create a temporary file\n");
+    fwrite(buf, 1, len/2, fp);
+    fclose(fp);
+    bu_free(buf, "png file");
+
+    img = icv_read(cut_file, BU_MIME_IMAGE_PNG, 0, 0);
+    if (img) {
+	bu_log("ERROR: read an image from a PNG cut to %ld of %ld bytes\n", len/2, len);
+	icv_destroy(img);
+	ret = 1;
+    }
+
+    bu_file_delete(png_file);
+    bu_file_delete(cut_file);
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
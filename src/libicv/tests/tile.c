@@ -0,0 +1,146 @@
+/*                         T I L E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file icv_tile.c
+ *
+ * Tester for the icv_file region API: copies an image to a pix, bw or
+ * dpix file one tile at a time, passing the samples through the
+ * chosen region type, then compares the result with icv_read().
+ *
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/getopt.h"
+#include "bu/str.h"
+#include "icv.h"
+
+static void
+usage(const char *argv0)
+{
+    bu_log("Usage: %s [-w width] [-n height] [-t tile_size] [-u|-H|-D] in_file out_file\n", argv0);
+    bu_log("\t -u, -H, -D copy tiles as 8-bit, half float or double samples\n");
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    size_t width = 0, height = 0, channels, out_channels, tile = 256;
+    size_t x, y, w, h;
+    ICV_DATA type = ICV_DATA_UCHAR;
+    size_t sample_size = 1;
+    int c, matching = 0, off_by_1 = 0, off_by_many = 0;
+    icv_file_t *in, *out;
+    icv_image_t *img1, *img2;
+    void *buf;
+
+    bu_setprogname(argv[0]);
+
+    while ((c = bu_getopt(argc, argv, "w:n:t:uHDh?")) != -1) {
+	switch (c) {
+	    case 'w':
+		width = (size_t)atoi(bu_optarg);
+		break;
+	    case 'n':
+		height = (size_t)atoi(bu_optarg);
+		break;
+	    case 't':
+		tile = (size_t)atoi(bu_optarg);
+		break;
+	    case 'u':
+		type = ICV_DATA_UCHAR;
+		sample_size = 1;
+		break;
+	    case 'H':
+		type = ICV_DATA_HALF;
+		sample_size = sizeof(uint16_t);
+		break;
+	    case 'D':
+		type = ICV_DATA_DOUBLE;
+		sample_size = sizeof(double);
+		break;
+	    default:
+		usage(argv[0]);
+		return 1;
+	}
+    }
+    if (argc - bu_optind != 2 || tile < 1) {
+	usage(argv[0]);
+	return 1;
+    }
+
+    in = icv_file_open(argv[bu_optind], BU_MIME_IMAGE_AUTO, width, height);
+    if (!in)
+	bu_exit(1, "cannot open %s\n", argv[bu_optind]);
+    icv_file_size(in, &width, &height, &channels);
+
+    out = icv_file_create(argv[bu_optind+1], BU_MIME_IMAGE_AUTO, width, height);
+    if (!out)
+	bu_exit(1, "cannot create %s\n", argv[bu_optind+1]);
+    icv_file_size(out, NULL, NULL, &out_channels);
+    if (out_channels != channels)
+	bu_exit(1, "%s and %s have different channel counts\n", argv[bu_optind], argv[bu_optind+1]);
+
+    /* Top down, so that PNG input is decoded once */
+    buf = bu_malloc(tile*tile*channels*sample_size, "tile");
+    for (y = height; y > 0; y -= h) {
+	h = (y < tile) ? y : tile;
+	for (x = 0; x < width; x += w) {
+	    w = (width - x < tile) ? width - x : tile;
+	    if (icv_file_read_region(in, x, y - h, w, h, type, buf) < 0 ||
+		icv_file_write_region(out, x, y - h, w, h, type, buf) < 0)
+		bu_exit(1, "tile copy failed at %zu %zu\n", x, y - h);
+	}
+    }
+    bu_free(buf, "tile");
+    icv_file_close(in);
+    icv_file_close(out);
+
+    img1 = icv_read(argv[bu_optind], BU_MIME_IMAGE_AUTO, width, height);
+    img2 = icv_read(argv[bu_optind+1], BU_MIME_IMAGE_AUTO, width, height);
+    if (!img1 || !img2)
+	bu_exit(1, "cannot read the images back\n");
+    if (img1->channels != 3 || img2->channels != 3) {
+	/* icv_diff compares RGB pixels */
+	icv_gray2rgb(img1);
+	icv_gray2rgb(img2);
+    }
+    icv_diff(&matching, &off_by_1, &off_by_many, img1, img2);
+    icv_destroy(img1);
+    icv_destroy(img2);
+
+    bu_log("%d matching, %d off by 1, %d off by many\n", matching, off_by_1, off_by_many);
+    return (off_by_1 || off_by_many) ? 1 : 0;
+}
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,608 @@
+/*                          T I L E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file libicv/tile.c
+ *
+ * Region at a time reading and writing of image files, see
+ * icv/tile.h.  PIX, BW and DPIX files are fixed size arrays of
+ * samples, so they are read straight out of a mapping of the file and
+ * written with seeks.  PNG files are decoded in strips of rows.
+ *
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "bio.h"
+
+#include "bu/file.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/mapped_file.h"
+#include "bu/str.h"
+#include "bu/vls.h"
+#include "vmath.h"
+#include "icv_private.h"
+
+/* PNG rows decoded at a time */
+#define ICV_FILE_STRIP 64
+
+struct icv_file {
+    bu_mime_image_t format;
+    size_t width, height, channels;
+    size_t sample_size;		/* bytes per sample in the file */
+    struct bu_mapped_file *mf;	/* PIX, BW and DPIX reads */
+    FILE *fp;			/* PNG reads and all writes */
+    void *png;			/* PNG row stream */
+    unsigned char *strip;	/* decoded PNG rows */
+    size_t strip_top;		/* row of the file, counted from the top, in strip[0] */
+    size_t strip_rows;		/* rows in the strip */
+    int writable;
+};
+
+
+/* private functions */
+
+uint16_t
+icv_double2half(double d)
+{
+    union {
+	double d;
+	uint64_t u;
+    } v;
+    uint64_t mant, round, sticky;
+    uint16_t sign, half;
+    int e, shift;
+
+    v.d = d;
+    sign = (uint16_t)((v.u >> 48) & 0x8000);
+    e = (int)((v.u >> 52) & 0x7ff);
+    mant = v.u & ((((uint64_t)1) << 52) - 1);
+
+    /* infinity and NaN */
+    if (e == 0x7ff)
+	return sign | 0x7c00 | (mant ? 0x200 : 0);
+
+    e = e - 1023 + 15;
+    if (e >= 0x1f)
+	return sign | 0x7c00;
+
+    if (e <= 0) {
+	/* subnormal half, or too small for one */
+	if (e < -10)
+	    return sign;
+	mant |= ((uint64_t)1) << 52;
+	shift = 43 - e;
+	half = (uint16_t)(mant >> shift);
+	round = (mant >> (shift - 1)) & 1;
+	sticky = mant & ((((uint64_t)1) << (shift - 1)) - 1);
+	if (round && (sticky || (half & 1)))
+	    half++;
+	return sign | half;
+    }
+
+    /* round to nearest even, a carry out of the mantissa correctly
+     * bumps the exponent */
+    half = (uint16_t)(((uint16_t)e << 10) | (uint16_t)(mant >> 42));
+    round = mant & (((uint64_t)1) << 41);
+    sticky = mant & ((((uint64_t)1) << 41) - 1);
+    if (round && (sticky || (half & 1)))
+	half++;
+    return sign | half;
+}
+
+
+double
+icv_half2double(uint16_t h)
+{
+    int e = (h >> 10) & 0x1f;
+    int mant = h & 0x3ff;
+    double v;
+
+    if (e == 0)
+	v = ldexp((double)mant, -24);
+    else if (e == 0x1f)
+	v = mant ? NAN : INFINITY;
+    else
+	v = ldexp((double)(mant | 0x400), e - 25);
+
+    return (h & 0x8000) ? -v : v;
+}
+
+
+static unsigned char
+sample2uchar(double d)
+{
+    long l = lrint(d*255.0);
+
+    if (l > 255)
+	return 255;
+    if (l < 0)
+	return 0;
+    return (unsigned char)l;
+}
+
+
+/* Convert n samples, 8-bit when src_double is zero, to the given type */
+static void
+convert_from(const void *src, int src_double, ICV_DATA type, void *dst, size_t n)
+{
+    const unsigned char *uc = (const unsigned char *)src;
+    const double *dp = (const double *)src;
+    size_t i;
+
+    switch (type) {
+	case ICV_DATA_UCHAR:
+	    if (src_double) {
+		for (i = 0; i < n; i++)
+		    ((unsigned char *)dst)[i] = sample2uchar(dp[i]);
+	    } else {
+		memcpy(dst, src, n);
+	    }
+	    break;
+	case ICV_DATA_HALF:
+	    for (i = 0; i < n; i++)
+		((uint16_t *)dst)[i] = icv_double2half(src_double ? dp[i] : ICV_CONV_8BIT(uc[i]));
+	    break;
+	default:
+	    if (src_double) {
+		memcpy(dst, src, n*sizeof(double));
+	    } else {
+		for (i = 0; i < n; i++)
+		    ((double *)dst)[i] = ICV_CONV_8BIT(uc[i]);
+	    }
+    }
+}
+
+
+/* Convert n samples of the given type to 8-bit, or to double when
+ * dst_double is set */
+static void
+convert_to(const void *src, ICV_DATA type, void *dst, int dst_double, size_t n)
+{
+    size_t i;
+    double d;
+
+    if (type == ICV_DATA_UCHAR && !dst_double) {
+	memcpy(dst, src, n);
+	return;
+    }
+    if (type == ICV_DATA_DOUBLE && dst_double) {
+	memcpy(dst, src, n*sizeof(double));
+	return;
+    }
+
+    for (i = 0; i < n; i++) {
+	switch (type) {
+	    case ICV_DATA_UCHAR:
+		d = ICV_CONV_8BIT(((const unsigned char *)src)[i]);
+		break;
+	    case ICV_DATA_HALF:
+		d = icv_half2double(((const uint16_t *)src)[i]);
+		break;
+	    default:
+		d = ((const double *)src)[i];
+	}
+	if (dst_double)
+	    ((double *)dst)[i] = d;
+	else
+	    ((unsigned char *)dst)[i] = sample2uchar(d);
+    }
+}
+
+
+static size_t
+data_size(ICV_DATA type)
+{
+    switch (type) {
+	case ICV_DATA_UCHAR:
+	    return 1;
+	case ICV_DATA_HALF:
+	    return sizeof(uint16_t);
+	default:
+	    return sizeof(double);
+    }
+}
+
+
+/* Channels and sample size of the fixed layout formats */
+static int
+file_layout(bu_mime_image_t format, size_t *channels, size_t *sample_size)
+{
+    switch (format) {
+	case BU_MIME_IMAGE_PIX:
+	    *channels = 3;
+	    *sample_size = 1;
+	    return 0;
+	case BU_MIME_IMAGE_BW:
+	    *channels = 1;
+	    *sample_size = 1;
+	    return 0;
+	case BU_MIME_IMAGE_DPIX:
+	    *channels = 3;
+	    *sample_size = sizeof(double);
+	    return 0;
+	default:
+	    return -1;
+    }
+}
+
+
+static int
+png_restart(icv_file_t *f)
+{
+    size_t width, height;
+
+    png_stream_close(f->png);
+    f->png = NULL;
+    f->strip_top = f->strip_rows = 0;
+
+    if (bu_fseek(f->fp, 0, SEEK_SET) != 0)
+	return -1;
+    f->png = png_stream_open(f->fp, &width, &height);
+    if (!f->png || width != f->width || height != f->height)
+	return -1;
+    return 0;
+}
+
+
+/* Decode strips until row frow, counted from the top, is in the strip */
+static int
+png_strip(icv_file_t *f, size_t frow)
+{
+    size_t rowbytes = f->width*f->channels;
+    size_t next, n, k;
+
+    if (frow < f->strip_top && png_restart(f) < 0)
+	return -1;
+    if (frow < f->strip_top + f->strip_rows)
+	return 0;
+
+    next = f->strip_top + f->strip_rows;
+    while (frow >= next) {
+	n = f->height - next;
+	if (n > ICV_FILE_STRIP)
+	    n = ICV_FILE_STRIP;
+	for (k = 0; k < n; k++) {
+	    if (png_stream_row(f->png, f->strip + k*rowbytes) < 0) {
+		/* the decoder can't continue after an error */
+		png_stream_close(f->png);
+		f->png = NULL;
+		f->strip_top = f->strip_rows = 0;
+		return -1;
+	    }
+	}
+	f->strip_top = next;
+	f->strip_rows = n;
+	next += n;
+    }
+    return 0;
+}
+
+
+/* The file's own samples for row y, counted from the bottom */
+static const void *
+file_row(icv_file_t *f, size_t y)
+{
+    size_t rowbytes = f->width*f->channels*f->sample_size;
+    size_t frow;
+
+    if (f->mf)
+	return (const char *)f->mf->buf + y*rowbytes;
+
+    if (!f->png)
+	return NULL;
+
+    frow = f->height - 1 - y;
+    if (png_strip(f, frow) < 0)
+	return NULL;
+    return f->strip + (frow - f->strip_top)*rowbytes;
+}
+
+
+/* end of private functions */
+
+/* begin public functions */
+
+icv_file_t *
+icv_file_open(const char *filename, bu_mime_image_t format, size_t width, size_t height)
+{
+    struct bu_vls name = BU_VLS_INIT_ZERO;
+    icv_file_t *f;
+    size_t channels, sample_size;
+
+    if (!filename) {
+	bu_log("icv_file_open : a file name is required\n");
+	return NULL;
+    }
+
+    if (format == BU_MIME_IMAGE_AUTO)
+	format = icv_guess_file_format(filename, &name);
+    else
+	bu_vls_strcpy(&name, filename);
+
+    BU_GET(f, icv_file_t);
+    f->format = format;
+
+    if (format == BU_MIME_IMAGE_PNG) {
+	f->fp = fopen(bu_vls_cstr(&name), "rb");
+	if (!f->fp) {
+	    bu_log("ERROR: Cannot open file %s for reading\n", bu_vls_cstr(&name));
+	    goto fail;
+	}
+	f->png = png_stream_open(f->fp, &f->width, &f->height);
+	if (!f->png)
+	    goto fail;
+	f->channels = 3;
+	f->sample_size = 1;
+	f->strip = (unsigned char *)bu_malloc(f->width*f->channels*ICV_FILE_STRIP, "icv_file strip");
+	bu_vls_free(&name);
+	return f;
+    }
+
+    if (file_layout(format, &channels, &sample_size) < 0) {
+	bu_log("icv_file_open : regions can only be read from PIX, BW, DPIX and PNG files\n");
+	goto fail;
+    }
+
+    f->mf = bu_open_mapped_file(bu_vls_cstr(&name), "icv_file");
+    if (!f->mf) {
+	bu_log("ERROR: Cannot open file %s for reading\n", bu_vls_cstr(&name));
+	goto fail;
+    }
+
+    if (width == 0 || height == 0) {
+	/* icv_image_size counts DPIX samples as bytes */
+	size_t guess = (format == BU_MIME_IMAGE_DPIX) ? f->mf->buflen/sample_size : f->mf->buflen;
+	if (!icv_image_size(NULL, 0, guess, format, &width, &height)) {
+	    bu_log("icv_file_open : cannot guess the size of %s\n", bu_vls_cstr(&name));
+	    goto fail;
+	}
+    }
+    if (f->mf->buflen < width*height*channels*sample_size) {
+	bu_log("icv_file_open : %s is too small for a %zux%zu image\n", bu_vls_cstr(&name), width, height);
+	goto fail;
+    }
+
+    f->width = width;
+    f->height = height;
+    f->channels = channels;
+    f->sample_size = sample_size;
+    bu_vls_free(&name);
+    return f;
+
+fail:
+    bu_vls_free(&name);
+    icv_file_close(f);
+    return NULL;
+}
+
+
+icv_file_t *
+icv_file_create(const char *filename, bu_mime_image_t format, size_t width, size_t height)
+{
+    struct bu_vls name = BU_VLS_INIT_ZERO;
+    icv_file_t *f;
+    size_t channels, sample_size;
+    b_off_t size;
+
+    if (!filename || width == 0 || height == 0) {
+	bu_log("icv_file_create : a file name and size are required\n");
+	return NULL;
+    }
+
+    if (format == BU_MIME_IMAGE_AUTO)
+	format = icv_guess_file_format(filename, &name);
+    else
+	bu_vls_strcpy(&name, filename);
+
+    if (file_layout(format, &channels, &sample_size) < 0) {
+	bu_log("icv_file_create : regions can only be written to PIX, BW and DPIX files\n");
+	bu_vls_free(&name);
+	return NULL;
+    }
+
+    BU_GET(f, icv_file_t);
+    f->format = format;
+    f->width = width;
+    f->height = height;
+    f->channels = channels;
+    f->sample_size = sample_size;
+    f->writable = 1;
+
+    f->fp = fopen(bu_vls_cstr(&name), "wb");
+    if (!f->fp) {
+	perror("fopen");
+	bu_log("ERROR: icv_file_create failed to open %s\n", bu_vls_cstr(&name));
+	bu_vls_free(&name);
+	icv_file_close(f);
+	return NULL;
+    }
+
+    /* Size the file up front, regions not written stay zero */
+    size = (b_off_t)(width*height*channels*sample_size);
+    if (bu_fseek(f->fp, size - 1, SEEK_SET) != 0 || fputc(0, f->fp) == EOF) {
+	bu_log("ERROR: icv_file_create cannot size %s\n", bu_vls_cstr(&name));
+	bu_vls_free(&name);
+	icv_file_close(f);
+	return NULL;
+    }
+
+    bu_vls_free(&name);
+    return f;
+}
+
+
+int
+icv_file_size(const icv_file_t *f, size_t *width, size_t *height, size_t *channels)
+{
+    if (!f)
+	return -1;
+
+    if (width)
+	*width = f->width;
+    if (height)
+	*height = f->height;
+    if (channels)
+	*channels = f->channels;
+    return 0;
+}
+
+
+int
+icv_file_read_region(icv_file_t *f, size_t x, size_t y, size_t w, size_t h, ICV_DATA type, void *buf)
+{
+    size_t r, yy, n, rowsize;
+    const void *row;
+
+    if (!f || f->writable || !buf)
+	return -1;
+    if (x + w > f->width || y + h > f->height || w == 0 || h == 0) {
+	bu_log("icv_file_read_region : region outside of the image\n");
+	return -1;
+    }
+
+    n = w*f->channels;
+    rowsize = n*data_size(type);
+
+    for (r = 0; r < h; r++) {
+	/* PNG rows are visited from the top, in file order */
+	yy = (f->png) ? y + h - 1 - r : y + r;
+	row = file_row(f, yy);
+	if (!row)
+	    return -1;
+	row = (const char *)row + x*f->channels*f->sample_size;
+	convert_from(row, f->sample_size == sizeof(double), type, (char *)buf + (yy - y)*rowsize, n);
+    }
+
+    return 0;
+}
+
+
+icv_image_t *
+icv_file_read_image(icv_file_t *f, size_t x, size_t y, size_t w, size_t h)
+{
+    icv_image_t *img;
+
+    if (!f)
+	return NULL;
+
+    img = icv_create(w, h, (f->channels == 1) ? ICV_COLOR_SPACE_GRAY : ICV_COLOR_SPACE_RGB);
+    if (icv_file_read_region(f, x, y, w, h, ICV_DATA_DOUBLE, img->data) < 0) {
+	icv_destroy(img);
+	return NULL;
+    }
+    return img;
+}
+
+
+const unsigned char *
+icv_file_row(icv_file_t *f, size_t y)
+{
+    if (!f || f->writable || f->sample_size != 1 || y >= f->height)
+	return NULL;
+
+    return (const unsigned char *)file_row(f, y);
+}
+
+
+int
+icv_file_write_region(icv_file_t *f, size_t x, size_t y, size_t w, size_t h, ICV_DATA type, const void *buf)
+{
+    size_t r, n, rowsize, outsize;
+    void *out;
+    int ret = 0;
+
+    if (!f || !f->writable || !buf)
+	return -1;
+    if (x + w > f->width || y + h > f->height || w == 0 || h == 0) {
+	bu_log("icv_file_write_region : region outside of the image\n");
+	return -1;
+    }
+
+    n = w*f->channels;
+    rowsize = n*data_size(type);
+    outsize = n*f->sample_size;
+    out = bu_malloc(outsize, "icv_file_write_region row");
+
+    for (r = 0; r < h; r++) {
+	b_off_t off = (b_off_t)((((y + r)*f->width + x)*f->channels)*f->sample_size);
+	convert_to((const char *)buf + r*rowsize, type, out, f->sample_size == sizeof(double), n);
+	if (bu_fseek(f->fp, off, SEEK_SET) != 0 || fwrite(out, 1, outsize, f->fp) != outsize) {
+	    bu_log("icv_file_write_region : Short Write\n");
+	    ret = -1;
+	    break;
+	}
+    }
+
+    bu_free(out, "icv_file_write_region row");
+    return ret;
+}
+
+
+int
+icv_file_write_image(icv_file_t *f, size_t x, size_t y, icv_image_t *img)
+{
+    ICV_IMAGE_VAL_INT(img);
+
+    if (!f || img->channels != f->channels) {
+	bu_log("icv_file_write_image : image and file channels differ\n");
+	return -1;
+    }
+
+    return icv_file_write_region(f, x, y, img->width, img->height, ICV_DATA_DOUBLE, img->data);
+}
+
+
+int
+icv_file_close(icv_file_t *f)
+{
+    int ret = 0;
+
+    if (!f)
+	return -1;
+
+    if (f->mf)
+	bu_close_mapped_file(f->mf);
+    if (f->png)
+	png_stream_close(f->png);
+    if (f->strip)
+	bu_free(f->strip, "icv_file strip");
+    if (f->fp) {
+	if (fclose(f->fp) != 0)
+	    ret = -1;
+    }
+
+    BU_PUT(f, icv_file_t);
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -61,6 +61,7 @@
 
 #include "vmath.h"
 #include "bu/malloc.h"
+#include "bu/parallel.h"
 #include "bn/mat.h"
 #include "bg/plane.h"
 #include "bv/plot3.h"
@@ -85,7 +86,9 @@ static int nmg_isect_edge2p_face2p(struct nmg_inter_struct *is,
 				   struct faceuse *eu_fu, struct bu_list *vlfree);
 
 
-static struct nmg_inter_struct *nmg_hack_last_is;	/* see nmg_isect2d_final_cleanup() */
+/* see nmg_isect2d_final_cleanup() - one per thread, so regions can be
+ * evaluated in parallel */
+static struct nmg_inter_struct *nmg_hack_last_is[MAX_PSW];
 
 struct vertexuse *
 nmg_make_dualvu(struct vertex *v, struct faceuse *fu, const struct bn_tol *tol)
@@ -546,7 +549,7 @@ nmg_isect2d_prep(struct nmg_inter_struct *is, const uint32_t *assoc_use)
     }
 
     nmg_isect2d_cleanup(is);
-    nmg_hack_last_is = is;
+    nmg_hack_last_is[bu_parallel_id()] = is;
 
     m = nmg_find_model(assoc_use);
 
@@ -627,7 +630,7 @@ nmg_isect2d_cleanup(struct nmg_inter_struct *is)
 {
     NMG_CK_INTER_STRUCT(is);
 
-    nmg_hack_last_is = (struct nmg_inter_struct *)NULL;
+    nmg_hack_last_is[bu_parallel_id()] = (struct nmg_inter_struct *)NULL;
 
     if (!is->vert2d) return;
     bu_free((char *)is->vert2d, "vert2d");
@@ -647,8 +650,10 @@ nmg_isect2d_cleanup(struct nmg_inter_struct *is)
 void
 nmg_isect2d_final_cleanup(void)
 {
-    if (nmg_hack_last_is && nmg_hack_last_is->magic == NMG_INTER_STRUCT_MAGIC)
-	nmg_isect2d_cleanup(nmg_hack_last_is);
+    struct nmg_inter_struct *is = nmg_hack_last_is[bu_parallel_id()];
+
+    if (is && is->magic == NMG_INTER_STRUCT_MAGIC)
+	nmg_isect2d_cleanup(is);
 }
 
 
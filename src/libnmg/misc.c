@@ -7406,11 +7406,15 @@ nmg_follow_free_edges_to_vertex(const struct vertex *vpa, const struct vertex *v
 }
 
 
-static struct bu_ptbl *
-nmg_find_path(const struct vertex *vpa, const struct vertex *vpb, struct bu_ptbl *bad_verts, const struct shell *s)
+/**
+ * Fills verts (initialized here, released by the caller) with the
+ * vertices along a path of free edges from vpa to vpb, avoiding
+ * bad_verts.
+ */
+static void
+nmg_find_path(const struct vertex *vpa, const struct vertex *vpb, struct bu_ptbl *bad_verts, const struct shell *s, struct bu_ptbl *verts)
 {
     int done = 0;
-    static struct bu_ptbl verts;
     struct vertexuse *vua;
 
 
@@ -7433,8 +7437,8 @@ nmg_find_path(const struct vertex *vpa, const struct vertex *vpb, struct bu_ptbl
 	}
     }
 
-    bu_ptbl_init(&verts, 64, " &verts ");
-    bu_ptbl_ins(&verts, (long *)vpa);
+    bu_ptbl_init(verts, 64, " verts ");
+    bu_ptbl_ins(verts, (long *)vpa);
 
     for (BU_LIST_FOR (vua, vertexuse, &vpa->vu_hd)) {
 	struct edgeuse *eua;
@@ -7472,26 +7476,24 @@ nmg_find_path(const struct vertex *vpa, const struct vertex *vpb, struct bu_ptbl
 	if (eua->eumate_p->vu_p->v_p == vpb) {
 	    if (nmg_debug & NMG_DEBUG_BASIC)
 		bu_log("\t\tfound goal!!\n");
-	    bu_ptbl_ins(&verts, (long *)vpb);
-	    return &verts;
+	    bu_ptbl_ins(verts, (long *)vpb);
+	    return;
 	}
 
 	done = 0;
 	if (nmg_debug & NMG_DEBUG_BASIC)
 	    bu_log("\tCall follow edges\n");
-	nmg_follow_free_edges_to_vertex(vpa, vpb, bad_verts, s, eua, &verts, &done);
+	nmg_follow_free_edges_to_vertex(vpa, vpb, bad_verts, s, eua, verts, &done);
 
 	if (done == 1)
 	    break;
 
-	bu_ptbl_reset(&verts);
-	bu_ptbl_ins(&verts, (long *)vpa);
+	bu_ptbl_reset(verts);
+	bu_ptbl_ins(verts, (long *)vpa);
     }
 
     if (done != 1)
-	bu_ptbl_init(&verts, 64, " &verts ");
-
-    return &verts;
+	bu_ptbl_reset(verts);
 }
 
 
@@ -7910,16 +7912,16 @@ nmg_open_shells_connect(struct shell *dst, struct shell *src, const long int **c
     /* now build the faces to connect the dangling edges */
     for (i=0; i<BU_PTBL_LEN(&dangles); i++) {
 	struct dangle *dang;
-	struct bu_ptbl *verts;
+	struct bu_ptbl verts;
 
 	dang = (struct dangle *)BU_PTBL_GET(&dangles, i);
 
 	/* find vertices between vp1 and vp2 */
-	verts = nmg_find_path(dang->v1, dang->v2, &dang->bad_verts, src);
+	nmg_find_path(dang->v1, dang->v2, &dang->bad_verts, src, &verts);
 
 	/* make faces connecting the two shells */
-	if (BU_PTBL_LEN(verts) > 1)
-	    dang->needs_edge_breaking = nmg_make_connect_faces(dst, dang->va, dang->vb, verts, tol);
+	if (BU_PTBL_LEN(&verts) > 1)
+	    dang->needs_edge_breaking = nmg_make_connect_faces(dst, dang->va, dang->vb, &verts, tol);
 	else {
 	    bu_log("nmg_open_shells_connect: unable to make connecting face\n");
 	    bu_log("\tfor edge from %p (%f %f %f)\n\t\tto %p (%f %f %f)\n",
@@ -7927,7 +7929,7 @@ nmg_open_shells_connect(struct shell *dst, struct shell *src, const long int **c
 		   (void *)dang->vb, V3ARGS(dang->vb->vg_p->coord));
 	}
 
-	bu_ptbl_free(verts);
+	bu_ptbl_free(&verts);
 	bu_ptbl_free(&dang->bad_verts);
     }
 
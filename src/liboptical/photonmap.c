@@ -39,21 +39,25 @@
 #include "bu/parallel.h"
 #include "photonmap.h"
 
-#if defined(HAVE_SRAND48) && !defined(HAVE_DECL_SRAND48)
-extern void srand48(long int seedval);
-#endif
+/* Ranges of at most this many photons are kd-tree leaves, which are
+ * not split further and are searched linearly */
+#define PM_LEAF 8
+
+/* Number of photons a thread claims at a time for the irradiance cache */
+#define PM_IC_CHUNK 64
+
+/* Photons are emitted in this many independently seeded streams, which
+ * threads take in turn, so the maps only depend on the random seed and
+ * the photon count and not on the number of threads */
+#define PM_STREAMS 256
 
 int PM_Activated;
 int PM_Visualize;
 
 struct PhotonMap *PMap[PM_MAPS];/* Photon Map (KD-TREE) */
 struct Photon *Emit[PM_MAPS];	/* Emitted Photons */
-struct Photon CurPh;
 vect_t BBMin;			/* Min Bounding Box */
 vect_t BBMax;			/* Max Bounding Box */
-int Depth;			/* Used to determine how many times the photon has propagated */
-int PType;			/* Used to determine the type of Photon: Direct, Indirect, Specular, Caustic */
-int PInit;
 int EPL;			/* Emitted Photons For the Light */
 int EPS[PM_MAPS];		/* Emitted Photons For the Light */
 int ICSize;
@@ -68,169 +72,353 @@ double GPM_ATOL;		/* Angular Tolerance for Photon Gathering */
 struct resource GPM_RTAB[MAX_PSW];	/* Resource Table for Multi-threading */
 int HitG, HitB;
 
+static int sem_photonmap = 0;
+static int PMSeed = 0;
 
-/* Split so that equal numbers are above and below the splitting plane */
-int
-FindMedian(struct Photon *List, int Num, int Axis)
+
+/* Photon emission state of one stream.  Each stream traces its own
+ * photons and stores them into its own slice of Emit[], so nothing is
+ * locked while emitting; the slices are compacted in stream order once
+ * all threads are done.
+ */
+struct PhotonThread {
+    struct application ap;
+    struct Photon CurPh;
+    int Depth;			/* Used to determine how many times the photon has propagated */
+    int PType;			/* Used to determine the type of Photon: Direct, Indirect, Specular, Caustic */
+    int PInit;
+    vect_t BBMin;
+    vect_t BBMax;
+    int HitG, HitB;
+    int EPL;
+    int EPS[PM_MAPS];
+    int Off[PM_MAPS];		/* Start of this thread's slice of Emit[] */
+    int Stored[PM_MAPS];	/* Photons stored in the slice */
+    int Max[PM_MAPS];		/* Size of the slice */
+    uint64_t Rand;
+};
+
+
+struct PhotonEmit {
+    struct application *ap;
+    struct PhotonThread *T;
+    point_t Eye;
+    double ScaleIndirect;
+    int Importons;
+    int Next;			/* Next stream to emit */
+};
+
+
+/* Random numbers in [0, 1) from a xorshift64* stream per thread, in
+ * place of the shared state of drand48() */
+static double
+PRand(uint64_t *Rand)
 {
-    int i;
-    fastf_t Min, Max, Mean;
-
-    Min = Max = List[0].Pos[Axis];
-    for (i = 1; i < Num; i++) {
-	if (List[i].Pos[Axis] < Min)
-	    Min = List[i].Pos[Axis];
-	if (List[i].Pos[Axis] > Max)
-	    Max = List[i].Pos[Axis];
-    }
-    Mean = (Min+Max)/2.0;
-    i = 0;
-    while (List[i].Pos[Axis] < Mean && i < Num)
-	i++;
+    uint64_t x = *Rand;
 
-    return i;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *Rand = x;
+    return (double)((x * 2685821657736338717ULL) >> 11) / 9007199254740992.0;
 }
 
 
-/* Generate a KD-Tree from a Flat Array of Photons */
-void
-BuildTree(struct Photon *EList, int ESize, struct PNode *Root)
+/* Seed random number stream id from the user's random seed */
+static uint64_t
+PSeed(int RandomSeed, int id)
+{
+    uint64_t z = (uint64_t)RandomSeed * 0x9E3779B97F4A7C15ULL + (uint64_t)(id + 1) * 0xBF58476D1CE4E5B9ULL;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return z ? z : 1;
+}
+
+
+/* Splitting axis for List[lo, hi), which is the largest dimension of its bounding volume */
+static int
+SplitAxis(struct Photon *List, int lo, int hi)
 {
-    struct Photon *LList, *RList;
     vect_t Min, Max;
-    int i, Axis, MedianIndex, LInd, RInd;
-
-
-    /* Allocate memory for left and right lists */
-    LList = (struct Photon*)bu_calloc(ESize, sizeof(struct Photon), "LList");
-    RList = (struct Photon*)bu_calloc(ESize, sizeof(struct Photon), "RList");
-
-    /* Find the Bounding volume of the Current list of photons */
-    Min[0] = Max[0] = EList[0].Pos[0];
-    Min[1] = Max[1] = EList[0].Pos[1];
-    Min[2] = Max[2] = EList[0].Pos[2];
-    for (i = 1; i < ESize; i++) {
-	if (EList[i].Pos[0] < Min[0]) Min[0] = EList[i].Pos[0];
-	if (EList[i].Pos[1] < Min[1]) Min[1] = EList[i].Pos[1];
-	if (EList[i].Pos[2] < Min[2]) Min[2] = EList[i].Pos[2];
-	if (EList[i].Pos[0] > Max[0]) Max[0] = EList[i].Pos[0];
-	if (EList[i].Pos[1] > Max[1]) Max[1] = EList[i].Pos[1];
-	if (EList[i].Pos[2] > Max[2]) Max[2] = EList[i].Pos[2];
+    int i, Axis;
+
+    VMOVE(Min, List[lo].Pos);
+    VMOVE(Max, List[lo].Pos);
+    for (i = lo + 1; i < hi; i++) {
+	VMIN(Min, List[i].Pos);
+	VMAX(Max, List[i].Pos);
     }
 
-    /* Obtain splitting Axis, which is the largest dimension of the bounding volume */
-    Max[0] -= Min[0];
-    Max[1] -= Min[1];
-    Max[2] -= Min[2];
+    VSUB2(Max, Max, Min);
     Axis = 0;
     if (Max[1] > Max[0] && Max[1] > Max[2]) Axis = 1;
     if (Max[2] > Max[0] && Max[2] > Max[1]) Axis = 2;
 
-    /* Find Median Photon to split by. */
-    MedianIndex = FindMedian(EList, ESize, Axis);
+    return Axis;
+}
+
 
-    /* Build Left and Right Lists and make sure the Median Photon is not included in either list. */
-    LInd = RInd = 0;
-    for (i = 0; i < ESize; i++) {
-	if (i != MedianIndex) {
-	    if (EList[i].Pos[Axis] < EList[MedianIndex].Pos[Axis]) {
-		LList[LInd++] = EList[i];
-	    } else {
-		RList[RInd++] = EList[i];
+/* Split so that equal numbers are above and below the splitting plane:
+ * reorders List[lo, hi) so that the photon at Median has none larger
+ * along Axis before it and none smaller after it.
+ */
+void
+FindMedian(struct Photon *List, int lo, int hi, int Median, int Axis)
+{
+    struct Photon t;
+    fastf_t Pivot;
+    int i, j;
+
+    hi--;
+    while (lo < hi) {
+	Pivot = List[lo + (hi - lo) / 2].Pos[Axis];
+	i = lo;
+	j = hi;
+	while (i <= j) {
+	    while (List[i].Pos[Axis] < Pivot)
+		i++;
+	    while (List[j].Pos[Axis] > Pivot)
+		j--;
+	    if (i <= j) {
+		t = List[i];
+		List[i] = List[j];
+		List[j] = t;
+		i++;
+		j--;
 	    }
-	    /*
-	      if (EList[i].Pos[Axis] < Median.Pos[Axis]) {
-	      LList[LInd++] = EList[i];
-	      } else {
-	      RList[RInd++] = EList[i];
-	      }
-	    */
 	}
+
+	if (Median <= j)
+	    hi = j;
+	else if (Median >= i)
+	    lo = i;
+	else
+	    break;
     }
+}
+
+
+/* Balance List[lo, hi) into a KD-Tree in place.  The node of a range is
+ * its middle photon, and the photons before and after it are its left
+ * and right subtrees, so the tree needs no pointers and every subtree
+ * is contiguous in memory.
+ */
+static void
+BuildRange(struct Photon *List, int lo, int hi)
+{
+    int Axis, Median;
 
-    /* Store the Median Photon into the KD-Tree. */
-    /* bu_log("insertKD: %.3f, %.3f, %.3f\n", EList[MedianIndex].Pos[0], EList[MedianIndex].Pos[1], EList[MedianIndex].Pos[2]);*/
-    Root->P = EList[MedianIndex];
-    Root->P.Axis = Axis;
-    Root->C = 0;
-
-    /* With Left and Right if either contain any photons then repeat this process */
-    /* if (LInd) bu_log("Left Branch\n");*/
-    if (LInd) {
-	BU_ALLOC(Root->L, struct PNode);
-	Root->L->L = 0;
-	Root->L->R = 0;
-	BuildTree(LList, LInd, Root->L);
+    while (hi - lo > PM_LEAF) {
+	Median = lo + (hi - lo) / 2;
+	Axis = SplitAxis(List, lo, hi);
+	FindMedian(List, lo, hi, Median, Axis);
+	List[Median].Axis = Axis;
+
+	BuildRange(List, lo, Median);
+	lo = Median + 1;
     }
-    /* if (RInd) bu_log("Right Branch\n");*/
-    if (RInd) {
-	BU_ALLOC(Root->R, struct PNode);
-	Root->R->L = 0;
-	Root->R->R = 0;
-	BuildTree(RList, RInd, Root->R);
+}
+
+
+struct TreeBuild {
+    struct Photon *List;
+    int *Ranges;		/* Subtrees left to build, as [lo, hi) pairs */
+    int Num;
+    int Next;
+};
+
+
+/* Split the top Levels of the tree, collecting the subtrees below them */
+static void
+SplitLevels(struct TreeBuild *B, int lo, int hi, int Levels)
+{
+    int Axis, Median;
+
+    if (!Levels || hi - lo <= PM_LEAF) {
+	B->Ranges[2*B->Num] = lo;
+	B->Ranges[2*B->Num+1] = hi;
+	B->Num++;
+	return;
     }
 
-    bu_free(LList, "LList");
-    bu_free(RList, "RList");
+    Median = lo + (hi - lo) / 2;
+    Axis = SplitAxis(B->List, lo, hi);
+    FindMedian(B->List, lo, hi, Median, Axis);
+    B->List[Median].Axis = Axis;
+
+    SplitLevels(B, lo, Median, Levels - 1);
+    SplitLevels(B, Median + 1, hi, Levels - 1);
+}
+
+
+static void
+BuildTreeThread(int UNUSED(pid), void *arg)
+{
+    struct TreeBuild *B = (struct TreeBuild *)arg;
+    int i;
+
+    while (1) {
+	bu_semaphore_acquire(sem_photonmap);
+	i = B->Next++;
+	bu_semaphore_release(sem_photonmap);
+
+	if (i >= B->Num)
+	    return;
+	BuildRange(B->List, B->Ranges[2*i], B->Ranges[2*i+1]);
+    }
 }
 
 
+/* Generate a KD-Tree from a Flat Array of Photons, in place.  The top
+ * levels are split here and the subtrees below them are balanced in
+ * parallel.
+ */
 void
-LocatePhotons(struct PhotonSearch *Search, struct PNode *Root)
+BuildTree(struct Photon *EList, int ESize, int cpus)
 {
-    fastf_t Dist, TDist, angle, MDist;
-    int i, MaxInd, Axis;
+    struct TreeBuild B;
+    int Levels = 0;
 
-    if (!Root)
+    if (ESize <= 0)
 	return;
 
-    Axis = Root->P.Axis;
-    Dist = Search->Pos[Axis] - Root->P.Pos[Axis];
+    /* A few subtrees per thread keeps them all busy */
+    while (cpus > 1 && (1 << Levels) < 4 * cpus)
+	Levels++;
+
+    B.List = EList;
+    B.Ranges = (int *)bu_malloc(2 * (1 << Levels) * sizeof(int), "Ranges");
+    B.Num = 0;
+    B.Next = 0;
+    SplitLevels(&B, 0, ESize, Levels);
+
+    if (cpus > 1 && B.Num > 1)
+	bu_parallel(BuildTreeThread, cpus, &B);
+    else
+	BuildTreeThread(0, &B);
+
+    bu_free(B.Ranges, "Ranges");
+}
+
 
-    if (Dist < 0) {
-	/* Left of plane - search left subtree first */
-	LocatePhotons(Search, Root->L);
-	if (Dist*Dist < Search->RadSq)
-	    LocatePhotons(Search, Root->R);
+/*
+  After inserting a new node it must be brought upwards until both children
+  are less than it.
+*/
+void
+HeapUp(struct PhotonSearch *S, int ind)
+{
+    struct PSN c = S->List[ind];
+    int i;
+
+    while (ind) {
+	i = (ind - 1) / 2;
+	if (S->List[i].Dist >= c.Dist)
+	    break;
+	S->List[ind] = S->List[i];
+	ind = i;
+    }
+    S->List[ind] = c;
+}
+
+
+/*
+  Sift the new Root node down, by choosing the child with the highest number
+  since choosing a child with the highest number may reduce the number of
+  recursions the number will have to propagate
+*/
+void
+HeapDown(struct PhotonSearch *S, int ind)
+{
+    struct PSN c = S->List[ind];
+    int i;
+
+    while ((i = 2*ind+1) < S->Found) {
+	if (i+1 < S->Found && S->List[i+1].Dist > S->List[i].Dist)
+	    i++;
+	if (S->List[i].Dist <= c.Dist)
+	    break;
+	S->List[ind] = S->List[i];
+	ind = i;
+    }
+    S->List[ind] = c;
+}
+
+
+/* Check a photon against the search.  The closest photons are kept in a
+ * max-heap on distance, and once it is full the search radius shrinks
+ * to the farthest of them, which prunes the rest of the search.
+ */
+static void
+OfferPhoton(struct PhotonSearch *Search, const struct Photon *P)
+{
+    vect_t t;
+    fastf_t Dist;
+
+    /* Check that Result is within Radius and Angular Tolerance */
+    VSUB2(t, P->Pos, Search->Pos);
+    Dist = MAGSQ(t);
+    if (Dist >= Search->RadSq || VDOT(Search->Normal, P->Normal) <= GPM_ATOL)
+	return;
+
+    if (Search->Found < Search->Max) {
+	Search->List[Search->Found].P = P;
+	Search->List[Search->Found].Dist = Dist;
+	HeapUp(Search, Search->Found++);
+	if (Search->Found < Search->Max)
+	    return;
     } else {
-	/* Right of plane - search right subtree first */
-	LocatePhotons(Search, Root->R);
-	if (Dist*Dist < Search->RadSq)
-	    LocatePhotons(Search, Root->L);
+	Search->List[0].P = P;
+	Search->List[0].Dist = Dist;
+	HeapDown(Search, 0);
     }
+    Search->RadSq = Search->List[0].Dist;
+}
 
-    /* REPLACE, Find Distance between Root Photon and NP->Pos */
-    Dist = (Root->P.Pos[0] - Search->Pos[0])*(Root->P.Pos[0] - Search->Pos[0]) + (Root->P.Pos[1] - Search->Pos[1])*(Root->P.Pos[1] - Search->Pos[1]) + (Root->P.Pos[2] - Search->Pos[2])*(Root->P.Pos[2] - Search->Pos[2]);
 
-    angle = VDOT(Search->Normal, Root->P.Normal);
-    if (Dist < Search->RadSq && angle > GPM_ATOL) {
-	/* Check that Result is within Radius and Angular Tolerance */
-	/* if (Dist < NP->RadSq) {*/
-	if (Search->Found < Search->Max) {
-	    Search->List[Search->Found++].P = Root->P;
+/* Find the photons of Tree[lo, hi) nearest to Search->Pos */
+void
+LocatePhotons(struct PhotonSearch *Search, const struct Photon *Tree, int lo, int hi)
+{
+    const struct Photon *P;
+    fastf_t Dist;
+    int Median;
+
+    while (hi - lo > PM_LEAF) {
+	Median = lo + (hi - lo) / 2;
+	P = &Tree[Median];
+	Dist = Search->Pos[P->Axis] - P->Pos[P->Axis];
+
+	if (Dist < 0) {
+	    /* Left of plane - search left subtree first */
+	    LocatePhotons(Search, Tree, lo, Median);
+	    OfferPhoton(Search, P);
+	    lo = Median + 1;
 	} else {
-	    MDist = (Search->Pos[0] - Search->List[0].P.Pos[0])*(Search->Pos[0] - Search->List[0].P.Pos[0])+(Search->Pos[1] - Search->List[0].P.Pos[1])*(Search->Pos[1] - Search->List[0].P.Pos[1])+(Search->Pos[2] - Search->List[0].P.Pos[2])*(Search->Pos[2] - Search->List[0].P.Pos[2]);
-	    MaxInd = 0;
-	    for (i = 1; i < Search->Found; i++) {
-		TDist = (Search->Pos[0] - Search->List[i].P.Pos[0])*(Search->Pos[0] - Search->List[i].P.Pos[0])+(Search->Pos[1] - Search->List[i].P.Pos[1])*(Search->Pos[1] - Search->List[i].P.Pos[1])+(Search->Pos[2] - Search->List[i].P.Pos[2])*(Search->Pos[2] - Search->List[i].P.Pos[2]);
-		if (TDist > MDist) {
-		    MDist = TDist;
-		    MaxInd = i;
-		}
-	    }
-
-	    if (Dist < MDist)
-		Search->List[MaxInd].P = Root->P;
+	    /* Right of plane - search right subtree first */
+	    LocatePhotons(Search, Tree, Median + 1, hi);
+	    OfferPhoton(Search, P);
+	    hi = Median;
 	}
+
+	if (Dist*Dist >= Search->RadSq)
+	    return;
     }
+
+    for (; lo < hi; lo++)
+	OfferPhoton(Search, &Tree[lo]);
 }
 
 
-/* Places photon into flat array that wwill form the final kd-tree. */
+/* Places photon into the thread's slice of the flat array that will form the final kd-tree. */
 void
-Store(point_t Pos, vect_t Dir, vect_t Normal, int map)
+Store(struct PhotonThread *T, point_t Pos, vect_t Dir, vect_t Normal, int map)
 {
     struct PhotonSearch Search;
+    struct PSN Nearest;
+    struct Photon *P;
     int i;
 
     /* If Importance Mapping is enabled, Check to see if the Photon is in an area that is considered important, if not then disregard it */
@@ -240,49 +428,30 @@ Store(point_t Pos, vect_t Dir, vect_t Normal, int map)
 	Search.RadSq = ScaleFactor;
 	Search.Found = 0;
 	Search.Max = 1;
-	Search.Pos[0] = Pos[0];
-	Search.Pos[1] = Pos[1];
-	Search.Pos[2] = Pos[2];
-	Search.Normal[0] = Normal[0];
-	Search.Normal[1] = Normal[1];
-	Search.Normal[2] = Normal[2];
-
-	Search.List = (struct PSN*)bu_calloc(Search.Max, sizeof(struct PSN), "Search.List");
-	LocatePhotons(&Search, PMap[PM_IMPORTANCE]->Root);
-	bu_free(Search.List, "Search.List");
+	VMOVE(Search.Pos, Pos);
+	VMOVE(Search.Normal, Normal);
+	Search.List = &Nearest;
+	LocatePhotons(&Search, PMap[PM_IMPORTANCE]->Photons, 0, PMap[PM_IMPORTANCE]->StoredPhotons);
 
 	if (!Search.Found) {
-	    HitB++;
+	    T->HitB++;
 	    return;
 	}
     }
 
 
-    if (PMap[map]->StoredPhotons < PMap[map]->MaxPhotons) {
-	HitG++;
+    if (T->Stored[map] < T->Max[map]) {
+	T->HitG++;
+	P = &Emit[map][T->Off[map] + T->Stored[map]];
 	for (i = 0; i < 3; i++) {
 	    /* Store Position, Direction, and Power of Photon */
-	    Emit[map][PMap[map]->StoredPhotons].Pos[i] = Pos[i];
-	    Emit[map][PMap[map]->StoredPhotons].Dir[i] = Dir[i];
-	    Emit[map][PMap[map]->StoredPhotons].Normal[i] = Normal[i];
-	    Emit[map][PMap[map]->StoredPhotons].Power[i] = CurPh.Power[i];
+	    P->Pos[i] = Pos[i];
+	    P->Dir[i] = Dir[i];
+	    P->Normal[i] = Normal[i];
+	    P->Power[i] = T->CurPh.Power[i];
 	}
-	PMap[map]->StoredPhotons++;
-	/*
-	  if (map != PM_IMPORTANCE && PMap[PM_IMPORTANCE]->StoredPhotons < PMap[PM_IMPORTANCE]->MaxPhotons)
-	  bu_log("Map2: %d, Size: %d\n", map, PMap[map]->StoredPhotons);
-	*/
-	/*
-	  if (map == PM_IMPORTANCE)
-	  bu_log("Map: %d, Size: %d, [%.3f, %.3f, %.3f] [%.3f, %.3f, %.3f]\n", map, PMap[map]->StoredPhotons, Pos[0], Pos[1], Pos[2], CurPh.Power[0], CurPh.Power[1], CurPh.Power[2]);
-	*/
+	T->Stored[map]++;
     }
-
-    /*
-      bu_log("[%d][%d][%.3f, %.3f, %.3f]\n", map, PMap[map]->StoredPhotons, CurPh.Power[0], CurPh.Power[1], CurPh.Power[2]);
-      if (!(PMap[map]->StoredPhotons % 64))
-      bu_log("[%d][%d][%.3f, %.3f, %.3f]\n", map, PMap[map]->StoredPhotons, Pos[0], Pos[1], Pos[2]);
-    */
 }
 
 
@@ -307,19 +476,13 @@ SpecularReflect(vect_t normal, vect_t rdir)
 
 /* Compute a random reflected diffuse direction */
 void
-DiffuseReflect(vect_t normal, vect_t rdir)
+DiffuseReflect(vect_t normal, vect_t rdir, uint64_t *Rand)
 {
     /* Allow Photons to get a random direction at most 60 degrees to the normal */
     do {
-#ifndef HAVE_DRAND48
-	rdir[0] = 2.0*rand()/(double)RAND_MAX-1.0;
-	rdir[1] = 2.0*rand()/(double)RAND_MAX-1.0;
-	rdir[2] = 2.0*rand()/(double)RAND_MAX-1.0;
-#else
-	rdir[0] = 2.0*drand48()-1.0;
-	rdir[1] = 2.0*drand48()-1.0;
-	rdir[2] = 2.0*drand48()-1.0;
-#endif
+	rdir[0] = 2.0*PRand(Rand)-1.0;
+	rdir[1] = 2.0*PRand(Rand)-1.0;
+	rdir[2] = 2.0*PRand(Rand)-1.0;
 	VUNITIZE(rdir);
     } while (VDOT(rdir, normal) < 0.5);
 }
@@ -457,6 +620,7 @@ int PHit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED
 int
 HitRef(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(finished_segs))
 {
+    struct PhotonThread *T = (struct PhotonThread *)ap->a_uptr;
     struct partition *part;
     vect_t pt, normal, spec;
     fastf_t refi, transmit;
@@ -484,11 +648,11 @@ HitRef(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(f
 
     if (Refract(ap->a_ray.r_dir, normal, refi, 1.0)) {
 	/*
-	  bu_log("1D: %d, [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f]\n", Depth, pt[0], pt[1], pt[2], ap->a_ray.r_dir[0], ap->a_ray.r_dir[1], ap->a_ray.r_dir[2], normal[0], normal[1], normal[2]);
+	  bu_log("1D: %d, [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f]\n", T->Depth, pt[0], pt[1], pt[2], ap->a_ray.r_dir[0], ap->a_ray.r_dir[1], ap->a_ray.r_dir[2], normal[0], normal[1], normal[2]);
 	  bu_log("p1: [%.3f, %.3f, %.3f]\n", part->pt_inhit->hit_point[0], part->pt_inhit->hit_point[1], part->pt_inhit->hit_point[2]);
 	  bu_log("p2: [%.3f, %.3f, %.3f]\n", part->pt_outhit->hit_point[0], part->pt_outhit->hit_point[1], part->pt_outhit->hit_point[2]);
 	*/
-	Depth++;
+	T->Depth++;
 	rt_shootray(ap);
     } else {
 	bu_log("TIF\n");
@@ -499,10 +663,11 @@ HitRef(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(f
 }
 
 //#define PHIT_DEBUG
-/* Callback for Photon Hit, The 'current' photon is Emit[PMap->StoredPhotons] */
+/* Callback for Photon Hit, The 'current' photon is the CurPh of the thread in a_uptr */
 int
 PHit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(finished_segs))
 {
+    struct PhotonThread *T = (struct PhotonThread *)ap->a_uptr;
     struct partition *part;
     vect_t pt, normal, color, spec, power;
     fastf_t refi, transmit, prob, prob_diff, prob_spec, prob_ref;
@@ -546,24 +711,24 @@ PHit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(fin
 
 
     /* Generate Bounding Box for Scaling Phase */
-    if (PInit) {
-	BBMin[0] = BBMax[0] = pt[0];
-	BBMin[1] = BBMax[1] = pt[1];
-	BBMin[2] = BBMax[2] = pt[2];
-	PInit = 0;
+    if (T->PInit) {
+	T->BBMin[0] = T->BBMax[0] = pt[0];
+	T->BBMin[1] = T->BBMax[1] = pt[1];
+	T->BBMin[2] = T->BBMax[2] = pt[2];
+	T->PInit = 0;
     } else {
-	if (pt[0] < BBMin[0])
-	    BBMin[0] = pt[0];
-	if (pt[0] > BBMax[0])
-	    BBMax[0] = pt[0];
-	if (pt[1] < BBMin[1])
-	    BBMin[1] = pt[1];
-	if (pt[1] > BBMax[1])
-	    BBMax[1] = pt[1];
-	if (pt[2] < BBMin[2])
-	    BBMin[2] = pt[2];
-	if (pt[2] > BBMax[2])
-	    BBMax[2] = pt[2];
+	if (pt[0] < T->BBMin[0])
+	    T->BBMin[0] = pt[0];
+	if (pt[0] > T->BBMax[0])
+	    T->BBMax[0] = pt[0];
+	if (pt[1] < T->BBMin[1])
+	    T->BBMin[1] = pt[1];
+	if (pt[1] > T->BBMax[1])
+	    T->BBMax[1] = pt[1];
+	if (pt[2] < T->BBMin[2])
+	    T->BBMin[2] = pt[2];
+	if (pt[2] > T->BBMax[2])
+	    T->BBMax[2] = pt[2];
     }
 
     /* Fetch Intersection Normal */
@@ -582,11 +747,7 @@ PHit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(fin
     prob_ref = MaxFloat(color[0]+spec[0], color[1]+spec[1], color[2]+spec[2]);
     prob_diff = ((color[0]+color[1]+color[2])/(color[0]+color[1]+color[2]+spec[0]+spec[1]+spec[2]))*prob_ref;
     prob_spec = prob_ref - prob_diff;
-#ifndef HAVE_DRAND48
-    prob = rand()/(double)RAND_MAX;
-#else
-    prob = drand48();
-#endif
+    prob = PRand(&T->Rand);
 
     /* bu_log("pr: %.3f, pd: %.3f, [%.3f, %.3f, %.3f] [%.3f, %.3f, %.3f]\n", prob_ref, prob_diff, color[0], color[1], color[2], spec[0], spec[1], spec[2]);*/
     /* bu_log("prob: %.3f, prob_diff: %.3f, pd+ps: %.3f\n", prob, prob_diff, prob_diff+prob_spec);*/
@@ -594,41 +755,41 @@ PHit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(fin
     if (prob < 1.0 - transmit) {
 	if (prob < prob_diff) {
 	    /* Store power of incident Photon */
-	    power[0] = CurPh.Power[0];
-	    power[1] = CurPh.Power[1];
-	    power[2] = CurPh.Power[2];
+	    power[0] = T->CurPh.Power[0];
+	    power[1] = T->CurPh.Power[1];
+	    power[2] = T->CurPh.Power[2];
 
 
 	    /* Scale Power of reflected photon */
-	    CurPh.Power[0] = power[0]*color[0]/prob_diff;
-	    CurPh.Power[1] = power[1]*color[1]/prob_diff;
-	    CurPh.Power[2] = power[2]*color[2]/prob_diff;
+	    T->CurPh.Power[0] = power[0]*color[0]/prob_diff;
+	    T->CurPh.Power[1] = power[1]*color[1]/prob_diff;
+	    T->CurPh.Power[2] = power[2]*color[2]/prob_diff;
 
 	    /* Store Photon */
-	    Store(pt, ap->a_ray.r_dir, normal, PType);
+	    Store(T, pt, ap->a_ray.r_dir, normal, T->PType);
 
 	    /* Assign diffuse reflection direction */
-	    DiffuseReflect(normal, ap->a_ray.r_dir);
+	    DiffuseReflect(normal, ap->a_ray.r_dir, &T->Rand);
 
 	    /* Assign pt */
 	    ap->a_ray.r_pt[0] = pt[0];
 	    ap->a_ray.r_pt[1] = pt[1];
 	    ap->a_ray.r_pt[2] = pt[2];
 
-	    if (PType != PM_CAUSTIC) {
-		Depth++;
+	    if (T->PType != PM_CAUSTIC) {
+		T->Depth++;
 		rt_shootray(ap);
 	    }
 	} else if (prob >= prob_diff && prob < prob_diff + prob_spec) {
 	    /* Store power of incident Photon */
-	    power[0] = CurPh.Power[0];
-	    power[1] = CurPh.Power[1];
-	    power[2] = CurPh.Power[2];
+	    power[0] = T->CurPh.Power[0];
+	    power[1] = T->CurPh.Power[1];
+	    power[2] = T->CurPh.Power[2];
 
 	    /* Scale power of reflected photon */
-	    CurPh.Power[0] = power[0]*spec[0]/prob_spec;
-	    CurPh.Power[1] = power[1]*spec[1]/prob_spec;
-	    CurPh.Power[2] = power[2]*spec[2]/prob_spec;
+	    T->CurPh.Power[0] = power[0]*spec[0]/prob_spec;
+	    T->CurPh.Power[1] = power[1]*spec[1]/prob_spec;
+	    T->CurPh.Power[2] = power[2]*spec[2]/prob_spec;
 
 	    /* Reflective */
 	    SpecularReflect(normal, ap->a_ray.r_dir);
@@ -638,34 +799,34 @@ PHit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(fin
 	    ap->a_ray.r_pt[1] = pt[1];
 	    ap->a_ray.r_pt[2] = pt[2];
 
-	    if (PType != PM_IMPORTANCE)
-		PType = PM_CAUSTIC;
-	    Depth++;
+	    if (T->PType != PM_IMPORTANCE)
+		T->PType = PM_CAUSTIC;
+	    T->Depth++;
 	    rt_shootray(ap);
 	} else {
 	    /* Store Photon */
-	    Store(pt, ap->a_ray.r_dir, normal, PType);
+	    Store(T, pt, ap->a_ray.r_dir, normal, T->PType);
 	}
     } else {
-	if (refi > 1.0 && (PType == PM_CAUSTIC || Depth == 0)) {
-	    if (PType != PM_IMPORTANCE)
-		PType = PM_CAUSTIC;
+	if (refi > 1.0 && (T->PType == PM_CAUSTIC || T->Depth == 0)) {
+	    if (T->PType != PM_IMPORTANCE)
+		T->PType = PM_CAUSTIC;
 
 	    /* Store power of incident Photon */
-	    power[0] = CurPh.Power[0];
-	    power[1] = CurPh.Power[1];
-	    power[2] = CurPh.Power[2];
+	    power[0] = T->CurPh.Power[0];
+	    power[1] = T->CurPh.Power[1];
+	    power[2] = T->CurPh.Power[2];
 
 	    /* Scale power of reflected photon */
-	    CurPh.Power[0] = power[0]*spec[0]/prob_spec;
-	    CurPh.Power[1] = power[1]*spec[1]/prob_spec;
-	    CurPh.Power[2] = power[2]*spec[2]/prob_spec;
+	    T->CurPh.Power[0] = power[0]*spec[0]/prob_spec;
+	    T->CurPh.Power[1] = power[1]*spec[1]/prob_spec;
+	    T->CurPh.Power[2] = power[2]*spec[2]/prob_spec;
 
 	    /* Refractive or Reflective */
 	    if (refi > 1.0 && prob < transmit) {
-		CurPh.Power[0] = power[0];
-		CurPh.Power[1] = power[1];
-		CurPh.Power[2] = power[2];
+		T->CurPh.Power[0] = power[0];
+		T->CurPh.Power[1] = power[1];
+		T->CurPh.Power[2] = power[2];
 
 		if (!Refract(ap->a_ray.r_dir, normal, 1.0, refi))
 		    printf("TIF0\n");
@@ -688,8 +849,8 @@ PHit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(fin
 	    ap->a_ray.r_pt[1] = pt[1];
 	    ap->a_ray.r_pt[2] = pt[2];
 
-	    /* bu_log("2D: %d, [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f]\n", Depth, pt[0], pt[1], pt[2], ap->a_ray.r_dir[0], ap->a_ray.r_dir[1], ap->a_ray.r_dir[2], normal[0], normal[1], normal[2]);*/
-	    Depth++;
+	    /* bu_log("2D: %d, [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f], [%.3f, %.3f, %.3f]\n", T->Depth, pt[0], pt[1], pt[2], ap->a_ray.r_dir[0], ap->a_ray.r_dir[1], ap->a_ray.r_dir[2], normal[0], normal[1], normal[2]);*/
+	    T->Depth++;
 	    rt_shootray(ap);
 	}
     }
@@ -727,18 +888,14 @@ ScalePhotonPower(int map)
 void
 EmitImportonsRandom(struct application *ap, point_t eye_pos)
 {
-    while (PMap[PM_IMPORTANCE]->StoredPhotons < PMap[PM_IMPORTANCE]->MaxPhotons) {
+    struct PhotonThread *T = (struct PhotonThread *)ap->a_uptr;
+
+    while (T->Stored[PM_IMPORTANCE] < T->Max[PM_IMPORTANCE]) {
 	do {
 	    /* Set Ray Direction to application ptr */
-#ifndef HAVE_DRAND48
-	    ap->a_ray.r_dir[0] = 2.0*rand()/(double)RAND_MAX-1.0;
-	    ap->a_ray.r_dir[1] = 2.0*rand()/(double)RAND_MAX-1.0;
-	    ap->a_ray.r_dir[2] = 2.0*rand()/(double)RAND_MAX-1.0;
-#else
-	    ap->a_ray.r_dir[0] = 2.0*drand48()-1.0;
-	    ap->a_ray.r_dir[1] = 2.0*drand48()-1.0;
-	    ap->a_ray.r_dir[2] = 2.0*drand48()-1.0;
-#endif
+	    ap->a_ray.r_dir[0] = 2.0*PRand(&T->Rand)-1.0;
+	    ap->a_ray.r_dir[1] = 2.0*PRand(&T->Rand)-1.0;
+	    ap->a_ray.r_dir[2] = 2.0*PRand(&T->Rand)-1.0;
 	} while (ap->a_ray.r_dir[0]*ap->a_ray.r_dir[0] + ap->a_ray.r_dir[1]*ap->a_ray.r_dir[1] + ap->a_ray.r_dir[2]*ap->a_ray.r_dir[2] > 1);
 
 	/* Normalize Ray Direction */
@@ -750,12 +907,12 @@ EmitImportonsRandom(struct application *ap, point_t eye_pos)
 	ap->a_ray.r_pt[2] = eye_pos[2];
 
 	/* Shoot Importon into Scene */
-	CurPh.Power[0] = 0;
-	CurPh.Power[1] = 100000000;
-	CurPh.Power[2] = 0;
+	T->CurPh.Power[0] = 0;
+	T->CurPh.Power[1] = 100000000;
+	T->CurPh.Power[2] = 0;
 
-	Depth = 0;
-	PType = PM_IMPORTANCE;
+	T->Depth = 0;
+	T->PType = PM_IMPORTANCE;
 	rt_shootray(ap);
     }
 }
@@ -765,6 +922,7 @@ EmitImportonsRandom(struct application *ap, point_t eye_pos)
 void
 EmitPhotonsRandom(struct application *ap, double ScaleIndirect)
 {
+    struct PhotonThread *T = (struct PhotonThread *)ap->a_uptr;
     struct light_specific *lp;
     int i;
 
@@ -775,21 +933,14 @@ EmitPhotonsRandom(struct application *ap, double ScaleIndirect)
     while (1) {
 	for (BU_LIST_FOR(lp, light_specific, &(LightHead.l))) {
 	    /* If the Global Photon Map Completes before the Caustics Map, then it probably means there are no caustic objects in the Scene */
-	    if (PMap[PM_GLOBAL]->StoredPhotons == PMap[PM_GLOBAL]->MaxPhotons && (!PMap[PM_CAUSTIC]->StoredPhotons || PMap[PM_CAUSTIC]->StoredPhotons == PMap[PM_CAUSTIC]->MaxPhotons))
+	    if (T->Stored[PM_GLOBAL] == T->Max[PM_GLOBAL] && (!T->Stored[PM_CAUSTIC] || T->Stored[PM_CAUSTIC] == T->Max[PM_CAUSTIC]))
 		return;
 
 	    do {
-		/* do {*/
 		/* Set Ray Direction to application ptr */
-#ifndef HAVE_DRAND48
-		ap->a_ray.r_dir[0] = 2.0*rand()/(double)RAND_MAX-1.0;
-		ap->a_ray.r_dir[1] = 2.0*rand()/(double)RAND_MAX-1.0;
-		ap->a_ray.r_dir[2] = 2.0*rand()/(double)RAND_MAX-1.0;
-#else
-		ap->a_ray.r_dir[0] = 2.0*drand48()-1.0;
-		ap->a_ray.r_dir[1] = 2.0*drand48()-1.0;
-		ap->a_ray.r_dir[2] = 2.0*drand48()-1.0;
-#endif
+		ap->a_ray.r_dir[0] = 2.0*PRand(&T->Rand)-1.0;
+		ap->a_ray.r_dir[1] = 2.0*PRand(&T->Rand)-1.0;
+		ap->a_ray.r_dir[2] = 2.0*PRand(&T->Rand)-1.0;
 	    } while (ap->a_ray.r_dir[0]*ap->a_ray.r_dir[0] + ap->a_ray.r_dir[1]*ap->a_ray.r_dir[1] + ap->a_ray.r_dir[2]*ap->a_ray.r_dir[2] > 1);
 	    /* Normalize Ray Direction */
 	    VUNITIZE(ap->a_ray.r_dir);
@@ -802,34 +953,85 @@ EmitPhotonsRandom(struct application *ap, double ScaleIndirect)
 
 	    /* Shoot Photon into Scene, (4.0) is used to align phong's attenuation with photonic energies, it's a heuristic */
 	    /*bu_log("Shooting Ray: [%.3f, %.3f, %.3f] [%.3f, %.3f, %.3f]\n", lp->lt_pos[0], lp->lt_pos[1], lp->lt_pos[2], x, y, z);*/
-	    CurPh.Power[0] = 1000.0 * ScaleIndirect * lp->lt_intensity * lp->lt_color[0];
-	    CurPh.Power[1] = 1000.0 * ScaleIndirect * lp->lt_intensity * lp->lt_color[1];
-	    CurPh.Power[2] = 1000.0 * ScaleIndirect * lp->lt_intensity * lp->lt_color[2];
+	    T->CurPh.Power[0] = 1000.0 * ScaleIndirect * lp->lt_intensity * lp->lt_color[0];
+	    T->CurPh.Power[1] = 1000.0 * ScaleIndirect * lp->lt_intensity * lp->lt_color[1];
+	    T->CurPh.Power[2] = 1000.0 * ScaleIndirect * lp->lt_intensity * lp->lt_color[2];
 
-	    Depth = 0;
-	    PType = PM_GLOBAL;
+	    T->Depth = 0;
+	    T->PType = PM_GLOBAL;
 
-	    EPL++;
+	    T->EPL++;
 	    for (i = 0; i < PM_MAPS; i++)
-		if (PMap[i]->StoredPhotons < PMap[i]->MaxPhotons)
-		    EPS[i]++;
+		if (T->Stored[i] < T->Max[i])
+		    T->EPS[i]++;
 
 	    rt_shootray(ap);
-	    /* bu_log("1: %d, 2: %d\n", PMap[PM_GLOBAL]->StoredPhotons, PMap[PM_CAUSTIC]->StoredPhotons);*/
 	}
     }
 }
 
 
-void
-SanityCheck(struct PNode *Root, int LR)
+static void
+EmitThread(int pid, void *arg)
 {
-    if (!Root)
-	return;
+    struct PhotonEmit *E = (struct PhotonEmit *)arg;
+    struct PhotonThread *T;
+    int i;
+
+    while (1) {
+	bu_semaphore_acquire(sem_photonmap);
+	i = E->Next++;
+	bu_semaphore_release(sem_photonmap);
+
+	if (i >= PM_STREAMS)
+	    return;
+
+	T = &E->T[i];
+	T->ap = *E->ap;
+	T->ap.a_resource = &GPM_RTAB[pid];
+	T->ap.a_uptr = (void *)T;
+
+	if (E->Importons)
+	    EmitImportonsRandom(&T->ap, E->Eye);
+	else
+	    EmitPhotonsRandom(&T->ap, E->ScaleIndirect);
+    }
+}
+
 
-    bu_log("Pos[%d]: [%.3f, %.3f, %.3f]\n", LR, Root->P.Pos[0], Root->P.Pos[1], Root->P.Pos[2]);
-    SanityCheck(Root->L, 1);
-    SanityCheck(Root->R, 2);
+/* Compact the slices the streams stored into Emit[map] */
+static void
+MergePhotons(struct PhotonThread *T, int map)
+{
+    int i, Num = 0;
+
+    for (i = 0; i < PM_STREAMS; i++) {
+	if (T[i].Stored[map] && T[i].Off[map] != Num)
+	    memmove(&Emit[map][Num], &Emit[map][T[i].Off[map]], T[i].Stored[map] * sizeof(struct Photon));
+	Num += T[i].Stored[map];
+    }
+    PMap[map]->StoredPhotons = Num;
+}
+
+
+/* Bounding box of everything the streams have hit so far */
+static void
+MergeBounds(struct PhotonThread *T)
+{
+    int i, Init = 1;
+
+    for (i = 0; i < PM_STREAMS; i++) {
+	if (T[i].PInit)
+	    continue;
+	if (Init) {
+	    VMOVE(BBMin, T[i].BBMin);
+	    VMOVE(BBMax, T[i].BBMax);
+	    Init = 0;
+	} else {
+	    VMIN(BBMin, T[i].BBMin);
+	    VMAX(BBMax, T[i].BBMax);
+	}
+    }
 }
 
 
@@ -873,7 +1075,7 @@ GetEstimate(vect_t irrad, point_t pos, vect_t normal, fastf_t rad, int np, int m
     do {
 	Search.Found = 0;
 	Search.RadSq *= 4.0;
-	LocatePhotons(&Search, PMap[map]->Root);
+	LocatePhotons(&Search, PMap[map]->Photons, 0, PMap[map]->StoredPhotons);
 	if (!Search.Found && Search.RadSq > ScaleFactor*ScaleFactor/100.0)
 	    break;
     } while (Search.Found < Search.Max && Search.RadSq < max_rad*max_rad);
@@ -889,13 +1091,13 @@ GetEstimate(vect_t irrad, point_t pos, vect_t normal, fastf_t rad, int np, int m
     Centroid[0] = Centroid[1] = Centroid[2] = 0;
 
     for (i = 0; i < Search.Found; i++) {
-	t[0] = Search.List[i].P.Pos[0] - pos[0];
-	t[1] = Search.List[i].P.Pos[1] - pos[1];
-	t[2] = Search.List[i].P.Pos[2] - pos[2];
+	t[0] = Search.List[i].P->Pos[0] - pos[0];
+	t[1] = Search.List[i].P->Pos[1] - pos[1];
+	t[2] = Search.List[i].P->Pos[2] - pos[2];
 
-	Centroid[0] += Search.List[i].P.Pos[0];
-	Centroid[1] += Search.List[i].P.Pos[1];
-	Centroid[2] += Search.List[i].P.Pos[2];
+	Centroid[0] += Search.List[i].P->Pos[0];
+	Centroid[1] += Search.List[i].P->Pos[1];
+	Centroid[2] += Search.List[i].P->Pos[2];
 
 	dist = t[0]*t[0] + t[1]*t[1] + t[2]*t[2];
 	if (dist > Search.RadSq)
@@ -920,18 +1122,18 @@ GetEstimate(vect_t irrad, point_t pos, vect_t normal, fastf_t rad, int np, int m
     }
 
     for (i = 0; i < Search.Found; i++) {
-	t[0] = Search.List[i].P.Pos[0] - pos[0];
-	t[1] = Search.List[i].P.Pos[1] - pos[1];
-	t[2] = Search.List[i].P.Pos[2] - pos[2];
+	t[0] = Search.List[i].P->Pos[0] - pos[0];
+	t[1] = Search.List[i].P->Pos[1] - pos[1];
+	t[2] = Search.List[i].P->Pos[2] - pos[2];
 
 	dist = t[0]*t[0] + t[1]*t[1] + t[2]*t[2];
 	/* Filter= 0.50;*/
 	/* Filter= ConeFilter(dist, NP.RadSq);*/
 	Filter = 0.5*GaussFilter(dist, Search.RadSq);
 
-	irrad[0] += Search.List[i].P.Power[0]*Filter*ScaleFilter;
-	irrad[1] += Search.List[i].P.Power[1]*Filter*ScaleFilter;
-	irrad[2] += Search.List[i].P.Power[2]*Filter*ScaleFilter;
+	irrad[0] += Search.List[i].P->Power[0]*Filter*ScaleFilter;
+	irrad[1] += Search.List[i].P->Power[1]*Filter*ScaleFilter;
+	irrad[2] += Search.List[i].P->Power[2]*Filter*ScaleFilter;
     }
 
     t[0] = sqrt((Centroid[0] - pos[0])*(Centroid[0] - pos[0])+(Centroid[1] - pos[1])*(Centroid[1] - pos[1])+(Centroid[2] - pos[2])*(Centroid[2] - pos[2]));
@@ -1026,45 +1228,39 @@ Polar2Euclidian(vect_t Dir, vect_t Normal, double Theta, double Phi)
  * Irradiance Calculation for a given position
  */
 void
-Irradiance(int pid, struct Photon *P, struct application *ap)
+Irradiance(int pid, struct Photon *P, struct application *ap, uint64_t *Rand)
 {
-    struct application *lap;		/* local application instance */
+    struct application lap;		/* local application instance */
     int i, j, M, N;
     double theta, phi, Coef;
 
-    BU_ALLOC(lap, struct application);
-    RT_APPLICATION_INIT(lap);
-    lap->a_rt_i = ap->a_rt_i;
-    lap->a_hit = ap->a_hit;
-    lap->a_miss = ap->a_miss;
-    lap->a_resource = &GPM_RTAB[pid];
-    lap->a_logoverlap = ap->a_logoverlap;
+    RT_APPLICATION_INIT(&lap);
+    lap.a_rt_i = ap->a_rt_i;
+    lap.a_hit = ap->a_hit;
+    lap.a_miss = ap->a_miss;
+    lap.a_resource = &GPM_RTAB[pid];
+    lap.a_logoverlap = ap->a_logoverlap;
 
     M = N = GPM_RAYS;
     P->Irrad[0] = P->Irrad[1] = P->Irrad[2] = 0.0;
     for (i = 1; i <= M; i++) {
 	for (j = 1; j <= N; j++) {
-#ifndef HAVE_DRAND48
-	    theta = asin(sqrt((j-rand()/(double)RAND_MAX)/M));
-	    phi = (M_2PI)*((i-rand()/(double)RAND_MAX)/N);
-#else
-	    theta = asin(sqrt((j-drand48())/M));
-	    phi = (M_2PI)*((i-drand48())/N);
-#endif
+	    theta = asin(sqrt((j-PRand(Rand))/M));
+	    phi = (M_2PI)*((i-PRand(Rand))/N);
 
 	    /* Assign pt */
-	    lap->a_ray.r_pt[0] = P->Pos[0];
-	    lap->a_ray.r_pt[1] = P->Pos[1];
-	    lap->a_ray.r_pt[2] = P->Pos[2];
+	    lap.a_ray.r_pt[0] = P->Pos[0];
+	    lap.a_ray.r_pt[1] = P->Pos[1];
+	    lap.a_ray.r_pt[2] = P->Pos[2];
 
 	    /* Assign Dir */
-	    Polar2Euclidian(lap->a_ray.r_dir, P->Normal, theta, phi);
+	    Polar2Euclidian(lap.a_ray.r_dir, P->Normal, theta, phi);
 
 	    /* Utilize the purpose pointer as a pointer to the Irradiance Color */
-	    lap->a_purpose = (const char *)P->Irrad;
+	    lap.a_purpose = (const char *)P->Irrad;
 
 	    /* bu_log("Vec: [%.3f, %.3f, %.3f]\n", ap->a_ray.r_dir[0], ap->a_ray.r_dir[1], ap->a_ray.r_dir[2]);*/
-	    rt_shootray(lap);
+	    rt_shootray(&lap);
 
 	    /* bu_log("[%.3f, %.3f, %.3f] [%.3f, %.3f, %.3f] [%.3f, %.3f, %.3f]\n", P.Pos[0], P.Pos[1], P.Pos[2], P.Normal[0], P.Normal[1], P.Normal[2], IMColor[0], IMColor[1], IMColor[2]);*/
 	}
@@ -1074,8 +1270,6 @@ Irradiance(int pid, struct Photon *P, struct application *ap)
     P->Irrad[0] *= Coef;
     P->Irrad[1] *= Coef;
     P->Irrad[2] *= Coef;
-
-    bu_free(lap, "app");
 }
 
 
@@ -1083,34 +1277,33 @@ Irradiance(int pid, struct Photon *P, struct application *ap)
  * Irradiance Cache for Indirect Illumination
  * Go through each photon and use it for the position of the hemisphere
  * and then determine whether that should be included as a Cache Pt.
+ * The photons are claimed a chunk at a time, in array order, and each
+ * chunk has its own random number stream whichever thread claims it.
  */
 void
-BuildIrradianceCache(int pid, struct PNode *Node, struct application *ap)
+BuildIrradianceCache(int pid, struct PhotonMap *Global, struct application *ap)
 {
-    static int sem_photonmap = 0;
-    if (!sem_photonmap)
-	sem_photonmap = bu_semaphore_register("sem_photonmap");
+    uint64_t Rand;
+    int i, End, Step;
 
-    if (!Node)
-	return;
+    Step = Global->MaxPhotons/8;
+    while (1) {
+	bu_semaphore_acquire(sem_photonmap);
+	i = ICSize;
+	ICSize += PM_IC_CHUNK;
+	bu_semaphore_release(sem_photonmap);
 
-    /* Determine if this pt will be used by calculating a weight */
-    bu_semaphore_acquire(sem_photonmap);
-    if (!Node->C) {
-	ICSize++;
-	Node->C++;
+	if (i >= Global->StoredPhotons)
+	    return;
+	End = i + PM_IC_CHUNK < Global->StoredPhotons ? i + PM_IC_CHUNK : Global->StoredPhotons;
 #ifndef HAVE_ALARM
-	if (!(ICSize%(PMap[PM_GLOBAL]->MaxPhotons/8)))
-	    bu_log("    Irradiance Cache Progress: %d%%\n", (int)(0.5+100.0*ICSize/PMap[PM_GLOBAL]->MaxPhotons));
+	if (Step > 0 && i/Step != End/Step)
+	    bu_log("    Irradiance Cache Progress: %d%%\n", (int)(0.5+100.0*End/Global->MaxPhotons));
 #endif
-	bu_semaphore_release(sem_photonmap);
-	Irradiance(pid, &Node->P, ap);
-    } else {
-	bu_semaphore_release(sem_photonmap);
+	Rand = PSeed(PMSeed, PM_STREAMS + i/PM_IC_CHUNK);
+	for (; i < End; i++)
+	    Irradiance(pid, &Global->Photons[i], ap, &Rand);
     }
-
-    BuildIrradianceCache(pid, Node->L, ap);
-    BuildIrradianceCache(pid, Node->R, ap);
 }
 
 
@@ -1144,16 +1337,7 @@ alarmhandler(int sig)
 void
 IrradianceThread(int pid, void *arg)
 {
-#ifdef HAVE_ALARM
-    starttime = time(NULL);
-    signal(SIGALRM, alarmhandler);
-    alarm(60);
-    BuildIrradianceCache(pid, PMap[PM_GLOBAL]->Root, (struct application*)arg);
-    alarm(0);
-    starttime = 0;
-#else
-    BuildIrradianceCache(pid, PMap[PM_GLOBAL]->Root, (struct application*)arg);
-#endif
+    BuildIrradianceCache(pid, PMap[PM_GLOBAL], (struct application*)arg);
 }
 
 
@@ -1162,18 +1346,17 @@ Initialize(int MAP, int MapSize)
 {
     BU_ALLOC(PMap[MAP], struct PhotonMap);
     PMap[MAP]->MaxPhotons = MapSize;
-
-    BU_ALLOC(PMap[MAP]->Root, struct PNode);
     PMap[MAP]->StoredPhotons = 0;
+    PMap[MAP]->Photons = NULL;
     if (MapSize > 0)
-	BU_ALLOC(Emit[MAP], struct Photon);
+	Emit[MAP] = (struct Photon *)bu_calloc(MapSize, sizeof(struct Photon), "Photons");
     else
 	Emit[MAP] = NULL;
 }
 
 
 int
-LoadFile(char *pmfile)
+LoadFile(char *pmfile, int cpus)
 {
     size_t ret;
     FILE *FH;
@@ -1261,11 +1444,12 @@ LoadFile(char *pmfile)
 	    }
 	}
 
-	PMap[PM_GLOBAL]->StoredPhotons = PMap[PM_GLOBAL]->MaxPhotons;
-	BuildTree(Emit[PM_GLOBAL], PMap[PM_GLOBAL]->StoredPhotons, PMap[PM_GLOBAL]->Root);
-
-	PMap[PM_CAUSTIC]->StoredPhotons = PMap[PM_CAUSTIC]->MaxPhotons;
-	BuildTree(Emit[PM_CAUSTIC], PMap[PM_CAUSTIC]->StoredPhotons, PMap[PM_CAUSTIC]->Root);
+	for (i = PM_GLOBAL; i <= PM_CAUSTIC; i++) {
+	    PMap[i]->StoredPhotons = PMap[i]->MaxPhotons;
+	    BuildTree(Emit[i], PMap[i]->StoredPhotons, cpus);
+	    PMap[i]->Photons = Emit[i];
+	    Emit[i] = NULL;
+	}
 	fclose(FH);
 	return 1;
     }
@@ -1275,17 +1459,13 @@ LoadFile(char *pmfile)
 
 
 void
-WritePhotons(struct PNode *Root, FILE *FH)
+WritePhotons(struct PhotonMap *Map, FILE *FH)
 {
     size_t ret;
-    if (!Root)
-	return;
 
-    ret = fwrite(&Root->P, sizeof(struct Photon), 1, FH);
-    if (ret != 1)
+    ret = fwrite(Map->Photons, sizeof(struct Photon), Map->StoredPhotons, FH);
+    if (ret != (size_t)Map->StoredPhotons)
 	bu_log("Unable to write photons\n");
-    WritePhotons(Root->L, FH);
-    WritePhotons(Root->R, FH);
 }
 
 
@@ -1331,7 +1511,7 @@ WritePhotonFile(char *pmfile)
 
 	/* Write each photon to file */
 	if (PMap[PM_GLOBAL]->StoredPhotons)
-	    WritePhotons(PMap[PM_GLOBAL]->Root, FH);
+	    WritePhotons(PMap[PM_GLOBAL], FH);
 
 	/* === Write PM_CAUSTIC Data === */
 	C1 = PM_CAUSTIC;
@@ -1347,7 +1527,7 @@ WritePhotonFile(char *pmfile)
 
 	/* Write each photon to file */
 	if (PMap[PM_CAUSTIC]->StoredPhotons)
-	    WritePhotons(PMap[PM_CAUSTIC]->Root, FH);
+	    WritePhotons(PMap[PM_CAUSTIC], FH);
 
 	fclose(FH);
     }
@@ -1360,7 +1540,9 @@ WritePhotonFile(char *pmfile)
 void
 BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int height, int UNUSED(Hypersample), int GlobalPhotons, double CausticsPercent, int Rays, double AngularTolerance, int RandomSeed, int ImportanceMapping, int IrradianceHypersampling, int VisualizeIrradiance, double ScaleIndirect, char pmfile[255])
 {
-    int i, MapSize[PM_MAPS];
+    struct PhotonThread *T;
+    struct PhotonEmit E;
+    int i, j, Off, MapSize[PM_MAPS];
     double ratio;
 
     PM_Visualize = VisualizeIrradiance;
@@ -1368,9 +1550,16 @@ BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int
     GPM_WIDTH = width;
     GPM_HEIGHT = height;
 
+    if (!sem_photonmap)
+	sem_photonmap = bu_semaphore_register("sem_photonmap");
+    if (cpus < 1)
+	cpus = 1;
+    if (cpus > MAX_PSW)
+	cpus = MAX_PSW;
+
     /* If the user has specified a cache file then first check to see if there is any valid data within it,
        otherwise utilize the file to push the resulting irradiance cache data into for future use. */
-    if (!LoadFile(pmfile)) {
+    if (!LoadFile(pmfile, cpus)) {
 	/*
 	  bu_log("pos: [%.3f, %.3f, %.3f]\n", eye_pos[0], eye_pos[1], eye_pos[2]);
 	  bu_log("I, V, Imp, H: %.3f, %d, %d, %d\n", LightIntensity, VisualizeIrradiance, ImportanceMapping, IrradianceHypersampling);
@@ -1380,26 +1569,13 @@ BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int
 
 	GPM_RAYS = Rays;
 	GPM_ATOL = cos(AngularTolerance*DEG2RAD);
-
-	PInit = 1;
-
-#ifndef HAVE_SRAND48
-	srand(RandomSeed);
-#else
-	srand48(RandomSeed);
-#endif
-	/* bu_log("Photon Structure Size: %d\n", sizeof(struct PNode));*/
+	PMSeed = RandomSeed;
 
 	/*
 	  bu_log("Checking application struct\n");
 	  RT_CK_APPLICATION(ap);
 	*/
 
-	/* Initialize Emitted Photons for each map to 0 */
-	EPL = 0;
-	for (i = 0; i < PM_MAPS; i++)
-	    EPS[i] = 0;
-
 	CausticsPercent /= 100.0;
 	MapSize[PM_IMPORTANCE] = GlobalPhotons/8;
 	MapSize[PM_GLOBAL] = (int)((1.0-CausticsPercent)*GlobalPhotons);
@@ -1413,6 +1589,25 @@ BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int
 	Initialize(PM_SHADOW, MapSize[PM_SHADOW]);
 	Initialize(PM_IMPORTANCE, MapSize[PM_IMPORTANCE]);
 
+	memset(GPM_RTAB, 0, sizeof(GPM_RTAB));
+	for (i = 0; i < cpus; i++)
+	    rt_init_resource(&GPM_RTAB[i], i, ap->a_rt_i);
+
+	/* Each stream gets an even share of every map */
+	T = (struct PhotonThread *)bu_calloc(PM_STREAMS, sizeof(struct PhotonThread), "PhotonThread");
+	for (i = 0; i < PM_STREAMS; i++) {
+	    T[i].PInit = 1;
+	    T[i].Rand = PSeed(RandomSeed, i);
+	}
+	for (j = 0; j < PM_MAPS; j++) {
+	    Off = 0;
+	    for (i = 0; i < PM_STREAMS; i++) {
+		T[i].Off[j] = Off;
+		T[i].Max[j] = MapSize[j]/PM_STREAMS + (i < MapSize[j]%PM_STREAMS);
+		Off += T[i].Max[j];
+	    }
+	}
+
 	/* Populate Application Structure */
 	/* Set Recursion Level, Magic Number, Hit/Miss Callbacks, and Purpose */
 	ap->a_level = 1;
@@ -1423,18 +1618,51 @@ BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int
 	ap->a_logoverlap = rt_silent_logoverlap;
 	ap->a_purpose = "Importance Mapping";
 
+	E.ap = ap;
+	E.T = T;
+	VMOVE(E.Eye, eye_pos);
+	E.ScaleIndirect = ScaleIndirect;
 
 	if (ImportanceMapping) {
 	    bu_log("  Building Importance Map...\n");
-	    EmitImportonsRandom(ap, eye_pos);
-	    BuildTree(Emit[PM_IMPORTANCE], PMap[PM_IMPORTANCE]->StoredPhotons, PMap[PM_IMPORTANCE]->Root);
+	    E.Importons = 1;
+	    E.Next = 0;
+	    if (cpus > 1)
+		bu_parallel(EmitThread, cpus, &E);
+	    else
+		EmitThread(0, &E);
+	    MergePhotons(T, PM_IMPORTANCE);
+	    BuildTree(Emit[PM_IMPORTANCE], PMap[PM_IMPORTANCE]->StoredPhotons, cpus);
+	    PMap[PM_IMPORTANCE]->Photons = Emit[PM_IMPORTANCE];
+	    MergeBounds(T);
 	    ScaleFactor = MaxFloat(BBMax[0]-BBMin[0], BBMax[1]-BBMin[1], BBMax[2]-BBMin[2]);
 	}
 
-	HitG = HitB = 0;
+	for (i = 0; i < PM_STREAMS; i++)
+	    T[i].HitG = T[i].HitB = 0;
 	bu_log("  Emitting Photons...\n");
-	EmitPhotonsRandom(ap, ScaleIndirect);
-	/* EmitPhotonsRandom(ap, &(LightHead.l), LightIntensity);*/
+	E.Importons = 0;
+	E.Next = 0;
+	if (cpus > 1)
+	    bu_parallel(EmitThread, cpus, &E);
+	else
+	    EmitThread(0, &E);
+
+	/* Gather what the streams emitted and stored */
+	EPL = HitG = HitB = 0;
+	for (j = 0; j < PM_MAPS; j++)
+	    EPS[j] = 0;
+	for (i = 0; i < PM_STREAMS; i++) {
+	    EPL += T[i].EPL;
+	    HitG += T[i].HitG;
+	    HitB += T[i].HitB;
+	    for (j = 0; j < PM_MAPS; j++)
+		EPS[j] += T[i].EPS[j];
+	}
+	MergePhotons(T, PM_GLOBAL);
+	MergePhotons(T, PM_CAUSTIC);
+	MergeBounds(T);
+	bu_free(T, "PhotonThread");
 
 	/* Generate Scale Factor */
 	ScaleFactor = MaxFloat(BBMax[0]-BBMin[0], BBMax[1]-BBMin[1], BBMax[2]-BBMin[2]);
@@ -1458,9 +1686,10 @@ BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int
 
 	bu_log("  Building KD-Tree...\n");
 	/* Balance KD-Tree */
-	for (i = 0; i < 3; i++)
-	    if (PMap[i]->StoredPhotons)
-		BuildTree(Emit[i], PMap[i]->StoredPhotons, PMap[i]->Root);
+	for (i = 0; i < 3; i++) {
+	    BuildTree(Emit[i], PMap[i]->StoredPhotons, cpus);
+	    PMap[i]->Photons = Emit[i];
+	}
 
 
 	bu_log("  Building Irradiance Cache...\n");
@@ -1472,16 +1701,21 @@ BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int
 	ap->a_logoverlap = rt_silent_logoverlap;
 	ICSize = 0;
 
+#ifdef HAVE_ALARM
+	starttime = time(NULL);
+	signal(SIGALRM, alarmhandler);
+	alarm(60);
+#endif
 	if (cpus > 1) {
-	    memset(GPM_RTAB, 0, sizeof(GPM_RTAB));
-	    for (i = 0; i < MAX_PSW; i++) {
-		rt_init_resource(&GPM_RTAB[i], i, ap->a_rt_i);
-	    }
 	    bu_parallel(IrradianceThread, cpus, ap);
 	} else {
 	    /* This will allow profiling for single threaded rendering */
 	    IrradianceThread(0, ap);
 	}
+#ifdef HAVE_ALARM
+	alarm(0);
+	starttime = 0;
+#endif
 
 	/* Allocate Memory for Irradiance Cache and Initialize Pixel Map */
 	/* bu_log("Image Size: %d, %d\n", width, height);*/
@@ -1494,89 +1728,13 @@ BuildPhotonMap(struct application *ap, point_t eye_pos, int cpus, int width, int
 	    }
 	}
 
-
-	/*
-	  bu_log("  Sanity Check...\n");
-	  SanityCheck(PMap[PM_GLOBAL]->Root, 0);
-	*/
-
 	WritePhotonFile(pmfile);
 
-	for (i = 0; i < PM_MAPS; i++) {
-	    bu_free(Emit[i], "Photons");
+	/* The trees were balanced in place, and now own the photons */
+	for (i = 0; i < PM_MAPS; i++)
 	    Emit[i] = NULL;
-	}
-
-    }
-}
-
-
-void
-Swap(struct PSN *a, struct PSN *b)
-{
-    struct PSN c;
-
-    /*
-      c.P = a->P;
-      c.Dist = a->Dist;
-      a->P = b->P;
-      a->Dist = b->Dist;
-      b->P = c.P;
-      b->Dist = c.Dist;
-    */
-    /* bu_log("  SWAP_IN: %.3f, %.3f\n", a->Dist, b->Dist);*/
-    memcpy(&c, a, sizeof(struct PSN));
-    memcpy(a, b, sizeof(struct PSN));
-    memcpy(b, &c, sizeof(struct PSN));
-    /* bu_log("  SWAP_OT: %.3f, %.3f\n", a->Dist, b->Dist);*/
-}
-
-
-/*
-  After inserting a new node it must be brought upwards until both children
-  are less than it.
-*/
-void
-HeapUp(struct PhotonSearch *S, int ind)
-{
-    int i;
-
-    if (!ind)
-	return;
-
-    i = ((ind+1)-(ind+1)%2)/2-1;
-    /* bu_log("  CHECK: %.3f > %.3f :: [%d] > [%d]\n", S->List[ind].Dist, S->List[i].Dist, ind, i);*/
-    if (S->List[ind].Dist > S->List[i].Dist) {
-	/* bu_log("SWAP_A: %.3f, %.3f\n", S->List[i].Dist, S->List[ind].Dist);*/
-	Swap(&S->List[i], &S->List[ind]);
-	/* bu_log("SWAP_B: %.3f, %.3f\n", S->List[i].Dist, S->List[ind].Dist);*/
-    }
-    HeapUp(S, i);
-}
-
-
-/*
-  Sift the new Root node down, by choosing the child with the highest number
-  since choosing a child with the highest number may reduce the number of
-  recursions the number will have to propagate
-*/
-void
-HeapDown(struct PhotonSearch *S, int ind)
-{
-    int c;
-
-    if (2*ind+1 > S->Found)
-	return;
-
-    c = 2*ind+1 < S->Found ? S->List[2*ind+2].Dist > S->List[2*ind+1].Dist ? 2*ind+2 : 2*ind+1 : 2*ind+1;
-    /* bu_log(" c: %d\n", c);*/
 
-    if (S->List[c].Dist > S->List[ind].Dist) {
-	/* bu_log("SWAP_C: %.3f, %.3f :: %d, %d :: %d\n", S->List[c].Dist, S->List[ind].Dist, c, ind, S->Found);*/
-	Swap(&S->List[c], &S->List[ind]);
-	/* bu_log("SWAP_D: %.3f, %.3f :: %d, %d :: %d\n", S->List[c].Dist, S->List[ind].Dist, c, ind, S->Found);*/
     }
-    HeapDown(S, c);
 }
 
 
@@ -1645,34 +1803,34 @@ IrradianceEstimate(struct application *ap, vect_t irrad, point_t pos, vect_t nor
     do {
 	Search.Found = 0;
 	Search.RadSq *= 4.0;
-	LocatePhotons(&Search, PMap[PM_GLOBAL]->Root);
+	LocatePhotons(&Search, PMap[PM_GLOBAL]->Photons, 0, PMap[PM_GLOBAL]->StoredPhotons);
     } while (Search.Found < Search.Max && Search.RadSq < ScaleFactor * ScaleFactor / 64.0);
 
 
     irrad[0] = irrad[1] = irrad[2] = 0;
     TotDist = 0;
     for (i = 0; i < Search.Found; i++) {
-	t[0] = Search.List[i].P.Pos[0] - pos[0];
-	t[1] = Search.List[i].P.Pos[1] - pos[1];
-	t[2] = Search.List[i].P.Pos[2] - pos[2];
+	t[0] = Search.List[i].P->Pos[0] - pos[0];
+	t[1] = Search.List[i].P->Pos[1] - pos[1];
+	t[2] = Search.List[i].P->Pos[2] - pos[2];
 	TotDist += t[0]*t[0] + t[1]*t[1] + t[2]*t[2];
     }
 
 
     for (i = 0; i < Search.Found; i++) {
-	t[0] = Search.List[i].P.Pos[0] - pos[0];
-	t[1] = Search.List[i].P.Pos[1] - pos[1];
-	t[2] = Search.List[i].P.Pos[2] - pos[2];
+	t[0] = Search.List[i].P->Pos[0] - pos[0];
+	t[1] = Search.List[i].P->Pos[1] - pos[1];
+	t[2] = Search.List[i].P->Pos[2] - pos[2];
 
 	t[0] = (t[0]*t[0] + t[1]*t[1] + t[2]*t[2])/TotDist;
 	/*
-	  irrad[0] += Search.List[i].P.Irrad[0] * t[0];
-	  irrad[1] += Search.List[i].P.Irrad[1] * t[0];
-	  irrad[2] += Search.List[i].P.Irrad[2] * t[0];
+	  irrad[0] += Search.List[i].P->Irrad[0] * t[0];
+	  irrad[1] += Search.List[i].P->Irrad[1] * t[0];
+	  irrad[2] += Search.List[i].P->Irrad[2] * t[0];
 	*/
-	irrad[0] += Search.List[i].P.Irrad[0];
-	irrad[1] += Search.List[i].P.Irrad[1];
-	irrad[2] += Search.List[i].P.Irrad[2];
+	irrad[0] += Search.List[i].P->Irrad[0];
+	irrad[1] += Search.List[i].P->Irrad[1];
+	irrad[2] += Search.List[i].P->Irrad[2];
     }
     if (Search.Found) {
 	irrad[0] /= (double)Search.Found;
@@ -42,10 +42,19 @@
 
 #define LIGHT_O(m) bu_offsetof(struct light_specific, m)
 
+/* Partitions of a light visibility ray ending this close to its start
+ * are the surface being lit.  light_hit() and the occlusion query in
+ * light_vis_shoot() both skip them, so the two paths agree.
+ */
+#define LIGHT_SURFACE_DIST(_ap) (10 * (_ap)->a_rt_i->rti_tol.dist)
+
 
 /** Heads linked list of lights */
 struct light_specific LightHead;
 
+/** Set by applications that defer light visibility rays */
+struct light_defer *light_defer = NULL;
+
 /* local sp_hook functions */
 /* for light_print_tab and light_parse callbacks */
 static void aim_set(const struct bu_structparse *, const char *, void *, const char *, void *);
@@ -875,14 +884,13 @@ light_hit(struct application *ap, struct partition *PartHeadp, struct seg *finis
      * Since the light visibility ray started at the surface of a
      * solid, it is likely that the solid will be the first partition
      * on the list, with pt_outhit->hit_dist being roughly zero.
-     * Don't start using partitions until pt_inhit->hit_dist is
-     * slightly larger than zero, i.e., that the partition is not
-     * including the start point.
+     * Don't start using partitions until pt_outhit->hit_dist is
+     * past LIGHT_SURFACE_DIST, i.e., that the partition is not just
+     * the start point.
      *
-     * The outhit distance needs to be checked too, so that if the
-     * partition is heading through the solid toward the light
-     * e.g. (-1, +50), then the fact that the light is obscured will
-     * not be missed.
+     * Checking the outhit distance means that if the partition is
+     * heading through the solid toward the light e.g. (-1, +50), the
+     * fact that the light is obscured will not be missed.
      */
     for (pp=PartHeadp->pt_forw; pp != PartHeadp; pp = pp->pt_forw) {
 	if (pp->pt_regionp->reg_aircode != 0) {
@@ -906,9 +914,7 @@ light_hit(struct application *ap, struct partition *PartHeadp, struct seg *finis
 	    VSCALE(filter_color, filter_color, sw.sw_transmit);
 	    continue;
 	}
-	if (pp->pt_inhit->hit_dist >= ap->a_rt_i->rti_tol.dist)
-	    break;
-	if (pp->pt_outhit->hit_dist >= ap->a_rt_i->rti_tol.dist*10)
+	if (pp->pt_outhit->hit_dist > LIGHT_SURFACE_DIST(ap))
 	    break;
     }
 
@@ -936,7 +942,7 @@ light_hit(struct application *ap, struct partition *PartHeadp, struct seg *finis
 	    goto out;
 	}
 
-	if (pp->pt_inhit->hit_dist <= ap->a_rt_i->rti_tol.dist) {
+	if (pp->pt_inhit->hit_dist <= LIGHT_SURFACE_DIST(ap)) {
 	    int retval;
 	    /* XXX This is bogus if air is being used */
 
@@ -1134,20 +1140,43 @@ light_miss(register struct application *ap)
 #define VF_BACKFACE 2
 
 /**
- * Compute 1 light visibility ray from a hit point to the light.
- * Called by light_obs() to determine light visibility.
+ * Occluder test for rt_shootray_occluded(): regions that can only block
+ * a light visibility ray outright - not air, not transparent or
+ * procedurally shaded, and not a light source themselves.
  */
 static int
-light_vis(struct light_obs_stuff *los, char *flags)
+light_occluder(struct application *UNUSED(ap), const struct region *regp)
+{
+    const struct mfuncs *mfp = (const struct mfuncs *)regp->reg_mfuncs;
+    struct light_specific *lsp;
+
+    if (regp->reg_aircode != 0 || regp->reg_transmit)
+	return 0;
+    if (!mfp || (mfp->mf_flags & MFF_PROC))
+	return 0;
+    for (BU_LIST_FOR(lsp, light_specific, &(LightHead.l))) {
+	if (lsp->lt_rp == regp)
+	    return 0;
+    }
+    return 1;
+}
+
+
+/**
+ * Pick 1 light visibility ray from a hit point to the light.  Returns
+ * 1 with the ray to shoot in rp, 0 if the light can't be seen from the
+ * hit point this way, or -1 for a fill light, which is always seen.
+ */
+static int
+light_vis_ray(struct light_obs_stuff *los, char *flags, struct light_vis_ray *rp)
 {
     const double cosine89_99deg = 0.0001745329;
-    struct application sub_ap;
     double radius = 0.0;
     double angle = 0.0;
     double cos_angle, x, y;
     point_t shoot_pt;
     vect_t shoot_dir;
-    int shot_status;
+    fastf_t shoot_dist;
     vect_t dir, rdir;
     int idx;
     int k = 0;
@@ -1347,6 +1376,7 @@ light_vis(struct light_obs_stuff *los, char *flags)
 	bu_semaphore_release(BU_SEM_SYSCALL);
     }
 
+    shoot_dist = (los->lsp->lt_infinite) ? INFINITY : MAGNITUDE(shoot_dir);
     VUNITIZE(shoot_dir);
 
     /*
@@ -1373,43 +1403,77 @@ light_vis(struct light_obs_stuff *los, char *flags)
 	return -1;
     }
 
+    /* Advance start point slightly off surface */
+    VJOIN1(rp->lv_pt, los->swp->sw_hit.hit_point, los->ap->a_rt_i->rti_tol.dist, shoot_dir);
+    VMOVE(rp->lv_dir, shoot_dir);
+    rp->lv_dist = shoot_dist;
+    rp->lv_rbeam = los->ap->a_rbeam + los->swp->sw_hit.hit_dist * los->ap->a_diverge;
+    rp->lv_lsp = los->lsp;
+
+    return 1;
+}
+
+
+int
+light_vis_shoot(struct application *ap, const struct light_vis_ray *rp, vect_t inten)
+{
+    struct application sub_ap;
+    struct light_specific *lsp = rp->lv_lsp;
+    int shot_status;
+
+    RT_CK_LIGHT(lsp);
 
     /*
      * Fire ray at light source to check for shadowing.
      * (This SHOULD actually return an energy spectrum).
-     * Advance start point slightly off surface.
      */
-    sub_ap = *los->ap;			/* struct copy */
+    sub_ap = *ap;			/* struct copy */
     RT_CK_AP(&sub_ap);
 
-    VMOVE(sub_ap.a_ray.r_dir, shoot_dir);
-    {
-	register fastf_t f;
-	f = los->ap->a_rt_i->rti_tol.dist;
-	VJOIN1(sub_ap.a_ray.r_pt, los->swp->sw_hit.hit_point, f,
-	       shoot_dir);
-    }
-    sub_ap.a_rbeam = los->ap->a_rbeam +
-	los->swp->sw_hit.hit_dist *
-	los->ap->a_diverge;
-    sub_ap.a_diverge = los->ap->a_diverge;
+    VMOVE(sub_ap.a_ray.r_pt, rp->lv_pt);
+    VMOVE(sub_ap.a_ray.r_dir, rp->lv_dir);
+    sub_ap.a_rbeam = rp->lv_rbeam;
+    sub_ap.a_diverge = ap->a_diverge;
 
     sub_ap.a_hit = light_hit;
     sub_ap.a_miss = light_miss;
-    sub_ap.a_logoverlap = los->ap->a_logoverlap;
+    sub_ap.a_logoverlap = ap->a_logoverlap;
     sub_ap.a_user = -1; /* sanity */
-    sub_ap.a_uptr = (void *)los->lsp;	/* so we can tell.. */
+    sub_ap.a_uptr = (void *)lsp;	/* so we can tell.. */
     sub_ap.a_level = 0;
     /* Will need entry & exit pts, for filter glass ==> 2 */
     /* Continue going through air ==> negative */
     sub_ap.a_onehit = -2;
 
     VSETALL(sub_ap.a_color, 1);	/* vis intens so far */
-    sub_ap.a_purpose = los->lsp->lt_name;	/* name of light shot at */
+    sub_ap.a_purpose = lsp->lt_name;	/* name of light shot at */
 
     RT_CK_LIGHT((struct light_specific *)(sub_ap.a_uptr));
     RT_CK_AP(&sub_ap);
 
+    /* Invisible and infinite lights can't be hit, so an occlusion
+     * query settles the usual cases without shading anything: an
+     * opaque region in the way means dark, and nothing at all in the
+     * way means full intensity.  Whatever else is in the way (air,
+     * transparent regions) needs the full ray to filter the light.
+     * Partitions within LIGHT_SURFACE_DIST of the start point are the
+     * surface being lit, as in light_hit().
+     */
+    if (lsp->lt_invisible || lsp->lt_infinite) {
+	int occluded = rt_shootray_occluded(&sub_ap, LIGHT_SURFACE_DIST(ap), rp->lv_dist, light_occluder);
+	if (occluded > 0) {
+	    if (optical_debug & OPTICAL_DEBUG_LIGHT)
+		bu_log("light occluded: %s\n", lsp->lt_name);
+	    return 0;
+	}
+	if (occluded == 0) {
+	    if (optical_debug & OPTICAL_DEBUG_LIGHT)
+		bu_log("light unobstructed: %s\n", lsp->lt_name);
+	    VSETALL(inten, 1);
+	    return 1;
+	}
+    }
+
     if (optical_debug & OPTICAL_DEBUG_LIGHT)
 	bu_log("shooting level %d from %d\n", sub_ap.a_level, __LINE__);
 
@@ -1419,21 +1483,39 @@ light_vis(struct light_obs_stuff *los, char *flags)
     if (shot_status > 0) {
 	/* light visible */
 	if (optical_debug & OPTICAL_DEBUG_LIGHT)
-	    bu_log("light visible: %s\n", los->lsp->lt_name);
+	    bu_log("light visible: %s\n", lsp->lt_name);
 
-	VMOVE(los->inten, sub_ap.a_color);
+	VMOVE(inten, sub_ap.a_color);
 
 	return 1;
     }
 
     /* dark (light obscured) */
     if (optical_debug & OPTICAL_DEBUG_LIGHT)
-	bu_log("light obscured: %s\n", los->lsp->lt_name);
+	bu_log("light obscured: %s\n", lsp->lt_name);
 
     return 0;
 }
 
 
+/**
+ * Compute 1 light visibility ray from a hit point to the light.
+ * Called by light_obs() to determine light visibility.
+ */
+static int
+light_vis(struct light_obs_stuff *los, char *flags)
+{
+    struct light_vis_ray ray;
+    int ret;
+
+    ret = light_vis_ray(los, flags, &ray);
+    if (ret <= 0)
+	return ret;
+
+    return light_vis_shoot(los->ap, &ray, los->inten);
+}
+
+
 /**
  * Determine the visibility of each light source in the scene from a
  * particular location.  It is up to the caller to apply
@@ -1450,16 +1532,20 @@ light_vis(struct light_obs_stuff *los, char *flags)
  * a_rti_i->rti_tol
  * a_rbeam
  * a_diverge
+ *
+ * With deferred set, lights light_defer takes are marked in it.
  */
-void
-light_obs(struct application *ap, struct shadework *swp, int have)
+static int
+light_obs_lights(struct application *ap, struct shadework *swp, int have, char *deferred)
 {
     register struct light_specific *lsp;
     register int i;
     register fastf_t *tl_p;
     int vis_ray;
     int tot_vis_rays;
+    int shoot_rays;
     int visibility;
+    int ndeferred = 0;
     struct light_obs_stuff los = {NULL, NULL, NULL, NULL, NULL, 0, VINIT_ZERO, VINIT_ZERO, VINIT_ZERO};
     static int rand_idx;
     int flag_size = 0;
@@ -1467,6 +1553,9 @@ light_obs(struct application *ap, struct shadework *swp, int have)
     /* use a constant buffer to minimize number of malloc/free calls per ray */
     char static_flags[SOME_LIGHT_SAMPLES] = {0};
     char *flags = static_flags;
+    struct light_vis_ray static_rays[SOME_LIGHT_SAMPLES];
+    struct light_vis_ray *rays = static_rays;
+    int ray_size = SOME_LIGHT_SAMPLES;
 
     if (optical_debug & OPTICAL_DEBUG_LIGHT) {
 	bu_log("computing Light obscuration: start\n");
@@ -1537,10 +1626,50 @@ light_obs(struct application *ap, struct shadework *swp, int have)
 	}
 
 	visibility = 0;
+	shoot_rays = tot_vis_rays;
 	if (flag_size > 0) {
 	    memset(flags, 0, flag_size * sizeof(char));
 	}
-	for (vis_ray = 0; vis_ray < tot_vis_rays; vis_ray ++) {
+
+	/* Pick all the rays up front, and have them shot later if
+	 * light_defer takes them */
+	if (deferred && light_defer && lsp->lt_shadows && (lsp->lt_invisible || lsp->lt_infinite)) {
+	    int nrays = 0;
+
+	    if (tot_vis_rays > ray_size) {
+		if (rays != static_rays)
+		    bu_free(rays, "free rays array");
+		ray_size = tot_vis_rays;
+		rays = (struct light_vis_ray *)bu_malloc(ray_size * sizeof(struct light_vis_ray), "allocate rays array");
+	    }
+	    for (vis_ray = 0; vis_ray < tot_vis_rays; vis_ray++) {
+		los.iter = vis_ray;
+		if (light_vis_ray(&los, flags, &rays[nrays]) > 0)
+		    nrays++;
+	    }
+
+	    if ((*light_defer->ld_rays)(ap, i, tot_vis_rays, rays, nrays) == 0) {
+		deferred[i] = 1;
+		ndeferred++;
+		VMOVE(tl_p, los.to_light_center);
+		VSETALL(los.inten, 1);
+		swp->sw_visible[i] = lsp;
+		swp->sw_lightfract[i] = 1.0;
+		tl_p += 3;
+		i++;
+		continue;
+	    }
+
+	    for (vis_ray = 0; vis_ray < nrays; vis_ray++) {
+		if (light_vis_shoot(ap, &rays[vis_ray], los.inten) > 0) {
+		    VMOVE(tl_p, los.to_light_center);
+		    visibility++;
+		}
+	    }
+	    shoot_rays = 0;
+	}
+
+	for (vis_ray = 0; vis_ray < shoot_rays; vis_ray ++) {
 	    int lv;
 	    los.iter = vis_ray;
 
@@ -1584,8 +1713,28 @@ light_obs(struct application *ap, struct shadework *swp, int have)
     if (flags && flags != static_flags) {
 	bu_free(flags, "free flags array");
     }
+    if (rays != static_rays) {
+	bu_free(rays, "free rays array");
+    }
 
     if (optical_debug & OPTICAL_DEBUG_LIGHT) bu_log("computing Light obscuration: end\n");
+
+    return ndeferred;
+}
+
+
+void
+light_obs(struct application *ap, struct shadework *swp, int have)
+{
+    (void)light_obs_lights(ap, swp, have, NULL);
+}
+
+
+int
+light_obs_defer(struct application *ap, struct shadework *swp, int have, char deferred[SW_NLIGHTS])
+{
+    memset(deferred, 0, SW_NLIGHTS);
+    return light_obs_lights(ap, swp, have, deferred);
 }
 
 
@@ -275,6 +275,9 @@ phong_render(register struct application *ap, const struct partition *pp, struct
     size_t i;
     vect_t reflected;
     vect_t work;
+    char deferred[SW_NLIGHTS] = {0};
+    vect_t term;
+    fastf_t *sum;
 
     point_t matcolor;		/* Material color */
     struct phong_specific *ps =
@@ -341,8 +344,17 @@ phong_render(register struct application *ap, const struct partition *pp, struct
 	 * provide us reliable light visibility information.  The hit point
 	 * may have been changed by another shader in a stack.  There is no
 	 * way that anyone else can tell us whether lights are visible.
+	 *
+	 * The color is a plain sum over the lights unless it gets mixed
+	 * with reflections or clamped for photon mapping, or another
+	 * shader in a stack works on it, so only then can the lights be
+	 * left to light_defer.
 	 */
-	light_obs(ap, swp, ps->mfp->mf_inputs);
+	if (light_defer && !PM_Activated && swp->sw_reflect <= 0 && swp->sw_transmit <= 0 &&
+	    ((const struct mfuncs *)pp->pt_regionp->reg_mfuncs)->mf_render == phong_render)
+	    (void)light_obs_defer(ap, swp, ps->mfp->mf_inputs, deferred);
+	else
+	    light_obs(ap, swp, ps->mfp->mf_inputs);
 
 	/* Consider effects of each light source */
 	for (i = 0; i < ap->a_rt_i->rti_nlights; i++) {
@@ -355,9 +367,15 @@ phong_render(register struct application *ap, const struct partition *pp, struct
 		       lp->lt_name, swp->sw_lightfract[i]);
 	    }
 
-	    /* Light is not shadowed -- add this contribution */
+	    /* Light is not shadowed -- add this contribution, or hand
+	     * it to light_defer to be scaled by its visibility */
 	    intensity = swp->sw_intensity+3*i;
 	    to_light = swp->sw_tolight+3*i;
+	    sum = swp->sw_color;
+	    if (i < SW_NLIGHTS && deferred[i]) {
+		VSETALL(term, 0);
+		sum = term;
+	    }
 
 	    /* Diffuse reflectance from this light source. */
 	    if ((cosine=VDOT(swp->sw_hit.hit_normal, to_light)) > 0.0) {
@@ -379,7 +397,7 @@ phong_render(register struct application *ap, const struct partition *pp, struct
 		}
 
 		VELMUL3(work, matcolor, lp->lt_color, intensity);
-		VJOIN1(swp->sw_color, swp->sw_color, refl, work);
+		VJOIN1(sum, sum, refl, work);
 	    }
 
 	    /* Calculate specular reflectance.
@@ -410,8 +428,11 @@ phong_render(register struct application *ap, const struct partition *pp, struct
 		phg_ipow(cosine, ps->shine);
 #endif /* PHAST_PHONG */
 		VELMUL(work, lp->lt_color, intensity);
-		VJOIN1(swp->sw_color, swp->sw_color, refl, work);
+		VJOIN1(sum, sum, refl, work);
 	    }
+
+	    if (sum == term)
+		(*light_defer->ld_term)(ap, (int)i, term);
 	}
 
 	if (PM_Activated) {
@@ -79,8 +79,13 @@
 
 #include <errno.h>
 
+#if !defined(__STDC_NO_ATOMICS__)
+#  include <stdatomic.h>
+#endif
+
 #include "bio.h"
 
+#include "bu/tc.h"
 #include "pkg.h"
 
 #if defined(HAVE_GETHOSTBYNAME) && !defined(HAVE_DECL_GETHOSTBYNAME) && !defined(_WINSOCKAPI_)
@@ -825,6 +830,10 @@ pkg_close(struct pkg_conn *pc)
 	fflush(_pkg_debug);
     }
 
+    /* Stop the transport threads, writing any queued output */
+    if (pc->pkc_async)
+	(void)pkg_async_stop(pc);
+
     /* Flush any queued stream output first. */
     if (pc->pkc_strpos > 0) {
 	(void)pkg_flush(pc);
@@ -962,6 +971,566 @@ _pkg_checkin(struct pkg_conn *pc, int nodelay)
 }
 
 
+/*
+ * Asynchronous transport, see pkg_async_start().
+ *
+ * Outgoing messages are queued on a linked list under a mutex; the
+ * sender thread takes the whole list at once and writes it with as
+ * few writev() calls as PKG_ASYNC_IOV allows.  Incoming messages are
+ * framed by the receiver thread into a single producer, single
+ * consumer ring.  Its indices are atomics, so neither side takes the
+ * mutex unless the other is asleep waiting on it.
+ */
+
+#define PKG_ASYNC_RING 1024		/* received messages in flight, power of 2 */
+#define PKG_ASYNC_IOV 256		/* iovec entries per writev() */
+#define PKG_ASYNC_MAXQUEUE (8*1024*1024)	/* queued output before senders block */
+
+#ifdef HAVE_WRITEV
+typedef struct iovec pkg_iovec_t;
+#else
+typedef struct {
+    void *iov_base;
+    size_t iov_len;
+} pkg_iovec_t;
+#endif
+
+struct pkg_msg {
+    struct pkg_msg *next;
+    struct pkg_header hdr;
+    char *buf;
+    size_t len;
+    int owned;		/* buf is a separate allocation to free */
+};
+
+struct pkg_rxmsg {
+    struct pkg_header hdr;
+    char *buf;
+};
+
+static int _pkg_dispatch(struct pkg_conn *pc);
+
+#define PKG_RX_ERROR 0
+#define PKG_RX_EOF 1
+#define PKG_RX_RUNNING 2
+
+#if !defined(__STDC_NO_ATOMICS__)
+typedef atomic_size_t pkg_atomic_t;
+#  define PKG_LOAD(a, x) atomic_load(&(a)->x)
+#  define PKG_STORE(a, x, v) atomic_store(&(a)->x, (v))
+#else
+/* No C11 atomics: fall back to a mutex of their own */
+typedef size_t pkg_atomic_t;
+#  define PKG_LOAD(a, x) _pkg_atomic_load((a), &(a)->x)
+#  define PKG_STORE(a, x, v) _pkg_atomic_store((a), &(a)->x, (v))
+#endif
+
+struct pkg_async {
+    bu_thrd_t tx_thread;
+    bu_thrd_t rx_thread;
+    bu_mtx_t lock;
+    bu_cnd_t tx_cnd;		/* output queued, or tx_stop set */
+    bu_cnd_t tx_done;		/* output written */
+    bu_cnd_t rx_cnd;		/* ring state changed */
+
+    /* protected by lock */
+    struct pkg_msg *tx_head;
+    struct pkg_msg **tx_tail;
+    size_t tx_bytes;		/* queued or being written */
+    int tx_error;
+    int tx_stop;
+    int tx_idle;		/* sender is waiting on tx_cnd */
+
+    struct pkg_rxmsg ring[PKG_ASYNC_RING];
+    pkg_atomic_t rx_head;	/* next slot to take, consumer owned */
+    pkg_atomic_t rx_tail;	/* next slot to fill, producer owned */
+    pkg_atomic_t rx_consumer_waiting;
+    pkg_atomic_t rx_producer_waiting;
+    pkg_atomic_t rx_state;
+    pkg_atomic_t rx_stop;
+#if defined(__STDC_NO_ATOMICS__)
+    bu_mtx_t atomic_lock;
+#endif
+};
+
+
+#if defined(__STDC_NO_ATOMICS__)
+static size_t
+_pkg_atomic_load(struct pkg_async *a, pkg_atomic_t *x)
+{
+    size_t v;
+    bu_mtx_lock(&a->atomic_lock);
+    v = *x;
+    bu_mtx_unlock(&a->atomic_lock);
+    return v;
+}
+
+
+static void
+_pkg_atomic_store(struct pkg_async *a, pkg_atomic_t *x, size_t v)
+{
+    bu_mtx_lock(&a->atomic_lock);
+    *x = v;
+    bu_mtx_unlock(&a->atomic_lock);
+}
+#endif
+
+
+/**
+ * Wake whoever is sleeping on the ring.  Taking the lock orders this
+ * with a sleeper that has checked the ring but not yet waited.
+ *
+ * This is a private implementation function.
+ */
+static void
+_pkg_async_wake(struct pkg_async *a)
+{
+    bu_mtx_lock(&a->lock);
+    bu_cnd_broadcast(&a->rx_cnd);
+    bu_mtx_unlock(&a->lock);
+}
+
+
+/**
+ * Write all of iov, picking up after short writes.
+ *
+ * Returns 0 on success, -1 on error.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_writev(int fd, pkg_iovec_t *iov, int n)
+{
+    ssize_t got;
+
+    while (n > 0) {
+	errno = 0;
+#ifdef HAVE_WRITEV
+	got = writev(fd, iov, n);
+#else
+	got = PKG_SEND(fd, iov->iov_base, iov->iov_len);
+#endif
+	if (got < 0 && errno == EINTR)
+	    continue;
+	if (got <= 0)
+	    return -1;
+	while (n > 0 && (size_t)got >= iov->iov_len) {
+	    got -= iov->iov_len;
+	    iov++;
+	    n--;
+	}
+	if (n > 0) {
+	    iov->iov_base = (char *)iov->iov_base + got;
+	    iov->iov_len -= got;
+	}
+    }
+    return 0;
+}
+
+
+/**
+ * Write and free a list of messages.  After an error the remaining
+ * messages are only freed.  Returns the number of bytes retired,
+ * setting *err on failure.
+ *
+ * This is a private implementation function.
+ */
+static size_t
+_pkg_async_write(struct pkg_conn *pc, struct pkg_msg *m, int *err)
+{
+    pkg_iovec_t iov[PKG_ASYNC_IOV];
+    struct pkg_msg *first, *next;
+    size_t bytes = 0;
+    int fd, n;
+
+    fd = (pc->pkc_fd == PKG_STDIO_MODE) ? pc->pkc_out_fd : pc->pkc_fd;
+
+    while (m) {
+	/* gather as many messages as fit in one vector */
+	first = m;
+	n = 0;
+	while (m && n <= PKG_ASYNC_IOV - 2) {
+	    iov[n].iov_base = (void *)&m->hdr;
+	    iov[n++].iov_len = sizeof(struct pkg_header);
+	    if (m->len > 0) {
+		iov[n].iov_base = (void *)m->buf;
+		iov[n++].iov_len = m->len;
+	    }
+	    m = m->next;
+	}
+	if (!*err && _pkg_async_writev(fd, iov, n) < 0) {
+	    _pkg_perror(pc->pkc_errlog, "pkg_async: write");
+	    *err = 1;
+	}
+	for (; first != m; first = next) {
+	    next = first->next;
+	    bytes += sizeof(struct pkg_header) + first->len;
+	    if (first->owned)
+		free(first->buf);
+	    free(first);
+	}
+    }
+    return bytes;
+}
+
+
+/**
+ * The sender thread.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_sender(void *arg)
+{
+    struct pkg_conn *pc = (struct pkg_conn *)arg;
+    struct pkg_async *a = pc->pkc_async;
+    struct pkg_msg *batch;
+    size_t bytes;
+    int err = 0;
+
+    bu_mtx_lock(&a->lock);
+    for (;;) {
+	while (!a->tx_head && !a->tx_stop) {
+	    a->tx_idle = 1;
+	    bu_cnd_wait(&a->tx_cnd, &a->lock);
+	    a->tx_idle = 0;
+	}
+	if (!a->tx_head)
+	    break;
+
+	/* take everything queued so far */
+	batch = a->tx_head;
+	a->tx_head = NULL;
+	a->tx_tail = &a->tx_head;
+	bu_mtx_unlock(&a->lock);
+
+	bytes = _pkg_async_write(pc, batch, &err);
+
+	bu_mtx_lock(&a->lock);
+	a->tx_bytes -= bytes;
+	if (err)
+	    a->tx_error = 1;
+	bu_cnd_broadcast(&a->tx_done);
+    }
+    bu_mtx_unlock(&a->lock);
+    return 0;
+}
+
+
+/**
+ * Hand a framed message to the consumer, waiting for room in the
+ * ring.  Returns 0, or -1 if the transport is stopping.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_push(struct pkg_async *a, const struct pkg_header *hdr, char *buf)
+{
+    size_t tail = PKG_LOAD(a, rx_tail);
+
+    if (tail - PKG_LOAD(a, rx_head) == PKG_ASYNC_RING) {
+	bu_mtx_lock(&a->lock);
+	PKG_STORE(a, rx_producer_waiting, 1);
+	while (tail - PKG_LOAD(a, rx_head) == PKG_ASYNC_RING && !PKG_LOAD(a, rx_stop))
+	    bu_cnd_wait(&a->rx_cnd, &a->lock);
+	PKG_STORE(a, rx_producer_waiting, 0);
+	bu_mtx_unlock(&a->lock);
+	if (tail - PKG_LOAD(a, rx_head) == PKG_ASYNC_RING)
+	    return -1;
+    }
+
+    a->ring[tail % PKG_ASYNC_RING].hdr = *hdr;
+    a->ring[tail % PKG_ASYNC_RING].buf = buf;
+    PKG_STORE(a, rx_tail, tail + 1);
+
+    if (PKG_LOAD(a, rx_consumer_waiting))
+	_pkg_async_wake(a);
+    return 0;
+}
+
+
+/**
+ * Frame the whole messages in the input buffer and pass them on,
+ * leaving any partial message at the front of the buffer, which is
+ * grown to hold it.
+ *
+ * Returns 0 to keep reading, -1 on error or when stopping.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_frame(struct pkg_conn *pc)
+{
+    struct pkg_async *a = pc->pkc_async;
+    struct pkg_header hdr;
+    char errbuf[MAX_PKG_ERRBUF_SIZE];
+    size_t avail, len, need;
+    char *buf;
+    int c;
+
+    for (;;) {
+	avail = (size_t)(pc->pkc_inend - pc->pkc_incur);
+	if (avail < sizeof(struct pkg_header))
+	    break;
+
+	memcpy(&hdr, &pc->pkc_inbuf[pc->pkc_incur], sizeof(struct pkg_header));
+	if (pkg_gshort((char *)hdr.pkh_magic) != PKG_MAGIC) {
+	    c = *((unsigned char *)&hdr);
+	    snprintf(errbuf, MAX_PKG_ERRBUF_SIZE, "pkg_async: skipping noise x%x\n", c);
+	    (pc->pkc_errlog)(errbuf);
+	    pc->pkc_incur++;
+	    continue;
+	}
+
+	len = pkg_glong((char *)hdr.pkh_len);
+	if (len > INT_MAX - sizeof(struct pkg_header) - PKG_STREAMLEN) {
+	    (pc->pkc_errlog)("pkg_async: message too large\n");
+	    return -1;
+	}
+	need = sizeof(struct pkg_header) + len;
+	if (avail < need)
+	    break;
+
+	buf = NULL;
+	if (len > 0) {
+	    if ((buf = (char *)malloc(len + 2)) == NULL) {
+		_pkg_perror(pc->pkc_errlog, "pkg_async: malloc fail");
+		return -1;
+	    }
+	    memcpy(buf, &pc->pkc_inbuf[pc->pkc_incur + sizeof(struct pkg_header)], len);
+	}
+	if (_pkg_async_push(a, &hdr, buf) < 0) {
+	    /* stopping, leave the message for the synchronous reader */
+	    free(buf);
+	    return -1;
+	}
+	pc->pkc_incur += (int)need;
+    }
+
+    /* Move what is left to the front, and make room for all of it */
+    avail = (size_t)(pc->pkc_inend - pc->pkc_incur);
+    if (pc->pkc_incur > 0) {
+	memmove(pc->pkc_inbuf, &pc->pkc_inbuf[pc->pkc_incur], avail);
+	pc->pkc_incur = 0;
+	pc->pkc_inend = (int)avail;
+    }
+    need = PKG_STREAMLEN;
+    if (avail >= sizeof(struct pkg_header))
+	need = sizeof(struct pkg_header) + pkg_glong((char *)((struct pkg_header *)pc->pkc_inbuf)->pkh_len) + PKG_STREAMLEN;
+    if ((size_t)pc->pkc_inlen < need) {
+	if ((buf = (char *)realloc(pc->pkc_inbuf, need)) == NULL) {
+	    (pc->pkc_errlog)("pkg_async: realloc failure\n");
+	    return -1;
+	}
+	pc->pkc_inbuf = buf;
+	pc->pkc_inlen = (int)need;
+    }
+    return 0;
+}
+
+
+/**
+ * The receiver thread.  The connection's input buffer belongs to it
+ * while it runs.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_receiver(void *arg)
+{
+    struct pkg_conn *pc = (struct pkg_conn *)arg;
+    struct pkg_async *a = pc->pkc_async;
+    struct timeval tv;
+    fd_set bits;
+    size_t state = PKG_RX_ERROR;
+    ssize_t got;
+    int fd;
+
+    fd = (pc->pkc_fd == PKG_STDIO_MODE) ? pc->pkc_in_fd : pc->pkc_fd;
+
+    while (!PKG_LOAD(a, rx_stop)) {
+	if (_pkg_async_frame(pc) < 0)
+	    break;
+
+	/* Wait with a timeout, so that a stop request is noticed */
+	FD_ZERO(&bits);
+	FD_SET(fd, &bits);
+	tv.tv_sec = 0;
+	tv.tv_usec = 100000;
+	errno = 0;
+	got = select(fd+1, &bits, (fd_set *)0, (fd_set *)0, &tv);
+	if (got < 0 && errno != EINTR) {
+	    _pkg_perror(pc->pkc_errlog, "pkg_async: select");
+	    break;
+	}
+	if (got <= 0)
+	    continue;
+
+	errno = 0;
+	got = PKG_READ(fd, &pc->pkc_inbuf[pc->pkc_inend], (size_t)(pc->pkc_inlen - pc->pkc_inend));
+	if (got < 0 && errno == EINTR)
+	    continue;
+	if (got == 0) {
+	    state = PKG_RX_EOF;
+	    break;
+	}
+	if (got < 0) {
+	    _pkg_perror(pc->pkc_errlog, "pkg_async: read");
+	    break;
+	}
+	pc->pkc_inend += (int)got;
+    }
+
+    PKG_STORE(a, rx_state, state);
+    _pkg_async_wake(a);
+    return 0;
+}
+
+
+/**
+ * Queue a message on an asynchronous connection, copying the two
+ * buffers, or taking over buf1 when take is set.
+ *
+ * Returns the number of bytes of user data queued, or -1 on error.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_send(struct pkg_conn *pc, int type, const char *buf1, size_t len1, const char *buf2, size_t len2, int take)
+{
+    struct pkg_async *a = pc->pkc_async;
+    struct pkg_msg *m;
+    size_t len = len1 + len2;
+
+    if (take) {
+	if ((m = (struct pkg_msg *)malloc(sizeof(struct pkg_msg))) == NULL) {
+	    free((char *)buf1);
+	    _pkg_perror(pc->pkc_errlog, "pkg_send: malloc failure");
+	    return -1;
+	}
+	m->buf = (char *)buf1;
+	m->owned = 1;
+    } else {
+	if ((m = (struct pkg_msg *)malloc(sizeof(struct pkg_msg) + len)) == NULL) {
+	    _pkg_perror(pc->pkc_errlog, "pkg_send: malloc failure");
+	    return -1;
+	}
+	m->buf = (char *)(m + 1);
+	m->owned = 0;
+	if (len1 > 0)
+	    memcpy(m->buf, buf1, len1);
+	if (len2 > 0)
+	    memcpy(m->buf + len1, buf2, len2);
+    }
+    m->next = NULL;
+    m->len = len;
+    pkg_pshort((char *)m->hdr.pkh_magic, (unsigned short)PKG_MAGIC);
+    pkg_pshort((char *)m->hdr.pkh_type, (unsigned short)type);
+    pkg_plong((char *)m->hdr.pkh_len, (unsigned long)len);
+
+    bu_mtx_lock(&a->lock);
+    /* Don't let the queue grow without bound on a slow connection */
+    while (a->tx_bytes > PKG_ASYNC_MAXQUEUE && !a->tx_error)
+	bu_cnd_wait(&a->tx_done, &a->lock);
+    if (a->tx_error) {
+	bu_mtx_unlock(&a->lock);
+	if (m->owned)
+	    free(m->buf);
+	free(m);
+	return -1;
+    }
+    *a->tx_tail = m;
+    a->tx_tail = &m->next;
+    a->tx_bytes += sizeof(struct pkg_header) + len;
+    /* A busy sender picks this up with the rest of its next batch */
+    if (a->tx_idle)
+	bu_cnd_signal(&a->tx_cnd);
+    bu_mtx_unlock(&a->lock);
+
+    return (int)len;
+}
+
+
+/**
+ * Wait until everything queued on an asynchronous connection has
+ * been written.  Returns 0, or -1 if a write failed.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_flush(struct pkg_conn *pc)
+{
+    struct pkg_async *a = pc->pkc_async;
+    int ret;
+
+    bu_mtx_lock(&a->lock);
+    while (a->tx_bytes > 0 && !a->tx_error)
+	bu_cnd_wait(&a->tx_done, &a->lock);
+    ret = a->tx_error ? -1 : 0;
+    bu_mtx_unlock(&a->lock);
+    return ret;
+}
+
+
+/**
+ * Wait for a received message.  Returns 1 when one is ready, 0 on EOF
+ * and -1 on error.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_wait(struct pkg_async *a)
+{
+    size_t head = PKG_LOAD(a, rx_head);
+
+    if (head != PKG_LOAD(a, rx_tail))
+	return 1;
+
+    bu_mtx_lock(&a->lock);
+    PKG_STORE(a, rx_consumer_waiting, 1);
+    while (head == PKG_LOAD(a, rx_tail) && PKG_LOAD(a, rx_state) == PKG_RX_RUNNING)
+	bu_cnd_wait(&a->rx_cnd, &a->lock);
+    PKG_STORE(a, rx_consumer_waiting, 0);
+    bu_mtx_unlock(&a->lock);
+
+    if (head != PKG_LOAD(a, rx_tail))
+	return 1;
+    return (PKG_LOAD(a, rx_state) == PKG_RX_EOF) ? 0 : -1;
+}
+
+
+/**
+ * Take the next received message, if there is one, making it the
+ * connection's current message as _pkg_gethdr() would.
+ *
+ * Returns 1 if there was a message, else 0.
+ *
+ * This is a private implementation function.
+ */
+static int
+_pkg_async_next(struct pkg_conn *pc, struct pkg_async *a)
+{
+    size_t head = PKG_LOAD(a, rx_head);
+    struct pkg_rxmsg *m;
+
+    if (head == PKG_LOAD(a, rx_tail))
+	return 0;
+
+    m = &a->ring[head % PKG_ASYNC_RING];
+    pc->pkc_hdr = m->hdr;
+    pc->pkc_type = pkg_gshort((char *)m->hdr.pkh_type);
+    pc->pkc_len = pkg_glong((char *)m->hdr.pkh_len);
+    pc->pkc_buf = m->buf;
+    pc->pkc_curpos = m->buf ? m->buf + pc->pkc_len : NULL;
+    pc->pkc_left = 0;
+    PKG_STORE(a, rx_head, head + 1);
+
+    if (PKG_LOAD(a, rx_producer_waiting))
+	_pkg_async_wake(a);
+    return 1;
+}
+
+
 int
 pkg_send(int type, const char *buf, size_t len, struct pkg_conn *pc)
 {
@@ -981,6 +1550,9 @@ pkg_send(int type, const char *buf, size_t len, struct pkg_conn *pc)
 	fflush(_pkg_debug);
     }
 
+    if (pc->pkc_async)
+	return _pkg_async_send(pc, type, buf, len, NULL, 0, 0);
+
     /* Check for any pending input, no delay */
     /* Input may be read, but not acted upon, to prevent deep recursion */
     _pkg_checkin(pc, 1);
@@ -1109,6 +1681,22 @@ pkg_send(int type, const char *buf, size_t len, struct pkg_conn *pc)
 }
 
 
+int
+pkg_send_nocopy(int type, char *buf, size_t len, struct pkg_conn *pc)
+{
+    int ret;
+
+    PKG_CK(pc);
+
+    if (pc->pkc_async)
+	return _pkg_async_send(pc, type, buf, len, NULL, 0, 1);
+
+    ret = pkg_send(type, buf, len, pc);
+    free(buf);
+    return ret;
+}
+
+
 int
 pkg_2send(int type, const char *buf1, size_t len1, const char *buf2, size_t len2, struct pkg_conn *pc)
 {
@@ -1128,6 +1716,9 @@ pkg_2send(int type, const char *buf1, size_t len1, const char *buf2, size_t len2
 	fflush(_pkg_debug);
     }
 
+    if (pc->pkc_async)
+	return _pkg_async_send(pc, type, buf1, len1, buf2, len2, 0);
+
     /* Check for any pending input, no delay */
     /* Input may be read, but not acted upon, to prevent deep recursion */
     _pkg_checkin(pc, 1);
@@ -1296,6 +1887,13 @@ pkg_stream(int type, const char *buf, size_t len, struct pkg_conn *pc)
 	fflush(_pkg_debug);
     }
 
+    /* The send queue already coalesces small messages */
+    if (pc->pkc_async) {
+	if (_pkg_async_send(pc, type, buf, len, NULL, 0, 0) < 0)
+	    return -1;
+	return (int)(len + sizeof(struct pkg_header));
+    }
+
     if (len > MAXQLEN)
 	return pkg_send(type, buf, len, pc);
 
@@ -1329,6 +1927,9 @@ pkg_flush(struct pkg_conn *pc)
 	fflush(_pkg_debug);
     }
 
+    if (pc->pkc_async)
+	return _pkg_async_flush(pc);
+
     if (pc->pkc_strpos <= 0) {
 	pc->pkc_strpos = 0;	/* sanity for < 0 */
 	return 0;
@@ -1458,6 +2059,34 @@ pkg_waitfor (int type, char *buf, size_t len, struct pkg_conn *pc)
 		type, (void *)buf, (unsigned long long)len, (void *)pc);
 	fflush(_pkg_debug);
     }
+
+    if (pc->pkc_async) {
+	for (;;) {
+	    if (_pkg_async_wait(pc->pkc_async) <= 0)
+		return -1;
+	    (void)_pkg_async_next(pc, pc->pkc_async);
+	    if (pc->pkc_type == type)
+		break;
+	    if (_pkg_dispatch(pc) < 0)
+		return -1;
+	}
+	i = pc->pkc_len;
+	if (i > len) {
+	    snprintf(_pkg_errbuf, MAX_PKG_ERRBUF_SIZE,
+		     "pkg_waitfor: message %ld exceeds buffer %ld\n",
+		     (long)pc->pkc_len, (long)len);
+	    (pc->pkc_errlog)(_pkg_errbuf);
+	    i = len;	/* truncated, as below */
+	}
+	if (i > 0)
+	    memcpy(buf, pc->pkc_buf, i);
+	free(pc->pkc_buf);
+	pc->pkc_buf = (char *)0;
+	pc->pkc_curpos = (char *)0;
+	pc->pkc_left = -1;
+	return (int)i;
+    }
+
  again:
     if (pc->pkc_left >= 0) {
 	/* Finish up remainder of partially received message */
@@ -1557,6 +2186,25 @@ pkg_bwaitfor (int type, struct pkg_conn *pc)
 		type, (void *)pc);
 	fflush(_pkg_debug);
     }
+
+    if (pc->pkc_async) {
+	/* Hand over the receiver's buffer, no copy needed */
+	for (;;) {
+	    if (_pkg_async_wait(pc->pkc_async) <= 0)
+		return (char *)0;
+	    (void)_pkg_async_next(pc, pc->pkc_async);
+	    if (pc->pkc_type == type)
+		break;
+	    if (_pkg_dispatch(pc) < 0)
+		return (char *)0;
+	}
+	tmpbuf = pc->pkc_buf;
+	pc->pkc_buf = (char *)0;
+	pc->pkc_curpos = (char *)0;
+	pc->pkc_left = -1;
+	return tmpbuf;
+    }
+
     do  {
 	/* Finish any unsolicited msg */
 	if (pc->pkc_left >= 0)
@@ -1667,6 +2315,18 @@ pkg_process(struct pkg_conn *pc)
     goodcnt = 0;
 
     PKG_CK(pc);
+
+    if (pc->pkc_async) {
+	/* Dispatch whatever the receiver thread has framed */
+	for (errcnt = 0; pc->pkc_async && _pkg_async_next(pc, pc->pkc_async);) {
+	    if (_pkg_dispatch(pc) <= 0)
+		errcnt++;
+	    else
+		goodcnt++;
+	}
+	return (errcnt > 0) ? -errcnt : goodcnt;
+    }
+
     /* This loop exists only to cut off "hard" errors */
     for (errcnt=0; errcnt < 500;) {
 	available = pc->pkc_inend - pc->pkc_incur;	/* amt in input buf */
@@ -1789,6 +2449,13 @@ pkg_block(struct pkg_conn *pc)
 	fflush(_pkg_debug);
     }
 
+    if (pc->pkc_async) {
+	if (_pkg_async_wait(pc->pkc_async) <= 0)
+	    return -1;
+	(void)_pkg_async_next(pc, pc->pkc_async);
+	return _pkg_dispatch(pc);
+    }
+
     /* If no read operation going now, start one. */
     if (pc->pkc_left < 0) {
 	if (_pkg_gethdr(pc, (char *)0) < 0)
@@ -1828,6 +2495,10 @@ pkg_suckin(struct pkg_conn *pc)
 	fflush(_pkg_debug);
     }
 
+    /* The receiver thread does the reading, wait for it to frame a message */
+    if (pc->pkc_async)
+	return _pkg_async_wait(pc->pkc_async);
+
     /* If no buffer allocated yet, get one */
     if (pc->pkc_inbuf == (char *)0 || pc->pkc_inlen <= 0) {
 	pc->pkc_inlen = PKG_STREAMLEN;
@@ -1930,6 +2601,133 @@ pkg_suckin(struct pkg_conn *pc)
 }
 
 
+int
+pkg_async_start(struct pkg_conn *pc)
+{
+    struct pkg_async *a;
+
+    PKG_CK(pc);
+    if (pc->pkc_async)
+	return 0;
+
+    if (pc->pkc_left >= 0) {
+	pc->pkc_errlog("pkg_async_start: a message is partially read\n");
+	return -1;
+    }
+    if (pc->pkc_strpos > 0 && pkg_flush(pc) < 0)
+	return -1;
+
+    /* The receiver thread frames straight out of the input buffer */
+    if (pc->pkc_inbuf == (char *)0 || pc->pkc_inlen <= 0) {
+	pc->pkc_inlen = PKG_STREAMLEN;
+	if ((pc->pkc_inbuf = (char *)malloc((size_t)pc->pkc_inlen)) == (char *)0) {
+	    pc->pkc_errlog("pkg_async_start: malloc failure\n");
+	    pc->pkc_inlen = 0;
+	    return -1;
+	}
+	pc->pkc_incur = pc->pkc_inend = 0;
+    }
+
+    if ((a = (struct pkg_async *)calloc(1, sizeof(struct pkg_async))) == NULL) {
+	pc->pkc_errlog("pkg_async_start: malloc failure\n");
+	return -1;
+    }
+#if defined(__STDC_NO_ATOMICS__)
+    bu_mtx_init(&a->atomic_lock);
+#endif
+    bu_mtx_init(&a->lock);
+    bu_cnd_init(&a->tx_cnd);
+    bu_cnd_init(&a->tx_done);
+    bu_cnd_init(&a->rx_cnd);
+    a->tx_tail = &a->tx_head;
+    PKG_STORE(a, rx_head, 0);
+    PKG_STORE(a, rx_tail, 0);
+    PKG_STORE(a, rx_consumer_waiting, 0);
+    PKG_STORE(a, rx_producer_waiting, 0);
+    PKG_STORE(a, rx_state, PKG_RX_RUNNING);
+    PKG_STORE(a, rx_stop, 0);
+
+    pc->pkc_async = a;
+    if (bu_thrd_create(&a->tx_thread, _pkg_async_sender, pc) != bu_thrd_success) {
+	pc->pkc_errlog("pkg_async_start: unable to start sender thread\n");
+	goto fail;
+    }
+    if (bu_thrd_create(&a->rx_thread, _pkg_async_receiver, pc) != bu_thrd_success) {
+	pc->pkc_errlog("pkg_async_start: unable to start receiver thread\n");
+	bu_mtx_lock(&a->lock);
+	a->tx_stop = 1;
+	bu_cnd_signal(&a->tx_cnd);
+	bu_mtx_unlock(&a->lock);
+	bu_thrd_join(a->tx_thread, NULL);
+	goto fail;
+    }
+
+    if (_pkg_debug) {
+	_pkg_timestamp();
+	fprintf(_pkg_debug, "pkg_async_start(pc=%p) fd=%d\n", (void *)pc, pc->pkc_fd);
+	fflush(_pkg_debug);
+    }
+    return 0;
+
+ fail:
+    pc->pkc_async = NULL;
+    bu_cnd_destroy(&a->rx_cnd);
+    bu_cnd_destroy(&a->tx_done);
+    bu_cnd_destroy(&a->tx_cnd);
+    bu_mtx_destroy(&a->lock);
+#if defined(__STDC_NO_ATOMICS__)
+    bu_mtx_destroy(&a->atomic_lock);
+#endif
+    free(a);
+    return -1;
+}
+
+
+int
+pkg_async_stop(struct pkg_conn *pc)
+{
+    struct pkg_async *a;
+    int ret;
+
+    PKG_CK(pc);
+    if ((a = pc->pkc_async) == NULL)
+	return 0;
+
+    if (_pkg_debug) {
+	_pkg_timestamp();
+	fprintf(_pkg_debug, "pkg_async_stop(pc=%p) fd=%d\n", (void *)pc, pc->pkc_fd);
+	fflush(_pkg_debug);
+    }
+
+    ret = _pkg_async_flush(pc);
+
+    bu_mtx_lock(&a->lock);
+    a->tx_stop = 1;
+    bu_cnd_signal(&a->tx_cnd);
+    bu_mtx_unlock(&a->lock);
+    bu_thrd_join(a->tx_thread, NULL);
+
+    PKG_STORE(a, rx_stop, 1);
+    _pkg_async_wake(a);
+    bu_thrd_join(a->rx_thread, NULL);
+
+    /* Back to synchronous operation before any handler can send */
+    pc->pkc_async = NULL;
+    while (_pkg_async_next(pc, a))
+	(void)_pkg_dispatch(pc);
+
+    bu_cnd_destroy(&a->rx_cnd);
+    bu_cnd_destroy(&a->tx_done);
+    bu_cnd_destroy(&a->tx_cnd);
+    bu_mtx_destroy(&a->lock);
+#if defined(__STDC_NO_ATOMICS__)
+    bu_mtx_destroy(&a->atomic_lock);
+#endif
+    free(a);
+    return ret;
+}
+
+
 /*
  * Local Variables:
  * mode: C
@@ -0,0 +1,329 @@
+/*                    T P K G _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file libpkg/tpkg_bench.c
+ *
+ * Loopback throughput benchmark for libpkg, in the style of tpkg.
+ * A client thread streams a number of messages to a server on
+ * 127.0.0.1, once over synchronous connections, once with
+ * pkg_async_start() on both ends, and once more handing the client's
+ * buffers over with pkg_send_nocopy().  The message and byte rates
+ * seen by the server are reported.
+ *
+ * Each message starts with its sequence number and is filled with a
+ * pattern that depends on it, and its length varies with it too.  The
+ * server checks every byte and the order the messages arrive in, and
+ * the exit status is non-zero if any message is lost or differs.
+ *
+ */
+
+#include "common.h"
+
+/* system headers */
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include "bio.h"
+
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/tc.h"
+#include "bu/time.h"
+
+/* interface headers */
+#include "pkg.h"
+
+
+#define MSG_HELO	1
+#define MSG_DATA	2
+#define MSG_CIAO	3
+
+/* maximum number of digits on a port number */
+#define MAX_DIGITS	5
+
+
+struct bench {
+    char port[MAX_DIGITS + 1];
+    size_t count;	/* messages to send */
+    size_t size;	/* bytes in the longest message */
+    int async;
+    int nocopy;
+
+    /* counted by the server */
+    size_t received;
+    size_t bytes;
+    size_t errors;
+    int done;
+};
+
+
+/* messages are up to 3 bytes shorter than the size asked for, so
+ * the lengths on the wire don't all line up */
+#define MSG_LEN(_b, _seq) ((_b)->size - (_seq) % 4)
+#define MIN_SIZE 8
+
+
+static void
+msg_fill(unsigned char *buf, size_t len, size_t seq)
+{
+    size_t i;
+
+    buf[0] = (unsigned char)(seq >> 24);
+    buf[1] = (unsigned char)(seq >> 16);
+    buf[2] = (unsigned char)(seq >> 8);
+    buf[3] = (unsigned char)seq;
+    for (i = 4; i < len; i++)
+	buf[i] = (unsigned char)(seq * 7 + i);
+}
+
+
+/**
+ * returns the number of bytes that differ from message seq, or the
+ * length when the length or the sequence number is wrong
+ */
+static size_t
+msg_check(const unsigned char *buf, size_t len, size_t seq, size_t want)
+{
+    size_t got, i, bad = 0;
+
+    if (len != want)
+	return (len > want) ? len : want;
+    got = ((size_t)buf[0] << 24) | ((size_t)buf[1] << 16) | ((size_t)buf[2] << 8) | buf[3];
+    if (got != (seq & 0xffffffff))
+	return len;
+    for (i = 4; i < len; i++) {
+	if (buf[i] != (unsigned char)(seq * 7 + i))
+	    bad++;
+    }
+    return bad;
+}
+
+
+static void
+usage(const char *argv0)
+{
+    bu_log("Usage: %s [-p#] [-n#] [-b#]\n", argv0);
+    bu_log("\t-p#\tport number to use on 127.0.0.1 (default 2000)\n");
+    bu_log("\t-n#\tnumber of messages to send (default 100000)\n");
+    bu_log("\t-b#\tsize of the longest message sent, at least %d (default 64)\n", MIN_SIZE);
+    bu_log("\n%s", pkg_version());
+    exit(1);
+}
+
+
+static void
+server_data(struct pkg_conn *connection, char *buf)
+{
+    struct bench *b = (struct bench *)connection->pkc_user_data;
+    size_t bad;
+
+    bad = msg_check((unsigned char *)buf, connection->pkc_len, b->received, MSG_LEN(b, b->received));
+    if (bad) {
+	if (b->errors < 10)
+	    bu_log("message %zu: %zu bytes, %zu of them wrong\n", b->received, connection->pkc_len, bad);
+	b->errors++;
+    }
+    b->received++;
+    b->bytes += connection->pkc_len;
+    free(buf);
+}
+
+
+static void
+server_ciao(struct pkg_conn *connection, char *buf)
+{
+    struct bench *b = (struct bench *)connection->pkc_user_data;
+    b->done = 1;
+    free(buf);
+}
+
+
+/**
+ * client thread, sends the messages as fast as it can
+ */
+static int
+run_client(void *arg)
+{
+    struct bench *b = (struct bench *)arg;
+    struct pkg_conn *pc;
+    char *buffer;
+    size_t i;
+    int failed = 0;
+
+    pc = pkg_open("127.0.0.1", b->port, "tcp", NULL, NULL, NULL, NULL);
+    if (pc == PKC_ERROR) {
+	bu_log("Connection to port %s failed.\n", b->port);
+	return 1;
+    }
+    if (b->async && pkg_async_start(pc) < 0) {
+	pkg_close(pc);
+	return 1;
+    }
+
+    buffer = (char *)bu_malloc(b->size, "buffer allocation");
+
+    pkg_send(MSG_HELO, NULL, 0, pc);
+    for (i = 0; i < b->count; i++) {
+	size_t len = MSG_LEN(b, i);
+	int ret;
+	if (b->nocopy) {
+	    char *msg = (char *)malloc(len);
+	    msg_fill((unsigned char *)msg, len, i);
+	    ret = pkg_send_nocopy(MSG_DATA, msg, len, pc);
+	} else {
+	    msg_fill((unsigned char *)buffer, len, i);
+	    ret = pkg_send(MSG_DATA, buffer, len, pc);
+	}
+	if (ret < 0) {
+	    bu_log("Unable to send message %zu\n", i);
+	    failed = 1;
+	    break;
+	}
+    }
+    pkg_send(MSG_CIAO, NULL, 0, pc);
+
+    /* flush output and close */
+    pkg_close(pc);
+    bu_free(buffer, "buffer release");
+    return failed;
+}
+
+
+/**
+ * accept one client and time the reception of its messages, returns
+ * non-zero if they didn't all arrive intact and in order
+ */
+static int
+run_bench(int netfd, struct bench *b)
+{
+    struct pkg_switch callbacks[] = {
+	{MSG_DATA, server_data, "DATA", NULL},
+	{MSG_CIAO, server_ciao, "CIAO", NULL},
+	{0, 0, (char *)0, (void*)0}
+    };
+    struct pkg_conn *client;
+    bu_thrd_t thread;
+    int64_t start;
+    double elapsed;
+    char *buf;
+    int client_failed = 0;
+
+    callbacks[0].pks_user_data = b;
+    callbacks[1].pks_user_data = b;
+    b->received = b->bytes = b->errors = 0;
+    b->done = 0;
+
+    if (bu_thrd_create(&thread, run_client, b) != bu_thrd_success)
+	bu_bomb("Unable to start the client thread\n");
+
+    client = pkg_getclient(netfd, callbacks, NULL, 0);
+    if (client == PKC_NULL || client == PKC_ERROR)
+	bu_bomb("Unable to accept the client connection\n");
+    if (b->async && pkg_async_start(client) < 0)
+	bu_bomb("Unable to start the asynchronous transport\n");
+
+    /* the clock starts with the first message */
+    buf = pkg_bwaitfor(MSG_HELO, client);
+    if (buf)
+	free(buf);
+    start = bu_gettime();
+    while (!b->done) {
+	if (pkg_block(client) < 0)
+	    break;
+    }
+    elapsed = (bu_gettime() - start) / 1000000.0;
+
+    pkg_close(client);
+    bu_thrd_join(thread, &client_failed);
+
+    if (elapsed <= 0.0)
+	elapsed = 1.0e-6;
+    bu_log("%-6s %10zu msgs %12zu bytes %8.3f s %12.0f msgs/s %9.2f MB/s%s%s\n",
+	   b->nocopy ? "nocopy" : (b->async ? "async" : "sync"),
+	   b->received, b->bytes, elapsed,
+	   b->received / elapsed, b->bytes / elapsed / (1024.0 * 1024.0),
+	   (b->received == b->count) ? "" : "  INCOMPLETE",
+	   (b->errors) ? "  CORRUPT" : "");
+
+    return (client_failed || !b->done || b->received != b->count || b->errors);
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    struct bench b;
+    int c, netfd;
+    int port = 2000;
+    int failed = 0;
+
+    memset(&b, 0, sizeof(b));
+    b.count = 100000;
+    b.size = 64;
+
+    while ((c = bu_getopt(argc, argv, "p:n:b:h?")) != -1) {
+	switch (c) {
+	    case 'p':
+		port = atoi(bu_optarg);
+		break;
+	    case 'n':
+		b.count = (size_t)strtoul(bu_optarg, NULL, 10);
+		break;
+	    case 'b':
+		b.size = (size_t)strtoul(bu_optarg, NULL, 10);
+		break;
+	    default:
+		usage(argv[0]);
+	}
+    }
+    if (port < 0 || port > 0xffff || b.size < MIN_SIZE)
+	usage(argv[0]);
+
+    /* ignore broken pipes */
+#ifdef SIGPIPE
+    (void)signal(SIGPIPE, SIG_IGN);
+#endif
+
+    snprintf(b.port, sizeof(b.port), "%d", port);
+    netfd = pkg_permserver(b.port, "tcp", 0, 0);
+    if (netfd < 0)
+	bu_bomb("Unable to start the server\n");
+
+    bu_log("%zu messages of up to %zu bytes over 127.0.0.1 port %d\n", b.count, b.size, port);
+    b.async = 0;
+    b.nocopy = 0;
+    failed += run_bench(netfd, &b);
+    b.async = 1;
+    failed += run_bench(netfd, &b);
+    b.nocopy = 1;
+    failed += run_bench(netfd, &b);
+
+    return (failed) ? 1 : 0;
+}
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
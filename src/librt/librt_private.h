@@ -227,6 +227,71 @@ extern void plot_ellipse(
 extern int _rt_tcl_list_to_int_array(const char *list, int **array, int *array_len);
 extern int _rt_tcl_list_to_fastf_array(const char *list, fastf_t **array, int *array_len);
 
+/* Shared, reference counted storage for the decoded data of the EBM,
+ * VOL and DSP primitives, so solids using the same file or binunif
+ * contents keep one copy of it.  This is heap memory, not the file
+ * mapping: EBM and VOL need padded copies and DSP needs byte swapped
+ * ones, so only DSP files on big-endian hosts are used straight from
+ * the map.  kind names the layout of the decoded data and dims (at most
+ * 3) its dimensions.  Data from the mapped file mp is matched by the
+ * file's name, size and modification time, and is decoded once.  Other
+ * data (mp NULL) is matched by comparing the decoded bytes, so it is
+ * decoded for each solid but stored once.  A hash of these only
+ * narrows the search - entries are always compared in full.
+ *
+ * rt_shared_data_get() returns the buffer stored for file mp with a
+ * new reference, or NULL (always, if mp is NULL).
+ * rt_shared_data_add() stores the len bytes of decoded data at buf, a
+ * bu_malloc'd buffer it takes ownership of - if a matching copy was
+ * stored first, buf is freed and that copy is returned instead.
+ * References are taken with rt_shared_data_ref() and released with
+ * rt_shared_data_put(), and the buffer is freed with the last.  Both
+ * ignore buffers that aren't in the store, such as file data used
+ * directly from the mapping.
+ *
+ * Only the decoded data is shared.  Prepped acceleration data, such as
+ * the brick maps below, is still built for each solid.
+ */
+extern void *rt_shared_data_get(const char *kind, const uint32_t *dims, size_t ndims, const struct bu_mapped_file *mp);
+extern void *rt_shared_data_add(const char *kind, const uint32_t *dims, size_t ndims, const struct bu_mapped_file *mp, void *buf, size_t len);
+extern void rt_shared_data_ref(const void *buf);
+extern void rt_shared_data_put(const void *buf);
+
+/* Empty space skipping for the voxel walks of the VOL and EBM
+ * primitives.  Level 0 of a brick map holds the minimum and maximum
+ * value of each 8x8x8 (8x8 for ndim 2) brick of cells, and each level
+ * above summarizes 8x8x8 bricks of the level below, up to a single
+ * brick covering the whole grid.
+ *
+ * rt_brick_map_build() builds the map for a grid of dim cells, the
+ * cell (x, y, z) found at cells[x*stride[X] + y*stride[Y] +
+ * z*stride[Z]].  Setting LIBRT_VOXEL_BRICKS to 0 leaves the map empty
+ * (nlevels 0), disabling the skipping.
+ *
+ * rt_brick_skip() is called by a DDA walk at each cell, with t[] the
+ * distances of the next cell planes crossed along each axis and delta[]
+ * their spacing (0 for axes the ray doesn't cross).  If the cell lies
+ * in a brick whose values are all outside [lo, hi] (or, when inside is
+ * set, all within it), it returns the axis the ray leaves the largest
+ * such brick through, the distance where it does so in texit, and in
+ * steps[] the number of cell planes crossed along each axis up to
+ * there.  Otherwise it returns -1.
+ */
+#define RT_BRICK_SHIFT 3
+#define RT_BRICK_MAX_LEVELS 8
+
+struct rt_brick_map {
+    int ndim;
+    int nlevels;
+    size_t dim[3];
+    size_t ldim[RT_BRICK_MAX_LEVELS][3];
+    unsigned char *minmax[RT_BRICK_MAX_LEVELS];
+};
+
+extern void rt_brick_map_build(struct rt_brick_map *bm, int ndim, const size_t dim[3], const unsigned char *cells, const size_t stride[3]);
+extern void rt_brick_map_free(struct rt_brick_map *bm);
+extern int rt_brick_skip(const struct rt_brick_map *bm, const size_t cell[3], const fastf_t dir[3], const fastf_t t[3], const fastf_t delta[3], unsigned int lo, unsigned int hi, int inside, size_t steps[3], double *texit);
+
 /* view.c */
 extern fastf_t solid_point_spacing(const struct bview *gvp, fastf_t solid_width);
 extern fastf_t view_avg_sample_spacing(const struct bview *gvp);
@@ -262,19 +262,18 @@ rt_arbn_print(const struct soltab *stp)
 
 
 /**
- * Intersect a ray with an ARBN.
+ * Intersect a ray with an ARBN, filling in the distances and surface
+ * numbers of the entry and exit points of segp.
  * Find the largest "in" distance and the smallest "out" distance.
  * Cyrus & Beck algorithm for convex polyhedra.
  *
  * Returns -
- *  0 MISS
- * >0 HIT
+ * 0 MISS
+ * 2 HIT
  */
-int
-rt_arbn_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+static int
+arbn_seg(const struct rt_arbn_internal *aip, const struct xray *rp, struct seg *segp)
 {
-    struct rt_arbn_internal *aip =
-	(struct rt_arbn_internal *)stp->st_specific;
     int i;
     int iplane, oplane;
     fastf_t in, out;	/* ray in/out distances */
@@ -322,22 +321,70 @@ rt_arbn_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     if (in >= out || out >= INFINITY)
 	return 0;	/* MISS */
 
-    {
-	struct seg *segp;
+    segp->seg_in.hit_dist = in;
+    segp->seg_in.hit_surfno = iplane;
 
-	RT_GET_SEG(segp, ap->a_resource);
-	segp->seg_stp = stp;
-	segp->seg_in.hit_dist = in;
-	segp->seg_in.hit_surfno = iplane;
+    segp->seg_out.hit_dist = out;
+    segp->seg_out.hit_surfno = oplane;
 
-	segp->seg_out.hit_dist = out;
-	segp->seg_out.hit_surfno = oplane;
-	BU_LIST_INSERT(&(seghead->l), &(segp->l));
-    }
     return 2;			/* HIT */
 }
 
 
+/**
+ * Intersect a ray with an ARBN.
+ *
+ * Returns -
+ *  0 MISS
+ * >0 HIT
+ */
+int
+rt_arbn_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct rt_arbn_internal *aip =
+	(struct rt_arbn_internal *)stp->st_specific;
+    struct seg seg;
+    struct seg *segp;
+
+    if (arbn_seg(aip, rp, &seg) != 2)
+	return 0;	/* MISS */
+
+    RT_GET_SEG(segp, ap->a_resource);
+    segp->seg_stp = stp;
+    segp->seg_in.hit_dist = seg.seg_in.hit_dist;
+    segp->seg_in.hit_surfno = seg.seg_in.hit_surfno;
+    segp->seg_out.hit_dist = seg.seg_out.hit_dist;
+    segp->seg_out.hit_surfno = seg.seg_out.hit_surfno;
+    BU_LIST_INSERT(&(seghead->l), &(segp->l));
+
+    return 2;			/* HIT */
+}
+
+
+/**
+ * Vectorized version.  The planes of each ARBN are clipped against
+ * its ray without any segment allocation, writing the results for
+ * each ray/solid pair directly into segp.
+ */
+void
+rt_arbn_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
+{
+    int i;
+
+    if (ap) RT_CK_APPLICATION(ap);
+
+    for (i = 0; i < n; i++) {
+	if (stp[i] == 0) continue; /* stp[i] == 0 signals skip ray */
+
+	if (arbn_seg((struct rt_arbn_internal *)stp[i]->st_specific, rp[i], &segp[i]) != 2) {
+	    segp[i].seg_stp = (struct soltab *)0;	/* MISS */
+	    continue;
+	}
+	segp[i].seg_stp = stp[i];
+    }
+}
+
+
 /**
  * Given ONE ray distance, return the normal and entry/exit point.
  */
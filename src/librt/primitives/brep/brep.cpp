@@ -28,6 +28,8 @@
 
 #include "common.h"
 
+#include <cfloat>
+#include <functional>
 #include <vector>
 #include <list>
 #include <map>
@@ -155,7 +157,7 @@ public:
 	LEAVING
     };
 
-    const ON_BrepFace& face;
+    const ON_BrepFace* face;
     fastf_t dist;
     point_t origin;
     point_t point;
@@ -172,7 +174,7 @@ public:
     int active;
 
     brep_hit(const ON_BrepFace& f, const ON_Ray& ray, const point_t p, const vect_t n, const pt2d_t _uv)
-	: face(f), trimmed(false), closeToEdge(false), oob(false), hit(CLEAN_HIT), direction(ENTERING), m_adj_face_index(0), sbv(NULL)
+	: face(&f), trimmed(false), closeToEdge(false), oob(false), hit(CLEAN_HIT), direction(ENTERING), m_adj_face_index(0), sbv(NULL)
     {
 	vect_t dir;
 	VMOVE(origin, ray.m_origin);
@@ -184,7 +186,7 @@ public:
     }
 
     brep_hit(const ON_BrepFace& f, fastf_t d, const ON_Ray& ray, const point_t p, const vect_t n, const pt2d_t _uv)
-	: face(f), dist(d), trimmed(false), closeToEdge(false), oob(false), hit(CLEAN_HIT), direction(ENTERING), m_adj_face_index(0), sbv(NULL)
+	: face(&f), dist(d), trimmed(false), closeToEdge(false), oob(false), hit(CLEAN_HIT), direction(ENTERING), m_adj_face_index(0), sbv(NULL)
     {
 	VMOVE(origin, ray.m_origin);
 	VMOVE(point, p);
@@ -204,7 +206,7 @@ public:
 
     brep_hit& operator=(const brep_hit& h)
     {
-	const_cast<ON_BrepFace&>(face) = h.face;
+	face = h.face;
 	dist = h.dist;
 	VMOVE(origin, h.origin);
 	VMOVE(point, h.point);
@@ -270,11 +272,11 @@ log_key(struct bu_vls *logstr)
 
 
 static void
-log_hits(std::list<brep_hit> &hits, int UNUSED(verbosity))
+log_hits(std::vector<brep_hit> &hits, int UNUSED(verbosity))
 {
     struct bu_vls logstr = BU_VLS_INIT_ZERO;
     log_key(&logstr);
-    for (std::list<brep_hit>::iterator i = hits.begin(); i != hits.end(); ++i) {
+    for (std::vector<brep_hit>::iterator i = hits.begin(); i != hits.end(); ++i) {
 	point_t prev = VINIT_ZERO;
 
 	const brep_hit &out = *i;
@@ -283,7 +285,7 @@ log_hits(std::list<brep_hit> &hits, int UNUSED(verbosity))
 	    bu_vls_printf(&logstr, "<%g>", DIST_PNT_PNT(out.point, prev));
 	}
 	bu_vls_printf(&logstr, "{");
-	bu_vls_printf(&logstr, "%s(%d)", brep_hit_type_str((int)out.hit), out.face.m_face_index);
+	bu_vls_printf(&logstr, "%s(%d)", brep_hit_type_str((int)out.hit), out.face->m_face_index);
 	if (out.direction == brep_hit::ENTERING) bu_vls_printf(&logstr, "+");
 	if (out.direction == brep_hit::LEAVING) bu_vls_printf(&logstr, "-");
 	bu_vls_printf(&logstr, "[%d]", out.sbv->get_face().m_bRev);
@@ -306,7 +308,7 @@ log_subset(std::vector<brep_hit*> &hits, size_t min, size_t max, brep_hit *pprev
 	    bu_vls_printf(&logstr, "<%g>", DIST_PNT_PNT(hits[i]->point, prev->point));
 	}
 	bu_vls_printf(&logstr, "{");
-	bu_vls_printf(&logstr, "%s(%d)", brep_hit_type_str((int)hits[i]->hit), hits[i]->face.m_face_index);
+	bu_vls_printf(&logstr, "%s(%d)", brep_hit_type_str((int)hits[i]->hit), hits[i]->face->m_face_index);
 	if (hits[i]->direction == brep_hit::ENTERING) bu_vls_printf(&logstr, "+");
 	if (hits[i]->direction == brep_hit::LEAVING) bu_vls_printf(&logstr, "-");
 	bu_vls_printf(&logstr, "[%d]", hits[i]->sbv->get_face().m_bRev);
@@ -346,6 +348,16 @@ brep_specific_delete(struct brep_specific* bs)
     if (bs != NULL) {
 	delete bs->brep;
 	delete bs->bvh;
+	if (bs->flat)
+	    bu_free(bs->flat, "brep flat bvh");
+	if (bs->flat_leaves)
+	    bu_free(bs->flat_leaves, "brep flat bvh leaves");
+	if (bs->mesh_stp) {
+	    OBJ[ID_BOT].ft_free(bs->mesh_stp);
+	    bu_free(bs->mesh_stp, "brep mesh soltab");
+	}
+	if (bs->mesh_tris)
+	    bu_free(bs->mesh_tris, "brep mesh triangles");
 	bu_free(bs, "brep_specific_delete");
     }
 }
@@ -393,6 +405,162 @@ brep_build_bvh_surface_tree(int cpu, void *data)
 }
 
 
+/* Returns true if any leaf below node is not completely trimmed away,
+ * recording the nodes that lead to such leaves in live.
+ */
+static bool
+brep_flat_live(const BBNode *node, std::set<const BBNode *> &live)
+{
+    bool ret = false;
+    const std::vector<BBNode *> &children = node->get_children();
+    if (children.empty()) {
+	ret = !node->m_trimmed;
+    } else {
+	for (size_t i = 0; i < children.size(); i++) {
+	    if (brep_flat_live(children[i], live))
+		ret = true;
+	}
+    }
+    if (ret)
+	live.insert(node);
+    return ret;
+}
+
+
+/* Item waiting to be flattened - either a surface tree node, or (when
+ * node is NULL) the range [start, end) of face root nodes.
+ */
+struct brep_flat_item {
+    const BBNode *node;
+    size_t start;
+    size_t end;
+    size_t idx;
+};
+
+
+struct brep_flat_axis_cmp {
+    int axis;
+    bool operator()(const BBNode *a, const BBNode *b) const {
+	return a->m_node.Center()[axis] < b->m_node.Center()[axis];
+    }
+};
+
+
+static void
+brep_flat_set_box(struct brep_flat_node *fn, const ON_BoundingBox &bb)
+{
+    for (int i = 0; i < 3; i++) {
+	fn->min[i] = bb.m_min[i];
+	fn->max[i] = bb.m_max[i];
+    }
+    fn->first = 0;
+    fn->count = 0;
+}
+
+
+/* Flatten the surface trees of bs into an array ordered so that the
+ * children of each node are adjacent.  The per-face trees all hang off
+ * the root BBNode, so rather than testing every face box for every ray
+ * the faces are first arranged in a median split tree of their own.
+ * Leaves that are completely trimmed can never be hit and are left out
+ * entirely.
+ */
+static void
+brep_build_flat_bvh(struct brep_specific *bs)
+{
+    std::set<const BBNode *> live;
+    std::vector<const BBNode *> roots;
+    const std::vector<BBNode *> &faces = bs->bvh->get_children();
+    for (size_t i = 0; i < faces.size(); i++) {
+	if (brep_flat_live(faces[i], live))
+	    roots.push_back(faces[i]);
+    }
+
+    if (bs->flat)
+	bu_free(bs->flat, "brep flat bvh");
+    if (bs->flat_leaves)
+	bu_free(bs->flat_leaves, "brep flat bvh leaves");
+    bs->flat = NULL;
+    bs->flat_cnt = 0;
+    bs->flat_leaves = NULL;
+    bs->flat_leaves_cnt = 0;
+    if (roots.empty())
+	return;
+
+    std::vector<struct brep_flat_node> nodes;
+    std::vector<const BBNode *> leaves;
+    std::vector<struct brep_flat_item> queue;
+    std::vector<struct brep_flat_item> kids;
+
+    struct brep_flat_item root = {NULL, 0, roots.size(), 0};
+    if (roots.size() == 1)
+	root.node = roots[0];
+    nodes.resize(1);
+    brep_flat_set_box(&nodes[0], (root.node) ? root.node->m_node : bs->bvh->m_node);
+    queue.push_back(root);
+
+    for (size_t q = 0; q < queue.size(); q++) {
+	struct brep_flat_item item = queue[q];
+	kids.clear();
+	if (!item.node) {
+	    /* split the faces at the median of the widest axis */
+	    ON_BoundingBox bb;
+	    for (size_t i = item.start; i < item.end; i++)
+		bb.Union(roots[i]->m_node);
+	    ON_3dVector d = bb.Diagonal();
+	    struct brep_flat_axis_cmp cmp;
+	    cmp.axis = (d.x > d.y) ? ((d.x > d.z) ? 0 : 2) : ((d.y > d.z) ? 1 : 2);
+	    size_t mid = item.start + (item.end - item.start) / 2;
+	    std::nth_element(roots.begin() + item.start, roots.begin() + mid, roots.begin() + item.end, cmp);
+	    struct brep_flat_item lo = {NULL, item.start, mid, 0};
+	    struct brep_flat_item hi = {NULL, mid, item.end, 0};
+	    if (mid - item.start == 1)
+		lo.node = roots[item.start];
+	    if (item.end - mid == 1)
+		hi.node = roots[mid];
+	    kids.push_back(lo);
+	    kids.push_back(hi);
+	} else if (item.node->isLeaf()) {
+	    nodes[item.idx].first = (int)leaves.size();
+	    leaves.push_back(item.node);
+	    continue;
+	} else {
+	    const std::vector<BBNode *> &children = item.node->get_children();
+	    for (size_t i = 0; i < children.size(); i++) {
+		if (live.find(children[i]) == live.end())
+		    continue;
+		struct brep_flat_item c = {children[i], 0, 0, 0};
+		kids.push_back(c);
+	    }
+	}
+
+	nodes[item.idx].first = (int)nodes.size();
+	nodes[item.idx].count = (int)kids.size();
+	for (size_t i = 0; i < kids.size(); i++) {
+	    struct brep_flat_node fn;
+	    if (kids[i].node) {
+		brep_flat_set_box(&fn, kids[i].node->m_node);
+	    } else {
+		ON_BoundingBox bb;
+		for (size_t j = kids[i].start; j < kids[i].end; j++)
+		    bb.Union(roots[j]->m_node);
+		brep_flat_set_box(&fn, bb);
+	    }
+	    kids[i].idx = nodes.size();
+	    nodes.push_back(fn);
+	    queue.push_back(kids[i]);
+	}
+    }
+
+    bs->flat_cnt = nodes.size();
+    bs->flat = (struct brep_flat_node *)bu_malloc(nodes.size() * sizeof(struct brep_flat_node), "brep flat bvh");
+    memcpy(bs->flat, nodes.data(), nodes.size() * sizeof(struct brep_flat_node));
+    bs->flat_leaves_cnt = leaves.size();
+    bs->flat_leaves = (const BBNode **)bu_malloc(leaves.size() * sizeof(const BBNode *), "brep flat bvh leaves");
+    memcpy(bs->flat_leaves, leaves.data(), leaves.size() * sizeof(const BBNode *));
+}
+
+
 static int
 brep_build_bvh(struct brep_specific* bs)
 {
@@ -429,14 +597,11 @@ brep_build_bvh(struct brep_specific* bs)
      * defined above.  We do this in parallel in order to divy up work
      * for objects comprised of many faces.
      *
-     * A possible future refinement of this approach would be to build
-     * a tree structure on top of the collection of surface trees
-     * based on their 3D bounding volumes, as opposed to the current
-     * approach of simply having all surfaces be child nodes of the
-     * master node.  This would allow a ray intersection to avoid
-     * checking every surface tree bounding box, but should probably
-     * be undertaken only if this step proves to be a bottleneck for
-     * raytracing.
+     * Rays don't traverse this hierarchy directly - the flattened
+     * copy made by brep_build_flat_bvh() arranges the surface trees
+     * in a tree of their own based on their 3D bounding volumes, so
+     * a ray intersection doesn't need to check every surface tree
+     * bounding box.
      */
 
     //start = bu_gettime();
@@ -453,6 +618,7 @@ brep_build_bvh(struct brep_specific* bs)
     bu_free(bbbp.faces, "free face array");
 
     bs->bvh->BuildBBox();
+    brep_build_flat_bvh(bs);
     return 0;
 }
 
@@ -485,6 +651,159 @@ rt_brep_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
 }
 
 
+/**
+ * Tessellate-and-shoot mode.  When LIBRT_BREP_MESH is set, the brep is
+ * tessellated during prep and the ray tracer shoots the resulting mesh
+ * (via the BoT intersector) instead of the NURBS surfaces.  Setting it
+ * to "refine" additionally polishes the reported hit points with a few
+ * Newton steps on the NURBS surface that produced the triangle.  The
+ * mesh is built to the rtip tessellation tolerances, unless
+ * LIBRT_BREP_MESH_TOL supplies an absolute tolerance in mm.
+ *
+ * Returns 0 for exact shots, 1 for mesh shots and 2 for refined mesh
+ * shots.
+ */
+static int
+brep_mesh_mode(void)
+{
+    const char *envstr = getenv("LIBRT_BREP_MESH");
+    if (!envstr || !strlen(envstr) || BU_STR_EQUAL(envstr, "0"))
+	return 0;
+    return (BU_STR_EQUAL(envstr, "refine")) ? 2 : 1;
+}
+
+
+static int
+brep_mesh_prep(struct soltab *stp, struct brep_specific *bs, struct rt_i *rtip, int refine)
+{
+    int fcnt = 0, fncnt = 0, ncnt = 0, vcnt = 0;
+    int *faces = NULL;
+    fastf_t *vertices = NULL;
+    int *face_normals = NULL;
+    fastf_t *normals = NULL;
+
+    struct bg_tess_tol cdttol = BG_TESS_TOL_INIT_ZERO;
+    cdttol.abs = rtip->rti_ttol.abs;
+    cdttol.rel = rtip->rti_ttol.rel;
+    cdttol.norm = rtip->rti_ttol.norm;
+    const char *envstr = getenv("LIBRT_BREP_MESH_TOL");
+    if (envstr && atof(envstr) > 0)
+	cdttol.abs = atof(envstr);
+
+    ON_Brep_CDT_State *s_cdt = ON_Brep_CDT_Create((void *)bs->brep, stp->st_name);
+    ON_Brep_CDT_Tol_Set(s_cdt, &cdttol);
+    if (ON_Brep_CDT_Tessellate(s_cdt, 0, NULL)) {
+	bu_log("%s: no solid tessellation, shooting NURBS surfaces\n", stp->st_name);
+	ON_Brep_CDT_Destroy(s_cdt);
+	return -1;
+    }
+    if (ON_Brep_CDT_Mesh(&faces, &fcnt, &vertices, &vcnt, &face_normals, &fncnt, &normals, &ncnt, s_cdt, 0, NULL) || !fcnt) {
+	bu_log("%s: empty tessellation, shooting NURBS surfaces\n", stp->st_name);
+	ON_Brep_CDT_Destroy(s_cdt);
+	return -1;
+    }
+
+    /* The mesh triangles come out grouped by face, in face order */
+    struct brep_mesh_tri *mtris = (struct brep_mesh_tri *)bu_calloc(fcnt, sizeof(struct brep_mesh_tri), "brep mesh triangles");
+    int tcnt = 0;
+    for (int fi = 0; fi < bs->brep->m_F.Count() && tcnt < fcnt; fi++) {
+	int fi_cnt = ON_Brep_CDT_Face_Tri_Cnt(s_cdt, fi);
+	for (int i = 0; i < fi_cnt && tcnt < fcnt; i++)
+	    mtris[tcnt++].face = fi;
+    }
+    ON_Brep_CDT_Destroy(s_cdt);
+    if (tcnt != fcnt) {
+	/* Without a face for every triangle we can't report uv values or
+	 * refine hits */
+	bu_log("%s: tessellation has %d triangles but the faces account for %d, shooting NURBS surfaces\n", stp->st_name, fcnt, tcnt);
+	bu_free(mtris, "brep mesh triangles");
+	bu_free(faces, "faces");
+	bu_free(vertices, "vertices");
+	bu_free(face_normals, "face_normals");
+	bu_free(normals, "normals");
+	return -1;
+    }
+
+    /* Parameter space coordinates of the triangle corners, used to
+     * report uv values for the hits and to seed their refinement.
+     * Vertices are shared by the triangles of a face, so cache them. */
+    std::map<std::pair<int, int>, ON_2dPoint> vuv;
+    for (int i = 0; i < fcnt; i++) {
+	const ON_Surface *surf = bs->brep->m_F[mtris[i].face].SurfaceOf();
+	for (int j = 0; j < 3; j++) {
+	    int vind = faces[i*3+j];
+	    const fastf_t *v = &vertices[vind*3];
+	    const fastf_t *vn = &vertices[faces[i*3+(j+1)%3]*3];
+	    V_MAX(mtris[i].size, DIST_PNT_PNT(v, vn));
+	    std::pair<int, int> key(mtris[i].face, vind);
+	    std::map<std::pair<int, int>, ON_2dPoint>::iterator v_it = vuv.find(key);
+	    if (v_it == vuv.end()) {
+		ON_2dPoint uv(0.0, 0.0);
+		ON_3dPoint p3d;
+		double dist = 0.0;
+		surface_GetClosestPoint3dFirstOrder(surf, ON_3dPoint(v), uv, p3d, dist);
+		v_it = vuv.insert(std::make_pair(key, uv)).first;
+	    }
+	    mtris[i].uv[j][0] = v_it->second.x;
+	    mtris[i].uv[j][1] = v_it->second.y;
+	}
+    }
+
+    struct rt_bot_internal *bot;
+    BU_GET(bot, struct rt_bot_internal);
+    bot->magic = RT_BOT_INTERNAL_MAGIC;
+    bot->mode = RT_BOT_SOLID;
+    bot->orientation = RT_BOT_CCW;
+    bot->bot_flags = RT_BOT_HAS_SURFACE_NORMALS | RT_BOT_USE_NORMALS;
+    bot->num_vertices = vcnt;
+    bot->num_faces = fcnt;
+    bot->vertices = vertices;
+    bot->faces = faces;
+    bot->thickness = NULL;
+    bot->face_mode = (struct bu_bitv *)NULL;
+    bot->num_normals = ncnt;
+    bot->num_face_normals = fncnt;
+    bot->normals = normals;
+    bot->face_normals = face_normals;
+
+    struct rt_db_internal intern;
+    RT_DB_INTERNAL_INIT(&intern);
+    intern.idb_major_type = DB5_MAJORTYPE_BRLCAD;
+    intern.idb_type = ID_BOT;
+    intern.idb_ptr = (void *)bot;
+    intern.idb_meth = &OBJ[intern.idb_type];
+
+    /* The mesh is prepped as a private BoT soltab - it isn't known to
+     * the rtip, so only the brep solid takes part in the space
+     * partitioning. */
+    struct soltab *mstp;
+    BU_ALLOC(mstp, struct soltab);
+    *mstp = *stp;
+    mstp->st_specific = NULL;
+    mstp->st_meth = &OBJ[ID_BOT];
+    mstp->st_id = ID_BOT;
+    int ret = OBJ[ID_BOT].ft_prep(mstp, &intern, rtip);
+
+    BU_PUT(bot, struct rt_bot_internal);
+    bu_free(faces, "faces");
+    bu_free(vertices, "vertices");
+    bu_free(face_normals, "face_normals");
+    bu_free(normals, "normals");
+
+    if (ret) {
+	bu_log("%s: mesh prep failed, shooting NURBS surfaces\n", stp->st_name);
+	bu_free(mstp, "brep mesh soltab");
+	bu_free(mtris, "brep mesh triangles");
+	return -1;
+    }
+
+    bs->mesh_stp = mstp;
+    bs->mesh_tris = mtris;
+    bs->mesh_refine = refine;
+    return 0;
+}
+
+
 /**
  * Given a pointer of a GED database record, and a transformation
  * matrix, determine if this is a valid NURB, and if so, prepare the
@@ -535,16 +854,27 @@ rt_brep_prep(struct soltab *stp, struct rt_db_internal* ip, struct rt_i* rtip)
 	//bu_log("brep %s solid\n", (bs->is_solid) ? "is" : "is NOT");
     }
 
-    //start = bu_gettime();
-    /* do the majority of real work here */
-    if (brep_build_bvh(bs) < 0) {
-	return -1;
-    }
-    //bu_log("!!! BUILD BVH: %.2f sec\n", (bu_gettime() - start) / 1000000.0);
+    /* plate mode hits depend on the surface trees, so are always exact */
+    int mesh_mode = (bs->plate_mode) ? 0 : brep_mesh_mode();
+    if (mesh_mode && !bs->mesh_stp)
+	(void)brep_mesh_prep(stp, bs, rtip, (mesh_mode == 2));
 
-    /* Once a proper SurfaceTree is built, finalize the bounding
-     * volumes.  This takes no time. */
-    bs->bvh->GetBBox(stp->st_min, stp->st_max);
+    if (bs->mesh_stp) {
+	/* the surface trees aren't needed to shoot the mesh */
+	VMOVE(stp->st_min, bs->mesh_stp->st_min);
+	VMOVE(stp->st_max, bs->mesh_stp->st_max);
+    } else {
+	//start = bu_gettime();
+	/* do the majority of real work here */
+	if (brep_build_bvh(bs) < 0) {
+	    return -1;
+	}
+	//bu_log("!!! BUILD BVH: %.2f sec\n", (bu_gettime() - start) / 1000000.0);
+
+	/* Once a proper SurfaceTree is built, finalize the bounding
+	 * volumes.  This takes no time. */
+	bs->bvh->GetBBox(stp->st_min, stp->st_max);
+    }
 
     // expand outer bounding box just a little bit
     point_t adjust;
@@ -846,7 +1176,7 @@ utah_newton_4corner_solver(const BBNode* sbv, const ON_Surface* surf, const ON_R
 
 
 static int
-utah_brep_intersect(const BBNode* sbv, const ON_BrepFace* face, const ON_Surface* surf, pt2d_t& uv, const ON_Ray& ray, std::list<brep_hit>& hits)
+utah_brep_intersect(const BBNode* sbv, const ON_BrepFace* face, const ON_Surface* surf, pt2d_t& uv, const ON_Ray& ray, std::vector<brep_hit>& hits)
 {
 #define MAX_BREP_SUBDIVISION_INTERSECTS 5
     ON_3dVector N[MAX_BREP_SUBDIVISION_INTERSECTS];
@@ -952,9 +1282,9 @@ sign(double val)
 
 
 static bool
-containsNearMiss(const std::list<brep_hit> *hits)
+containsNearMiss(const std::vector<brep_hit> *hits)
 {
-    for (std::list<brep_hit>::const_iterator i = hits->begin(); i != hits->end(); ++i) {
+    for (std::vector<brep_hit>::const_iterator i = hits->begin(); i != hits->end(); ++i) {
 	const brep_hit&out = *i;
 	if (out.hit == brep_hit::NEAR_MISS) {
 	    return true;
@@ -965,9 +1295,9 @@ containsNearMiss(const std::list<brep_hit> *hits)
 
 
 static bool
-containsNearHit(const std::list<brep_hit> *hits)
+containsNearHit(const std::vector<brep_hit> *hits)
 {
-    for (std::list<brep_hit>::const_iterator i = hits->begin(); i != hits->end(); ++i) {
+    for (std::vector<brep_hit>::const_iterator i = hits->begin(); i != hits->end(); ++i) {
 	const brep_hit&out = *i;
 	if (out.hit == brep_hit::NEAR_HIT) {
 	    return true;
@@ -1003,8 +1333,8 @@ brep_platemode_thickness(const struct xray& ray, const brep_hit& hit, const stru
      * beyond the surface by calculating the proposed exit point's
      * distance to the surface.
      */
-    const ON_Surface* surf = hit.face.SurfaceOf();
-    const ON_BrepFace& face = hit.face;
+    const ON_Surface* surf = hit.face->SurfaceOf();
+    const ON_BrepFace& face = *hit.face;
 
 #if 0
     SurfaceTree* tree = NULL;
@@ -1044,6 +1374,234 @@ brep_platemode_thickness(const struct xray& ray, const brep_hit& hit, const stru
 }
 
 
+/* Per thread scratch space for rt_brep_shot, reused from ray to ray so
+ * shooting doesn't have to allocate.
+ */
+struct brep_shot_buffers {
+    std::vector<std::pair<double, int> > stack;
+    std::vector<const BBNode *> leaves;
+    std::vector<brep_hit> hits;
+};
+static thread_local struct brep_shot_buffers brep_shot_bufs;
+
+
+struct brep_flat_ray {
+    double org[3];
+    double inv[3];
+    int parallel[3];
+};
+
+
+/* Same test as BBNode::intersectedBy(), including solving for boxes
+ * behind the ray origin.
+ */
+static inline bool
+brep_flat_box(const struct brep_flat_node *n, const struct brep_flat_ray *fr, double *tnear)
+{
+    double tn = -DBL_MAX;
+    double tf = DBL_MAX;
+    for (int i = 0; i < 3; i++) {
+	if (UNLIKELY(fr->parallel[i])) {
+	    if (fr->org[i] < n->min[i] || fr->org[i] > n->max[i])
+		return false;
+	    continue;
+	}
+	double t1 = (n->min[i] - fr->org[i]) * fr->inv[i];
+	double t2 = (n->max[i] - fr->org[i]) * fr->inv[i];
+	if (t1 > t2) {
+	    double tmp = t1;
+	    t1 = t2;
+	    t2 = tmp;
+	}
+	V_MAX(tn, t1);
+	V_MIN(tf, t2);
+    }
+    *tnear = tn;
+    return (tn <= tf);
+}
+
+
+/* Collect the leaves of the flattened surface trees whose boxes are
+ * intersected by r into buf.leaves.  Children are visited nearest
+ * entry point first, and subtrees entered beyond tmax are skipped.
+ */
+static void
+brep_flat_leaves(const struct brep_specific *bs, const ON_Ray &r, double tmax, struct brep_shot_buffers &buf)
+{
+    struct brep_flat_ray fr;
+    double t;
+
+    buf.leaves.clear();
+    buf.stack.clear();
+    if (!bs->flat_cnt)
+	return;
+
+    for (int i = 0; i < 3; i++) {
+	fr.org[i] = r.m_origin[i];
+	fr.parallel[i] = ON_NearZero(r.m_dir[i]) ? 1 : 0;
+	fr.inv[i] = (fr.parallel[i]) ? 0.0 : 1.0 / r.m_dir[i];
+    }
+
+    if (!brep_flat_box(&bs->flat[0], &fr, &t) || t > tmax)
+	return;
+    buf.stack.push_back(std::make_pair(t, 0));
+
+    while (!buf.stack.empty()) {
+	std::pair<double, int> e = buf.stack.back();
+	buf.stack.pop_back();
+
+	const struct brep_flat_node *n = &bs->flat[e.second];
+	if (!n->count) {
+	    buf.leaves.push_back(bs->flat_leaves[n->first]);
+	    continue;
+	}
+
+	size_t base = buf.stack.size();
+	for (int i = n->first; i < n->first + n->count; i++) {
+	    if (brep_flat_box(&bs->flat[i], &fr, &t) && t <= tmax)
+		buf.stack.push_back(std::make_pair(t, i));
+	}
+
+	/* leave the nearest child on top */
+	std::sort(buf.stack.begin() + base, buf.stack.end(), std::greater<std::pair<double, int> >());
+    }
+}
+
+
+/* Hits come in close to sorted order when the leaves are visited front
+ * to back, so an insertion sort does very little work (and is stable,
+ * like the list sort used previously.)
+ */
+static void
+brep_hits_sort(std::vector<brep_hit> &hits)
+{
+    for (size_t i = 1; i < hits.size(); i++) {
+	if (!(hits[i] < hits[i-1]))
+	    continue;
+	brep_hit h = hits[i];
+	size_t j = i;
+	while (j > 0 && h < hits[j-1]) {
+	    hits[j] = hits[j-1];
+	    j--;
+	}
+	hits[j] = h;
+    }
+}
+
+
+/* Polish a mesh hit against the NURBS surface of its face, starting
+ * from the uv interpolated from the triangle corners.  The hit is only
+ * moved if the iteration converges within a triangle's size of the
+ * mesh hit - otherwise it stays on the mesh. */
+static void
+brep_mesh_refine(const struct brep_specific *bs, const struct brep_mesh_tri *mt, struct hit *hitp, const struct xray *rp, ON_2dPoint &uv)
+{
+    const ON_BrepFace &face = bs->brep->m_F[mt->face];
+    const ON_Surface *surf = face.SurfaceOf();
+    ON_Interval udom = surf->Domain(0);
+    ON_Interval vdom = surf->Domain(1);
+    ON_Ray r = toXRay(rp);
+    ON_3dVector p1, p2;
+    double p1d = 0.0, p2d = 0.0;
+    utah_ray_planes(r, p1, p1d, p2, p2d);
+
+    ON_2dPoint ruv(uv);
+    ON_3dPoint S(0.0, 0.0, 0.0);
+    ON_3dVector Su(0.0, 0.0, 0.0);
+    ON_3dVector Sv(0.0, 0.0, 0.0);
+    double f = 0.0, g = 0.0;
+    double j11, j12, j21, j22;
+    bool converged = false;
+
+    for (int i = 0; i < BREP_MAX_ITERATIONS; i++) {
+	surf->Ev1Der(ruv.x, ruv.y, S, Su, Sv);
+	utah_F(S, p1, p1d, p2, p2d, f, g);
+	if (fabs(f) + fabs(g) < ROOT_TOL) {
+	    converged = true;
+	    break;
+	}
+	utah_Fu(Su, p1, p2, j11, j21);
+	utah_Fv(Sv, p1, p2, j12, j22);
+	double J = j11 * j22 - j12 * j21;
+	if (NEAR_ZERO(J, BREP_INTERSECTION_ROOT_EPSILON))
+	    break;
+	double invdetJ = 1.0 / J;
+	ruv.x = FMIN(FMAX(ruv.x - invdetJ * (j22 * f - j12 * g), udom.Min()), udom.Max());
+	ruv.y = FMIN(FMAX(ruv.y - invdetJ * (j11 * g - j21 * f), vdom.Min()), vdom.Max());
+    }
+    if (!converged)
+	return;
+
+    double t = utah_calc_t(r, S);
+    if (fabs(t - hitp->hit_dist) > mt->size)
+	return;
+
+    ON_3dVector N = ON_CrossProduct(Su, Sv);
+    if (!N.Unitize())
+	return;
+    if (face.m_bRev)
+	N.Reverse();
+    /* defer to the mesh for which side is out */
+    if (VDOT(N, hitp->hit_normal) < 0.0)
+	N.Reverse();
+
+    hitp->hit_dist = t;
+    VMOVE(hitp->hit_point, S);
+    VMOVE(hitp->hit_normal, N);
+    uv = ruv;
+}
+
+
+/* Translate a hit on the tessellation into a brep hit */
+static void
+brep_mesh_hit(const struct brep_specific *bs, struct hit *hitp, struct xray *rp)
+{
+    /* the BoT normal needs the barycentric coordinates left in
+     * hit_vpriv by the shot, so must be evaluated first */
+    OBJ[ID_BOT].ft_norm(hitp, bs->mesh_stp, rp);
+
+    const struct brep_mesh_tri *mt = &bs->mesh_tris[hitp->hit_surfno];
+    double b = FMIN(FMAX(hitp->hit_vpriv[Y], 0.0), 1.0);
+    double c = FMIN(FMAX(hitp->hit_vpriv[Z], 0.0), 1.0 - b);
+    double a = 1.0 - b - c;
+    ON_2dPoint uv(a * mt->uv[0][0] + b * mt->uv[1][0] + c * mt->uv[2][0],
+		  a * mt->uv[0][1] + b * mt->uv[1][1] + c * mt->uv[2][1]);
+
+    if (bs->mesh_refine)
+	brep_mesh_refine(bs, mt, hitp, rp, uv);
+
+    hitp->hit_surfno = mt->face;
+    VSET(hitp->hit_vpriv, uv.x, uv.y, 0.0);
+}
+
+
+static int
+brep_mesh_shot(struct soltab *stp, const struct brep_specific *bs, struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct seg mhead;
+    struct seg *segp;
+
+    BU_LIST_INIT(&mhead.l);
+    int ret = OBJ[ID_BOT].ft_shot(bs->mesh_stp, rp, ap, &mhead);
+    if (ret <= 0) {
+	RT_FREE_SEG_LIST(&mhead, ap->a_resource);
+	return 0;
+    }
+
+    for (BU_LIST_FOR(segp, seg, &mhead.l)) {
+	segp->seg_stp = stp;
+	brep_mesh_hit(bs, &segp->seg_in, rp);
+	brep_mesh_hit(bs, &segp->seg_out, rp);
+	/* refinement must not turn a thin segment inside out */
+	if (segp->seg_out.hit_dist < segp->seg_in.hit_dist)
+	    segp->seg_out.hit_dist = segp->seg_in.hit_dist;
+    }
+    BU_LIST_APPEND_LIST(&seghead->l, &mhead.l);
+
+    return ret;
+}
+
+
 /**
  * Intersect a ray with a brep.  If an intersection occurs, a struct
  * seg will be acquired and filled in.
@@ -1064,22 +1622,26 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     if (!bs)
 	return 0;
 
+    if (bs->mesh_stp)
+	return brep_mesh_shot(stp, bs, rp, ap, seghead);
+
     /* First, test for intersections between the Surface Tree
      * hierarchy and the ray - if one or more leaf nodes are
      * intersected, there is potentially a hit and more evaluation is
      * needed.  Otherwise, return a miss.
      */
-    std::list<const BBNode*> inters;
+    struct brep_shot_buffers &buf = brep_shot_bufs;
     ON_Ray r = toXRay(rp);
-    bs->bvh->intersectsHierarchy(r, inters);
-    if (inters.empty())
+    brep_flat_leaves(bs, r, DBL_MAX, buf);
+    if (buf.leaves.empty())
 	return 0; // MISS
 
-    // find all the hits (XXX very inefficient right now!)
-    std::list<brep_hit> hits;
-    MissList misses;
-    for (std::list<const BBNode*>::const_iterator i = inters.begin(); i != inters.end(); i++) {
-	const BBNode* sbv = (*i);
+    // find all the hits - leaves are in front to back order, so the
+    // hits come out nearly sorted
+    std::vector<brep_hit> &hits = buf.hits;
+    hits.clear();
+    for (size_t i = 0; i < buf.leaves.size(); i++) {
+	const BBNode* sbv = buf.leaves[i];
 	const ON_BrepFace* f = &sbv->get_face();
 	const ON_Surface* surf = f->SurfaceOf();
 	pt2d_t uv = {sbv->m_u.Mid(), sbv->m_v.Mid()};
@@ -1087,18 +1649,18 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     }
 
     // sort the hits
-    hits.sort();
+    brep_hits_sort(hits);
 
 #ifdef RT_DEBUG_HITS
-    std::list<brep_hit> orig = hits;
+    std::vector<brep_hit> orig = hits;
 #endif
 
     ////////////////////////
     if ((hits.size() > 1) && containsNearMiss(&hits)) { //&& ((hits.size() % 2) != 0)) {
 
-	std::list<brep_hit>::iterator prev;
-	std::list<brep_hit>::const_iterator next;
-	std::list<brep_hit>::iterator curr = hits.begin();
+	std::vector<brep_hit>::iterator prev;
+	std::vector<brep_hit>::const_iterator next;
+	std::vector<brep_hit>::iterator curr = hits.begin();
 
 	while (curr != hits.end()) {
 	    const brep_hit &curr_hit = *curr;
@@ -1139,7 +1701,7 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 		    prev--;
 		    brep_hit &prev_hit = (*prev);
 		    if (prev_hit.hit == brep_hit::NEAR_MISS) { // two near misses in a row
-			if (prev_hit.m_adj_face_index == curr_hit.face.m_face_index) {
+			if (prev_hit.m_adj_face_index == curr_hit.face->m_face_index) {
 			    if (prev_hit.direction == curr_hit.direction) {
 				//remove current miss
 				prev_hit.hit = brep_hit::CRACK_HIT;
@@ -1147,13 +1709,13 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 				continue;
 			    } else {
 				//remove both edge near misses
-				(void)hits.erase(prev);
+				curr = hits.erase(prev);
 				curr = hits.erase(curr);
 				continue;
 			    }
 			} else {
 			    // not adjacent faces so remove first miss
-			    (void)hits.erase(prev);
+			    curr = hits.erase(prev);
 			}
 		    }
 		} else {
@@ -1162,7 +1724,7 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 		    brep_hit &prev_hit = (*prev);
 		    if ((curr_hit.hit == brep_hit::CLEAN_HIT || curr_hit.hit == brep_hit::NEAR_HIT) && prev_hit.hit == brep_hit::NEAR_MISS) {
 			if (curr_hit.direction == brep_hit::ENTERING) {
-			    (void)hits.erase(prev);
+			    curr = hits.erase(prev);
 			} else {
 			    prev_hit.hit = brep_hit::CRACK_HIT;
 			}
@@ -1184,13 +1746,13 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 		    const brep_hit &prev_hit = (*prev);
 		    if ((prev_hit.hit == brep_hit::CLEAN_HIT) &&
 			(prev_hit.direction == curr_hit.direction) &&
-			(prev_hit.face.m_face_index == curr_hit.m_adj_face_index)) {
+			(prev_hit.face->m_face_index == curr_hit.m_adj_face_index)) {
 			// if "entering" remove first hit if
 			// "existing" remove second hit until we get
 			// good solids with known normal directions
 			// assume first hit direction is "entering"
 			// todo check solid status and normals
-			std::list<brep_hit>::const_iterator first = hits.begin();
+			std::vector<brep_hit>::const_iterator first = hits.begin();
 			const brep_hit &first_hit = *first;
 			if (first_hit.direction == curr_hit.direction) { // assume "entering"
 			    curr = hits.erase(prev);
@@ -1214,7 +1776,7 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 	if (!hits.empty() && ((hits.size() % 2) != 0)) {
 	    const brep_hit &curr_hit = hits.front();
 	    if (curr_hit.hit == brep_hit::NEAR_MISS) {
-		hits.pop_front();
+		hits.erase(hits.begin());
 	    }
 	}
 
@@ -1222,9 +1784,9 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 
     ///////////// handle near hit
     if ((hits.size() > 1) && containsNearHit(&hits)) { //&& ((hits.size() % 2) != 0)) {
-	std::list<brep_hit>::iterator prev;
-	std::list<brep_hit>::const_iterator next;
-	std::list<brep_hit>::iterator curr = hits.begin();
+	std::vector<brep_hit>::iterator prev;
+	std::vector<brep_hit>::const_iterator next;
+	std::vector<brep_hit>::iterator curr = hits.begin();
 	while (curr != hits.end()) {
 	    const brep_hit &curr_hit = *curr;
 	    if (curr_hit.hit == brep_hit::NEAR_HIT) {
@@ -1276,7 +1838,8 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 	// BREP_GRAZING_DOT_TOL (>= 89.999 degrees obliq)
 	TRACE("-- Remove grazing hits --");
 	//int num = 0;
-	for (std::list<brep_hit>::iterator i = hits.begin(); i != hits.end(); ++i) {
+	std::vector<brep_hit>::iterator i = hits.begin();
+	while (i != hits.end()) {
 	    const brep_hit &curr_hit = *i;
 	    if ((curr_hit.trimmed && !curr_hit.closeToEdge) || curr_hit.oob || NEAR_ZERO(VDOT(curr_hit.normal, rp->r_dir), BREP_GRAZING_DOT_TOL)) {
 		// remove what we were removing earlier
@@ -1286,21 +1849,24 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 		}
 		i = hits.erase(i);
 
-		if (i != hits.begin())
-		    --i;
+		// the hit following a removed first hit has always been
+		// passed over here
+		if (i == hits.begin() && i != hits.end())
+		    ++i;
 
 		continue;
 	    }
 	    //TRACE("hit " << num << ": " << PT(i->point) << " [" << VDOT(i->normal, rp->r_dir) << "]");
 	    //++num;
+	    ++i;
 	}
     }
 
     if (!hits.empty()) {
 	// we should have "valid" points now, remove duplicates or
 	// grazes(same point with in/out sign change)
-	std::list<brep_hit>::iterator last = hits.begin();
-	std::list<brep_hit>::iterator i = hits.begin();
+	std::vector<brep_hit>::iterator last = hits.begin();
+	std::vector<brep_hit>::iterator i = hits.begin();
 	++i;
 	while (i != hits.end()) {
 	    if ((*i) == (*last)) {
@@ -1334,8 +1900,8 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     //if (!hits.empty() && ((hits.size() % 2) != 0)) {
     if (!hits.empty()) {
 	// we should have "valid" points now, remove duplicates or grazes
-	std::list<brep_hit>::iterator last = hits.begin();
-	std::list<brep_hit>::iterator i = hits.begin();
+	std::vector<brep_hit>::iterator last = hits.begin();
+	std::vector<brep_hit>::iterator i = hits.begin();
 	++i;
 	int entering = 1;
 	while (i != hits.end()) {
@@ -1387,7 +1953,7 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 	    /* PLATE MODE case */
 
 	    /* iterate over all hit points assuming a plate-mode shell */
-	    for (std::list<brep_hit>::const_iterator i = hits.begin(); i != hits.end(); ++i) {
+	    for (std::vector<brep_hit>::const_iterator i = hits.begin(); i != hits.end(); ++i) {
 		const brep_hit& in = *i;
 		const brep_hit& out = *i;
 
@@ -1400,7 +1966,7 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 		/* set in hit */
 		segp->seg_in.hit_dist = in.dist - (los*0.5);
 		// segment is centered on the hit point
-		segp->seg_in.hit_surfno = in.face.m_face_index;
+		segp->seg_in.hit_surfno = in.face->m_face_index;
 		VSET(segp->seg_in.hit_vpriv, in.uv[0], in.uv[1], 0.0);
 		VMOVE(segp->seg_in.hit_normal, in.normal);
 		VJOIN1(segp->seg_in.hit_point, rp->r_pt, segp->seg_in.hit_dist, rp->r_dir);
@@ -1412,7 +1978,7 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 
 		/* set out hit */
 		segp->seg_out.hit_dist = out.dist + (los*0.5); // centered
-		segp->seg_out.hit_surfno = out.face.m_face_index;
+		segp->seg_out.hit_surfno = out.face->m_face_index;
 		VSET(segp->seg_out.hit_vpriv, out.uv[0], out.uv[1], 0.0);
 		VREVERSE(segp->seg_out.hit_normal, out.normal);
 		segp->seg_out.hit_rayp = &ap->a_ray;
@@ -1450,7 +2016,7 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 	    bool hit_it = hits.size() % 2 == 0;
 	    if (hit_it) {
 		// take each pair as a segment
-		for (std::list<brep_hit>::const_iterator i = hits.begin(); i != hits.end(); ++i) {
+		for (std::vector<brep_hit>::const_iterator i = hits.begin(); i != hits.end(); ++i) {
 		    const brep_hit& in = *i;
 		    i++;
 		    const brep_hit& out = *i;
@@ -1462,13 +2028,13 @@ rt_brep_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
 		    VMOVE(segp->seg_in.hit_point, in.point);
 		    VMOVE(segp->seg_in.hit_normal, in.normal);
 		    segp->seg_in.hit_dist = in.dist;
-		    segp->seg_in.hit_surfno = in.face.m_face_index;
+		    segp->seg_in.hit_surfno = in.face->m_face_index;
 		    VSET(segp->seg_in.hit_vpriv, in.uv[0], in.uv[1], 0.0);
 
 		    VMOVE(segp->seg_out.hit_point, out.point);
 		    VMOVE(segp->seg_out.hit_normal, out.normal);
 		    segp->seg_out.hit_dist = out.dist;
-		    segp->seg_out.hit_surfno = out.face.m_face_index;
+		    segp->seg_out.hit_surfno = out.face->m_face_index;
 		    VSET(segp->seg_out.hit_vpriv, out.uv[0], out.uv[1], 0.0);
 
 		    BU_LIST_INSERT(&(seghead->l), &(segp->l));
@@ -2968,6 +3534,10 @@ rt_brep_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, stru
     RT_CK_SOLTAB(stp);
     BU_CK_EXTERNAL(external);
 
+    /* tessellations are rebuilt each prep rather than cached */
+    if (brep_mesh_mode())
+	return 1;
+
     if (stp->st_specific) {
 	/* export to external */
 
@@ -3009,6 +3579,7 @@ rt_brep_prep_serialize(struct soltab *stp, const struct rt_db_internal *ip, stru
 	}
 
 	specific->bvh->BuildBBox();
+	brep_build_flat_bvh(specific);
 
 	{
 	    /* Once a proper SurfaceTree is built, finalize the bounding
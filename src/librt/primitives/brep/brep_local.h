@@ -26,6 +26,30 @@
 #define LIBRT_PRIMITIVES_BREP_BREP_LOCAL_H
 
 
+/**
+ * Node of the flattened surface tree hierarchy used for shooting.
+ * The children of a node are stored contiguously so their boxes can
+ * be tested together - first is the index of the first child, or of
+ * the leaf's BBNode in flat_leaves when count is 0.
+ */
+struct brep_flat_node {
+    double min[3];
+    double max[3];
+    int first;
+    int count;
+};
+
+/**
+ * Triangle of the tessellation shot in place of the NURBS surfaces
+ * when LIBRT_BREP_MESH is set.  The corner uv parameters are only
+ * filled in when hits are to be refined.
+ */
+struct brep_mesh_tri {
+    int face;
+    double uv[3][2];
+    double size;
+};
+
 /**
  * The b-rep specific data structure for caching the prepared
  * acceleration data structure.
@@ -33,6 +57,13 @@
 struct brep_specific {
     ON_Brep* brep;
     BrepBoundingVolume* bvh;
+    struct brep_flat_node* flat;
+    size_t flat_cnt;
+    const BrepBoundingVolume** flat_leaves;
+    size_t flat_leaves_cnt;
+    struct soltab* mesh_stp;
+    struct brep_mesh_tri* mesh_tris;
+    int mesh_refine;
     int is_solid;
     int plate_mode;
     int plate_mode_nocos;
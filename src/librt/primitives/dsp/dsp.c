@@ -65,15 +65,13 @@
 
 /* private header */
 #include "./dsp.h"
+#include "../../librt_private.h"
 
 
 #define FULL_DSP_DEBUGGING 1
 
 #define ORDERED_ISECT 1
 
-#define DIM_BB_CHILDREN 4
-#define NUM_BB_CHILDREN (DIM_BB_CHILDREN*DIM_BB_CHILDREN)
-
 #define IMPORT_FAIL(_s) \
     if (dsp_ip) { \
 	bu_log("rt_dsp_import4(%d) '%s' %s\n", __LINE__, bu_vls_addr(&dsp_ip->dsp_name), _s); \
@@ -91,38 +89,40 @@ struct dsp_rpp {
 
 
 /**
- * This structure contains a bounding box for a portion of the DSP
- * along with information about sub-bounding boxes, and what layer
- * (resolution) of the DSP this box bounds
+ * Elevation bounds for a square block of DSP cells
  */
-struct dsp_bb {
-    uint32_t magic;
-    struct dsp_rpp dspb_rpp;	/* our bounding box */
-    /*
-     * the next two elements indicate the number and locations of
-     * sub-bounding rpps.
-     *
-     * dsp_b_ch_dim is typically DIM_BB_CHILDREN, DIM_BB_CHILDREN
-     * except for "border" areas of the array
-     */
-    unsigned short dspb_subcell_size;/* XXX This is not yet computed */
-    unsigned short dspb_ch_dim[2];	/* dimensions of children[] */
-    struct dsp_bb *dspb_children[NUM_BB_CHILDREN];
+struct dsp_minmax {
+    unsigned short min;
+    unsigned short max;
 };
 
 
-#define MAGIC_dsp_bb 234
-#define DSP_BB_CK(_p) BU_CKMAG(_p, MAGIC_dsp_bb, "dsp_bb")
-/*
- * This structure provides a handle to all of the bounding boxes for
- * the DSP at a particular resolution.
+#define DSP_MIP_MAX_LEVELS 33
+
+/**
+ * Multi-resolution elevation bounds (a min/max mipmap) for the DSP.
+ * This is an implicit quadtree stored as one contiguous array per
+ * level: the node at (x, y) of level l bounds the (1<<l) x (1<<l)
+ * block of cells starting at cell (x<<l, y<<l), clipped to the edges
+ * of the DSP.  Level 0, the cells themselves, isn't stored - the
+ * bounds of a cell are just the elevations at its four corners.
+ *
+ * The bounds depend only on the elevation data, so all the solids
+ * using the same height field share one copy (see dsp_mip_get).
  */
-#define LAYER(l, x, y) l->p[l->dim[1]*y+x]
-struct dsp_bb_layer {
-    unsigned int dim[2]; /* the dimensions of the array at element p */
-    struct dsp_bb *p; /* array of dsp_bb's for this level */
+struct dsp_mipmap {
+    const void *key;	/* elevation data buffer */
+    unsigned int xsiz;
+    unsigned int ysiz;
+    int top;		/* level with a single node covering the DSP */
+    unsigned int dim[DSP_MIP_MAX_LEVELS][2];	/* nodes in each level */
+    struct dsp_minmax *lvl[DSP_MIP_MAX_LEVELS];
+    struct dsp_minmax *nodes;	/* storage for all the levels */
+    struct dsp_minmax bounds;	/* elevation bounds of the whole DSP */
+    int uses;
 };
 
+
 # define XCNT(_p) (((struct rt_dsp_internal *)_p)->dsp_xcnt)
 # define YCNT(_p) (((struct rt_dsp_internal *)_p)->dsp_ycnt)
 # define XSIZ(_p) (_p->dsp_i.dsp_xcnt - 1)
@@ -160,9 +160,7 @@ struct dsp_specific {
     double dsp_pl_dist[BBOX_PLANES];
     int xsiz;
     int ysiz;
-    int layers;
-    struct dsp_bb_layer *layer;
-    struct dsp_bb *bb_array;
+    struct dsp_mipmap *mip;
 };
 
 
@@ -337,23 +335,21 @@ plot_rpp(FILE *fp, struct bound_rpp *rpp, int r, int g, int b)
 
 
 /**
- * Plot a dsp_bb structure
+ * Plot a dsp_rpp structure
  */
 static void
-plot_dsp_bb(FILE *fp, struct dsp_bb *dsp_bb,
-	    struct dsp_specific *dsp,
-	    int r, int g, int b, int blather)
+plot_dsp_rpp(FILE *fp, struct dsp_rpp *dsp_rpp,
+	     struct dsp_specific *dsp,
+	     int r, int g, int b, int blather)
 {
     fastf_t *stom = &dsp->dsp_i.dsp_stom[0];
     struct bound_rpp rpp;
     point_t pt;
 
-    DSP_BB_CK(dsp_bb);
-
-    VMOVE(pt, dsp_bb->dspb_rpp.dsp_min); /* int->float conversion */
+    VMOVE(pt, dsp_rpp->dsp_min); /* int->float conversion */
     MAT4X3PNT(rpp.min, stom, pt);
 
-    VMOVE(pt, dsp_bb->dspb_rpp.dsp_max); /* int->float conversion */
+    VMOVE(pt, dsp_rpp->dsp_max); /* int->float conversion */
     MAT4X3PNT(rpp.max, stom, pt);
 
     if (blather)
@@ -365,17 +361,17 @@ plot_dsp_bb(FILE *fp, struct dsp_bb *dsp_bb,
 
 
 /*
- * drawing support for isect_ray_dsp_bb()
+ * drawing support for isect_ray_dsp_cell()
  */
 static FILE *
-draw_dsp_bb(int *plotnum,
-	    struct dsp_bb *dsp_bb,
-	    struct dsp_specific *dsp,
-	    int r, int g, int b)
+draw_dsp_rpp(int *plotnum,
+	     struct dsp_rpp *dsp_rpp,
+	     struct dsp_specific *dsp,
+	     int r, int g, int b)
 {
     char buf[64];
     FILE *fp;
-    struct dsp_bb bb;
+    struct dsp_rpp bb;
 
     sprintf(buf, "dsp_bb%03d.plot3", (*plotnum)++);
     if ((fp=fopen(buf, "wb")) == (FILE *)NULL) {
@@ -384,9 +380,9 @@ draw_dsp_bb(int *plotnum,
     }
 
     bu_log("plotting %s", buf);
-    bb = *dsp_bb; /* struct copy */
-    bb.dspb_rpp.dsp_min[Z] = 0.0;
-    plot_dsp_bb(fp, &bb, dsp, r, g, b, 1);
+    bb = *dsp_rpp; /* struct copy */
+    bb.dsp_min[Z] = 0;
+    plot_dsp_rpp(fp, &bb, dsp, r, g, b, 1);
 
     return fp;
 }
@@ -403,7 +399,7 @@ static void
 plot_layers(struct dsp_specific *dsp_sp)
 {
     FILE *fp;
-    int l, n;
+    int l;
     unsigned int x, y;
     char buf[32];
     static int colors[7][3] = {
@@ -416,9 +412,10 @@ plot_layers(struct dsp_specific *dsp_sp)
 	{255, 255, 255}
     };
     int r, g, b, c;
-    struct dsp_bb *d_bb;
+    struct dsp_mipmap *mip = dsp_sp->mip;
+    struct dsp_rpp rpp;
 
-    for (l = 0; l < dsp_sp->layers; l++) {
+    for (l = 1; l <= mip->top; l++) {
 	bu_semaphore_acquire(BU_SEM_SYSCALL);
 	sprintf(buf, "Dsp_layer%d.plot3", l);
 	fp=fopen(buf, "wb");
@@ -428,20 +425,20 @@ plot_layers(struct dsp_specific *dsp_sp)
 		   buf);
 	    return;
 	} else
-	    bu_log("plotting \"%s\" dim:%d, %d\n", buf,
-		   dsp_sp->layer[l].dim[X],
-		   dsp_sp->layer[l].dim[Y]);
+	    bu_log("plotting \"%s\" dim:%u, %u\n", buf,
+		   mip->dim[l][X],
+		   mip->dim[l][Y]);
 	c = l % 6;
 	r = colors[c][0];
 	g = colors[c][1];
 	b = colors[c][2];
 
-	for (y = 0; y < dsp_sp->layer[l].dim[Y]; y+= 2) {
-	    for (x = 0; x < dsp_sp->layer[l].dim[X]; x+= 2) {
-		n = y * dsp_sp->layer[l].dim[X] + x;
-		d_bb = &dsp_sp->layer[l].p[n];
-		plot_dsp_bb(fp, d_bb, dsp_sp, r, g, b, 0);
-
+	for (y = 0; y < mip->dim[l][Y]; y+= 2) {
+	    for (x = 0; x < mip->dim[l][X]; x+= 2) {
+		struct dsp_minmax *n = &mip->lvl[l][y * mip->dim[l][X] + x];
+		VSET(rpp.dsp_min, x << l, y << l, n->min);
+		VSET(rpp.dsp_max, FMIN((x + 1) << l, mip->xsiz), FMIN((y + 1) << l, mip->ysiz), n->max);
+		plot_dsp_rpp(fp, &rpp, dsp_sp, r, g, b, 0);
 	    }
 	}
 	fclose(fp);
@@ -457,7 +454,7 @@ plot_layers(struct dsp_specific *dsp_sp)
  */
 static void
 plot_cell_top(struct isect_stuff *isect,
-	      struct dsp_bb *dsp_bb,
+	      struct dsp_rpp *dsp_rpp,
 	      point_t A,
 	      point_t B,
 	      point_t C,
@@ -481,8 +478,6 @@ plot_cell_top(struct isect_stuff *isect,
 	{128, 255, 255},
     };
 
-    DSP_BB_CK(dsp_bb);
-
     bu_semaphore_acquire(BU_SEM_SYSCALL);
     if (style)
 	sprintf(buf, "dsp_cell_isect%04d.plot3", cnt++);
@@ -500,7 +495,7 @@ plot_cell_top(struct isect_stuff *isect,
 	bu_log("plotting %s flags 0x%x\n\t", buf, hitflags);
     }
 
-    plot_dsp_bb(fp, dsp_bb, isect->dsp, 128, 128, 128, 1);
+    plot_dsp_rpp(fp, dsp_rpp, isect->dsp, 128, 128, 128, 1);
 
     /* plot the triangulation */
     pl_color(fp, 255, 255, 255);
@@ -620,216 +615,307 @@ rt_dsp_print(register const struct soltab *stp)
 }
 
 
-/**
- * compute bounding boxes for each cell, then compute bounding boxes
- * for collections of bounding boxes
- */
-static void
-dsp_layers(struct dsp_specific *dsp, unsigned short *d_min, unsigned short *d_max)
-{
-    int idx, curr_layer, xs, ys, xv, yv, tot;
-    unsigned int x, y, i, j, k;
-    unsigned short dsp_min, dsp_max;
-    unsigned short elev;
-    struct dsp_bb *dsp_bb;
-    struct dsp_rpp *t;
-    struct dsp_bb_layer *curr, *prev;
-    unsigned short subcell_size;
-
-    /* First we compute the total number of struct dsp_bb's we will need */
-    xs = dsp->xsiz;
-    ys = dsp->ysiz;
-    tot = xs * ys;
-    /*    bu_log("layer %d   %dx%d\n", 0, xs, ys); */
-    dsp->layers = 1;
-    while (xs > 1 || ys > 1) {
-	xv = xs / DIM_BB_CHILDREN;
-	yv = ys / DIM_BB_CHILDREN;
-	if (xs % DIM_BB_CHILDREN) xv++;
-	if (ys % DIM_BB_CHILDREN) yv++;
+/* min/max mipmaps of the height fields currently in use */
+static struct bu_ptbl dsp_mipmaps = BU_PTBL_INIT_ZERO;
 
-#ifdef FULL_DSP_DEBUGGING
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log("layer %d   %dx%d\n", dsp->layers, xv, yv);
-#endif
-	tot += xv * yv;
+/* rows of a level claimed at a time by each build thread */
+#define DSP_MIP_ROWS 16
 
-	if (xv > 0) xs = xv;
-	else xs = 1;
+/* levels smaller than this aren't worth building in parallel */
+#define DSP_MIP_PARALLEL_MIN (64*1024)
 
-	if (yv > 0) ys = yv;
-	else ys = 1;
-	dsp->layers++;
-    }
+struct dsp_mip_build {
+    struct dsp_specific *dsp;
+    struct dsp_mipmap *mip;
+    int level;
+    unsigned int next_row;
+};
 
 
-#ifdef FULL_DSP_DEBUGGING
-    if (RT_G_DEBUG & RT_DEBUG_HF)
-	bu_log("%d layers total\n", dsp->layers);
-#endif
+static void
+dsp_mip_build_rows(int UNUSED(cpu), void *data)
+{
+    struct dsp_mip_build *mb = (struct dsp_mip_build *)data;
+    struct dsp_mipmap *mip = mb->mip;
+    int l = mb->level;
+    unsigned int xdim = mip->dim[l][X];
+    unsigned int ydim = mip->dim[l][Y];
+    unsigned int x, y, i, j, y_start, y_end;
+    unsigned short elev;
 
-    /* allocate the struct dsp_bb's we will need */
-    dsp->layer = (struct dsp_bb_layer *)bu_malloc(dsp->layers * sizeof(struct dsp_bb_layer),
-			   "dsp_bb_layers array");
-    dsp->bb_array = (struct dsp_bb *)bu_malloc(tot * sizeof(struct dsp_bb), "dsp_bb array");
+    while (1) {
+	bu_semaphore_acquire(BU_SEM_GENERAL);
+	y_start = mb->next_row;
+	mb->next_row += DSP_MIP_ROWS;
+	bu_semaphore_release(BU_SEM_GENERAL);
 
-    /* now we fill in the "lowest" layer of struct dsp_bb's from the
-     * raw data
-     */
-    dsp->layer[0].dim[X] = dsp->xsiz;
-    dsp->layer[0].dim[Y] = dsp->ysiz;
-    dsp->layer[0].p = dsp->bb_array;
+	if (y_start >= ydim)
+	    return;
+	y_end = (ydim - y_start > DSP_MIP_ROWS) ? y_start + DSP_MIP_ROWS : ydim;
+
+	for (y = y_start; y < y_end; y++) {
+	    for (x = 0; x < xdim; x++) {
+		struct dsp_minmax *n = &mip->lvl[l][y * xdim + x];
+		n->min = 0xffff;
+		n->max = 0;
+
+		if (l == 1) {
+		    /* the elevations at the corners of a 2x2 block of
+		     * cells
+		     */
+		    unsigned int x_end = FMIN(2*x + 2, mip->xsiz);
+		    unsigned int yp_end = FMIN(2*y + 2, mip->ysiz);
+		    for (j = 2*y; j <= yp_end; j++) {
+			for (i = 2*x; i <= x_end; i++) {
+			    elev = DSP(&mb->dsp->dsp_i, i, j);
+			    V_MIN(n->min, elev);
+			    V_MAX(n->max, elev);
+			}
+		    }
+		} else {
+		    /* the (up to) four nodes of the level below */
+		    unsigned int pxdim = mip->dim[l-1][X];
+		    unsigned int pydim = mip->dim[l-1][Y];
+		    for (j = 2*y; j < 2*y + 2 && j < pydim; j++) {
+			for (i = 2*x; i < 2*x + 2 && i < pxdim; i++) {
+			    struct dsp_minmax *c = &mip->lvl[l-1][j * pxdim + i];
+			    V_MIN(n->min, c->min);
+			    V_MAX(n->max, c->max);
+			}
+		    }
+		}
+	    }
+	}
+    }
+}
 
-    dsp_min = 0xffff;
-    dsp_max = 0;
 
-    for (y = 0; y < YSIZ(dsp); y++) {
+/**
+ * Compute the elevation bounds at each level of the mipmap, from the
+ * grid data up.
+ */
+static struct dsp_mipmap *
+dsp_mip_build(struct dsp_specific *dsp, const void *key)
+{
+    struct dsp_mipmap *mip;
+    struct dsp_mip_build mb;
+    unsigned int xs, ys;
+    size_t tot = 0;
+    int l;
+
+    BU_ALLOC(mip, struct dsp_mipmap);
+    mip->key = key;
+    mip->xsiz = (dsp->xsiz > 0) ? dsp->xsiz : 0;
+    mip->ysiz = (dsp->ysiz > 0) ? dsp->ysiz : 0;
+    mip->dim[0][X] = mip->xsiz;
+    mip->dim[0][Y] = mip->ysiz;
+
+    if (!mip->xsiz || !mip->ysiz)
+	return mip;
+
+    /* size each level */
+    xs = mip->xsiz;
+    ys = mip->ysiz;
+    l = 0;
+    while (xs > 1 || ys > 1) {
+	l++;
+	xs = (xs + 1) / 2;
+	ys = (ys + 1) / 2;
+	mip->dim[l][X] = xs;
+	mip->dim[l][Y] = ys;
+	tot += (size_t)xs * ys;
+    }
+    mip->top = l;
 
-	unsigned short cell_min = 0xffff;
-	unsigned short cell_max = 0;
+    if (RT_G_DEBUG & RT_DEBUG_HF)
+	bu_log("dsp mipmap: %d levels, %zu nodes\n", mip->top + 1, tot);
+
+    if (tot) {
+	mip->nodes = (struct dsp_minmax *)bu_malloc(tot * sizeof(struct dsp_minmax), "dsp mipmap nodes");
+	tot = 0;
+	for (l = 1; l <= mip->top; l++) {
+	    mip->lvl[l] = &mip->nodes[tot];
+	    tot += (size_t)mip->dim[l][X] * mip->dim[l][Y];
+	}
+    }
 
-	for (x = 0; x < XSIZ(dsp); x++) {
+    mb.dsp = dsp;
+    mb.mip = mip;
+    for (l = 1; l <= mip->top; l++) {
+	size_t cnt = (size_t)mip->dim[l][X] * mip->dim[l][Y];
+	mb.level = l;
+	mb.next_row = 0;
+	bu_parallel(dsp_mip_build_rows, (cnt < DSP_MIP_PARALLEL_MIN) ? 1 : 0, &mb);
+    }
 
-	    elev = DSP(&dsp->dsp_i, x, y);
-	    cell_min = cell_max = elev;
-
-	    elev = DSP(&dsp->dsp_i, x+1, y);
-	    V_MIN(cell_min, elev);
-	    V_MAX(cell_max, elev);
-
-	    elev = DSP(&dsp->dsp_i, x, y+1);
-	    V_MIN(cell_min, elev);
-	    V_MAX(cell_max, elev);
-
-	    elev = DSP(&dsp->dsp_i, x+1, y+1);
-	    V_MIN(cell_min, elev);
-	    V_MAX(cell_max, elev);
-
-	    /* factor the cell min/max into the overall min/max */
-	    V_MIN(dsp_min, cell_min);
-	    V_MAX(dsp_max, cell_max);
-
-	    /* fill in the dsp_rpp cell min/max */
-	    i = y*XSIZ(dsp) + x;
-	    dsp_bb = &dsp->layer[0].p[i];
-	    VSET(dsp_bb->dspb_rpp.dsp_min, x, y, cell_min);
-	    VSET(dsp_bb->dspb_rpp.dsp_max, x+1, y+1, cell_max);
-
-	    dsp_bb->dspb_subcell_size = 0;
-
-	    /* There are no "children" of a layer 0 element */
-	    dsp_bb->dspb_ch_dim[X] = 0;
-	    dsp_bb->dspb_ch_dim[Y] = 0;
-	    for (k = 0; k < NUM_BB_CHILDREN; k++) {
-		dsp_bb->dspb_children[k] =
-		    (struct dsp_bb *)NULL;
+    if (mip->top) {
+	mip->bounds = mip->lvl[mip->top][0];
+    } else {
+	/* a single cell */
+	unsigned short elev;
+	unsigned int i, j;
+	mip->bounds.min = 0xffff;
+	mip->bounds.max = 0;
+	for (j = 0; j <= 1; j++) {
+	    for (i = 0; i <= 1; i++) {
+		elev = DSP(&dsp->dsp_i, i, j);
+		V_MIN(mip->bounds.min, elev);
+		V_MAX(mip->bounds.max, elev);
 	    }
-	    dsp_bb->magic = MAGIC_dsp_bb;
-
-	    /* XXX should we compute the triangle orientation and
-	     * save it here too?
-	     */
 	}
     }
 
-    *d_min = dsp_min;
-    *d_max = dsp_max;
+    return mip;
+}
 
 
-    if (RT_G_DEBUG & RT_DEBUG_HF)
-	bu_log("layer 0 filled\n");
+/* The elevations are shared by all the solids using the same file or
+ * object contents (see get_file_data and get_obj_data), so the data
+ * buffer identifies the height field.
+ */
+static const void *
+dsp_mip_key(const struct rt_dsp_internal *dsp_ip)
+{
+    return dsp_ip->dsp_buf;
+}
 
-    subcell_size = 1;
 
-    /* now we compute successive layers from the initial layer */
-    for (curr_layer = 1; curr_layer < dsp->layers; curr_layer++) {
-	/* compute the number of cells in each direction for this layer */
+/* caller must hold RT_SEM_MODEL */
+static struct dsp_mipmap *
+dsp_mip_find(const void *key, int xsiz, int ysiz)
+{
+    size_t i;
+    for (i = 0; i < BU_PTBL_LEN(&dsp_mipmaps); i++) {
+	struct dsp_mipmap *mip = (struct dsp_mipmap *)BU_PTBL_GET(&dsp_mipmaps, i);
+	if (mip->key == key && (int)mip->xsiz == xsiz && (int)mip->ysiz == ysiz)
+	    return mip;
+    }
+    return NULL;
+}
 
-	xs = dsp->layer[curr_layer-1].dim[X];
-	if (xs % DIM_BB_CHILDREN)
-	    dsp->layer[curr_layer].dim[X] =
-		xs / DIM_BB_CHILDREN + 1;
-	else
-	    dsp->layer[curr_layer].dim[X] =
-		xs / DIM_BB_CHILDREN;
 
-	ys = dsp->layer[curr_layer-1].dim[Y];
-	if (ys % DIM_BB_CHILDREN)
-	    dsp->layer[curr_layer].dim[Y] =
-		ys / DIM_BB_CHILDREN + 1;
-	else
-	    dsp->layer[curr_layer].dim[Y] =
-		ys / DIM_BB_CHILDREN;
-
-	/* set the start of the array for this layer */
-	dsp->layer[curr_layer].p =
-	    &dsp->layer[curr_layer-1].p[dsp->layer[curr_layer-1].dim[X] * dsp->layer[curr_layer-1].dim[Y] ];
+/**
+ * Return the min/max mipmap for the elevation data of dsp, building it
+ * if no other solid is using the same data.  Release with dsp_mip_put.
+ */
+static struct dsp_mipmap *
+dsp_mip_get(struct dsp_specific *dsp)
+{
+    const void *key = dsp_mip_key(&dsp->dsp_i);
+    struct dsp_mipmap *mip, *existing;
+
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    mip = dsp_mip_find(key, dsp->xsiz, dsp->ysiz);
+    if (mip)
+	mip->uses++;
+    bu_semaphore_release(RT_SEM_MODEL);
+    if (mip)
+	return mip;
+
+    /* build without holding the lock - if another solid sharing the
+     * data got there first, use its copy instead
+     */
+    mip = dsp_mip_build(dsp, key);
 
-	curr = &dsp->layer[curr_layer];
-	prev = &dsp->layer[curr_layer-1];
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    existing = dsp_mip_find(key, dsp->xsiz, dsp->ysiz);
+    if (existing) {
+	existing->uses++;
+    } else {
+	mip->uses = 1;
+	bu_ptbl_ins(&dsp_mipmaps, (long *)mip);
+    }
+    bu_semaphore_release(RT_SEM_MODEL);
 
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log("layer %d  subcell size %d\n", curr_layer, subcell_size);
+    if (existing) {
+	if (mip->nodes)
+	    bu_free(mip->nodes, "dsp mipmap nodes");
+	bu_free(mip, "dsp mipmap");
+	return existing;
+    }
+    return mip;
+}
 
-	/* walk the grid and fill in the values for this layer */
-	for (y = 0; y < curr->dim[Y]; y++) {
-	    for (x = 0; x < curr->dim[X]; x++) {
-		int n, xp, yp;
-		/* x, y are in the coordinates in the current
-		 * layer.  xp, yp are the coordinates of the
-		 * same area in the previous (lower) layer.
-		 */
-		xp = x * DIM_BB_CHILDREN;
-		yp = y * DIM_BB_CHILDREN;
 
-		/* initialize the current dsp_bb cell */
-		dsp_bb = &curr->p[y*curr->dim[X]+x];
-		dsp_bb->magic = MAGIC_dsp_bb;
-		n = lrint(pow((double)DIM_BB_CHILDREN, (double)curr_layer));
-		VSET(dsp_bb->dspb_rpp.dsp_min,
-		     x * n, y * n, 0x0ffff);
-		VSET(dsp_bb->dspb_rpp.dsp_max,
-		     x * n, y * n, 0);
+static void
+dsp_mip_put(struct dsp_mipmap *mip)
+{
+    int unused;
 
-		/* record the dimensions of our children */
-		dsp_bb->dspb_subcell_size = subcell_size;
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    unused = (--mip->uses <= 0);
+    if (unused)
+	bu_ptbl_rm(&dsp_mipmaps, (long *)mip);
+    bu_semaphore_release(RT_SEM_MODEL);
 
+    if (unused) {
+	if (mip->nodes)
+	    bu_free(mip->nodes, "dsp mipmap nodes");
+	bu_free(mip, "dsp mipmap");
+    }
+}
 
-		tot = 0;
-		i = 0;
-		for (j = 0; j < DIM_BB_CHILDREN && (yp+j)<prev->dim[Y]; j++) {
-		    for (i = 0; i < DIM_BB_CHILDREN && (xp+i)<prev->dim[X]; i++) {
 
-			idx = (yp+j) * prev->dim[X] + xp+i;
+/**
+ * Elevation bounds of a node of the mipmap (or a cell, at level 0)
+ */
+static void
+dsp_mip_bounds(struct dsp_specific *dsp, int l, unsigned int x, unsigned int y, struct dsp_minmax *b)
+{
+    unsigned short elev;
 
-			t = &prev->p[ idx ].dspb_rpp;
+    if (l > 0) {
+	*b = dsp->mip->lvl[l][y * dsp->mip->dim[l][X] + x];
+	return;
+    }
 
-			VMINMAX(dsp_bb->dspb_rpp.dsp_min,
-				dsp_bb->dspb_rpp.dsp_max, t->dsp_min);
-			VMINMAX(dsp_bb->dspb_rpp.dsp_min,
-				dsp_bb->dspb_rpp.dsp_max, t->dsp_max);
+    b->min = b->max = DSP(&dsp->dsp_i, x, y);
+    elev = DSP(&dsp->dsp_i, x+1, y);
+    V_MIN(b->min, elev);
+    V_MAX(b->max, elev);
+    elev = DSP(&dsp->dsp_i, x, y+1);
+    V_MIN(b->min, elev);
+    V_MAX(b->max, elev);
+    elev = DSP(&dsp->dsp_i, x+1, y+1);
+    V_MIN(b->min, elev);
+    V_MAX(b->max, elev);
+}
 
-			dsp_bb->dspb_children[tot++] = &prev->p[ idx ];
 
-		    }
-		}
+/**
+ * Overall elevation bounds of a DSP.  Uses the bounds of a prepped
+ * solid sharing the data if there is one, rather than scanning the
+ * elevations.
+ */
+static void
+dsp_elev_bounds(struct dsp_specific *dsp, unsigned short *d_min, unsigned short *d_max)
+{
+    struct dsp_mipmap *mip;
+    unsigned short elev;
+    int x, y;
 
-		dsp_bb->dspb_ch_dim[X] = i;
-		dsp_bb->dspb_ch_dim[Y] = j;
-	    }
-	}
-	subcell_size *= DIM_BB_CHILDREN;
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    mip = dsp_mip_find(dsp_mip_key(&dsp->dsp_i), dsp->xsiz, dsp->ysiz);
+    if (mip) {
+	*d_min = mip->bounds.min;
+	*d_max = mip->bounds.max;
     }
+    bu_semaphore_release(RT_SEM_MODEL);
+    if (mip)
+	return;
 
-#ifdef PLOT_LAYERS
-    if (RT_G_DEBUG & RT_DEBUG_HF) {
-	plot_layers(dsp);
-	bu_log("_  x:%u y:%u min %d max %d\n",
-	       XCNT(dsp), YCNT(dsp), dsp_min, dsp_max);
+    *d_min = 0xffff;
+    *d_max = 0;
+    for (y = 0; y <= dsp->ysiz; y++) {
+	for (x = 0; x <= dsp->xsiz; x++) {
+	    elev = DSP(&dsp->dsp_i, x, y);
+	    V_MIN(*d_min, elev);
+	    V_MAX(*d_max, elev);
+	}
     }
-#endif
 }
 
+
 /**
  * Calculate the bounding box for a dsp.
  */
@@ -886,8 +972,8 @@ rt_dsp_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
     ds.ysiz = dsp_ip->dsp_ycnt-1;	/* size is # cells or values-1 */
 
 
-    /* compute the multi-resolution bounding boxes */
-    dsp_layers(&ds, &dsp_min, &dsp_max);
+    /* the elevation range of the data */
+    dsp_elev_bounds(&ds, &dsp_min, &dsp_max);
 
 
     /* record the distance to each of the bounding planes */
@@ -1002,6 +1088,7 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
      * We'll have to copy the data for that one.
      */
     dsp->dsp_i = *dsp_ip;		/* struct copy */
+    rt_shared_data_ref(dsp->dsp_i.dsp_buf);
 
     /* this keeps the binary internal object from being freed */
     dsp_ip->dsp_bip = (struct rt_db_internal *)NULL;
@@ -1011,8 +1098,17 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     dsp->ysiz = dsp_ip->dsp_ycnt-1;	/* size is # cells or values-1 */
 
 
-    /* compute the multi-resolution bounding boxes */
-    dsp_layers(dsp, &dsp_min, &dsp_max);
+    /* the elevation bounds hierarchy, shared with any other solids
+     * using the same data
+     */
+    dsp->mip = dsp_mip_get(dsp);
+    dsp_min = dsp->mip->bounds.min;
+    dsp_max = dsp->mip->bounds.max;
+
+    if (RT_G_DEBUG & RT_DEBUG_HF) {
+	bu_log("dsp mipmap bounds: %u %u (%d users)\n", dsp_min, dsp_max, dsp->mip->uses);
+	plot_layers(dsp);
+    }
 
 
     /* record the distance to each of the bounding planes */
@@ -1741,7 +1837,7 @@ check_bbpt_hit_elev(int i,	/* indicates face of cell */
  * 1 Terminate intersection computation
  */
 static int
-isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
+isect_ray_cell_top(struct isect_stuff *isect, struct dsp_rpp *rpp)
 {
     point_t A, B, C, D, P;
     int x, y;
@@ -1759,7 +1855,6 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	memset(hits+x, 0, sizeof(struct hit));
 
     dlog("isect_ray_cell_top\n");
-    DSP_BB_CK(dsp_bb);
 
     /* assign the values for the corner points
      *
@@ -1769,17 +1864,17 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
      *  |    |
      *  A----B
      */
-    x = dsp_bb->dspb_rpp.dsp_min[X];
-    y = dsp_bb->dspb_rpp.dsp_min[Y];
+    x = rpp->dsp_min[X];
+    y = rpp->dsp_min[Y];
     VSET(A, x, y, DSP(&isect->dsp->dsp_i, x, y));
 
-    x = dsp_bb->dspb_rpp.dsp_max[X];
+    x = rpp->dsp_max[X];
     VSET(B, x, y, DSP(&isect->dsp->dsp_i, x, y));
 
-    y = dsp_bb->dspb_rpp.dsp_max[Y];
+    y = rpp->dsp_max[Y];
     VSET(D, x, y, DSP(&isect->dsp->dsp_i, x, y));
 
-    x = dsp_bb->dspb_rpp.dsp_min[X];
+    x = rpp->dsp_min[X];
     VSET(C, x, y, DSP(&isect->dsp->dsp_i, x, y));
 
 
@@ -1795,7 +1890,7 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	VMOVE(hits[1].hit_point, p2);
 	hits[1].hit_dist = isect->r.r_max;
 
-	plot_cell_top(isect, dsp_bb, A, B, C, D, hits, 3, 0);
+	plot_cell_top(isect, rpp, A, B, C, D, hits, 3, 0);
     }
 #endif
 
@@ -1809,8 +1904,8 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	VMOVE(hits[0].hit_point, P);
 	VMOVE(hits[0].hit_normal, dsp_pl[isect->dmin]);
 	/* vpriv */
-	hits[0].hit_vpriv[X] = dsp_bb->dspb_rpp.dsp_min[X];
-	hits[0].hit_vpriv[Y] = dsp_bb->dspb_rpp.dsp_min[Y];
+	hits[0].hit_vpriv[X] = rpp->dsp_min[X];
+	hits[0].hit_vpriv[Y] = rpp->dsp_min[Y];
 	/* private */
 	hits[0].hit_surfno = isect->dmin;
 
@@ -1836,8 +1931,8 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	VMOVE(hits[3].hit_point, P);
 	VMOVE(hits[3].hit_normal, dsp_pl[isect->dmax]);
 	/* vpriv */
-	hits[3].hit_vpriv[X] = dsp_bb->dspb_rpp.dsp_min[X];
-	hits[3].hit_vpriv[Y] = dsp_bb->dspb_rpp.dsp_min[Y];
+	hits[3].hit_vpriv[X] = rpp->dsp_min[X];
+	hits[3].hit_vpriv[Y] = rpp->dsp_min[Y];
 	/* private */
 	hits[3].hit_surfno = isect->dmax;
 
@@ -1855,14 +1950,14 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
     }
 
 
-    (void)permute_cell(A, B, C, D, isect->dsp, &dsp_bb->dspb_rpp);
+    (void)permute_cell(A, B, C, D, isect->dsp, rpp);
 
     if ((cond=isect_ray_triangle(isect, B, D, A, &hits[1], ab_first)) > 0.0) {
 	/* hit triangle */
 
 	/* record cell */
-	hits[1].hit_vpriv[X] = dsp_bb->dspb_rpp.dsp_min[X];
-	hits[1].hit_vpriv[Y] = dsp_bb->dspb_rpp.dsp_min[Y];
+	hits[1].hit_vpriv[X] = rpp->dsp_min[X];
+	hits[1].hit_vpriv[Y] = rpp->dsp_min[Y];
 	hits[1].hit_surfno = ZTOP; /* indicate we hit the top */
 
 	hitcount++;
@@ -1878,8 +1973,8 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	/* hit triangle */
 
 	/* record cell */
-	hits[2].hit_vpriv[X] = dsp_bb->dspb_rpp.dsp_min[X];
-	hits[2].hit_vpriv[Y] = dsp_bb->dspb_rpp.dsp_min[Y];
+	hits[2].hit_vpriv[X] = rpp->dsp_min[X];
+	hits[2].hit_vpriv[Y] = rpp->dsp_min[Y];
 	hits[2].hit_surfno = ZTOP; /* indicate we hit the top */
 
 	hitcount++;
@@ -1913,7 +2008,7 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
     if (RT_G_DEBUG & RT_DEBUG_HF) {
 	bu_log("hitcount: %d flags: 0x%0x\n", hitcount, hitf);
 
-	plot_cell_top(isect, dsp_bb, A, B, C, D, hits, hitf, 1);
+	plot_cell_top(isect, rpp, A, B, C, D, hits, hitf, 1);
 	for (i = 0; i < 4; i++) {
 	    if (hitf & (1<<i)) {
 		fastf_t v = VDOT(isect->r.r_dir, hits[i].hit_normal);
@@ -1956,8 +2051,8 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 		}
 
 		/* int/float conv */
-		VMOVE(bbmin, dsp_bb->dspb_rpp.dsp_min);
-		VMOVE(bbmax, dsp_bb->dspb_rpp.dsp_max);
+		VMOVE(bbmin, rpp->dsp_min);
+		VMOVE(bbmax, rpp->dsp_max);
 
 		/* create seg with hits[i].hit_point as out point */
 		if (add_seg(isect, hitp, &hits[i], bbmin, bbmax, 255, 255, 255))
@@ -1993,7 +2088,7 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	hits[1].hit_dist = isect->r.r_max;
 
 	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    plot_cell_top(isect, dsp_bb, A, B, C, D, hits, 3, 0);
+	    plot_cell_top(isect, rpp, A, B, C, D, hits, 3, 0);
     }
     return 0;
 }
@@ -2141,183 +2236,16 @@ dsp_in_rpp(struct isect_stuff *isect,
 }
 
 
-#ifdef ORDERED_ISECT
-static int
-isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb);
-
-
 /**
- * Return
- * 0 continue intersection calculations
- * 1 Terminate intersection computation
- */
-static int
-recurse_dsp_bb(struct isect_stuff *isect,
-	       struct dsp_bb *dsp_bb,
-	       point_t minpt, /* entry point of dsp_bb */
-	       point_t UNUSED(maxpt), /* exit point of dsp_bb */
-	       point_t bbmin, /* min point of bb (Z=0) */
-	       point_t UNUSED(bbmax)) /* max point of bb */
-{
-    fastf_t tDX;		/* dist along ray to span 1 cell in X dir */
-    fastf_t tDY;		/* dist along ray to span 1 cell in Y dir */
-    fastf_t tX, tY;	/* dist from hit pt. to next cell boundary */
-    fastf_t curr_dist;
-    short cX, cY;	/* coordinates of current cell */
-    short cs;		/* cell X, Y dimension */
-    short stepX, stepY;	/* dist to step in child array for each dir */
-    short stepPX, stepPY;
-    fastf_t out_dist;
-    struct dsp_bb **p;
-    fastf_t *stom = &isect->dsp->dsp_i.dsp_stom[0];
-    point_t pt, v;
-    int loop = 0;
-
-    DSP_BB_CK(dsp_bb);
-
-    /* compute the size of a cell in each direction */
-    cs = dsp_bb->dspb_subcell_size;
-
-    /* compute current cell */
-    cX = (minpt[X] - bbmin[X]) / cs;
-    cY = (minpt[Y] - bbmin[Y]) / cs;
-
-    /* a little bounds checking because a hit on XMAX or YMAX looks
-     * like it should be in the next cell outside the box
-     */
-    if (cX >= dsp_bb->dspb_ch_dim[X]) cX = dsp_bb->dspb_ch_dim[X] - 1;
-    if (cY >= dsp_bb->dspb_ch_dim[Y]) cY = dsp_bb->dspb_ch_dim[Y] - 1;
-
-#ifdef FULL_DSP_DEBUGGING
-    dlog("recurse_dsp_bb  cell size: %d  current cell: %d %d\n",
-	 cs, cX, cY);
-    dlog("dspb_ch_dim x:%d  y:%d\n",
-	 dsp_bb->dspb_ch_dim[X], dsp_bb->dspb_ch_dim[Y]);
-#endif
-
-    tX = tY = curr_dist = isect->r.r_min;
-
-    if (isect->r.r_dir[X] < 0.0) {
-	stepPX = stepX = -1;
-	/* tDX is the distance along the ray we have to travel to
-	 * traverse a cell (travel a unit distance) along the X axis
-	 * of the grid
-	 */
-	tDX = -cs / isect->r.r_dir[X];
-
-	/* tX is the distance along the ray to the first cell boundary
-	 * in the X direction beyond our hit point (minpt)
-	 */
-	tX += ((bbmin[X] + (cX * cs)) - minpt[X]) / isect->r.r_dir[X];
-    } else {
-	stepPX = stepX = 1;
-	tDX = cs / isect->r.r_dir[X];
-
-	if (isect->r.r_dir[X] > 0.0)
-	    tX += ((bbmin[X] + ((cX+1) * cs)) - minpt[X]) / isect->r.r_dir[X];
-	else
-	    tX = MAX_FASTF; /* infinite distance to next X boundary */
-    }
-
-    if (isect->r.r_dir[Y] < 0) {
-	/* distance in dspb_children we have to move to step in Y dir
-	 */
-	stepY = -1;
-	stepPY = -dsp_bb->dspb_ch_dim[X];
-	tDY = -cs / isect->r.r_dir[Y];
-	tY += ((bbmin[Y] + (cY * cs)) - minpt[Y]) / isect->r.r_dir[Y];
-    } else {
-	stepY = 1;
-	stepPY = dsp_bb->dspb_ch_dim[X];
-	tDY = cs / isect->r.r_dir[Y];
-
-	if (isect->r.r_dir[Y] > 0.0)
-	    tY += ((bbmin[Y] + ((cY+1) * cs)) - minpt[Y]) / isect->r.r_dir[Y];
-	else
-	    tY = MAX_FASTF;
-    }
-
-    /* factor in the tolerance to the out-distance */
-    out_dist = isect->r.r_max - isect->tol->dist;
-
-    p = &dsp_bb->dspb_children[dsp_bb->dspb_ch_dim[X] * cY + cX];
-#ifdef FULL_DSP_DEBUGGING
-    dlog("tX:%g tY:%g\n", tX, tY);
-
-#endif
-
-    do {
-	/* intersect with the current cell */
-	if (RT_G_DEBUG & RT_DEBUG_HF) {
-	    if (loop)
-		bu_log("\nisect sub-cell %d %d  curr_dist:%g out_dist: %g",
-		       cX, cY, curr_dist, out_dist);
-	    else {
-		bu_log("isect sub-cell %d %d  curr_dist:%g out_dist %g",
-		       cX, cY, curr_dist, out_dist);
-		loop = 1;
-	    }
-	    VJOIN1(pt, isect->r.r_pt, curr_dist, isect->r.r_dir);
-	    MAT4X3PNT(v, stom, pt);
-	    bu_log("pt %g %g %g\n", V3ARGS(v));
-	}
-
-	/* get pointer to the current child cell.  Note the extra
-	 * level of indirection.  We want to march p through
-	 * dspb_children using pointer addition, but dspb_children
-	 * contains pointers.  We need to be sure to increment the
-	 * offset in the array, not the child pointer.
-	 */
-
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log_indent_delta(4);
-
-	if (isect_ray_dsp_bb(isect, *p)) return 1;
-
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log_indent_delta(-4);
-
-	/* figure out which cell is next */
-	if (tX < tY) {
-	    cX += stepX;  /* track cell offset for debugging */
-	    p += stepPX;
-#ifdef FULL_DSP_DEBUGGING
-	    dlog("stepping X to %d because %g < %g\n", cX, tX, tY);
-#endif
-	    curr_dist = tX;
-	    tX += tDX;
-	} else {
-	    cY += stepY;  /* track cell offset for debugging */
-	    p += stepPY;
-#ifdef FULL_DSP_DEBUGGING
-	    dlog("stepping Y to %d because %g >= %g\n", cY, tX, tY);
-#endif
-	    curr_dist = tY;
-	    tY += tDY;
-	}
-#ifdef FULL_DSP_DEBUGGING
-	dlog("curr_dist %g, out_dist %g\n", curr_dist, out_dist);
-#endif
-    } while (curr_dist < out_dist &&
-	     cX < dsp_bb->dspb_ch_dim[X] && cX >= 0 &&
-	     cY < dsp_bb->dspb_ch_dim[Y] && cY >= 0);
-
-    return 0;
-}
-
-
-#endif
-
-/**
- * Intersect a ray with a DSP bounding box.  This is the primary child
- * of rt_dsp_shot()
+ * Intersect a ray with a single cell of the DSP: the triangulated top
+ * and the "foundation" pillar underneath it.
  *
  * Return
  * 0 continue intersection calculations
  * 1 Terminate intersection computation
  */
 static int
-isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
+isect_ray_dsp_cell(struct isect_stuff *isect, struct dsp_rpp *cell)
 {
     point_t bbmin, bbmax;
     point_t minpt, maxpt;
@@ -2327,56 +2255,38 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
     static int plotnum;
     fastf_t *stom;
     point_t pt;
-    struct xray *r = &isect->r; /* Does this buy us anything? */
-
-    if (dsp_bb) {
-	DSP_BB_CK(dsp_bb);
-    } else {
-	bu_log("%s:%d null ptr pixel %d %d\n",
-	       __FILE__, __LINE__, isect->ap->a_x,  isect->ap->a_y);
-	bu_bomb("");
-    }
+    struct xray *r = &isect->r;
 
     if (RT_G_DEBUG & RT_DEBUG_HF) {
-	bu_log("\nisect_ray_dsp_bb((%d, %d, %d) (%d, %d, %d))\n",
-	       V3ARGS(dsp_bb->dspb_rpp.dsp_min),
-	       V3ARGS(dsp_bb->dspb_rpp.dsp_max));
+	bu_log("\nisect_ray_dsp_cell((%d, %d, %d) (%d, %d, %d))\n",
+	       V3ARGS(cell->dsp_min),
+	       V3ARGS(cell->dsp_max));
     }
 
-    /* check to see if we miss the RPP for this area entirely */
-    VMOVE(bbmax, dsp_bb->dspb_rpp.dsp_max);
-    VSET(bbmin,
-	 dsp_bb->dspb_rpp.dsp_min[X],
-	 dsp_bb->dspb_rpp.dsp_min[Y], 0.0);
-
+    /* check to see if we miss the RPP for this cell entirely */
+    VMOVE(bbmax, cell->dsp_max);
+    VSET(bbmin, cell->dsp_min[X], cell->dsp_min[Y], 0.0);
 
     if (! dsp_in_rpp(isect, bbmin, bbmax)) {
 	/* missed it all, just return */
 
 	if (RT_G_DEBUG & RT_DEBUG_HF) {
 	    bu_log("missed... ");
-	    fclose(draw_dsp_bb(&plotnum, dsp_bb, isect->dsp, 0, 150, 0));
+	    fclose(draw_dsp_rpp(&plotnum, cell, isect->dsp, 0, 150, 0));
 	}
 
 	return 0;
     }
 
-    /* At this point we know that we've hit the overall bounding box
-     */
-
     VJOIN1(minpt, r->r_pt, r->r_min, r->r_dir);
     VJOIN1(maxpt, r->r_pt, r->r_max, r->r_dir);
-    /* We could do the following:
-     *
-     * however, we only need the Z values now, and benchmarking show
-     * that this is an expensive
-     */
+
     if (RT_G_DEBUG & RT_DEBUG_HF) {
 
 	stom = &isect->dsp->dsp_i.dsp_stom[0];
 
 	bu_log("hit b-box ");
-	fp = draw_dsp_bb(&plotnum, dsp_bb, isect->dsp, 200, 200, 100);
+	fp = draw_dsp_rpp(&plotnum, cell, isect->dsp, 200, 200, 100);
 
 	pl_color(fp, 150, 150, 255);
 	MAT4X3PNT(pt, stom, minpt);
@@ -2387,11 +2297,10 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	fclose(fp);
     }
 
-
     /* if both hits are UNDER the top of the "foundation" pillar, we
      * can just add a segment for that range and return
      */
-    min_z = dsp_bb->dspb_rpp.dsp_min[Z];
+    min_z = cell->dsp_min[Z];
 
     if (minpt[Z] < min_z && maxpt[Z] < min_z) {
 	/* add hit segment */
@@ -2403,28 +2312,18 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	seg_in.hit_dist = r->r_min;
 	VMOVE(seg_in.hit_point, minpt);
 	VMOVE(seg_in.hit_normal, dsp_pl[isect->dmin]);
-	/* hit_priv */
-	/* hit_private */
 	seg_in.hit_surfno = isect->dmin;
-	/* hit_rayp */
 
+	seg_out.hit_magic = RT_HIT_MAGIC;
 	seg_out.hit_dist = r->r_max;
-
 	VMOVE(seg_out.hit_point, maxpt);
 	VMOVE(seg_out.hit_normal, dsp_pl[isect->dmax]);
-	/* hit_priv */
-	/* hit_private */
 	seg_out.hit_surfno = isect->dmax;
-	/* hit_rayp */
 
 	if (RT_G_DEBUG & RT_DEBUG_HF) {
-	    /* we need these for debug output
-	     * VMOVE(seg_in.hit_point, minpt);
-	     * VMOVE(seg_out.hit_point, maxpt);
-	     */
 	    /* create a special bounding box for plotting purposes */
-	    VMOVE(bbmax,  dsp_bb->dspb_rpp.dsp_max);
-	    VMOVE(bbmin,  dsp_bb->dspb_rpp.dsp_min);
+	    VMOVE(bbmax, cell->dsp_max);
+	    VMOVE(bbmin, cell->dsp_min);
 	    bbmax[Z] = bbmin[Z];
 	    bbmin[Z] = 0.0;
 	}
@@ -2433,37 +2332,6 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	return add_seg(isect, &seg_in, &seg_out, bbmin, bbmax, 0, 255, 255);
     }
 
-
-    /* We've hit something where we might be going through the
-     * boundary.  We've got to intersect the children
-     */
-    if (dsp_bb->dspb_ch_dim[0]) {
-#ifdef ORDERED_ISECT
-	return recurse_dsp_bb(isect, dsp_bb, minpt, maxpt, bbmin, bbmax);
-#else
-	int i;
-	/* there are children, so we recurse */
-	i = dsp_bb->dspb_ch_dim[X] * dsp_bb->dspb_ch_dim[Y] - 1;
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log_indent_delta(4);
-
-	for (; i >= 0; i--)
-	    isect_ray_dsp_bb(isect, dsp_bb->dspb_children[i]);
-
-	if (RT_G_DEBUG & RT_DEBUG_HF)
-	    bu_log_indent_delta(-4);
-
-	return 0;
-
-#endif
-    }
-
-    /***********************************************************************
-     *
-     * This section is for level 0 intersections only
-     *
-     ***********************************************************************/
-
     /* intersect the DSP grid surface geometry */
 
     /* Check for a hit on the triangulated zone on top.  This gives us
@@ -2474,11 +2342,11 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
      * just pass through the "foundation " pillar underneath (see test
      * above)
      */
-    bbmin[Z] = dsp_bb->dspb_rpp.dsp_min[Z];
+    bbmin[Z] = cell->dsp_min[Z];
     if (dsp_in_rpp(isect, bbmin, bbmax)) {
 	/* hit rpp */
 
-	isect_ray_cell_top(isect, dsp_bb);
+	isect_ray_cell_top(isect, cell);
     }
 
 
@@ -2486,7 +2354,7 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
      * ray may have entered through the top of the pillar, possibly
      * after having come down through the triangles above
      */
-    bbmax[Z] = dsp_bb->dspb_rpp.dsp_min[Z];
+    bbmax[Z] = cell->dsp_min[Z];
     bbmin[Z] = 0.0;
     if (dsp_in_rpp(isect, bbmin, bbmax)) {
 	/* hit rpp */
@@ -2515,6 +2383,184 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 }
 
 
+/* the cell containing coordinate v, for a ray heading in direction d */
+static int64_t
+dsp_mip_cell(fastf_t v, fastf_t d, int64_t siz)
+{
+    int64_t c = (int64_t)floor(v);
+
+    /* on a cell boundary the ray is in the cell it is heading into */
+    if (d < 0.0 && ZERO(v - (fastf_t)c))
+	c--;
+
+    if (c < 0)
+	c = 0;
+    if (c >= siz)
+	c = siz - 1;
+    return c;
+}
+
+
+/**
+ * Intersect a ray with a DSP by walking the min/max mipmap.  This is
+ * the primary child of rt_dsp_shot()
+ *
+ * The walk visits the nodes along the ray in order without a stack.
+ * Starting with the root, a node the ray passes entirely above is
+ * stepped across, and a node the ray passes entirely below the minimum
+ * elevation of is a solid segment.  Otherwise the ray descends into the
+ * child containing the current point.  After each step the walk goes up
+ * a level, so large empty (or solid) areas are crossed in a few steps.
+ *
+ * Return
+ * 0 continue intersection calculations
+ * 1 Terminate intersection computation
+ */
+static int
+isect_ray_dsp_mip(struct isect_stuff *isect)
+{
+    struct dsp_mipmap *mip = isect->dsp->mip;
+    struct xray *r = &isect->r;
+    int64_t xsiz = mip->xsiz;
+    int64_t ysiz = mip->ysiz;
+    point_t bbmin, bbmax;
+    fastf_t t, tend, texit, tx, ty;
+    int in_face, end_face, exit_face;
+    int64_t cx, cy, x0, x1, y0, y1;
+    int l, done;
+
+    if (xsiz < 1 || ysiz < 1)
+	return 0;
+
+    VSETALL(bbmin, 0.0);
+    VSET(bbmax, (fastf_t)xsiz, (fastf_t)ysiz, (fastf_t)mip->bounds.max);
+    if (!dsp_in_rpp(isect, bbmin, bbmax))
+	return 0;
+
+    t = r->r_min;
+    tend = r->r_max;
+    in_face = isect->dmin;
+    end_face = isect->dmax;
+
+    cx = dsp_mip_cell(r->r_pt[X] + t * r->r_dir[X], r->r_dir[X], xsiz);
+    cy = dsp_mip_cell(r->r_pt[Y] + t * r->r_dir[Y], r->r_dir[Y], ysiz);
+
+    l = mip->top;
+    while (1) {
+	/* extent of the node containing cell (cx, cy) at level l */
+	x0 = (cx >> l) << l;
+	x1 = x0 + ((int64_t)1 << l);
+	if (x1 > xsiz) x1 = xsiz;
+	y0 = (cy >> l) << l;
+	y1 = y0 + ((int64_t)1 << l);
+	if (y1 > ysiz) y1 = ysiz;
+
+	/* where the ray leaves the node column */
+	if (r->r_dir[X] > 0.0)
+	    tx = ((fastf_t)x1 - r->r_pt[X]) * isect->inv_dir[X];
+	else if (r->r_dir[X] < 0.0)
+	    tx = ((fastf_t)x0 - r->r_pt[X]) * isect->inv_dir[X];
+	else
+	    tx = INFINITY;
+	if (r->r_dir[Y] > 0.0)
+	    ty = ((fastf_t)y1 - r->r_pt[Y]) * isect->inv_dir[Y];
+	else if (r->r_dir[Y] < 0.0)
+	    ty = ((fastf_t)y0 - r->r_pt[Y]) * isect->inv_dir[Y];
+	else
+	    ty = INFINITY;
+
+	if (tx < ty) {
+	    texit = tx;
+	    exit_face = (r->r_dir[X] > 0.0) ? XMAX : XMIN;
+	} else {
+	    texit = ty;
+	    exit_face = (r->r_dir[Y] > 0.0) ? YMAX : YMIN;
+	}
+	done = 0;
+	if (texit >= tend) {
+	    texit = tend;
+	    exit_face = end_face;
+	    done = 1;
+	}
+	if (texit < t)
+	    texit = t;
+
+	if (l == 0) {
+	    struct dsp_minmax b;
+	    struct dsp_rpp cell;
+
+	    dsp_mip_bounds(isect->dsp, 0, (unsigned int)cx, (unsigned int)cy, &b);
+	    VSET(cell.dsp_min, (unsigned short)cx, (unsigned short)cy, b.min);
+	    VSET(cell.dsp_max, (unsigned short)(cx+1), (unsigned short)(cy+1), b.max);
+
+	    if (isect_ray_dsp_cell(isect, &cell))
+		return 1;
+	} else {
+	    struct dsp_minmax b;
+	    fastf_t z_in = r->r_pt[Z] + t * r->r_dir[Z];
+	    fastf_t z_out = r->r_pt[Z] + texit * r->r_dir[Z];
+
+	    dsp_mip_bounds(isect->dsp, l, (unsigned int)(cx >> l), (unsigned int)(cy >> l), &b);
+
+	    if (z_in < b.min && z_out < b.min) {
+		/* under the lowest point of the node - solid all the way */
+		struct hit in_hit, out_hit;
+		VSETALL(in_hit.hit_vpriv, 0.0);
+		VSETALL(out_hit.hit_vpriv, 0.0);
+
+		in_hit.hit_magic = RT_HIT_MAGIC;
+		in_hit.hit_dist = t;
+		VJOIN1(in_hit.hit_point, r->r_pt, t, r->r_dir);
+		VMOVE(in_hit.hit_normal, dsp_pl[in_face]);
+		in_hit.hit_surfno = in_face;
+
+		out_hit.hit_magic = RT_HIT_MAGIC;
+		out_hit.hit_dist = texit;
+		VJOIN1(out_hit.hit_point, r->r_pt, texit, r->r_dir);
+		VMOVE(out_hit.hit_normal, dsp_pl[exit_face]);
+		out_hit.hit_surfno = exit_face;
+
+		VSET(bbmin, (fastf_t)x0, (fastf_t)y0, 0.0);
+		VSET(bbmax, (fastf_t)x1, (fastf_t)y1, (fastf_t)b.min);
+		if (add_seg(isect, &in_hit, &out_hit, bbmin, bbmax, 0, 255, 255))
+		    return 1;
+	    } else if (z_in <= b.max || z_out <= b.max) {
+		/* the ray may cross the surface within this node */
+		l--;
+		continue;
+	    }
+	    /* otherwise the ray passes above the node */
+	}
+
+	/* step to the neighboring node */
+	if (done)
+	    return 0;
+
+	t = texit;
+	if (exit_face == XMIN || exit_face == XMAX) {
+	    cx = (exit_face == XMAX) ? x1 : x0 - 1;
+	    if (cx < 0 || cx >= xsiz)
+		return 0;
+	    cy = dsp_mip_cell(r->r_pt[Y] + t * r->r_dir[Y], r->r_dir[Y], ysiz);
+	    if (cy < y0) cy = y0;
+	    if (cy >= y1) cy = y1 - 1;
+	    in_face = (exit_face == XMAX) ? XMIN : XMAX;
+	} else {
+	    cy = (exit_face == YMAX) ? y1 : y0 - 1;
+	    if (cy < 0 || cy >= ysiz)
+		return 0;
+	    cx = dsp_mip_cell(r->r_pt[X] + t * r->r_dir[X], r->r_dir[X], xsiz);
+	    if (cx < x0) cx = x0;
+	    if (cx >= x1) cx = x1 - 1;
+	    in_face = (exit_face == YMAX) ? YMIN : YMAX;
+	}
+
+	if (l < mip->top)
+	    l++;
+    }
+}
+
+
 /**
  * Intersect a ray with a dsp.
  * If an intersection occurs, a struct seg will be acquired
@@ -2583,19 +2629,8 @@ rt_dsp_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	       V3ARGS(isect.r.r_dir));
     }
 
-    /* We look at the topmost layer of the bounding-box tree and make
-     * sure that it has dimension 1.  Otherwise, something is wrong
-     */
-    if (isect.dsp->layer[isect.dsp->layers-1].dim[X] != 1 ||
-	isect.dsp->layer[isect.dsp->layers-1].dim[Y] != 1) {
-	bu_log("%s:%d how do i find the topmost layer?\n",
-	       __FILE__, __LINE__);
-	bu_bomb("");
-    }
-
-
-    /* intersect the ray with the bounding rpps */
-    (void)isect_ray_dsp_bb(&isect, isect.dsp->layer[isect.dsp->layers-1].p);
+    /* walk the ray through the elevation bounds */
+    (void)isect_ray_dsp_mip(&isect);
 
     /* if we missed it all, give up now */
     if (BU_LIST_IS_EMPTY(&isect.seglist))
@@ -3076,17 +3111,18 @@ rt_dsp_free(register struct soltab *stp)
     if (RT_G_DEBUG & RT_DEBUG_HF)
 	bu_log("rt_dsp_free()\n");
 
+    if (dsp->mip)
+	dsp_mip_put(dsp->mip);
+
     switch (dsp->dsp_i.dsp_datasrc) {
 	case RT_DSP_SRC_V4_FILE:
 	case RT_DSP_SRC_FILE:
 	    bu_close_mapped_file(dsp->dsp_i.dsp_mp);
-	    if (dsp->dsp_i.dsp_buf) {
-		bu_free(dsp->dsp_i.dsp_buf, "dsp fake data");
-	    }
 	    break;
 	case RT_DSP_SRC_OBJ:
 	    break;
     }
+    rt_shared_data_put(dsp->dsp_i.dsp_buf);
 
     BU_PUT(dsp, struct dsp_specific);
 }
@@ -3999,23 +4035,32 @@ get_file_data(struct rt_dsp_internal *dsp_ip, const struct db_i *dbip)
     out_cookie = bu_cv_cookie("hus");
 
     if (bu_cv_optimize(in_cookie) != bu_cv_optimize(out_cookie)) {
-	size_t got;
 	/* if we're on a little-endian machine we convert the input
-	 * file from network to host format
+	 * file from network to host format, once for all the solids
+	 * using this file
 	 */
-	count = dsp_ip->dsp_xcnt * dsp_ip->dsp_ycnt;
-	mf->apbuflen = count * sizeof(unsigned short);
-	mf->apbuf = bu_malloc(mf->apbuflen, "apbuf");
-
-	got = bu_cv_w_cookie(mf->apbuf, out_cookie, mf->apbuflen,
-			     mf->buf,    in_cookie, count);
-	if (got != (size_t)count) {
-	    bu_log("got %zu != count %d", got, count);
-	    bu_bomb("\n");
+	uint32_t dims[2];
+
+	dims[X] = dsp_ip->dsp_xcnt;
+	dims[Y] = dsp_ip->dsp_ycnt;
+	dsp_ip->dsp_buf = (unsigned short *)rt_shared_data_get("dsp", dims, 2, mf);
+	if (!dsp_ip->dsp_buf) {
+	    size_t got;
+	    unsigned short *buf;
+
+	    count = dsp_ip->dsp_xcnt * dsp_ip->dsp_ycnt;
+	    buf = (unsigned short *)bu_malloc(count * sizeof(unsigned short), "dsp data");
+	    got = bu_cv_w_cookie(buf, out_cookie, count * sizeof(unsigned short),
+				 mf->buf, in_cookie, count);
+	    if (got != (size_t)count) {
+		bu_log("got %zu != count %d", got, count);
+		bu_bomb("\n");
+	    }
+	    dsp_ip->dsp_buf = (unsigned short *)rt_shared_data_add("dsp", dims, 2, mf, buf, count * sizeof(unsigned short));
 	}
-	dsp_ip->dsp_buf = (short unsigned int *)dsp_ip->dsp_mp->apbuf;
     } else {
-	dsp_ip->dsp_buf = (short unsigned int *)dsp_ip->dsp_mp->buf;
+	/* use the file data as mapped */
+	dsp_ip->dsp_buf = (unsigned short *)dsp_ip->dsp_mp->buf;
     }
     return 0;
 }
@@ -4035,6 +4080,8 @@ get_obj_data(struct rt_dsp_internal *dsp_ip, const struct db_i *dbip)
     int in_cookie, out_cookie;
     size_t got;
     int ret;
+    uint32_t dims[2];
+    unsigned short *buf;
 
     BU_ALLOC(dsp_ip->dsp_bip, struct rt_db_internal);
 
@@ -4085,12 +4132,12 @@ get_obj_data(struct rt_dsp_internal *dsp_ip, const struct db_i *dbip)
     in_cookie = bu_cv_cookie("nus"); /* data is network unsigned short */
     out_cookie = bu_cv_cookie("hus");
 
+    buf = (unsigned short *)bu_malloc(bip->count * sizeof(unsigned short), "dsp data");
     if (bu_cv_optimize(in_cookie) != bu_cv_optimize(out_cookie)) {
 	/* if we're on a little-endian machine we convert the input
 	 * file from network to host format
 	 */
-
-	got = bu_cv_w_cookie(bip->u.uint16, out_cookie,
+	got = bu_cv_w_cookie(buf, out_cookie,
 			     bip->count * sizeof(unsigned short),
 			     bip->u.uint16, in_cookie, bip->count);
 
@@ -4098,9 +4145,21 @@ get_obj_data(struct rt_dsp_internal *dsp_ip, const struct db_i *dbip)
 	    bu_log("got %zu != count %zu", got, bip->count);
 	    bu_bomb("\n");
 	}
+    } else {
+	memcpy(buf, bip->u.uint16, bip->count * sizeof(unsigned short));
     }
 
-    dsp_ip->dsp_buf = bip->u.uint16;
+    /* solids using objects with the same contents share one copy of
+     * the data
+     */
+    dims[X] = dsp_ip->dsp_xcnt;
+    dims[Y] = dsp_ip->dsp_ycnt;
+    dsp_ip->dsp_buf = (unsigned short *)rt_shared_data_add("dsp", dims, 2, NULL, buf, bip->count * sizeof(unsigned short));
+
+    /* the object's copy of the data is no longer needed */
+    bu_free(bip->u.uint16, "dsp binunif data");
+    bip->u.uint16 = NULL;
+
     return 0;
 }
 
@@ -4559,6 +4618,7 @@ rt_dsp_ifree(struct rt_db_internal *ip)
     RT_DSP_CK_MAGIC(dsp_ip);
 
     bu_close_mapped_file(dsp_ip->dsp_mp);
+    rt_shared_data_put(dsp_ip->dsp_buf);
 
     if (dsp_ip->dsp_bip) {
 	dsp_ip->dsp_bip->idb_meth->ft_ifree((struct rt_db_internal *) dsp_ip->dsp_bip);
@@ -30,6 +30,7 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <limits.h>
 #include <ctype.h>
 #include <math.h>
 #include <string.h>
@@ -55,6 +56,7 @@ struct rt_ebm_specific {
     vect_t ebm_origin;	/* local coords of grid origin (0, 0, 0) for now */
     vect_t ebm_large;	/* local coords of XYZ max */
     mat_t ebm_mat;	/* model to ideal space */
+    struct rt_brick_map ebm_bricks;	/* empty space skipping */
 };
 
 
@@ -110,22 +112,45 @@ extern int rt_seg_planeclip(struct seg *out_hd, struct seg *in_hd,
 unsigned char *
 bit(struct rt_ebm_internal *eip, size_t x, size_t y)
 {
-    unsigned char *ret = NULL;
-    switch (eip->datasrc) {
-	case RT_EBM_SRC_FILE:
-	    ret = &(((unsigned char *)(eip->mp->apbuf))[(y+BIT_YWIDEN)*(eip->xdim+BIT_XWIDEN*2)+x+BIT_XWIDEN]);
-	    break;
-	case RT_EBM_SRC_OBJ:
-	    ret = &((eip->buf)[(y+BIT_YWIDEN)*(eip->xdim+BIT_XWIDEN*2)+x+BIT_XWIDEN]);
-	    break;
-	default:
-	    bu_log("Unrecognized EBM data source (datasrc='%d')\n", eip->datasrc);
-	    bu_bomb("Internal Error, exiting.\n");
-    }
-    return ret;
+    /* the data from either source is decoded into buf */
+    return &((eip->buf)[(y+BIT_YWIDEN)*(eip->xdim+BIT_XWIDEN*2)+x+BIT_XWIDEN]);
 }
 
 
+/**
+ * Set eip->buf to the padded in-memory bitmap for the eip->xdim by
+ * eip->ydim bytes at data, keeping one copy for all the solids using
+ * the same bitmap.  A file source mp is only loaded once; data without
+ * one is matched after it has been padded.
+ *
+ * As with VOL, file data is copied rather than used from the mapping,
+ * since bit() and the brick maps address the padded layout.
+ */
+static void
+ebm_share_bitmap(struct rt_ebm_internal *eip, const struct bu_mapped_file *mp, const unsigned char *data)
+{
+    uint32_t dims[2];
+    unsigned char *buf;
+    size_t nbytes, y;
+
+    dims[X] = eip->xdim;
+    dims[Y] = eip->ydim;
+    eip->buf = (unsigned char *)rt_shared_data_get("ebm", dims, 2, mp);
+    if (eip->buf)
+	return;
+
+    nbytes = (eip->xdim+BIT_XWIDEN*2)*(eip->ydim+BIT_YWIDEN*2);
+    buf = (unsigned char *)bu_calloc(1, nbytes, "ebm bitmap");
+
+    /* Because of in-memory padding, read each scanline separately */
+    for (y = 0; y < eip->ydim; y++) {
+	memcpy(&buf[(y+BIT_YWIDEN)*(eip->xdim+BIT_XWIDEN*2)+BIT_XWIDEN], data, eip->xdim);
+	data += eip->xdim;
+    }
+
+    eip->buf = (unsigned char *)rt_shared_data_add("ebm", dims, 2, mp, buf, nbytes);
+}
+
 #ifdef USE_OPENCL
 /* largest data members first */
 struct clt_ebm_specific {
@@ -471,6 +496,35 @@ rt_ebm_dda(register struct xray *rp, struct soltab *stp, struct application *ap,
 	int val;
 	struct seg *segp;
 
+	/* Jump over bricks of cells that can't change inside */
+	if (ebmp->ebm_bricks.nlevels &&
+	    igrid[X] < ebmp->ebm_i.xdim && igrid[Y] < ebmp->ebm_i.ydim) {
+	    size_t cell[3];
+	    size_t steps[3];
+	    double texit;
+
+	    cell[X] = igrid[X];
+	    cell[Y] = igrid[Y];
+	    cell[Z] = 0;
+	    j = rt_brick_skip(&ebmp->ebm_bricks, cell, rp->r_dir, t, delta,
+			      1, UCHAR_MAX, inside, steps, &texit);
+	    if (j >= 0) {
+		if (RT_G_DEBUG&RT_DEBUG_EBM)bu_log("igrid [%zu %zu] skip to %g\n",
+						igrid[X], igrid[Y], texit);
+		for (out_index = X; out_index <= Y; out_index++) {
+		    t[out_index] += steps[out_index] * delta[out_index];
+		    if (rp->r_dir[out_index] > 0) {
+			igrid[out_index] += steps[out_index];
+		    } else {
+			igrid[out_index] -= steps[out_index];
+		    }
+		}
+		t0 = texit;
+		in_index = j;
+		continue;
+	    }
+	}
+
 	/* find minimum exit t value */
 	out_index = t[X] < t[Y] ? X : Y;
 
@@ -597,7 +651,6 @@ static int
 get_file_data(struct rt_ebm_internal *eip, const struct db_i *dbip)
 {
     struct bu_mapped_file *mp;
-    int nbytes;
 
     /* get file */
     mp = bu_open_mapped_file_with_path(dbip->dbi_filepath, eip->name, "ebm");
@@ -613,32 +666,8 @@ get_file_data(struct rt_ebm_internal *eip, const struct db_i *dbip)
 	return -1;
     }
 
-    nbytes = (eip->xdim+BIT_XWIDEN*2)*(eip->ydim+BIT_YWIDEN*2);
-
-    /* If first use of this file, prepare in-memory buffer */
-    if (!mp->apbuf) {
-	size_t y;
-	unsigned char* cp;
-
-	/* Prevent a multi-processor race */
-	bu_semaphore_acquire(RT_SEM_MODEL);
-	if (mp->apbuf) {
-	    /* someone else beat us, nothing more to do */
-	    bu_semaphore_release(RT_SEM_MODEL);
-	    return 0;
-	}
-	mp->apbuf = (uint8_t *)bu_calloc(1, nbytes, "rt_ebm_import4 bitmap");
-	mp->apbuflen = nbytes;
-	bu_semaphore_release(RT_SEM_MODEL);
-
-	/* Because of in-memory padding, read each scanline separately */
-	cp = (unsigned char*)mp->buf;
-	for (y = 0; y < eip->ydim; y++) {
-	    /* bit() addresses into mp->apbuf */
-	    memcpy(bit(eip, 0, y), cp, eip->xdim);
-	    cp += eip->xdim;
-	}
-    }
+    /* solids using the same file share one padded copy */
+    ebm_share_bitmap(eip, mp, (const unsigned char *)mp->buf);
     return 0;
 }
 
@@ -658,7 +687,6 @@ get_obj_data(struct rt_ebm_internal *eip, const struct db_i *dbip)
 {
     struct rt_binunif_internal *bip;
     int ret;
-    int nbytes;
 
     BU_ALLOC(eip->bip, struct rt_db_internal);
 
@@ -706,30 +734,12 @@ get_obj_data(struct rt_ebm_internal *eip, const struct db_i *dbip)
 	return -2;
     }
 
-    nbytes = (eip->xdim+BIT_XWIDEN*2)*(eip->ydim+BIT_YWIDEN*2);
-
-    if (!eip->buf) {
-	size_t y;
-	unsigned char* cp;
-
-	/* Prevent a multi-processor race */
-	bu_semaphore_acquire(RT_SEM_MODEL);
-	if (eip->buf) {
-	    /* someone else beat us, nothing more to do */
-	    bu_semaphore_release(RT_SEM_MODEL);
-	    return 0;
-	}
-	eip->buf = (unsigned char *)bu_calloc(1, nbytes, "rt_ebm_import4 bitmap");
-	bu_semaphore_release(RT_SEM_MODEL);
-
-	/* Because of in-memory padding, read each scanline separately */
-	cp = (unsigned char *)bip->u.uint8;
-	for (y = 0; y < eip->ydim; y++) {
-	    /* bit() addresses into buf */
-	    memcpy(bit(eip, 0, y), cp, eip->xdim);
-	    cp += eip->xdim;
-	}
-    }
+    /* solids using objects with the same contents share one padded
+     * copy, and the object's copy of the data is no longer needed
+     */
+    ebm_share_bitmap(eip, NULL, (const unsigned char *)bip->u.uint8);
+    bu_free(bip->u.uint8, "ebm binunif data");
+    bip->u.uint8 = NULL;
     return 0;
 }
 
@@ -801,7 +811,6 @@ rt_ebm_import4(struct rt_db_internal *ip, const struct bu_external *ep, const fa
     union record *rp;
     register struct rt_ebm_internal *eip;
     struct bu_vls str = BU_VLS_INIT_ZERO;
-    int nbytes;
     mat_t tmat;
     struct bu_mapped_file *mp;
 
@@ -867,33 +876,7 @@ rt_ebm_import4(struct rt_db_internal *ip, const struct bu_external *ep, const fa
 	goto fail;
     }
 
-    nbytes = (eip->xdim+BIT_XWIDEN*2)*(eip->ydim+BIT_YWIDEN*2);
-
-    /* If first use of this file, prepare in-memory buffer */
-    if (!mp->apbuf) {
-	size_t y;
-	unsigned char *cp;
-
-	/* Prevent a multi-processor race */
-	bu_semaphore_acquire(RT_SEM_MODEL);
-	if (mp->apbuf) {
-	    /* someone else beat us, nothing more to do */
-	    bu_semaphore_release(RT_SEM_MODEL);
-	    return 0;
-	}
-	mp->apbuf = (unsigned char *)bu_calloc(1, nbytes, "rt_ebm_import4 bitmap");
-	mp->apbuflen = nbytes;
-
-	bu_semaphore_release(RT_SEM_MODEL);
-
-	/* Because of in-memory padding, read each scanline separately */
-	cp = (unsigned char *)mp->buf;
-	for (y = 0; y < eip->ydim; y++) {
-	    /* bit() addresses into mp->apbuf */
-	    memcpy(bit(eip, 0, y), cp, eip->xdim);
-	    cp += eip->xdim;
-	}
-    }
+    ebm_share_bitmap(eip, mp, (const unsigned char *)mp->buf);
     return 0;
 }
 
@@ -1105,9 +1088,11 @@ rt_ebm_ifree(struct rt_db_internal *ip)
     RT_EBM_CK_MAGIC(eip);
 
     bu_close_mapped_file(eip->mp);
+    rt_shared_data_put(eip->buf);
 
     eip->magic = 0;			/* sanity */
     eip->mp = (struct bu_mapped_file *)0;
+    eip->buf = (unsigned char *)0;
     bu_free((char *)eip, "ebm ifree");
     ip->idb_ptr = ((void *)0);	/* sanity */
     ip->idb_type = ID_NULL;		/* sanity */
@@ -1152,6 +1137,8 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     vect_t norm;
     vect_t radvec;
     vect_t diam;
+    size_t dim[3];
+    size_t stride[3];
 
     if (rtip) RT_CK_RTI(rtip);
 
@@ -1163,6 +1150,7 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 
     /* "steal" the bitmap storage */
     eip->mp = (struct bu_mapped_file *)0;	/* "steal" the mapped file */
+    eip->buf = (unsigned char *)0;
 
     /* build Xform matrix from model(world) to ideal(local) space */
     bn_mat_inv(ebmp->ebm_mat, eip->mat);
@@ -1193,6 +1181,17 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     VSCALE(radvec, diam, 0.5);
     stp->st_aradius = stp->st_bradius = MAGNITUDE(radvec);
 
+    /* Summarize the cells for skipping empty (and full) space */
+    if (ebmp->ebm_i.buf) {
+	dim[X] = ebmp->ebm_i.xdim;
+	dim[Y] = ebmp->ebm_i.ydim;
+	dim[Z] = 1;
+	stride[X] = 1;
+	stride[Y] = ebmp->ebm_i.xdim + BIT_XWIDEN*2;
+	stride[Z] = 0;
+	rt_brick_map_build(&ebmp->ebm_bricks, 2, dim, bit(&ebmp->ebm_i, 0, 0), stride);
+    }
+
     return 0;		/* OK */
 }
 
@@ -1330,6 +1329,8 @@ rt_ebm_free(struct soltab *stp)
 	(struct rt_ebm_specific *)stp->st_specific;
 
     bu_close_mapped_file(ebmp->ebm_i.mp);
+    rt_shared_data_put(ebmp->ebm_i.buf);
+    rt_brick_map_free(&ebmp->ebm_bricks);
 
     BU_PUT(ebmp, struct rt_ebm_specific);
 }
@@ -487,9 +487,9 @@ rt_eto_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     /* It is known that the equation is 4th order.  Therefore, if the
      * root finder returns other than 4 roots, error.
      */
-    if ((i = rt_poly_roots(&C, val, stp->st_dp->d_namep)) != 4) {
+    if ((i = rt_poly_quartic_roots(&C, val, stp->st_dp->d_namep)) != 4) {
 	if (i > 0) {
-	    bu_log("eto:  rt_poly_roots() 4!=%d\n", i);
+	    bu_log("eto:  rt_poly_quartic_roots() 4!=%d\n", i);
 	    bn_pr_roots(stp->st_name, val, i);
 	} else if (i < 0) {
 	    static int reported = 0;
@@ -1002,9 +1002,9 @@ bend_pipe_shot(
     /* It is known that the equation is 4th order.  Therefore, if the
      * root finder returns other than 4 roots, error.
      */
-    if ((root_count = rt_poly_roots(&C, val, stp->st_dp->d_namep)) != 4) {
+    if ((root_count = rt_poly_quartic_roots(&C, val, stp->st_dp->d_namep)) != 4) {
 	if (root_count > 0) {
-	    bu_log("pipe:  rt_poly_roots() 4!=%d\n", root_count);
+	    bu_log("pipe:  rt_poly_quartic_roots() 4!=%d\n", root_count);
 	    bn_pr_roots(stp->st_name, val, root_count);
 	} else if (root_count < 0) {
 	    static int reported = 0;
@@ -1094,9 +1094,9 @@ bend_pipe_shot(
     /* It is known that the equation is 4th order.  Therefore,
      * if the root finder returns other than 4 roots, error.
      */
-    if ((root_count = rt_poly_roots(&C, val, stp->st_dp->d_namep)) != 4) {
+    if ((root_count = rt_poly_quartic_roots(&C, val, stp->st_dp->d_namep)) != 4) {
 	if (root_count > 0) {
-	    bu_log("tor:  rt_poly_roots() 4!=%d\n", root_count);
+	    bu_log("tor:  rt_poly_quartic_roots() 4!=%d\n", root_count);
 	    bn_pr_roots(stp->st_name, val, root_count);
 	} else if (root_count < 0) {
 	    static int reported = 0;
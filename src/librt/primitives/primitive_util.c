@@ -24,9 +24,18 @@
  * librt_private.h.
  */
 
+#include "common.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "bu/malloc.h"
 #include "bu/opt.h"
 #include "bu/app.h"
+#include "bu/hash.h"
+#include "bu/ptbl.h"
+#include "bu/str.h"
 #include "../librt_private.h"
 
 
@@ -469,6 +478,363 @@ _rt_tcl_list_to_fastf_array(const char *list, fastf_t **array, int *array_len)
 }
 
 
+/*
+ * Shared storage for the decoded data of the bitmap, voxel and height
+ * field primitives.  Each entry is a bu_malloc'd buffer with a count
+ * of the solids (and internal forms) using it.  The key only narrows
+ * the search: entries from a file match on the file's name, size and
+ * modification time, and the others on their decoded bytes.
+ */
+#define SHARED_DATA_MAXDIMS 3
+
+struct shared_data {
+    unsigned long long key;
+    const char *kind;
+    uint32_t dims[SHARED_DATA_MAXDIMS];
+    size_t ndims;
+    char *file;			/* source file, or NULL */
+    size_t filelen;
+    int64_t mtime;
+    void *buf;
+    size_t len;
+    int uses;
+};
+
+static struct bu_ptbl shared_data_tbl = BU_PTBL_INIT_ZERO;
+
+
+static unsigned long long
+shared_data_key(const char *kind, const uint32_t *dims, size_t ndims, const struct bu_mapped_file *mp, const void *buf, size_t len)
+{
+    struct bu_data_hash_state *s = bu_data_hash_create();
+    unsigned long long key;
+
+    bu_data_hash_update(s, kind, strlen(kind));
+    if (ndims)
+	bu_data_hash_update(s, dims, ndims * sizeof(uint32_t));
+
+    if (mp) {
+	/* libbu only hands out a mapping of a file while the file's size
+	 * and modification time are unchanged, so those identify the
+	 * contents without reading them
+	 */
+	int64_t mtime = (int64_t)mp->modtime;
+	bu_data_hash_update(s, mp->name, strlen(mp->name));
+	bu_data_hash_update(s, &mp->buflen, sizeof(mp->buflen));
+	bu_data_hash_update(s, &mtime, sizeof(mtime));
+    } else if (buf && len) {
+	bu_data_hash_update(s, buf, len);
+    }
+
+    key = bu_data_hash_val(s);
+    bu_data_hash_destroy(s);
+    return key;
+}
+
+
+/* caller must hold RT_SEM_MODEL */
+static struct shared_data *
+shared_data_find(unsigned long long key, const char *kind, const uint32_t *dims, size_t ndims, const struct bu_mapped_file *mp, const void *buf, size_t len)
+{
+    size_t i;
+    for (i = 0; i < BU_PTBL_LEN(&shared_data_tbl); i++) {
+	struct shared_data *sd = (struct shared_data *)BU_PTBL_GET(&shared_data_tbl, i);
+	if (sd->key != key || !BU_STR_EQUAL(sd->kind, kind) || sd->ndims != ndims ||
+	    memcmp(sd->dims, dims, ndims * sizeof(uint32_t)))
+	    continue;
+	if (mp) {
+	    if (sd->file && BU_STR_EQUAL(sd->file, mp->name) &&
+		sd->filelen == mp->buflen && sd->mtime == (int64_t)mp->modtime)
+		return sd;
+	} else if (!sd->file && sd->len == len && !memcmp(sd->buf, buf, len)) {
+	    return sd;
+	}
+    }
+    return NULL;
+}
+
+
+/* caller must hold RT_SEM_MODEL */
+static struct shared_data *
+shared_data_find_buf(const void *buf)
+{
+    size_t i;
+    for (i = 0; i < BU_PTBL_LEN(&shared_data_tbl); i++) {
+	struct shared_data *sd = (struct shared_data *)BU_PTBL_GET(&shared_data_tbl, i);
+	if (sd->buf == buf)
+	    return sd;
+    }
+    return NULL;
+}
+
+
+void *
+rt_shared_data_get(const char *kind, const uint32_t *dims, size_t ndims, const struct bu_mapped_file *mp)
+{
+    struct shared_data *sd;
+    unsigned long long key;
+    void *buf = NULL;
+
+    /* other data can only be matched once it is decoded */
+    if (!mp || ndims > SHARED_DATA_MAXDIMS)
+	return NULL;
+
+    key = shared_data_key(kind, dims, ndims, mp, NULL, 0);
+
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    sd = shared_data_find(key, kind, dims, ndims, mp, NULL, 0);
+    if (sd) {
+	sd->uses++;
+	buf = sd->buf;
+    }
+    bu_semaphore_release(RT_SEM_MODEL);
+
+    return buf;
+}
+
+
+void *
+rt_shared_data_add(const char *kind, const uint32_t *dims, size_t ndims, const struct bu_mapped_file *mp, void *buf, size_t len)
+{
+    struct shared_data *sd;
+    unsigned long long key;
+    void *ret;
+
+    if (ndims > SHARED_DATA_MAXDIMS)
+	bu_bomb("rt_shared_data_add: too many dimensions\n");
+
+    key = shared_data_key(kind, dims, ndims, mp, buf, len);
+
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    sd = shared_data_find(key, kind, dims, ndims, mp, buf, len);
+    if (sd) {
+	sd->uses++;
+    } else {
+	BU_ALLOC(sd, struct shared_data);
+	sd->key = key;
+	sd->kind = kind;
+	memcpy(sd->dims, dims, ndims * sizeof(uint32_t));
+	sd->ndims = ndims;
+	if (mp) {
+	    sd->file = bu_strdup(mp->name);
+	    sd->filelen = mp->buflen;
+	    sd->mtime = (int64_t)mp->modtime;
+	}
+	sd->buf = buf;
+	sd->len = len;
+	sd->uses = 1;
+	bu_ptbl_ins(&shared_data_tbl, (long *)sd);
+    }
+    ret = sd->buf;
+    bu_semaphore_release(RT_SEM_MODEL);
+
+    /* another solid decoded the same data first */
+    if (ret != buf)
+	bu_free(buf, "shared data");
+
+    return ret;
+}
+
+
+void
+rt_shared_data_ref(const void *buf)
+{
+    struct shared_data *sd;
+
+    if (!buf)
+	return;
+
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    sd = shared_data_find_buf(buf);
+    if (sd)
+	sd->uses++;
+    bu_semaphore_release(RT_SEM_MODEL);
+}
+
+
+void
+rt_shared_data_put(const void *buf)
+{
+    struct shared_data *sd;
+
+    if (!buf)
+	return;
+
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    sd = shared_data_find_buf(buf);
+    if (sd && --sd->uses <= 0)
+	bu_ptbl_rm(&shared_data_tbl, (long *)sd);
+    else
+	sd = NULL;
+    bu_semaphore_release(RT_SEM_MODEL);
+
+    if (sd) {
+	if (sd->file)
+	    bu_free(sd->file, "shared data file");
+	bu_free(sd->buf, "shared data");
+	bu_free(sd, "shared data");
+    }
+}
+
+
+/* index of brick (bx, by, bz) of a brick map level */
+#define BRICK_IDX(_bm, _l, _bx, _by, _bz) \
+    ((((_bz) * (_bm)->ldim[_l][Y]) + (_by)) * (_bm)->ldim[_l][X] + (_bx))
+
+
+void
+rt_brick_map_build(struct rt_brick_map *bm, int ndim, const size_t dim[3], const unsigned char *cells, const size_t stride[3])
+{
+    const char *envstr = getenv("LIBRT_VOXEL_BRICKS");
+    size_t x, y, z, i, n;
+    int l, a;
+
+    memset(bm, 0, sizeof(struct rt_brick_map));
+    if (envstr && atoi(envstr) == 0)
+	return;
+
+    bm->ndim = ndim;
+    for (a = 0; a < 3; a++)
+	bm->dim[a] = (a < ndim) ? dim[a] : 1;
+    if (!bm->dim[X] || !bm->dim[Y] || !bm->dim[Z])
+	return;
+
+    /* add levels until one brick covers the whole grid */
+    for (l = 0; l < RT_BRICK_MAX_LEVELS; l++) {
+	int shift = RT_BRICK_SHIFT * (l + 1);
+	int more = 0;
+
+	n = 1;
+	for (a = 0; a < 3; a++) {
+	    bm->ldim[l][a] = ((bm->dim[a] - 1) >> shift) + 1;
+	    n *= bm->ldim[l][a];
+	    if (bm->ldim[l][a] > 1)
+		more = 1;
+	}
+	bm->minmax[l] = (unsigned char *)bu_malloc(2 * n, "brick min/max");
+	for (i = 0; i < n; i++) {
+	    bm->minmax[l][2*i] = UCHAR_MAX;
+	    bm->minmax[l][2*i+1] = 0;
+	}
+	bm->nlevels++;
+	if (!more)
+	    break;
+    }
+
+    for (z = 0; z < bm->dim[Z]; z++) {
+	for (y = 0; y < bm->dim[Y]; y++) {
+	    const unsigned char *cp = cells + z * stride[Z] + y * stride[Y];
+	    for (x = 0; x < bm->dim[X]; x++, cp += stride[X]) {
+		unsigned char *mm = &bm->minmax[0][2 * BRICK_IDX(bm, 0, x >> RT_BRICK_SHIFT, y >> RT_BRICK_SHIFT, z >> RT_BRICK_SHIFT)];
+		if (*cp < mm[0])
+		    mm[0] = *cp;
+		if (*cp > mm[1])
+		    mm[1] = *cp;
+	    }
+	}
+    }
+
+    for (l = 1; l < bm->nlevels; l++) {
+	for (z = 0; z < bm->ldim[l-1][Z]; z++) {
+	    for (y = 0; y < bm->ldim[l-1][Y]; y++) {
+		for (x = 0; x < bm->ldim[l-1][X]; x++) {
+		    const unsigned char *cmm = &bm->minmax[l-1][2 * BRICK_IDX(bm, l-1, x, y, z)];
+		    unsigned char *mm = &bm->minmax[l][2 * BRICK_IDX(bm, l, x >> RT_BRICK_SHIFT, y >> RT_BRICK_SHIFT, z >> RT_BRICK_SHIFT)];
+		    if (cmm[0] < mm[0])
+			mm[0] = cmm[0];
+		    if (cmm[1] > mm[1])
+			mm[1] = cmm[1];
+		}
+	    }
+	}
+    }
+}
+
+
+void
+rt_brick_map_free(struct rt_brick_map *bm)
+{
+    int l;
+
+    for (l = 0; l < bm->nlevels; l++)
+	bu_free(bm->minmax[l], "brick min/max");
+    memset(bm, 0, sizeof(struct rt_brick_map));
+}
+
+
+int
+rt_brick_skip(const struct rt_brick_map *bm, const size_t cell[3], const fastf_t dir[3], const fastf_t t[3], const fastf_t delta[3], unsigned int lo, unsigned int hi, int inside, size_t steps[3], double *texit)
+{
+    size_t s[3] = {0, 0, 0};
+    int lvl = -1;
+    int best = -1;
+    int shift, l, a;
+
+    /* A brick containing a mixed brick is mixed too, so go up the
+     * levels only as far as the bricks stay uniform.
+     */
+    for (l = 0; l < bm->nlevels; l++) {
+	const unsigned char *mm;
+	shift = RT_BRICK_SHIFT * (l + 1);
+	mm = &bm->minmax[l][2 * BRICK_IDX(bm, l, cell[X] >> shift, cell[Y] >> shift, cell[Z] >> shift)];
+	if (inside) {
+	    if (mm[0] < lo || mm[1] > hi)
+		break;
+	} else {
+	    if (mm[1] >= lo && mm[0] <= hi)
+		break;
+	}
+	lvl = l;
+    }
+    if (lvl < 0)
+	return -1;
+
+    /* the brick is left along the axis whose last cell plane in the
+     * brick comes first
+     */
+    shift = RT_BRICK_SHIFT * (lvl + 1);
+    *texit = INFINITY;
+    for (a = 0; a < bm->ndim; a++) {
+	size_t base = (cell[a] >> shift) << shift;
+	double te;
+
+	if (delta[a] <= 0)
+	    continue;
+	if (dir[a] > 0) {
+	    size_t end = base + ((size_t)1 << shift);
+	    if (end > bm->dim[a])
+		end = bm->dim[a];
+	    s[a] = end - cell[a];
+	} else {
+	    s[a] = cell[a] - base + 1;
+	}
+	te = t[a] + (s[a] - 1) * delta[a];
+	if (te < *texit) {
+	    *texit = te;
+	    best = a;
+	}
+    }
+    if (best < 0)
+	return -1;
+
+    /* count the cell planes crossed on the way along the other axes */
+    for (a = 0; a < 3; a++) {
+	steps[a] = 0;
+	if (a >= bm->ndim || delta[a] <= 0)
+	    continue;
+	if (a == best) {
+	    steps[a] = s[a];
+	} else if (t[a] <= *texit) {
+	    steps[a] = (size_t)((*texit - t[a]) / delta[a]) + 1;
+	    if (steps[a] > s[a])
+		steps[a] = s[a];
+	}
+    }
+
+    return best;
+}
+
+
 #ifdef USE_OPENCL
 
 #ifndef BRLCAD_OPENCL_DIR
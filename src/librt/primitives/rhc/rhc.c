@@ -405,16 +405,16 @@ rt_rhc_print(const struct soltab *stp)
 #define RHC_NORM_BACK (4)
 
 /**
- * Intersect a ray with a rhc.
- * If an intersection occurs, a struct seg will be acquired
- * and filled in.
+ * Intersect a ray with the right hyperbolic cylinder, leaving the entry point
+ * in hits[0] and the exit point in hits[1].  hits must have room for
+ * 3 entries.
  *
  * Returns -
  * 0 MISS
- * >0 HIT
+ * 2 HIT
  */
-int
-rt_rhc_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+static int
+rhc_hits(struct soltab *stp, struct xray *rp, struct hit *hits)
 {
     struct rhc_specific *rhc =
 	(struct rhc_specific *)stp->st_specific;
@@ -423,7 +423,6 @@ rt_rhc_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     fastf_t k1, k2;		/* distance constants of solution */
     fastf_t x;
     vect_t xlated;		/* translated vector */
-    struct hit hits[3];	/* 2 potential hit points */
     struct hit *hitp;	/* pointer to hit point */
 
     hitp = &hits[0];
@@ -563,34 +562,75 @@ check_plates:
 	}
     }
 
-    if (hitp != &hits[2]) {
-	return 0;    /* MISS */
+    if (hitp != &hits[2])
+	return 0;	/* MISS */
+
+    if (hits[0].hit_dist >= hits[1].hit_dist) {
+	/* entry is [1], exit is [0] */
+	struct hit tmp = hits[0];	/* struct copy */
+	hits[0] = hits[1];
+	hits[1] = tmp;
     }
 
-    if (hits[0].hit_dist < hits[1].hit_dist) {
-	/* entry is [0], exit is [1] */
-	struct seg *segp;
+    return 2;			/* HIT */
+}
 
-	RT_GET_SEG(segp, ap->a_resource);
-	segp->seg_stp = stp;
-	segp->seg_in = hits[0];		/* struct copy */
-	segp->seg_out = hits[1];	/* struct copy */
-	BU_LIST_INSERT(&(seghead->l), &(segp->l));
-    } else {
-	/* entry is [1], exit is [0] */
-	struct seg *segp;
 
-	RT_GET_SEG(segp, ap->a_resource);
-	segp->seg_stp = stp;
-	segp->seg_in = hits[1];		/* struct copy */
-	segp->seg_out = hits[0];	/* struct copy */
-	BU_LIST_INSERT(&(seghead->l), &(segp->l));
-    }
+/**
+ * Intersect a ray with a rhc.
+ * If an intersection occurs, a struct seg will be acquired
+ * and filled in.
+ *
+ * Returns -
+ * 0 MISS
+ * >0 HIT
+ */
+int
+rt_rhc_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct hit hits[3];	/* 2 potential hit points */
+    struct seg *segp;
+
+    if (rhc_hits(stp, rp, hits) != 2)
+	return 0;	/* MISS */
+
+    RT_GET_SEG(segp, ap->a_resource);
+    segp->seg_stp = stp;
+    segp->seg_in = hits[0];		/* struct copy */
+    segp->seg_out = hits[1];	/* struct copy */
+    BU_LIST_INSERT(&(seghead->l), &(segp->l));
 
     return 2;			/* HIT */
 }
 
 
+/**
+ * Vectorized version.  Skips the segment allocation and list handling
+ * of rt_rhc_shot, writing the single rhc segment for each
+ * ray/solid pair directly into segp.
+ */
+void
+rt_rhc_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
+{
+    struct hit hits[3];	/* 2 potential hit points */
+    int i;
+
+    if (ap) RT_CK_APPLICATION(ap);
+
+    for (i = 0; i < n; i++) {
+	if (stp[i] == 0) continue; /* stp[i] == 0 signals skip ray */
+
+	if (rhc_hits(stp[i], rp[i], hits) != 2) {
+	    segp[i].seg_stp = (struct soltab *)0;	/* MISS */
+	    continue;
+	}
+	segp[i].seg_stp = stp[i];
+	segp[i].seg_in = hits[0];	/* struct copy */
+	segp[i].seg_out = hits[1];	/* struct copy */
+    }
+}
+
+
 /**
  * Given ONE ray distance, return the normal and entry/exit point.
  */
@@ -393,16 +393,16 @@ rt_rpc_print(const struct soltab *stp)
 #define RPC_NORM_BACK (4)
 
 /**
- * Intersect a ray with a rpc.
- * If an intersection occurs, a struct seg will be acquired
- * and filled in.
+ * Intersect a ray with the right parabolic cylinder, leaving the entry point
+ * in hits[0] and the exit point in hits[1].  hits must have room for
+ * 3 entries.
  *
  * Returns -
  * 0 MISS
- * >0 HIT
+ * 2 HIT
  */
-int
-rt_rpc_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+static int
+rpc_hits(struct soltab *stp, struct xray *rp, struct hit *hits)
 {
     struct rpc_specific *rpc =
 	(struct rpc_specific *)stp->st_specific;
@@ -410,7 +410,6 @@ rt_rpc_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     vect_t pprime;		/* P' */
     fastf_t k1, k2;		/* distance constants of solution */
     vect_t xlated;		/* translated vector */
-    struct hit hits[3];	/* 2 potential hit points */
     struct hit *hitp;	/* pointer to hit point */
 
     hitp = &hits[0];
@@ -520,29 +519,72 @@ rt_rpc_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct
     if (hitp != &hits[2])
 	return 0;	/* MISS */
 
-    if (hits[0].hit_dist < hits[1].hit_dist) {
-	/* entry is [0], exit is [1] */
-	struct seg *segp;
-
-	RT_GET_SEG(segp, ap->a_resource);
-	segp->seg_stp = stp;
-	segp->seg_in = hits[0];		/* struct copy */
-	segp->seg_out = hits[1];	/* struct copy */
-	BU_LIST_INSERT(&(seghead->l), &(segp->l));
-    } else {
+    if (hits[0].hit_dist >= hits[1].hit_dist) {
 	/* entry is [1], exit is [0] */
-	struct seg *segp;
-
-	RT_GET_SEG(segp, ap->a_resource);
-	segp->seg_stp = stp;
-	segp->seg_in = hits[1];		/* struct copy */
-	segp->seg_out = hits[0];	/* struct copy */
-	BU_LIST_INSERT(&(seghead->l), &(segp->l));
+	struct hit tmp = hits[0];	/* struct copy */
+	hits[0] = hits[1];
+	hits[1] = tmp;
     }
+
+    return 2;			/* HIT */
+}
+
+
+/**
+ * Intersect a ray with a rpc.
+ * If an intersection occurs, a struct seg will be acquired
+ * and filled in.
+ *
+ * Returns -
+ * 0 MISS
+ * >0 HIT
+ */
+int
+rt_rpc_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct hit hits[3];	/* 2 potential hit points */
+    struct seg *segp;
+
+    if (rpc_hits(stp, rp, hits) != 2)
+	return 0;	/* MISS */
+
+    RT_GET_SEG(segp, ap->a_resource);
+    segp->seg_stp = stp;
+    segp->seg_in = hits[0];		/* struct copy */
+    segp->seg_out = hits[1];	/* struct copy */
+    BU_LIST_INSERT(&(seghead->l), &(segp->l));
+
     return 2;			/* HIT */
 }
 
 
+/**
+ * Vectorized version.  Skips the segment allocation and list handling
+ * of rt_rpc_shot, writing the single rpc segment for each
+ * ray/solid pair directly into segp.
+ */
+void
+rt_rpc_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, struct application *ap)
+{
+    struct hit hits[3];	/* 2 potential hit points */
+    int i;
+
+    if (ap) RT_CK_APPLICATION(ap);
+
+    for (i = 0; i < n; i++) {
+	if (stp[i] == 0) continue; /* stp[i] == 0 signals skip ray */
+
+	if (rpc_hits(stp[i], rp[i], hits) != 2) {
+	    segp[i].seg_stp = (struct soltab *)0;	/* MISS */
+	    continue;
+	}
+	segp[i].seg_stp = stp[i];
+	segp[i].seg_in = hits[0];	/* struct copy */
+	segp[i].seg_out = hits[1];	/* struct copy */
+    }
+}
+
+
 /**
  * Given ONE ray distance, return the normal and entry/exit point.
  */
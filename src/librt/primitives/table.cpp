@@ -883,7 +883,7 @@ const struct rt_functab OBJ[] = {
 	RTFUNCTAB_FUNC_FREE_CAST(rt_arbn_free),
 	RTFUNCTAB_FUNC_PLOT_CAST(rt_arbn_plot),
 	NULL, /* adaptive_plot */
-	NULL, /* vshot */
+	RTFUNCTAB_FUNC_VSHOT_CAST(rt_arbn_vshot),
 	RTFUNCTAB_FUNC_TESS_CAST(rt_arbn_tess),
 	NULL, /* tnurb */
 	RTFUNCTAB_FUNC_BREP_CAST(rt_arbn_brep),
@@ -1033,7 +1033,7 @@ const struct rt_functab OBJ[] = {
 	RTFUNCTAB_FUNC_FREE_CAST(rt_rpc_free),
 	RTFUNCTAB_FUNC_PLOT_CAST(rt_rpc_plot),
 	RTFUNCTAB_FUNC_ADAPTIVE_PLOT_CAST(rt_rpc_adaptive_plot),
-	NULL, /* vshot */
+	RTFUNCTAB_FUNC_VSHOT_CAST(rt_rpc_vshot),
 	RTFUNCTAB_FUNC_TESS_CAST(rt_rpc_tess),
 	NULL, /* tnurb */
 	RTFUNCTAB_FUNC_BREP_CAST(rt_rpc_brep),
@@ -1083,7 +1083,7 @@ const struct rt_functab OBJ[] = {
 	RTFUNCTAB_FUNC_FREE_CAST(rt_rhc_free),
 	RTFUNCTAB_FUNC_PLOT_CAST(rt_rhc_plot),
 	RTFUNCTAB_FUNC_ADAPTIVE_PLOT_CAST(rt_rhc_adaptive_plot),
-	NULL, /* vshot */
+	RTFUNCTAB_FUNC_VSHOT_CAST(rt_rhc_vshot),
 	RTFUNCTAB_FUNC_TESS_CAST(rt_rhc_tess),
 	NULL, /* tnurb */
 	RTFUNCTAB_FUNC_BREP_CAST(rt_rhc_brep),
@@ -1133,7 +1133,7 @@ const struct rt_functab OBJ[] = {
 	RTFUNCTAB_FUNC_FREE_CAST(rt_epa_free),
 	RTFUNCTAB_FUNC_PLOT_CAST(rt_epa_plot),
 	RTFUNCTAB_FUNC_ADAPTIVE_PLOT_CAST(rt_epa_adaptive_plot),
-	NULL, /* vshot */
+	RTFUNCTAB_FUNC_VSHOT_CAST(rt_epa_vshot),
 	RTFUNCTAB_FUNC_TESS_CAST(rt_epa_tess),
 	NULL, /* tnurb */
 	RTFUNCTAB_FUNC_BREP_CAST(rt_epa_brep),
@@ -1183,7 +1183,7 @@ const struct rt_functab OBJ[] = {
 	RTFUNCTAB_FUNC_FREE_CAST(rt_ehy_free),
 	RTFUNCTAB_FUNC_PLOT_CAST(rt_ehy_plot),
 	RTFUNCTAB_FUNC_ADAPTIVE_PLOT_CAST(rt_ehy_adaptive_plot),
-	NULL, /* vshot */
+	RTFUNCTAB_FUNC_VSHOT_CAST(rt_ehy_vshot),
 	RTFUNCTAB_FUNC_TESS_CAST(rt_ehy_tess),
 	NULL, /* tnurb */
 	RTFUNCTAB_FUNC_BREP_CAST(rt_ehy_brep),
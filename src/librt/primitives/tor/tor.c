@@ -486,9 +486,9 @@ rt_tor_shot(struct soltab *stp, register struct xray *rp, struct application *ap
     /* It is known that the equation is 4th order.  Therefore, if the
      * root finder returns other than 4 roots, error.
      */
-    if ((i = rt_poly_roots(&C, val, stp->st_dp->d_namep)) != 4) {
+    if ((i = rt_poly_quartic_roots(&C, val, stp->st_dp->d_namep)) != 4) {
 	if (i > 0) {
-	    bu_log("tor:  rt_poly_roots() 4!=%d\n", i);
+	    bu_log("tor:  rt_poly_quartic_roots() 4!=%d\n", i);
 	    bn_pr_roots(stp->st_name, val, i);
 	} else if (i < 0) {
 	    static int reported=0;
@@ -624,6 +624,7 @@ rt_tor_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     bn_poly_t X2_Y2;		/* X**2 + Y**2 */
     vect_t cor_pprime;	/* new ray origin */
     fastf_t *cor_proj;
+    int *nroots;
 
     if (!stp || !(*stp) || !rp || !segp || !ap)
 	return;
@@ -633,6 +634,7 @@ rt_tor_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     val = (bn_complex_t (*)[4])bu_malloc(n * sizeof(bn_complex_t) * 4,
 					 "tor bn_complex_t");
     cor_proj = (fastf_t *)bu_malloc(n * sizeof(fastf_t), "tor proj");
+    nroots = (int *)bu_malloc(n * sizeof(int), "tor nroots");
 
     /* Initialize seg_stp to assume hit (zero will then flag miss) */
     for (i = 0; i < n; i++) segp[i].seg_stp = stp[i];
@@ -724,17 +726,21 @@ rt_tor_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     }
 
     /* Unfortunately finding the 4th order roots are too ugly to
-     * expand the root solving manually.
+     * expand the root solving manually - solve them all in one pass.
      */
+    for (i = 0; i < n; i++)
+	nroots[i] = (segp[i].seg_stp == 0) ? -1 : 0;
+    rt_poly_quartic_roots_batch(C, val, nroots, (size_t)n, (*stp)->st_dp->d_namep);
+
     for (i = 0; i < n; i++) {
 	if (segp[i].seg_stp == 0) continue;	/* Skip */
 
 	/* It is known that the equation is 4th order.  Therefore, if
 	 * the root finder returns other than 4 roots, error.
 	 */
-	if ((num_roots = rt_poly_roots(&(C[i]), &(val[i][0]), (*stp)->st_dp->d_namep)) != 4) {
+	if ((num_roots = nroots[i]) != 4) {
 	    if (num_roots > 0) {
-		bu_log("tor:  rt_poly_roots() 4!=%d\n", num_roots);
+		bu_log("tor:  rt_poly_quartic_roots() 4!=%d\n", num_roots);
 		bn_pr_roots("tor", val[i], num_roots);
 	    } else if (num_roots < 0) {
 		static int reported=0;
@@ -847,6 +853,7 @@ rt_tor_vshot(struct soltab **stp, struct xray **rp, struct seg *segp, int n, str
     bu_free((char *)C, "tor C");
     bu_free((char *)val, "tor val");
     bu_free((char *)cor_proj, "tor cor_proj");
+    bu_free((char *)nroots, "tor nroots");
 }
 
 
@@ -43,6 +43,7 @@
 #include "raytrace.h"
 
 #include "../fixpt.h"
+#include "../../librt_private.h"
 
 
 /*
@@ -59,6 +60,7 @@ struct rt_vol_specific {
     mat_t vol_mat;	/* model to ideal space */
     vect_t vol_origin;	/* local coords of grid origin (0, 0, 0) for now */
     vect_t vol_large;	/* local coords of XYZ max */
+    struct rt_brick_map vol_bricks;	/* empty space skipping */
 };
 #define VOL_NULL ((struct rt_vol_specific *)0)
 
@@ -118,6 +120,53 @@ extern int rt_binunif_describe(struct bu_vls  *str, const struct rt_db_internal
 
 static int rt_vol_normtab[3] = { NORM_XPOS, NORM_YPOS, NORM_ZPOS };
 
+static int vol_file_data(struct rt_vol_internal *vip);
+
+
+/**
+ * Set vip->map to the padded in-memory volume for the len bytes of
+ * scanlines at data, keeping one copy for all the solids using the
+ * same volume.  A file source mp is only loaded once; data without one
+ * is matched after it has been padded.
+ *
+ * File data is always copied: the shot, normal and brick map code
+ * index the padded layout directly, so the mapping itself can't be
+ * used.  Sharing limits this to one copy per distinct volume.
+ */
+static void
+vol_share_map(struct rt_vol_internal *vip, const struct bu_mapped_file *mp, const unsigned char *data, size_t len)
+{
+    uint32_t dims[3];
+    unsigned char *map;
+    size_t nbytes, y, z;
+
+    dims[X] = vip->xdim;
+    dims[Y] = vip->ydim;
+    dims[Z] = vip->zdim;
+    vip->map = (unsigned char *)rt_shared_data_get("vol", dims, 3, mp);
+    if (vip->map)
+	return;
+
+    nbytes = (vip->xdim+VOL_XWIDEN*2)*
+	(vip->ydim+VOL_YWIDEN*2)*
+	(vip->zdim+VOL_ZWIDEN*2);
+    map = (unsigned char *)bu_calloc(1, nbytes, "vol bitmap");
+
+    /* Because of in-memory padding, copy each scanline separately */
+    for (z = 0; z < vip->zdim; z++) {
+	for (y = 0; y < vip->ydim; y++) {
+	    if (len < vip->xdim)
+		goto done;
+	    memcpy(&VOLMAP(map, vip->xdim, vip->ydim, 0, y, z), data, vip->xdim);
+	    data += vip->xdim;
+	    len -= vip->xdim;
+	}
+    }
+
+ done:
+    vip->map = (unsigned char *)rt_shared_data_add("vol", dims, 3, mp, map, nbytes);
+}
+
 /**
  * Transform the ray into local coordinates of the volume ("ideal space").
  * Step through the 3-D array, in local coordinates.
@@ -305,6 +354,37 @@ rt_vol_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	int val;
 	struct seg *segp;
 
+	/* Jump over bricks of cells that can't change inside */
+	if (volp->vol_bricks.nlevels &&
+	    igrid[X] >= 0 && (size_t)igrid[X] < volp->vol_i.xdim &&
+	    igrid[Y] >= 0 && (size_t)igrid[Y] < volp->vol_i.ydim &&
+	    igrid[Z] >= 0 && (size_t)igrid[Z] < volp->vol_i.zdim) {
+	    size_t cell[3];
+	    size_t steps[3];
+	    double texit;
+
+	    cell[X] = igrid[X];
+	    cell[Y] = igrid[Y];
+	    cell[Z] = igrid[Z];
+	    j = rt_brick_skip(&volp->vol_bricks, cell, rp->r_dir, t, delta,
+			      volp->vol_i.lo, volp->vol_i.hi, inside, steps, &texit);
+	    if (j >= 0) {
+		if (RT_G_DEBUG&RT_DEBUG_VOL)bu_log("igrid [%d %d %d] skip to %g\n",
+						igrid[X], igrid[Y], igrid[Z], texit);
+		for (out_axis = X; out_axis <= Z; out_axis++) {
+		    t[out_axis] += steps[out_axis] * delta[out_axis];
+		    if (rp->r_dir[out_axis] > 0) {
+			igrid[out_axis] += steps[out_axis];
+		    } else {
+			igrid[out_axis] -= steps[out_axis];
+		    }
+		}
+		t0 = texit;
+		in_axis = j;
+		continue;
+	    }
+	}
+
 	/* find minimum exit t value */
 	if (t[X] < t[Y]) {
 	    if (t[Z] < t[X]) {
@@ -434,12 +514,7 @@ rt_vol_import4(struct rt_db_internal *ip, const struct bu_external *ep, const fa
     union record *rp;
     register struct rt_vol_internal *vip;
     struct bu_vls str = BU_VLS_INIT_ZERO;
-    FILE *fp;
-    int nbytes;
-    size_t y;
-    size_t z;
     mat_t tmat;
-    size_t ret;
 
     if (dbip) RT_CK_DBI(dbip);
 
@@ -491,40 +566,8 @@ rt_vol_import4(struct rt_db_internal *ip, const struct bu_external *ep, const fa
     bn_mat_mul(tmat, mat, vip->mat);
     MAT_COPY(vip->mat, tmat);
 
-    /* Get bit map from .bw(5) file */
-    nbytes = (vip->xdim+VOL_XWIDEN*2)*
-	(vip->ydim+VOL_YWIDEN*2)*
-	(vip->zdim+VOL_ZWIDEN*2);
-    vip->map = (unsigned char *)bu_calloc(1, nbytes, "vol_import4 bitmap");
-
-    bu_semaphore_acquire(BU_SEM_SYSCALL);		/* lock */
-    if ((fp = fopen(vip->name, "rb")) == NULL) {
-	perror(vip->name);
-	bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
+    if (vol_file_data(vip) != 0)
 	return -1;
-    }
-    bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
-
-    /* Because of in-memory padding, read each scanline separately */
-    for (z = 0; z < vip->zdim; z++) {
-	for (y = 0; y < vip->ydim; y++) {
-	    void *data = &VOLMAP(vip->map, vip->xdim, vip->ydim, 0, y, z);
-	    bu_semaphore_acquire(BU_SEM_SYSCALL);		/* lock */
-	    ret = fread(data, vip->xdim, 1, fp); /* res_syscall */
-	    bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
-	    if (ret < 1) {
-		bu_log("rt_vol_import4(%s): Unable to read whole VOL, y=%zu, z=%zu\n",
-		       vip->name, y, z);
-		bu_semaphore_acquire(BU_SEM_SYSCALL);		/* lock */
-		fclose(fp);
-		bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
-		return -1;
-	    }
-	}
-    }
-    bu_semaphore_acquire(BU_SEM_SYSCALL);		/* lock */
-    fclose(fp);
-    bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
     return 0;
 }
 
@@ -567,56 +610,6 @@ rt_vol_export4(struct bu_external *ep, const struct rt_db_internal *ip, double l
 }
 
 
-static size_t
-vol_from_file(const char *file, size_t xdim, size_t ydim, size_t zdim, unsigned char **map)
-{
-    size_t y;
-    size_t z;
-    size_t ret = 0;
-    size_t nbytes;
-    FILE *fp;
-
-    /* Get bit map from .bw(5) file */
-    nbytes = (xdim+VOL_XWIDEN*2)*
-	(ydim+VOL_YWIDEN*2)*
-	(zdim+VOL_ZWIDEN*2);
-    *map = (unsigned char *)bu_calloc(1, nbytes, "vol_import4 bitmap");
-
-    bu_semaphore_acquire(BU_SEM_SYSCALL);		/* lock */
-    if ((fp = fopen(file, "rb")) == NULL) {
-	perror(file);
-	bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
-	return 0;
-    }
-    bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
-
-    /* Because of in-memory padding, read each scanline separately */
-    for (z = 0; z < zdim; z++) {
-	for (y = 0; y < ydim; y++) {
-	    size_t fret;
-	    void *data = &VOLMAP(*map, xdim, ydim, 0, y, z);
-
-	    bu_semaphore_acquire(BU_SEM_SYSCALL);	/* lock */
-	    fret = fread(data, xdim, 1, fp);		/* res_syscall */
-	    bu_semaphore_release(BU_SEM_SYSCALL);	/* unlock */
-	    if (fret < 1) {
-		bu_log("rt_vol_import4(%s): Unable to read whole VOL, y=%zu, z=%zu\n", file, y, z);
-		bu_semaphore_acquire(BU_SEM_SYSCALL);	/* lock */
-		fclose(fp);
-		bu_semaphore_release(BU_SEM_SYSCALL);	/* unlock */
-		return 0;
-	    }
-	    ret += xdim;
-	}
-    }
-    bu_semaphore_acquire(BU_SEM_SYSCALL);		/* lock */
-    fclose(fp);
-    bu_semaphore_release(BU_SEM_SYSCALL);		/* unlock */
-
-    return ret;
-}
-
-
 /**
  * Read VOL data from external file
  * Returns :
@@ -626,15 +619,27 @@ vol_from_file(const char *file, size_t xdim, size_t ydim, size_t zdim, unsigned
 static int
 vol_file_data(struct rt_vol_internal *vip)
 {
-   size_t nbytes;
+    struct bu_mapped_file *mp;
+    size_t bytes = (size_t)vip->xdim * vip->ydim * vip->zdim;
 
-   size_t bytes = vip->xdim * vip->ydim * vip->zdim;
-	nbytes = vol_from_file(vip->name, vip->xdim, vip->ydim, vip->zdim, &vip->map);
-	if (nbytes != bytes) {
-	    bu_log("WARNING: unexpected VOL bytes (read %zu, expected %zu) in %s\n", nbytes, bytes, vip->name);
-	}
+    /* Get bit map from .bw(5) file */
+    mp = bu_open_mapped_file(vip->name, "vol");
+    if (!mp) {
+	bu_log("rt_vol: unable to open '%s'\n", vip->name);
+	return -1;
+    }
 
-   return 0;
+    if (mp->buflen < bytes) {
+	bu_log("WARNING: unexpected VOL bytes (read %zu, expected %zu) in %s\n", mp->buflen, bytes, vip->name);
+    }
+
+    /* solids using the same file share one padded copy, so the mapping
+     * isn't needed once that exists
+     */
+    vol_share_map(vip, mp, (const unsigned char *)mp->buf, (mp->buflen < bytes) ? mp->buflen : bytes);
+    bu_close_mapped_file(mp);
+
+    return 0;
 }
 
 
@@ -649,7 +654,6 @@ get_obj_data(struct rt_vol_internal *vip, const struct db_i *dbip)
 {
     struct rt_binunif_internal *bip;
     int ret;
-    int nbytes;
 
     if (!vip || !dbip)
 	return -1;
@@ -700,23 +704,13 @@ get_obj_data(struct rt_vol_internal *vip, const struct db_i *dbip)
 	return -2;
     }
 
-    nbytes = (vip->xdim+VOL_XWIDEN*2)*(vip->ydim+VOL_YWIDEN*2)*(vip->zdim+VOL_ZWIDEN*2);
-
-    size_t y, z;
+    /* solids using objects with the same contents share one padded
+     * copy, and the object's copy of the data is no longer needed
+     */
     if (!vip->map) {
-	unsigned char* cp;
-
-  vip->map = (unsigned char *)bu_calloc(1, nbytes, "vol_import4 bitmap");
-	cp = (unsigned char *)bip->u.uint8;
-
-  for (z = 0; z < vip->zdim; z++) {
-	   for (y = 0; y < vip->ydim; y++) {
-       void *data = &VOLMAP(vip->map, vip->xdim, vip->ydim, 0, y, z);
-
-	     memcpy(data, cp, vip->xdim);
-       cp+= vip->xdim;
-	   }
-  }
+	vol_share_map(vip, NULL, (const unsigned char *)bip->u.uint8, bip->count);
+	bu_free(bip->u.uint8, "vol binunif data");
+	bip->u.uint8 = NULL;
     }
     return 0;
 }
@@ -946,8 +940,7 @@ rt_vol_ifree(struct rt_db_internal *ip)
     RT_VOL_CK_MAGIC(vip);
 
     /* should be stolen by vol_specific, but check just in case */
-    if (vip->map)
-	bu_free((char *)vip->map, "vol bitmap");
+    rt_shared_data_put(vip->map);
 
     vip->magic = 0;			/* sanity */
     vip->map = (unsigned char *)0;
@@ -994,6 +987,8 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     vect_t norm;
     vect_t radvec;
     vect_t diam;
+    size_t dim[3];
+    size_t stride[3];
 
     RT_CK_SOLTAB(stp);
     RT_CK_DB_INTERNAL(ip);
@@ -1002,6 +997,11 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     vip = (struct rt_vol_internal *)ip->idb_ptr;
     RT_VOL_CK_MAGIC(vip);
 
+    if (!vip->map) {
+	bu_log("vol(%s): no data\n", vip->name);
+	return 1;
+    }
+
     BU_GET(volp, struct rt_vol_specific);
     volp->vol_i = *vip;		/* struct copy */
     vip->map = (unsigned char *)0;	/* "steal" the bitmap storage */
@@ -1033,6 +1033,16 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     VSCALE(radvec, diam, 0.5);
     stp->st_aradius = stp->st_bradius = MAGNITUDE(radvec);
 
+    /* Summarize the cells for skipping empty (and full) space */
+    dim[X] = volp->vol_i.xdim;
+    dim[Y] = volp->vol_i.ydim;
+    dim[Z] = volp->vol_i.zdim;
+    stride[X] = 1;
+    stride[Y] = volp->vol_i.xdim + VOL_XWIDEN*2;
+    stride[Z] = stride[Y] * (volp->vol_i.ydim + VOL_YWIDEN*2);
+    rt_brick_map_build(&volp->vol_bricks, 3, dim,
+		       &VOL(&volp->vol_i, 0, 0, 0), stride);
+
     return 0;		/* OK */
 }
 
@@ -1137,10 +1147,9 @@ rt_vol_free(struct soltab *stp)
 	(struct rt_vol_specific *)stp->st_specific;
 
     /* specific steals map from vip, release here */
-    if (volp->vol_i.map) {
-	bu_free((char *)volp->vol_i.map, "vol_map");
-	volp->vol_i.map = NULL; /* sanity */
-    }
+    rt_shared_data_put(volp->vol_i.map);
+    volp->vol_i.map = NULL; /* sanity */
+    rt_brick_map_free(&volp->vol_bricks);
     BU_PUT(volp, struct rt_vol_specific);
 }
 
@@ -352,6 +352,129 @@ rt_poly_roots(bn_poly_t *eqn,	/* equation to be solved */
 }
 
 
+/* Maximum Newton iterations used to polish a closed form quartic root.  The
+ * closed form real roots are close enough that one step gets them to within
+ * a few ulps - more steps are only worth it to rescue a failed solve. */
+#define RT_QUARTIC_POLISH 4
+
+/**
+ * Refine a root of the monic quartic eqn with Newton's method.  The closed
+ * form solution loses accuracy to cancellation when the coefficients differ
+ * greatly in magnitude (common for rays starting far from a torus), which
+ * left to itself sends rt_poly_roots() off to the much slower iterative
+ * solver.  A step is only kept if it reduces the residual, so roots near a
+ * multiple root (where Newton converges slowly or wanders) are never made
+ * worse.
+ *
+ * Returns the residual |p(root)| (the larger of the real and imaginary
+ * parts for a complex root, as rt_poly_checkroots() tests it.)
+ */
+static fastf_t
+rt_quartic_polish(const bn_poly_t *eqn, bn_complex_t *root, int iters)
+{
+    const fastf_t c1 = eqn->cf[1];
+    const fastf_t c2 = eqn->cf[2];
+    const fastf_t c3 = eqn->cf[3];
+    const fastf_t c4 = eqn->cf[4];
+    int i;
+
+    if (ZERO(root->im)) {
+	fastf_t x = root->re;
+	fastf_t p = (((x + c1)*x + c2)*x + c3)*x + c4;
+	for (i = 0; i < iters && !ZERO(p); i++) {
+	    fastf_t dp = ((4.0*x + 3.0*c1)*x + 2.0*c2)*x + c3;
+	    fastf_t nx, np;
+	    if (ZERO(dp))
+		break;
+	    nx = x - p / dp;
+	    np = (((nx + c1)*nx + c2)*nx + c3)*nx + c4;
+	    if (fabs(np) >= fabs(p))
+		break;
+	    x = nx;
+	    p = np;
+	}
+	root->re = x;
+	return fabs(p);
+    }
+
+    {
+	bn_complex_t z = *root;
+	bn_complex_t p, dp, d2p;
+	bn_poly_t e = *eqn;
+	rt_poly_eval_w_2derivatives(&z, &e, &p, &dp, &d2p);
+	for (i = 0; i < iters && !ZERO(bn_cx_amplsq(&p)); i++) {
+	    bn_complex_t nz = z;
+	    bn_complex_t np, ndp, nd2p;
+	    bn_complex_t step = p;
+	    if (ZERO(bn_cx_amplsq(&dp)))
+		break;
+	    bn_cx_div(&step, &dp);
+	    bn_cx_sub(&nz, &step);
+	    rt_poly_eval_w_2derivatives(&nz, &e, &np, &ndp, &nd2p);
+	    if (bn_cx_amplsq(&np) >= bn_cx_amplsq(&p))
+		break;
+	    z = nz;
+	    p = np;
+	    dp = ndp;
+	}
+	*root = z;
+	return FMAX(fabs(p.re), fabs(p.im));
+    }
+}
+
+
+int
+rt_poly_quartic_roots(bn_poly_t *eqn, bn_complex_t roots[], const char *name)
+{
+    int i;
+
+    /* Leave the degenerate cases (leading coefficient vanishing, zero
+     * roots) to the general solver */
+    if (eqn->dgr != 4 || ZERO(eqn->cf[0]) || ZERO(eqn->cf[4] / eqn->cf[0]))
+	return rt_poly_roots(eqn, roots, name);
+
+    (void) bn_poly_scale(eqn, 1.0 / eqn->cf[0]);
+
+    if (bn_poly_quartic_roots(roots, eqn)) {
+	/* Real roots are the ones the primitives care about, and cheap to
+	 * refine.  The complex ones are only worth refining if they are what
+	 * stands between us and the iterative solver. */
+	int bad = 0;
+	for (i = 0; i < 4; i++) {
+	    if (ZERO(roots[i].im)) {
+		if (rt_quartic_polish(eqn, &roots[i], 1) > RT_ROOT_TOL)
+		    bad = 1;
+	    } else if (rt_poly_checkroots(eqn, &roots[i], 1)) {
+		bad = 1;
+	    }
+	}
+	if (!bad)
+	    return 4;
+	for (i = 0; i < 4; i++)
+	    rt_quartic_polish(eqn, &roots[i], RT_QUARTIC_POLISH);
+	if (rt_poly_checkroots(eqn, roots, 4) == 0)
+	    return 4;
+    }
+
+    /* Closed form failed - eqn is monic now, which rt_poly_roots() is
+     * happy to take as is */
+    return rt_poly_roots(eqn, roots, name);
+}
+
+
+void
+rt_poly_quartic_roots_batch(bn_poly_t eqns[], bn_complex_t (*roots)[4], int nroots[], size_t n, const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+	if (nroots[i] < 0)
+	    continue;
+	nroots[i] = rt_poly_quartic_roots(&eqns[i], roots[i], name);
+    }
+}
+
+
 /*
  * Local Variables:
  * mode: C
@@ -640,8 +640,89 @@ rt_plot_cell(const union cutter *cutp, const struct rt_shootray_status *ssp, str
 }
 
 
-_BU_ATTR_FLATTEN int
-rt_shootray(register struct application *ap)
+/* State of an rt_shootray_occluded() query */
+struct shoot_occlusion {
+    fastf_t mindist;
+    fastf_t maxdist;
+    int (*occluder)(struct application *, const struct region *);
+    int entry;		/* regions must be entered past mindist */
+    int straddled;	/* a segment spans mindist, see shoot_occluded_segs */
+    int seen;		/* some region was found in the interval */
+};
+
+
+static int
+shoot_occluder(struct shoot_occlusion *oq, struct application *ap, const struct region *regp)
+{
+    if (!oq->occluder || oq->occluder(ap, regp))
+	return 1;
+    oq->seen = 1;
+    return 0;
+}
+
+
+/* Segments of solids that are only ever unioned into their regions are
+ * region hits as they stand, so an occluder among them settles the
+ * query without weaving any partitions.
+ *
+ * When regions have to be entered past mindist, a segment spanning
+ * mindist could be part of the same partition as one starting after
+ * it, and only the partitions can tell.  Such a segment is shot in the
+ * first cell along the ray (its solid's box holds the ray start), so
+ * once one shows up the rest of the query uses the partitions. */
+static int
+shoot_occluded_segs(struct shoot_occlusion *oq, struct application *ap, struct seg *segs)
+{
+    struct seg *segp;
+
+    if (oq->entry && !oq->straddled) {
+	for (BU_LIST_FOR(segp, seg, &(segs->l))) {
+	    if (segp->seg_in.hit_dist <= oq->mindist && segp->seg_out.hit_dist > oq->mindist)
+		oq->straddled = 1;
+	}
+    }
+    if (oq->straddled)
+	return 0;
+
+    for (BU_LIST_FOR(segp, seg, &(segs->l))) {
+	struct region **regpp;
+
+	if (segp->seg_out.hit_dist <= oq->mindist || segp->seg_in.hit_dist >= oq->maxdist)
+	    continue;
+	if (oq->entry && segp->seg_in.hit_dist <= oq->mindist)
+	    continue;
+	for (BU_PTBL_FOR(regpp, (struct region **), &segp->seg_stp->st_regions)) {
+	    if ((*regpp)->reg_all_unions && shoot_occluder(oq, ap, *regpp))
+		return 1;
+	}
+    }
+    return 0;
+}
+
+
+static int
+shoot_occluded_parts(struct shoot_occlusion *oq, struct application *ap, struct partition *PartHeadp)
+{
+    struct partition *pp;
+
+    for (pp = PartHeadp->pt_forw; pp != PartHeadp; pp = pp->pt_forw) {
+	if (pp->pt_outhit->hit_dist <= oq->mindist)
+	    continue;
+	if (oq->entry && pp->pt_inhit->hit_dist <= oq->mindist)
+	    continue;
+	if (pp->pt_inhit->hit_dist >= oq->maxdist)
+	    break;
+	if (shoot_occluder(oq, ap, pp->pt_regionp))
+	    return 1;
+    }
+    return 0;
+}
+
+
+/* rt_shootray(), or with oq set, the rt_shootray_occluded() query -
+ * which stops at the first occluder and never calls a_hit or a_miss */
+_BU_ATTR_FLATTEN static int
+shootray(register struct application *ap, struct shoot_occlusion *oq)
 {
     struct rt_shootray_status ss;
     struct seg new_segs;	/* from solid intersections */
@@ -834,7 +915,9 @@ rt_shootray(register struct application *ap)
 	    goto start_cell;
 	}
 	resp->re_nmiss_model++;
-	if (ap->a_miss)
+	if (oq)
+	    ap->a_return = 0;
+	else if (ap->a_miss)
 	    ap->a_return = ap->a_miss(ap);
 	else
 	    ap->a_return = 0;
@@ -1147,7 +1230,9 @@ rt_shootray(register struct application *ap)
 		    rt_pr_seg(segp);
 		}
 	    }
-	    if (ap->a_onehit != 0) {
+	    if (oq && shoot_occluded_segs(oq, ap, &waiting_segs))
+		goto occluded;
+	    if (ap->a_onehit != 0 || oq) {
 		int done;
 
 		/* Weave these segments into partition list */
@@ -1177,6 +1262,12 @@ rt_shootray(register struct application *ap)
 				    last_bool_start, pending_hit, regionbits, ap, solidbits);
 		last_bool_start = pending_hit;
 
+		if (oq) {
+		    if (shoot_occluded_parts(oq, ap, &FinalPart))
+			goto occluded;
+		    done = 0;
+		}
+
 		/* See if enough partitions have been acquired */
 		if (done > 0) goto hitit;
 	    }
@@ -1187,6 +1278,10 @@ rt_shootray(register struct application *ap)
 	    ap->a_ray_length < pending_hit)
 	    goto weave;
 
+	/* Nothing past the end of the occlusion interval matters */
+	if (oq && ss.box_end >= oq->maxdist && oq->maxdist < pending_hit)
+	    goto weave;
+
 	/* Push ray onwards to next box */
 	ss.box_start = ss.box_end;
     }
@@ -1215,9 +1310,24 @@ weave:
     }
 
     if (BU_LIST_NON_EMPTY(&(waiting_segs.l))) {
+	if (oq && shoot_occluded_segs(oq, ap, &waiting_segs))
+	    goto occluded;
 	rt_boolweave(&finished_segs, &waiting_segs, &InitialPart, ap);
     }
 
+    if (oq) {
+	(void)rt_boolfinal(&InitialPart, &FinalPart, last_bool_start,
+			   INFINITY, regionbits, ap, solidbits);
+	if (shoot_occluded_parts(oq, ap, &FinalPart))
+	    goto occluded;
+	ap->a_return = (oq->seen) ? -1 : 0;
+	status = (oq->seen) ? "CLEAR (non-occluders seen)" : "CLEAR";
+	RT_FREE_PT_LIST(&InitialPart, resp);
+	RT_FREE_PT_LIST(&FinalPart, resp);
+	RT_FREE_SEG_LIST(&finished_segs, resp);
+	goto out;
+    }
+
     /* finished_segs chain now has all segments hit by this ray */
     if (BU_LIST_IS_EMPTY(&(finished_segs.l))) {
 	if (ap->a_miss)
@@ -1274,6 +1384,15 @@ hitit:
 
     RT_FREE_SEG_LIST(&finished_segs, resp);
     RT_FREE_PT_LIST(&FinalPart, resp);
+    goto out;
+
+occluded:
+    ap->a_return = 1;
+    status = "OCCLUDED";
+    RT_FREE_SEG_LIST(&waiting_segs, resp);
+    RT_FREE_PT_LIST(&InitialPart, resp);
+    RT_FREE_PT_LIST(&FinalPart, resp);
+    RT_FREE_SEG_LIST(&finished_segs, resp);
 
     /*
      * Processing of this ray is complete.
@@ -1313,6 +1432,51 @@ out:
 }
 
 
+int
+rt_shootray(struct application *ap)
+{
+    return shootray(ap, NULL);
+}
+
+
+static int
+shoot_occluded(struct application *ap, fastf_t mindist, fastf_t maxdist, int (*occluder)(struct application *, const struct region *), int entry)
+{
+    struct shoot_occlusion oq;
+    int onehit = ap->a_onehit;
+    int ret;
+
+    oq.mindist = mindist;
+    oq.maxdist = maxdist;
+    oq.occluder = occluder;
+    oq.entry = entry;
+    oq.straddled = 0;
+    oq.seen = 0;
+
+    /* The query decides for itself when it is done - the partitions
+     * are evaluated as far as each cell allows */
+    ap->a_onehit = 0;
+    ret = shootray(ap, &oq);
+    ap->a_onehit = onehit;
+
+    return ret;
+}
+
+
+int
+rt_shootray_occluded(struct application *ap, fastf_t mindist, fastf_t maxdist, int (*occluder)(struct application *, const struct region *))
+{
+    return shoot_occluded(ap, mindist, maxdist, occluder, 0);
+}
+
+
+int
+rt_shootray_occluded_entry(struct application *ap, fastf_t mindist, fastf_t maxdist, int (*occluder)(struct application *, const struct region *))
+{
+    return shoot_occluded(ap, mindist, maxdist, occluder, 1);
+}
+
+
 const union cutter *
 rt_cell_n_on_ray(register struct application *ap, int n)
 
@@ -0,0 +1,290 @@
+/*                     B R E P _ S H O T . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/* Shot throughput for B-Rep models (the regress/nurbs geometry, or any
+ * other .g file) - a grid of rays is fired along each axis and along a
+ * skewed direction at the named objects, and the rays per second are
+ * reported.  With -s the objects are taken to be a sphere centered in
+ * their bounding box, and every partition is checked against the exact
+ * chord length.  With -m the same grid is fired again with the breps
+ * shot as tessellations (LIBRT_BREP_MESH set to the -m argument, and
+ * LIBRT_BREP_MESH_TOL to the -t argument if given), and the hit count
+ * and total partition length are compared with the exact shots as
+ * proxies for area and volume error.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/env.h"
+#include "bu/getopt.h"
+#include "bu/time.h"
+#include "raytrace.h"
+
+struct brep_shot_state {
+    point_t center;
+    fastf_t radius;
+    fastf_t tol;
+    int sphere;
+    size_t hits;
+    size_t parts;
+    size_t fails;
+    fastf_t length;
+    fastf_t extent;
+    point_t grid_center;
+};
+
+static int
+brep_shot_hit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(segs))
+{
+    struct brep_shot_state *s = (struct brep_shot_state *)ap->a_uptr;
+    struct partition *pp;
+    int cnt = 0;
+
+    for (pp = PartHeadp->pt_forw; pp != PartHeadp; pp = pp->pt_forw) {
+	cnt++;
+	s->length += pp->pt_outhit->hit_dist - pp->pt_inhit->hit_dist;
+	if (pp->pt_outhit->hit_dist < pp->pt_inhit->hit_dist)
+	    s->fails++;
+	if (s->sphere) {
+	    vect_t tocenter;
+	    VSUB2(tocenter, s->center, ap->a_ray.r_pt);
+	    fastf_t along = VDOT(tocenter, ap->a_ray.r_dir);
+	    fastf_t d2 = MAGSQ(tocenter) - along * along;
+	    fastf_t mid = 0.5 * (pp->pt_inhit->hit_dist + pp->pt_outhit->hit_dist);
+	    fastf_t half = 0.5 * (pp->pt_outhit->hit_dist - pp->pt_inhit->hit_dist);
+	    /* distances along nearly grazing rays are poorly conditioned */
+	    if (half < 0.1 * s->radius)
+		continue;
+	    if (fabs(mid - along) > s->tol || fabs(sqrt(half * half + d2) - s->radius) > s->tol) {
+		s->fails++;
+		bu_log("ray (%g %g %g) dir (%g %g %g): partition [%g, %g], centered at %g\n",
+		       V3ARGS(ap->a_ray.r_pt), V3ARGS(ap->a_ray.r_dir),
+		       pp->pt_inhit->hit_dist, pp->pt_outhit->hit_dist, along);
+	    }
+	}
+    }
+    if (s->sphere && cnt > 1)
+	s->fails++;
+
+    s->hits++;
+    s->parts += cnt;
+    return 1;
+}
+
+/* Sizes the sphere from a ray through its center - the bounding box of
+ * a NURBS surface isn't necessarily tight */
+static int
+brep_shot_radius(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(segs))
+{
+    struct brep_shot_state *s = (struct brep_shot_state *)ap->a_uptr;
+    struct partition *pp = PartHeadp->pt_forw;
+    s->radius = 0.5 * (pp->pt_outhit->hit_dist - pp->pt_inhit->hit_dist);
+    return 1;
+}
+
+static int
+brep_shot_miss(struct application *UNUSED(ap))
+{
+    return 0;
+}
+
+/* Fire the ray grid at the objects, returning -1 if they can't be
+ * loaded */
+static int
+brep_shot_run(const char *gfile, int nobj, const char **objs, int grid, struct brep_shot_state *s)
+{
+    struct application ap;
+    struct rt_i *rtip;
+
+    rtip = rt_dirbuild(gfile, NULL, 0);
+    if (rtip == RTI_NULL) {
+	bu_log("ERROR: unable to open %s\n", gfile);
+	return -1;
+    }
+    if (rt_gettrees(rtip, nobj, objs, 1) < 0) {
+	bu_log("ERROR: rt_gettrees failed\n");
+	rt_free_rti(rtip);
+	return -1;
+    }
+
+    int64_t start = bu_gettime();
+    rt_prep(rtip);
+    bu_log("prep: %.3f sec\n", (bu_gettime() - start) / 1000000.0);
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_miss = brep_shot_miss;
+    ap.a_onehit = 0;
+    ap.a_uptr = (void *)s;
+
+    VADD2SCALE(s->center, rtip->mdl_min, rtip->mdl_max, 0.5);
+    if (s->sphere) {
+	ap.a_hit = brep_shot_radius;
+	VSET(ap.a_ray.r_dir, 1, 0, 0);
+	VJOIN1(ap.a_ray.r_pt, s->center, -2 * (rtip->mdl_max[X] - rtip->mdl_min[X]), ap.a_ray.r_dir);
+	if (!rt_shootray(&ap) || s->radius <= 0) {
+	    bu_log("ERROR: no hit through the center of the sphere\n");
+	    rt_free_rti(rtip);
+	    return -1;
+	}
+	s->tol = (s->radius * 1.0e-4 > 2 * rtip->rti_tol.dist) ? s->radius * 1.0e-4 : 2 * rtip->rti_tol.dist;
+    }
+    ap.a_hit = brep_shot_hit;
+
+    vect_t dirs[4];
+    VSET(dirs[0], 1, 0, 0);
+    VSET(dirs[1], 0, 1, 0);
+    VSET(dirs[2], 0, 0, 1);
+    VSET(dirs[3], 0.36, -0.48, 0.8);
+
+    /* the grid is sized by the bounding box of the first run, so a
+     * comparison run fires exactly the same rays */
+    if (s->extent <= 0) {
+	s->extent = DIST_PNT_PNT(rtip->mdl_min, rtip->mdl_max);
+	VMOVE(s->grid_center, s->center);
+    }
+    size_t nrays = 0;
+    start = bu_gettime();
+    for (int d = 0; d < 4; d++) {
+	vect_t u, v;
+	bn_vec_ortho(u, dirs[d]);
+	VCROSS(v, dirs[d], u);
+	for (int i = 0; i < grid; i++) {
+	    for (int j = 0; j < grid; j++) {
+		fastf_t a = s->extent * ((i + 0.5) / grid - 0.5);
+		fastf_t b = s->extent * ((j + 0.5) / grid - 0.5);
+		VJOIN3(ap.a_ray.r_pt, s->grid_center, -s->extent, dirs[d], a, u, b, v);
+		VMOVE(ap.a_ray.r_dir, dirs[d]);
+		(void)rt_shootray(&ap);
+		nrays++;
+	    }
+	}
+    }
+    fastf_t elapsed = (bu_gettime() - start) / 1000000.0;
+
+    bu_log("%zu rays, %zu hit, %zu partitions: %.3f sec, %.0f rays/sec\n",
+	   nrays, s->hits, s->parts, elapsed, (elapsed > 0) ? nrays / elapsed : 0.0);
+
+    rt_free_rti(rtip);
+    return 0;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    struct brep_shot_state s;
+    struct brep_shot_state ms;
+    int grid = 200;
+    int c;
+    const char *mesh_mode = NULL;
+    const char *mesh_tol = NULL;
+    fastf_t max_err = 0.01;
+    const char *usage = "Usage: %s [-s] [-n grid_size] [-m mesh|refine [-t mesh_tol] [-e max_rel_err]] file.g object [object ...]\n";
+
+    bu_setprogname(argv[0]);
+    memset(&s, 0, sizeof(struct brep_shot_state));
+    memset(&ms, 0, sizeof(struct brep_shot_state));
+
+    while ((c = bu_getopt(argc, argv, "sn:m:t:e:")) != -1) {
+	switch (c) {
+	    case 's':
+		s.sphere = 1;
+		break;
+	    case 'n':
+		grid = atoi(bu_optarg);
+		break;
+	    case 'm':
+		mesh_mode = bu_optarg;
+		break;
+	    case 't':
+		mesh_tol = bu_optarg;
+		break;
+	    case 'e':
+		max_err = atof(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, usage, argv[0]);
+	}
+    }
+    if (argc - bu_optind < 2 || grid < 1)
+	bu_exit(1, usage, argv[0]);
+
+    const char *gfile = argv[bu_optind];
+    int nobj = argc - bu_optind - 1;
+    const char **objs = (const char **)&argv[bu_optind + 1];
+
+    bu_setenv("LIBRT_BREP_MESH", "", 1);
+    if (brep_shot_run(gfile, nobj, objs, grid, &s) < 0)
+	return 1;
+
+    if (!s.hits) {
+	bu_log("ERROR: no rays hit\n");
+	return 1;
+    }
+    if (s.fails) {
+	bu_log("ERROR: %zu bad partitions\n", s.fails);
+	return 1;
+    }
+    if (!mesh_mode)
+	return 0;
+
+    /* Tessellated shots won't reproduce the exact chord lengths the
+     * sphere check expects - compare with the exact shots instead */
+    bu_setenv("LIBRT_BREP_MESH", mesh_mode, 1);
+    if (mesh_tol)
+	bu_setenv("LIBRT_BREP_MESH_TOL", mesh_tol, 1);
+    ms.extent = s.extent;
+    VMOVE(ms.grid_center, s.grid_center);
+    bu_log("%s mode:\n", mesh_mode);
+    if (brep_shot_run(gfile, nobj, objs, grid, &ms) < 0)
+	return 1;
+
+    fastf_t area_err = fabs((fastf_t)ms.hits - (fastf_t)s.hits) / (fastf_t)s.hits;
+    fastf_t vol_err = (s.length > 0) ? fabs(ms.length - s.length) / s.length : 0.0;
+    bu_log("%s mode: area error %g, volume error %g\n", mesh_mode, area_err, vol_err);
+    if (ms.fails) {
+	bu_log("ERROR: %zu bad partitions in %s mode\n", ms.fails, mesh_mode);
+	return 1;
+    }
+    if (area_err > max_err || vol_err > max_err) {
+	bu_log("ERROR: %s mode error exceeds %g\n", mesh_mode, max_err);
+	return 1;
+    }
+    return 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,301 @@
+/*                      D S P _ S H O T . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/* Checks the DSP min/max mipmap walk against a brute force reference.
+ * A pseudo-random height field is shot with rays that start above its
+ * highest point and end below its base, inside its footprint, so every
+ * segment boundary is a crossing of the top surface except the last,
+ * which is on the base.  The reference intersects each ray with the
+ * two triangles of every cell (cut lower left to upper right) and the
+ * segments rt_dsp_shot() reports must match.  The optional arguments
+ * are the number of samples along each side and the number of rays.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/malloc.h"
+#include "bu/time.h"
+#include "bn.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+struct dsp_crossing {
+    fastf_t dist;
+    int entering;
+};
+
+static unsigned short *
+dsp_mk(struct rt_wdb *wdbp, int n, unsigned short *hmax)
+{
+    struct rt_dsp_internal *dsp;
+    unsigned short *elev;
+
+    elev = (unsigned short *)bu_malloc(n * n * sizeof(unsigned short), "elevations");
+    *hmax = 0;
+    for (int y = 0; y < n; y++) {
+	for (int x = 0; x < n; x++) {
+	    /* rolling terrain with some noise, so both smooth runs and
+	     * abrupt steps are walked */
+	    fastf_t h = 100.0 + 60.0 * sin(0.11 * x) * cos(0.07 * y) + 30.0 * bn_randmt();
+	    elev[y * n + x] = (unsigned short)h;
+	    if (elev[y * n + x] > *hmax)
+		*hmax = elev[y * n + x];
+	}
+    }
+    mk_binunif(wdbp, "dsp.bin", elev, WDB_BINUNIF_UINT16, (long)(n * n));
+
+    /* mk_dsp() only knows about files */
+    BU_ALLOC(dsp, struct rt_dsp_internal);
+    dsp->magic = RT_DSP_INTERNAL_MAGIC;
+    bu_vls_init(&dsp->dsp_name);
+    bu_vls_strcat(&dsp->dsp_name, "dsp.bin");
+    dsp->dsp_xcnt = n;
+    dsp->dsp_ycnt = n;
+    dsp->dsp_smooth = 0;
+    dsp->dsp_cuttype = DSP_CUT_DIR_llUR;
+    dsp->dsp_datasrc = RT_DSP_SRC_OBJ;
+    MAT_IDN(dsp->dsp_stom);
+    MAT_IDN(dsp->dsp_mtos);
+    wdb_export(wdbp, "dsp.s", (void *)dsp, ID_DSP, mk_conv2mm);
+
+    return elev;
+}
+
+/* Ray/triangle intersection, recording the crossing if there is one */
+static int
+dsp_tri(const struct xray *rp, const fastf_t *a, const fastf_t *b, const fastf_t *c, struct dsp_crossing *cp)
+{
+    vect_t e1, e2, p, q, t;
+    fastf_t det, u, v;
+
+    VSUB2(e1, b, a);
+    VSUB2(e2, c, a);
+    VCROSS(p, rp->r_dir, e2);
+    det = VDOT(e1, p);
+    if (ZERO(det))
+	return 0;
+    VSUB2(t, rp->r_pt, a);
+    u = VDOT(t, p) / det;
+    if (u < -1.0e-12 || u > 1.0 + 1.0e-12)
+	return 0;
+    VCROSS(q, t, e1);
+    v = VDOT(rp->r_dir, q) / det;
+    if (v < -1.0e-12 || u + v > 1.0 + 1.0e-12)
+	return 0;
+
+    /* The triangles wind counter-clockwise seen from above, so a
+     * positive determinant means the ray is heading down into the
+     * solid */
+    cp->dist = VDOT(e2, q) / det;
+    cp->entering = (det > 0);
+    return 1;
+}
+
+static int
+dsp_crossing_cmp(const void *a, const void *b)
+{
+    const struct dsp_crossing *ca = (const struct dsp_crossing *)a;
+    const struct dsp_crossing *cb = (const struct dsp_crossing *)b;
+    if (ca->dist < cb->dist)
+	return -1;
+    return (ca->dist > cb->dist) ? 1 : 0;
+}
+
+/* Reference segments for a ray, as in/out distance pairs.  Returns the
+ * number of segments, or -1 if the ray grazes the surface too closely
+ * for the answer to be well defined. */
+static int
+dsp_ref(const struct xray *rp, const unsigned short *elev, int n, struct dsp_crossing *cross, fastf_t *segs, fastf_t tol)
+{
+    int ncross = 0;
+    int nsegs = 0;
+
+    for (int y = 0; y < n - 1; y++) {
+	for (int x = 0; x < n - 1; x++) {
+	    point_t A, B, C, D;
+	    VSET(A, x, y, elev[y * n + x]);
+	    VSET(B, x + 1, y, elev[y * n + x + 1]);
+	    VSET(C, x, y + 1, elev[(y + 1) * n + x]);
+	    VSET(D, x + 1, y + 1, elev[(y + 1) * n + x + 1]);
+	    ncross += dsp_tri(rp, A, B, D, &cross[ncross]);
+	    ncross += dsp_tri(rp, A, D, C, &cross[ncross]);
+	}
+    }
+    qsort(cross, ncross, sizeof(struct dsp_crossing), dsp_crossing_cmp);
+
+    /* A ray through a shared edge or vertex hits more than one triangle
+     * at the same point - those are one crossing */
+    int ndistinct = 0;
+    for (int i = 0; i < ncross; i++) {
+	if (ndistinct && cross[i].entering == cross[ndistinct - 1].entering &&
+	    cross[i].dist - cross[ndistinct - 1].dist < 1.0e-9)
+	    continue;
+	cross[ndistinct++] = cross[i];
+    }
+
+    for (int i = 1; i < ndistinct; i++) {
+	if (cross[i].dist - cross[i - 1].dist < 2 * tol)
+	    return -1;
+    }
+
+    /* Alternately entering and leaving, and still inside at the base */
+    if (!(ndistinct % 2))
+	return -1;
+    for (int i = 0; i < ndistinct; i++) {
+	if (cross[i].entering != !(i % 2))
+	    return -1;
+	segs[nsegs++] = cross[i].dist;
+    }
+    segs[nsegs++] = -rp->r_pt[Z] / rp->r_dir[Z];
+
+    return nsegs / 2;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct rt_i *rtip;
+    struct application ap;
+    struct soltab *stp;
+    unsigned short *elev;
+    unsigned short hmax;
+    int nsamples = 64;
+    int nrays = 2000;
+    int fails = 0;
+    int skipped = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc > 3)
+	bu_exit(1, "Usage: %s [sample_count [ray_count]]\n", argv[0]);
+    if (argc > 1 && (sscanf(argv[1], "%d", &nsamples) != 1 || nsamples < 3))
+	bu_exit(1, "ERROR: invalid sample count %s\n", argv[1]);
+    if (argc > 2 && (sscanf(argv[2], "%d", &nrays) != 1 || nrays < 1))
+	bu_exit(1, "ERROR: invalid ray count %s\n", argv[2]);
+
+    bn_randmt_seed(5489);
+
+    dbip = db_open_inmem();
+    if (dbip == DBI_NULL)
+	bu_exit(1, "ERROR: unable to create in-memory database\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+    elev = dsp_mk(wdbp, nsamples, &hmax);
+
+    rtip = rt_new_rti(dbip);
+    if (rt_gettree(rtip, "dsp.s") < 0)
+	bu_exit(1, "ERROR: rt_gettree failed\n");
+    rt_prep(rtip);
+    stp = rt_find_solid(rtip, "dsp.s");
+    if (!stp)
+	bu_exit(1, "ERROR: dsp.s was not prepped\n");
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+
+    fastf_t tol = rtip->rti_tol.dist;
+    size_t ncells = (size_t)(nsamples - 1) * (nsamples - 1);
+    struct dsp_crossing *cross = (struct dsp_crossing *)bu_calloc(2 * ncells, sizeof(struct dsp_crossing), "crossings");
+    fastf_t *ref = (fastf_t *)bu_calloc(2 * ncells + 2, sizeof(fastf_t), "ref segs");
+    fastf_t lo = 0.5;
+    fastf_t hi = nsamples - 1.5;
+    int64_t t_dsp = 0;
+
+    for (int i = 0; i < nrays; i++) {
+	struct xray ray;
+	struct seg segs;
+	point_t end;
+
+	/* Start above the highest point and end below the base, both
+	 * inside the footprint - some rays steep, most of them long
+	 * shallow runs across many cells */
+	VSET(ray.r_pt, lo + (hi - lo) * bn_randmt(), lo + (hi - lo) * bn_randmt(), hmax + 1.0 + 50.0 * bn_randmt());
+	VSET(end, lo + (hi - lo) * bn_randmt(), lo + (hi - lo) * bn_randmt(), -1.0);
+	if (i % 8 == 0)
+	    VSET(end, ray.r_pt[X] + bn_randmt() - 0.5, ray.r_pt[Y] + bn_randmt() - 0.5, -1.0);
+	VSUB2(ray.r_dir, end, ray.r_pt);
+	VUNITIZE(ray.r_dir);
+	ray.magic = RT_RAY_MAGIC;
+	ray.index = i;
+	ray.r_min = 0;
+	ray.r_max = INFINITY;
+
+	int nref = dsp_ref(&ray, elev, nsamples, cross, ref, tol);
+	if (nref < 0) {
+	    skipped++;
+	    continue;
+	}
+
+	BU_LIST_INIT(&segs.l);
+	int64_t start = bu_gettime();
+	(void)stp->st_meth->ft_shot(stp, &ray, &ap, &segs);
+	t_dsp += bu_gettime() - start;
+
+	int match = 1;
+	int s = 0;
+	struct seg *sp;
+	for (BU_LIST_FOR(sp, seg, &segs.l)) {
+	    if (s >= nref ||
+		fabs(sp->seg_in.hit_dist - ref[2 * s]) > tol ||
+		fabs(sp->seg_out.hit_dist - ref[2 * s + 1]) > tol)
+		match = 0;
+	    s++;
+	}
+	if (s != nref)
+	    match = 0;
+
+	if (!match) {
+	    fails++;
+	    bu_log("ray %d: %d segments, expected %d\n", i, s, nref);
+	    VPRINT("  pt ", ray.r_pt);
+	    VPRINT("  dir", ray.r_dir);
+	}
+	RT_FREE_SEG_LIST(&segs, ap.a_resource);
+    }
+
+    bu_log("dsp: %d rays (%d grazing, not checked), %8.3f ms, %d differ\n",
+	   nrays, skipped, t_dsp / 1000.0, fails);
+
+    bu_free(cross, "crossings");
+    bu_free(ref, "ref segs");
+    bu_free(elev, "elevations");
+    rt_free_rti(rtip);
+    wdb_close(wdbp);
+
+    return (fails) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -103,6 +103,10 @@ main(int argc, char *argv[])
     seconds = elapsed / 1000000.0;
     bu_log("lod level setting: %f sec\n", seconds);
 
+    struct bv_mesh_lod_stats st;
+    bv_mesh_lod_stats_get(c, &st);
+    bu_log("lod resident data: %zu bytes (peak %zu)\n", st.resident, st.peak);
+
     BU_PUT(s, struct bv_scene_obj);
     bv_mesh_lod_destroy(mlod);
     bv_mesh_lod_context_destroy(c);
@@ -0,0 +1,289 @@
+/*                       O C C L U D E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/* Consistency and throughput of rt_shootray_occluded() compared with
+ * full rt_shootray() partition lists.  A lattice of regions - plain
+ * spheres, hollowed boxes, unions of spheres and air - is crossed by
+ * pseudo-random segments between points in the model, the way shadow
+ * rays run from a surface to a light, and the occlusion answer for
+ * each must match what the partitions of the full shot say.  Air is
+ * treated as a non-occluder.  The same rays are then checked against
+ * rt_shootray_occluded_entry(), where regions a ray starts inside of
+ * don't count, as ambient occlusion rays need.  The optional arguments
+ * are the lattice size and the number of rays.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/malloc.h"
+#include "bu/time.h"
+#include "bn.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+struct occlude_ray {
+    point_t pt;
+    vect_t dir;
+    fastf_t dist;
+};
+
+static void
+occlude_mk(struct rt_wdb *wdbp, int n)
+{
+    struct wmember all;
+    struct bu_vls name = BU_VLS_INIT_ZERO;
+    struct bu_vls sname = BU_VLS_INIT_ZERO;
+
+    BU_LIST_INIT(&all.l);
+    for (int i = 0; i < n * n * n; i++) {
+	struct wmember reg;
+	point_t c, min, max;
+	int air = 0;
+
+	VSET(c, 10.0 * (i % n), 10.0 * ((i / n) % n), 10.0 * (i / (n * n)));
+	BU_LIST_INIT(&reg.l);
+	bu_vls_sprintf(&sname, "s%d.s", i);
+
+	switch (i % 4) {
+	    case 0:
+		mk_sph(wdbp, bu_vls_cstr(&sname), c, 3.0);
+		(void)mk_addmember(bu_vls_cstr(&sname), &reg.l, NULL, WMOP_UNION);
+		break;
+	    case 1:
+		/* hollow box, with holes through the middle of each face */
+		VSET(min, c[X] - 3, c[Y] - 3, c[Z] - 3);
+		VSET(max, c[X] + 3, c[Y] + 3, c[Z] + 3);
+		mk_rpp(wdbp, bu_vls_cstr(&sname), min, max);
+		(void)mk_addmember(bu_vls_cstr(&sname), &reg.l, NULL, WMOP_UNION);
+		bu_vls_sprintf(&sname, "h%d.s", i);
+		mk_sph(wdbp, bu_vls_cstr(&sname), c, 3.5);
+		(void)mk_addmember(bu_vls_cstr(&sname), &reg.l, NULL, WMOP_SUBTRACT);
+		break;
+	    case 2:
+		mk_sph(wdbp, bu_vls_cstr(&sname), c, 4.0);
+		(void)mk_addmember(bu_vls_cstr(&sname), &reg.l, NULL, WMOP_UNION);
+		air = 1;
+		break;
+	    default:
+		c[X] -= 1.5;
+		mk_sph(wdbp, bu_vls_cstr(&sname), c, 2.0);
+		(void)mk_addmember(bu_vls_cstr(&sname), &reg.l, NULL, WMOP_UNION);
+		bu_vls_sprintf(&sname, "u%d.s", i);
+		c[X] += 3.0;
+		mk_sph(wdbp, bu_vls_cstr(&sname), c, 2.0);
+		(void)mk_addmember(bu_vls_cstr(&sname), &reg.l, NULL, WMOP_UNION);
+		break;
+	}
+
+	bu_vls_sprintf(&name, "r%d.r", i);
+	mk_comb(wdbp, bu_vls_cstr(&name), &reg.l, 1, NULL, NULL, NULL, (air) ? 0 : 1000 + i, air, 0, 0, 0, 0, 0);
+	(void)mk_addmember(bu_vls_cstr(&name), &all.l, NULL, WMOP_UNION);
+    }
+    mk_lcomb(wdbp, "all", &all, 0, NULL, NULL, NULL, 0);
+
+    bu_vls_free(&name);
+    bu_vls_free(&sname);
+}
+
+static int
+occlude_occluder(struct application *UNUSED(ap), const struct region *regp)
+{
+    return (regp->reg_aircode == 0);
+}
+
+/* What the full partition list says: 1 occluded, -1 only air, 0 clear */
+static int
+occlude_hit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(segs))
+{
+    struct partition *pp;
+    int ret = 0;
+
+    for (pp = PartHeadp->pt_forw; pp != PartHeadp; pp = pp->pt_forw) {
+	if (pp->pt_outhit->hit_dist <= 0 || pp->pt_inhit->hit_dist >= ap->a_dist)
+	    continue;
+	if (occlude_occluder(ap, pp->pt_regionp))
+	    return 1;
+	ret = -1;
+    }
+    return ret;
+}
+
+/* As occlude_hit(), but passing over regions entered behind the start */
+static int
+occlude_entry_hit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(segs))
+{
+    struct partition *pp;
+    int ret = 0;
+
+    for (pp = PartHeadp->pt_forw; pp != PartHeadp; pp = pp->pt_forw) {
+	if (pp->pt_inhit->hit_dist <= 0 || pp->pt_inhit->hit_dist >= ap->a_dist)
+	    continue;
+	if (occlude_occluder(ap, pp->pt_regionp))
+	    return 1;
+	ret = -1;
+    }
+    return ret;
+}
+
+static int
+occlude_miss(struct application *UNUSED(ap))
+{
+    return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct rt_i *rtip;
+    struct application ap;
+    const char *top = "all";
+    int n = 8;
+    int nrays = 100000;
+    int ridx = 0;
+    int fails = 0;
+    int counts[3] = {0, 0, 0};
+
+    bu_setprogname(argv[0]);
+
+    if (argc > 3)
+	bu_exit(1, "Usage: %s [lattice_size [ray_count]]\n", argv[0]);
+    if (argc > 1 && (sscanf(argv[1], "%d", &n) != 1 || n < 1))
+	bu_exit(1, "ERROR: invalid lattice size %s\n", argv[1]);
+    if (argc > 2 && (sscanf(argv[2], "%d", &nrays) != 1 || nrays < 1))
+	bu_exit(1, "ERROR: invalid ray count %s\n", argv[2]);
+
+    dbip = db_open_inmem();
+    if (dbip == DBI_NULL)
+	bu_exit(1, "ERROR: unable to create in-memory database\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+    occlude_mk(wdbp, n);
+
+    rtip = rt_new_rti(dbip);
+    if (rt_gettrees(rtip, 1, &top, 1) < 0)
+	bu_exit(1, "ERROR: rt_gettrees failed\n");
+    rt_prep(rtip);
+
+    struct occlude_ray *rays = (struct occlude_ray *)bu_calloc(nrays, sizeof(struct occlude_ray), "rays");
+    int *ref = (int *)bu_calloc(nrays, sizeof(int), "ref");
+    for (int i = 0; i < nrays; i++) {
+	point_t end;
+	VSET(rays[i].pt,
+	     rtip->mdl_min[X] + BN_RANDOM(ridx) * (rtip->mdl_max[X] - rtip->mdl_min[X]),
+	     rtip->mdl_min[Y] + BN_RANDOM(ridx) * (rtip->mdl_max[Y] - rtip->mdl_min[Y]),
+	     rtip->mdl_min[Z] + BN_RANDOM(ridx) * (rtip->mdl_max[Z] - rtip->mdl_min[Z]));
+	VSET(end,
+	     rtip->mdl_min[X] + BN_RANDOM(ridx) * (rtip->mdl_max[X] - rtip->mdl_min[X]),
+	     rtip->mdl_min[Y] + BN_RANDOM(ridx) * (rtip->mdl_max[Y] - rtip->mdl_min[Y]),
+	     rtip->mdl_min[Z] + BN_RANDOM(ridx) * (rtip->mdl_max[Z] - rtip->mdl_min[Z]));
+	VSUB2(rays[i].dir, end, rays[i].pt);
+	rays[i].dist = MAGNITUDE(rays[i].dir);
+	if (rays[i].dist < SMALL_FASTF) {
+	    VSET(rays[i].dir, 1, 0, 0);
+	    rays[i].dist = 1;
+	}
+	VUNITIZE(rays[i].dir);
+    }
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_hit = occlude_hit;
+    ap.a_miss = occlude_miss;
+    ap.a_onehit = 0;
+
+    int64_t start = bu_gettime();
+    for (int i = 0; i < nrays; i++) {
+	VMOVE(ap.a_ray.r_pt, rays[i].pt);
+	VMOVE(ap.a_ray.r_dir, rays[i].dir);
+	ap.a_dist = rays[i].dist;
+	ref[i] = rt_shootray(&ap);
+    }
+    fastf_t t_full = (bu_gettime() - start) / 1000.0;
+
+    start = bu_gettime();
+    for (int i = 0; i < nrays; i++) {
+	VMOVE(ap.a_ray.r_pt, rays[i].pt);
+	VMOVE(ap.a_ray.r_dir, rays[i].dir);
+	int ret = rt_shootray_occluded(&ap, 0.0, rays[i].dist, occlude_occluder);
+	counts[ret + 1]++;
+	if (ret != ref[i]) {
+	    fails++;
+	    if (fails < 10) {
+		bu_log("ray %d: occlusion query %d, partitions %d\n", i, ret, ref[i]);
+		VPRINT("  pt ", rays[i].pt);
+		VPRINT("  dir", rays[i].dir);
+		bu_log("  dist %g\n", rays[i].dist);
+	    }
+	}
+    }
+    fastf_t t_occ = (bu_gettime() - start) / 1000.0;
+
+    bu_log("%d rays: %d occluded, %d air only, %d clear\n", nrays, counts[2], counts[0], counts[1]);
+    bu_log("rt_shootray:          %8.3f ms\n", t_full);
+    bu_log("rt_shootray_occluded: %8.3f ms (%.1fx), %d differ\n",
+	   t_occ, (t_occ > 0) ? t_full / t_occ : 0.0, fails);
+
+    ap.a_hit = occlude_entry_hit;
+    int entry_fails = 0;
+    for (int i = 0; i < nrays; i++) {
+	VMOVE(ap.a_ray.r_pt, rays[i].pt);
+	VMOVE(ap.a_ray.r_dir, rays[i].dir);
+	ap.a_dist = rays[i].dist;
+	int expect = rt_shootray(&ap);
+	int ret = rt_shootray_occluded_entry(&ap, 0.0, rays[i].dist, occlude_occluder);
+	if (ret != expect) {
+	    entry_fails++;
+	    if (entry_fails < 10) {
+		bu_log("ray %d: entry occlusion query %d, partitions %d\n", i, ret, expect);
+		VPRINT("  pt ", rays[i].pt);
+		VPRINT("  dir", rays[i].dir);
+		bu_log("  dist %g\n", rays[i].dist);
+	    }
+	}
+    }
+    bu_log("rt_shootray_occluded_entry: %d differ\n", entry_fails);
+    fails += entry_fails;
+
+    bu_free(rays, "rays");
+    bu_free(ref, "ref");
+    rt_free_rti(rtip);
+    wdb_close(wdbp);
+
+    /* Timing is reported, but too machine dependent to test */
+    return (fails) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
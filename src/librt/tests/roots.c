@@ -0,0 +1,202 @@
+/*                         R O O T S . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/* Accuracy and throughput of rt_poly_quartic_roots() compared with the
+ * general rt_poly_roots() solver.  Quartics are built from known roots -
+ * a mix of real roots and complex conjugate pairs, with magnitudes spread
+ * the way torus intersections produce them - and each solver's real roots
+ * are checked against the known ones.  The optional argument is the
+ * number of quartics to solve.
+ */
+
+#include "common.h"
+
+#include <math.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/malloc.h"
+#include "bu/time.h"
+#include "bn.h"
+#include "raytrace.h"
+
+struct quartic_case {
+    bn_poly_t eqn;
+    fastf_t real[4];
+    int nreal;
+};
+
+/* Multiply the monic polynomial p by (x^2 + b*x + c) */
+static void
+quartic_mul2(bn_poly_t *p, fastf_t b, fastf_t c)
+{
+    bn_poly_t q;
+    bn_poly_t f;
+    f.magic = BN_POLY_MAGIC;
+    f.dgr = 2;
+    f.cf[0] = 1;
+    f.cf[1] = b;
+    f.cf[2] = c;
+    bn_poly_mul(&q, p, &f);
+    *p = q;
+}
+
+static void
+quartic_mk(struct quartic_case *qc)
+{
+    /* Scale of the roots - torus intersections in unit space range from a
+     * few units down to the radius ratio of thin tori */
+    fastf_t scale = pow(10.0, 3.0 * bn_randmt() - 1.0);
+    fastf_t lead = pow(10.0, 4.0 * bn_randmt() - 2.0);
+    int npairs = (int)(bn_randmt() * 3.0);
+    if (npairs > 2)
+	npairs = 2;
+
+    qc->eqn.magic = BN_POLY_MAGIC;
+    qc->eqn.dgr = 0;
+    qc->eqn.cf[0] = 1;
+    qc->nreal = 0;
+
+    for (int i = 0; i < 2; i++) {
+	if (i < npairs) {
+	    fastf_t re = scale * (bn_randmt() - 0.5);
+	    fastf_t im = scale * (bn_randmt() + 0.01);
+	    quartic_mul2(&qc->eqn, -2.0 * re, re * re + im * im);
+	} else {
+	    fastf_t r1 = scale * (bn_randmt() - 0.5);
+	    fastf_t r2 = scale * (bn_randmt() - 0.5);
+	    qc->real[qc->nreal++] = r1;
+	    qc->real[qc->nreal++] = r2;
+	    quartic_mul2(&qc->eqn, -(r1 + r2), r1 * r2);
+	}
+    }
+
+    /* The primitives don't hand over monic polynomials */
+    bn_poly_scale(&qc->eqn, lead);
+}
+
+/* Returns the worst relative error over the known real roots, or -1 if one
+ * of them wasn't found */
+static fastf_t
+quartic_err(const struct quartic_case *qc, const bn_complex_t *roots, int nroots)
+{
+    fastf_t worst = 0;
+    if (nroots != 4)
+	return -1;
+    for (int i = 0; i < qc->nreal; i++) {
+	fastf_t best = INFINITY;
+	for (int j = 0; j < 4; j++) {
+	    fastf_t err;
+	    if (!NEAR_ZERO(roots[j].im, 1.0e-3 * (1.0 + fabs(qc->real[i]))))
+		continue;
+	    err = fabs(roots[j].re - qc->real[i]) / (1.0 + fabs(qc->real[i]));
+	    if (err < best)
+		best = err;
+	}
+	if (best > worst)
+	    worst = best;
+    }
+    return (worst < INFINITY) ? worst : -1;
+}
+
+int
+main(int argc, char *argv[])
+{
+    int ncases = 100000;
+
+    bu_setprogname(argv[0]);
+
+    if (argc > 2)
+	bu_exit(1, "Usage: %s [quartic_count]\n", argv[0]);
+    if (argc == 2 && (sscanf(argv[1], "%d", &ncases) != 1 || ncases < 1))
+	bu_exit(1, "ERROR: invalid quartic count %s\n", argv[1]);
+
+    struct quartic_case *qc = (struct quartic_case *)bu_calloc(ncases, sizeof(struct quartic_case), "cases");
+    bn_poly_t *eqns = (bn_poly_t *)bu_calloc(ncases, sizeof(bn_poly_t), "eqns");
+    bn_complex_t (*roots)[4] = (bn_complex_t (*)[4])bu_calloc(ncases, sizeof(bn_complex_t) * 4, "roots");
+    int *nroots = (int *)bu_calloc(ncases, sizeof(int), "nroots");
+
+    /* BN_RANDOM's table is only 4096 entries long, so it would hand
+     * back the same few thousand quartics over and over - use the
+     * Mersenne Twister, with a fixed seed so failures can be reproduced */
+    bn_randmt_seed(5489);
+    for (int i = 0; i < ncases; i++)
+	quartic_mk(&qc[i]);
+
+    /* Current general solver */
+    for (int i = 0; i < ncases; i++)
+	eqns[i] = qc[i].eqn;
+    int64_t t0 = bu_gettime();
+    for (int i = 0; i < ncases; i++)
+	nroots[i] = rt_poly_roots(&eqns[i], roots[i], "roots test");
+    int64_t t_general = bu_gettime() - t0;
+    int general_fails = 0;
+    fastf_t general_worst = 0;
+    for (int i = 0; i < ncases; i++) {
+	fastf_t err = quartic_err(&qc[i], roots[i], nroots[i]);
+	if (err < 0 || err > 1.0e-6)
+	    general_fails++;
+	else if (err > general_worst)
+	    general_worst = err;
+    }
+
+    /* Quartic solver, via the batch interface */
+    for (int i = 0; i < ncases; i++) {
+	eqns[i] = qc[i].eqn;
+	nroots[i] = 0;
+    }
+    t0 = bu_gettime();
+    rt_poly_quartic_roots_batch(eqns, roots, nroots, (size_t)ncases, "roots test");
+    int64_t t_quartic = bu_gettime() - t0;
+    int quartic_fails = 0;
+    fastf_t quartic_worst = 0;
+    for (int i = 0; i < ncases; i++) {
+	fastf_t err = quartic_err(&qc[i], roots[i], nroots[i]);
+	if (err < 0 || err > 1.0e-6)
+	    quartic_fails++;
+	else if (err > quartic_worst)
+	    quartic_worst = err;
+    }
+
+    bu_log("rt_poly_roots:         %8.3f ms, %d of %d inaccurate, worst accepted error %g\n",
+	   t_general / 1000.0, general_fails, ncases, general_worst);
+    bu_log("rt_poly_quartic_roots: %8.3f ms, %d of %d inaccurate, worst accepted error %g\n",
+	   t_quartic / 1000.0, quartic_fails, ncases, quartic_worst);
+
+    bu_free(qc, "cases");
+    bu_free(eqns, "eqns");
+    bu_free(roots, "roots");
+    bu_free(nroots, "nroots");
+
+    /* Timing is reported, but too machine dependent to test - accuracy
+     * must not regress */
+    return (quartic_fails > general_fails) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,272 @@
+/*                    V O X E L _ S H O T . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/* Throughput and consistency of the VOL and EBM voxel walks with and
+ * without empty space skipping.  A large, mostly empty synthetic volume
+ * (scattered blobs and one large solid ball, over background noise below
+ * the threshold) and a sparse bitmap are shot with the same
+ * pseudo-random rays, once prepped with LIBRT_VOXEL_BRICKS=0 and once
+ * with the brick maps, and the segments must agree.  The optional
+ * arguments are the volume size in cells and the number of rays.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/env.h"
+#include "bu/malloc.h"
+#include "bu/str.h"
+#include "bu/time.h"
+#include "bn.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+static void
+voxel_mk(struct rt_wdb *wdbp, size_t n)
+{
+    struct rt_ebm_internal *ebm;
+    unsigned char *data;
+    vect_t cellsize;
+    mat_t mat;
+    size_t x, y, z;
+    size_t bn = 4 * n;
+    int ridx = 0;
+
+    MAT_IDN(mat);
+    VSETALL(cellsize, 1.0);
+
+    data = (unsigned char *)bu_malloc(n * n * n, "volume");
+    for (z = 0; z < n; z++) {
+	for (y = 0; y < n; y++) {
+	    for (x = 0; x < n; x++) {
+		fastf_t dx = x - 0.3 * n;
+		fastf_t dy = y - 0.6 * n;
+		fastf_t dz = z - 0.5 * n;
+		unsigned char v = (unsigned char)(20 * BN_RANDOM(ridx));
+
+		/* one large solid ball, and small blobs every so often */
+		if (dx * dx + dy * dy + dz * dz < 0.04 * n * n)
+		    v = 200;
+		else if ((x / 4 + 3 * (y / 4) + 7 * (z / 4)) % 61 == 0 && x % 4 && y % 4 && z % 4)
+		    v = 100 + (unsigned char)(100 * BN_RANDOM(ridx));
+		data[(z * n + y) * n + x] = v;
+	    }
+	}
+    }
+    mk_binunif(wdbp, "vol.bin", data, WDB_BINUNIF_UINT8, (long)(n * n * n));
+    bu_free(data, "volume");
+    mk_vol(wdbp, "vol.s", RT_VOL_SRC_OBJ, "vol.bin", n, n, n, 50, 255, cellsize, mat);
+
+    data = (unsigned char *)bu_calloc(bn * bn, 1, "bitmap");
+    for (y = 0; y < bn; y++) {
+	for (x = 0; x < bn; x++) {
+	    fastf_t dx = x - 0.7 * bn;
+	    fastf_t dy = y - 0.4 * bn;
+	    if (dx * dx + dy * dy < 0.01 * bn * bn || (x / 8 + 5 * (y / 8)) % 53 == 0)
+		data[y * bn + x] = 1;
+	}
+    }
+    mk_binunif(wdbp, "ebm.bin", data, WDB_BINUNIF_UINT8, (long)(bn * bn));
+    bu_free(data, "bitmap");
+
+    /* mk_ebm() only knows about files */
+    BU_ALLOC(ebm, struct rt_ebm_internal);
+    ebm->magic = RT_EBM_INTERNAL_MAGIC;
+    bu_strlcpy(ebm->name, "ebm.bin", RT_EBM_NAME_LEN);
+    ebm->xdim = bn;
+    ebm->ydim = bn;
+    ebm->tallness = 10;
+    ebm->datasrc = RT_EBM_SRC_OBJ;
+    MAT_COPY(ebm->mat, mat);
+    wdb_export(wdbp, "ebm.s", (void *)ebm, ID_EBM, mk_conv2mm);
+}
+
+/* Pseudo-random rays from outside the bounding sphere, aimed into the
+ * bounding box */
+static void
+voxel_rays(struct soltab *stp, struct xray *rays, int nrays)
+{
+    int ridx = 0;
+
+    for (int i = 0; i < nrays; i++) {
+	vect_t dir, tgt;
+	do {
+	    VSET(dir, BN_RANDOM(ridx) - 0.5, BN_RANDOM(ridx) - 0.5, BN_RANDOM(ridx) - 0.5);
+	} while (MAGSQ(dir) < SMALL_FASTF);
+	VUNITIZE(dir);
+	VJOIN1(rays[i].r_pt, stp->st_center, 2 * stp->st_aradius + 1, dir);
+	VSET(tgt,
+	     stp->st_min[X] + BN_RANDOM(ridx) * (stp->st_max[X] - stp->st_min[X]),
+	     stp->st_min[Y] + BN_RANDOM(ridx) * (stp->st_max[Y] - stp->st_min[Y]),
+	     stp->st_min[Z] + BN_RANDOM(ridx) * (stp->st_max[Z] - stp->st_min[Z]));
+	VSUB2(rays[i].r_dir, tgt, rays[i].r_pt);
+	/* some rays along the axes, which the walks special case */
+	if (i % 8 == 0)
+	    rays[i].r_dir[i / 8 % 3] = 0;
+	if (MAGSQ(rays[i].r_dir) < SMALL_FASTF)
+	    VREVERSE(rays[i].r_dir, dir);
+	VUNITIZE(rays[i].r_dir);
+	rays[i].magic = RT_RAY_MAGIC;
+	rays[i].index = i;
+	rays[i].r_min = 0;
+	rays[i].r_max = INFINITY;
+    }
+}
+
+/* Shoot all the rays, keeping the segments of each */
+static fastf_t
+voxel_shoot(struct soltab *stp, struct application *ap, struct xray *rays, struct seg *segs, int nrays)
+{
+    int64_t start = bu_gettime();
+    for (int i = 0; i < nrays; i++) {
+	BU_LIST_INIT(&segs[i].l);
+	(void)stp->st_meth->ft_shot(stp, &rays[i], ap, &segs[i]);
+    }
+    return (bu_gettime() - start) / 1000.0;
+}
+
+static int
+voxel_cmp(struct soltab *stp, struct application *ap, struct xray *rays, struct seg *ref, struct seg *segs, int nrays)
+{
+    fastf_t tol = ap->a_rt_i->rti_tol.dist;
+    int fails = 0;
+
+    for (int i = 0; i < nrays; i++) {
+	struct seg *rp = BU_LIST_FIRST(seg, &ref[i].l);
+	struct seg *sp = BU_LIST_FIRST(seg, &segs[i].l);
+	int match = 1;
+
+	while (BU_LIST_NOT_HEAD(rp, &ref[i].l) && BU_LIST_NOT_HEAD(sp, &segs[i].l)) {
+	    if (fabs(rp->seg_in.hit_dist - sp->seg_in.hit_dist) > tol ||
+		fabs(rp->seg_out.hit_dist - sp->seg_out.hit_dist) > tol ||
+		rp->seg_in.hit_surfno != sp->seg_in.hit_surfno ||
+		rp->seg_out.hit_surfno != sp->seg_out.hit_surfno)
+		match = 0;
+	    rp = BU_LIST_PNEXT(seg, rp);
+	    sp = BU_LIST_PNEXT(seg, sp);
+	}
+	if (BU_LIST_NOT_HEAD(rp, &ref[i].l) || BU_LIST_NOT_HEAD(sp, &segs[i].l))
+	    match = 0;
+
+	if (!match) {
+	    fails++;
+	    bu_log("%s: ray %d segments differ\n", stp->st_dp->d_namep, i);
+	    VPRINT("  pt ", rays[i].r_pt);
+	    VPRINT("  dir", rays[i].r_dir);
+	}
+	RT_FREE_SEG_LIST(&ref[i], ap->a_resource);
+	RT_FREE_SEG_LIST(&segs[i], ap->a_resource);
+    }
+
+    return fails;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct rt_i *rtip[2];
+    struct application ap;
+    const char *names[] = {"vol.s", "ebm.s"};
+    int nnames = sizeof(names) / sizeof(names[0]);
+    int ncells = 256;
+    int nrays = 20000;
+    int fails = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc > 3)
+	bu_exit(1, "Usage: %s [volume_size [ray_count]]\n", argv[0]);
+    if (argc > 1 && (sscanf(argv[1], "%d", &ncells) != 1 || ncells < 1))
+	bu_exit(1, "ERROR: invalid volume size %s\n", argv[1]);
+    if (argc > 2 && (sscanf(argv[2], "%d", &nrays) != 1 || nrays < 1))
+	bu_exit(1, "ERROR: invalid ray count %s\n", argv[2]);
+
+    dbip = db_open_inmem();
+    if (dbip == DBI_NULL)
+	bu_exit(1, "ERROR: unable to create in-memory database\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+    voxel_mk(wdbp, (size_t)ncells);
+
+    /* the dense walks, then the brick maps */
+    for (int i = 0; i < 2; i++) {
+	bu_setenv("LIBRT_VOXEL_BRICKS", (i) ? "1" : "0", 1);
+	rtip[i] = rt_new_rti(dbip);
+	if (rt_gettrees(rtip[i], nnames, names, 1) < 0)
+	    bu_exit(1, "ERROR: rt_gettrees failed\n");
+	int64_t start = bu_gettime();
+	rt_prep(rtip[i]);
+	bu_log("%s prep: %.3f ms\n", (i) ? "brick" : "dense", (bu_gettime() - start) / 1000.0);
+    }
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_resource = &rt_uniresource;
+
+    struct xray *rays = (struct xray *)bu_calloc(nrays, sizeof(struct xray), "rays");
+    struct seg *ref = (struct seg *)bu_calloc(nrays, sizeof(struct seg), "ref segs");
+    struct seg *segs = (struct seg *)bu_calloc(nrays, sizeof(struct seg), "segs");
+
+    for (int n = 0; n < nnames; n++) {
+	struct soltab *dense = rt_find_solid(rtip[0], names[n]);
+	struct soltab *brick = rt_find_solid(rtip[1], names[n]);
+	if (!dense || !brick) {
+	    bu_log("ERROR: %s was not prepped\n", names[n]);
+	    fails++;
+	    continue;
+	}
+
+	voxel_rays(dense, rays, nrays);
+	ap.a_rt_i = rtip[0];
+	fastf_t t_dense = voxel_shoot(dense, &ap, rays, ref, nrays);
+	ap.a_rt_i = rtip[1];
+	fastf_t t_brick = voxel_shoot(brick, &ap, rays, segs, nrays);
+
+	int sfails = voxel_cmp(brick, &ap, rays, ref, segs, nrays);
+	bu_log("%-6s: %d rays, dense %8.3f ms, brick %8.3f ms (%.1fx), %d differ\n",
+	       names[n], nrays, t_dense, t_brick, (t_brick > 0) ? t_dense / t_brick : 0.0, sfails);
+	fails += sfails;
+    }
+
+    bu_free(rays, "rays");
+    bu_free(ref, "ref segs");
+    bu_free(segs, "segs");
+    rt_free_rti(rtip[0]);
+    rt_free_rti(rtip[1]);
+    wdb_close(wdbp);
+
+    /* Timing is reported, but too machine dependent to test */
+    return (fails) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
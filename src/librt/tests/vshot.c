@@ -0,0 +1,269 @@
+/*                         V S H O T . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/* Cross check the vector (ft_vshot) intersectors against the scalar
+ * (ft_shot) versions.  Each primitive with a vshot method is shot with
+ * pseudo-random rays aimed through its bounding box, one batch at a time,
+ * and the segment returned by vshot for each ray must match one of the
+ * segments returned by shot.  The optional argument is the number of rays
+ * to fire at each primitive.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/app.h"
+#include "bu/malloc.h"
+#include "bn.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#define VSHOT_BATCH 64
+
+static int
+vshot_dist_eq(fastf_t a, fastf_t b, fastf_t tol)
+{
+    if (isinf(a) || isinf(b))
+	return (EQUAL(a, b)) ? 1 : 0;
+    return (fabs(a - b) <= tol * (1.0 + fabs(a))) ? 1 : 0;
+}
+
+static void
+vshot_mk(struct rt_wdb *wdbp)
+{
+    point_t v;
+    vect_t a, b, c, d, h;
+    fastf_t pts8[24] = {
+	0, 0, 0,  10, 0, 0,  10, 20, 0,  0, 20, 0,
+	0, 0, 30,  10, 0, 30,  10, 20, 25,  0, 20, 25
+    };
+    plane_t eqn[7] = {
+	{1, 0, 0, 10}, {-1, 0, 0, 10},
+	{0, 1, 0, 12}, {0, -1, 0, 12},
+	{0, 0, 1, 8}, {0, 0, -1, 8},
+	{M_SQRT1_2, M_SQRT1_2, 0, 12}
+    };
+
+    mk_arb8(wdbp, "arb8.s", pts8);
+    mk_arbn(wdbp, "arbn.s", 7, (const plane_t *)eqn);
+
+    VSET(v, 1, 2, 3);
+    VSET(a, 10, 0, 0);
+    VSET(b, 0, 5, 0);
+    VSET(c, 0, 0, 3);
+    mk_ell(wdbp, "ell.s", v, a, b, c);
+    mk_sph(wdbp, "sph.s", v, 7);
+
+    VSET(h, 0, 0, 20);
+    mk_rcc(wdbp, "rec.s", v, h, 4);
+    VSET(a, 6, 0, 0);
+    VSET(b, 0, 3, 0);
+    VSET(c, 3, 0, 0);
+    VSET(d, 0, 1.5, 0);
+    mk_tgc(wdbp, "tgc.s", v, h, a, b, c, d);
+
+    VSET(h, 0, 0, 1);
+    mk_tor(wdbp, "tor.s", v, h, 10, 3);
+
+    VSET(h, 0, 0, 1);
+    mk_half(wdbp, "half.s", h, 2);
+
+    VSET(a, 1, 0, 0);
+    VSET(b, 0, 1, 0);
+    VSET(c, 0, 0, 1);
+    mk_hrt(wdbp, "hrt.s", v, a, b, c, 1);
+
+    VSET(h, 0, 0, 15);
+    VSET(b, 0, 8, 0);
+    mk_rpc(wdbp, "rpc.s", v, h, b, 4);
+    mk_rhc(wdbp, "rhc.s", v, h, b, 4, 2);
+
+    VSET(a, 1, 0, 0);
+    mk_epa(wdbp, "epa.s", v, h, a, 8, 5);
+    mk_ehy(wdbp, "ehy.s", v, h, a, 8, 5, 3);
+}
+
+/* Returns the number of rays where vshot and shot disagree */
+static int
+vshot_check(struct soltab *stp, struct application *ap, int nrays, int *ridx)
+{
+    struct soltab *stps[VSHOT_BATCH];
+    struct xray rays[VSHOT_BATCH];
+    struct xray *rps[VSHOT_BATCH];
+    struct seg segs[VSHOT_BATCH];
+    fastf_t tol = ap->a_rt_i->rti_tol.dist;
+    int fails = 0;
+    point_t center;
+    fastf_t radius;
+
+    /* Rays start outside the bounding sphere (half spaces have huge
+     * bounds, so keep to a reasonable neighborhood for them) */
+    VMOVE(center, stp->st_center);
+    radius = (stp->st_aradius < 1000) ? 2 * stp->st_aradius + 1 : 100;
+
+    for (int done = 0; done < nrays; done += VSHOT_BATCH) {
+	int n = (nrays - done < VSHOT_BATCH) ? nrays - done : VSHOT_BATCH;
+
+	for (int i = 0; i < n; i++) {
+	    vect_t dir, tgt;
+	    do {
+		VSET(dir, BN_RANDOM(*ridx) - 0.5, BN_RANDOM(*ridx) - 0.5, BN_RANDOM(*ridx) - 0.5);
+	    } while (MAGSQ(dir) < SMALL_FASTF);
+	    VUNITIZE(dir);
+	    VJOIN1(rays[i].r_pt, center, radius, dir);
+	    /* aim somewhere within the bounding box */
+	    VSET(tgt,
+		 stp->st_min[X] + BN_RANDOM(*ridx) * (stp->st_max[X] - stp->st_min[X]),
+		 stp->st_min[Y] + BN_RANDOM(*ridx) * (stp->st_max[Y] - stp->st_min[Y]),
+		 stp->st_min[Z] + BN_RANDOM(*ridx) * (stp->st_max[Z] - stp->st_min[Z]));
+	    if (stp->st_aradius >= 1000)
+		VSET(tgt, center[X] + 20 * (BN_RANDOM(*ridx) - 0.5), center[Y] + 20 * (BN_RANDOM(*ridx) - 0.5), center[Z]);
+	    VSUB2(rays[i].r_dir, tgt, rays[i].r_pt);
+	    if (MAGSQ(rays[i].r_dir) < SMALL_FASTF)
+		VREVERSE(rays[i].r_dir, dir);
+	    VUNITIZE(rays[i].r_dir);
+	    rays[i].magic = RT_RAY_MAGIC;
+	    rays[i].index = done + i;
+	    rays[i].r_min = 0;
+	    rays[i].r_max = INFINITY;
+	    stps[i] = stp;
+	    rps[i] = &rays[i];
+	    memset(&segs[i], 0, sizeof(struct seg));
+	    BU_LIST_INIT(&segs[i].l);
+	}
+
+	stp->st_meth->ft_vshot(stps, rps, segs, n, ap);
+
+	for (int i = 0; i < n; i++) {
+	    struct seg seghead;
+	    struct seg *sp;
+	    int match = 0;
+	    fastf_t thick = 0;
+
+	    BU_LIST_INIT(&seghead.l);
+	    int ret = stp->st_meth->ft_shot(stp, &rays[i], ap, &seghead);
+	    if (ret > 0) {
+		for (BU_LIST_FOR(sp, seg, &seghead.l)) {
+		    if (sp->seg_out.hit_dist - sp->seg_in.hit_dist > thick)
+			thick = sp->seg_out.hit_dist - sp->seg_in.hit_dist;
+		    if (segs[i].seg_stp &&
+			vshot_dist_eq(sp->seg_in.hit_dist, segs[i].seg_in.hit_dist, tol) &&
+			vshot_dist_eq(sp->seg_out.hit_dist, segs[i].seg_out.hit_dist, tol))
+			match = 1;
+		}
+	    } else if (!segs[i].seg_stp) {
+		match = 1;
+	    } else {
+		thick = segs[i].seg_out.hit_dist - segs[i].seg_in.hit_dist;
+	    }
+
+	    /* Grazing hits may legitimately be found by one method and not
+	     * the other */
+	    if (!match && (ret > 0) != (segs[i].seg_stp != NULL) && thick < 10 * tol)
+		match = 1;
+
+	    if (!match) {
+		fails++;
+		bu_log("%s: ray %d mismatch - shot %s, vshot %s [%g, %g]\n",
+		       stp->st_dp->d_namep, rays[i].index,
+		       (ret > 0) ? "hit" : "miss",
+		       (segs[i].seg_stp) ? "hit" : "miss",
+		       segs[i].seg_in.hit_dist, segs[i].seg_out.hit_dist);
+		VPRINT("  pt ", rays[i].r_pt);
+		VPRINT("  dir", rays[i].r_dir);
+	    }
+
+	    RT_FREE_SEG_LIST(&seghead, ap->a_resource);
+	}
+    }
+
+    return fails;
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct db_i *dbip;
+    struct rt_wdb *wdbp;
+    struct rt_i *rtip;
+    struct application ap;
+    struct soltab *stp;
+    const char *names[] = {"arb8.s", "arbn.s", "ell.s", "sph.s", "rec.s", "tgc.s", "tor.s", "half.s", "hrt.s", "rpc.s", "rhc.s", "epa.s", "ehy.s"};
+    int nnames = sizeof(names) / sizeof(names[0]);
+    int nrays = 10000;
+    int ridx = 0;
+    int fails = 0;
+    int checked = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc > 2)
+	bu_exit(1, "Usage: %s [rays_per_primitive]\n", argv[0]);
+    if (argc == 2 && (sscanf(argv[1], "%d", &nrays) != 1 || nrays < 1))
+	bu_exit(1, "ERROR: invalid ray count %s\n", argv[1]);
+
+    dbip = db_open_inmem();
+    if (dbip == DBI_NULL)
+	bu_exit(1, "ERROR: unable to create in-memory database\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+    vshot_mk(wdbp);
+
+    rtip = rt_new_rti(dbip);
+    if (rt_gettrees(rtip, nnames, names, 1) < 0)
+	bu_exit(1, "ERROR: rt_gettrees failed\n");
+    rt_prep(rtip);
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+
+    RT_VISIT_ALL_SOLTABS_START(stp, rtip) {
+	if (!stp->st_meth->ft_vshot || !stp->st_meth->ft_shot)
+	    continue;
+	int sfails = vshot_check(stp, &ap, nrays, &ridx);
+	bu_log("%-8s (%s): %d of %d rays mismatched\n", stp->st_dp->d_namep, stp->st_meth->ft_label, sfails, nrays);
+	fails += sfails;
+	checked++;
+    } RT_VISIT_ALL_SOLTABS_END
+
+    if (checked != nnames) {
+	bu_log("ERROR: checked %d primitives, expected %d\n", checked, nnames);
+	fails++;
+    }
+
+    rt_free_rti(rtip);
+    wdb_close(wdbp);
+
+    return (fails) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
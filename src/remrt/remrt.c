@@ -100,8 +100,10 @@ extern int gettimeofday(struct timeval *, void *);
 #define REMRT_TCP_DEFAULT_PORT 4446
 
 #define TARDY_SERVER_INTERVAL	(900*60)	/* max seconds of silence */
-#define N_SERVER_ASSIGNMENTS	1		/* desired # of assignments */
+#define N_SERVER_ASSIGNMENTS	2		/* desired # of assignments */
 #define MIN_ASSIGNMENT_TIME	5		/* desired seconds/result */
+#define MIN_ELAPSED_TIME	0.02		/* shortest believable result time */
+#define REISSUE_MARGIN		1.5		/* straggler must be this much slower */
 #define SERVER_CHECK_INTERVAL	(10*60)		/* seconds */
 #ifndef RSH
 #  define RSH "/usr/ucb/rsh"
@@ -130,7 +132,9 @@ extern int gettimeofday(struct timeval *, void *);
  *	NEW		VERSOK		ph_version pkg rcvd.
  *					Optionally send loglvl & "cd" cmds.
  *	VERSOK		DOING_DIRBUILD	MSG_DIRBUILD sent
- *	DOING_DIRBUILD	READY		MSG_DIRBUILD_REPLY rcvd
+ *	DOING_DIRBUILD	NEED_TREE	MSG_DIRBUILD_REPLY rcvd
+ *	NEED_TREE	DOING_GETTREES	a frame is queued:  send_matrix(),
+ *					send_gettrees(), before any work.
  *
  * --	READY		DOING_GETTREES	new frame:  send_gettrees(), send_matrix()
  *	DOING_GETTREES	READY		MSG_GETTREES_REPLY rcvd
@@ -240,12 +244,16 @@ struct timeval last_server_check_time;
 /*
  * Macros to manage lists of pixel spans.
  * The span is inclusive, from start up to and including stop.
+ * li_done marks an assignment whose pixels are no longer wanted,
+ * because another server finished the same span first or the frame
+ * has been destroyed; the reply is still expected, and is discarded.
  */
 struct list {
     struct bu_list l;
     struct frame *li_frame;
     int li_start;
     int li_stop;
+    int li_done;
 };
 
 
@@ -257,9 +265,11 @@ struct bu_list FreeList;
 #define GET_LIST(p) if (BU_LIST_IS_EMPTY(&FreeList)) { \
 	BU_ALLOC((p), struct list); \
 	(p)->l.magic = LIST_MAGIC; \
+	(p)->li_done = 0; \
     } else { \
 	(p) = BU_LIST_FIRST(list, &FreeList); \
 	BU_LIST_DEQUEUE(&(p)->l); \
+	(p)->li_done = 0; \
     }
 
 #define FREE_LIST(p) { BU_LIST_APPEND(&FreeList, &(p)->l); }
@@ -463,6 +473,29 @@ remrt_log(const char *msg)
 }
 
 
+/*
+ * Find a live copy of an assignment on some server other than 'sp',
+ * as made when a straggling assignment is re-issued.
+ */
+static struct list *
+other_copy(struct servers *sp, struct list *lp)
+{
+    struct servers *csp;
+    struct list *lp2;
+
+    for (csp = &servers[0]; csp < &servers[MAXSERVERS]; csp++) {
+	if (csp == sp || csp->sr_pc == PKC_NULL) continue;
+	if (csp->sr_state == SRST_CLOSING) continue;
+	for (BU_LIST_FOR(lp2, list, &csp->sr_work)) {
+	    if (lp2->li_done || lp2->li_frame != lp->li_frame) continue;
+	    if (lp2->li_start == lp->li_start && lp2->li_stop == lp->li_stop)
+		return lp2;
+	}
+    }
+    return LIST_NULL;
+}
+
+
 /*
  * Note that final connection closeout is handled in schedule(),
  * to prevent recursion problems.
@@ -506,13 +539,19 @@ drop_server(struct servers *sp, char *why)
     }
     FD_CLR(sp->sr_pc->pkc_fd, &clients);
 
-    if (oldstate != SRST_READY && oldstate != SRST_NEED_TREE) return;
+    if (oldstate != SRST_READY && oldstate != SRST_NEED_TREE &&
+	oldstate != SRST_DOING_GETTREES) return;
 
     /* Need to requeue any work that was in progress */
     while (BU_LIST_WHILE(lp, list, &sp->sr_work)) {
+	BU_LIST_DEQUEUE(&lp->l);
+	if (lp->li_done || other_copy(sp, lp) != LIST_NULL) {
+	    /* Finished already, or still being done elsewhere */
+	    FREE_LIST(lp);
+	    continue;
+	}
 	fr = lp->li_frame;
 	CHECK_FRAME(fr);
-	BU_LIST_DEQUEUE(&lp->l);
 	bu_log("%s requeueing fr%ld %d..%d\n",
 	       stamp(),
 	       fr->fr_number,
@@ -1159,7 +1198,7 @@ destroy_frame(struct frame *fr)
 
     /*
      * Need to remove any pending work.
-     * What about work already assigned that will dribble in?
+     * Work already assigned will dribble in, see below.
      */
     while (BU_LIST_WHILE(lp, list, &fr->fr_todo)) {
 	BU_LIST_DEQUEUE(&lp->l);
@@ -1175,6 +1214,12 @@ destroy_frame(struct frame *fr)
 	if (sp->sr_curframe == fr) {
 	    sp->sr_curframe = FRAME_NULL;
 	}
+	/* Replies to work already assigned will be discarded */
+	for (BU_LIST_FOR(lp, list, &sp->sr_work)) {
+	    if (lp->li_frame != fr) continue;
+	    lp->li_frame = FRAME_NULL;
+	    lp->li_done = 1;
+	}
     }
     DEQUEUE_FRAME(fr);
     FREE_FRAME(fr);
@@ -1285,12 +1330,14 @@ pr_list(struct bu_list *lhp)
 
     for (BU_LIST_FOR(lp, list, lhp)) {
 	if (lp->li_frame == 0) {
-	    bu_log("\t%d..%d frame *NULL*??\n",
-		   lp->li_start, lp->li_stop);
+	    bu_log("\t%d..%d frame *NULL*%s\n",
+		   lp->li_start, lp->li_stop,
+		   lp->li_done ? " (discarded)" : "??");
 	} else {
-	    bu_log("\t%d..%d frame %ld\n",
+	    bu_log("\t%d..%d frame %ld%s\n",
 		   lp->li_start, lp->li_stop,
-		   lp->li_frame->fr_number);
+		   lp->li_frame->fr_number,
+		   lp->li_done ? " (done elsewhere)" : "");
 	}
     }
 }
@@ -1394,13 +1441,16 @@ static int
 all_servers_idle(void)
 {
     struct servers *sp;
+    struct list *lp;
 
     for (sp = &servers[0]; sp < &servers[MAXSERVERS]; sp++) {
 	if (sp->sr_pc == PKC_NULL) continue;
 	if (sp->sr_state != SRST_READY &&
 	    sp->sr_state != SRST_NEED_TREE) continue;
-	if (BU_LIST_IS_EMPTY(&sp->sr_work)) continue;
-	return 0;		/* nope, still more work */
+	for (BU_LIST_FOR(lp, list, &sp->sr_work)) {
+	    if (lp->li_done) continue;
+	    return 0;		/* nope, still more work */
+	}
     }
     return 1;			/* All done */
 }
@@ -1490,7 +1540,7 @@ this_frame_done(struct frame *fr)
     for (sp = &servers[0]; sp < &servers[MAXSERVERS]; sp++) {
 	if (sp->sr_pc == PKC_NULL) continue;
 	for (BU_LIST_FOR(lp, list, &sp->sr_work)) {
-	    if (fr != lp->li_frame) continue;
+	    if (fr != lp->li_frame || lp->li_done) continue;
 	    return 0;		/* nope, still more work */
 	}
     }
@@ -1594,7 +1644,13 @@ send_do_lines(struct servers *sp, int start, int stop, int framenum)
     if (pkg_send(MSG_LINES, obuf, strlen(obuf)+1, sp->sr_pc) < 0)
 	drop_server(sp, "MSG_LINES pkg_send error");
 
-    (void)gettimeofday(&sp->sr_sendtime, (struct timezone *)0);
+    /*
+     * Only start the clock when the server was idle.  Otherwise this
+     * assignment waits behind the others, and ph_pixels() restarts
+     * the clock as each of those comes back.
+     */
+    if (server_q_len(sp) <= 1)
+	(void)gettimeofday(&sp->sr_sendtime, (struct timezone *)0);
 }
 
 
@@ -1727,11 +1783,47 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
     if (maxlump < 1) maxlump = 1;
     maxlump *= fr->fr_width;
     if (lump > maxlump) lump=maxlump;
+
+    /*
+     * As the frame runs out of unassigned work, shrink the
+     * assignments so that the tail of the frame is spread over all
+     * the servers, rather than waiting on one big last assignment.
+     */
+    if (work_allocate_method != OPT_MOVIE) {
+	int nready = number_of_ready_servers();
+	int left = 0;
+
+	for (BU_LIST_FOR(lp, list, &fr->fr_todo))
+	    left += lp->li_stop - lp->li_start + 1;
+	if (nready > 0 && lump > left / (2*nready))
+	    lump = left / (2*nready);
+
+	/* Near the end of the frame left can be less than 2*nready */
+	if (fr->fr_width > REMRT_MAX_PIXELS) {
+	    if (lump < 32) lump = 32;
+	} else if (lump < fr->fr_width) {
+	    lump = fr->fr_width;
+	}
+    }
+
+    /* Assign whole scanlines, so that each assignment is a band */
+    if (fr->fr_width <= REMRT_MAX_PIXELS) {
+	int rows = (lump + fr->fr_width/2) / fr->fr_width;
+	if (rows > REMRT_MAX_PIXELS / fr->fr_width)
+	    rows = REMRT_MAX_PIXELS / fr->fr_width;
+	if (rows < 1) rows = 1;
+	lump = rows * fr->fr_width;
+    }
     sp->sr_lump = lump;
 
     lp = BU_LIST_FIRST(list, &fr->fr_todo);
     a = lp->li_start;
     b = a+sp->sr_lump-1;	/* work increment */
+    /* Partial spans from an earlier run are realigned here */
+    if ((b+1) % fr->fr_width && b - (b+1) % fr->fr_width >= a) {
+	b -= (b+1) % fr->fr_width;
+	sp->sr_lump = b-a+1;
+    }
     if (b >= lp->li_stop) {
 	b = lp->li_stop;
 	sp->sr_lump = b-a+1;	/* Indicate short assignment */
@@ -1756,6 +1848,106 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
 }
 
 
+/*
+ * Estimate how many seconds remain until a server sends back the
+ * given assignment, from the pixels queued ahead of it, the server's
+ * weighted pixel rate, and the time spent on the current assignment.
+ * A server that is already overdue is assumed to need as long again.
+ */
+static double
+time_to_finish(struct servers *sp, struct list *target, struct timeval *nowp)
+{
+    struct list *lp;
+    double npix = 0;
+    double el;
+    double t;
+
+    for (BU_LIST_FOR(lp, list, &sp->sr_work)) {
+	npix += lp->li_stop - lp->li_start + 1;
+	if (lp == target) break;
+    }
+    el = tvdiff(nowp, &sp->sr_sendtime);
+    if (sp->sr_w_elapsed < MIN_ELAPSED_TIME)
+	return el;
+    t = npix / sp->sr_w_elapsed - el;
+    if (t < 0)
+	return el;
+    return t;
+}
+
+
+/*
+ * Once a frame has no unassigned work left, its last assignments can
+ * keep the whole frame waiting on one slow or stuck server.  Give
+ * each idle server a copy of the outstanding assignment with the
+ * longest expected wait, provided the idle server would finish it
+ * REISSUE_MARGIN times sooner than its owner.  Whichever reply comes
+ * back first is kept, see ph_pixels().
+ */
+static void
+reissue_stragglers(struct timeval *nowp)
+{
+    struct servers *sp;
+    struct servers *csp;
+    struct list *lp;
+    struct list *best;
+    struct servers *best_sp;
+    struct frame *fr;
+    double best_t;
+    double t;
+
+    for (sp = &servers[0]; sp < &servers[MAXSERVERS]; sp++) {
+	if (sp->sr_pc == PKC_NULL) continue;
+	if (sp->sr_state != SRST_READY) continue;
+	if (BU_LIST_NON_EMPTY(&sp->sr_work)) continue;
+	if (sp->sr_w_elapsed < MIN_ELAPSED_TIME) continue;
+
+	best = LIST_NULL;
+	best_sp = SERVERS_NULL;
+	best_t = 0;
+	for (csp = &servers[0]; csp < &servers[MAXSERVERS]; csp++) {
+	    if (csp == sp || csp->sr_pc == PKC_NULL) continue;
+	    if (csp->sr_state != SRST_READY) continue;
+	    for (BU_LIST_FOR(lp, list, &csp->sr_work)) {
+		if (lp->li_done || lp->li_frame == FRAME_NULL) continue;
+		if (BU_LIST_NON_EMPTY(&lp->li_frame->fr_todo)) continue;
+		if (other_copy(csp, lp) != LIST_NULL) continue;
+		t = time_to_finish(csp, lp, nowp);
+		if (t < REISSUE_MARGIN * (lp->li_stop - lp->li_start + 1) /
+		    sp->sr_w_elapsed)
+		    continue;
+		if (t > best_t) {
+		    best = lp;
+		    best_sp = csp;
+		    best_t = t;
+		}
+	    }
+	}
+	if (best == LIST_NULL) continue;
+
+	fr = best->li_frame;
+	CHECK_FRAME(fr);
+	if (sp->sr_curframe != fr) {
+	    /* Not worth loading new geometry for */
+	    if (fr->fr_needgettree) continue;
+	    sp->sr_curframe = fr;
+	    send_matrix(sp, fr);
+	    if (sp->sr_pc == PKC_NULL) continue;
+	}
+
+	GET_LIST(lp);
+	lp->li_frame = fr;
+	lp->li_start = best->li_start;
+	lp->li_stop = best->li_stop;
+	BU_LIST_INSERT(&sp->sr_work, &lp->l);
+	bu_log("%s re-issuing fr%ld %d..%d from %s to %s (%g sec left)\n",
+	       stamp(), fr->fr_number, lp->li_start, lp->li_stop,
+	       best_sp->sr_host->ht_name, sp->sr_host->ht_name, best_t);
+	send_do_lines(sp, lp->li_start, lp->li_stop, fr->fr_number);
+    }
+}
+
+
 /*
  * This routine is called by the main loop, after each batch of PKGs
  * have arrived.
@@ -1806,6 +1998,33 @@ schedule(struct timeval *nowp)
 		    send_dirbuild(sp);
 		break;
 
+	    case SRST_NEED_TREE:
+		/*
+		 * Have the server prep the geometry as soon as there
+		 * is a frame for it, rather than on its first
+		 * assignment, so the prep overlaps with the other
+		 * servers starting up and with any "go" delay.
+		 * In movie mode, pick a frame no one else has.
+		 */
+		for (fr = FrameHead.fr_forw; fr != &FrameHead; fr = fr->fr_forw) {
+		    struct servers *csp;
+
+		    CHECK_FRAME(fr);
+		    if (work_allocate_method != OPT_MOVIE) break;
+		    for (csp = &servers[0]; csp < &servers[MAXSERVERS]; csp++) {
+			if (csp->sr_pc != PKC_NULL && csp->sr_curframe == fr) break;
+		    }
+		    if (csp >= &servers[MAXSERVERS]) break;
+		}
+		if (fr == &FrameHead) break;
+
+		sp->sr_curframe = fr;
+		send_matrix(sp, fr);
+		if (sp->sr_pc != PKC_NULL)
+		    send_gettrees(sp, fr);
+		/* Now in state SRST_DOING_GETTREES */
+		break;
+
 	    case SRST_CLOSING:
 		/* Handle final closing */
 		if (rem_debug>1) bu_log("%s Final close on %s\n", stamp(), sp->sr_host->ht_name);
@@ -1889,6 +2108,10 @@ top:
 	work_allocate_method--;
 	goto top;
     }
+
+    /* Idle servers can race the last assignments of a frame */
+    reissue_stragglers(nowp);
+
     /* No work remains to be assigned, or servers are stuffed full */
 out:
     scheduler_going = 0;
@@ -3152,6 +3375,55 @@ ph_cmd(struct pkg_conn *pc, char *buf)
 }
 
 
+/*
+ * Fold the timings of one reply into the server's statistics.
+ * Only perform weighted averages if elapsed times are reasonable.
+ */
+static void
+server_stats(struct servers *sp, int npix, struct line_info *info)
+{
+    sp->sr_l_percent = info->li_percent;
+    if (sp->sr_l_elapsed > MIN_ELAPSED_TIME) {
+	double blend1;	/* fraction of historical value to use */
+	double blend2;	/* fraction of new value to use */
+
+	if (sp->sr_w_elapsed < MIN_ELAPSED_TIME) {
+	    /*
+	     * The weighted average so far is much too small.
+	     * Ignore the historical value, and
+	     * use this sample to try and get a good initial
+	     * estimate.
+	     */
+	    blend1 = 0.1;
+	} else if (sp->sr_l_elapsed > assignment_time()) {
+	    /*
+	     * Took longer than expected, put more weight on
+	     * this sample, and less on the historical values.
+	     */
+	    blend1 = 0.5;
+	} else {
+	    /*
+	     * Took less time than expected, don't get excited.
+	     * Place more emphasis on historical values.
+	     */
+	    blend1 = 0.8;
+	}
+	blend2 = 1 - blend1;
+
+	sp->sr_l_el_rate = npix / sp->sr_l_elapsed;
+	sp->sr_w_elapsed = blend1 * sp->sr_w_elapsed +
+	    blend2 * sp->sr_l_el_rate;
+	sp->sr_w_rays = blend1 * sp->sr_w_rays +
+	    blend2 * (info->li_nrays/sp->sr_l_elapsed);
+	sp->sr_l_cpu = info->li_cpusec;
+	sp->sr_s_cpu += info->li_cpusec;
+	sp->sr_s_elapsed += sp->sr_l_el_rate;
+	sp->sr_sq_elapsed += sp->sr_l_el_rate * sp->sr_l_el_rate;
+	sp->sr_nsamp++;
+    }
+}
+
+
 /*
  * When a scanline is received from a server, file it away.
  */
@@ -3162,6 +3434,7 @@ ph_pixels(struct pkg_conn *pc, char *buf)
     struct servers *sp;
     struct frame *fr;
     struct list *lp;
+    struct list *lp2;
     struct line_info info;
     struct timeval tvnow;
     int npix;
@@ -3179,17 +3452,16 @@ ph_pixels(struct pkg_conn *pc, char *buf)
 	goto out;
     }
 
-    /* XXX Is this measuring the processing time for
-     * XXX one assignment, or for the whole pipeline of N_SERVER_ASSIGNMENTS
-     * XXX worth of assignments?  It looks like the latter.
-     */
-
     /*
+     * This measures the processing time for one assignment:
+     * send_do_lines() only starts the clock on an idle server, and
+     * with N_SERVER_ASSIGNMENTS pipelined the next assignment is
+     * started as this one is received.
+     *
      * If the elapsed time is less than MIN_ELAPSED_TIME, the package
      * was probably waiting in either the kernel's or libraries
      * input buffer.  Don't use these statistics.
      */
-#define MIN_ELAPSED_TIME 0.02
     if ((sp->sr_l_elapsed = tvdiff(&tvnow, &sp->sr_sendtime)) < MIN_ELAPSED_TIME)
 	sp->sr_l_elapsed = MIN_ELAPSED_TIME;
 
@@ -3227,6 +3499,27 @@ ph_pixels(struct pkg_conn *pc, char *buf)
      */
     lp = BU_LIST_FIRST(list, &sp->sr_work);
     fr = lp->li_frame;
+
+    if (lp->li_done) {
+	/*
+	 * Another server got these pixels in first, or the frame
+	 * is gone.  Check the reply and throw the pixels away.
+	 */
+	if ((fr != FRAME_NULL && info.li_frame != fr->fr_number) ||
+	    info.li_startpix != lp->li_start ||
+	    info.li_endpix != lp->li_stop) {
+	    bu_log("%s:  stale assignment mismatch, sent %d..%d, got %d..%d\n",
+		   sp->sr_host->ht_name,
+		   lp->li_start, lp->li_stop,
+		   info.li_startpix, info.li_endpix);
+	    drop_server(sp, "stale assignment mismatch");
+	    goto out;
+	}
+	server_stats(sp, info.li_endpix - info.li_startpix + 1, &info);
+	BU_LIST_DEQUEUE(&lp->l);
+	FREE_LIST(lp);
+	goto out;
+    }
     CHECK_FRAME(fr);
 
     if (info.li_frame != fr->fr_number) {
@@ -3304,52 +3597,16 @@ ph_pixels(struct pkg_conn *pc, char *buf)
 
     /*
      * Stash the statistics that came back.
-     * Only perform weighted averages if elapsed times are reasonable.
      */
     fr->fr_nrays += info.li_nrays;
     fr->fr_cpu += info.li_cpusec;
-    sp->sr_l_percent = info.li_percent;
-    if (sp->sr_l_elapsed > MIN_ELAPSED_TIME) {
-	double blend1;	/* fraction of historical value to use */
-	double blend2;	/* fraction of new value to use */
-
-	if (sp->sr_w_elapsed < MIN_ELAPSED_TIME) {
-	    /*
-	     * The weighted average so far is much too small.
-	     * Ignore the historical value, and
-	     * use this sample to try and get a good initial
-	     * estimate.
-	     */
-	    blend1 = 0.1;
-	} else if (sp->sr_l_elapsed > assignment_time()) {
-	    /*
-	     * Took longer than expected, put more weight on
-	     * this sample, and less on the historical values.
-	     */
-	    blend1 = 0.5;
-	} else {
-	    /*
-	     * Took less time than expected, don't get excited.
-	     * Place more emphasis on historical values.
-	     */
-	    blend1 = 0.8;
-	}
-	blend2 = 1 - blend1;
-
-	sp->sr_l_el_rate = npix / sp->sr_l_elapsed;
-	sp->sr_w_elapsed = blend1 * sp->sr_w_elapsed +
-	    blend2 * sp->sr_l_el_rate;
-	sp->sr_w_rays = blend1 * sp->sr_w_rays +
-	    blend2 * (info.li_nrays/sp->sr_l_elapsed);
-	sp->sr_l_cpu = info.li_cpusec;
-	sp->sr_s_cpu += info.li_cpusec;
-	sp->sr_s_elapsed += sp->sr_l_el_rate;
-	sp->sr_sq_elapsed += sp->sr_l_el_rate * sp->sr_l_el_rate;
-	sp->sr_nsamp++;
-    }
+    server_stats(sp, npix, &info);
 
-    /* Remove from work list */
-    list_remove(&(sp->sr_work), info.li_startpix, info.li_endpix);
+    /* Remove from work list, and retire any re-issued copy */
+    BU_LIST_DEQUEUE(&lp->l);
+    while ((lp2 = other_copy(sp, lp)) != LIST_NULL)
+	lp2->li_done = 1;
+    FREE_LIST(lp);
 
 /*
  * Check to see if this host is load limited.  If the host is loaded
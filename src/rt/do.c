@@ -1093,6 +1093,9 @@ do_frame(int framenumber)
 	    full_incr_sample++) {
 	    if (full_incr_sample > 1) /* first sample was already initialized */
 		view_2init(&APP, framename);
+	    /* progressive rendering may have stopped early */
+	    if (full_incr_sample > full_incr_nsamples)
+		break;
 	    do_run(pix_start, pix_end);
 	}
     }
@@ -170,6 +170,12 @@ extern void do_ae(double azim, double elev);
 extern int old_way(FILE *fp);
 extern int do_frame(int framenumber);
 
+/*** worker.c ***/
+extern int (*view_flush)(int final);	/* writes out finished output, set by the view module */
+extern int view_flush_async;		/* !0 while view_flush runs in its own thread */
+extern void (*view_drain)(int cpu);	/* finishes pixels a CPU deferred, set by the view module */
+extern unsigned char *pixel_converged;	/* progressive mode, !0 for pixels not to shoot again */
+
 #ifdef USE_OPENCL
 enum {
     CLT_COLOR = (1<<0),
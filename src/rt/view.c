@@ -54,6 +54,8 @@
 #include "icv.h"
 #include "raytrace.h"
 #include "bu/cv.h"
+#include "bu/sort.h"
+#include "bu/time.h"
 #include "dm.h"
 #include "bv/plot3.h"
 #include "photonmap.h"
@@ -87,6 +89,23 @@ const char title[] = "The BRL-CAD Raytracer RT";
 
 static struct scanline* scanline = NULL;
 static fastf_t* psum_buffer;            /* Buffer that keeps partial sums for multi-samples modes */
+
+/* Finished scanlines waiting to be written, in the order they finished */
+static int *rows_ready = NULL;
+static size_t rows_nready = 0;
+static size_t rows_nwritten = 0;
+static int row_xmin = 0;		/* first and last pixel of a row */
+static int row_xmax = 0;
+
+/* Each thread counts the pixels it stores on a scanline, and only
+ * settles up with scanline[].sl_left when it moves on */
+struct view_run {
+    int y;
+    int n;
+    int buf_y;			/* scanline buf is the buffer of */
+    unsigned char *buf;
+};
+static struct view_run view_runs[MAX_PSW];
 static size_t pwidth = 0;		/* Width of each pixel (in bytes) */
 struct mfuncs *mfHead = MF_NULL;	/* Head of list of shaders */
 
@@ -125,6 +144,96 @@ int ambSlow = 0;
 int ambSamples = 0;
 double ambRadius = 0.0;
 double ambOffset = 0.0;
+
+/**
+ * Wavefront shading
+ *
+ * With wavefront set, the ambient occlusion rays of primary hits, and
+ * the light visibility rays an occlusion query can decide, are not
+ * shot from inside colorview().  Each CPU queues them with the pixel
+ * they belong to, and once about WAVE_BATCH rays of a kind are waiting
+ * (or it runs out of pixels) shoots the whole batch, sorted by
+ * direction octant and origin cell so that consecutive rays walk the
+ * same parts of the model, and then finishes the pixels.  Lights are
+ * only deferred where the shader's color is a plain sum over them, see
+ * light_obs_defer().  Only single sample, non-stereo rendering without
+ * a cutting plane is deferred.
+ */
+int wavefront = 0;
+#define WAVE_BATCH 4096
+struct wave_pixel {
+    int x, y;
+    vect_t color;		/* without deferred lights or occlusion */
+    fastf_t haze;		/* air attenuation of the deferred lights */
+    int ao;			/* occlusion rays are queued */
+    int hits;			/* occluded ones */
+    size_t lights;		/* first of its deferred lights */
+    size_t nlights;
+};
+struct wave_light {
+    vect_t term;		/* color it adds if fully visible */
+    int light;			/* index, as in sw_visible[] */
+    int tot;			/* visibility rays it was to get */
+    size_t rays;		/* first of its rays, by slot */
+    int nrays;
+};
+struct ao_ray {
+    unsigned int key;		/* octant, then Morton code of the origin cell */
+    size_t pix;
+    point_t pt;
+    vect_t dir;
+};
+struct light_ray {
+    unsigned int key;		/* as for ao_ray */
+    size_t slot;		/* queued order, indexes lvis[] */
+    struct light_vis_ray ray;
+};
+struct light_seen {
+    int vis;
+    vect_t inten;
+};
+struct wave_queue {
+    struct wave_pixel *pix;
+    size_t npix;
+    struct ao_ray *rays;
+    size_t nrays;
+    struct wave_light *lights;
+    size_t nlights, maxlights;
+    struct light_ray *lrays;
+    struct light_seen *lvis;
+    size_t nlrays, maxlrays;
+    size_t lights0;		/* first light of the pixel being shaded */
+    fastf_t haze;		/* of the pixel being shaded */
+    int ao_pending;		/* occlusion rays are queued for it */
+    int pending;		/* rays are queued for a pixel view_pixel() hasn't seen */
+};
+static struct wave_queue wave_queues[MAX_PSW];
+static size_t wave_maxpix = 0;		/* pixels per batch */
+static void view_wave_flush(struct resource *resp);
+static void view_wave_free(void);
+int colorview(struct application *ap, struct partition *PartHeadp, struct seg *finished_segs);
+
+/**
+ * Progressive rendering
+ *
+ * With progressive set to a maximum number of samples per pixel, rt
+ * makes jittered passes over the image, accumulating samples the way
+ * the multiple sample mode does.  After PROG_MIN_SAMPLES passes, a
+ * pixel is no longer shot once the standard error of its mean color
+ * is below prog_noise (0..1 color units) in every channel.  Rendering
+ * stops when no pixels are left, after the maximum number of passes,
+ * or at the first pass to start after prog_time seconds (if set).
+ * Each pass writes out the scanlines it changed, so the output always
+ * has the current best image.
+ */
+int progressive = 0;
+double prog_noise = 0.004;
+double prog_time = 0.0;
+#define PROG_MIN_SAMPLES 4
+static fastf_t *psq_buffer = NULL;	/* sums of squared samples */
+static int64_t prog_start = 0;
+static int prog_jitter = -1;		/* caller's jitter, while a pass runs */
+static int prog_full_incr = 0;		/* caller's full_incr_mode */
 vect_t ambient_color = { 1, 1, 1 };	/* Ambient white light */
 int ibackground[3] = {0};		/* integer 0..255 version */
 int inonbackground[3] = {0};		/* integer non-background */
@@ -164,10 +273,263 @@ struct bu_structparse view_parse[] = {
     {"%g", 1, "ambRadius", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"%g", 1, "ambOffset", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"%d", 1, "ambSlow", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%d", 1, "progressive", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%g", 1, "prog_noise", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%g", 1, "prog_time", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%d", 1, "wavefront", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"", 0, (char *)0, 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL}
 };
 
 
+/**
+ * Settle a thread's run of pixels with its scanline, and queue the
+ * scanline for output if that finishes it.  Returns 1 if it did.
+ */
+static int
+view_run_end(struct view_run *run)
+{
+    int done = 0;
+
+    if (!run->n)
+	return 0;
+
+    bu_semaphore_acquire(RT_SEM_RESULTS);
+    if (scanline[run->y].sl_left > 0) {
+	scanline[run->y].sl_left -= run->n;
+	if (scanline[run->y].sl_left <= 0) {
+	    rows_ready[rows_nready++] = run->y;
+	    done = 1;
+	}
+    }
+    bu_semaphore_release(RT_SEM_RESULTS);
+
+    run->n = 0;
+    return done;
+}
+
+
+/**
+ * Return the buffer of scanline y, allocating it if this is the first
+ * pixel stored there.  Dynamic and scanline buffering only keep the
+ * buffers of scanlines being worked on.
+ */
+static unsigned char *
+view_row_buf(int y)
+{
+    unsigned char *buf;
+
+    bu_semaphore_acquire(RT_SEM_RESULTS);
+    if (!scanline[y].sl_buf)
+	scanline[y].sl_buf = (unsigned char *)bu_calloc(width, pwidth, "sl_buf scanline buffer");
+    buf = scanline[y].sl_buf;
+    bu_semaphore_release(RT_SEM_RESULTS);
+
+    return buf;
+}
+
+
+/**
+ * Write out one finished scanline (the block of scanlines it stands
+ * for in incremental mode).
+ */
+static void
+view_write_row(int y)
+{
+    switch (buf_mode) {
+	case BUFMODE_INCR:
+	    {
+		long dy, yy;
+		long spread;
+		size_t npix = 0;
+
+		if (fbp == FB_NULL)
+		    bu_exit(EXIT_FAILURE, "Incremental rendering with no framebuffer?");
+
+		spread = (1<<(incr_nlevel-incr_level))-1;
+		bu_semaphore_acquire(BU_SEM_SYSCALL);
+		for (dy=spread; dy >= 0; dy--) {
+		    yy = y + dy;
+		    if (sub_grid_mode) {
+			if (dy < sub_ymin || dy > sub_ymax)
+			    continue;
+			npix = fb_write(fbp, sub_xmin, yy,
+					(unsigned char *)scanline[yy].sl_buf+3*sub_xmin,
+					sub_xmax-sub_xmin+1);
+			if (npix != (size_t)sub_xmax-(size_t)sub_xmin+1) break;
+		    } else {
+			npix = fb_write(fbp, 0, yy,
+					(unsigned char *)scanline[yy].sl_buf,
+					width);
+			if (npix != width) break;
+		    }
+		}
+		bu_semaphore_release(BU_SEM_SYSCALL);
+		if (npix != width) bu_exit(EXIT_FAILURE, "fb_write error (incremental res)");
+	    }
+	    break;
+
+	case BUFMODE_ACC:
+	case BUFMODE_SCANLINE:
+	case BUFMODE_DYNAMIC:
+	    if (fbp != FB_NULL) {
+		size_t npix;
+		bu_semaphore_acquire(BU_SEM_SYSCALL);
+		if (sub_grid_mode) {
+		    npix = fb_write(fbp, sub_xmin, y,
+				    (unsigned char *)scanline[y].sl_buf+3*sub_xmin,
+				    sub_xmax-sub_xmin+1);
+		} else {
+		    npix = fb_write(fbp, 0, y,
+				    (unsigned char *)scanline[y].sl_buf, width);
+		}
+		bu_semaphore_release(BU_SEM_SYSCALL);
+		if (sub_grid_mode) {
+		    if (npix < (size_t)sub_xmax-(size_t)sub_xmin-1) {
+			bu_log("WARNING: scanline error (wrote %zu of %zu pixels)", npix, (size_t)sub_xmax-sub_xmin-1);
+		    }
+		}
+	    }
+	    if (bif != NULL) {
+		/* TODO : Add double type data to maintain resolution */
+		icv_writeline(bif, y, (unsigned char *)scanline[y].sl_buf, ICV_DATA_UCHAR);
+	    } else if (outfp != NULL) {
+		size_t count;
+
+		bu_semaphore_acquire(BU_SEM_SYSCALL);
+		if (bu_fseek(outfp, y*width*pwidth, 0) != 0)
+		    fprintf(stderr, "fseek error\n");
+		count = fwrite(scanline[y].sl_buf,
+			       sizeof(char), width*pwidth, outfp);
+		bu_semaphore_release(BU_SEM_SYSCALL);
+		if (count != width*pwidth)
+		    bu_exit(EXIT_FAILURE, "view_pixel:  fwrite failure\n");
+	    }
+	    /* Accumulated frames are reused by the next pass */
+	    if (buf_mode != BUFMODE_ACC) {
+		bu_semaphore_acquire(RT_SEM_RESULTS);
+		bu_free(scanline[y].sl_buf, "sl_buf scanline buffer");
+		scanline[y].sl_buf = (unsigned char *)0;
+		bu_semaphore_release(RT_SEM_RESULTS);
+	    }
+    }
+}
+
+
+/**
+ * Write out the scanlines finished so far, returning how many were
+ * written.  With final set, the workers are done, and the runs they
+ * left unsettled are counted first.  This is view_flush for worker.c,
+ * and only runs in one thread at a time while output is asynchronous.
+ */
+static int
+view_write_rows(int final)
+{
+    int cnt = 0;
+
+    if (final) {
+	for (int i = 0; i < MAX_PSW; i++)
+	    (void)view_run_end(&view_runs[i]);
+    }
+
+    while (1) {
+	int y;
+
+	bu_semaphore_acquire(RT_SEM_RESULTS);
+	if (rows_nwritten >= rows_nready) {
+	    bu_semaphore_release(RT_SEM_RESULTS);
+	    break;
+	}
+	y = rows_ready[rows_nwritten++];
+	bu_semaphore_release(RT_SEM_RESULTS);
+
+	view_write_row(y);
+	cnt++;
+    }
+
+    return cnt;
+}
+
+
+/**
+ * Get ready to write out scanlines as they finish.  Incremental and
+ * accumulating modes keep the whole frame, so their scanline buffers
+ * are allocated up front and view_pixel() stores pixels without any
+ * interlock.  The other modes allocate each buffer when its scanline
+ * is started (see view_row_buf()) and free it once it is written.
+ */
+static void
+view_rows_init(void)
+{
+    size_t i;
+    size_t len = (buf_mode == BUFMODE_INCR) ? width+32 : width;
+
+    if (buf_mode == BUFMODE_INCR || buf_mode == BUFMODE_ACC) {
+	for (i = 0; i < height; i++) {
+	    if (!scanline[i].sl_buf)
+		scanline[i].sl_buf = (unsigned char *)bu_calloc(len, pwidth, "sl_buf scanline buffer");
+	}
+    }
+    if (!rows_ready)
+	rows_ready = (int *)bu_calloc(height, sizeof(int), "rows_ready");
+    rows_nready = rows_nwritten = 0;
+    memset(view_runs, 0, sizeof(view_runs));
+
+    if (buf_mode == BUFMODE_INCR) {
+	row_xmin = 0;
+	row_xmax = ((1<<incr_level)-1) << (incr_nlevel-incr_level);
+    } else if (sub_grid_mode) {
+	row_xmin = sub_xmin;
+	row_xmax = sub_xmax;
+    } else {
+	row_xmin = 0;
+	row_xmax = width-1;
+    }
+
+    view_flush = view_write_rows;
+}
+
+
+/**
+ * Set up the next progressive pass over the pixels that haven't
+ * converged, or end the run.  Returns the number of pixels to shoot.
+ */
+static size_t
+view_prog_pass(int first)
+{
+    size_t x, y;
+    size_t left = 0;
+    fastf_t elapsed = (bu_gettime() - prog_start) / 1000000.0;
+
+    for (y = 0; y < height; y++) {
+	scanline[y].sl_left = 0;
+	if (sub_grid_mode && (y < (size_t)sub_ymin || y > (size_t)sub_ymax))
+	    continue;
+	for (x = (size_t)row_xmin; x <= (size_t)row_xmax; x++) {
+	    if (!pixel_converged[y*width + x])
+		scanline[y].sl_left++;
+	}
+	left += scanline[y].sl_left;
+    }
+
+    if (first) {
+	bu_log("Mode: Progressive, up to %zu samples per pixel\n", full_incr_nsamples);
+	return left;
+    }
+
+    if (!left || (prog_time > 0.0 && elapsed >= prog_time)) {
+	bu_log("Progressive rendering done after %zu samples, %.2f sec, %zu pixels still noisy\n",
+	       full_incr_sample - 1, elapsed, left);
+	/* ends the passes in do_frame() */
+	full_incr_nsamples = full_incr_sample - 1;
+	return 0;
+    }
+
+    if (rt_verbosity & VERBOSE_INCREMENTAL)
+	bu_log("Progressive sample %zu: %zu pixels, %.2f sec\n", full_incr_sample, left, elapsed);
+    return left;
+}
+
+
 /**
  * Arrange to have the pixel output.  a_uptr has region pointer, for
  * reference.
@@ -177,8 +539,8 @@ view_pixel(struct application *ap)
 {
     int r, g, b;
     unsigned char *pixelp;
-    struct scanline *slp;
-    int do_eol = 0;
+    struct view_run *run;
+    int done = 0;
 
 /* #define DRAW_INDICATOR_LINE 1 */
 #ifdef DRAW_INDICATOR_LINE
@@ -195,6 +557,30 @@ view_pixel(struct application *ap)
     bu_semaphore_release(BU_SEM_SYSCALL);
 #endif
 
+    /* Rays are queued for this pixel, so it is finished later by
+     * view_wave_flush() */
+    if (view_drain && wave_queues[ap->a_resource->re_cpu].pending) {
+	struct wave_queue *q = &wave_queues[ap->a_resource->re_cpu];
+	struct wave_pixel *p = &q->pix[q->npix++];
+
+	p->x = ap->a_x;
+	p->y = ap->a_y;
+	VMOVE(p->color, ap->a_color);
+	p->haze = q->haze;
+	p->ao = q->ao_pending;
+	p->hits = 0;
+	p->lights = q->lights0;
+	p->nlights = q->nlights - q->lights0;
+
+	q->pending = 0;
+	q->ao_pending = 0;
+	q->haze = 1.0;
+	q->lights0 = q->nlights;
+	if (q->npix >= wave_maxpix || q->nlrays >= WAVE_BATCH)
+	    view_wave_flush(ap->a_resource);
+	return;
+    }
+
     if (ap->a_user == 0) {
 	/* Shot missed the model, don't dither */
 	r = ibackground[0];
@@ -340,41 +726,24 @@ view_pixel(struct application *ap)
 #endif
 
 	    /*
-	     * Store results into pixel buffer.  Don't depend on
-	     * interlocked hardware byte-splice.  Need to protect
-	     * scanline[].sl_left when in parallel mode.
+	     * Store results into the scanline buffers.  Each pixel is
+	     * computed by exactly one CPU per pass, so only getting the
+	     * buffer of a scanline needs an interlock.  A buffer is only
+	     * freed once all its pixels are in, so a CPU can keep using
+	     * the one it got until it moves to another scanline.
 	     */
 
 	case BUFMODE_DYNAMIC:
-	    slp = &scanline[ap->a_y];
-	    bu_semaphore_acquire(RT_SEM_RESULTS);
-	    if (slp->sl_buf == (unsigned char *)0) {
-		slp->sl_buf = (unsigned char *)bu_calloc(width, pwidth, "sl_buf scanline buffer");
-	    }
-	    pixelp = slp->sl_buf+(ap->a_x*pwidth);
-	    *pixelp++ = r;
-	    *pixelp++ = g;
-	    *pixelp++ = b;
-	    if (--(slp->sl_left) <= 0)
-		do_eol = 1;
-	    bu_semaphore_release(RT_SEM_RESULTS);
-	    break;
-
-	    /*
-	     * Only one CPU is working on this scanline, no parallel
-	     * interlock required! Much faster.
-	     */
 	case BUFMODE_SCANLINE:
-	    slp = &scanline[ap->a_y];
-	    if (slp->sl_buf == (unsigned char *)0) {
-		slp->sl_buf = (unsigned char *)bu_calloc(width, pwidth, "sl_buf scanline buffer");
+	    run = &view_runs[ap->a_resource->re_cpu];
+	    if (!run->buf || run->buf_y != ap->a_y) {
+		run->buf = view_row_buf(ap->a_y);
+		run->buf_y = ap->a_y;
 	    }
-	    pixelp = slp->sl_buf+(ap->a_x*pwidth);
+	    pixelp = run->buf+(ap->a_x*pwidth);
 	    *pixelp++ = r;
 	    *pixelp++ = g;
 	    *pixelp++ = b;
-	    if (--(slp->sl_left) <= 0)
-		do_eol = 1;
 	    break;
 
 	case BUFMODE_INCR:
@@ -384,15 +753,9 @@ view_pixel(struct application *ap)
 
 		spread = 1<<(incr_nlevel-incr_level);
 
-		bu_semaphore_acquire(RT_SEM_RESULTS);
 		for (dy=0; dy<spread; dy++) {
 		    if ((size_t)ap->a_y+dy >= height) break;
-		    slp = &scanline[ap->a_y+dy];
-		    if (slp->sl_buf == (unsigned char *)0)
-			slp->sl_buf = (unsigned char *)bu_calloc(width+32,
-								 pwidth, "sl_buf scanline buffer");
-
-		    pixelp = slp->sl_buf+(ap->a_x*pwidth);
+		    pixelp = scanline[ap->a_y+dy].sl_buf+(ap->a_x*pwidth);
 		    for (dx=0; dx<spread; dx++) {
 			*pixelp++ = r;
 			*pixelp++ = g;
@@ -400,47 +763,52 @@ view_pixel(struct application *ap)
 		    }
 		}
 		/* First 3 incremental iterations are boring */
-		if (incr_level > 3) {
-		    if (--(scanline[ap->a_y].sl_left) <= 0)
-			do_eol = 1;
-		}
-		bu_semaphore_release(RT_SEM_RESULTS);
+		if (incr_level <= 3)
+		    return;
 	    }
 	    break;
 
 	case BUFMODE_ACC:
 	    {
 		unsigned int i;
+		size_t pix = ap->a_y*width + ap->a_x;
 		fastf_t *psum_p;
-		fastf_t *tmp_pixel;
 		int tmp_color;
+		/* a_color only flags a miss */
+		const fastf_t *color = (ap->a_user == 0) ? background : ap->a_color;
 
-		/* Scanline buffered mode */
-		bu_semaphore_acquire(RT_SEM_RESULTS);
-
-		tmp_pixel = (fastf_t *)bu_calloc(pwidth, sizeof(fastf_t), "tmp_pixel");
-		VMOVE(tmp_pixel, ap->a_color);
-
-		psum_p = &psum_buffer[ap->a_y*width*pwidth + ap->a_x*pwidth];
-		slp = &scanline[ap->a_y];
-		if (slp->sl_buf == (unsigned char *)0) {
-		    slp->sl_buf = (unsigned char *)bu_calloc(width, pwidth, "sl_buf scanline buffer");
-		}
-		pixelp = slp->sl_buf+(ap->a_x*pwidth);
+		psum_p = &psum_buffer[pix*pwidth];
+		pixelp = scanline[ap->a_y].sl_buf+(ap->a_x*pwidth);
 		/* Update the partial sums and the scanline */
 		for (i = 0; i < pwidth; i++) {
-		    psum_p[i] += tmp_pixel[i];
+		    psum_p[i] += color[i];
 		    /* change the float interval to [0, 255] and round to
 		       the nearest integer */
 		    tmp_color = psum_p[i]*255.0/full_incr_sample + 0.5;
 		    /* clamp */
 		    pixelp[i] = tmp_color < 0 ? 0 : tmp_color > 255 ? 255 : tmp_color;
 		}
-		bu_free(tmp_pixel, "tmp_pixel");
 
-		bu_semaphore_release(RT_SEM_RESULTS);
-		if (--(slp->sl_left) <= 0)
-		    do_eol = 1;
+		/* Every pass samples each pixel that hasn't converged,
+		 * so full_incr_sample is its sample count */
+		if (pixel_converged) {
+		    fastf_t *psq_p = &psq_buffer[pix*pwidth];
+		    fastf_t n = full_incr_sample;
+		    fastf_t worst = 0.0;
+
+		    for (i = 0; i < pwidth; i++) {
+			psq_p[i] += color[i] * color[i];
+			if (full_incr_sample >= PROG_MIN_SAMPLES) {
+			    fastf_t mean = psum_p[i] / n;
+			    fastf_t var = (psq_p[i] - n * mean * mean) / (n - 1);
+			    if (var > worst)
+				worst = var;
+			}
+		    }
+		    /* variance of the mean is var/n */
+		    if (full_incr_sample >= PROG_MIN_SAMPLES && worst <= prog_noise * prog_noise * n)
+			pixel_converged[pix] = 1;
+		}
 	    }
 	    break;
 
@@ -448,82 +816,23 @@ view_pixel(struct application *ap)
 	    bu_exit(EXIT_FAILURE, "bad buf_mode: %d", buf_mode);
     }
 
-
-    if (!do_eol)
-	return;
-
-    switch (buf_mode) {
-	case BUFMODE_INCR:
-	    {
-		long dy, yy;
-		long spread;
-		size_t npix = 0;
-
-		if (fbp == FB_NULL)
-		    bu_exit(EXIT_FAILURE, "Incremental rendering with no framebuffer?");
-
-		spread = (1<<(incr_nlevel-incr_level))-1;
-		bu_semaphore_acquire(BU_SEM_SYSCALL);
-		for (dy=spread; dy >= 0; dy--) {
-		    yy = ap->a_y + dy;
-		    if (sub_grid_mode) {
-			if (dy < sub_ymin || dy > sub_ymax)
-			    continue;
-			npix = fb_write(fbp, sub_xmin, yy,
-					(unsigned char *)scanline[yy].sl_buf+3*sub_xmin,
-					sub_xmax-sub_xmin+1);
-			if (npix != (size_t)sub_xmax-(size_t)sub_xmin+1) break;
-		    } else {
-			npix = fb_write(fbp, 0, yy,
-					(unsigned char *)scanline[yy].sl_buf,
-					width);
-			if (npix != width) break;
-		    }
-		}
-		bu_semaphore_release(BU_SEM_SYSCALL);
-		if (npix != width) bu_exit(EXIT_FAILURE, "fb_write error (incremental res)");
-	    }
-	    break;
-
-	case BUFMODE_ACC:
-	case BUFMODE_SCANLINE:
-	case BUFMODE_DYNAMIC:
-	    if (fbp != FB_NULL) {
-		size_t npix;
-		bu_semaphore_acquire(BU_SEM_SYSCALL);
-		if (sub_grid_mode) {
-		    npix = fb_write(fbp, sub_xmin, ap->a_y,
-				    (unsigned char *)scanline[ap->a_y].sl_buf+3*sub_xmin,
-				    sub_xmax-sub_xmin+1);
-		} else {
-		    npix = fb_write(fbp, 0, ap->a_y,
-				    (unsigned char *)scanline[ap->a_y].sl_buf, width);
-		}
-		bu_semaphore_release(BU_SEM_SYSCALL);
-		if (sub_grid_mode) {
-		    if (npix < (size_t)sub_xmax-(size_t)sub_xmin-1) {
-			bu_log("WARNING: scanline error (wrote %zu of %zu pixels)", npix, (size_t)sub_xmax-sub_xmin-1);
-		    }
-		}
-	    }
-	    if (bif != NULL) {
-		/* TODO : Add double type data to maintain resolution */
-		icv_writeline(bif, ap->a_y, (unsigned char *)scanline[ap->a_y].sl_buf, ICV_DATA_UCHAR);
-	    } else if (outfp != NULL) {
-		size_t count;
-
-		bu_semaphore_acquire(BU_SEM_SYSCALL);
-		if (bu_fseek(outfp, ap->a_y*width*pwidth, 0) != 0)
-		    fprintf(stderr, "fseek error\n");
-		count = fwrite(scanline[ap->a_y].sl_buf,
-			       sizeof(char), width*pwidth, outfp);
-		bu_semaphore_release(BU_SEM_SYSCALL);
-		if (count != width*pwidth)
-		    bu_exit(EXIT_FAILURE, "view_pixel:  fwrite failure\n");
-	    }
-	    bu_free(scanline[ap->a_y].sl_buf, "sl_buf scanline buffer");
-	    scanline[ap->a_y].sl_buf = (unsigned char *)0;
-    }
+    /* Settle up with the scanline at the end of this CPU's run on it -
+     * when it moves to another scanline, or reaches either end of this
+     * one.  Whatever is left after the last run is settled by
+     * view_write_rows() once the workers are done.
+     */
+    run = &view_runs[ap->a_resource->re_cpu];
+    if (run->n && run->y != ap->a_y)
+	done = view_run_end(run);
+    run->y = ap->a_y;
+    run->n++;
+    if (ap->a_x <= row_xmin || ap->a_x >= row_xmax)
+	done |= view_run_end(run);
+
+    /* Without an output thread, the CPU that finishes a scanline
+     * writes it out */
+    if (done && !view_flush_async)
+	(void)view_write_rows(0);
 }
 
 
@@ -575,6 +884,31 @@ view_end(struct application *ap)
 	bu_free(psum_buffer, "psum_buffer");
 	psum_buffer = 0;
     }
+
+    if (rows_ready) {
+	bu_free(rows_ready, "rows_ready");
+	rows_ready = NULL;
+    }
+
+    view_drain = NULL;
+    light_defer = NULL;
+    view_wave_free();
+
+    if (pixel_converged) {
+	bu_free(pixel_converged, "pixel_converged");
+	pixel_converged = NULL;
+    }
+    if (psq_buffer) {
+	bu_free(psq_buffer, "psq_buffer");
+	psq_buffer = NULL;
+    }
+    /* progressive passes are done, put the user's settings back */
+    if (prog_jitter >= 0) {
+	jitter = prog_jitter;
+	full_incr_mode = prog_full_incr;
+	prog_jitter = -1;
+    }
+    view_flush = NULL;
 }
 
 
@@ -886,6 +1220,145 @@ ao_raymiss(register struct application *ap)
 }
 
 
+/*
+ * Returns 1 if an ambient occlusion ray is occluded, as ao_rayhit()
+ * would decide it without a cutting plane: with no radius anything
+ * along the ray counts, otherwise the first region entered in front
+ * of the origin has to be entered within the radius.
+ */
+static int
+ao_occluded(struct application *ap)
+{
+    if (NEAR_ZERO(ambRadius, ap->a_rt_i->rti_tol.dist))
+	return rt_shootray_occluded(ap, 0.0, INFINITY, NULL) > 0;
+
+    return rt_shootray_occluded_entry(ap, 0.0, ambRadius, NULL) > 0;
+}
+
+
+/*
+ * Sort key of a queued ray: its direction octant and the Morton code
+ * of the model cell it starts in.
+ */
+static unsigned int
+wave_key(const struct rt_i *rtip, const point_t pt, const vect_t dir)
+{
+    unsigned int key = 0;
+    int i, b;
+
+    for (i = 0; i < 3; i++) {
+	fastf_t span = rtip->mdl_max[i] - rtip->mdl_min[i];
+	int c = (span > SMALL_FASTF) ? (int)(256.0 * (pt[i] - rtip->mdl_min[i]) / span) : 0;
+
+	CLAMP(c, 0, 255);
+	for (b = 0; b < 8; b++)
+	    key |= (unsigned int)((c >> b) & 1) << (3*b + i);
+	if (dir[i] < 0)
+	    key |= 1U << (24 + i);
+    }
+
+    return key;
+}
+
+
+/*
+ * Queue an ambient occlusion ray for the pixel being shaded.
+ */
+static void
+ao_queue_ray(struct wave_queue *q, const struct rt_i *rtip, const struct xray *rp)
+{
+    struct ao_ray *r = &q->rays[q->nrays++];
+
+    r->key = wave_key(rtip, rp->r_pt, rp->r_dir);
+    r->pix = q->npix;
+    VMOVE(r->pt, rp->r_pt);
+    VMOVE(r->dir, rp->r_dir);
+}
+
+
+static int
+ao_ray_cmp(const void *a, const void *b, void *UNUSED(arg))
+{
+    unsigned int ka = ((const struct ao_ray *)a)->key;
+    unsigned int kb = ((const struct ao_ray *)b)->key;
+
+    return (ka > kb) - (ka < kb);
+}
+
+
+static int
+light_ray_cmp(const void *a, const void *b, void *UNUSED(arg))
+{
+    unsigned int ka = ((const struct light_ray *)a)->key;
+    unsigned int kb = ((const struct light_ray *)b)->key;
+
+    return (ka > kb) - (ka < kb);
+}
+
+
+/*
+ * light_defer hooks: queue the visibility rays of a light for the
+ * primary hit being shaded, and note what the light adds to its color.
+ */
+static int
+wave_light_rays(struct application *ap, int light, int tot, const struct light_vis_ray *rays, int nrays)
+{
+    struct wave_queue *q;
+    struct wave_light *l;
+    int i;
+
+    if (!view_drain || ap->a_level != 0 || ap->a_hit != colorview)
+	return -1;
+    q = &wave_queues[ap->a_resource->re_cpu];
+
+    if (q->nlights >= q->maxlights) {
+	q->maxlights = (q->maxlights) ? 2 * q->maxlights : 64;
+	q->lights = (struct wave_light *)bu_realloc(q->lights, q->maxlights * sizeof(struct wave_light), "wave lights");
+    }
+    if (q->nlrays + nrays > q->maxlrays) {
+	while (q->nlrays + nrays > q->maxlrays)
+	    q->maxlrays = (q->maxlrays) ? 2 * q->maxlrays : WAVE_BATCH;
+	q->lrays = (struct light_ray *)bu_realloc(q->lrays, q->maxlrays * sizeof(struct light_ray), "light rays");
+	q->lvis = (struct light_seen *)bu_realloc(q->lvis, q->maxlrays * sizeof(struct light_seen), "light visibility");
+    }
+
+    l = &q->lights[q->nlights++];
+    VSETALL(l->term, 0);
+    l->light = light;
+    l->tot = tot;
+    l->rays = q->nlrays;
+    l->nrays = nrays;
+    for (i = 0; i < nrays; i++) {
+	struct light_ray *r = &q->lrays[q->nlrays];
+
+	r->key = wave_key(ap->a_rt_i, rays[i].lv_pt, rays[i].lv_dir);
+	r->slot = q->nlrays++;
+	r->ray = rays[i];
+    }
+
+    q->pending = 1;
+    return 0;
+}
+
+
+static void
+wave_light_term(struct application *ap, int light, const vect_t term)
+{
+    struct wave_queue *q = &wave_queues[ap->a_resource->re_cpu];
+    size_t i;
+
+    for (i = q->lights0; i < q->nlights; i++) {
+	if (q->lights[i].light == light) {
+	    VMOVE(q->lights[i].term, term);
+	    return;
+	}
+    }
+}
+
+
+static struct light_defer wave_light_defer = {wave_light_rays, wave_light_term};
+
+
 /*
  * Compute the ambient term using occlusion rays.
  * Scale the color based upon the occlusion
@@ -894,6 +1367,7 @@ void
 ambientOcclusion(struct application *ap, struct partition *pp)
 {
     struct application amb_ap = *ap;
+    struct wave_queue *q = NULL;
     struct soltab *stp;
     struct hit *hitp;
     vect_t inormal;
@@ -940,6 +1414,13 @@ ambientOcclusion(struct application *ap, struct partition *pp)
     VUNITIZE(vAxis);
     VCROSS(uAxis, vAxis, inormal);
 
+    /* Primary hits leave their rays for the next batch */
+    if (view_drain && ap->a_level == 0 && !do_kut_plane) {
+	q = &wave_queues[ap->a_resource->re_cpu];
+	if (q->ao_pending)
+	    q = NULL;
+    }
+
     for (ao_samp=0; ao_samp < ambSamples ; ao_samp++) {
 	vect_t randScale;
 
@@ -958,6 +1439,18 @@ ambientOcclusion(struct application *ap, struct partition *pp)
 
 	VUNITIZE(amb_ap.a_ray.r_dir);
 
+	if (q) {
+	    ao_queue_ray(q, ap->a_rt_i, &amb_ap.a_ray);
+	    continue;
+	}
+
+	/* Only whether something is within the radius matters, unless
+	 * the cutting plane has to see the partitions */
+	if (!do_kut_plane) {
+	    hitCount += ao_occluded(&amb_ap);
+	    continue;
+	}
+
 	amb_ap.a_user = 0;
 	amb_ap.a_flag = 0;
 
@@ -966,6 +1459,12 @@ ambientOcclusion(struct application *ap, struct partition *pp)
 	hitCount += amb_ap.a_flag;
     }
 
+    if (q) {
+	q->ao_pending = 1;
+	q->pending = 1;
+	return;
+    }
+
     occlusionFactor = 1.0 - (hitCount / (float)ambSamples);
 
     /* try not go go completely black */
@@ -975,6 +1474,122 @@ ambientOcclusion(struct application *ap, struct partition *pp)
 }
 
 
+/*
+ * Shoot the occlusion and light rays a CPU has queued, each kind in
+ * sorted order, and finish their pixels.
+ */
+static void
+view_wave_flush(struct resource *resp)
+{
+    struct wave_queue *q = &wave_queues[resp->re_cpu];
+    struct application amb_ap;
+    struct application a;
+    size_t i, j;
+    int k;
+
+    if (!q->npix)
+	return;
+
+    bu_sort(q->rays, q->nrays, sizeof(struct ao_ray), ao_ray_cmp, NULL);
+
+    amb_ap = APP;
+    amb_ap.a_resource = resp;
+    amb_ap.a_purpose = "ambient occlusion";
+    for (i = 0; i < q->nrays; i++) {
+	VMOVE(amb_ap.a_ray.r_pt, q->rays[i].pt);
+	VMOVE(amb_ap.a_ray.r_dir, q->rays[i].dir);
+	q->pix[q->rays[i].pix].hits += ao_occluded(&amb_ap);
+    }
+
+    bu_sort(q->lrays, q->nlrays, sizeof(struct light_ray), light_ray_cmp, NULL);
+
+    a = APP;
+    a.a_resource = resp;
+    for (i = 0; i < q->nlrays; i++) {
+	struct light_seen *lv = &q->lvis[q->lrays[i].slot];
+
+	lv->vis = light_vis_shoot(&a, &q->lrays[i].ray, lv->inten);
+    }
+
+    a = APP;
+    a.a_resource = resp;
+    a.a_user = 1;
+    for (i = 0; i < q->npix; i++) {
+	struct wave_pixel *p = &q->pix[i];
+
+	VMOVE(a.a_color, p->color);
+
+	/* As light_obs() would have it: the fraction of rays that see
+	 * the light, at the intensity the last of them got */
+	for (j = p->lights; j < p->lights + p->nlights; j++) {
+	    struct wave_light *l = &q->lights[j];
+	    const fastf_t *inten = NULL;
+	    int nvis = 0;
+	    vect_t work;
+
+	    for (k = 0; k < l->nrays; k++) {
+		if (q->lvis[l->rays + k].vis) {
+		    inten = q->lvis[l->rays + k].inten;
+		    nvis++;
+		}
+	    }
+	    if (!nvis || l->tot <= 0)
+		continue;
+	    VELMUL(work, l->term, inten);
+	    VJOIN1(a.a_color, a.a_color, p->haze * nvis / (fastf_t)l->tot, work);
+	}
+
+	if (p->ao) {
+	    fastf_t occlusionFactor = 1.0 - (p->hits / (float)ambSamples);
+
+	    /* try not go go completely black */
+	    CLAMP(occlusionFactor, 0.0125, 1.0);
+
+	    VSCALE(a.a_color, a.a_color, occlusionFactor);
+	}
+	a.a_x = p->x;
+	a.a_y = p->y;
+	view_pixel(&a);
+    }
+
+    q->npix = 0;
+    q->nrays = 0;
+    q->nlights = 0;
+    q->nlrays = 0;
+    q->lights0 = 0;
+    q->haze = 1.0;
+}
+
+
+static void
+view_wave_drain(int cpu)
+{
+    view_wave_flush(&resource[cpu]);
+}
+
+
+static void
+view_wave_free(void)
+{
+    int i;
+
+    for (i = 0; i < MAX_PSW; i++) {
+	if (wave_queues[i].pix)
+	    bu_free(wave_queues[i].pix, "wave pixels");
+	if (wave_queues[i].rays)
+	    bu_free(wave_queues[i].rays, "ao rays");
+	if (wave_queues[i].lights)
+	    bu_free(wave_queues[i].lights, "wave lights");
+	if (wave_queues[i].lrays)
+	    bu_free(wave_queues[i].lrays, "light rays");
+	if (wave_queues[i].lvis)
+	    bu_free(wave_queues[i].lvis, "light visibility");
+	memset(&wave_queues[i], 0, sizeof(struct wave_queue));
+	wave_queues[i].haze = 1.0;
+    }
+}
+
+
 /**
  * Manage the coloring of whatever it was we just hit.  This can be a
  * recursive procedure.
@@ -1176,6 +1791,10 @@ out:
 
 	VSCALE(ap->a_color, ap->a_color, f);
 	VJOIN1(ap->a_color, ap->a_color, g, haze);
+
+	/* and of any lights left for the wavefront queue */
+	if (view_drain && ap->a_level == 0 && wave_queues[ap->a_resource->re_cpu].pending)
+	    wave_queues[ap->a_resource->re_cpu].haze = f;
     }
 
 
@@ -1514,6 +2133,7 @@ view_2init(struct application *ap, char *UNUSED(framename))
 {
     size_t i;
     struct bu_ptbl stps;
+    int prog_first = 0;
 
     ap->a_refrac_index = 1.0;	/* RI_AIR -- might be water? */
     ap->a_cumlen = 0.0;
@@ -1529,6 +2149,23 @@ view_2init(struct application *ap, char *UNUSED(framename))
 
     pwidth = 3;
 
+    /* Progressive rendering is the multiple sample mode, with jitter,
+     * stopping early.  The first call for a frame is the one before
+     * psum_buffer is allocated. */
+    if (progressive > 0 && !psum_buffer && !incr_mode && !fullfloat_mode) {
+	if (prog_jitter < 0) {
+	    prog_jitter = jitter;
+	    prog_full_incr = full_incr_mode;
+	}
+	full_incr_mode = 1;
+	full_incr_nsamples = progressive;
+	jitter |= JITTER_CELL;
+	pixel_converged = (unsigned char *)bu_calloc(width*height, 1, "pixel_converged");
+	psq_buffer = (fastf_t *)bu_calloc(height*width*pwidth, sizeof(fastf_t), "psq_buffer");
+	prog_start = bu_gettime();
+	prog_first = 1;
+    }
+
     /* Always allocate the scanline[] array (unless we already have
      * one in incremental mode)
      */
@@ -1566,6 +2203,34 @@ view_2init(struct application *ap, char *UNUSED(framename))
     }
 #endif
 
+    /* Buffered modes render into the whole frame, and write out each
+     * scanline once it is finished */
+    view_flush = NULL;
+    if (buf_mode == BUFMODE_INCR || buf_mode == BUFMODE_ACC ||
+	buf_mode == BUFMODE_SCANLINE || buf_mode == BUFMODE_DYNAMIC)
+	view_rows_init();
+
+    /* Wavefront shading needs the pixels to be finished in any order */
+    view_drain = NULL;
+    light_defer = NULL;
+    view_wave_free();
+    if (wavefront && hypersample == 0 && !stereo && !random_mode && !do_kut_plane &&
+	buf_mode != BUFMODE_FULLFLOAT && buf_mode != BUFMODE_RTSRV) {
+	int i;
+
+	if (ambSamples > 0)
+	    wave_maxpix = (WAVE_BATCH > ambSamples) ? WAVE_BATCH / ambSamples : 1;
+	else
+	    wave_maxpix = WAVE_BATCH;
+	for (i = 0; i < npsw; i++) {
+	    wave_queues[i].pix = (struct wave_pixel *)bu_calloc(wave_maxpix, sizeof(struct wave_pixel), "wave pixels");
+	    if (ambSamples > 0)
+		wave_queues[i].rays = (struct ao_ray *)bu_calloc(wave_maxpix * ambSamples, sizeof(struct ao_ray), "ao rays");
+	}
+	view_drain = view_wave_drain;
+	light_defer = &wave_light_defer;
+    }
+
     switch (buf_mode) {
 	case BUFMODE_UNBUF:
 	    bu_log("Mode: Single pixel I/O, unbuffered\n");
@@ -1654,6 +2319,11 @@ view_2init(struct application *ap, char *UNUSED(framename))
 
 	    break;
 	case BUFMODE_ACC:
+	    if (pixel_converged) {
+		if (!view_prog_pass(prog_first))
+		    return;	/* done */
+		break;
+	    }
 	    for (i=0; i<height; i++)
 		scanline[i].sl_left = width;
 	    bu_log("Mode: Multiple-sample, average buffering\n");
@@ -1843,6 +2513,10 @@ application_init(void)
     view_parse[ 9].sp_offset = bu_byteoffset(ambRadius);
     view_parse[10].sp_offset = bu_byteoffset(ambOffset);
     view_parse[11].sp_offset = bu_byteoffset(ambSlow);
+    view_parse[12].sp_offset = bu_byteoffset(progressive);
+    view_parse[13].sp_offset = bu_byteoffset(prog_noise);
+    view_parse[14].sp_offset = bu_byteoffset(prog_time);
+    view_parse[15].sp_offset = bu_byteoffset(wavefront);
 
     option("", "-A #", "Set image brightness, ambient light intensity (default: 0.4)", 0);
     option("Raytrace", "-i", "Enable incremental (progressive-style) rendering", 1);
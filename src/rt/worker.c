@@ -31,6 +31,7 @@
 #include <math.h>
 
 #include "bu/log.h"
+#include "bu/snooze.h"
 #include "vmath.h"
 #include "bn.h"
 #include "raytrace.h"
@@ -79,6 +80,26 @@ int last_pixel = 0;			/* last pixel number */
 
 int stop_worker = 0;
 
+/* Set by the view module when it buffers output.  While do_run()
+ * renders in parallel it is called from a thread of its own to write
+ * out finished scanlines, so the workers never wait on output, and
+ * view_flush_async is set for the duration.  It is called once more
+ * with final set after the workers are done.
+ */
+int (*view_flush)(int final) = NULL;
+int view_flush_async = 0;
+
+/* Set by the view module when it defers work on some pixels.  Each
+ * worker calls it with its CPU number when it runs out of pixels, to
+ * finish whatever it still holds.
+ */
+void (*view_drain)(int cpu) = NULL;
+
+/* Set by the view module for progressive rendering - pixels marked
+ * non-zero have converged, and are not shot again */
+unsigned char *pixel_converged = NULL;
+static int workers_running = 0;
+
 /**
  * For certain hypersample values there is a particular advantage to
  * subdividing the pixel and shooting a ray in each sub-pixel.  This
@@ -208,6 +229,8 @@ do_pixel(int cpu, int pat_num, int pixelnum)
 	if (a.a_y < sub_ymin || a.a_y > sub_ymax)
 	    return;
     }
+    if (pixel_converged && pixel_converged[a.a_y*width + a.a_x])
+	return;
     if (fullfloat_mode) {
 	register struct floatpixel *fp;
 	fp = &curr_float_frame[a.a_y*width + a.a_x];
@@ -554,7 +577,7 @@ pat_found:
 
 	while (1) {
 	    if (stop_worker)
-		return;
+		break;
 
 	    bu_semaphore_acquire(RT_SEM_WORKER);
 	    pixel_start = cur_pixel;
@@ -572,13 +595,45 @@ pat_found:
 	    /* bu_log("SPAN[%d -> %d] for %d pixels\n", pixel_start, pixel_start+per_processor_chunk, per_processor_chunk); */
 	    for (pixelnum = from; pixelnum != to; (from < to) ? pixelnum++ : pixelnum--) {
 		if (pixelnum > last_pixel || pixelnum < 0)
-		    return;
+		    goto done;
 
 		/* bu_log("    PIXEL[%d]\n", pixelnum); */
 		do_pixel(cpu, pat_num, pixelnum);
 	    }
 	}
     }
+
+done:
+    if (view_drain)
+	(*view_drain)(cpu);
+}
+
+
+/**
+ * The first npsw threads render, and the last writes out finished
+ * scanlines until they are all done.
+ */
+static void
+worker_or_writer(int cpu, void *arg)
+{
+    int running = 1;
+
+    if (cpu < npsw) {
+	worker(cpu, arg);
+	bu_semaphore_acquire(RT_SEM_WORKER);
+	workers_running--;
+	bu_semaphore_release(RT_SEM_WORKER);
+	return;
+    }
+
+    while (running) {
+	bu_semaphore_acquire(RT_SEM_WORKER);
+	running = workers_running;
+	bu_semaphore_release(RT_SEM_WORKER);
+
+	if (!(*view_flush)(0) && running)
+	    bu_snooze(BU_SEC2USEC(0.005));
+    }
 }
 
 
@@ -597,6 +652,14 @@ do_run(int a, int b)
 	 */
 	npsw = 1;
 	worker(0, NULL);
+    } else if (view_flush && npsw > 1 && npsw < MAX_PSW) {
+	/*
+	 * Parallel case, with an extra thread for output.
+	 */
+	workers_running = (int)npsw;
+	view_flush_async = 1;
+	bu_parallel(worker_or_writer, (size_t)npsw + 1, NULL);
+	view_flush_async = 0;
     } else {
 	/*
 	 * Parallel case.
@@ -604,6 +667,10 @@ do_run(int a, int b)
 	bu_parallel(worker, (size_t)npsw, NULL);
     }
 
+    /* Write whatever is left */
+    if (view_flush)
+	(void)(*view_flush)(1);
+
     /* Tally up the statistics */
     size_t cpu;
     for (cpu = 0; cpu < MAX_PSW; cpu++) {